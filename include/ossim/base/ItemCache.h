@@ -250,10 +250,6 @@ namespace ossim
    void ItemCache<ItemType>::protectedAddItem(const ossimString& key, 
                                                      std::shared_ptr<ItemType> item)
    {
-      if(m_cache.size() > m_maxItemsToCache)
-      {
-         shrinkCache();
-      }
       typename CacheType::iterator iter = m_cache.find(key);
       if(iter!= m_cache.end())
       {
@@ -285,16 +281,23 @@ namespace ossim
                                                 nodePtr));            
             }
          }
+
+         // Shrink once the new item takes the cache past its max, so it never holds more:
+         if(m_cache.size() > m_maxItemsToCache)
+         {
+            shrinkCache();
+         }
       }
    }
 
    template<class ItemType>
    void ItemCache<ItemType>::touchNode(std::shared_ptr<Node> node)const
    {
-      m_lruCache.erase(node->m_lruId);
-      node->m_lruId = nextId();
+      // Readers touch nodes under a read lock on the items, so the LRU needs its own lock:
       {
          ossim::ScopeWriteLock lock(m_lruCacheMutex);
+         m_lruCache.erase(node->m_lruId);
+         node->m_lruId = nextId();
          if(m_lruCache.size() > 0)
          {
             m_lruCache.insert(m_lruCache.end(), std::make_pair(node->m_lruId, node));
@@ -313,12 +316,16 @@ namespace ossim
    }
 
    template<class ItemType>
-   void ItemCache<ItemType>::setMinAndMaxItemsToCache(ossim_uint32 maxItemsToCache, 
-                                                ossim_uint32 minItemsToCache)
+   void ItemCache<ItemType>::setMinAndMaxItemsToCache(ossim_uint32 minItemsToCache, 
+                                                ossim_uint32 maxItemsToCache)
    {
      ossim::ScopeWriteLock lock(m_itemCacheMutex);
      m_maxItemsToCache = maxItemsToCache;
      m_minItemsToCache = minItemsToCache;
+     if(m_cache.size() > m_maxItemsToCache)
+     {
+        shrinkCache();
+     }
    }
    template<class ItemType>
    void ItemCache<ItemType>::reset()
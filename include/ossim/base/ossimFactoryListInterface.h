@@ -16,6 +16,7 @@
 #include <ossim/base/ossimString.h>
 #include <ossim/base/ossimKeywordlist.h>
 #include <mutex>
+#include <thread>
 
 /**
  * The is a factory list interface that allows registries to be accessed in a common way.  
@@ -36,8 +37,19 @@ class ossimFactoryListInterface
       typedef std::vector<T*> FactoryListType;
       typedef T FactoryType;
       typedef NativeType NativeReturnType;
+
+      /** A registration held back while capturing, see setCaptureList(). */
+      struct Registration
+      {
+         T*   factory;
+         bool pushToFrontFlag;
+         T*   beforeThisFactory;
+      };
+      typedef std::vector<Registration> RegistrationList;
       
-      ossimFactoryListInterface(){}
+      ossimFactoryListInterface()
+         :m_captureList(0)
+      {}
       
       /**
        * This is for backward compatability and calls registerFactory for simple adds.
@@ -67,7 +79,7 @@ class ossimFactoryListInterface
       {
          if(!factory) return;
          std::lock_guard<std::mutex> lock(m_factoryListMutex);
-         if(!findFactory(factory))
+         if(!findFactory(factory)&&!capture(factory, pushToFrontFlag, 0))
          {
             if (pushToFrontFlag)
             {
@@ -133,7 +145,7 @@ class ossimFactoryListInterface
       void registerFactoryToFront(T* factory)
       {
          std::lock_guard<std::mutex> lock(m_factoryListMutex);
-         if(!findFactory(factory))
+         if(!findFactory(factory)&&!capture(factory, true, 0))
          {
             m_factoryList.insert(m_factoryList.begin(), factory);
          }
@@ -146,7 +158,7 @@ class ossimFactoryListInterface
       void registerFactoryBefore(T* factory, T* beforeThisFactory)
       {
          std::lock_guard<std::mutex> lock(m_factoryListMutex);
-         if(!findFactory(factory))
+         if(!findFactory(factory)&&!capture(factory, false, beforeThisFactory))
          {
             ossim_uint32 idx = 0;
             for(idx = 0; idx < m_factoryList.size(); ++idx)
@@ -160,6 +172,39 @@ class ossimFactoryListInterface
             m_factoryList.push_back(factory);
          }
       }
+
+      /**
+       * While list is set, factories registered by the calling thread are appended to list
+       * instead of the registry.  Lets a plugin be loaded in the middle of a call walking the
+       * factory list without changing it.  Pass 0 to stop.
+       *
+       * @return The list set before, so captures can nest.
+       */
+      RegistrationList* setCaptureList(RegistrationList* list)
+      {
+         std::lock_guard<std::mutex> lock(m_factoryListMutex);
+         RegistrationList* previous = m_captureList;
+         m_captureList = list;
+         m_captureThread = std::this_thread::get_id();
+         return previous;
+      }
+
+      /** Makes the registrations held back by setCaptureList(). */
+      void registerFactories(const RegistrationList& registrations)
+      {
+         for(std::size_t idx = 0; idx < registrations.size(); ++idx)
+         {
+            const Registration& r = registrations[idx];
+            if(r.beforeThisFactory)
+            {
+               registerFactoryBefore(r.factory, r.beforeThisFactory);
+            }
+            else
+            {
+               registerFactory(r.factory, r.pushToFrontFlag);
+            }
+         }
+      }
       
       /**
        *
@@ -216,8 +261,32 @@ class ossimFactoryListInterface
          
          return false;
       }
+
+      /**
+       * Utility to hold back a registration while capturing.  Caller holds m_factoryListMutex.
+       * @return true if captured.
+       */
+      bool capture(T* factory, bool pushToFrontFlag, T* beforeThisFactory)
+      {
+         if(!m_captureList||(m_captureThread != std::this_thread::get_id()))
+         {
+            return false;
+         }
+         for(std::size_t idx = 0; idx < m_captureList->size(); ++idx)
+         {
+            if((*m_captureList)[idx].factory == factory)
+            {
+               return true;
+            }
+         }
+         Registration r = { factory, pushToFrontFlag, beforeThisFactory };
+         m_captureList->push_back(r);
+         return true;
+      }
       mutable std::mutex m_factoryListMutex;
       FactoryListType m_factoryList;
+      RegistrationList* m_captureList;
+      std::thread::id m_captureThread;
    };
 
 template <class T, class NativeType>
@@ -36,6 +36,16 @@ public:
     */
    virtual double offsetFromEllipsoid(const ossimGpt& gpt) = 0;
 
+   /**
+    *  Batch form of offsetFromEllipsoid.  Fills offsets with one value per
+    *  point, ossim::nan() where the grid does not contain the point.  The
+    *  base version loops over offsetFromEllipsoid; geoids with a grid in
+    *  memory override it to skip the per point overhead.
+    */
+   virtual void offsetsFromEllipsoid(const ossimGpt* gpts,
+                                     double* offsets,
+                                     ossim_uint32 count);
+
 protected:
    virtual ~ossimGeoid();
    
@@ -25,6 +25,7 @@
 #define GEOID_LAT_ERROR             0x0008
 #define GEOID_LON_ERROR             0x0010
 
+class ossimDatum;
 class ossimGpt;
 
 class OSSIMDLLEXPORT ossimGeoidEgm96 : public ossimGeoid
@@ -48,6 +49,16 @@ public:
     */
    virtual double offsetFromEllipsoid(const ossimGpt& gpt);
 
+   /**
+    *  Batch form.  Points in the WGS84 datum are used as is, the corner
+    *  posts of each point are found in one pass and the bilinear
+    *  interpolation runs two points at a time with SSE2 where available.
+    *  Results match offsetFromEllipsoid exactly.
+    */
+   virtual void offsetsFromEllipsoid(const ossimGpt* gpts,
+                                     double* offsets,
+                                     ossim_uint32 count);
+
    double geoidToEllipsoidHeight(double lat,
                                  double lon,
                                  double geoidHeight);
@@ -57,8 +68,23 @@ public:
                            double ellipsoidHeight);
 protected:
 
+   /**
+    *  Finds the north west post of the grid cell holding a WGS84 point,
+    *  wrapping latitude and longitude into range first.
+    *  @param index Offset of the post in theGeoidHeightBuffer.
+    *  @param dx, dy Position in the cell, 0 to 1 east and south.
+    *  @return false if the point is out of range (or NaN).
+    */
+   bool locate(double lat, double lon, long& index, double& dx, double& dy) const;
+
+   /** Bilinear interpolation in the cell at index. */
+   double interpolate(long index, double dx, double dy) const;
+
    std::vector<float> theGeoidHeightBuffer;
    mutable float* theGeoidHeightBufferPtr;
+
+   /** WGS84 datum of the grid, so points already in it skip the datum shift. */
+   const ossimDatum* theWgs84Datum;
    TYPE_DATA
 };
 
@@ -49,6 +49,14 @@ public:
     */
    virtual double offsetFromEllipsoid(const ossimGpt& gpt);
 
+   /**
+    *  Batch form.  Each geoid in the list is asked once for all the points
+    *  the geoids before it did not contain.
+    */
+   virtual void offsetsFromEllipsoid(const ossimGpt* gpts,
+                                     double* offsets,
+                                     ossim_uint32 count);
+
    /**
     * Method to save the state of the object to a keyword list.
     * Return true if ok or false on error. DO NOTHING
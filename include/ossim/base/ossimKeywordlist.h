@@ -568,6 +568,11 @@ protected:
                   bool  ignoreBinaryChars = false);
 
    bool isValidKeywordlistCharacter(ossim_uint8 c)const;
+
+   /*!
+    *  Stream readers for one statement at a time.  parseStream no longer uses
+    *  these, it tokenizes whole blocks; they are kept for derived classes.
+    */
    void skipWhitespace(ossim::istream& in)const;
    KeywordlistParseState readComments(ossimString& sequence, ossim::istream& in)const;
    KeywordlistParseState readPreprocDirective(ossim::istream& in);
@@ -575,6 +580,12 @@ protected:
    KeywordlistParseState readValue(ossimString& sequence, ossim::istream& in)const;
    KeywordlistParseState readKeyAndValuePair(ossimString& key,
                                              ossimString& value, ossim::istream& in)const;
+
+   /**
+    * Handles a line starting with '#' found by parseStream.  Only "#include <file>" does
+    * anything, others are ignored like comments.
+    */
+   void parsePreprocDirective(const ossimString& line);
    
    // Method to see if keyword exists in list.
    KeywordMap::iterator getMapEntry(const std::string& key);
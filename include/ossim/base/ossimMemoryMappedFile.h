@@ -0,0 +1,71 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+#ifndef ossimMemoryMappedFile_HEADER
+#define ossimMemoryMappedFile_HEADER 1
+
+#include <ossim/base/ossimConstants.h>
+#include <ossim/base/ossimFilename.h>
+#include <memory>
+
+/**
+* Read only memory mapping of a whole file.
+*
+* Mappings are shared: open() hands back the mapping already made for the same file name if
+* one is still in use, so every thread and every copy of an elevation database reads a cell
+* through one mapping, and processes on the same host share the pages through the page cache.
+* The file is unmapped when the last shared_ptr to it goes away.
+*
+* Example:
+* @code
+* std::shared_ptr<ossimMemoryMappedFile> mf = ossimMemoryMappedFile::open(file);
+* if ( mf )
+* {
+*    const ossim_uint8* buf = mf->getData();
+*    ...
+* }
+* @endcode
+*/
+class OSSIM_DLL ossimMemoryMappedFile
+{
+public:
+   /**
+    * @return Mapping of file, or an empty pointer if file is empty or cannot be mapped, e.g.
+    * it is not a local file.
+    */
+   static std::shared_ptr<ossimMemoryMappedFile> open(const ossimFilename& file);
+
+   ~ossimMemoryMappedFile();
+
+   /** @return Start of the mapped file. */
+   const ossim_uint8* getData() const { return m_data; }
+
+   /** @return Size of the mapped file in bytes. */
+   ossim_uint64 getSize() const { return m_size; }
+
+   const ossimFilename& getFilename() const { return m_filename; }
+
+private:
+   ossimMemoryMappedFile(const ossimFilename& file);
+
+   /** Maps m_filename. @return true on success. */
+   bool map();
+
+   // Disallow copy.
+   ossimMemoryMappedFile(const ossimMemoryMappedFile&);
+   ossimMemoryMappedFile& operator=(const ossimMemoryMappedFile&);
+
+   ossimFilename      m_filename;
+   const ossim_uint8* m_data;
+   ossim_uint64       m_size;
+#if defined(_WIN32)
+   void*              m_fileHandle;
+   void*              m_mappingHandle;
+#endif
+};
+
+#endif /* #ifndef ossimMemoryMappedFile_HEADER */
@@ -143,6 +143,12 @@ public:
    virtual bool loadState(const ossimKeywordlist& kwl, const char* prefix=0);
 
 protected:
+   /**
+    * Copies rhs into m_dataBuffer, taking storage from ossimTileBufferPool
+    * if the current buffer is too small.
+    */
+   void copyDataBuffer(const std::vector<ossim_uint8>& rhs);
+
    ossim_uint64 m_numberOfDataComponents;
    ossimScalarType           m_scalarType;
    std::vector<ossim_uint8>  m_dataBuffer;
@@ -0,0 +1,106 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+#ifndef ossimRtree_HEADER
+#define ossimRtree_HEADER 1
+
+#include <ossim/base/ossimConstants.h>
+#include <vector>
+
+/**
+* Static R-tree of axis aligned rectangles, each carrying a 64 bit id.
+*
+* Rectangles are added with add() and then packed bottom up with the Sort-Tile-Recursive
+* algorithm by build(), which gives nearly full nodes with little overlap.  The tree is not
+* updated in place; after adding or removing items call build() again.  Once built, point and
+* rectangle searches only descend nodes whose bounds contain the query, so a lookup over many
+* thousands of rectangles costs a few dozen box tests.
+*
+* Searches are const and may be run from several threads at once.
+*
+* Example:
+* @code
+* ossimRtree tree;
+* tree.add(id, minLon, minLat, maxLon, maxLat);
+* ...
+* tree.build();
+* std::vector<ossim_uint64> ids;
+* tree.findPoint(lon, lat, ids);
+* @endcode
+*/
+class OSSIM_DLL ossimRtree
+{
+public:
+   /** @param nodeCapacity Maximum number of children of a node. */
+   ossimRtree(ossim_uint32 nodeCapacity=16);
+
+   /** Removes all items. */
+   void clear();
+
+   /** Adds a rectangle.  Not searchable until build() is called. */
+   void add(ossim_uint64 id, double minX, double minY, double maxX, double maxY);
+
+   /** Packs the items added so far into the tree. */
+   void build();
+
+   /** @return Number of items. */
+   ossim_uint32 size() const { return (ossim_uint32)m_items.size(); }
+
+   bool empty() const { return m_items.empty(); }
+
+   /**
+    * Appends to ids the id of every rectangle containing point x, y, edges included.
+    * @return true if any were found.
+    */
+   bool findPoint(double x, double y, std::vector<ossim_uint64>& ids) const;
+
+   /**
+    * Appends to ids the id of every rectangle intersecting the rectangle, edges included.
+    * @return true if any were found.
+    */
+   bool findIntersecting(double minX, double minY, double maxX, double maxY,
+                         std::vector<ossim_uint64>& ids) const;
+
+private:
+   struct Box
+   {
+      bool intersects(const Box& b) const
+      {
+         return (minX <= b.maxX) && (b.minX <= maxX) && (minY <= b.maxY) && (b.minY <= maxY);
+      }
+      void expand(const Box& b);
+
+      double minX;
+      double minY;
+      double maxX;
+      double maxY;
+   };
+
+   struct Item
+   {
+      Box          box;
+      ossim_uint64 id;
+   };
+
+   /** Children are m_nodes, or m_items for a leaf, [first, first + count). */
+   struct Node
+   {
+      Box          box;
+      ossim_uint32 first;
+      ossim_uint32 count;
+      bool         leaf;
+   };
+
+   bool search(const Box& query, std::vector<ossim_uint64>& ids) const;
+
+   ossim_uint32       m_nodeCapacity;
+   std::vector<Item>  m_items;
+   std::vector<Node>  m_nodes;
+   bool               m_built;
+};
+
+#endif /* #ifndef ossimRtree_HEADER */
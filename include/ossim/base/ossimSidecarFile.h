@@ -0,0 +1,85 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Description: Helpers shared by the readers and writers of the binary and keyword list side
+// files OSSIM keeps next to images and in its caches (block indexes, projection grids, image
+// handler states).
+//
+//**************************************************************************************************
+//  $Id$
+#ifndef ossimSidecarFile_HEADER
+#define ossimSidecarFile_HEADER 1
+
+#include <ossim/base/ossimConstants.h>
+#include <ossim/base/ossimFilename.h>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+namespace ossim
+{
+   /**
+    * @brief Name to write file under before replaceFile() moves it into place.
+    *
+    * Made from file plus a suffix unique to the calling thread and moment, so concurrent
+    * writers in one or several processes do not share it.
+    */
+   OSSIM_DLL ossimFilename getSidecarTempFile(const ossimFilename& file);
+
+   /**
+    * @brief Moves tmp over file, replacing any file already there.
+    *
+    * A reader in another process sees the old file or the new one, never part of one, and of
+    * two writers the last one wins whole.  Unlike ossimFilename::rename this does not remove
+    * file first.  On failure tmp is removed and file left as it was.
+    *
+    * @return true on success.
+    */
+   OSSIM_DLL bool replaceFile(const ossimFilename& tmp, const ossimFilename& file);
+
+   /** Writes the magic, version and byte order mark that start a binary side file. */
+   OSSIM_DLL void writeSidecarHeader(std::ostream& out, const char magic[8], ossim_uint32 version);
+
+   /**
+    * @return true if in starts with the header writeSidecarHeader writes for magic and
+    * version on a machine of the same byte order.
+    */
+   OSSIM_DLL bool readSidecarHeader(std::istream& in, const char magic[8], ossim_uint32 version);
+
+   /** Writes v in native byte order. */
+   template <class T> void writeValue(std::ostream& out, const T& v)
+   {
+      out.write((const char*)&v, sizeof(T));
+   }
+
+   /** Reads a value written by writeValue. */
+   template <class T> bool readValue(std::istream& in, T& v)
+   {
+      in.read((char*)&v, sizeof(T));
+      return in.good();
+   }
+
+   /** Writes the elements of v, not its size. */
+   template <class T> void writeArray(std::ostream& out, const std::vector<T>& v)
+   {
+      if ( v.size() )
+      {
+         out.write((const char*)&v.front(), v.size() * sizeof(T));
+      }
+   }
+
+   /** Reads size elements written by writeArray into v. */
+   template <class T> bool readArray(std::istream& in, std::vector<T>& v, ossim_uint64 size)
+   {
+      v.resize( (std::size_t)size );
+      if ( size )
+      {
+         in.read((char*)&v.front(), size * sizeof(T));
+      }
+      return !in.fail();
+   }
+}
+
+#endif /* #ifndef ossimSidecarFile_HEADER */
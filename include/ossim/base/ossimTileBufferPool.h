@@ -0,0 +1,114 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+#ifndef ossimTileBufferPool_HEADER
+#define ossimTileBufferPool_HEADER 1
+
+#include <ossim/base/ossimConstants.h>
+#include <atomic>
+#include <iosfwd>
+#include <mutex>
+#include <vector>
+
+/**
+* Recycles the byte buffers behind ossimRectilinearDataObject (and so ossimImageData).
+*
+* Tile producers allocate and free buffers of the same few sizes over and over. Instead of
+* handing them back to the allocator, a destroyed data object gives its buffer to the pool, and
+* the next object needing a buffer of that size picks it up. Buffers are binned by power of two
+* capacity and held in one pool guarded by a mutex, so every pooled byte counts against the
+* limit and flush() frees them all.
+*
+* The pool size is read from the "tile_buffer_pool_size" preference in megabytes.  Pooling is
+* off unless that is set, and a value of 0 disables it.
+*
+* Buffers come out of the pool holding stale data. Callers must fill or blank them.
+*/
+class OSSIM_DLL ossimTileBufferPool
+{
+public:
+   typedef std::vector<ossim_uint8> Buffer;
+
+   /** Counters are cumulative since startup or the last call to resetStatistics(). */
+   struct OSSIM_DLL Statistics
+   {
+      Statistics();
+
+      /** Prints the statistics in keyword: value form. */
+      std::ostream& print(std::ostream& out) const;
+
+      ossim_uint64 hits;          //!< acquire() served from the pool.
+      ossim_uint64 misses;        //!< acquire() that found nothing suitable.
+      ossim_uint64 releases;      //!< Buffers taken back by release().
+      ossim_uint64 discards;      //!< Buffers release() let go because the pool was full.
+      ossim_uint64 pooledBytes;   //!< Bytes currently held by the pool.
+   };
+
+   static ossimTileBufferPool* instance();
+
+   /**
+    * Sets the pool size from the "tile_buffer_pool_size" preference, if present.  Called on
+    * construction and again by ossimInit once the preferences are loaded, as the pool may be
+    * used first.
+    */
+   void readPreferences();
+
+   /**
+    * Puts a pooled buffer able to hold size bytes into buffer and resizes it to size. The
+    * previous contents of buffer are released to the pool first.
+    *
+    * @return true on a pool hit, false if nothing was found in which case buffer is left empty.
+    */
+   bool acquire(Buffer& buffer, ossim_uint64 size);
+
+   /**
+    * Takes the storage of buffer for later reuse. buffer is left empty either way.
+    */
+   void release(Buffer& buffer);
+
+   /** Frees everything held by the pool. */
+   void flush();
+
+   void setEnabled(bool flag);
+   bool getEnabled() const;
+
+   /** Sets the byte limit of the pool. */
+   void setMaxPoolSize(ossim_uint64 bytes);
+   ossim_uint64 getMaxPoolSize() const;
+
+   Statistics getStatistics() const;
+   void resetStatistics();
+
+   /** Buffers smaller than this go straight to the allocator. */
+   static const ossim_uint64 MIN_BUFFER_SIZE;
+
+   /** Number of power of two bins. */
+   static const ossim_uint32 NUMBER_OF_BINS = 40;
+
+protected:
+   ossimTileBufferPool();
+
+   /** @return The bin for a buffer of the given capacity. */
+   static ossim_uint32 getBin(ossim_uint64 capacity);
+
+   /** Takes a buffer that holds at least size bytes from the bin, if there is one. */
+   static bool take(std::vector<Buffer>& bin, Buffer& buffer, ossim_uint64 size);
+
+   std::atomic<bool>         m_enabled;
+   std::atomic<ossim_uint64> m_maxPoolSize;
+   std::atomic<ossim_uint64> m_pooledBytes;
+
+   mutable std::mutex  m_mutex;
+   std::vector<Buffer> m_bins[NUMBER_OF_BINS];
+
+   std::atomic<ossim_uint64> m_hits;
+   std::atomic<ossim_uint64> m_misses;
+   std::atomic<ossim_uint64> m_releases;
+   std::atomic<ossim_uint64> m_discards;
+};
+
+#endif
@@ -24,6 +24,7 @@
 #include <fstream>
 
 #include <ossim/base/ossimConstants.h>
+#include <ossim/base/ossimMemoryMappedFile.h>
 #include <ossim/base/ossimString.h>
 #include <ossim/elevation/ossimElevCellHandler.h>
 #include <ossim/support_data/ossimDtedVol.h>
@@ -67,6 +68,7 @@ public:
    * Constructor
    */
    ossimDtedHandler()
+      : m_postBuf(0)
    {
    }
 
@@ -75,9 +77,9 @@ public:
    *
    * @param dted_file is a file path to the dted cell we wish to
    *        open
-   * @param memoryMapFlag If this is set we will pull the entire cell
-   *        into memory and treat that memory location as an 
-   *        inputstream.
+   * @param memoryMapFlag If this is set the cell is memory mapped, falling
+   *        back to reading the entire cell into memory if it is not a
+   *        local file.
    */
    ossimDtedHandler(const ossimFilename& dted_file, bool memoryMapFlag=false);
 
@@ -94,9 +96,9 @@ public:
    *
    * @param file is a file path to the dted cell we wish to
    *        open
-   * @param memoryMapFlag If this is set we will pull the entire cell
-   *        into memory and treat that memory location as an 
-   *        inputstream.
+   * @param memoryMapFlag If this is set the cell is memory mapped, falling
+   *        back to reading the entire cell into memory if it is not a
+   *        local file.
    */
    virtual bool open(const ossimFilename& file, bool memoryMapFlag=false);
 
@@ -107,9 +109,9 @@ public:
    *        to a cell.
    * @param connectionString is the connection string used to open the
    *        input stream.
-   * @param memoryMapFlag If this is set we will pull the entire cell
-   *        into memory and treat that memory location as an 
-   *        inputstream.
+   * @param memoryMapFlag If this is set the cell is memory mapped, falling
+   *        back to reading the entire cell into memory if it is not a
+   *        local file.
    */
    virtual bool open(std::shared_ptr<ossim::istream>& fileStr, const std::string& connectionString, bool memoryMapFlag=false);
    virtual void close();
@@ -121,6 +123,14 @@ public:
     */
    virtual double getHeightAboveMSL(const ossimGpt& gpt);
 
+   /**
+    * @brief Batch getHeightAboveMSL.  Picks the memory map or file path once
+    * and interpolates every point without further dispatch.
+    */
+   virtual void getHeightsAboveMSL(const ossimGpt* gpts,
+                                   double*         heights,
+                                   ossim_uint32    count);
+
    /*!
     *  METHOD:  getSizeOfElevCell
     *  Returns the number of post in the cell.  Satisfies pure virtual.
@@ -166,7 +176,7 @@ public:
 
    virtual ossimObject* dup () const
    {
-      return new ossimDtedHandler(this->getFilename(), (m_memoryMap.size() != 0));
+      return new ossimDtedHandler(this->getFilename(), (m_postBuf != 0));
    }
 
    virtual ~ossimDtedHandler();
@@ -254,6 +264,12 @@ protected:
 
    mutable std::mutex m_memoryMapMutex;
    mutable std::vector<ossim_uint8> m_memoryMap;
+
+   /** Shared read only mapping of the cell when memory mapped. */
+   std::shared_ptr<ossimMemoryMappedFile> m_mappedFile;
+
+   /** Start of the whole cell in memory, mapped or read, else 0. */
+   const ossim_uint8* m_postBuf;
    
    std::shared_ptr<ossimDtedVol> m_vol;
    std::shared_ptr<ossimDtedHdr> m_hdr;
@@ -284,7 +300,7 @@ inline ossim_sint16 ossimDtedHandler::convertSignedMagnitude(ossim_uint16& s) co
 inline bool ossimDtedHandler::isOpen()const
 {
 
-  if(!m_memoryMap.empty()) return true;
+  if(m_postBuf) return true;
   std::lock_guard<std::mutex> lock(m_fileStrMutex);
 
   return (m_fileStr != 0);
@@ -294,6 +310,8 @@ inline void ossimDtedHandler::close()
 {
    m_fileStr.reset();
    m_memoryMap.clear();
+   m_mappedFile.reset();
+   m_postBuf = 0;
 }
 
 #endif
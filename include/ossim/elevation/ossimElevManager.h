@@ -24,10 +24,15 @@
 #include <ossim/base/ossimVisitor.h>
 #include <ossim/elevation/ossimElevSource.h>
 #include <ossim/elevation/ossimElevationDatabase.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <vector>
 
 class ossimFilename;
+class ossimGrect;
+class ossimJobMultiThreadQueue;
 
 class OSSIM_DLL ossimElevManager : public ossimElevSource
 {
@@ -58,6 +63,39 @@ public:
    
    virtual double getHeightAboveEllipsoid(const ossimGpt& gpt);
    virtual double getHeightAboveMSL(const ossimGpt& gpt);
+
+   /**
+    * @brief Batch forms of getHeightAboveEllipsoid and getHeightAboveMSL.
+    *
+    * Results are the same as the single point calls, including the default
+    * height, geoid and elevation offset fallbacks.  The database list is
+    * picked once per batch and each database is asked for all the points
+    * still without a height in one call, so cell databases take their cache
+    * lock once per cell instead of once per point.
+    */
+   virtual void getHeightsAboveEllipsoid(const ossimGpt* gpts,
+                                         double*         heights,
+                                         ossim_uint32    count);
+   virtual void getHeightsAboveMSL(const ossimGpt* gpts,
+                                   double*         heights,
+                                   ossim_uint32    count);
+
+   /**
+    * @brief Heights above ellipsoid of a regular lat/lon grid.
+    *
+    * Post (line, samp) is at origin.lat + line*latSpacing,
+    * origin.lon + samp*lonSpacing, on origin's datum.  Spacings may be
+    * negative, e.g. a north up grid starting at its upper left corner.
+    *
+    * @param heights Filled line by line, lines*samples values.
+    */
+   void getHeightsAboveEllipsoid(const ossimGpt& origin,
+                                 double          latSpacing,
+                                 double          lonSpacing,
+                                 ossim_uint32    lines,
+                                 ossim_uint32    samples,
+                                 double*         heights);
+
    virtual bool pointHasCoverage(const ossimGpt&) const;
 
    /**
@@ -177,6 +215,26 @@ public:
    bool getUseGeoidIfNullFlag() const { return m_useGeoidIfNullFlag; }
    void setRoundRobinMaxSize(ossim_uint32 size);
 
+   /**
+    * @brief Loads the cells covering bounds on a background thread.
+    *
+    * Returns immediately.  The worker samples a coarse grid over bounds
+    * through every database copy in the round robin, which opens the cells
+    * and pages in their posts, so later height queries over the area do not
+    * wait on DEM I/O.  This is only a hint: it does nothing if prefetching is
+    * disabled (key "prefetch"), the source is disabled, there are no
+    * databases, or too many requests are already pending.
+    *
+    * @return true if the request was queued.
+    */
+   bool prefetch(const ossimGrect& bounds);
+
+   /** @brief Blocks until all queued prefetch requests have been done. */
+   void waitForPrefetch();
+
+   void setPrefetchFlag(bool flag) { m_prefetchFlag = flag; }
+   bool getPrefetchFlag() const { return m_prefetchFlag; }
+
    void clear();
    /**
     * Method to save the state of an object to a keyword list.
@@ -201,6 +259,29 @@ protected:
    void loadStandardElevationPaths();
 
    ElevationDatabaseListType& getNextElevDbList() const; // for multithreading
+
+   /**
+    * Fills the NaN heights by asking each database in turn for just the
+    * points still missing.
+    */
+   void getDatabaseHeights(const ossimGpt* gpts, double* heights, ossim_uint32 count,
+                           bool aboveEllipsoid);
+
+   /**
+    * Looks up the geoid offsets of the points whose height is still NaN in one batch.
+    * missing gets their indexes and offsets the offsets, NaN where there is no geoid value.
+    */
+   void getGeoidOffsets(const ossimGpt* gpts, const double* heights, ossim_uint32 count,
+                        std::vector<ossim_uint32>& missing, std::vector<double>& offsets) const;
+
+   class PrefetchJob;
+   friend class PrefetchJob;
+
+   /** Does the work of a prefetch request on the prefetch thread. */
+   void loadCells(const ossimGrect& bounds);
+
+   /** Counts a prefetch request done and wakes waitForPrefetch on the last one. */
+   void finishPrefetch();
    
    static ossimElevManager* m_instance;
    mutable std::vector<ElevationDatabaseListType> m_dbRoundRobin;
@@ -220,6 +301,12 @@ protected:
     * For now we will use Mutex.
     */
    mutable std::mutex m_mutex;
+
+   bool                                      m_prefetchFlag;
+   std::shared_ptr<ossimJobMultiThreadQueue> m_prefetchQueue;
+   std::atomic<ossim_uint32>                 m_prefetchPending;
+   std::mutex                                m_prefetchMutex;
+   std::condition_variable                   m_prefetchDone;
 };
 
 #endif
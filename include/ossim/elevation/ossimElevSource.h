@@ -38,6 +38,20 @@ public:
    virtual double getHeightAboveMSL(const ossimGpt&) = 0;
    virtual double getHeightAboveEllipsoid(const ossimGpt&);
 
+   /**
+    * @brief Batch forms of getHeightAboveMSL and getHeightAboveEllipsoid.
+    *
+    * Fills heights[i] for gpts[i], NaN where there is no coverage.  The
+    * default implementations loop over the single point methods; sources
+    * that can look up their cells once per batch override them.
+    */
+   virtual void getHeightsAboveMSL(const ossimGpt* gpts,
+                                   double*         heights,
+                                   ossim_uint32    count);
+   virtual void getHeightsAboveEllipsoid(const ossimGpt* gpts,
+                                         double*         heights,
+                                         ossim_uint32    count);
+
    // Forces all concrete subtypes to implement:
    virtual ossimObject* dup() const = 0;
 
@@ -60,6 +74,22 @@ public:
     *  Returns true if good intersection found.
     */
    bool intersectRay(const ossimEcefRay& ray, ossimGpt& gpt, double defaultElevValue = 0.0);
+
+   /**
+    * Batch intersectRay.  Runs the same iteration as intersectRay for every
+    * ray in lock step so the heights of all rays still converging are looked
+    * up with one getHeightsAboveEllipsoid call per iteration.  Results are
+    * the same as calling intersectRay per ray.  As with intersectRay, each
+    * gpts[i] must be initialized with the desired datum.
+    *
+    * @param intersected Optional, set per ray to the intersectRay return.
+    * @return Number of rays intersected.
+    */
+   ossim_uint32 intersectRays(const ossimEcefRay* rays,
+                              ossimGpt*           gpts,
+                              ossim_uint32        count,
+                              double              defaultElevValue = 0.0,
+                              bool*               intersected = 0);
    
    /**
     * Access methods for the bounding elevations:
@@ -110,12 +110,12 @@ public:
     * @param maxNumberOfCells Value of 0 indicates return as many as you can.  Any positive
     *        number will only return that number of cells.
     */   
-   void getCellsForBounds( const ossim_float64& minLat,
-                           const ossim_float64& minLon,
-                           const ossim_float64& maxLat,
-                           const ossim_float64& maxLon,
-                           std::vector<ossimFilename>& cells,
-                           ossim_uint32 maxNumberOfCells=0 );
+   virtual void getCellsForBounds( const ossim_float64& minLat,
+                                   const ossim_float64& minLon,
+                                   const ossim_float64& maxLat,
+                                   const ossim_float64& maxLon,
+                                   std::vector<ossimFilename>& cells,
+                                   ossim_uint32 maxNumberOfCells=0 );
 
    virtual ossim_uint64 createId(const ossimGpt& /* pt */)const
    {
@@ -123,6 +123,20 @@ public:
    }
    virtual ossimRefPtr<ossimElevCellHandler> getOrCreateCellHandler(const ossimGpt& gpt);
 
+   /**
+    * @brief Batch height lookups.
+    *
+    * Consecutive points falling in the same cell are handed to that cell's
+    * handler as one run, so the cell cache is locked and searched once per
+    * cell per batch instead of once per point.
+    */
+   virtual void getHeightsAboveMSL(const ossimGpt* gpts,
+                                   double*         heights,
+                                   ossim_uint32    count);
+   virtual void getHeightsAboveEllipsoid(const ossimGpt* gpts,
+                                         double*         heights,
+                                         ossim_uint32    count);
+
    virtual std::ostream& print(std::ostream& out) const;
 
 protected:
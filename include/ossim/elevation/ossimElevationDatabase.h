@@ -79,6 +79,11 @@ protected:
    }
    virtual double getOffsetFromEllipsoid(const ossimGpt& gpt);
 
+   /** Batch form of getOffsetFromEllipsoid, 0.0 where there is no geoid value. */
+   virtual void getOffsetsFromEllipsoid(const ossimGpt* gpts,
+                                        double*         offsets,
+                                        ossim_uint32    count);
+
    ossimString m_connectionString;
    ossimRefPtr<ossimGeoid>    m_geoid;
    ossim_float64              m_meanSpacing;
@@ -13,6 +13,7 @@
 #define ossimGeneralRasterElevHandler_HEADER
 #include <list>
 #include <ossim/base/ossimIoStream.h>
+#include <ossim/base/ossimMemoryMappedFile.h>
 //#include <fstream>
 
 #include <ossim/base/ossimString.h>
@@ -163,6 +164,12 @@ private:
    bool          m_streamOpen;
    
    std::vector<char> m_memoryMap;
+
+   /** Shared read only mapping of the cell when memory mapped. */
+   std::shared_ptr<ossimMemoryMappedFile> m_mappedFile;
+
+   /** Start of the whole cell in memory, mapped or read, else 0. */
+   const char* m_postBuf;
 TYPE_DATA
 };
 
@@ -20,9 +20,14 @@
 #include <ossim/base/ossimFilename.h>
 #include <ossim/base/ossimGrect.h>
 #include <ossim/base/ossimRefPtr.h>
+#include <ossim/base/ossimRtree.h>
 #include <ossim/base/ossimRtti.h>
 #include <iosfwd>
 #include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
 
 class ossimString;
 
@@ -125,6 +130,19 @@ public:
     */
    void getBoundingRect(ossimGrect& rect) const;
 
+   /**
+    * @brief Gets the files whose bounding rectangles intersect the bounding box.
+    *
+    * Overrides ossimElevationCellDatabase::getCellsForBounds to look the files up in the
+    * spatial index instead of opening a cell every 0.1 degree.
+    */
+   virtual void getCellsForBounds( const ossim_float64& minLat,
+                                   const ossim_float64& minLon,
+                                   const ossim_float64& maxLat,
+                                   const ossim_float64& maxLon,
+                                   std::vector<ossimFilename>& cells,
+                                   ossim_uint32 maxNumberOfCells=0 );
+
    /**
     * @brief ProcessFile method.
     *
@@ -188,6 +206,9 @@ private:
       /** Bounding rectangle in decimal degrees. */
       ossimGrect m_rect;
 
+      /** Modification time of m_file in seconds since the epoch, 0 if unknown. */
+      ossim_int64 m_modTime;
+
       // post spacing at center
       // ossimDpt m_nominalGSD;
 
@@ -195,6 +216,14 @@ private:
       bool m_loadedFlag;
    };  
 
+   /**
+    * @brief Loads m_entryMap from the map file or by walking m_connectionString, builds the
+    * index and writes the map file if it changed.
+    *
+    * The map file is only written here, when the database is opened, never from queries.
+    */
+   void loadMap();
+
    /**
     * @brief Initializes m_entryMap with all loadable files from
     * m_connectionString.
@@ -202,15 +231,76 @@ private:
    void loadFileMap();
 
    /**
-    * @brief Initializes m_entryMap with all loadable files from
-    * m_connectionString.
+    * @brief Initializes m_entryMap from the elev_cell_map.kwl saved in
+    * m_connectionString, or the map kept in memory if it could not be written, then brings
+    * it up to date with the directory.
     */
    bool loadMapFromKwl();
 
+   /**
+    * @brief Brings m_entryMap loaded from the map file up to date.
+    *
+    * Drops entries for files that no longer exist, recaptures the rectangle of files
+    * modified since the map was written and, if any directory in m_dirModTimes changed
+    * since, walks m_connectionString again to pick up new files.
+    *
+    * @return true if m_entryMap or m_dirModTimes changed.
+    */
+   bool refreshFileMap();
+
+   /**
+    * @brief Writes m_entryMap and m_dirModTimes to elev_cell_map.kwl in m_connectionString,
+    * through a temporary file moved into place.  If the directory is read only the map is
+    * kept in memory for the next open in this process instead.
+    */
+   void saveFileMap() const;
+
+   /**
+    * @brief Builds m_entryIndex over the m_entryMap rectangles.
+    *
+    * Entries with no rectangle, e.g. files that could not be opened when mapped, go to
+    * m_unindexedIds instead and are opened on the first query that gets to them.
+    */
+   void buildIndex();
+
+   /**
+    * @brief createCell for the entries in m_unindexedIds.
+    *
+    * Captures the rectangles of those not opened yet and sets m_mapDirty so the next open
+    * writes them to the map file.
+    */
+   ossimRefPtr<ossimElevCellHandler> createUnindexedCell(const ossimGpt& gpt);
+
+   /** @return true if the rectangle of an entry in m_unindexedIds holds gpt. */
+   bool unindexedHasCoverage(const ossimGpt& gpt) const;
+
    /** Hidden from use copy constructor */
    ossimImageElevationDatabase(const ossimImageElevationDatabase& copy_this);
    
    std::map<ossim_uint64, ossimImageElevationFileEntry> m_entryMap;
+
+   /** Spatial index of m_entryMap rectangles (lon, lat) keyed by m_entryMap key. */
+   ossimRtree         m_entryIndex;
+
+   /**
+    * Keys of m_entryMap entries left out of m_entryIndex for having no rectangle.  Guarded,
+    * with their rectangles, by m_unindexedMutex.
+    */
+   std::vector<ossim_uint64> m_unindexedIds;
+   mutable std::mutex        m_unindexedMutex;
+
+   /** Files already in m_entryMap that processFile skips when walking again. */
+   std::set<std::string> m_knownFiles;
+
+   /**
+    * Modification times of m_connectionString and every directory below it when last walked.
+    * A new file anywhere in the tree changes the time of the directory holding it.
+    */
+   std::map<std::string, ossim_int64> m_dirModTimes;
+
+   /** True if m_entryMap has changes not yet in the map file.  Guarded by m_unindexedMutex. */
+   bool m_mapDirty;
+
    ossim_uint64       m_lastMapKey;
    ossim_uint64       m_lastAccessedId;
 
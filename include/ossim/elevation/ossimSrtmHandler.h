@@ -14,6 +14,7 @@
 #define ossimSrtmHandler_HEADER
 
 #include <ossim/base/ossimIoStream.h>
+#include <ossim/base/ossimMemoryMappedFile.h>
 //#include <fstream>
 
 #include <ossim/base/ossimString.h>
@@ -77,7 +78,7 @@ public:
    virtual ossimObject* dup() const
    {
       ossimSrtmHandler* obj = new ossimSrtmHandler();
-      obj->open(theFilename, (m_memoryMap.size() != 0));
+      obj->open(theFilename, (m_postBuf != 0));
       return obj;
    }
 
@@ -101,6 +102,12 @@ protected:
    ossimScalarType  m_scalarType;
    
    mutable std::vector<ossim_int8> m_memoryMap;
+
+   /** Shared read only mapping of the cell when memory mapped. */
+   std::shared_ptr<ossimMemoryMappedFile> m_mappedFile;
+
+   /** Start of the whole cell in memory, mapped or read, else 0. */
+   const ossim_int8* m_postBuf;
    
    template <class T>
    double getHeightAboveMSLFileTemplate(T dummy, const ossimGpt& gpt);
@@ -12,17 +12,30 @@
 // $Id: ossimAppFixedTileCache.h 20127 2011-10-12 11:27:10Z gpotts $
 #ifndef ossimAppFixedTileCache_HEADER
 #define ossimAppFixedTileCache_HEADER
-#include <map>
-#include <list>
+#include <unordered_map>
 #include <iostream>
 #include <ossim/base/ossimConstants.h>
 #include <ossim/base/ossimRefPtr.h>
 #include <ossim/base/ossimIrect.h>
+#include <ossim/imaging/ossimFixedTileCache.h>
+#include <atomic>
 #include <mutex>
+#include <vector>
 
-class ossimFixedTileCache;
 class ossimImageData;
 
+/**
+ * Process wide registry of ossimFixedTileCache instances.
+ *
+ * Caches are spread over a fixed number of shards by id, each with its own
+ * lock that is only held to look a cache up, so threads working on different
+ * cache ids do not serialize on each other; tile access then only locks the
+ * one cache.  The total size is a byte count kept up to date by the caches
+ * themselves.  When an add takes it over the max cache size, least recently
+ * used tiles are evicted round robin across the caches until the total is
+ * back under 90% of the max.
+ */
+
 class OSSIM_DLL ossimAppFixedTileCache
 {
 public:
@@ -69,6 +82,9 @@ public:
    virtual void setMaxCacheSize(ossim_uint32 cacheSize);
    virtual ossim_uint32 getMaxCacheSize() const { return theMaxCacheSize; }
 
+   /** @return Sum of the sizes in bytes of all caches. */
+   ossim_uint64 getCurrentCacheSize() const;
+
 protected:
 //    struct ossimAppFixedCacheTileInfo
 //    {
@@ -88,11 +104,29 @@ protected:
 //          } 
 //    };
    
+   /** Number of cache registry shards. */
+   static const ossim_uint32 SHARD_COUNT = 16;
+
+   typedef std::unordered_map<ossimAppFixedCacheId,
+                              ossimRefPtr<ossimFixedTileCache> > CacheMap;
+
+   /** One registry shard.  Aligned to keep neighboring shard locks apart. */
+   struct alignas(64) CacheShard
+   {
+      mutable std::mutex theMutex;
+      CacheMap           theCacheMap;
+   };
+
    ossimAppFixedTileCache();
    
-   ossimFixedTileCache* getCache(ossimAppFixedCacheId cacheId);
+   ossimRefPtr<ossimFixedTileCache> getCache(ossimAppFixedCacheId cacheId);
+   CacheShard& getShard(ossimAppFixedCacheId cacheId);
+   void addCache(ossimAppFixedCacheId cacheId, ossimFixedTileCache* cache);
+
+   /** Initializes caches with all registered caches. */
+   void getCaches(std::vector<ossimRefPtr<ossimFixedTileCache> >& caches);
 
-   void shrinkGlobalCacheSize(ossim_int32 byteCount);
+   void shrinkGlobalCacheSize(ossim_int64 byteCount);
    void shrinkCacheSize(ossimAppFixedCacheId id,
                         ossim_int32 byteCount);
    void shrinkCacheSize(ossimFixedTileCache* cache,
@@ -104,15 +138,19 @@ protected:
    /*!
     * Will hold the current unique Application id.
     */
-   static ossimAppFixedCacheId    theUniqueAppIdCounter;
+   static std::atomic<ossimAppFixedCacheId> theUniqueAppIdCounter;
    ossimIpt                       theTileSize;
-   ossim_uint32                   theMaxCacheSize;
-   ossim_uint32                   theMaxGlobalCacheSize;
-   ossim_uint32                   theCurrentCacheSize;
+   std::atomic<ossim_uint32>      theMaxCacheSize;
+   std::atomic<ossim_uint32>      theMaxGlobalCacheSize;
+   std::atomic<ossim_int64>       theCurrentCacheSize;
 
-   std::map<ossimAppFixedCacheId, ossimFixedTileCache*> theAppCacheMap;
+   CacheShard                     theShards[SHARD_COUNT];
 
+   /** Guards theTileSize. */
    std::mutex theMutex;
+
+   /** Held by the one thread evicting for the global limit. */
+   std::mutex theShrinkMutex;
 };
 
 #endif
@@ -0,0 +1,70 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+#ifndef ossimDeferredImageHandlerFactory_HEADER
+#define ossimDeferredImageHandlerFactory_HEADER 1
+
+#include <ossim/imaging/ossimImageHandlerFactoryBase.h>
+#include <ossim/base/ossimFactoryListInterface.h>
+#include <ossim/plugin/ossimDeferredPlugin.h>
+#include <memory>
+
+/**
+* Stands in the ossimImageHandlerRegistry for the image handler factories of a plugin that is
+* not loaded yet.  Lists extensions and types from the plugin manifest.  Loads the plugin when
+* a request reaches it that the plugin may serve, i.e. every factory before it failed, and
+* passes the request on to the factories the plugin registered.
+*
+* Suffix and type requests for something the plugin does not list do not load it, so e.g. a
+* .tif opened by a core reader never loads a plugin registered behind it.
+*/
+class OSSIMDLLEXPORT ossimDeferredImageHandlerFactory : public ossimImageHandlerFactoryBase,
+                                                         public ossimDeferredPlugin::Listener
+{
+public:
+   ossimDeferredImageHandlerFactory(std::shared_ptr<ossimDeferredPlugin> plugin);
+
+   virtual ossimImageHandler* open(const ossimFilename& fileName,
+                                   bool openOverview=true)const;
+   virtual ossimImageHandler* open(const ossimKeywordlist& kwl,
+                                   const char* prefix=0)const;
+   virtual ossimRefPtr<ossimImageHandler> open(std::shared_ptr<ossim::istream>& str,
+                                               const std::string& connectionString,
+                                               bool openOverview=true)const;
+   virtual ossimRefPtr<ossimImageHandler> open(
+      std::shared_ptr<ossim::ImageHandlerState> state)const;
+   virtual ossimRefPtr<ossimImageHandler> openOverview(const ossimFilename& file)const;
+   virtual ossimRefPtr<ossimImageHandler> openOverview(std::shared_ptr<ossim::istream>& str,
+                                                       const ossimString& connectionString)const;
+   virtual void getImageHandlersBySuffix(ImageHandlerList& result, const ossimString& ext)const;
+   virtual void getImageHandlersByMimeType(ImageHandlerList& result,
+                                           const ossimString& mimeType)const;
+   virtual void getSupportedExtensions(UniqueStringList& extensionList)const;
+
+   virtual ossimObject* createObject(const ossimString& typeName)const;
+   virtual ossimObject* createObject(const ossimKeywordlist& kwl, const char* prefix=0)const;
+   virtual void getTypeNameList(std::vector<ossimString>& typeList)const;
+
+   virtual void beginLoad();
+   virtual void endLoad();
+
+private:
+   typedef ossimFactoryListInterface<ossimImageHandlerFactoryBase,
+                                     ossimImageHandler>::RegistrationList RegistrationList;
+
+   /** Loads the plugin.  @return The factories it registered. */
+   const RegistrationList& load(const ossimString& reason)const;
+
+   std::shared_ptr<ossimDeferredPlugin> m_plugin;
+   const ossimPluginManifest::Services& m_services;
+   RegistrationList                     m_registrations;
+   RegistrationList*                    m_previousCapture;
+
+TYPE_DATA
+};
+
+#endif /* #ifndef ossimDeferredImageHandlerFactory_HEADER */
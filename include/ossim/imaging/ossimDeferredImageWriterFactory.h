@@ -0,0 +1,62 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+#ifndef ossimDeferredImageWriterFactory_HEADER
+#define ossimDeferredImageWriterFactory_HEADER 1
+
+#include <ossim/imaging/ossimImageWriterFactoryBase.h>
+#include <ossim/base/ossimFactoryListInterface.h>
+#include <ossim/plugin/ossimDeferredPlugin.h>
+#include <memory>
+
+/**
+* Stands in the ossimImageWriterFactoryRegistry for the writer factories of a plugin that is not
+* loaded yet.  Lists extensions and types from the plugin manifest and loads the plugin only for
+* an extension or type it lists, or a mime type.  See ossimDeferredImageHandlerFactory.
+*/
+class OSSIMDLLEXPORT ossimDeferredImageWriterFactory : public ossimImageWriterFactoryBase,
+                                                        public ossimDeferredPlugin::Listener
+{
+public:
+   ossimDeferredImageWriterFactory(std::shared_ptr<ossimDeferredPlugin> plugin);
+
+   virtual ossimImageFileWriter* createWriter(const ossimKeywordlist& kwl,
+                                              const char *prefix=0)const;
+   virtual ossimImageFileWriter* createWriter(const ossimString& typeName)const;
+   virtual void getExtensions(std::vector<ossimString>& result)const;
+   virtual void getImageTypeList(std::vector<ossimString>& imageTypeList)const;
+   virtual void getImageFileWritersBySuffix(ImageFileWriterList& result,
+                                            const ossimString& ext)const;
+   virtual void getImageFileWritersByMimeType(ImageFileWriterList& result,
+                                              const ossimString& mimeType)const;
+
+   virtual ossimObject* createObject(const ossimString& typeName)const;
+   virtual ossimObject* createObject(const ossimKeywordlist& kwl, const char* prefix=0)const;
+   virtual void getTypeNameList(std::vector<ossimString>& typeList)const;
+
+   virtual void beginLoad();
+   virtual void endLoad();
+
+private:
+   typedef ossimFactoryListInterface<ossimImageWriterFactoryBase,
+                                     ossimImageFileWriter>::RegistrationList RegistrationList;
+
+   /** Loads the plugin.  @return The factories it registered. */
+   const RegistrationList& load(const ossimString& reason)const;
+
+   /** @return true if typeName is listed or is a mime type. */
+   bool mayCreate(const ossimString& typeName)const;
+
+   std::shared_ptr<ossimDeferredPlugin> m_plugin;
+   const ossimPluginManifest::Services& m_services;
+   RegistrationList                     m_registrations;
+   RegistrationList*                    m_previousCapture;
+
+TYPE_DATA
+};
+
+#endif /* #ifndef ossimDeferredImageWriterFactory_HEADER */
@@ -56,6 +56,18 @@ public:
     */
    const double* getClosestWeights(const double& x, const double& y)const;
 
+   /**
+    * Single precision copy of the weights for the vectorized resampler
+    * kernels.  Each kernel row is padded with zero weights out to
+    * getFloatRowStride() so rows can be read four taps at a time.
+    *
+    * @return const float* to the closest weight of x and y.
+    */
+   const float* getClosestFloatWeights(const double& x, const double& y)const;
+
+   /** @return theWidth rounded up to a multiple of four. */
+   ossim_uint32 getFloatRowStride()const;
+
 protected:
 
    /**
@@ -65,6 +77,8 @@ protected:
    void allocateWeights();
 
    double*      theWeights;
+   float*       theFloatWeights;
+   ossim_uint32 theFloatRowStride;
    ossim_uint32 theWidth;
    ossim_uint32 theHeight;
    ossim_uint32 theWidthHeight;
@@ -94,4 +108,20 @@ inline const double* ossimFilterTable::getClosestWeights(const double& x,
                       kernelSamp)*theWidthHeight];
 }
 
+inline const float* ossimFilterTable::getClosestFloatWeights(const double& x,
+                                                             const double& y)const
+{
+   double intPartDummy;
+   double decimalPrecisionX = fabs(modf(x, &intPartDummy));
+   double decimalPrecisionY = fabs(modf(y, &intPartDummy));
+
+   ossim_int32 kernelLine =
+      (ossim_int32)(theFilterSteps*decimalPrecisionY);
+   ossim_int32 kernelSamp =
+      (ossim_int32)(theFilterSteps*decimalPrecisionX);
+
+   return &theFloatWeights[(kernelLine*theFilterSteps +
+                            kernelSamp)*theFloatRowStride*theHeight];
+}
+
 #endif /* End of "#ifndef ossimFilterTable_HEADER" */
@@ -13,12 +13,12 @@
 // $Id: ossimFixedTileCache.h 16276 2010-01-06 01:54:47Z gpotts $
 #ifndef ossimFixedTileCache_HEADER
 #define ossimFixedTileCache_HEADER
-#include <map>
-#include <list>
+#include <unordered_map>
 #include <ossim/base/ossimIpt.h>
 #include <ossim/base/ossimReferenced.h>
 #include <ossim/base/ossimRefPtr.h>
 #include <ossim/imaging/ossimImageData.h>
+#include <atomic>
 #include <mutex>
 
 class  ossimFixedTileCacheInfo
@@ -27,7 +27,10 @@ public:
    ossimFixedTileCacheInfo(ossimRefPtr<ossimImageData>& tile,
                            ossim_int32 tileId=-1)
       :theTile(tile),
-      theTileId(tileId)
+      theTileId(tileId),
+      theSizeInBytes(tile.valid()?tile->getDataSizeInBytes():0),
+      theLruPrev(0),
+      theLruNext(0)
       {
       }
    
@@ -58,8 +61,30 @@ public:
    
    ossimRefPtr<ossimImageData> theTile;
    ossim_int32 theTileId;
+
+   /** Bytes charged to the cache for this tile when it was added. */
+   ossim_uint32 theSizeInBytes;
+
+   /**
+    * Intrusive LRU links.  theLruPrev is the next older entry, theLruNext the
+    * next newer.  Both are null when the entry is not on the LRU list.
+    */
+   ossimFixedTileCacheInfo* theLruPrev;
+   ossimFixedTileCacheInfo* theLruNext;
 };
 
+class ossimAppFixedTileCache;
+
+/**
+ * Fixed grid tile cache.  Tiles are hashed by their grid id and, when the LRU
+ * flag is set, linked into an intrusive least recently used list, so that a
+ * lookup, a hit and an eviction are all constant time.
+ *
+ * The cache size is the sum of getDataSizeInBytes() of the tiles at the time
+ * they were added.  If the max cache size is non-zero, addTile() evicts the
+ * least recently used tiles to stay within it.  A max of zero (the default)
+ * leaves size management to the owner.
+ */
 class ossimFixedTileCache : public ossimReferenced
 {
 public:
@@ -75,10 +100,7 @@ public:
       {
          return getTile(computeId(origin));
       }
-   virtual void setUseLruFlag(bool flag)
-      {
-         theUseLruFlag = flag;
-      }
+   virtual void setUseLruFlag(bool flag);
    virtual bool getUseLruFlag()const
       {
          return theUseLruFlag;
@@ -98,28 +120,27 @@ public:
       {
          return theTileBoundaryRect;
       }
-   virtual ossim_uint32 getNumberOfTiles()const
-      {
-         return (ossim_uint32)theTileMap.size();
-      }
+   virtual ossim_uint32 getNumberOfTiles()const;
    virtual const ossimIpt& getTileSize()const
       {
          return theTileSize;
       }
    virtual ossim_uint32 getCacheSize()const
       {
-         return theCacheSize;
+         return theCacheSize.load();
       }
    virtual void deleteTile();
    virtual ossimRefPtr<ossimImageData> removeTile();
    
    virtual void setMaxCacheSize(ossim_uint32 cacheSize)
       {
+         std::lock_guard<std::mutex> lock(theMutex);
          theMaxCacheSize = cacheSize;
       }
 
    ossim_uint32 getMaxCacheSize()const
       {
+         std::lock_guard<std::mutex> lock(theMutex);
          return theMaxCacheSize;
       }
    
@@ -127,18 +148,45 @@ public:
    virtual ossim_int32 computeId(const ossimIpt& tileOrigin)const;
    virtual void setTileSize(const ossimIpt& tileSize);
 protected:
+   friend class ossimAppFixedTileCache;
+   typedef std::unordered_map<ossim_int32, ossimFixedTileCacheInfo> TileMap;
+
    virtual ~ossimFixedTileCache();
-   std::mutex theMutex;
+
+   /**
+    * Sets a counter that is kept in step with this cache's size, e.g. a
+    * process wide total.  The current size is moved from the old counter to
+    * the new one.  Pass null to detach.
+    */
+   void setSizeCounter(std::atomic<ossim_int64>* counter);
+
+   /**
+    * Deletes the least recently used tile.
+    * @return Bytes freed, 0 if nothing was deleted.
+    */
+   ossim_uint32 evictLruTile();
+
+   // The following assume theMutex is held.
+   ossim_uint32 evictLruTileNoLock();
+   ossimRefPtr<ossimImageData> eraseTileNoLock(TileMap::iterator tileIter);
+   void flushNoLock();
+   void adjustCacheSize(ossim_int64 delta);
+   void pushLru(ossimFixedTileCacheInfo* info);
+   void unlinkLru(ossimFixedTileCacheInfo* info);
+
+   mutable std::mutex theMutex;
    ossimIrect   theTileBoundaryRect;
    ossimIpt     theTileSize;
    ossimIpt     theBoundaryWidthHeight;
    ossim_uint32 theTilesHorizontal;
    ossim_uint32 theTilesVertical;
-   ossim_uint32 theCacheSize;
+   std::atomic<ossim_uint32> theCacheSize;
    ossim_uint32 theMaxCacheSize;
-   std::map<ossim_int32, ossimFixedTileCacheInfo> theTileMap;
-   std::list<ossim_int32> theLruQueue;
+   TileMap      theTileMap;
+   ossimFixedTileCacheInfo* theLruHead; //!< Least recently used.
+   ossimFixedTileCacheInfo* theLruTail; //!< Most recently used.
    bool                   theUseLruFlag;
+   std::atomic<ossim_int64>* theSizeCounter;
    virtual void eraseFromLru(ossim_int32 id);
    void adjustLru(ossim_int32 id);
 };
@@ -23,7 +23,10 @@
 #include <ossim/base/ossimPolyArea2d.h>
 #include <ossim/projection/ossimMapProjection.h>
 #include <ossim/projection/ossimProjection.h>
+#include <ossim/projection/ossimProjectionGrid.h>
 #include <ossim/base/ossim2dTo2dTransform.h>
+#include <atomic>
+#include <mutex>
 #include <vector>
 #include <ossim/matrix/newmat.h>
 #include <ossim/base/ossimDpt3d.h>
@@ -151,6 +154,35 @@ public:
    bool worldToLocal(const ossimGpt& world_pt, ossimDpt& local_pt) const;
    bool worldToLocal(const ossimGrect& world_rect, ossimDrect& local_rect) const;
 
+   //! Batch forms of localToWorld and worldToLocal. The points go through the projection's batch
+   //! methods so the per call overhead is paid once per batch instead of once per point. Returns
+   //! FALSE, with NaN outputs, if there is no projection.
+   bool localToWorld(const ossimDpt* local_pts, ossimGpt* world_pts, ossim_uint32 count) const;
+   bool worldToLocal(const ossimGpt* world_pts, ossimDpt* local_pts, ossim_uint32 count) const;
+
+   /**
+    * @brief Turns fast geometry mode on or off.
+    *
+    * In fast mode the localToWorld and worldToLocal methods of a geometry whose projection is
+    * affected by elevation (a sensor model) are served from an ossimProjectionGrid sampling the
+    * projection over the image at a stack of height layers.  The grid is built on first use to
+    * within maxError full image pixels, kept in memory keyed by the projection state, and
+    * written to the "geometry.fast_mode.cache_dir" preference directory so later runs read it
+    * back.  Points the grid does not cover, and projections it cannot approximate, go to the
+    * projection as before.
+    *
+    * The mode defaults to the "geometry.fast_mode" preferences.  A projection changed in place
+    * through getProjection() keeps its old grid until setProjection() or setFastMode() is called.
+    */
+   void setFastMode(bool flag, double maxError=0.1);
+   bool getFastMode() const { return m_fastMode; }
+
+   /**
+    * @return The grid serving fast mode, made on the first call, or NULL if fast mode is off
+    * or the projection could not be approximated.
+    */
+   const ossimProjectionGrid* getFastGrid() const;
+
    //! Sets the transform to be used for local-to-full-image coordinate transformation
    void setTransform(ossim2dTo2dTransform* transform);
 
@@ -326,6 +358,7 @@ public:
    void setImageSize(const ossimIpt& size)
    {
       m_imageSize = size;
+      resetFastGrid();
    }
    const ossimIpt& getImageSize()const
    {
@@ -476,6 +509,12 @@ protected:
                       ossim_uint32 resolutionLevel,
                       ossimDpt& rnPt) const;
 
+   //! @brief Drops the fast mode grid so the next getFastGrid() looks it up again.
+   void resetFastGrid() { m_fastGridChecked.store(false); m_fastGrid = 0; }
+
+   //! @brief Takes the fast mode grid of other if it has looked it up.
+   void copyFastGrid(const ossimImageGeometry& other);
+
    ossimRefPtr<ossim2dTo2dTransform> m_transform;   //!< Maintains local_image-to-full_image transformation 
    ossimRefPtr<ossimProjection>      m_projection;  //!< Maintains full_image-to-world_space transformation
    std::vector<ossimDpt>             m_decimationFactors; //!< List of decimation factors for R-levels
@@ -484,6 +523,17 @@ protected:
    /** @brief Target rrds for localToWorld and worldToLocal methods. */
    ossim_uint32                      m_targetRrds; 
 
+   /** @brief Fast geometry mode, see setFastMode(). */
+   bool                                     m_fastMode;
+   double                                   m_fastModeMaxError;
+   mutable ossimRefPtr<ossimProjectionGrid> m_fastGrid;
+
+   /** @brief Set with release once m_fastGrid is final, so readers may skip the lock. */
+   mutable std::atomic<bool>                m_fastGridChecked;
+
+   /** @brief Serializes the lookup of m_fastGrid. */
+   mutable std::mutex                       m_fastGridMutex;
+
    TYPE_DATA
 };
 
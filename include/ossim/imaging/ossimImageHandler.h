@@ -710,6 +710,33 @@ public:
     */
    virtual const ossimFilename& getSupplementaryDirectory()const;
    
+   /**
+    * @brief Capability flag for concurrent block reads.
+    *
+    * A handler returning true can hand out independent readers through
+    * createConcurrentReader().  Each reader shares this handler's parsed
+    * header/state but owns its own stream handle and decode buffers so that
+    * several threads can read the same file at once.
+    *
+    * This implementation returns false.
+    *
+    * @return true if createConcurrentReader() is supported.
+    */
+   virtual bool supportsConcurrentReads() const;
+
+   /**
+    * @brief Creates a reader for use by one thread at a time, alongside this
+    * handler and any other readers created from it.
+    *
+    * The reader is a snapshot: band selection and other settings changed on
+    * this handler after the call are not reflected.
+    *
+    * This implementation returns a null pointer.
+    *
+    * @return New reader or null if not supported or on error.
+    */
+   virtual ossimRefPtr<ossimImageHandler> createConcurrentReader() const;
+
    //! Fetches the image ID. This is initialized to -1 in the constructor but is searched for in 
    //! loadState():
    const ossimString& getImageID() const { return theImageID; }
@@ -818,6 +845,19 @@ protected:
                                   std::vector<ossim_uint32>& outBandList);
 
    
+   /**
+    * @brief Initializes the handler level members of a reader being made by
+    * a derived createConcurrentReader().
+    *
+    * Copies file names, decimation factors, lut, geometry and state, and
+    * creates a concurrent reader for the overview if one is open.
+    *
+    * @param reader Reader to initialize.
+    * @return true on success, false if the overview cannot be read
+    * concurrently.
+    */
+   bool initConcurrentReader(ossimImageHandler* reader) const;
+
    /**
     * @brief Get filename with no extension, using supplentary directory for
     * dirname if set.
@@ -26,6 +26,10 @@
 class ossimImageHandler;
 class ossimFilename;
 class ossimKeywordlist;
+namespace ossim
+{
+   class ImageHandlerStateStore;
+}
 
 /**
 * ossimImageHandlerRegistry supports the new state cache. During initialization the properties are
@@ -34,9 +38,14 @@ class ossimKeywordlist;
 * ossim.imaging.handler.registry.state_cache.enabled: true or false
 * ossim.imaging.handler.registry.state_cache.min_size: min number of items
 * ossim.imaging.handler.registry.state_cache.max_size: max number of items
+* ossim.imaging.handler.registry.state_cache.directory: optional directory to persist states in
 *
 * On open if the state cache is enabled it will determine if a state exists when a file is passed 
 * in to be open and if a state exists it will try to open the handler based on the state.
+*
+* If a directory is given, states are also saved there (see ossim::ImageHandlerStateStore) and
+* a state not in memory is looked for there, so a later process reopens the same files without
+* probing the factories.  States of files that changed since are ignored.
 */
 class OSSIMDLLEXPORT ossimImageHandlerRegistry : public ossimObjectFactory,
                                                 public ossimFactoryListInterface<ossimImageHandlerFactoryBase, ossimImageHandler>
@@ -185,6 +194,7 @@ protected:
    void addToStateCache(ossimImageHandler* handler)const;
 
    mutable std::shared_ptr<ossim::ItemCache<ossim::ImageHandlerState> > m_stateCache;
+   mutable std::shared_ptr<ossim::ImageHandlerStateStore> m_stateStore;
 
    //static ossimImageHandlerRegistry*            theInstance;
    
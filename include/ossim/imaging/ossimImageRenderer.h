@@ -18,6 +18,10 @@
 #include <ossim/base/ossimPolyArea2d.h>
 #include <ossim/base/ossimViewInterface.h>
 #include <ossim/base/ossimRationalNumber.h>
+#include <list>
+#include <map>
+#include <utility>
+#include <vector>
 
 class ossimImageData;
 class ossimDiscreteConvolutionKernel;
@@ -150,6 +154,39 @@ public:
     */
    virtual void setEnableFlag(bool flag);
 
+   /**
+    * @brief Sets the size of the transform grid cache.
+    *
+    * The cache holds the bilinear sub rectangles each requested view tile was
+    * split into, so repeated requests for the same area skip the view to
+    * image projection and the interpolation error analysis.  Entries are
+    * keyed by the transform state (view and image geometry), the tile rect
+    * and the resolution level, and are cleared on refreshEvent.
+    *
+    * @param bytes Memory limit of the cache.  0 disables it.
+    */
+   void setTransformCacheSize(ossim_uint64 bytes);
+   ossim_uint64 getTransformCacheSize() const;
+
+   /** @return Bytes currently held by the transform grid cache. */
+   ossim_uint64 getTransformCacheBytes() const;
+
+   /** Empties the transform grid cache. */
+   void clearTransformCache();
+
+   /**
+    * @brief Hints the elevation manager to load the elevation under a view
+    * rectangle that will be requested later.
+    *
+    * The rectangle's ground footprint at the ellipsoid is handed to
+    * ossimElevManager::prefetch, which loads the cells on a background
+    * thread.  Sequencers call this for upcoming tiles so DEM reads overlap
+    * the resampling of the current ones.
+    *
+    * @return true if the image geometry is affected by elevation and the
+    * request was queued.
+    */
+   bool prefetchElevation(const ossimIrect& viewRect) const;
    
 protected:
 private:
@@ -262,9 +299,56 @@ private:
       void splitAll(std::vector<ossimRendererSubRectInfo>& result)const;
    };
 
+   typedef std::vector<ossimRendererSubRectInfo> SubRectList;
+
+   /** Key of a transform grid cache entry. */
+   struct TransformGridKey
+   {
+      bool operator<(const TransformGridKey& rhs) const;
+
+      ossim_uint64 m_stateHash;
+      ossimIpt     m_ul;
+      ossimIpt     m_lr;
+      ossim_uint32 m_resLevel;
+   };
+   typedef std::list< std::pair<TransformGridKey, SubRectList> > TransformGridList;
+   typedef std::map<TransformGridKey, TransformGridList::iterator> TransformGridMap;
+
    void recursiveResample(ossimRefPtr<ossimImageData> outputData,
                           const ossimRendererSubRectInfo& rectInfo,
 			  ossim_uint32 level);
+
+   /**
+    * Splits rectInfo until each piece can be bilinearly interpolated and
+    * returns the pieces that need filling, in fill order.
+    */
+   void computeSubRects(const ossimRendererSubRectInfo& rectInfo,
+                        SubRectList& subRects);
+
+   /** Fills outputData from each of the sub rectangles. */
+   void fillTile(ossimRefPtr<ossimImageData> outputData,
+                 const SubRectList& subRects);
+
+   /**
+    * @return The cached sub rectangles for the view tile or null if not
+    * cached.  A hit makes the entry most recently used.
+    */
+   const SubRectList* findTransformGrid(const ossimIrect& tileRect,
+                                        ossim_uint32 resLevel);
+
+   /** Caches subRects, evicting least recently used entries to make room. */
+   void addTransformGrid(const ossimIrect& tileRect,
+                         ossim_uint32 resLevel,
+                         const SubRectList& subRects);
+
+   /** Evicts least recently used entries until the cache holds maxBytes or less. */
+   void trimTransformCache(ossim_uint64 maxBytes);
+
+   /**
+    * Hashes the image view transform state into m_transformStateHash.  Called
+    * whenever the bounding rects are reinitialized.
+    */
+   void updateTransformStateHash();
    
 
    void fillTile(ossimRefPtr<ossimImageData> outputData,
@@ -340,6 +424,12 @@ private:
    double                   m_averageViewToImageRLevelScale;
    static double            m_interpErrorThreshold;
 
+   ossim_uint64             m_transformCacheSize;
+   ossim_uint64             m_transformCacheBytes;
+   ossim_uint64             m_transformStateHash;
+   TransformGridList        m_transformGridList; // Most recently used first.
+   TransformGridMap         m_transformGridMap;
+
    TYPE_DATA
 };
 
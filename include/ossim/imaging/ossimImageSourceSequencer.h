@@ -18,6 +18,8 @@
 #include <ossim/base/ossimHistogramSource.h>
 #include <ossim/base/ossimMultiResLevelHistogram.h>
 
+class ossimImageRenderer;
+
 
 class OSSIMDLLEXPORT ossimImageSourceSequencer
    :
@@ -171,8 +173,17 @@ protected:
    ossim_int64 theCurrentTileNumber;
    bool theCreateHistogram;
 
+   /** Renderer in the input chain, used to prefetch elevation.  May be null. */
+   ossimRefPtr<ossimImageRenderer> thePrefetchRenderer;
+
    virtual void updateTileDimensions();
 
+   /**
+    * @brief Asks the renderer in the input chain, if any, to prefetch the
+    * elevation under a tile that will be requested later.
+    */
+   void prefetchElevation(ossim_int64 tileId) const;
+
 TYPE_DATA
 };
 
@@ -20,7 +20,9 @@
 #include <ossim/imaging/ossimImageData.h>
 #include <ossim/imaging/ossimImageGeometry.h>
 #include <ossim/projection/ossimProjection.h>
+#include <ossim/support_data/ossimLasPointIndex.h>
 #include <mutex>
+#include <vector>
 
 class ossimLasHdr;
 class ossimLasPointRecordInterface;
@@ -29,6 +31,11 @@ class ossimLasPointRecordInterface;
  * @class ossimLasReader
  *
  * OSSIM LAS LIDAR reader.
+ *
+ * Tiles are rasterized from the points under them, located with an ossimLasPointIndex built
+ * by one pass over the file on the first tile request.  With the las_reader.point_index
+ * preference on it is kept in a ".lpi" file beside the LAS file for later opens.  Reduced resolution tiles come from an overview when one has been
+ * built, e.g. with ossim-img2rr, so zoomed out views do not re-rasterize every point.
  */
 class ossimLasReader : public ossimImageHandler
 {
@@ -237,7 +244,8 @@ protected:
    /**
     * @brief Will complete the opening process.
     *
-    * Overrides ossimImageHandler::completeOpen() as we do not ever have overviews.
+    * Overrides ossimImageHandler::completeOpen() to skip the metadata and valid vertices
+    * files.  Overviews, if present, are opened and used for reduced resolution levels.
     */
    virtual void completeOpen();
    
@@ -292,6 +300,22 @@ private:
 
    void convertToMeters(ossim_float64& value) const;
 
+   /**
+    * @brief Reads the point index from its sidecar file, or builds it with one pass over the
+    * points and writes the sidecar if the las_reader.point_index preference is on.  Leaves
+    * m_index invalid if neither works.
+    */
+   void initIndex();
+
+   /**
+    * @brief Reads point records [first, first + count) into m_recordBuf.
+    * @return Number of whole records read.
+    */
+   ossim_uint64 readRecords(ossim_uint64 first, ossim_uint64 count);
+
+   /** @return Number of point records the file holds. */
+   ossim_uint64 getNumberOfRecords() const;
+
    /**
     * Returns a point of type.
     */
@@ -311,6 +335,9 @@ private:
    bool                         m_scan;  // Scan for bounds at open.
    ossimUnitType                m_units;
    ossimUnitConversionTool*     m_unitConverter;
+   ossimLasPointIndex           m_index;
+   bool                         m_indexInitialized;
+   std::vector<char>            m_recordBuf;
 TYPE_DATA
 };
 
@@ -167,6 +167,24 @@ public:
 
    virtual bool isOpen()const;
 
+   /**
+    * @brief Concurrent reads are supported for plain nitf entries whose
+    * overview (if any) also supports them.
+    *
+    * Overrides: ossimImageHandler::supportsConcurrentReads
+    */
+   virtual bool supportsConcurrentReads() const;
+
+   /**
+    * @brief Creates a reader on the current entry with its own stream and
+    * block buffers that shares this source's parsed headers.
+    *
+    * The reader does not use the application tile cache.
+    *
+    * Overrides: ossimImageHandler::createConcurrentReader
+    */
+   virtual ossimRefPtr<ossimImageHandler> createConcurrentReader() const;
+
    /**
     * @return The current entry number.
     *
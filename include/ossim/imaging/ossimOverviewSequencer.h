@@ -19,10 +19,13 @@
 #include <ossim/imaging/ossimFilterResampler.h>
 #include <ossim/imaging/ossimBitMaskWriter.h>
 #include <ossim/imaging/ossimMaskFilter.h>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 class ossimFilename;
+class ossimJobWorkStealingQueue;
 
 /**
  * @class Sequencer for building overview files.
@@ -206,8 +209,50 @@ public:
     */
    bool writeOmdFile(const std::string& file);   
 
+   /**
+    * @brief Sets the number of threads used to decimate tiles.
+    *
+    * With more than one thread getNextTile decimates a batch of upcoming
+    * tiles concurrently, each thread reading through its own concurrent
+    * reader (see ossimImageHandler::createConcurrentReader) when the image
+    * handler supports it.  Tiles are still returned in order.  Ignored when
+    * bit mask objects are set.  Must be called before initialize.
+    *
+    * @param threads Thread count. 0 uses ossim::getNumberOfThreads().
+    * Default = 1.
+    */
+   void setNumberOfThreads(ossim_uint32 threads);
+
+   /** @return The number of threads used to decimate tiles. */
+   ossim_uint32 getNumberOfThreads() const;
+
+   /**
+    * @brief Sets an in memory copy of the source level to decimate from.
+    *
+    * Input tiles are then cut from level instead of being read from the
+    * image handler, which is still used for the pixel type and band count.
+    * Typically the retained output of the previous level's sequencer.  Must
+    * be called before initialize.
+    *
+    * @param level Full source level, zero based.  Null to read from the
+    * image handler.
+    */
+   void setInputLevel(ossimImageData* level);
+
+   /**
+    * @brief If set, every tile returned by getNextTile is also copied into an
+    * image of the whole output level, available from getOutputLevel once
+    * the sequence is done.  Must be called before initialize.
+    */
+   void setRetainOutputLevel(bool flag);
+
+   /** @return The retained output level or null if not retained. */
+   ossimRefPtr<ossimImageData> getOutputLevel() const;
+
 protected:
 
+   class ResampleJob;
+
    /** virtual destructor */
    virtual ~ossimOverviewSequencer();
 
@@ -217,6 +262,10 @@ protected:
     * @param inputRect The rectangle to initialize.
     */
    void getInputTileRectangle(ossimIrect& inputRect) const;
+
+   /** @brief Gets the image rectangle for the input tile for tileNumber. */
+   void getInputTileRectangle(ossimIrect& inputRect,
+                              ossim_uint32 tileNumber) const;
    
    /**
     * @brief Gets the image rectangle for the output tile for
@@ -225,6 +274,10 @@ protected:
     */
    void getOutputTileRectangle(ossimIrect& outputRect) const;
 
+   /** @brief Gets the image rectangle for the output tile for tileNumber. */
+   void getOutputTileRectangle(ossimIrect& outputRect,
+                               ossim_uint32 tileNumber) const;
+
    /**
     * @brief Updates theNumberOfTilesHorizontal and theNumberOfTilesVertical.
     *
@@ -237,8 +290,56 @@ protected:
     */
    void resampleTile(const ossimImageData* inputTile);
 
+   /**
+    * Resamples inputTile into outputTile.  Safe to call from several threads
+    * on different tiles.
+    */
+   void resampleTile(const ossimImageData* inputTile,
+                     ossimImageData* outputTile) const;
+
    template <class T> void resampleTile(const ossimImageData* inputTile,
-                                        T dummy);
+                                        ossimImageData* outputTile,
+                                        T dummy) const;
+
+   /**
+    * @brief Reads and decimates one tile.
+    *
+    * @param tileNumber Tile to make.
+    * @param source Source to read from.  Ignored if an input level is set.
+    * @param readMutex If not null, held while reading from source.
+    * @param inputTile Scratch tile for an input level.  Allocated on first use.
+    * @param outputTile Tile to fill.  Left blank if there was nothing to
+    * resample.
+    * @param readError Set to true on a read error.
+    * @return true if the tile was resampled, false if the input was empty,
+    * null or in error.
+    */
+   bool makeTile(ossim_uint32 tileNumber,
+                 ossimImageSource* source,
+                 std::mutex* readMutex,
+                 ossimRefPtr<ossimImageData>& inputTile,
+                 ossimImageData* outputTile,
+                 bool& readError) const;
+
+   /** Outcome of makeTile for a batch tile. */
+   enum TileStatus
+   {
+      TILE_BLANK      = 0,
+      TILE_RESAMPLED  = 1,
+      TILE_READ_ERROR = 2
+   };
+
+   /**
+    * @brief Decimates the batch of tiles starting at tileNumber using the
+    * job queue.
+    */
+   void makeTileBatch(ossim_uint32 tileNumber);
+
+   /**
+    * @brief Per tile bookkeeping done in tile order: mask generation, stats
+    * and retaining the output level.
+    */
+   void finishTile(ossimRefPtr<ossimImageData> tile);
 
    /** @brief Clears out the arrays from a scan for min, max, nulls. */
    void clearMinMaxNullArrays();
@@ -286,6 +387,22 @@ protected:
    std::vector<ossim_float64> m_minValues; 
    std::vector<ossim_float64> m_maxValues; 
    std::vector<ossim_float64> m_nulValues;
+
+   /** Threading.  Batch tiles hold output tiles m_batchStart and up. */
+   ossim_uint32                                m_numberOfThreads;
+   std::shared_ptr<ossimJobWorkStealingQueue>  m_jobQueue;
+   std::vector< ossimRefPtr<ossimImageHandler> > m_readers;
+   std::mutex                                  m_readMutex;
+   std::vector< ossimRefPtr<ossimImageData> >  m_batchTiles;
+   std::vector<ossim_uint8>                    m_batchStatus; // TileStatus per batch tile.
+   ossim_uint32                                m_batchStart;
+   ossim_uint32                                m_batchSize;
+
+   /** In memory levels. */
+   ossimRefPtr<ossimImageData> m_inputLevel;
+   ossimRefPtr<ossimImageData> m_inputTile;
+   ossimRefPtr<ossimImageData> m_outputLevel;
+   bool                        m_retainOutputLevel;
 };
 
 #endif /* #ifndef ossimOverviewSequencer_HEADER */
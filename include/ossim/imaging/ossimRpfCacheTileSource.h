@@ -17,7 +17,6 @@
 
 class ossimRpfToc;
 class ossimRpfTocEntry;
-class ossimRpfFrame;
 
 class OSSIMDLLEXPORT ossimRpfCacheTileSource : public ossimImageHandler
 {
@@ -378,11 +377,10 @@ protected:
    std::vector<ossimFrameEntryData> getIntersectingEntries(const ossimIrect& rect);
 
    /**
-    * This is a wrapper for the fill cib and fill cadrg.  It takes the frames
-    * involved that were found in the getIntersectingEntries and call the
-    * appropriate fill cib or fill cadrg on each frame entry data.  It will
-    * loop through making sure that the frame file exists before calling
-    * the associated fill routines.
+    * Fills the tile from the subframes of the frames involved that were
+    * found in the getIntersectingEntries.  The subframes come VQ decoded
+    * from the shared ossimRpfFrameCache, which decodes the ones it does not
+    * hold in parallel.
     *
     * @param tileRect Region to fill.
     * @param framesInvolved All intersecting frames used to render the region.
@@ -392,33 +390,9 @@ protected:
                  ossimImageData* tile);
 
    /**
-    * Will uncompress the CIB file using a VQ decompression algorithm.
-    *
-    * @param aFrame Frame that overlaps the requested tile rect.
-    * @param tileRect The region requested to render.
-    * @param frameEntryData The frame entry data.
-    */
-   void fillSubTileCib(const ossimRpfFrame& aFrame,
-                       const ossimIrect& tileRect,
-                       const ossimFrameEntryData& frameEntryData,
-                       ossimImageData* tile);
-   
-   /**
-    * Will uncompress the CADRG file using a VQ decompression algorithm.
-    *
-    * @param aFrame Frame that overlaps the requested tile rect.
-    * @param tileRect The region requested to render.
-    * @param frameEntryData The frame entry data.
-    */
-   void fillSubTileCadrg(const ossimRpfFrame& aFrame,
-                         const ossimIrect& tileRect,
-                         const ossimFrameEntryData& frameEntryData,
-                         ossimImageData* tile);
-   
-   /**
-    * Will allocate an internal buffer for the given product.  If the product is
-    * a CIB then it is a single band OSSIM_UCHAR buffer and if its a CADRG it
-    * is a 3 band OSSIM_UCHAR buffer.
+    * Will allocate the tile for the given product.  If the product is
+    * a CIB then it is a single band OSSIM_UCHAR tile and if its a CADRG it
+    * is a 3 band OSSIM_UCHAR tile.
     */
    void allocateForProduct();
 
@@ -435,16 +409,6 @@ protected:
     */
    ossimIrect                  m_actualImageRect;
    
-   /**
-    * This is for storage of a single compressed buffer.
-    */
-   unsigned char*               m_compressedBuffer;
-
-   /**
-    * This is used as a buffer to uncompress the data to
-    */
-   unsigned char*               m_uncompressedBuffer;
-   
    /**
     * This will be computed based on the frames organized within
     * the directory.  The CibCadrg have fixed size frames of 1536x1536
@@ -479,8 +443,6 @@ protected:
     * The product type can be a CIB or a CADRG product.
     */
    ossimRpfCacheProductType     m_productType;
-   
-   mutable ossimRpfFrame*       m_workFrame;
 
 	// data to use in property retrieval
 
@@ -20,6 +20,7 @@
 
 #include <ossim/base/ossimConstants.h>
 #include <ossim/base/ossimFilename.h>
+#include <ossim/base/ossimRefPtr.h>
 
 #include <ossim/imaging/ossimOverviewBuilderBase.h>
 #include <ossim/imaging/ossimFilterResampler.h>
@@ -28,6 +29,7 @@
 
 class ossimConnectableObject;
 class ossimFilename;
+class ossimImageData;
 class ossimImageGeometry;
 
 class OSSIM_DLL ossimTiffOverviewBuilder
@@ -230,11 +232,19 @@ private:
     *
     *  @param firstRestLevel used to tell method that if a histogram is needed, do it on
     *  that res level.
+    *
+    *  @param lastResLevel used to tell method no level follows this one so
+    *  there is no point keeping it in memory.
+    *
+    *  If m_previousLevel is set it is decimated instead of imageHandler's
+    *  data.  On return m_previousLevel holds this level if it fit in the
+    *  pipeline memory budget, else it is null.
     */
    bool writeRn(ossimImageHandler* imageHandler,
                 TIFF* tif,
                 ossim_uint32 resLevel,
-                bool firstResLevel);
+                bool firstResLevel,
+                bool lastResLevel);
    
    /**
     *  Set the tiff tags for the appropriate resLevel.  Level zero is the
@@ -298,6 +308,18 @@ private:
    bool                                               m_outputTileSizeSetFlag;
    bool                                               m_internalOverviewsFlag;
 
+   /** Decimation threads, 0 for one per core. */
+   ossim_uint32                                       m_numberOfThreads;
+
+   /** Tile compression threads, 0 for one per core. */
+   ossim_uint32                                       m_compressionThreads;
+
+   /** Largest level in bytes kept in memory to feed the next level. */
+   ossim_uint64                                       m_pipelineMemorySize;
+
+   /** Last level written if kept in memory; null otherwise. */
+   ossimRefPtr<ossimImageData>                        m_previousLevel;
+
 TYPE_DATA   
 };
    
@@ -0,0 +1,126 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+#ifndef ossimTiffTileEncoder_HEADER
+#define ossimTiffTileEncoder_HEADER 1
+
+#include <ossim/base/ossimConstants.h>
+#include <tiffio.h>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class ossimJobWorkStealingQueue;
+
+/**
+* Compresses tiles of a tiled TIFF directory on a thread pool and writes them in order.
+*
+* libtiff compresses inside TIFFWriteTile, so a writer calling it from one thread compresses
+* on one core. This class copies each tile handed to writeTile() and compresses it on a
+* worker. The worker writes the tile into a one tile TIFF held in memory that has the same
+* codec tags as the output. The compressed bytes are then written to the output with
+* TIFFWriteRawTile, strictly in the order the tiles were given. Tile order and directory
+* layout are the same as writing with TIFFWriteTile.
+*
+* The compression, bits, samples, sample format, planar configuration, photometric, tile
+* size, predictor and JPEG/deflate quality tags must be set on the output before the
+* encoder is made. For JPEG, the shared tables produced by the workers are copied to the
+* output's JPEGTABLES tag.
+*
+* The thread count defaults to the "tiff_writer.compression_threads" preference.
+*/
+class OSSIM_DLL ossimTiffTileEncoder
+{
+public:
+   /**
+    * @param tif Output, on the directory about to be written.
+    * @param threads Compression threads. 0 means one per core.
+    */
+   ossimTiffTileEncoder(TIFF* tif, ossim_uint32 threads);
+
+   /** Writes any tiles still queued. */
+   ~ossimTiffTileEncoder();
+
+   /**
+    * Queues the tile (or band plane of a tile for separate planes) at image position x, y.
+    * Copies TIFFTileSize bytes from buf. Blocks while too many tiles are waiting to be written.
+    *
+    * @return false if this or an earlier tile failed.
+    */
+   bool writeTile(const void* buf, ossim_uint32 x, ossim_uint32 y, ossim_uint16 sample);
+
+   /**
+    * Waits for and writes all queued tiles.
+    * @return false if any tile failed.
+    */
+   bool finish();
+
+   ossim_uint32 getNumberOfThreads() const;
+
+   /**
+    * @return true if the compression of tif's current directory is one worth compressing
+    * in parallel, i.e. anything but none, and tiles can be encoded apart from the file.
+    */
+   static bool isParallelizable(TIFF* tif);
+
+   /** @return "tiff_writer.compression_threads" preference, 0 (one per core) if not set. */
+   static ossim_uint32 getDefaultNumberOfThreads();
+
+   class EncodeJob;
+
+private:
+   struct Tile
+   {
+      Tile() : m_index(0), m_raw(), m_encoded(), m_done(false), m_ok(false) {}
+
+      ossim_uint32              m_index;
+      std::vector<ossim_uint8>  m_raw;
+      std::vector<ossim_uint8>  m_encoded;
+      bool                      m_done;
+      bool                      m_ok;
+   };
+
+   /** Compresses the tile through a scratch TIFF. Called on a worker thread. */
+   void encode(Tile& tile);
+
+   /** Waits for the oldest tile and writes it to the output. */
+   bool writeFront();
+
+   // Disallow copy.
+   ossimTiffTileEncoder(const ossimTiffTileEncoder&);
+   ossimTiffTileEncoder& operator=(const ossimTiffTileEncoder&);
+
+   TIFF*         m_tif;
+   ossim_uint32  m_threads;
+   tmsize_t      m_tileSize;
+
+   // Codec tags copied to every scratch TIFF.
+   ossim_uint16  m_compression;
+   ossim_uint16  m_bitsPerSample;
+   ossim_uint16  m_samplesPerPixel;
+   ossim_uint16  m_sampleFormat;
+   ossim_uint16  m_planarConfig;
+   ossim_uint16  m_photometric;
+   ossim_uint16  m_predictor;
+   ossim_uint32  m_tileWidth;
+   ossim_uint32  m_tileLength;
+   int           m_jpegQuality;
+   int           m_jpegColorMode;
+   int           m_zipQuality;
+
+   std::shared_ptr<ossimJobWorkStealingQueue> m_queue;
+   std::deque< std::shared_ptr<Tile> >        m_pending;
+   std::mutex                                 m_mutex;
+   std::condition_variable                    m_condition;
+   std::vector<ossim_uint8>                   m_jpegTables;
+   bool                                       m_jpegTablesWritten;
+   bool                                       m_ok;
+};
+
+#endif
@@ -166,6 +166,22 @@ public:
 
    virtual bool isOpen()const;
 
+   /**
+    * @brief Concurrent reads are supported for plain tiffs whose overview
+    * (if any) also supports them.
+    *
+    * Overrides: ossimImageHandler::supportsConcurrentReads
+    */
+   virtual bool supportsConcurrentReads() const;
+
+   /**
+    * @brief Creates a reader with its own stream, TIFF handle and buffers
+    * that shares this source's parsed directory information.
+    *
+    * Overrides: ossimImageHandler::createConcurrentReader
+    */
+   virtual ossimRefPtr<ossimImageHandler> createConcurrentReader() const;
+
    /**
     * Returns the output pixel type of the tile source.
     */
@@ -85,6 +85,15 @@ public:
 
    virtual ossimString getCompressionType()const;
 
+   /**
+    * Sets the number of threads tiled output is compressed with. 0 means one
+    * per core, 1 compresses on the writing thread. Defaults to the
+    * "tiff_writer.compression_threads" preference.
+    */
+   void setCompressionThreads(ossim_uint32 threads);
+
+   ossim_uint32 getCompressionThreads()const;
+
    virtual bool getGeotiffFlag()const;
 
    virtual void setGeotiffFlag(bool flag);
@@ -226,6 +235,7 @@ protected:
    ossimFilename           theLutFilename;
    bool                    theForceBigTiffFlag;
    bool                    theBigTiffFlag;
+   ossim_uint32            theCompressionThreads;
    mutable ossimRefPtr<ossimNBandToIndexFilter> theNBandToIndexFilter;
 TYPE_DATA
 };
@@ -25,6 +25,7 @@
 
 class ossimPreferences;
 class ossimArgumentParser;
+class ossimPluginManifest;
 
 class OSSIMDLLEXPORT ossimInit
 {
@@ -134,6 +135,18 @@ protected:
    void parseNotifyOption(ossimArgumentParser& parser);
    void parseEnvOptions(ossimArgumentParser& parser);
    void parsePrefsOptions(ossimArgumentParser& parser);
+
+   /**
+    * @brief Registers a plugin from the initializePlugins preferences.
+    *
+    * If deferAllowed and manifest holds a current entry for the plugin that allows it, stand in
+    * factories are registered instead and the library is loaded when a request reaches one of
+    * them.  Else the plugin is loaded now and its entry in manifest updated.
+    */
+   void registerPlugin(ossimPluginManifest& manifest,
+                       const ossimFilename& file,
+                       const ossimString& options,
+                       bool deferAllowed);
    /*!
     * METHOD: removeOptions()
     * Utility for stripping from argv all characters associated with a
@@ -13,9 +13,15 @@
 #include <ossim/imaging/ossimImageHandler.h>
 #include <ossim/imaging/ossimCacheTileSource.h>
 #include <mutex>
+#include <vector>
 //**************************************************************************************************
 //! Intended mainly to provide a mechanism for mutex-locking access to a shared resource during
 //! a getTile operation on an ossimImageHandler. This is needed for multi-threaded implementation.
+//!
+//! If the adaptee supportsConcurrentReads(), getTile() does not serialize on the adaptee. Instead
+//! each calling thread checks out one of a pool of readers created with createConcurrentReader(),
+//! reads through it, and returns it to the pool. The pool grows to the number of threads reading
+//! at once. Otherwise (or if a reader cannot be created) the adaptee is locked as before.
 //**************************************************************************************************
 class OSSIMDLLEXPORT ossimImageHandlerMtAdaptor : public ossimImageHandler
 {
@@ -71,6 +77,12 @@ public:
    virtual ossim_float64   getNullPixelValue(ossim_uint32 band=0)const;
    void setCacheTileSize(ossim_uint32 cache_tile_size);
    void setUseCache(bool use_cache);
+
+   //! Enables the concurrent reader pool when the adaptee supports it. Default is true.
+   //! Note the handler cache (setUseCache) is bypassed by reads through the pool.
+   void setUseConcurrentReads(bool flag);
+   bool getUseConcurrentReads() const;
+
    void writeTime() const;
 
    double       d_getTileT;
@@ -80,10 +92,25 @@ protected:
    //! Protected destructor forces using reference pointer for instantiation.
    virtual ~ossimImageHandlerMtAdaptor();
 
+   //! Takes an idle reader from the pool or creates one. Returns null if the adaptee can't
+   //! be read concurrently, in which case the caller falls back to the locked path.
+   ossimRefPtr<ossimImageHandler> checkOutReader();
+
+   //! Returns a reader obtained from checkOutReader() to the pool.
+   void checkInReader(ossimRefPtr<ossimImageHandler>& reader);
+
+   //! Drops all pooled readers.
+   void clearReaders();
+
    ossimRefPtr<ossimImageHandler>    m_adaptedHandler;
    ossimRefPtr<ossimCacheTileSource> m_cache;
    mutable std::mutex                m_mutex;   
 
+   std::vector<ossimRefPtr<ossimImageHandler> > m_idleReaders;
+   std::mutex                        m_readerMutex;
+   bool                              m_useConcurrentReads;
+   bool                              m_concurrentReadsFailed;
+
    bool                        d_useCache;
    bool                        d_useFauxTile;
    ossimRefPtr<ossimImageData> d_fauxTile;
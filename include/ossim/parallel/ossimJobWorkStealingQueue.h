@@ -0,0 +1,248 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+#ifndef ossimJobWorkStealingQueue_HEADER
+#define ossimJobWorkStealingQueue_HEADER
+
+#include <ossim/parallel/ossimJob.h>
+#include <ossim/base/Thread.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+* Work-stealing thread pool for ossimJob instances. This is a drop-in alternative to the
+* ossimJobQueue/ossimJobMultiThreadQueue pair for workloads that enqueue a large number of short
+* jobs from one or more producers.
+*
+* Every worker thread owns its own deque guarded by its own lock. Jobs added from outside the
+* pool are distributed round-robin across the worker deques; jobs added from inside a running
+* job are pushed onto the calling worker's deque. A worker services its own deque first (FIFO)
+* and, when that is empty, steals from the other workers before going idle. There is no global
+* lock on the add/next path and no uniqueness scan, so an add is O(1) regardless of backlog.
+*
+* Job state handling follows ossimJobThreadQueue: added jobs are marked ready(), canceled jobs
+* are marked finished() without being run, and ready jobs are run through ossimJob::start() so
+* any attached ossimJobCallback sees the usual started/finished notifications.
+*
+* @code
+* #include <ossim/parallel/ossimJobWorkStealingQueue.h>
+* class TestJob : public ossimJob
+* {
+* protected:
+*    virtual void run() { ossim::Thread::sleepInMilliSeconds(10); }
+* };
+* int main(int argc, char *argv[])
+* {
+*    std::shared_ptr<ossimJobWorkStealingQueue> pool =
+*       std::make_shared<ossimJobWorkStealingQueue>(8);
+*    for(int i = 0; i < 1000; ++i)
+*    {
+*       pool->add(std::make_shared<TestJob>());
+*    }
+*    pool->waitForJobsToFinish();
+*    pool->getStatistics().print(std::cout);
+*    return 0;
+* }
+* @endcode
+*/
+class OSSIM_DLL ossimJobWorkStealingQueue
+{
+public:
+   /**
+   * Snapshot of the pool counters. Counters are cumulative since construction or the last
+   * call to resetStatistics().
+   */
+   struct OSSIM_DLL Statistics
+   {
+      Statistics();
+
+      /** Prints the statistics in keyword: value form. */
+      std::ostream& print(std::ostream& out) const;
+
+      ossim_uint64 jobsAdded;     //!< Number of jobs added to the pool.
+      ossim_uint64 jobsExecuted;  //!< Number of jobs run (or finished due to cancel).
+      ossim_uint64 jobsStolen;    //!< Number of jobs a worker took from another worker's deque.
+      ossim_uint64 stealAttempts; //!< Number of times a worker went looking for work to steal.
+      ossim_uint32 queueDepth;    //!< Jobs currently waiting on all deques.
+      ossim_uint32 maxQueueDepth; //!< High water mark of queueDepth.
+      ossim_uint32 busyThreads;   //!< Workers currently running a job.
+
+      /** Current depth of each worker's deque. */
+      std::vector<ossim_uint32> threadQueueDepth;
+
+      /** Number of jobs executed by each worker. */
+      std::vector<ossim_uint64> threadJobsExecuted;
+   };
+
+   /**
+   * Creates the pool and starts the worker threads.
+   *
+   * @param nThreads Number of workers.  If 0, ossim::getNumberOfThreads() is used.
+   */
+   ossimJobWorkStealingQueue(ossim_uint32 nThreads=0);
+
+   /**
+   * Cancels pending jobs, stops the workers and waits for them to exit.
+   */
+   virtual ~ossimJobWorkStealingQueue();
+
+   /**
+   * @return Process wide pool of ossim::getNumberOfThreads() workers, started on first call.
+   * For library code splitting one call's work, e.g. with parallelFor(), that would otherwise
+   * start threads of its own each time.
+   */
+   static ossimJobWorkStealingQueue* instance();
+
+   /**
+   * Adds a job to the pool. The job is marked ready and will be run by one of the workers.
+   *
+   * @param job The job to add.
+   */
+   void add(std::shared_ptr<ossimJob> job);
+
+   /**
+   * @return the number of worker threads.
+   */
+   ossim_uint32 getNumberOfThreads() const;
+
+   /**
+   * @return the number of jobs waiting to be run.
+   */
+   ossim_uint32 size() const;
+
+   /**
+   * @return true if no jobs are waiting to be run.
+   */
+   bool isEmpty() const;
+
+   /**
+   * @return the number of workers currently running a job.
+   */
+   ossim_uint32 numberOfBusyThreads() const;
+
+   /**
+   * @return true if jobs are waiting or running.
+   */
+   bool hasJobsToProcess() const;
+
+   /**
+   * Blocks the caller until every job added so far has been run. Must not be called from
+   * inside a job running on this pool.
+   */
+   void waitForJobsToFinish();
+
+   /**
+   * Calls work(i) for every i in [0, count) on up to shares workers plus the calling thread,
+   * and returns when all calls are done. Unlike waitForJobsToFinish() this waits only for its
+   * own work, so any number of threads may use one pool, including jobs running on it.
+   *
+   * @param count Number of calls.
+   * @param shares Most workers to hand calls to. 0 makes them all on the calling thread.
+   * @param work Called once per index, concurrently.
+   */
+   void parallelFor(ossim_uint32 count, ossim_uint32 shares,
+                    const std::function<void(ossim_uint32)>& work);
+
+   /**
+   * Removes all waiting jobs. Each removed job is canceled and marked finished.
+   */
+   void clear();
+
+   /**
+   * Clears the waiting jobs, cancels the running ones and tells the workers to exit.
+   */
+   void cancel();
+
+   /**
+   * Waits for all workers to exit. Usually called after @see cancel.
+   */
+   void waitForCompletion();
+
+   /**
+   * @return a snapshot of the queue-depth and steal counters.
+   */
+   Statistics getStatistics() const;
+
+   /**
+   * Zeroes the cumulative counters.
+   */
+   void resetStatistics();
+
+protected:
+   /**
+   * Per worker deque. Aligned to keep the hot locks of neighboring workers off the same
+   * cache line.
+   */
+   struct alignas(64) WorkerDeque
+   {
+      WorkerDeque();
+
+      mutable std::mutex                    m_mutex;
+      std::deque<std::shared_ptr<ossimJob> > m_jobs;
+      std::atomic<ossim_uint64>             m_executed;
+      std::shared_ptr<ossimJob>             m_currentJob;
+   };
+
+   class Worker : public ossim::Thread
+   {
+   public:
+      Worker(ossimJobWorkStealingQueue* pool, ossim_uint32 index);
+      virtual ~Worker();
+   protected:
+      virtual void run();
+   private:
+      ossimJobWorkStealingQueue* m_pool;
+      ossim_uint32               m_index;
+   };
+   friend class Worker;
+
+   /** Main loop executed by worker @index. */
+   void workerLoop(ossim_uint32 index);
+
+   /** Pops the oldest job from the worker's own deque. */
+   std::shared_ptr<ossimJob> popLocal(ossim_uint32 index);
+
+   /** Steals the oldest job from another worker's deque. */
+   std::shared_ptr<ossimJob> steal(ossim_uint32 index);
+
+   /** Runs the job and updates the counters. */
+   void execute(ossim_uint32 index, std::shared_ptr<ossimJob> job);
+
+   /** Called when a job leaves the pool, either run or discarded. */
+   void jobDone();
+
+   /** @return the index of the calling worker, or -1 if not called from one of our workers. */
+   ossim_int32 currentWorkerIndex() const;
+
+   std::vector<std::unique_ptr<WorkerDeque> > m_deques;
+   std::vector<std::shared_ptr<Worker> >       m_workers;
+
+   std::atomic<bool>         m_doneFlag;
+   std::atomic<ossim_uint32> m_nextDeque;
+   std::atomic<ossim_int64>  m_pendingJobs;     //!< Jobs sitting on the deques.
+   std::atomic<ossim_int64>  m_outstandingJobs; //!< Jobs added but not yet done.
+   std::atomic<ossim_uint32> m_busyThreads;
+   std::atomic<ossim_uint32> m_sleepingThreads;
+
+   std::mutex              m_idleMutex;
+   std::condition_variable m_idleCondition;
+   std::mutex              m_finishedMutex;
+   std::condition_variable m_finishedCondition;
+
+   std::atomic<ossim_uint64> m_jobsAdded;
+   std::atomic<ossim_uint64> m_jobsStolen;
+   std::atomic<ossim_uint64> m_stealAttempts;
+   std::atomic<ossim_uint32> m_maxQueueDepth;
+};
+
+#endif
@@ -13,10 +13,12 @@
 #include <ossim/imaging/ossimImageSourceSequencer.h>
 #include <ossim/base/ossimIpt.h>
 #include <ossim/base/ossimConnectableObjectListener.h>
-#include <ossim/parallel/ossimJobMultiThreadQueue.h>
+#include <ossim/parallel/ossimJobWorkStealingQueue.h>
 #include <ossim/parallel/ossimImageChainMtAdaptor.h>
 #include <ossim/base/Thread.h>
-#include <ossim/base/Block.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
 #include <mutex>
 //*************************************************************************************************
 //! This class manages the sequencing of tile requests across multiple threads. Note that multi-
@@ -49,6 +51,9 @@ public:
 
    //! Accessed for performance logging.
    ossim_uint32 maxCacheSize() const { return m_maxCacheSize; }
+
+   //! Accessed for performance logging. Queue depth and steal counts of the getTile job pool.
+   ossimJobWorkStealingQueue::Statistics getJobStatistics() const;
    bool loadState(const ossimKeywordlist& kwl, const char* prefix);
    void setUseSharedHandlers(bool use_shared_handlers);
    void setCacheTileSize(ossim_uint32 cache_tile_size);
@@ -71,8 +76,15 @@ public:
 
 protected:
 
-   // Associates a job with a tile ID for quick access to its tile data when finished:
-   typedef std::map<ossim_uint32 /*tile_ID*/, ossimRefPtr<ossimImageData> >  TileCache;
+   //! One slot of the tile reorder buffer. Tile N lives in slot N % m_maxCacheSize. The slot's
+   //! m_tileID is published (release) after m_tile is assigned, so a reader that sees its tile ID
+   //! there also sees the tile. An empty slot holds -1.
+   struct TileSlot
+   {
+      TileSlot() : m_tileID(-1), m_tile(0) {}
+      std::atomic<ossim_int64>    m_tileID;
+      ossimRefPtr<ossimImageData> m_tile;
+   };
 
    //! Private class representing a getTile job.
    class ossimGetTileJob : public ossimJob
@@ -112,31 +124,39 @@ protected:
    //! the output tile cache.
    void initJobs();
 
-   //! Access method to tile cache with scope lock to avoid multiple threads writing to
-   //! the cache simultaneously. 
+   //! Deposits a finished tile in its reorder buffer slot. No lock is taken; the writer thread is
+   //! only signaled if it is waiting.
    //! NOTE: chain_id being passed only for debug. To be removed.
    void setTileInCache(ossim_uint32 tile_id, ossimImageData* tile, ossim_uint32 chain_id, double dt /*for debug*/);
 
-   //! Method to job queue with scope lock to avoid multiple threads modifying the queue
-   //! simultaneously.
+   //! Claims the next tile ID and queues its getTile job. Blocks the calling worker while the
+   //! tile is more than m_maxCacheSize tiles ahead of the writer (backpressure).
    void nextJob(ossim_uint32 chain_id);
 
+   //! Stops and discards the current job pool, releasing any workers waiting for buffer space.
+   void stopJobs();
+
    //! For debug -- thread-safe console output
    void print(std::ostringstream& msg) const;
 
    ossimRefPtr<ossimImageChainMtAdaptor> m_inputChain; //!< Same as base class' theInputConnection
-   std::shared_ptr<ossimJobMultiThreadQueue> m_jobMtQueue;
+   std::shared_ptr<ossimJobWorkStealingQueue> m_jobMtQueue;
    ossim_uint32                          m_numThreads;
    std::shared_ptr<ossimGetTileCallback> m_callback;
-   ossim_uint32                          m_nextTileID; //!< ID of next tile to be threaded, different from base class' theCurrentTileNumber
-   TileCache                             m_tileCache;  //!< Saves tiles output by threaded jobs
+   std::atomic<ossim_uint32>             m_nextTileID; //!< ID of next tile to be threaded, different from base class' theCurrentTileNumber
+   std::unique_ptr<TileSlot[]>           m_tileCache;  //!< Reorder buffer of m_tileCacheSize slots for tiles output by threaded jobs
+   ossim_uint32                          m_tileCacheSize;
+   std::atomic<ossim_uint32>             m_consumedTiles; //!< Number of tiles handed out by getNextTile()
    ossim_uint32                          m_maxCacheSize;
    ossim_uint32                          m_maxTileCacheFactor;
-   mutable std::mutex                    m_cacheMutex;   
-   mutable std::mutex                    m_jobMutex;   
    ossim_uint32                          m_totalNumberOfTiles;
-   ossim::Block                          m_getTileBlock; //<! Blocks execution of main thread while waiting for tile to become available
-   ossim::Block                          m_nextJobBlock; //<! Blocks execution of worker threads
+   std::atomic<bool>                     m_stopJobs;
+   std::atomic<bool>                     m_writerWaiting;
+   std::atomic<ossim_uint32>             m_workersWaiting;
+   std::mutex                            m_getTileMutex;
+   std::condition_variable               m_getTileCondition; //<! Blocks execution of main thread while waiting for tile to become available
+   std::mutex                            m_nextJobMutex;
+   std::condition_variable               m_nextJobCondition; //<! Blocks execution of worker threads while the buffer is full
 
    // FOR DEBUG:
    mutable std::mutex d_printMutex;
@@ -0,0 +1,71 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+#ifndef ossimDeferredPlugin_HEADER
+#define ossimDeferredPlugin_HEADER 1
+
+#include <ossim/base/ossimConstants.h>
+#include <ossim/base/ossimFilename.h>
+#include <ossim/base/ossimString.h>
+#include <ossim/plugin/ossimPluginManifest.h>
+#include <vector>
+
+/**
+* Plugin registered from its ossimPluginManifest entry without loading the library.
+*
+* Stand in factories registered in place of the plugin's own call load() when a request
+* reaches them that the plugin may serve.  load() registers the plugin with the
+* ossimSharedPluginRegistry once.  While it runs, each listener captures the factories the
+* plugin registers with its registry (see ossimFactoryListInterface::setCaptureList) and then
+* serves the requests with them, so no factory list changes under a caller walking it.
+*/
+class OSSIMDLLEXPORT ossimDeferredPlugin
+{
+public:
+   /** Stand in factory told around the plugin load. */
+   class Listener
+   {
+   public:
+      virtual ~Listener() {}
+      virtual void beginLoad() = 0;
+      virtual void endLoad() = 0;
+   };
+
+   ossimDeferredPlugin(const ossimFilename& file, const ossimString& options,
+                       const ossimPluginManifest::Entry& entry);
+
+   const ossimFilename& getFilename()const { return m_file; }
+   const ossimString& getOptions()const { return m_options; }
+   const ossimPluginManifest::Entry& getEntry()const { return m_entry; }
+
+   void addListener(Listener* listener);
+
+   /**
+    * Loads the plugin if not done yet.  Loads of all deferred plugins are serialized.
+    * @param reason What was asked for, for the trace.
+    * @return true if the plugin is loaded.
+    */
+   bool load(const ossimString& reason);
+
+   bool isLoaded()const;
+
+private:
+   enum State
+   {
+      PENDING,
+      LOADED,
+      FAILED
+   };
+
+   ossimFilename              m_file;
+   ossimString                m_options;
+   ossimPluginManifest::Entry m_entry;
+   std::vector<Listener*>     m_listeners;
+   State                      m_state;
+};
+
+#endif /* #ifndef ossimDeferredPlugin_HEADER */
@@ -22,9 +22,14 @@ public:
    ossimString getDescription()const;
    void getClassNames(std::vector<ossimString>& classNames)const;
    void setOptions(const ossimString& options);
+
+   /** @return Seconds taken to load and initialize the library. */
+   double getLoadSeconds()const;
+   void setLoadSeconds(double seconds);
 protected:
    ossimString m_options;
    ossimSharedObjectInfo* m_info;
+   double m_loadSeconds;
 };
 
 #endif 
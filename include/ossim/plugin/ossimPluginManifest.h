@@ -0,0 +1,132 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+#ifndef ossimPluginManifest_HEADER
+#define ossimPluginManifest_HEADER 1
+
+#include <ossim/base/ossimConstants.h>
+#include <ossim/base/ossimFilename.h>
+#include <ossim/base/ossimString.h>
+#include <map>
+#include <string>
+#include <vector>
+
+class ossimKeywordlist;
+
+/**
+* Cache of what each plugin library registers, kept in a keyword list file so a later process
+* can defer loading a plugin until something it serves is asked for.
+*
+* An entry is stamped with the size and modification time of the library and the options it
+* was loaded with, and find() ignores it once any of those change.  Keywords, for plugin
+* index n:
+*
+* number_of_plugins: 12
+* plugin<n>.file: /usr/lib64/ossim/plugins/libossim_gdal_plugin.so
+* plugin<n>.size: 5123456
+* plugin<n>.modification_time: 1700000000
+* plugin<n>.options: ...
+* plugin<n>.deferrable: true
+* plugin<n>.image_handler.front: false
+* plugin<n>.image_handler.extensions: hdf jp2 ...
+* plugin<n>.image_handler.types: ossimGdalTileSource ...
+*
+* and the same for image_writer, which also has image_types, and projection.  For projection,
+* extensions and handler_types are the suffixes and image handler classes the plugin's
+* projection factories are asked to make projections for, those of its own image handlers.
+*/
+class OSSIMDLLEXPORT ossimPluginManifest
+{
+public:
+   /** Factories a plugin registers with one registry. */
+   struct Services
+   {
+      Services() : front(false), extensions(), types(), imageTypes(), handlerTypes() {}
+      bool empty()const
+      {
+         return extensions.empty() && types.empty() && imageTypes.empty() &&
+            handlerTypes.empty();
+      }
+
+      /** @return true if ext, in any case, is one of extensions. */
+      bool hasExtension(const ossimString& ext)const;
+
+      /** @return true if type, in any case, is one of types or imageTypes. */
+      bool hasType(const ossimString& type)const;
+
+      /** @return true if className is one of handlerTypes. */
+      bool hasHandlerType(const ossimString& className)const;
+
+      /**
+       * @return false if kwl names a type under prefix that is not one of types.  Lists
+       * without a type keyword may be served.
+       */
+      bool mayCreate(const ossimKeywordlist& kwl, const char* prefix)const;
+
+      /** Registered to the front of the registry. */
+      bool front;
+
+      /** File extensions served, lower case. */
+      std::vector<ossimString> extensions;
+
+      /** Type names the factories create by. */
+      std::vector<ossimString> types;
+
+      /** Writer image types, e.g. gdal_png, which writers are also created by. */
+      std::vector<ossimString> imageTypes;
+
+      /** Image handler classes projections are made from, e.g. ossimGdalTileSource. */
+      std::vector<ossimString> handlerTypes;
+   };
+
+   struct Entry
+   {
+      Entry() : size(0), modTime(0), options(), deferrable(false),
+                imageHandlers(), imageWriters(), projections() {}
+
+      ossim_int64 size;
+      ossim_int64 modTime;
+      ossimString options;
+
+      /**
+       * false if the plugin registered nothing to the registries below or registered so its
+       * position can not be reproduced later.  It must then be loaded at startup.
+       */
+      bool deferrable;
+
+      Services imageHandlers;
+      Services imageWriters;
+      Services projections;
+   };
+
+   ossimPluginManifest();
+
+   /** Reads file.  @return false if it could not be read; the manifest is then empty. */
+   bool read(const ossimFilename& file);
+
+   /** Writes the manifest to file.  @return true on success. */
+   bool write(const ossimFilename& file)const;
+
+   /**
+    * @return Entry of plugin if it matches the library on disk and options, null if not.
+    */
+   const Entry* find(const ossimFilename& plugin, const ossimString& options)const;
+
+   /** Stamps entry with the size and modification time of plugin and keeps it. */
+   void set(const ossimFilename& plugin, const ossimString& options, Entry entry);
+
+   /** @return true if set() was called since the last read() or write(). */
+   bool isModified()const { return m_modified; }
+
+private:
+   static bool getStamp(const ossimFilename& plugin, ossim_int64& size, ossim_int64& modTime);
+
+   std::map<std::string, Entry> m_entries;
+   mutable bool                 m_modified;
+};
+
+#endif /* #ifndef ossimPluginManifest_HEADER */
@@ -1,12 +1,15 @@
 #ifndef ossimSharedPluginRegistry_HEADER
 #define ossimSharedPluginRegistry_HEADER
 #include <iostream>
+#include <memory>
 #include <vector>
 #include <ossim/plugin/ossimSharedObjectBridge.h>
 #include <ossim/base/ossimFilename.h>
 #include <ossim/base/ossimRefPtr.h>
 #include <ossim/plugin/ossimPluginLibrary.h>
 
+class ossimDeferredPlugin;
+
 class OSSIMDLLEXPORT ossimSharedPluginRegistry
 {
 public:
@@ -33,6 +36,14 @@ public:
     * @return true if any of the plugins match file name, false if not.
     */
    bool isLoaded(const ossimFilename& filename) const;
+
+   /**
+    * Keeps plugin, registered from the plugin manifest and not loaded yet, so it can be listed.
+    * It shows up among the plugins above once loaded.
+    */
+   void registerDeferredPlugin(std::shared_ptr<ossimDeferredPlugin> plugin);
+   ossim_uint32 getNumberOfDeferredPlugins()const;
+   std::shared_ptr<const ossimDeferredPlugin> getDeferredPlugin(ossim_uint32 idx)const;
    
    void printAllPluginInformation(std::ostream& out);
    
@@ -43,6 +54,7 @@ protected:
 
    //static ossimSharedPluginRegistry* theInstance;   
    std::vector<ossimRefPtr<ossimPluginLibrary> > theLibraryList;
+   std::vector<std::shared_ptr<ossimDeferredPlugin> > theDeferredList;
 };
 
 #endif
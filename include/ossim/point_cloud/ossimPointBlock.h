@@ -14,27 +14,76 @@
 #include <ossim/base/ossimRefPtr.h>
 #include <ossim/base/ossimGrect.h>
 #include <ossim/point_cloud/ossimPointRecord.h>
+#include <atomic>
+#include <mutex>
 #include <vector>
 
 class ossimSource;
+class ossimDatum;
 
 /***************************************************************************************************
- * Base class for all Point Cloud data sources, including input file handlers and processing nodes.
+ * Block of point cloud samples.
+ *
+ * Points are stored by column: one contiguous array each for the lat (or y), lon (or x) and
+ * height of the positions, the point ids, and each field selected by the field code. A point
+ * costs 28 bytes plus 4 bytes per stored field, and loops over one attribute stream through
+ * memory. Read points with the column accessors, the per-point getPosition()/getField(), or
+ * iterate:
+ *
+ * @code
+ * for (ossimPointBlock::const_iterator p = block.begin(); p != block.end(); ++p)
+ *    sum += p.getField(ossimPointRecord::Intensity);
+ * @endcode
+ *
+ * For existing code, addPoint(ossimPointRecord*) appends a record's values, and getPoint(),
+ * operator[] and getPoints() hand back ossimPointRecord copies, made the first time one is asked
+ * for and refreshed in place after the block changes. Records from the non-const accessors may
+ * be edited, and getPoints() added to or shortened. Once handed out they stand for the block,
+ * and size() and the record accessors use them as they are. The first call that reads the
+ * columns, or changes the block otherwise, copies them back once; to edit again after that, get
+ * the records again.
  **************************************************************************************************/
 class OSSIMDLLEXPORT ossimPointBlock: public ossimDataObject
 {
 public:
    typedef std::vector< ossimRefPtr<ossimPointRecord> > PointList;
 
+   /** Read only cursor over the points of a block. */
+   class const_iterator
+   {
+   public:
+      const_iterator(const ossimPointBlock* block, ossim_uint32 index)
+         : m_block(block), m_index(index) {}
+
+      ossim_uint32  getIndex()    const { return m_index; }
+      ossim_uint32  getPointId()  const { return m_block->getPointId(m_index); }
+      ossimGpt      getPosition() const { return m_block->getPosition(m_index); }
+      ossim_float32 getField(ossimPointRecord::FIELD_CODES fc) const
+      { return m_block->getField(m_index, fc); }
+
+      const const_iterator& operator*() const { return *this; }
+      const const_iterator* operator->() const { return this; }
+      const_iterator& operator++() { ++m_index; return *this; }
+      bool operator==(const const_iterator& rhs) const { return m_index == rhs.m_index; }
+      bool operator!=(const const_iterator& rhs) const { return m_index != rhs.m_index; }
+
+   private:
+      const ossimPointBlock* m_block;
+      ossim_uint32           m_index;
+   };
+
    explicit ossimPointBlock(ossimSource* owner=0, ossim_uint32 fields=0);
 
    ~ossimPointBlock();
 
-   /** Returns allocated size. The pointList may contain only null points if not assigned */
-   virtual ossim_uint32 size() const { return (ossim_uint32)m_pointList.size(); }
+   /** Returns number of points stored. */
+   virtual ossim_uint32 size() const;
 
    bool empty() const { return (size() == 0); }
 
+   /** Reserves room for numPoints points with the current fields. */
+   void reserve(ossim_uint32 numPoints);
+
    /**
     * Returns OR'd mash-up of ossimPointRecord field codes being stored (or desired to be stored)
     */
@@ -43,22 +92,64 @@ public:
 
    /**
     * Initializes the desired fields to be stored. This will affect future getBlock() calls. If
-    * the point list contains points from prior read, they will be deleted unless the points field
-    * code matches the code argument.
+    * the block contains points from prior read, they will be deleted unless the field code
+    * matches the code argument.
     */
    void setFieldCode(ossim_uint32 code);
 
-   /** Adds single point to the tail of the list. */
+   /**
+    * Adds single point to the tail of the block, copying its position, id and the fields the
+    * block stores. The first point added to an empty block sets the fields stored to its own.
+    * The block takes a reference to point, so one allocated with new and not otherwise
+    * referenced is deleted.
+    */
    virtual void addPoint(ossimPointRecord* point);
 
+   /**
+    * Adds a point at pos to the tail of the block with its fields null.
+    * @return Index of the new point, for setField().
+    */
+   ossim_uint32 addPoint(const ossimGpt& pos, ossim_uint32 pointId=0);
+
+   /**
+    * Adds point i of block to the tail of this block. If this block is empty it takes the fields
+    * of block.
+    * @return Index of the new point.
+    */
+   ossim_uint32 addPoint(const ossimPointBlock& block, ossim_uint32 i);
+
+   ossimGpt      getPosition(ossim_uint32 i) const;
+   void          setPosition(ossim_uint32 i, const ossimGpt& pos);
+   ossim_uint32  getPointId(ossim_uint32 i) const { sync(); return m_pointId[i]; }
+
+   /** @return Field fc of point i, or NaN if the field is not stored. */
+   ossim_float32 getField(ossim_uint32 i, ossimPointRecord::FIELD_CODES fc) const;
+
+   /** Sets field fc of point i. Ignored if the field is not stored. */
+   void setField(ossim_uint32 i, ossimPointRecord::FIELD_CODES fc, ossim_float32 value);
+
+   /** Position columns, size() long. */
+   const ossim_float64* getLats() const { sync(); return m_lat.empty() ? 0 : &m_lat.front(); }
+   const ossim_float64* getLons() const { sync(); return m_lon.empty() ? 0 : &m_lon.front(); }
+   const ossim_float64* getHgts() const { sync(); return m_hgt.empty() ? 0 : &m_hgt.front(); }
+
+   /** @return Column of field fc, size() long, or null if the field is not stored. */
+   const ossim_float32* getFieldColumn(ossimPointRecord::FIELD_CODES fc) const;
+   ossim_float32*       getFieldColumn(ossimPointRecord::FIELD_CODES fc);
+
+   const_iterator begin() const { return const_iterator(this, 0); }
+   const_iterator end()   const { return const_iterator(this, size()); }
+
+   /** Compatibility access: returns a record copy of a point, or null if out of range. */
    virtual const ossimPointRecord* getPoint(ossim_uint32 point_offset) const;
    virtual ossimPointRecord* getPoint(ossim_uint32 point_offset);
 
    const ossimPointRecord* operator[](ossim_uint32 i) const { return getPoint(i); }
    ossimPointRecord* operator[](ossim_uint32 i) { return getPoint(i); }
 
-   virtual const PointList&  getPoints() const { return m_pointList; }
-   virtual PointList&  getPoints()  { return m_pointList; }
+   /** Compatibility access: returns record copies of all points. */
+   virtual const PointList&  getPoints() const;
+   virtual PointList&  getPoints();
 
    void getFieldMin(ossimPointRecord::FIELD_CODES field, ossim_float32& value) const;
    void getFieldMax(ossimPointRecord::FIELD_CODES field, ossim_float32& value) const;
@@ -69,28 +160,77 @@ public:
    virtual ossimObject* dup() const;
 
    /** Resets any storage to empty. */
-   virtual void clear() { m_pointList.clear(); m_isNormalized = false; m_minMaxValid = false;}
+   virtual void clear();
 
    /**
     *  Fulfills base class pure virtual. TODO: Needs to be correctly implemented
     */
    virtual bool isEqualTo(const ossimDataObject& /*rhs*/, bool /*deep_copy*/) const { return false; }
    virtual ossim_uint32 getHashId() const { return 0; }
-   virtual ossim_uint64 getDataSizeInBytes() const { return 0; };
+   virtual ossim_uint64 getDataSizeInBytes() const;
    virtual void initialize() {};
 
+   /** Number of field codes, i.e. the most columns a block has besides position and id. */
+   static const ossim_uint32 NUM_FIELDS = 8;
+
+   /** @return Column index 0 to NUM_FIELDS-1 of a single field code. */
+   static ossim_uint32 fieldIndex(ossimPointRecord::FIELD_CODES fc);
+
 protected:
-   ossimPointBlock(const ossimPointBlock& /* rhs */) {}
+   ossimPointBlock(const ossimPointBlock& /* rhs */)
+      : m_minMaxValid(false), m_fieldCode(0), m_isNormalized(false), m_datum(0),
+        m_pointListValid(false), m_pointsEditable(false) {}
+
+   /** Scans for the min and max records if not valid. Takes m_lazyMutex. */
+   void updateMinMax() const;
    void scanForMinMax() const;
 
+   /**
+    * Copies the records handed out by the non-const accessors to the columns, once per handout.
+    * Called by everything that reads or changes the columns.
+    */
+   void sync() const { if (m_pointsEditable.load()) syncColumns(); }
+   void syncColumns() const;
+
+   /**
+    * Makes or refreshes the record copies if the block changed, keeping the record objects
+    * already handed out. Assumes m_lazyMutex is held.
+    */
+   void makePointList() const;
+
+   /** Sizes the field columns to the field code and point count. */
+   void allocateFields();
+
+   /**
+    * Marks the record copies made for getPoint()/getPoints() and the min/max stale. Changes to
+    * the columns must sync() first.
+    */
+   void invalidate() { m_pointsEditable = false; m_minMaxValid = false; m_pointListValid = false; }
+
    ossimPointRecord m_nullPCR;
    mutable ossimPointRecord m_minRecord;
    mutable ossimPointRecord m_maxRecord;
    mutable bool m_minMaxValid;
-   PointList m_pointList;
    mutable ossim_uint32 m_fieldCode; // OR'd mash-up of ossimPointRecord::FIELD_CODES
    bool m_isNormalized;
 
+   std::vector<ossim_float64> m_lat;
+   std::vector<ossim_float64> m_lon;
+   std::vector<ossim_float64> m_hgt;
+   std::vector<ossim_uint32>  m_pointId;
+   std::vector<ossim_float32> m_fields[NUM_FIELDS]; // Empty unless the field is stored.
+   const ossimDatum*          m_datum;
+
+   /** Record copies for the compatibility accessors. */
+   mutable PointList m_pointList;
+   mutable bool      m_pointListValid;
+
+   /** True from a non-const handout of the records until they are copied to the columns. */
+   mutable std::atomic<bool> m_pointsEditable;
+
+   /** Guards the lazily made m_pointList and min/max records, read from several threads. */
+   mutable std::mutex m_lazyMutex;
+
 TYPE_DATA
 };
 
@@ -0,0 +1,78 @@
+//**************************************************************************************************
+//
+// OSSIM (http://trac.osgeo.org/ossim/)
+//
+// License:  LGPL -- See LICENSE.txt file in the top level directory for more details.
+//
+//**************************************************************************************************
+// $Id$
+
+#ifndef ossimPointCloudGrid_HEADER
+#define ossimPointCloudGrid_HEADER 1
+
+#include <ossim/base/ossimConstants.h>
+#include <vector>
+
+/***************************************************************************************************
+ * Dense accumulation grid for rasterizing point samples into one tile. Each cell keeps a sample
+ * count and, per band, the running value of the reducer: a sum for MEAN and SUM, the extreme for
+ * MIN and MAX.
+ *
+ * Grids of the same size are independent of each other, so threads may each fill their own grid
+ * from part of a point stream and merge() them afterwards.
+ **************************************************************************************************/
+class OSSIMDLLEXPORT ossimPointCloudGrid
+{
+public:
+   enum Reducer { MEAN=0, MIN, MAX, SUM, COUNT };
+
+   ossimPointCloudGrid();
+
+   ossimPointCloudGrid(ossim_uint32 width, ossim_uint32 height, ossim_uint32 numBands,
+                       Reducer reducer);
+
+   /** Sizes the grid and empties every cell. */
+   void initialize(ossim_uint32 width, ossim_uint32 height, ossim_uint32 numBands,
+                   Reducer reducer);
+
+   /** Empties every cell keeping the size and reducer. */
+   void clear();
+
+   ossim_uint32 getWidth()          const { return m_width; }
+   ossim_uint32 getHeight()         const { return m_height; }
+   ossim_uint32 getNumberOfBands()  const { return m_numBands; }
+   ossim_uint32 getNumberOfCells()  const { return m_width * m_height; }
+   Reducer      getReducer()        const { return m_reducer; }
+
+   /** Adds a sample with one value per band to cell (line * width + sample). */
+   void add(ossim_uint32 cell, const ossim_float32* values);
+
+   /** Adds a single band sample to cell. */
+   void add(ossim_uint32 cell, ossim_float32 value) { add(cell, &value); }
+
+   /**
+    * Folds the samples of grid into this one. Does nothing unless grid has the same size, bands
+    * and reducer.
+    */
+   void merge(const ossimPointCloudGrid& grid);
+
+   /** @return Number of samples added to cell. */
+   ossim_uint32 getCount(ossim_uint32 cell) const { return m_count[cell]; }
+
+   /** @return Reduced value of band for cell, or nullValue if the cell has no samples. */
+   ossim_float32 getValue(ossim_uint32 cell, ossim_uint32 band, ossim_float32 nullValue) const;
+
+   /** Writes the reduced values of band for all cells to buf, getNumberOfCells() long. */
+   void getBand(ossim_uint32 band, ossim_float32* buf, ossim_float32 nullValue) const;
+
+private:
+   ossim_uint32  m_width;
+   ossim_uint32  m_height;
+   ossim_uint32  m_numBands;
+   Reducer       m_reducer;
+
+   std::vector<ossim_uint32>  m_count;
+   std::vector<ossim_float64> m_value;   // cell * bands + band
+};
+
+#endif /* #ifndef ossimPointCloudGrid_HEADER */
@@ -15,6 +15,7 @@
 #include <ossim/imaging/ossimImageHandler.h>
 #include <ossim/base/ossimIrect.h>
 #include <ossim/point_cloud/ossimPointCloudHandler.h>
+#include <ossim/point_cloud/ossimPointCloudGrid.h>
 #include <vector>
 #include <mutex>
 
@@ -200,6 +201,7 @@ public:
     *    to "component" property (listed below)
     * -- the active component ("component") as string with possible values
     *    "intensity", "highest", "lowest", "returns", or "rgb", respectively (case insensitive)
+    * -- the number of threads ("threads") rasterizing each tile, 0 for ossim::getNumberOfThreads()
     */
    void setProperty(ossimRefPtr<ossimProperty> property) override;
    ossimRefPtr<ossimProperty> getProperty(const ossimString& name) const override;
@@ -216,28 +218,32 @@ public:
    void setGSD( const ossim_float64& gsd );
 
 
-protected:
-   class PcrBucket
-   {
-   public:
-      PcrBucket() : m_bucket(0), m_numSamples(0) {}
-      PcrBucket(const ossim_float32* init_value, ossim_uint32 numBands);
-      PcrBucket(const ossim_float32& R, const ossim_float32& G, const ossim_float32& B);
-
-      explicit PcrBucket(const ossim_float32& init_value);
+   /**
+    * @brief Sets the number of threads splitting the points of each tile.
+    * @param numThreads Thread count, 0 (the default) for ossim::getNumberOfThreads().
+    */
+   void setNumberOfThreads(ossim_uint32 numThreads);
 
-      ~PcrBucket();
-      ossim_float32* m_bucket;
-      int m_numSamples;
-   };
+   /** @return Number of threads splitting the points of each tile. */
+   ossim_uint32 getNumberOfThreads() const;
 
+protected:
    void initTile();
 
-   void addSample(std::map<ossim_int32, PcrBucket*>& accumulator,
-                  ossim_int32 index,
-                  const ossimPointRecord* sample);
+   /**
+    * Adds points [first, last) of block to the tile grid. Safe to run concurrently on disjoint
+    * ranges as long as each call has its own grid.
+    */
+   void accumulate(const ossimPointBlock& block,
+                   ossim_uint32 first,
+                   ossim_uint32 last,
+                   const ossimIpt& tile_offset,
+                   ossim_uint32 resLevel,
+                   Components component,
+                   ossimPointCloudGrid& grid) const;
 
-   void normalize(std::map<ossim_int32, PcrBucket*>& accumulator);
+   /** @return Reducer for the grid cells of component. */
+   static ossimPointCloudGrid::Reducer componentToReducer(Components component);
 
    ossim_uint32 componentToFieldCode() const;
 
@@ -250,6 +256,7 @@ protected:
    std::mutex                   m_mutex;
    Components                   m_activeComponent;
    std::vector<ossimString>     m_componentNames;
+   ossim_uint32                 m_numThreads;
 };
 
 #endif /* ossimPointCloudRenderer_HEADER */
@@ -47,6 +47,10 @@ public:
    
    virtual ossimDpt forward(const ossimGpt &worldPoint)    const;
    virtual ossimGpt inverse(const ossimDpt &projectedPoint)const;
+
+   /** Keeps the single point transforms, so batches go through forward/inverse. */
+   virtual bool hasBatchFastPath() const { return true; }
+
    virtual void update();
 
    /*!
@@ -0,0 +1,62 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+#ifndef ossimDeferredProjectionFactory_HEADER
+#define ossimDeferredProjectionFactory_HEADER 1
+
+#include <ossim/projection/ossimProjectionFactoryBase.h>
+#include <ossim/base/ossimFactoryListInterface.h>
+#include <ossim/plugin/ossimDeferredPlugin.h>
+#include <memory>
+
+/**
+* Stands in the ossimProjectionFactoryRegistry for the projection factories of a plugin that is
+* not loaded yet.  Lists types from the plugin manifest.  A type or keyword list request loads
+* the plugin only for a type it lists, or a code like "EPSG:4326" as codes can not be listed.
+* A file request loads it only for a suffix its image handlers serve, and an image handler
+* request only for one of its image handler classes, so an image with no core projection does
+* not load every plugin.  See ossimDeferredImageHandlerFactory.
+*/
+class OSSIMDLLEXPORT ossimDeferredProjectionFactory : public ossimProjectionFactoryBase,
+                                                       public ossimDeferredPlugin::Listener
+{
+public:
+   ossimDeferredProjectionFactory(std::shared_ptr<ossimDeferredPlugin> plugin);
+
+   virtual ossimProjection* createProjection(const ossimFilename& filename,
+                                             ossim_uint32 entryIdx)const;
+   virtual ossimProjection* createProjection(const ossimString& name)const;
+   virtual ossimProjection* createProjection(const ossimKeywordlist& kwl,
+                                             const char* prefix)const;
+   virtual ossimProjection* createProjection(ossimImageHandler* handler)const;
+
+   virtual ossimObject* createObject(const ossimString& typeName)const;
+   virtual ossimObject* createObject(const ossimKeywordlist& kwl, const char* prefix=0)const;
+   virtual void getTypeNameList(std::vector<ossimString>& typeList)const;
+
+   virtual void beginLoad();
+   virtual void endLoad();
+
+private:
+   typedef ossimFactoryListInterface<ossimProjectionFactoryBase,
+                                     ossimProjection>::RegistrationList RegistrationList;
+
+   /** Loads the plugin.  @return The factories it registered. */
+   const RegistrationList& load(const ossimString& reason)const;
+
+   /** @return true if name is listed or is a code. */
+   bool mayCreate(const ossimString& name)const;
+
+   std::shared_ptr<ossimDeferredPlugin> m_plugin;
+   const ossimPluginManifest::Services& m_services;
+   RegistrationList                     m_registrations;
+   RegistrationList*                    m_previousCapture;
+
+TYPE_DATA
+};
+
+#endif /* #ifndef ossimDeferredProjectionFactory_HEADER */
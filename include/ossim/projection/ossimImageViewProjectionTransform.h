@@ -53,6 +53,13 @@ public:
    //! Other workhorse of the object. Converts view-space to image-space.
    virtual void viewToImage(const ossimDpt& viewPoint, ossimDpt& imagePoint) const;
 
+   //! Batch forms. The geometry comparisons are done once per batch and the points are sent
+   //! through the geometries' batch localToWorld/worldToLocal.
+   virtual void imageToView(const ossimDpt* imagePoints, ossimDpt* viewPoints,
+                            ossim_uint32 count) const;
+   virtual void viewToImage(const ossimDpt* viewPoints, ossimDpt* imagePoints,
+                            ossim_uint32 count) const;
+
    //! Dumps contents to stream
    virtual std::ostream& print(std::ostream& out) const;
    
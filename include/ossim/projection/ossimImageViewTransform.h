@@ -78,6 +78,20 @@ public:
   
   virtual void viewToImage(const ossimDpt& viewPoint,
                            ossimDpt&       imagePoint)const;
+
+  /**
+   * Batch forms of imageToView and viewToImage.  Transforms count points in
+   * one call.  This implementation loops over the single point methods;
+   * derived classes override to pay their per call setup once per batch.
+   * Input and output arrays must not overlap.
+   */
+  virtual void imageToView(const ossimDpt* imagePoints,
+                           ossimDpt*       viewPoints,
+                           ossim_uint32    count)const;
+
+  virtual void viewToImage(const ossimDpt* viewPoints,
+                           ossimDpt*       imagePoints,
+                           ossim_uint32    count)const;
   
   virtual std::ostream& print(std::ostream& out) const;
   
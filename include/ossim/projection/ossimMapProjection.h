@@ -63,6 +63,26 @@ public:
    virtual ossimGpt lineSampleToWorld(const ossimDpt &projectedPoint)const;
    virtual void     lineSampleToWorld(const ossimDpt &projectedPoint,
                                       ossimGpt& gpt)const;
+
+   /**
+    * Batch forms.  By default these loop over the single point methods.  When
+    * hasBatchFastPath() is true the image/model transform is fetched once per
+    * batch and only forward()/inverse() are called per point.
+    */
+   virtual void worldToLineSample(const ossimGpt* worldPts,
+                                  ossimDpt*       lineSampPts,
+                                  ossim_uint32    count) const;
+   virtual void lineSampleToWorld(const ossimDpt* lineSampPts,
+                                  ossimGpt*       worldPts,
+                                  ossim_uint32    count) const;
+
+   /**
+    * @return true if the batch forms may skip the single point methods and
+    * call forward()/inverse() directly.  Defaults to false.  Only classes that
+    * keep the single point transforms of this class should return true.
+    */
+   virtual bool hasBatchFastPath() const;
+
    /**
     * This is the virtual that projects the image point to the given
     * elevation above ellipsoid, thereby bypassing reference to a DEM. Useful
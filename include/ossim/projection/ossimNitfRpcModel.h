@@ -47,6 +47,19 @@ public:
    virtual void  worldToLineSample(const ossimGpt& world_point,
                                    ossimDpt&       image_point) const;
 
+   /** Batch form of the above. */
+   virtual void  worldToLineSample(const ossimGpt* world_points,
+                                   ossimDpt*       image_points,
+                                   ossim_uint32    count) const;
+
+   /** Batch form of the above over coordinate arrays. */
+   virtual void  worldToLineSample(const double* lat,
+                                   const double* lon,
+                                   const double* hgt,
+                                   double*       line,
+                                   double*       samp,
+                                   ossim_uint32  count) const;
+
    /**
     * @brief lineSampleHeightToWorld()
     * Backs out decimation of image_point (if needed) then calls:
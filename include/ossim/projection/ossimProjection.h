@@ -71,6 +71,21 @@ public:
                                         const double&   heightAboveEllipsoid,
                                         ossimGpt&       worldPt) const = 0;
 
+   /**
+    * @brief Batch forms of worldToLineSample and lineSampleToWorld.
+    *
+    * Transforms count points in one call so that per call setup and virtual
+    * dispatch are paid once per batch.  The default implementations loop over
+    * the single point methods; derived classes with cheaper batch paths
+    * override them.  Input and output arrays must not overlap.
+    */
+   virtual void worldToLineSample(const ossimGpt* worldPts,
+                                  ossimDpt*       lineSampPts,
+                                  ossim_uint32    count) const;
+   virtual void lineSampleToWorld(const ossimDpt* lineSampPts,
+                                  ossimGpt*       worldPts,
+                                  ossim_uint32    count) const;
+
    virtual void getRoundTripError(const ossimDpt& imagePoint,
                                   ossimDpt& errorResult)const;
 
@@ -0,0 +1,137 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+#ifndef ossimProjectionGrid_HEADER
+#define ossimProjectionGrid_HEADER 1
+
+#include <ossim/base/ossimConstants.h>
+#include <ossim/base/ossimDpt.h>
+#include <ossim/base/ossimDrect.h>
+#include <ossim/base/ossimFilename.h>
+#include <ossim/base/ossimReferenced.h>
+#include <string>
+#include <vector>
+
+class ossimDatum;
+class ossimGpt;
+class ossimProjection;
+
+/**
+* Interpolation grid standing in for an expensive projection over one image.
+*
+* The projection is sampled at a stack of height layers, minHgt, minHgt + hgtStep, ... up to
+* maxHgt.  Each layer holds two bilinear grids with the same number of nodes: a forward grid of
+* lat/lon over the image rectangle, and an inverse grid of line/sample over the ground rectangle
+* the forward grid covers.  Points between layers are interpolated linearly in height.
+*
+* build() starts with eight cells along the longer image side and doubles the node count until
+* the grid agrees with the projection to within maxError pixels at the check points: the nodes,
+* the middle of every cell edge and every cell center, at every layer height and halfway between
+* layers.  Forward errors are measured in pixels by taking the grid's ground point back to the
+* image through the projection.  Between check points the error of a smooth projection stays
+* close to the bound but is not checked.  If 128 cells per side are not enough, or the footprint
+* crosses the date line, build() fails and the projection should be used directly.
+*
+* Queries outside the image rectangle, the height range or the ground grid return false, as do
+* those landing on cells where the projection itself failed, so callers fall back to the
+* projection for them.
+*
+* A built grid can be written to and read back from a binary file.  The file carries a caller
+* supplied key, e.g. the state of the projection, and read() only accepts a file whose key
+* matches.
+*/
+class OSSIM_DLL ossimProjectionGrid : public ossimReferenced
+{
+public:
+   ossimProjectionGrid();
+
+   /** Removes the grid. */
+   void clear();
+
+   /** @return true if the grid has been built or read. */
+   bool valid() const { return !m_layers.empty(); }
+
+   /**
+    * Samples proj over imageRect (full image space).
+    * @param hgtStep Spacing of the height layers in meters above the ellipsoid.
+    * @param maxError Largest error allowed at the check points, in pixels.
+    * @return true if the grid meets maxError.  On false the grid is left empty.
+    */
+   bool build(const ossimProjection* proj, const ossimDrect& imageRect,
+              double minHgt, double maxHgt, double hgtStep, double maxError);
+
+   /**
+    * @return Forward grid approximation of proj->lineSampleHeightToWorld(), false if ipt or hgt
+    * are outside the grid.
+    */
+   bool lineSampleHeightToWorld(const ossimDpt& ipt, double hgt, ossimGpt& gpt) const;
+
+   /**
+    * @return Inverse grid approximation of proj->worldToLineSample() for a point with a valid
+    * height, false if the point is outside the grid or maps outside the image rectangle.
+    */
+   bool worldToLineSample(const ossimGpt& gpt, ossimDpt& ipt) const;
+
+   /** @return Largest error in pixels found at the check points when the grid was built. */
+   double getMaxError() const { return m_maxError; }
+
+   const ossimDrect& getImageRect() const { return m_imageRect; }
+
+   ossim_uint32 getNumberOfLayers() const { return (ossim_uint32)m_layers.size(); }
+
+   /** @return Nodes per side of the grids of each layer. */
+   ossim_uint32 getCols() const { return m_cols; }
+   ossim_uint32 getRows() const { return m_rows; }
+
+   /** Reads a grid written with the same key.  @return true on success. */
+   bool read(const ossimFilename& file, const std::string& key);
+
+   /**
+    * Writes the grid with key to a temporary file renamed to file, so a concurrent reader sees
+    * the old file or the whole new one.  @return true on success.
+    */
+   bool write(const ossimFilename& file, const std::string& key) const;
+
+   /** @return 64 bit FNV-1a hash of key as 16 hex digits, for naming cache files. */
+   static std::string hashKey(const std::string& key);
+
+private:
+   struct Layer
+   {
+      std::vector<ossim_float64> lat;  // m_cols x m_rows nodes over m_imageRect
+      std::vector<ossim_float64> lon;
+      ossimDpt groundOrigin;           // lon, lat of the first inverse node
+      ossimDpt groundSpacing;          // lon, lat degrees between inverse nodes
+      std::vector<ossim_float64> x;    // m_cols x m_rows nodes over the ground rectangle
+      std::vector<ossim_float64> y;
+   };
+
+   /** Fills the forward and inverse grids of layer k from proj. */
+   void sampleLayer(const ossimProjection* proj, ossim_uint32 k);
+
+   /**
+    * Compares the grid to proj at the check points at height hgt, which lies between layer k
+    * and the next.  Stops once maxError is exceeded.  @return Largest error found in pixels.
+    */
+   double checkHeight(const ossimProjection* proj, double hgt, ossim_uint32 k,
+                      double maxError) const;
+
+   /** Finds the layers bracketing hgt. */
+   bool findLayer(double hgt, ossim_uint32& k, double& t) const;
+
+   ossimDrect         m_imageRect;
+   ossimDpt           m_spacing;    // Pixels between forward nodes.
+   ossim_uint32       m_cols;
+   ossim_uint32       m_rows;
+   ossim_float64      m_minHgt;
+   ossim_float64      m_hgtStep;
+   ossim_float64      m_maxError;
+   const ossimDatum*  m_datum;
+   std::vector<Layer> m_layers;
+};
+
+#endif /* #ifndef ossimProjectionGrid_HEADER */
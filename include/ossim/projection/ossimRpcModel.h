@@ -112,6 +112,33 @@ public:
     */
    virtual void  worldToLineSample(const ossimGpt& world_point,
                                    ossimDpt&       image_point) const;
+
+   /**
+    * @brief Batch worldToLineSample.  Normalization and adjustment constants
+    * are set up once for the whole batch.
+    */
+   virtual void  worldToLineSample(const ossimGpt* world_points,
+                                   ossimDpt*       image_points,
+                                   ossim_uint32    count) const;
+
+   /**
+    * @brief Batch worldToLineSample over ground coordinates held in separate
+    * arrays.  Points go through the polynomials two at a time with SSE2 on
+    * x86-64.
+    * @param lat Latitudes in degrees, count long.
+    * @param lon Longitudes in degrees, count long.
+    * @param hgt Heights above ellipsoid in meters, count long.  May be null,
+    * as may any entry be nan, for zero height.
+    * @param line Output lines, count long.  Nan where lat or lon is nan.
+    * @param samp Output samples, count long.  Nan where lat or lon is nan.
+    */
+   virtual void  worldToLineSample(const double* lat,
+                                   const double* lon,
+                                   const double* hgt,
+                                   double*       line,
+                                   double*       samp,
+                                   ossim_uint32  count) const;
+
    /**
     * @brief print()
     * Extends base-class implementation. Dumps contents of object to std::ostream.
@@ -140,6 +167,15 @@ public:
    //***
    virtual void  lineSampleToWorld(const ossimDpt& image_point,
                                    ossimGpt&       world_point) const;
+
+   /**
+    * @brief Batch lineSampleToWorld.  The imaging rays of all points are
+    * intersected with the DEM together so each iteration looks up the
+    * heights of every point still converging in one elevation call.
+    */
+   virtual void  lineSampleToWorld(const ossimDpt* image_points,
+                                   ossimGpt*       world_points,
+                                   ossim_uint32    count) const;
    //***
    // @brief lineSampleHeightToWorld()
    // Overrides base class pure virtual. Height understood to be relative to
@@ -262,6 +298,39 @@ protected:
                      const double& nlon,
                      const double& nhgt,
                      const double* coeffs) const;
+
+   //***
+   // The twenty monomials of a normalized ground point, computed once and
+   // shared by all four polynomials (and their partials) as dot products
+   // with the coefficients. The basis is in the coefficient order of
+   // thePolyType.
+   //***
+   void basis(const double& nlat,
+              const double& nlon,
+              const double& nhgt,
+              double* m) const;
+
+   /** Partials of the basis wrt normalized lat, lon and (if dHgt is not null) hgt. */
+   void basisPartials(const double& nlat,
+                      const double& nlon,
+                      const double& nhgt,
+                      double* dLat,
+                      double* dLon,
+                      double* dHgt) const;
+
+   /** @return Sum of the twenty products of coeffs and basis m. */
+   static double dot(const double* coeffs, const double* m);
+
+   /**
+    * Unadjusted normalized line (U) and sample (V) for count normalized ground
+    * points held in separate arrays.
+    */
+   void evaluate(const double* nlat,
+                 const double* nlon,
+                 const double* nhgt,
+                 double*       U,
+                 double*       V,
+                 ossim_uint32  count) const;
    
    PolynomialType thePolyType;
 
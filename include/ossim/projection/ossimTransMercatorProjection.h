@@ -30,6 +30,10 @@ public:
    virtual ossimObject *dup()const{return new ossimTransMercatorProjection(*this);}
    virtual ossimGpt inverse(const ossimDpt &eastingNorthing)const;
    virtual ossimDpt forward(const ossimGpt &latLon)const;
+
+   /** Keeps the single point transforms, so batches go through forward/inverse. */
+   virtual bool hasBatchFastPath() const { return true; }
+
    virtual void update();
    
    /*!
@@ -0,0 +1,61 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+#ifndef ossimImageHandlerStateStore_HEADER
+#define ossimImageHandlerStateStore_HEADER 1
+
+#include <ossim/base/ossimConstants.h>
+#include <ossim/base/ossimFilename.h>
+#include <ossim/base/ossimString.h>
+#include <ossim/support_data/ImageHandlerState.h>
+#include <memory>
+
+namespace ossim
+{
+   /**
+   * Persistent store of image handler states so a handler can be reopened from its state by a
+   * later process, e.g. the next ossim-info or ossim-chipper run over the same files.
+   *
+   * Each state is saved as a keyword list file in a directory, named by a hash of the id the
+   * ossimImageHandlerRegistry caches it under.  A file holds one state, so processes sharing the
+   * directory never rewrite each other's entries, and a new file is written aside and renamed
+   * into place.  The file is stamped with the size and modification time of the image and of
+   * its overview, and load() drops a state whose files have changed since.  States of
+   * connection strings that are not local files are not stored, as there is nothing cheap to
+   * check them against.
+   */
+   class OSSIM_DLL ImageHandlerStateStore
+   {
+   public:
+      ImageHandlerStateStore(const ossimFilename& directory);
+
+      const ossimFilename& getDirectory()const{return m_directory;}
+
+      /**
+      * @return State saved under id, null if there is none or it no longer matches the files it
+      * was saved for.
+      */
+      std::shared_ptr<ImageHandlerState> load(const ossimString& id)const;
+
+      /**
+      * Saves state under id.  Creates the directory if needed.
+      * @return true on success.
+      */
+      bool save(const ossimString& id, const ImageHandlerState& state)const;
+
+      /** Removes the state saved under id. */
+      void remove(const ossimString& id)const;
+
+      /** @return File holding the state saved under id. */
+      ossimFilename getFile(const ossimString& id)const;
+
+   private:
+      ossimFilename m_directory;
+   };
+}
+
+#endif /* #ifndef ossimImageHandlerStateStore_HEADER */
@@ -0,0 +1,119 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+#ifndef ossimLasPointIndex_HEADER
+#define ossimLasPointIndex_HEADER 1
+
+#include <ossim/base/ossimConstants.h>
+#include <ossim/base/ossimFilename.h>
+#include <vector>
+
+/**
+* Spatial index of the point records of a LAS file.
+*
+* The bounds of the file are split into a uniform grid of cells.  For every cell the index
+* keeps the runs of consecutive record numbers whose points fall in it, so a reader can fetch
+* the records under a rectangle with a few ranged reads instead of scanning the whole file.
+* LAS files are usually written in flight line or tile order, which keeps the runs long and the
+* index small.
+*
+* The index is built by one pass over the records, feeding each point to add() in record
+* order, and can be saved to and read back from a binary sidecar file stamped with the size and
+* modification time of the LAS file it describes.
+*
+* Example:
+* @code
+* ossimLasPointIndex index;
+* index.initialize(minX, minY, maxX, maxY, numberOfPoints);
+* for ( each record r at x, y ) index.add(r, x, y);
+* index.finalize();
+* std::vector<ossimLasPointIndex::Range> ranges;
+* index.getRanges(tileMinX, tileMinY, tileMaxX, tileMaxY, ranges);
+* @endcode
+*/
+class OSSIM_DLL ossimLasPointIndex
+{
+public:
+   /** Records [first, first + count). */
+   struct Range
+   {
+      ossim_uint64 first;
+      ossim_uint64 count;
+   };
+
+   ossimLasPointIndex();
+
+   /** Removes the index. */
+   void clear();
+
+   /**
+    * Starts a new index over the bounds.  The grid is sized to hold about POINTS_PER_CELL
+    * points per cell.
+    */
+   void initialize(double minX, double minY, double maxX, double maxY,
+                   ossim_uint64 numberOfPoints);
+
+   /**
+    * Adds record at x, y.  Records must be added in increasing order.  Points outside the
+    * bounds go to the nearest edge cell.
+    */
+   void add(ossim_uint64 record, double x, double y);
+
+   /** Packs the cells after the last add().  Searches are valid after this. */
+   void finalize();
+
+   /** @return true if the index has been built or read. */
+   bool valid() const { return !m_cellStart.empty(); }
+
+   /**
+    * Initializes ranges with the sorted records of every cell touching the rectangle.  Runs
+    * closer than maxGap records apart are merged, as one read of a few unwanted records is
+    * cheaper than a seek.  The records returned are a superset of those in the rectangle.
+    */
+   void getRanges(double minX, double minY, double maxX, double maxY,
+                  std::vector<Range>& ranges, ossim_uint64 maxGap=256) const;
+
+   /** @return true and the bounds passed to initialize() if valid. */
+   bool getBounds(double& minX, double& minY, double& maxX, double& maxY) const;
+
+   /**
+    * Reads an index written by write().
+    * @param numberOfPoints Point records in the LAS file, which bounds the runs read.
+    * @return true if file holds an index stamped with fileSize and modTime.
+    */
+   bool read(const ossimFilename& file, ossim_uint64 fileSize, ossim_int64 modTime,
+             ossim_uint64 numberOfPoints);
+
+   /**
+    * Writes the index stamped with the size and modification time of the LAS file.  The file
+    * is written aside and moved into place, so concurrent readers see a whole file or none.
+    */
+   bool write(const ossimFilename& file, ossim_uint64 fileSize, ossim_int64 modTime) const;
+
+   /** Target number of points per grid cell. */
+   static const ossim_uint64 POINTS_PER_CELL = 4096;
+
+private:
+   void getCell(double x, double y, ossim_int64& col, ossim_int64& row) const;
+
+   double m_minX;
+   double m_minY;
+   double m_maxX;
+   double m_maxY;
+   ossim_uint32 m_cols;
+   ossim_uint32 m_rows;
+
+   /** Runs of cell i are m_first/m_count [m_cellStart[i], m_cellStart[i + 1]). */
+   std::vector<ossim_uint64> m_cellStart;
+   std::vector<ossim_uint64> m_first;
+   std::vector<ossim_uint32> m_count;
+
+   /** Runs per cell while building. */
+   std::vector< std::vector<Range> > m_building;
+};
+
+#endif /* #ifndef ossimLasPointIndex_HEADER */
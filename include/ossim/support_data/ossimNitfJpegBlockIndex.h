@@ -0,0 +1,72 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+#ifndef ossimNitfJpegBlockIndex_HEADER
+#define ossimNitfJpegBlockIndex_HEADER 1
+
+#include <ossim/base/ossimConstants.h>
+#include <ossim/base/ossimFilename.h>
+#include <iosfwd>
+#include <vector>
+
+/**
+* Offsets and sizes of the JPEG blocks of a JPEG compressed (C3/M3) NITF image segment.
+*
+* The blocks of such a segment are stored as separate JPEG streams with no table of their
+* sizes, so they have to be found by scanning the segment for SOI and EOI markers.  scan() reads
+* the stream in large chunks and jumps between 0xFF bytes with memchr rather than pulling one
+* byte at a time from the stream.  Marker segments that may hold a stray 0xFF 0xD9 are skipped
+* by their length.
+*
+* A scan of a large image still reads the whole segment, so the result can be saved to and
+* read back from a binary sidecar file stamped with the size and modification time of the NITF
+* file and the location of the segment.
+*/
+class OSSIM_DLL ossimNitfJpegBlockIndex
+{
+public:
+   ossimNitfJpegBlockIndex();
+
+   /** Removes the offsets. */
+   void clear();
+
+   /**
+    * Scans str from start for up to totalBlocks JPEG streams.  Stops at the end of the stream,
+    * so fewer blocks are found if the segment is masked or damaged.
+    * @return true if totalBlocks blocks were found.
+    */
+   bool scan(std::istream& str, std::streamoff start, ossim_uint32 totalBlocks);
+
+   /** @return Number of blocks found. */
+   ossim_uint32 getNumberOfBlocks() const { return (ossim_uint32)m_offsets.size(); }
+
+   /** @return File offset of the SOI marker of each block found. */
+   const std::vector<std::streamoff>& getOffsets() const { return m_offsets; }
+
+   /** @return Bytes from the SOI marker to the end of the EOI marker of each block found. */
+   const std::vector<ossim_uint32>& getSizes() const { return m_sizes; }
+
+   /**
+    * Reads offsets written by write().
+    * @return true if file holds offsets stamped with fileSize, modTime, start and totalBlocks.
+    */
+   bool read(const ossimFilename& file, ossim_uint64 fileSize, ossim_int64 modTime,
+             std::streamoff start, ossim_uint32 totalBlocks);
+
+   /** Writes the offsets stamped with the NITF file and segment they describe. */
+   bool write(const ossimFilename& file, ossim_uint64 fileSize, ossim_int64 modTime,
+              std::streamoff start, ossim_uint32 totalBlocks) const;
+
+   /** Bytes read from the stream at a time by scan(). */
+   static const ossim_uint32 SCAN_BUFFER_SIZE = 1048576;
+
+private:
+   std::vector<std::streamoff> m_offsets;
+   std::vector<ossim_uint32>   m_sizes;
+};
+
+#endif /* #ifndef ossimNitfJpegBlockIndex_HEADER */
@@ -73,6 +73,24 @@ public:
                            ossim_uint32 row,
                            ossim_uint32 col)const;
    
+   /**
+    * Decodes a subframe into 256x256 band sequential pixels, one band for CIB
+    * or three for CADRG, by looking the VQ codes up in the compression and
+    * color tables.  A missing subframe decodes to zeros.
+    *
+    * @param buffer Holds 256*256*bands bytes.
+    * @return false if the frame has no compression or color tables.
+    */
+   bool decodeSubFrame(ossim_uint8* buffer,
+                       ossim_uint32 bands,
+                       ossim_uint32 row,
+                       ossim_uint32 col)const;
+
+   const ossimFilename& getFilename()const
+   {
+      return theFilename;
+   }
+
    const ossimRpfCompressionSection* getCompressionSection()const
    {
       return theCompressionSection;
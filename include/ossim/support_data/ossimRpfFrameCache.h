@@ -0,0 +1,88 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+#ifndef ossimRpfFrameCache_HEADER
+#define ossimRpfFrameCache_HEADER 1
+
+#include <ossim/base/ossimConstants.h>
+#include <ossim/base/ossimFilename.h>
+#include <ossim/base/ossimString.h>
+#include <ossim/base/ItemCache.h>
+#include <memory>
+#include <vector>
+
+class ossimRpfFrame;
+
+/**
+* Process wide cache of parsed RPF frame files and of their decoded subframes, shared by the
+* CIB/CADRG and RPF cache tile sources.
+*
+* A viewer panning over a map keeps asking for tiles from the same few frames.  Without the
+* cache each tile parsed every frame it touched again and VQ decoded the subframes again.
+* Frames are keyed by path and subframes by path, row, column and band count.  Both are kept
+* in LRU ossim::ItemCache's sized from the preferences:
+*
+* rpf.frame_cache.max_frames: 32
+* rpf.frame_cache.max_subframes: 512
+*
+* A CADRG subframe is 192 KiB decoded, so the default subframe limit is about 96 MiB.  The
+* frames and subframes handed out are never modified, so callers may hold on to them after
+* they drop out of the cache.
+*/
+class OSSIM_DLL ossimRpfFrameCache
+{
+public:
+   typedef std::vector<ossim_uint8> SubFrameData;
+   typedef std::shared_ptr<const SubFrameData> SubFrame;
+
+   /** One subframe wanted by getSubFrames(). */
+   struct SubFrameRequest
+   {
+      ossimFilename file;
+      ossim_uint32  row;
+      ossim_uint32  col;
+      SubFrame      data; // Set by getSubFrames().
+   };
+
+   static ossimRpfFrameCache* instance();
+
+   /** @return The parsed frame, null if file could not be parsed. */
+   std::shared_ptr<const ossimRpfFrame> getFrame(const ossimFilename& file);
+
+   /**
+    * @return Subframe row, col of file decoded into 256x256 band sequential pixels of bands
+    * bands, null if the frame could not be parsed or decoded.  A subframe missing from the frame
+    * comes back as zeros.
+    */
+   SubFrame getSubFrame(const ossimFilename& file, ossim_uint32 row, ossim_uint32 col,
+                        ossim_uint32 bands);
+
+   /**
+    * Fills in the data of each request.  Subframes not in the cache are decoded on the shared
+    * ossimJobWorkStealingQueue::instance() pool.
+    */
+   void getSubFrames(std::vector<SubFrameRequest>& requests, ossim_uint32 bands);
+
+   /** Sets the number of frames and subframes to keep. */
+   void setLimits(ossim_uint32 maxFrames, ossim_uint32 maxSubFrames);
+
+   /** Empties the cache, e.g. after frame files were replaced. */
+   void clear();
+
+private:
+   ossimRpfFrameCache();
+   ossimRpfFrameCache(const ossimRpfFrameCache&);
+   const ossimRpfFrameCache& operator=(const ossimRpfFrameCache&);
+
+   static ossimString subFrameKey(const ossimFilename& file, ossim_uint32 row, ossim_uint32 col,
+                                  ossim_uint32 bands);
+
+   ossim::ItemCache<const ossimRpfFrame> m_frames;
+   ossim::ItemCache<const SubFrameData>  m_subFrames;
+};
+
+#endif /* #ifndef ossimRpfFrameCache_HEADER */
@@ -22,7 +22,7 @@
 #include <ossim/imaging/ossimMemoryImageSource.h>
 #include <ossim/projection/ossimImageViewProjectionTransform.h>
 #include <ossim/parallel/ossimJob.h>
-#include <ossim/parallel/ossimJobMultiThreadQueue.h>
+#include <ossim/parallel/ossimJobWorkStealingQueue.h>
 #include <ossim/point_cloud/ossimPointCloudHandler.h>
 #include <ossim/util/ossimChipProcTool.h>
 #include <vector>
@@ -53,6 +53,7 @@ protected:
    ossimRefPtr<ossimPointCloudImageHandler> m_pciHandler;
    ossimRefPtr<ossimPointCloudUtilityFilter> m_pcuFilter;
    double m_gsd;
+   ossim_uint32 m_numThreads; // Threads rasterizing each tile, 0 for all cores.
    ossimFilename m_lutFile;
    ossimFilename m_prodFile;
    ossimFilename m_demFile;
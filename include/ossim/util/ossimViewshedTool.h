@@ -11,7 +11,7 @@
 #include <ossim/projection/ossimMapProjection.h>
 #include <ossim/imaging/ossimMemoryImageSource.h>
 #include <ossim/parallel/ossimJob.h>
-#include <ossim/parallel/ossimJobMultiThreadQueue.h>
+#include <ossim/parallel/ossimJobWorkStealingQueue.h>
 #include <ossim/util/ossimChipProcTool.h>
 #include <mutex>
 /*!
@@ -100,7 +100,7 @@ protected:
    ossim_uint8 m_overlayValue;
    ossim_int32 m_reticleSize;
    bool m_simulation;
-   std::shared_ptr<ossimJobMultiThreadQueue> m_jobMtQueue;
+   std::shared_ptr<ossimJobWorkStealingQueue> m_jobMtQueue;
    ossim_uint32 m_numThreads;
    double m_startFov;
    double m_stopFov;
@@ -13,6 +13,7 @@
 //*****************************************************************************
 
 #include <ossim/base/ossimGeoid.h>
+#include <ossim/base/ossimGpt.h>
 
 RTTI_DEF2(ossimGeoid, "ossimGeoid", ossimObject, ossimErrorStatusInterface)
 RTTI_DEF1(ossimIdentityGeoid, "ossimIdentityGeoid", ossimGeoid)
@@ -25,3 +26,13 @@ ossimGeoid::ossimGeoid()
 
 ossimGeoid::~ossimGeoid()
 {}
+
+void ossimGeoid::offsetsFromEllipsoid(const ossimGpt* gpts,
+                                      double* offsets,
+                                      ossim_uint32 count)
+{
+   for (ossim_uint32 i = 0; i < count; ++i)
+   {
+      offsets[i] = offsetFromEllipsoid(gpts[i]);
+   }
+}
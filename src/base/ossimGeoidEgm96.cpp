@@ -15,8 +15,15 @@
 #include <ossim/base/ossimTrace.h>
 #include <ossim/base/ossimNotifyContext.h>
 #include <ossim/base/ossimDatumFactory.h>
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 
+#if defined(__x86_64__) || defined(_M_X64)
+#  define OSSIM_GEOID_EGM96_X86 1
+#  include <emmintrin.h>
+#endif
+
 static ossimTrace traceDebug ("ossimGeoidEgm96:debug");
 
 
@@ -31,13 +38,15 @@ static ossimTrace traceDebug ("ossimGeoidEgm96:debug");
 RTTI_DEF1(ossimGeoidEgm96, "ossimGeoidEgm96", ossimGeoid)
 
 ossimGeoidEgm96::ossimGeoidEgm96()
-   :theGeoidHeightBufferPtr(0)
+   :theGeoidHeightBufferPtr(0),
+    theWgs84Datum(ossimDatumFactory::instance()->wgs84())
 {
 }
 
 ossimGeoidEgm96::ossimGeoidEgm96(const ossimFilename& grid_file,
                                  ossimByteOrder byteOrder)
-   :theGeoidHeightBufferPtr(0)
+   :theGeoidHeightBufferPtr(0),
+    theWgs84Datum(ossimDatumFactory::instance()->wgs84())
 {
    open(grid_file, byteOrder);
    if (getErrorStatus() != ossimErrorCodes::OSSIM_OK)
@@ -170,12 +179,6 @@ bool ossimGeoidEgm96::open(const ossimFilename& grid_file,
 double ossimGeoidEgm96::offsetFromEllipsoid(const ossimGpt& gpt)
 {
    double offset = ossim::nan();
-   ossimGpt savedGpt = gpt;
-   if(ossimDatumFactory::instance()->wgs84())
-   {
-      savedGpt.changeDatum(ossimDatumFactory::instance()->wgs84());
-   }
-   
    if (!theGeoidHeightBufferPtr)
    {
       if(traceDebug())
@@ -187,105 +190,179 @@ double ossimGeoidEgm96::offsetFromEllipsoid(const ossimGpt& gpt)
 
       return offset;
    }
-   
-   long    Index;
-   double DeltaX, DeltaY;
-   double ElevationSE, ElevationSW, ElevationNE, ElevationNW;
-   double LatitudeDD, LongitudeDD;
-   double OffsetX, OffsetY;
-   double PostX, PostY;
-   double UpperY, LowerY;
-
-   LatitudeDD  = savedGpt.latd();
-   
-   // Check for wrap.
-   if (LatitudeDD < -90.0)
+
+   // Only shift points that are not already WGS84:
+   long   index;
+   double dx, dy;
+   bool   found;
+   if ( !theWgs84Datum || (gpt.datum() == theWgs84Datum) )
    {
-      LatitudeDD = -180.0 - LatitudeDD;
+      found = locate(gpt.latd(), gpt.lond(), index, dx, dy);
    }
-   else if (LatitudeDD > 90.0)
+   else
    {
-      LatitudeDD = 180.0 - LatitudeDD;
+      ossimGpt savedGpt = gpt;
+      savedGpt.changeDatum(theWgs84Datum);
+      found = locate(savedGpt.latd(), savedGpt.lond(), index, dx, dy);
    }
 
-   if ( (LatitudeDD < -90.0) || LatitudeDD > 90.0)
+   if (found)
    {
-      if(traceDebug())
+      offset = interpolate(index, dx, dy);
+   }
+   else if (traceDebug())
+   {
+      ossimNotify(ossimNotifyLevel_FATAL)
+         << "FATAL: " << "ossimGeoidEgm96::offsetFromEllipsoid, "
+         << "Point out of range:  " << gpt << "\n";
+   }
+
+   return offset;
+}
+
+void ossimGeoidEgm96::offsetsFromEllipsoid(const ossimGpt* gpts,
+                                           double* offsets,
+                                           ossim_uint32 count)
+{
+   if (!theGeoidHeightBufferPtr)
+   {
+      std::fill(offsets, offsets + count, ossim::nan());
+      return;
+   }
+
+   //---
+   // Points go through in chunks: first the cell of every point, then the
+   // interpolation.  Out of range points get index -1.
+   //---
+   const ossim_uint32 CHUNK_SIZE = 64;
+   long   index[CHUNK_SIZE];
+   double dx[CHUNK_SIZE];
+   double dy[CHUNK_SIZE];
+   for (ossim_uint32 start = 0; start < count; start += CHUNK_SIZE)
+   {
+      const ossim_uint32 n = std::min(count - start, CHUNK_SIZE);
+      for (ossim_uint32 i = 0; i < n; ++i)
       {
-         // Latitude out of range
-         ossimNotify(ossimNotifyLevel_FATAL)
-            << "FATAL: " << "ossimGeoidEgm96::offsetFromEllipsoid, "
-            << "Point out of range:  " << savedGpt << "\n";
+         const ossimGpt& gpt = gpts[start + i];
+         bool found;
+         if ( !theWgs84Datum || (gpt.datum() == theWgs84Datum) )
+         {
+            found = locate(gpt.latd(), gpt.lond(), index[i], dx[i], dy[i]);
+         }
+         else
+         {
+            ossimGpt savedGpt = gpt;
+            savedGpt.changeDatum(theWgs84Datum);
+            found = locate(savedGpt.latd(), savedGpt.lond(), index[i], dx[i], dy[i]);
+         }
+         if (!found)
+         {
+            index[i] = -1;
+            dx[i] = 0.0;
+            dy[i] = 0.0;
+         }
+      }
+
+      double* out = offsets + start;
+      ossim_uint32 i = 0;
+
+#if defined(OSSIM_GEOID_EGM96_X86)
+      // Two points at a time, the same operations in the same order as interpolate():
+      const float* buf = theGeoidHeightBufferPtr;
+      for ( ; i + 2 <= n; i += 2)
+      {
+         if ( (index[i] < 0) || (index[i + 1] < 0) )
+         {
+            out[i]     = (index[i] < 0) ? ossim::nan() : interpolate(index[i], dx[i], dy[i]);
+            out[i + 1] = (index[i + 1] < 0) ? ossim::nan() :
+               interpolate(index[i + 1], dx[i + 1], dy[i + 1]);
+            continue;
+         }
+
+         const float* a = buf + index[i];
+         const float* b = buf + index[i + 1];
+         const __m128d nw = _mm_set_pd(b[0], a[0]);
+         const __m128d ne = _mm_set_pd(b[1], a[1]);
+         const __m128d sw = _mm_set_pd(b[NumbGeoidCols], a[NumbGeoidCols]);
+         const __m128d se = _mm_set_pd(b[NumbGeoidCols + 1], a[NumbGeoidCols + 1]);
+         const __m128d DX = _mm_loadu_pd(dx + i);
+         const __m128d DY = _mm_loadu_pd(dy + i);
+
+         const __m128d upper = _mm_add_pd(nw, _mm_mul_pd(DX, _mm_sub_pd(ne, nw)));
+         const __m128d lower = _mm_add_pd(sw, _mm_mul_pd(DX, _mm_sub_pd(se, sw)));
+         _mm_storeu_pd(out + i, _mm_add_pd(upper, _mm_mul_pd(DY, _mm_sub_pd(lower, upper))));
+      }
+#endif
+
+      for ( ; i < n; ++i)
+      {
+         out[i] = (index[i] < 0) ? ossim::nan() : interpolate(index[i], dx[i], dy[i]);
       }
-      return offset;
    }
-   
-   LongitudeDD = savedGpt.lond();
+}
 
+bool ossimGeoidEgm96::locate(double lat, double lon,
+                             long& index, double& dx, double& dy) const
+{
    // Check for wrap.
-   if (LongitudeDD < -180)
+   if (lat < -90.0)
    {
-      LongitudeDD = LongitudeDD + 360.0;
+      lat = -180.0 - lat;
    }
-   else if (LongitudeDD > 180.0)
+   else if (lat > 90.0)
    {
-      LongitudeDD = LongitudeDD - 360.0;
+      lat = 180.0 - lat;
    }
-
-   if ( (LongitudeDD < -180.0) || (LongitudeDD > 180.0) )
+   if (lon < -180.0)
    {
-      // Longitude out of range
-      if(traceDebug())
-      {
-         ossimNotify(ossimNotifyLevel_FATAL)
-            << "FATAL: " << "ossimGeoidEgm96::offsetFromEllipsoid, "
-            << "Point out of range:  " << savedGpt << "\n";
-      }
-      return offset;
+      lon = lon + 360.0;
    }
-   
-   // Compute X and Y Offsets into Geoid Height Array:
-   
-   if (LongitudeDD < 0.0)
+   else if (lon > 180.0)
    {
-      OffsetX = ( LongitudeDD + 360.0 ) * ScaleFactor;
+      lon = lon - 360.0;
    }
-   else
+
+   // Written so NaNs fail too:
+   if ( !( (lat >= -90.0) && (lat <= 90.0) && (lon >= -180.0) && (lon <= 180.0) ) )
    {
-      OffsetX = LongitudeDD * ScaleFactor;
+      return false;
    }
-   OffsetY = ( 90.0 - LatitudeDD ) * ScaleFactor;
-   
+
+   // Compute X and Y Offsets into Geoid Height Array:
+   const double offsetX = ( (lon < 0.0) ? (lon + 360.0) : lon ) * ScaleFactor;
+   const double offsetY = ( 90.0 - lat ) * ScaleFactor;
+
    //---
    // Find Four Nearest Geoid Height Cells for specified Latitude,
    // Longitude;  Assumes that (0,0) of Geoid Height Array is at
    // Northwest corner:
    //---
-   PostX = floor( OffsetX );
-   if ((PostX + 1) == NumbGeoidCols)
-      PostX--;
-   PostY = floor( OffsetY );
-   if ((PostY + 1) == NumbGeoidRows)
-      PostY--;
-   
-   Index = (long)(PostY * NumbGeoidCols + PostX);
-   ElevationNW = theGeoidHeightBufferPtr[ Index ];
-   ElevationNE = theGeoidHeightBufferPtr[ Index+ 1 ];
-   
-   Index = (long)((PostY + 1) * NumbGeoidCols + PostX);
-   ElevationSW = theGeoidHeightBufferPtr[ Index ];
-   ElevationSE = theGeoidHeightBufferPtr[ Index + 1 ];
-   
+   double postX = floor( offsetX );
+   if ((postX + 1) == NumbGeoidCols)
+      postX--;
+   double postY = floor( offsetY );
+   if ((postY + 1) == NumbGeoidRows)
+      postY--;
+
+   index = (long)(postY * NumbGeoidCols + postX);
+   dx = offsetX - postX;
+   dy = offsetY - postY;
+   return true;
+}
+
+double ossimGeoidEgm96::interpolate(long index, double dx, double dy) const
+{
+   const float* p = theGeoidHeightBufferPtr + index;
+   const double elevationNW = p[0];
+   const double elevationNE = p[1];
+   const double elevationSW = p[NumbGeoidCols];
+   const double elevationSE = p[NumbGeoidCols + 1];
+
    //Perform Bi-Linear Interpolation to compute Height above Ellipsoid:
-   DeltaX = OffsetX - PostX;
-   DeltaY = OffsetY - PostY;
-   
-   UpperY = ElevationNW + DeltaX * ( ElevationNE - ElevationNW );
-   LowerY = ElevationSW + DeltaX * ( ElevationSE - ElevationSW );
-   
-   offset = UpperY + DeltaY * ( LowerY - UpperY );
-   
-   return offset;
+   const double upperY = elevationNW + dx * ( elevationNE - elevationNW );
+   const double lowerY = elevationSW + dx * ( elevationSE - elevationSW );
+
+   return upperY + dy * ( lowerY - upperY );
 }
 
 double ossimGeoidEgm96::geoidToEllipsoidHeight(double lat,
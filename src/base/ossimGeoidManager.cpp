@@ -21,11 +21,13 @@
 #include <ossim/base/ossimGeoidNgs.h>
 #include <ossim/base/ossimGeoidEgm96.h>
 #include <ossim/base/ossimGeoidImage.h>
+#include <ossim/base/ossimGpt.h>
 #include <ossim/base/ossimFilename.h>
 #include <ossim/base/ossimFilename.h>
 #include <ossim/base/ossimKeywordlist.h>
 #include <ossim/base/ossimKeyword.h>
 #include <ossim/base/ossimNotifyContext.h>
+#include <algorithm>
 //***
 // Define Trace flags for use within this file:
 //***
@@ -325,6 +327,62 @@ double ossimGeoidManager::offsetFromEllipsoid(const ossimGpt& gpt)
    return offset;
 }
 
+void ossimGeoidManager::offsetsFromEllipsoid(const ossimGpt* gpts,
+                                             double* offsets,
+                                             ossim_uint32 count)
+{
+   std::fill(offsets, offsets + count, ossim::nan());
+
+   // Points not yet covered, compacted for the next geoid in the list:
+   std::vector<ossim_uint32> missing;
+   std::vector<ossimGpt>     missingPts;
+   std::vector<double>       missingOffsets;
+   std::vector<ossimRefPtr<ossimGeoid> >::iterator geoid = theGeoidList.begin();
+   while (geoid != theGeoidList.end())
+   {
+      if (missing.empty())
+      {
+         // First geoid sees every point in place:
+         (*geoid)->offsetsFromEllipsoid(gpts, offsets, count);
+         for (ossim_uint32 i = 0; i < count; ++i)
+         {
+            if (ossim::isnan(offsets[i]))
+            {
+               missing.push_back(i);
+               missingPts.push_back(gpts[i]);
+            }
+         }
+      }
+      else
+      {
+         const ossim_uint32 MISSING = (ossim_uint32)missing.size();
+         missingOffsets.resize(MISSING);
+         (*geoid)->offsetsFromEllipsoid(&missingPts.front(), &missingOffsets.front(), MISSING);
+
+         ossim_uint32 stillMissing = 0;
+         for (ossim_uint32 i = 0; i < MISSING; ++i)
+         {
+            if (ossim::isnan(missingOffsets[i]))
+            {
+               missing[stillMissing] = missing[i];
+               missingPts[stillMissing] = missingPts[i];
+               ++stillMissing;
+            }
+            else
+            {
+               offsets[missing[i]] = missingOffsets[i];
+            }
+         }
+         missing.resize(stillMissing);
+         missingPts.resize(stillMissing);
+      }
+
+      if (missing.empty())
+         break;
+      ++geoid;
+   }
+}
+
 ossimRefPtr<ossimGeoid> ossimGeoidManager::getGeoidForPoint( const ossimGpt& gpt )
 {
    ossimRefPtr<ossimGeoid> geoid = 0;
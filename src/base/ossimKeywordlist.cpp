@@ -25,6 +25,7 @@
 #include <fstream>
 #include <list>
 #include <memory>
+#include <set>
 #include <sstream>
 #include <utility>
 
@@ -39,6 +40,126 @@ static const char OSSIM_ID[] = "$Id: ossimKeywordlist.cpp 23632 2015-11-19 20:43
 
 const std::string ossimKeywordlist::NULL_KW = "";
 
+//---
+// Returns the text every key matched by regularExpression starts with, e.g. "image" for
+// "^(image[0-9]+\\.)".  Empty if the expression is not anchored, has alternatives or starts
+// with anything but plain characters.  The map is sorted, so the keys to try are then the
+// range found by getPrefixRange() rather than the whole map.
+//---
+static std::string getLiteralPrefix(const std::string& regularExpression)
+{
+   std::string prefix;
+   if ( regularExpression.empty() || (regularExpression[0] != '^') ||
+        (regularExpression.find('|') != std::string::npos) )
+   {
+      return prefix;
+   }
+
+   const std::size_t SIZE = regularExpression.size();
+   std::size_t i = 1;
+   while ( i < SIZE )
+   {
+      char c = regularExpression[i];
+      if ( c == '(' )
+      {
+         // Find the matching ')', a group followed by '*' or '?' may match nothing.
+         int depth = 0;
+         std::size_t j = i;
+         for ( ; j < SIZE; ++j )
+         {
+            char g = regularExpression[j];
+            if ( g == '\\' )
+            {
+               ++j;
+            }
+            else if ( g == '[' )
+            {
+               // A ']' first in the class, after any '^', is literal.
+               std::size_t k = j + 1;
+               if ( ( k < SIZE ) && ( regularExpression[k] == '^' ) )
+               {
+                  ++k;
+               }
+               if ( ( k < SIZE ) && ( regularExpression[k] == ']' ) )
+               {
+                  ++k;
+               }
+               j = regularExpression.find( ']', k );
+               if ( j == std::string::npos )
+               {
+                  return prefix;
+               }
+            }
+            else if ( g == '(' )
+            {
+               ++depth;
+            }
+            else if ( ( g == ')' ) && ( --depth == 0 ) )
+            {
+               break;
+            }
+         }
+         if ( ( j + 1 < SIZE ) &&
+              ( ( regularExpression[j+1] == '*' ) || ( regularExpression[j+1] == '?' ) ) )
+         {
+            break;
+         }
+         ++i;
+         continue;
+      }
+      if ( c == ')' )
+      {
+         ++i;
+         continue;
+      }
+
+      char literal = c;
+      std::size_t width = 1;
+      if ( c == '\\' )
+      {
+         if ( i + 1 == SIZE )
+         {
+            break;
+         }
+         literal = regularExpression[i+1];
+         width = 2;
+      }
+      else if ( std::string("^$.[]*+?").find(c) != std::string::npos )
+      {
+         break;
+      }
+
+      char next = ( i + width < SIZE ) ? regularExpression[i+width] : '\0';
+      if ( ( next == '*' ) || ( next == '?' ) )
+      {
+         break;
+      }
+      prefix += literal;
+      if ( next == '+' )
+      {
+         break;
+      }
+      i += width;
+   }
+   return prefix;
+}
+
+//---
+// Sets [first, last) to the keys of map starting with prefix.
+//---
+static void getPrefixRange(const ossimKeywordlist::KeywordMap& map,
+                           const std::string& prefix,
+                           ossimKeywordlist::KeywordMap::const_iterator& first,
+                           ossimKeywordlist::KeywordMap::const_iterator& last)
+{
+   first = prefix.size() ? map.lower_bound( prefix ) : map.begin();
+   last  = first;
+   while ( ( last != map.end() ) && ( last->first.compare( 0, prefix.size(), prefix ) == 0 ) )
+   {
+      ++last;
+   }
+}
+
 ossimKeywordlist::ossimKeywordlist(const ossimKeywordlist& src)
 :m_map(src.m_map),
 m_delimiter(src.m_delimiter),
@@ -147,17 +268,20 @@ void ossimKeywordlist::add(const ossimKeywordlist& kwl,
                            const char* prefix,
                            bool stripPrefix)
 {
-   std::map<std::string, std::string>::const_iterator iter = kwl.m_map.begin();
-   
    ossimRegExp regExp;
    
    // Check for null prefix.
    std::string tmpPrefix;
    if (prefix) tmpPrefix = prefix;
    
-   regExp.compile(("^("+tmpPrefix+")").c_str());
+   std::string regularExpression = "^("+tmpPrefix+")";
+   regExp.compile(regularExpression.c_str());
+
+   KeywordMap::const_iterator iter;
+   KeywordMap::const_iterator last;
+   getPrefixRange(kwl.m_map, getLiteralPrefix(regularExpression), iter, last);
    
-   while(iter != kwl.m_map.end())
+   while(iter != last)
    {
       ossimString newKey;
       
@@ -756,20 +880,243 @@ bool ossimKeywordlist::parseString(const std::string& inString)
    return parseStream(in);
 }
 
-bool ossimKeywordlist::isValidKeywordlistCharacter(ossim_uint8 c)const
+//---
+// Block parser.  parseStream reads the stream in blocks and nextStatement() tokenizes each
+// block in place, so keys and values are copied once, into the map.  Rules are those of the
+// former character at a time reader:
+//
+// - Lines starting with "//" are comments, lines starting with '#' preprocessor directives.
+// - key<delimiter>value, key trimmed, value with leading blanks skipped, to end of line.
+// - A value starting with """ runs to the closing """, across lines, quotes stripped.
+// - Any character other than printable ascii, tab and line breaks fails the parse.
+// - A line without delimiter fails the parse unless it is the last one, an empty key ends it.
+//---
+enum KwlStatementType
+{
+   KWL_STATEMENT_NONE,      // Comment, nothing to add.
+   KWL_STATEMENT_PAIR,      // Key and value.
+   KWL_STATEMENT_DIRECTIVE, // Line starting with '#', in value.
+   KWL_STATEMENT_END,       // Stop, keyword list is valid.
+   KWL_STATEMENT_BAD,       // Stop, malformed.
+   KWL_STATEMENT_MORE       // Runs past the end of the buffer; call again with more.
+};
+
+struct KwlStatement
 {
-   if((c>=0x20&&c<=0x7e))
+   const char* keyBegin;
+   const char* keyEnd;
+   const char* valueBegin;
+   const char* valueEnd;
+};
+
+static inline bool isKeywordlistCharacter(ossim_uint8 c)
+{
+   return ( (c >= 0x20) && (c <= 0x7e) ) || (c == '\n') || (c == '\r') || (c == '\t');
+}
+
+static inline bool isLineBreak(char c)
+{
+   return (c == '\n') || (c == '\r');
+}
+
+static KwlStatementType scanValue(const char*& pos, const char* end, bool atEof,
+                                  KwlStatement& statement)
+{
+   const char* p = pos;
+   while ( (p < end) && ( (*p == ' ') || (*p == '\t') ) )
    {
-      return true;
+      ++p;
    }
-   switch(c)
+   if ( (p == end) && !atEof )
    {
-      case '\n':
-      case '\r':
-      case '\t':
-         return true;
+      return KWL_STATEMENT_MORE;
    }
-   return false;
+   if ( (p == end) || isLineBreak(*p) )
+   {
+      // Blank value.
+      statement.valueBegin = statement.valueEnd = p;
+      pos = (p == end) ? p : p + 1;
+      return KWL_STATEMENT_PAIR;
+   }
+
+   const char* start = p;
+   bool quoted = false;
+   while ( p < end )
+   {
+      char c = *p;
+      if ( !isKeywordlistCharacter( (ossim_uint8)c ) )
+      {
+         return KWL_STATEMENT_BAD;
+      }
+      ++p;
+      if ( isLineBreak(c) && !quoted )
+      {
+         statement.valueBegin = start;
+         statement.valueEnd   = p - 1;
+         pos = p;
+         return KWL_STATEMENT_PAIR;
+      }
+      if ( (p - start) > 2 )
+      {
+         if ( !quoted )
+         {
+            // Leading triple quotes, keep line breaks until the closing ones.
+            quoted = ( (start[0] == '"') && (start[1] == '"') && (start[2] == '"') );
+         }
+         else if ( (p[-1] == '"') && (p[-2] == '"') && (p[-3] == '"') )
+         {
+            //---
+            // Closing triple quotes.  Some tiff writers, e.g. Space Imaging, use four quotes
+            // so all are stripped from each end.
+            //---
+            const char* b = start;
+            const char* e = p;
+            while ( (b < e) && (*b == '"') )
+            {
+               ++b;
+            }
+            while ( (e > b) && (e[-1] == '"') )
+            {
+               --e;
+            }
+            statement.valueBegin = (b < e) ? b : start;
+            statement.valueEnd   = (b < e) ? e : p;
+            pos = p;
+            return KWL_STATEMENT_PAIR;
+         }
+      }
+   }
+   if ( !atEof )
+   {
+      return KWL_STATEMENT_MORE;
+   }
+   statement.valueBegin = start;
+   statement.valueEnd   = p;
+   pos = p;
+   return KWL_STATEMENT_PAIR;
+}
+
+static KwlStatementType nextStatement(const char*& pos, const char* end, bool atEof,
+                                      char delimiter, KwlStatement& statement)
+{
+   const char* p = pos;
+   while ( (p < end) && ( (*p == ' ') || (*p == '\t') || isLineBreak(*p) ) )
+   {
+      ++p;
+   }
+   pos = p;
+   if ( p == end )
+   {
+      return atEof ? KWL_STATEMENT_END : KWL_STATEMENT_MORE;
+   }
+
+   if ( *p == '#' )
+   {
+      KwlStatementType type = scanValue( p, end, atEof, statement );
+      if ( type == KWL_STATEMENT_PAIR )
+      {
+         pos = p;
+         type = KWL_STATEMENT_DIRECTIVE;
+      }
+      return type;
+   }
+
+   if ( *p == '/' )
+   {
+      if ( (p + 1 == end) && !atEof )
+      {
+         return KWL_STATEMENT_MORE;
+      }
+      if ( (p + 1 < end) && (p[1] == '/') )
+      {
+         p += 2;
+         while ( p < end )
+         {
+            char c = *p++;
+            if ( !isKeywordlistCharacter( (ossim_uint8)c ) )
+            {
+               return KWL_STATEMENT_BAD;
+            }
+            if ( isLineBreak(c) )
+            {
+               pos = p;
+               return KWL_STATEMENT_NONE;
+            }
+         }
+         if ( !atEof )
+         {
+            return KWL_STATEMENT_MORE;
+         }
+         pos = p;
+         return KWL_STATEMENT_NONE;
+      }
+      // Single slash starts a key.
+   }
+
+   const char* keyEnd = p;
+   while ( true )
+   {
+      if ( keyEnd == end )
+      {
+         // No delimiter.
+         return atEof ? KWL_STATEMENT_BAD : KWL_STATEMENT_MORE;
+      }
+      char c = *keyEnd;
+      if ( !isKeywordlistCharacter( (ossim_uint8)c ) )
+      {
+         return KWL_STATEMENT_BAD;
+      }
+      if ( isLineBreak(c) )
+      {
+         // Line with no delimiter, allowed as the last line only.
+         if ( keyEnd + 1 < end )
+         {
+            return KWL_STATEMENT_BAD;
+         }
+         if ( !atEof )
+         {
+            return KWL_STATEMENT_MORE;
+         }
+         pos = end;
+         return KWL_STATEMENT_END;
+      }
+      if ( c == delimiter )
+      {
+         break;
+      }
+      ++keyEnd;
+   }
+
+   statement.keyBegin = p;
+   statement.keyEnd   = keyEnd;
+   while ( (statement.keyBegin < statement.keyEnd) &&
+           ( (*statement.keyBegin == ' ') || (*statement.keyBegin == '\t') ) )
+   {
+      ++statement.keyBegin;
+   }
+   while ( (statement.keyEnd > statement.keyBegin) &&
+           ( (statement.keyEnd[-1] == ' ') || (statement.keyEnd[-1] == '\t') ) )
+   {
+      --statement.keyEnd;
+   }
+
+   p = keyEnd + 1;
+   KwlStatementType type = scanValue( p, end, atEof, statement );
+   if ( type == KWL_STATEMENT_PAIR )
+   {
+      pos = p;
+      if ( statement.keyBegin == statement.keyEnd )
+      {
+         // Empty key ends the list.
+         type = KWL_STATEMENT_END;
+      }
+   }
+   return type;
+}
+
+bool ossimKeywordlist::isValidKeywordlistCharacter(ossim_uint8 c)const
+{
+   return isKeywordlistCharacter(c);
 }
 
 void ossimKeywordlist::skipWhitespace(ossim::istream& in)const
@@ -820,44 +1167,15 @@ ossimKeywordlist::KeywordlistParseState
 ossimKeywordlist::readPreprocDirective(ossim::istream& in)
 {
    KeywordlistParseState status = KeywordlistParseState_FAIL;
-
-   char c = (char)in.peek();
-   while (c == '#')
+   if ((char)in.peek() == '#')
    {
       // Read the line as one big value:
       ossimString sequence;
       status = readValue(sequence, in);
-      if (status)
-         break;
-
-      ossimString directive = sequence.before(" ");
-
-      // Check for external KWL include file:
-      if (directive == "#include")
+      if (status == KeywordlistParseState_OK)
       {
-         ossimFilename includeFile = sequence.after(" ");
-         if (includeFile.empty())
-            break; // ignore bogus preproc line
-         includeFile.trim("\"");
-         includeFile.expandEnvironmentVariable();
-
-         // The filename can be either relative to the current file being parsed or absolute:
-         if (includeFile.string()[0] != '/')
-            includeFile = m_currentlyParsing.path() + "/" + includeFile;
-
-         // Save the current path in case the new one contains it's own include directive!
-         ossimFilename savedCurrentPath = m_currentlyParsing;
-         addFile(includeFile); // Quietly ignore any errors loading external KWL.
-         m_currentlyParsing = savedCurrentPath;
+         parsePreprocDirective(sequence);
       }
-
-//      else if (directive == "#add_new_directive_here")
-//      {
-//         process directive
-//      }
-
-      status = KeywordlistParseState_OK;
-      break;
    }
    return status;
 }
@@ -1019,70 +1337,100 @@ ossimKeywordlist::KeywordlistParseState ossimKeywordlist::readKeyAndValuePair(os
                                                                  static_cast<int>(valueState)) );
 }
 
+void ossimKeywordlist::parsePreprocDirective(const ossimString& line)
+{
+   ossimString directive = line.before(" ");
+
+   // Check for external KWL include file:
+   if (directive == "#include")
+   {
+      ossimFilename includeFile = line.after(" ");
+      if (includeFile.empty())
+         return; // ignore bogus preproc line
+      includeFile.trim("\"");
+      includeFile.expandEnvironmentVariable();
+
+      // The filename can be either relative to the current file being parsed or absolute:
+      if (includeFile.string()[0] != '/')
+         includeFile = m_currentlyParsing.path() + "/" + includeFile;
+
+      // Save the current path in case the new one contains it's own include directive!
+      ossimFilename savedCurrentPath = m_currentlyParsing;
+      addFile(includeFile); // Quietly ignore any errors loading external KWL.
+      m_currentlyParsing = savedCurrentPath;
+   }
+
+//   else if (directive == "#add_new_directive_here")
+//   {
+//      process directive
+//   }
+}
+
 bool ossimKeywordlist::parseStream(ossim::istream& is)
 {
    if (!is) // Check stream state.
    {
       return false;
    }
-   ossimString key;
-   ossimString value;
-   ossimString sequence;
-   KeywordlistParseState state = KeywordlistParseState_OK;
-   while(!is.eof() && !is.bad())
-   {
-      skipWhitespace(is);
-      if(is.eof() || is.bad())
-         return true; // we skipped to end so valid keyword list
 
-      state = readPreprocDirective(is);
-      if(state & KeywordlistParseState_BAD_STREAM)
-         return false;
-
-      // if we failed a preprocessor directive parse then try comment parse.
-      if(state == KeywordlistParseState_FAIL)
+   //---
+   // Statements are tokenized in place in the buffer.  One running past the end of a block is
+   // kept and tokenized again once the next block is appended.
+   //---
+   const std::size_t BLOCK_SIZE = 65536;
+   std::vector<char> buffer;
+   std::size_t start = 0;
+   bool atEof = false;
+   KwlStatement statement;
+   while ( true )
+   {
+      if ( !atEof )
       {
-         state = readComments(sequence, is);
-         if(state & KeywordlistParseState_BAD_STREAM)
-            return false;
+         buffer.erase( buffer.begin(), buffer.begin() + start );
+         start = 0;
+         std::size_t size = buffer.size();
+         buffer.resize( size + BLOCK_SIZE );
+         is.read( &buffer[size], BLOCK_SIZE );
+         buffer.resize( size + (std::size_t)is.gcount() );
+         atEof = !is.good();
       }
 
-      // if we failed a comment parse then try key value parse.
-      if(state == KeywordlistParseState_FAIL)
+      const char* pos = buffer.data() + start;
+      const char* end = buffer.data() + buffer.size();
+      KwlStatementType type = nextStatement( pos, end, atEof, m_delimiter, statement );
+      while ( type != KWL_STATEMENT_MORE )
       {
-         key = sequence; // just in case there is a 1 token look ahead residual for a single slash test.
-         ossimKeywordlist::KeywordlistParseState testKeyValueState = readKeyAndValuePair(key, value, is);
-         if(testKeyValueState == KeywordlistParseState_OK)
+         if ( type == KWL_STATEMENT_PAIR )
          {
-            key = key.trim();
-            if(key.empty())
-               return true;
-
             if ( m_expandEnvVars == true )
-               value = value.expandEnvironmentVariable();
-            m_map.insert(std::make_pair(key.string(), value.string()));
+            {
+               ossimString value(statement.valueBegin, statement.valueEnd);
+               m_map.insert( std::make_pair( std::string(statement.keyBegin, statement.keyEnd),
+                                             value.expandEnvironmentVariable().string() ) );
+            }
+            else
+            {
+               m_map.insert( std::make_pair(
+                                std::string(statement.keyBegin, statement.keyEnd),
+                                std::string(statement.valueBegin, statement.valueEnd) ) );
+            }
          }
-         else if(testKeyValueState & KeywordlistParseState_BAD_STREAM)
+         else if ( type == KWL_STATEMENT_DIRECTIVE )
          {
-            return false;
+            parsePreprocDirective( ossimString(statement.valueBegin, statement.valueEnd) );
          }
-#if 0
-         // Commented out to allow an invalid line in keyword list without
-         // erroring out, effectively skipping bad line. drb - 01 Sep. 2001
-         else
+         else if ( type == KWL_STATEMENT_END )
+         {
+            return true;
+         }
+         else if ( type == KWL_STATEMENT_BAD )
          {
             return false;
          }
-#endif
-      }
-      else if(state & KeywordlistParseState_BAD_STREAM)
-      {
-         return false;
+         type = nextStatement( pos, end, atEof, m_delimiter, statement );
       }
-      sequence = key = value = "";
-   }   
-   
-   return true;
+      start = pos - buffer.data();
+   }
 }
 
 void ossimKeywordlist::getSortedList(std::vector<ossimString>& prefixValues,
@@ -1129,9 +1477,11 @@ void ossimKeywordlist::findAllKeysThatMatch( std::vector<ossimString>& result,
                                              const ossimString &regularExpression ) const
 {
    KeywordMap::const_iterator i;
+   KeywordMap::const_iterator last;
    ossimRegExp regExp;
    regExp.compile(regularExpression.c_str());
-   for(i = m_map.begin(); i != m_map.end(); ++i)
+   getPrefixRange(m_map, getLiteralPrefix(regularExpression.string()), i, last);
+   for(; i != last; ++i)
    {
       if(regExp.find( (*i).first.c_str()))
       {
@@ -1145,9 +1495,11 @@ ossim_uint32  ossimKeywordlist::getNumberOfKeysThatMatch(
 {
    ossim_uint32 result = 0;
    KeywordMap::const_iterator i;
+   KeywordMap::const_iterator last;
    ossimRegExp regExp;
    regExp.compile(regularExpression.c_str());
-   for(i = m_map.begin(); i != m_map.end(); ++i)
+   getPrefixRange(m_map, getLiteralPrefix(regularExpression.string()), i, last);
+   for(; i != last; ++i)
    {
       if(regExp.find( (*i).first.c_str()))
       {
@@ -1161,12 +1513,13 @@ void ossimKeywordlist::extractKeysThatMatch(ossimKeywordlist& kwl,
                                             const ossimString &regularExpression)const
 {
    KeywordMap::const_iterator i;
-   std::vector<ossimString> result;
+   KeywordMap::const_iterator last;
    ossimRegExp regExp;
    
    regExp.compile(regularExpression.c_str());
+   getPrefixRange(m_map, getLiteralPrefix(regularExpression.string()), i, last);
    
-   for(i = m_map.begin(); i != m_map.end(); ++i)
+   for(; i != last; ++i)
    {
       if(regExp.find( (*i).first.c_str()))
       {
@@ -1178,12 +1531,14 @@ void ossimKeywordlist::extractKeysThatMatch(ossimKeywordlist& kwl,
 void ossimKeywordlist::removeKeysThatMatch(const ossimString &regularExpression)
 {
    KeywordMap::const_iterator i;
+   KeywordMap::const_iterator last;
    std::vector<ossimString> result;
    ossimRegExp regExp;
    
    regExp.compile(regularExpression.c_str());
+   getPrefixRange(m_map, getLiteralPrefix(regularExpression.string()), i, last);
    
-   for(i = m_map.begin(); i != m_map.end(); ++i)
+   for(; i != last; ++i)
    {
       if(regExp.find( (*i).first.c_str()))
       {
@@ -1207,18 +1562,27 @@ void ossimKeywordlist::getSubstringKeyList(std::vector<ossimString>& result,
                                            const ossimString& regularExpression)const
 {
    KeywordMap::const_iterator i;
+   KeywordMap::const_iterator last;
    ossimRegExp regExp;
    
    regExp.compile(regularExpression.c_str());
+   getPrefixRange(m_map, getLiteralPrefix(regularExpression.string()), i, last);
+
+   // Substrings already in result, e.g. "image0." is found once per image0 key.
+   std::set<std::string> found;
+   for(std::size_t idx = 0; idx < result.size(); ++idx)
+   {
+      found.insert(result[idx].string());
+   }
    
-   for(i = m_map.begin(); i != m_map.end(); ++i)
+   for(; i != last; ++i)
    {
       if(regExp.find( (*i).first.c_str()))
       {
-         ossimString value = ossimString((*i).first.begin()+regExp.start(),
-                                         (*i).first.begin()+regExp.start()+regExp.end());
+         std::string value((*i).first.begin()+regExp.start(),
+                           (*i).first.begin()+regExp.start()+regExp.end());
          
-         if(std::find(result.begin(), result.end(), value) == result.end())
+         if(found.insert(value).second)
          {
             result.push_back(value);
          }
@@ -0,0 +1,171 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/base/ossimMemoryMappedFile.h>
+#include <ossim/base/ossimNotify.h>
+#include <ossim/base/ossimTrace.h>
+#include <map>
+#include <mutex>
+#include <string>
+
+#if defined(_WIN32)
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+static ossimTrace traceDebug("ossimMemoryMappedFile:debug");
+
+namespace
+{
+   // Mappings in use, keyed by file name.
+   std::mutex& registryMutex()
+   {
+      static std::mutex mutex;
+      return mutex;
+   }
+
+   std::map< std::string, std::weak_ptr<ossimMemoryMappedFile> >& registry()
+   {
+      static std::map< std::string, std::weak_ptr<ossimMemoryMappedFile> > files;
+      return files;
+   }
+}
+
+std::shared_ptr<ossimMemoryMappedFile> ossimMemoryMappedFile::open(const ossimFilename& file)
+{
+   std::shared_ptr<ossimMemoryMappedFile> result;
+   if ( file.empty() )
+   {
+      return result;
+   }
+
+   std::lock_guard<std::mutex> lock( registryMutex() );
+   std::map< std::string, std::weak_ptr<ossimMemoryMappedFile> >& files = registry();
+
+   std::map< std::string, std::weak_ptr<ossimMemoryMappedFile> >::iterator i =
+      files.find( file.string() );
+   if ( i != files.end() )
+   {
+      result = i->second.lock();
+      if ( result )
+      {
+         return result;
+      }
+      files.erase( i );
+   }
+
+   result.reset( new ossimMemoryMappedFile( file ) );
+   if ( result->map() )
+   {
+      files[ file.string() ] = result;
+   }
+   else
+   {
+      result.reset();
+   }
+   return result;
+}
+
+ossimMemoryMappedFile::ossimMemoryMappedFile(const ossimFilename& file)
+   :
+   m_filename(file),
+   m_data(0),
+   m_size(0)
+#if defined(_WIN32)
+   ,
+   m_fileHandle(0),
+   m_mappingHandle(0)
+#endif
+{
+}
+
+ossimMemoryMappedFile::~ossimMemoryMappedFile()
+{
+#if defined(_WIN32)
+   if ( m_data )
+   {
+      UnmapViewOfFile( m_data );
+   }
+   if ( m_mappingHandle )
+   {
+      CloseHandle( (HANDLE)m_mappingHandle );
+   }
+   if ( m_fileHandle )
+   {
+      CloseHandle( (HANDLE)m_fileHandle );
+   }
+#else
+   if ( m_data )
+   {
+      munmap( (void*)m_data, (size_t)m_size );
+   }
+#endif
+}
+
+bool ossimMemoryMappedFile::map()
+{
+#if defined(_WIN32)
+   HANDLE fh = CreateFileA( m_filename.c_str(), GENERIC_READ, FILE_SHARE_READ, 0,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0 );
+   if ( fh == INVALID_HANDLE_VALUE )
+   {
+      return false;
+   }
+   m_fileHandle = fh;
+
+   LARGE_INTEGER size;
+   if ( !GetFileSizeEx( fh, &size ) || (size.QuadPart == 0) )
+   {
+      return false;
+   }
+   m_size = (ossim_uint64)size.QuadPart;
+
+   m_mappingHandle = CreateFileMappingA( fh, 0, PAGE_READONLY, 0, 0, 0 );
+   if ( !m_mappingHandle )
+   {
+      return false;
+   }
+   m_data = (const ossim_uint8*)MapViewOfFile( (HANDLE)m_mappingHandle, FILE_MAP_READ, 0, 0, 0 );
+#else
+   int fd = ::open( m_filename.c_str(), O_RDONLY );
+   if ( fd < 0 )
+   {
+      return false;
+   }
+
+   struct stat st;
+   if ( (fstat( fd, &st ) == 0) && S_ISREG( st.st_mode ) && (st.st_size > 0) )
+   {
+      void* data = mmap( 0, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+      if ( data != MAP_FAILED )
+      {
+         m_data = (const ossim_uint8*)data;
+         m_size = (ossim_uint64)st.st_size;
+      }
+   }
+
+   // The mapping stays valid after the descriptor is closed.
+   close( fd );
+#endif
+
+   if ( !m_data )
+   {
+      m_size = 0;
+      if ( traceDebug() )
+      {
+         ossimNotify(ossimNotifyLevel_DEBUG)
+            << "ossimMemoryMappedFile::map DEBUG: Could not map " << m_filename << std::endl;
+      }
+   }
+
+   return ( m_data != 0 );
+}
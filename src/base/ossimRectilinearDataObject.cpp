@@ -14,6 +14,7 @@
 #include <ossim/base/ossimException.h>
 #include <ossim/base/ossimScalarTypeLut.h>
 #include <ossim/base/ossimKeywordlist.h>
+#include <ossim/base/ossimTileBufferPool.h>
 #include <sstream>
 
 RTTI_DEF1(ossimRectilinearDataObject, "ossimRectilinearDataObject", ossimDataObject);
@@ -34,9 +35,10 @@ ossimRectilinearDataObject::ossimRectilinearDataObject(
    : ossimDataObject(rhs),
      m_numberOfDataComponents(rhs.m_numberOfDataComponents),
      m_scalarType(rhs.m_scalarType),
-     m_dataBuffer(rhs.m_dataBuffer),
+     m_dataBuffer(),
      m_spatialExtents(rhs.m_spatialExtents)
 {
+   copyDataBuffer(rhs.m_dataBuffer);
 }
 
 ossimRectilinearDataObject::ossimRectilinearDataObject(
@@ -106,6 +108,7 @@ ossimRectilinearDataObject::ossimRectilinearDataObject(
 
 ossimRectilinearDataObject::~ossimRectilinearDataObject()
 {
+   ossimTileBufferPool::instance()->release(m_dataBuffer);
 }
 
 ossim_uint64 ossimRectilinearDataObject::computeSpatialProduct() const
@@ -194,8 +197,8 @@ void ossimRectilinearDataObject::assign(const ossimRectilinearDataObject* data)
          
          m_numberOfDataComponents    = data->m_numberOfDataComponents;
          m_scalarType                = data->m_scalarType;
-         m_dataBuffer                = data->m_dataBuffer;
          m_spatialExtents            = data->m_spatialExtents;
+         copyDataBuffer(data->m_dataBuffer);
       }
    }
 }
@@ -222,6 +225,16 @@ void ossimRectilinearDataObject::initialize()
    }
 }
 
+void ossimRectilinearDataObject::copyDataBuffer(const std::vector<ossim_uint8>& rhs)
+{
+   // Only go to the pool if the copy would otherwise reallocate:
+   if (m_dataBuffer.capacity() < rhs.size())
+   {
+      ossimTileBufferPool::instance()->acquire(m_dataBuffer, rhs.size());
+   }
+   m_dataBuffer.assign(rhs.begin(), rhs.end());
+}
+
 ossim_uint64 ossimRectilinearDataObject::getDataSizeInBytes() const
 {
    return (ossim_uint64)(getScalarSizeInBytes() *
@@ -252,8 +265,8 @@ const ossimRectilinearDataObject& ossimRectilinearDataObject::operator=(
       // ossimRectilinearDataObject (this) initialization:
       m_numberOfDataComponents    = rhs.m_numberOfDataComponents;
       m_scalarType                = rhs.m_scalarType;
-      m_dataBuffer                = rhs.m_dataBuffer;
       m_spatialExtents            = rhs.m_spatialExtents;
+      copyDataBuffer(rhs.m_dataBuffer);
    }
    return *this;
 }
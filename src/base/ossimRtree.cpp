@@ -0,0 +1,196 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/base/ossimRtree.h>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+   template <class T> bool lessCenterX(const T& a, const T& b)
+   {
+      return (a.box.minX + a.box.maxX) < (b.box.minX + b.box.maxX);
+   }
+
+   template <class T> bool lessCenterY(const T& a, const T& b)
+   {
+      return (a.box.minY + a.box.maxY) < (b.box.minY + b.box.maxY);
+   }
+
+   /**
+    * Sort-Tile-Recursive ordering: sorts v by x into vertical slices of about sqrt(nodes)
+    * nodes each, then each slice by y, so runs of capacity consecutive entries are compact.
+    */
+   template <class T> void strSort(std::vector<T>& v, ossim_uint32 capacity)
+   {
+      const std::size_t nodes  = (v.size() + capacity - 1) / capacity;
+      const std::size_t slices = (std::size_t)std::ceil( std::sqrt( (double)nodes ) );
+      const std::size_t sliceSize = slices * capacity;
+
+      std::sort( v.begin(), v.end(), lessCenterX<T> );
+      for ( std::size_t i = 0; i < v.size(); i += sliceSize )
+      {
+         std::sort( v.begin() + i, v.begin() + std::min(i + sliceSize, v.size()),
+                    lessCenterY<T> );
+      }
+   }
+}
+
+void ossimRtree::Box::expand(const Box& b)
+{
+   minX = std::min(minX, b.minX);
+   minY = std::min(minY, b.minY);
+   maxX = std::max(maxX, b.maxX);
+   maxY = std::max(maxY, b.maxY);
+}
+
+ossimRtree::ossimRtree(ossim_uint32 nodeCapacity)
+   :
+   m_nodeCapacity( std::max<ossim_uint32>(nodeCapacity, 2) ),
+   m_items(),
+   m_nodes(),
+   m_built(true)
+{
+}
+
+void ossimRtree::clear()
+{
+   m_items.clear();
+   m_nodes.clear();
+   m_built = true;
+}
+
+void ossimRtree::add(ossim_uint64 id, double minX, double minY, double maxX, double maxY)
+{
+   Item item;
+   item.box.minX = std::min(minX, maxX);
+   item.box.minY = std::min(minY, maxY);
+   item.box.maxX = std::max(minX, maxX);
+   item.box.maxY = std::max(minY, maxY);
+   item.id = id;
+   m_items.push_back(item);
+   m_built = false;
+}
+
+void ossimRtree::build()
+{
+   m_nodes.clear();
+   m_built = true;
+   if ( m_items.empty() )
+   {
+      return;
+   }
+
+   // Leaves over runs of the sorted items.
+   strSort( m_items, m_nodeCapacity );
+   std::vector<Node> level;
+   for ( std::size_t i = 0; i < m_items.size(); i += m_nodeCapacity )
+   {
+      Node node;
+      node.first = (ossim_uint32)i;
+      node.count = (ossim_uint32)std::min<std::size_t>(m_nodeCapacity, m_items.size() - i);
+      node.leaf  = true;
+      node.box   = m_items[i].box;
+      for ( ossim_uint32 j = 1; j < node.count; ++j )
+      {
+         node.box.expand( m_items[i + j].box );
+      }
+      level.push_back(node);
+   }
+
+   // Pack each level the same way until one node is left.  The root is stored last.
+   while ( level.size() > 1 )
+   {
+      strSort( level, m_nodeCapacity );
+      const std::size_t base = m_nodes.size();
+      m_nodes.insert( m_nodes.end(), level.begin(), level.end() );
+
+      std::vector<Node> parents;
+      for ( std::size_t i = 0; i < level.size(); i += m_nodeCapacity )
+      {
+         Node node;
+         node.first = (ossim_uint32)(base + i);
+         node.count = (ossim_uint32)std::min<std::size_t>(m_nodeCapacity, level.size() - i);
+         node.leaf  = false;
+         node.box   = level[i].box;
+         for ( ossim_uint32 j = 1; j < node.count; ++j )
+         {
+            node.box.expand( level[i + j].box );
+         }
+         parents.push_back(node);
+      }
+      level.swap(parents);
+   }
+   m_nodes.push_back( level[0] );
+}
+
+bool ossimRtree::findPoint(double x, double y, std::vector<ossim_uint64>& ids) const
+{
+   Box query;
+   query.minX = query.maxX = x;
+   query.minY = query.maxY = y;
+   return search(query, ids);
+}
+
+bool ossimRtree::findIntersecting(double minX, double minY, double maxX, double maxY,
+                                  std::vector<ossim_uint64>& ids) const
+{
+   Box query;
+   query.minX = std::min(minX, maxX);
+   query.minY = std::min(minY, maxY);
+   query.maxX = std::max(minX, maxX);
+   query.maxY = std::max(minY, maxY);
+   return search(query, ids);
+}
+
+bool ossimRtree::search(const Box& query, std::vector<ossim_uint64>& ids) const
+{
+   const std::size_t startSize = ids.size();
+
+   if ( !m_built )
+   {
+      // Items added since the last build: fall back to a scan.
+      for ( std::size_t i = 0; i < m_items.size(); ++i )
+      {
+         if ( m_items[i].box.intersects(query) )
+         {
+            ids.push_back( m_items[i].id );
+         }
+      }
+   }
+   else if ( m_nodes.size() )
+   {
+      std::vector<ossim_uint32> stack;
+      stack.push_back( (ossim_uint32)m_nodes.size() - 1 );
+      while ( stack.size() )
+      {
+         const Node& node = m_nodes[ stack.back() ];
+         stack.pop_back();
+         if ( !node.box.intersects(query) )
+         {
+            continue;
+         }
+         for ( ossim_uint32 i = node.first; i < node.first + node.count; ++i )
+         {
+            if ( node.leaf )
+            {
+               if ( m_items[i].box.intersects(query) )
+               {
+                  ids.push_back( m_items[i].id );
+               }
+            }
+            else if ( m_nodes[i].box.intersects(query) )
+            {
+               stack.push_back(i);
+            }
+         }
+      }
+   }
+
+   return ( ids.size() > startSize );
+}
@@ -0,0 +1,65 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/base/ossimSidecarFile.h>
+#include <ossim/base/ossimString.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+#if defined(_WIN32)
+#  include <windows.h>
+#endif
+
+namespace
+{
+   const ossim_uint32 BYTE_ORDER_MARK = 0x01020304; // Catches files from the other endian.
+}
+
+ossimFilename ossim::getSidecarTempFile(const ossimFilename& file)
+{
+   return file + "." + ossimString::toString(
+      (ossim_uint64)( std::hash<std::thread::id>()( std::this_thread::get_id() ) ^
+                      (std::size_t)std::chrono::steady_clock::now().time_since_epoch().count() ) );
+}
+
+bool ossim::replaceFile(const ossimFilename& tmp, const ossimFilename& file)
+{
+#if defined(_WIN32)
+   // std::rename fails there when file exists.
+   bool result = ( MoveFileExA( tmp.c_str(), file.c_str(),
+                                MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH ) != 0 );
+#else
+   bool result = ( std::rename( tmp.c_str(), file.c_str() ) == 0 );
+#endif
+   if ( !result )
+   {
+      tmp.remove();
+   }
+   return result;
+}
+
+void ossim::writeSidecarHeader(std::ostream& out, const char magic[8], ossim_uint32 version)
+{
+   out.write( magic, 8 );
+   writeValue( out, version );
+   writeValue( out, BYTE_ORDER_MARK );
+}
+
+bool ossim::readSidecarHeader(std::istream& in, const char magic[8], ossim_uint32 version)
+{
+   char         fileMagic[8];
+   ossim_uint32 fileVersion   = 0;
+   ossim_uint32 fileByteOrder = 0;
+   in.read( fileMagic, 8 );
+   return in.good() && !memcmp( fileMagic, magic, 8 ) &&
+          readValue( in, fileVersion ) && ( fileVersion == version ) &&
+          readValue( in, fileByteOrder ) && ( fileByteOrder == BYTE_ORDER_MARK );
+}
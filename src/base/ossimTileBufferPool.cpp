@@ -0,0 +1,205 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/base/ossimTileBufferPool.h>
+#include <ossim/base/ossimPreferences.h>
+#include <ossim/base/ossimString.h>
+#include <ostream>
+
+const ossim_uint64 ossimTileBufferPool::MIN_BUFFER_SIZE = 4096;
+
+namespace
+{
+   // Pool size in megabytes used when pooling is turned on without a size.
+   const ossim_uint64 DEFAULT_POOL_SIZE_MB = 64;
+}
+
+ossimTileBufferPool::Statistics::Statistics()
+:  hits(0),
+   misses(0),
+   releases(0),
+   discards(0),
+   pooledBytes(0)
+{
+}
+
+std::ostream& ossimTileBufferPool::Statistics::print(std::ostream& out) const
+{
+   out << "hits:          " << hits
+       << "\nmisses:        " << misses
+       << "\nreleases:      " << releases
+       << "\ndiscards:      " << discards
+       << "\npooled_bytes:  " << pooledBytes
+       << "\n";
+   return out;
+}
+
+ossimTileBufferPool* ossimTileBufferPool::instance()
+{
+   // Never deleted; tiles released at process exit still go through it.
+   static ossimTileBufferPool* pool = new ossimTileBufferPool();
+   return pool;
+}
+
+ossimTileBufferPool::ossimTileBufferPool()
+:  m_enabled(false),
+   m_maxPoolSize(DEFAULT_POOL_SIZE_MB*1024*1024),
+   m_pooledBytes(0),
+   m_mutex(),
+   m_hits(0),
+   m_misses(0),
+   m_releases(0),
+   m_discards(0)
+{
+   readPreferences();
+}
+
+void ossimTileBufferPool::readPreferences()
+{
+   const char* lookup = ossimPreferences::instance()->findPreference("tile_buffer_pool_size");
+   if (lookup)
+   {
+      ossim_uint64 size = ossimString(lookup).toUInt64();
+      setMaxPoolSize(size*1024*1024);
+      m_enabled = (size != 0);
+   }
+}
+
+bool ossimTileBufferPool::acquire(Buffer& buffer, ossim_uint64 size)
+{
+   release(buffer);
+   if (!m_enabled.load() || (size < MIN_BUFFER_SIZE))
+      return false;
+
+   // A bin holds capacities [2^bin, 2^(bin+1)) so the size's own bin may have a fit, and
+   // anything in the next bin up always does:
+   bool result = false;
+   ossim_uint32 bin = getBin(size);
+   if (m_pooledBytes.load() != 0)
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      result = take(m_bins[bin], buffer, size);
+      if (!result && (bin + 1 < NUMBER_OF_BINS))
+         result = take(m_bins[bin + 1], buffer, size);
+      if (result)
+         m_pooledBytes -= buffer.capacity();
+   }
+
+   if (result)
+   {
+      ++m_hits;
+      buffer.resize(size);
+   }
+   else
+   {
+      ++m_misses;
+   }
+   return result;
+}
+
+void ossimTileBufferPool::release(Buffer& buffer)
+{
+   const ossim_uint64 capacity = buffer.capacity();
+   if (capacity == 0)
+      return;
+
+   if (!m_enabled.load() || (capacity < MIN_BUFFER_SIZE))
+   {
+      Buffer().swap(buffer);
+      return;
+   }
+
+   ++m_releases;
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (m_pooledBytes.load() + capacity <= m_maxPoolSize.load())
+      {
+         std::vector<Buffer>& bin = m_bins[getBin(capacity)];
+         bin.push_back(Buffer());
+         bin.back().swap(buffer);
+         m_pooledBytes += capacity;
+         return;
+      }
+   }
+   ++m_discards;
+   Buffer().swap(buffer);
+}
+
+void ossimTileBufferPool::flush()
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   for (ossim_uint32 bin = 0; bin < NUMBER_OF_BINS; ++bin)
+      m_bins[bin].clear();
+   m_pooledBytes = 0;
+}
+
+void ossimTileBufferPool::setEnabled(bool flag)
+{
+   m_enabled = flag;
+   if (!flag)
+      flush();
+}
+
+bool ossimTileBufferPool::getEnabled() const
+{
+   return m_enabled.load();
+}
+
+void ossimTileBufferPool::setMaxPoolSize(ossim_uint64 bytes)
+{
+   m_maxPoolSize = bytes;
+   if (m_pooledBytes.load() > bytes)
+      flush();
+}
+
+ossim_uint64 ossimTileBufferPool::getMaxPoolSize() const
+{
+   return m_maxPoolSize.load();
+}
+
+ossimTileBufferPool::Statistics ossimTileBufferPool::getStatistics() const
+{
+   Statistics stats;
+   stats.hits        = m_hits.load();
+   stats.misses      = m_misses.load();
+   stats.releases    = m_releases.load();
+   stats.discards    = m_discards.load();
+   stats.pooledBytes = m_pooledBytes.load();
+   return stats;
+}
+
+void ossimTileBufferPool::resetStatistics()
+{
+   m_hits       = 0;
+   m_misses     = 0;
+   m_releases   = 0;
+   m_discards   = 0;
+}
+
+ossim_uint32 ossimTileBufferPool::getBin(ossim_uint64 capacity)
+{
+   ossim_uint32 bin = 0;
+   while ((capacity >>= 1) && (bin + 1 < NUMBER_OF_BINS))
+      ++bin;
+   return bin;
+}
+
+bool ossimTileBufferPool::take(std::vector<Buffer>& bin, Buffer& buffer, ossim_uint64 size)
+{
+   // Most recently released first; it is the most likely to still be in cache.
+   for (ossim_uint32 idx = (ossim_uint32)bin.size(); idx > 0; --idx)
+   {
+      if (bin[idx - 1].capacity() >= size)
+      {
+         buffer.swap(bin[idx - 1]);
+         bin.erase(bin.begin() + (idx - 1));
+         return true;
+      }
+   }
+   return false;
+}
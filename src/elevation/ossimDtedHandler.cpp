@@ -11,6 +11,7 @@
 //*****************************************************************************
 // $Id: ossimDtedHandler.cpp 21214 2012-07-03 16:20:11Z dburken $
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring> /* for memcpy */
 #include <ossim/elevation/ossimDtedHandler.h>
@@ -49,7 +50,8 @@ ossimDtedHandler::ossimDtedHandler(const ossimFilename& dted_file, bool memoryMa
       m_latSpacing(0.0),
       m_lonSpacing(0.0),
       m_swCornerPost(),
-      m_swapBytesFlag(false)
+      m_swapBytesFlag(false),
+      m_postBuf(0)
 {
 
    static const char MODULE[] = "ossimDtedHandler (Filename) Constructor";
@@ -117,7 +119,7 @@ bool ossimDtedHandler::getAccuracyInfo(ossimElevationAccuracyInfo& info,
 
 double ossimDtedHandler::getHeightAboveMSL(const ossimGpt& gpt)
 {
-   if(m_memoryMap.size())
+   if(m_postBuf)
    {
       return getHeightAboveMSL(gpt, false);
    }
@@ -129,6 +131,26 @@ double ossimDtedHandler::getHeightAboveMSL(const ossimGpt& gpt)
    return ossim::nan();
 }
 
+void ossimDtedHandler::getHeightsAboveMSL(const ossimGpt* gpts,
+                                          double*         heights,
+                                          ossim_uint32    count)
+{
+   bool readFromFile = false;
+   if ( !m_postBuf )
+   {
+      if ( !m_fileStr || !m_fileStr->good() )
+      {
+         std::fill(heights, heights + count, ossim::nan());
+         return;
+      }
+      readFromFile = true;
+   }
+   for (ossim_uint32 i = 0; i < count; ++i)
+   {
+      heights[i] = ossimDtedHandler::getHeightAboveMSL(gpts[i], readFromFile);
+   }
+}
+
 bool ossimDtedHandler::open(const ossimFilename& file, bool memoryMapFlag)
 {
   std::string connectionString = file.c_str();
@@ -191,14 +213,27 @@ bool ossimDtedHandler::open(std::shared_ptr<ossim::istream>& fileStr,
   }
   if(memoryMapFlag)
   {
-    ossim_int64 streamSize;
-    m_fileStr->clear();
-    m_fileStr->seekg(0, std::ios::end);
-    streamSize = m_fileStr->tellg();
-    m_fileStr->seekg(0, std::ios::beg);
-
-    m_memoryMap.resize(streamSize);//theFilename.fileSize());
-    m_fileStr->read((char*)(&m_memoryMap.front()), (std::streamsize)m_memoryMap.size());
+    //---
+    // Map local files read only.  The mapping is shared with every other
+    // handler on the same cell and the pages with other processes.
+    //---
+    m_mappedFile = ossimMemoryMappedFile::open(ossimFilename(connectionString));
+    if(m_mappedFile)
+    {
+      m_postBuf = m_mappedFile->getData();
+    }
+    else
+    {
+      ossim_int64 streamSize;
+      m_fileStr->clear();
+      m_fileStr->seekg(0, std::ios::end);
+      streamSize = m_fileStr->tellg();
+      m_fileStr->seekg(0, std::ios::beg);
+
+      m_memoryMap.resize(streamSize);//theFilename.fileSize());
+      m_fileStr->read((char*)(&m_memoryMap.front()), (std::streamsize)m_memoryMap.size());
+      m_postBuf = &m_memoryMap.front();
+    }
     m_fileStr.reset();
   }
 
@@ -311,7 +346,7 @@ double ossimDtedHandler::getHeightAboveMSL(const ossimGpt& gpt, bool readFromFil
    }
    else
    {
-     ossim_uint8* buf = &m_memoryMap.front();
+     const ossim_uint8* buf = m_postBuf;
      {
        ossim_uint16 us;
 
@@ -411,14 +446,23 @@ double ossimDtedHandler::getPostValue(const ossimIpt& gridPt) const
    int offset =
       m_offsetToFirstDataRecord + gridPt.x * m_dtedRecordSizeInBytes +
       gridPt.y * 2 + DATA_RECORD_OFFSET_TO_POST;
-   
-   // Put the file pointer at the start of the first elevation post.
-   m_fileStr->seekg(offset, std::ios::beg);
 
    ossim_uint16 us;
 
-   // Get the post.
-   m_fileStr->read((char*)&us, POST_SIZE);
+   if (m_postBuf)
+   {
+      memcpy(&us, m_postBuf + offset, POST_SIZE);
+   }
+   else
+   {
+      std::lock_guard<std::mutex> lock(m_fileStrMutex);
+
+      // Put the file pointer at the start of the first elevation post.
+      m_fileStr->seekg(offset, std::ios::beg);
+
+      // Get the post.
+      m_fileStr->read((char*)&us, POST_SIZE);
+   }
    
    return double(convertSignedMagnitude(us));
 }
@@ -458,7 +502,7 @@ void ossimDtedHandler::gatherStatistics()
       theMinHeightAboveMSL = atoi(min_str);
       theMaxHeightAboveMSL = atoi(max_str);
    }
-   else if (theComputeStatsFlag&&!m_memoryMap.size())  // Scan the cell and gather the statistics...
+   else if (theComputeStatsFlag&&!m_postBuf)  // Scan the cell and gather the statistics...
    {
       if(traceDebug())
       {
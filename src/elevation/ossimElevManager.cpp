@@ -28,11 +28,40 @@
 #include <ossim/base/ossimGeoidManager.h>
 #include <ossim/elevation/ossimElevationDatabaseRegistry.h>
 #include <ossim/base/ossimKeywordNames.h>
+#include <ossim/base/ossimGrect.h>
+#include <ossim/parallel/ossimJob.h>
+#include <ossim/parallel/ossimJobMultiThreadQueue.h>
 #include <algorithm>
+#include <cmath>
 
 ossimElevManager* ossimElevManager::m_instance = 0;
 static ossimTrace traceDebug("ossimElevManager:debug");
 
+// Prefetch requests waiting beyond this are dropped.
+static const ossim_uint32 MAX_PENDING_PREFETCH = 64;
+
+// Prefetch samples at most this many posts a side and at least every 0.05 degrees below that.
+static const ossim_uint32 MAX_PREFETCH_SAMPLES = 16;
+static const double       PREFETCH_SAMPLE_SPACING = 0.05;
+
+class ossimElevManager::PrefetchJob : public ossimJob
+{
+public:
+   PrefetchJob(ossimElevManager* manager, const ossimGrect& bounds)
+      : m_manager(manager), m_bounds(bounds) {}
+
+protected:
+   virtual void run()
+   {
+      m_manager->loadCells(m_bounds);
+      m_manager->finishPrefetch();
+   }
+
+private:
+   ossimElevManager* m_manager;
+   ossimGrect        m_bounds;
+};
+
 using namespace std;
 
 //---
@@ -89,7 +118,11 @@ ossimElevManager::ossimElevManager()
     m_useGeoidIfNullFlag(false),
     m_useStandardPaths(false),
     m_currentDatabaseIdx(0),
-    m_mutex()
+    m_mutex(),
+    m_prefetchFlag(false),
+    m_prefetchQueue(),
+    m_prefetchPending(0),
+    m_prefetchMutex()
 {
    m_instance = this;
    //---
@@ -101,6 +134,12 @@ ossimElevManager::ossimElevManager()
 
 ossimElevManager::~ossimElevManager()
 {
+   if (m_prefetchQueue)
+   {
+      m_prefetchQueue->cancel();
+      m_prefetchQueue->waitForCompletion();
+      m_prefetchQueue.reset();
+   }
    clear();
 }
 
@@ -174,6 +213,185 @@ double ossimElevManager::getHeightAboveMSL(const ossimGpt& gpt)
    return result;
 }
 
+void ossimElevManager::getHeightsAboveEllipsoid(const ossimGpt* gpts,
+                                                double*         heights,
+                                                ossim_uint32    count)
+{
+   std::fill(heights, heights + count, ossim::nan());
+   if (!isSourceEnabled())
+      return;
+
+   getDatabaseHeights(gpts, heights, count, true);
+
+   // Same fallbacks as the single point getHeightAboveEllipsoid:
+   if (!ossim::isnan(m_defaultHeightAboveEllipsoid))
+   {
+      for (ossim_uint32 i = 0; i < count; ++i)
+      {
+         if (ossim::isnan(heights[i]))
+            heights[i] = m_defaultHeightAboveEllipsoid;
+      }
+   }
+   else if (m_useGeoidIfNullFlag)
+   {
+      std::vector<ossim_uint32> missing;
+      std::vector<double> offsets;
+      getGeoidOffsets(gpts, heights, count, missing, offsets);
+      for (ossim_uint32 i = 0; i < missing.size(); ++i)
+         heights[missing[i]] = offsets[i];
+   }
+
+   if (!ossim::isnan(m_elevationOffset))
+   {
+      for (ossim_uint32 i = 0; i < count; ++i)
+      {
+         if (!ossim::isnan(heights[i]))
+            heights[i] += m_elevationOffset;
+      }
+   }
+}
+
+void ossimElevManager::getHeightsAboveMSL(const ossimGpt* gpts,
+                                          double*         heights,
+                                          ossim_uint32    count)
+{
+   std::fill(heights, heights + count, ossim::nan());
+   if (!isSourceEnabled())
+      return;
+
+   getDatabaseHeights(gpts, heights, count, false);
+
+   // Same fallbacks as the single point getHeightAboveMSL:
+   if (m_useGeoidIfNullFlag)
+   {
+      if (!ossim::isnan(m_defaultHeightAboveEllipsoid))
+      {
+         std::vector<ossim_uint32> missing;
+         std::vector<double> offsets;
+         getGeoidOffsets(gpts, heights, count, missing, offsets);
+         for (ossim_uint32 i = 0; i < missing.size(); ++i)
+         {
+            heights[missing[i]] = ossim::isnan(offsets[i]) ? 0.0 :
+               m_defaultHeightAboveEllipsoid - offsets[i];
+         }
+      }
+      else
+      {
+         for (ossim_uint32 i = 0; i < count; ++i)
+         {
+            if (ossim::isnan(heights[i]))
+               heights[i] = 0.0; // MSL
+         }
+      }
+   }
+
+   if (!ossim::isnan(m_elevationOffset))
+   {
+      for (ossim_uint32 i = 0; i < count; ++i)
+      {
+         if (!ossim::isnan(heights[i]))
+            heights[i] += m_elevationOffset;
+      }
+   }
+}
+
+void ossimElevManager::getGeoidOffsets(const ossimGpt*            gpts,
+                                       const double*              heights,
+                                       ossim_uint32               count,
+                                       std::vector<ossim_uint32>& missing,
+                                       std::vector<double>&       offsets) const
+{
+   std::vector<ossimGpt> missingPts;
+   for (ossim_uint32 i = 0; i < count; ++i)
+   {
+      if (ossim::isnan(heights[i]))
+      {
+         missing.push_back(i);
+         missingPts.push_back(gpts[i]);
+      }
+   }
+   offsets.resize(missing.size());
+   if (missing.size())
+   {
+      ossimGeoidManager::instance()->offsetsFromEllipsoid(&missingPts.front(), &offsets.front(),
+                                                          (ossim_uint32)missing.size());
+   }
+}
+
+void ossimElevManager::getHeightsAboveEllipsoid(const ossimGpt& origin,
+                                                double          latSpacing,
+                                                double          lonSpacing,
+                                                ossim_uint32    lines,
+                                                ossim_uint32    samples,
+                                                double*         heights)
+{
+   if (!lines || !samples)
+      return;
+
+   //---
+   // One line per batch keeps the scratch small; lines run along a row of
+   // cells so each batch still touches only one or two cells.
+   //---
+   std::vector<ossimGpt> linePts(samples, origin);
+   for (ossim_uint32 line = 0; line < lines; ++line)
+   {
+      const double LAT = origin.lat + line*latSpacing;
+      for (ossim_uint32 samp = 0; samp < samples; ++samp)
+      {
+         linePts[samp].lat = LAT;
+         linePts[samp].lon = origin.lon + samp*lonSpacing;
+      }
+      getHeightsAboveEllipsoid(&linePts.front(), heights + line*samples, samples);
+   }
+}
+
+void ossimElevManager::getDatabaseHeights(const ossimGpt* gpts,
+                                          double*         heights,
+                                          ossim_uint32    count,
+                                          bool            aboveEllipsoid)
+{
+   ElevationDatabaseListType& elevDbList = getNextElevDbList();
+
+   // Points still missing a height after the previous databases:
+   std::vector<ossim_uint32> missing;
+   std::vector<ossimGpt>     missingPts;
+   std::vector<double>       missingHeights;
+
+   for (ossim_uint32 idx = 0; idx < elevDbList.size(); ++idx)
+   {
+      ossimElevationDatabase* db = elevDbList[idx].get();
+      if (idx == 0)
+      {
+         if (aboveEllipsoid)
+            db->getHeightsAboveEllipsoid(gpts, heights, count);
+         else
+            db->getHeightsAboveMSL(gpts, heights, count);
+         continue;
+      }
+
+      missing.clear();
+      for (ossim_uint32 i = 0; i < count; ++i)
+      {
+         if (ossim::isnan(heights[i]))
+            missing.push_back(i);
+      }
+      if (missing.empty())
+         break;
+
+      const ossim_uint32 MISSING = (ossim_uint32)missing.size();
+      missingPts.resize(MISSING);
+      missingHeights.resize(MISSING);
+      for (ossim_uint32 k = 0; k < MISSING; ++k)
+         missingPts[k] = gpts[missing[k]];
+      if (aboveEllipsoid)
+         db->getHeightsAboveEllipsoid(&missingPts.front(), &missingHeights.front(), MISSING);
+      else
+         db->getHeightsAboveMSL(&missingPts.front(), &missingHeights.front(), MISSING);
+      for (ossim_uint32 k = 0; k < MISSING; ++k)
+         heights[missing[k]] = missingHeights[k];
+   }
+}
+
 void ossimElevManager::loadStandardElevationPaths()
 {
    if (!m_useStandardPaths)
@@ -419,6 +637,96 @@ void ossimElevManager::getCellsForBounds( const ossimGrect& bbox,
    getCellsForBounds(bbox.lr().lat, bbox.ul().lon, bbox.ul().lat, bbox.lr().lon, cells, maxCells);
 }
 
+bool ossimElevManager::prefetch(const ossimGrect& bounds)
+{
+   if ( !m_prefetchFlag || !isSourceEnabled() || bounds.isLonLatNan() ||
+        !getNumberOfElevationDatabases() )
+   {
+      return false;
+   }
+
+   // A hint only, so drop it rather than queue work that will be too late.
+   if ( ++m_prefetchPending > MAX_PENDING_PREFETCH )
+   {
+      --m_prefetchPending;
+      return false;
+   }
+
+   std::lock_guard<std::mutex> lock(m_prefetchMutex);
+   if (!m_prefetchQueue)
+   {
+      m_prefetchQueue = std::make_shared<ossimJobMultiThreadQueue>(
+         std::make_shared<ossimJobQueue>(), 1);
+   }
+   m_prefetchQueue->getJobQueue()->add(std::make_shared<PrefetchJob>(this, bounds), false);
+   return true;
+}
+
+void ossimElevManager::waitForPrefetch()
+{
+   std::unique_lock<std::mutex> lock(m_prefetchMutex);
+   m_prefetchDone.wait(lock, [this]() { return m_prefetchPending.load() == 0; });
+}
+
+void ossimElevManager::finishPrefetch()
+{
+   // Decremented under the lock so waitForPrefetch can't miss the last one.
+   std::lock_guard<std::mutex> lock(m_prefetchMutex);
+   if (--m_prefetchPending == 0)
+   {
+      m_prefetchDone.notify_all();
+   }
+}
+
+void ossimElevManager::loadCells(const ossimGrect& bounds)
+{
+   // Sample grid over bounds, edges included.
+   const double latSpan = bounds.ul().lat - bounds.lr().lat;
+   const double lonSpan = bounds.lr().lon - bounds.ul().lon;
+   const ossim_uint32 lines = std::min<ossim_uint32>(
+      (ossim_uint32)std::ceil(std::fabs(latSpan) / PREFETCH_SAMPLE_SPACING) + 1,
+      MAX_PREFETCH_SAMPLES);
+   const ossim_uint32 samples = std::min<ossim_uint32>(
+      (ossim_uint32)std::ceil(std::fabs(lonSpan) / PREFETCH_SAMPLE_SPACING) + 1,
+      MAX_PREFETCH_SAMPLES);
+
+   std::vector<ossimGpt> gpts(lines * samples);
+   for (ossim_uint32 line = 0; line < lines; ++line)
+   {
+      double lat = bounds.ul().lat - ((lines > 1) ? (latSpan * line / (lines - 1)) : 0.0);
+      for (ossim_uint32 samp = 0; samp < samples; ++samp)
+      {
+         double lon = bounds.ul().lon + ((samples > 1) ? (lonSpan * samp / (samples - 1)) : 0.0);
+         gpts[line * samples + samp] = ossimGpt(lat, lon, 0.0, bounds.ul().datum());
+      }
+   }
+   std::vector<double> heights(gpts.size());
+
+   // Each copy in the round robin has its own cell cache, so warm them all.
+   std::vector<ElevationDatabaseListType> lists;
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      lists = m_dbRoundRobin;
+   }
+   for (ossim_uint32 i = 0; i < lists.size(); ++i)
+   {
+      // Like getDatabaseHeights, later databases only see the posts still missing.
+      std::vector<ossimGpt> missing(gpts);
+      for (ossim_uint32 idx = 0; (idx < lists[i].size()) && missing.size(); ++idx)
+      {
+         lists[i][idx]->getHeightsAboveMSL(&missing.front(), &heights.front(),
+                                           (ossim_uint32)missing.size());
+         ossim_uint32 count = 0;
+         for (ossim_uint32 j = 0; j < missing.size(); ++j)
+         {
+            if (ossim::isnan(heights[j]))
+               missing[count++] = missing[j];
+         }
+         missing.resize(count);
+      }
+   }
+}
+
 void ossimElevManager::clear()
 {
    std::vector<ElevationDatabaseListType>::iterator i = m_dbRoundRobin.begin();
@@ -490,6 +798,7 @@ bool ossimElevManager::saveState(ossimKeywordlist& kwl, const char* prefix) cons
    kwl.add(prefix, "default_height_above_ellipsoid", m_defaultHeightAboveEllipsoid, true);
    kwl.add(prefix, "use_geoid_if_null", m_useGeoidIfNullFlag, true);
    kwl.add(prefix, "use_standard_elev_paths", m_useStandardPaths, true);
+   kwl.add(prefix, "prefetch", m_prefetchFlag, true);
    kwl.add(prefix, "threads", ossimString::toString(m_maxRoundRobinSize), true);
 
    return ossimElevSource::saveState(kwl, prefix);
@@ -518,6 +827,7 @@ bool ossimElevManager::loadState(const ossimKeywordlist& kwl, const char* prefix
 
    kwl.getBoolKeywordValue(m_useGeoidIfNullFlag, "use_geoid_if_null", copyPrefix.chars());
    kwl.getBoolKeywordValue(m_useStandardPaths, "use_standard_elev_paths", copyPrefix.chars());
+   kwl.getBoolKeywordValue(m_prefetchFlag, "prefetch", copyPrefix.chars());
 
    if(!elevationOffset.empty())
       m_elevationOffset = elevationOffset.toDouble();
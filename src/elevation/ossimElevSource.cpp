@@ -31,6 +31,7 @@ RTTI_DEF1(ossimElevSource, "ossimElevSource" , ossimSource)
 // Define Trace flags for use within this file:
 //***
 #include <ossim/base/ossimTrace.h>
+#include <vector>
 static ossimTrace traceExec  ("ossimElevSource:exec");
 static ossimTrace traceDebug ("ossimElevSource:debug");
 
@@ -104,6 +105,26 @@ double ossimElevSource::getHeightAboveEllipsoid(const ossimGpt& /* argGpt */)
    return theNullHeightValue;
 }
 
+void ossimElevSource::getHeightsAboveMSL(const ossimGpt* gpts,
+                                         double*         heights,
+                                         ossim_uint32    count)
+{
+   for (ossim_uint32 i = 0; i < count; ++i)
+   {
+      heights[i] = getHeightAboveMSL(gpts[i]);
+   }
+}
+
+void ossimElevSource::getHeightsAboveEllipsoid(const ossimGpt* gpts,
+                                               double*         heights,
+                                               ossim_uint32    count)
+{
+   for (ossim_uint32 i = 0; i < count; ++i)
+   {
+      heights[i] = getHeightAboveEllipsoid(gpts[i]);
+   }
+}
+
 //*****************************************************************************
 //  METHOD: intersectRay()
 //  
@@ -219,6 +240,102 @@ bool ossimElevSource::intersectRay(const ossimEcefRay& ray, ossimGpt& gpt, doubl
    return intersected;
 }
 
+//*****************************************************************************
+//  METHOD: intersectRays()
+//
+//  Batch form of intersectRay.  Every ray takes the same steps as it would in
+//  intersectRay; the rays still converging just share one elevation lookup
+//  per iteration.
+//*****************************************************************************
+ossim_uint32 ossimElevSource::intersectRays(const ossimEcefRay* rays,
+                                            ossimGpt*           gpts,
+                                            ossim_uint32        count,
+                                            double              defaultElevValue,
+                                            bool*               intersected)
+{
+   static const double CONVERGENCE_THRESHOLD = 0.001; // meters
+   static const int    MAX_NUM_ITERATIONS    = 50;
+
+   std::vector<char>           hit(count, 0);
+   std::vector<ossimEcefPoint> prevPts(count);
+   std::vector<ossim_uint32>   active;
+   std::vector<ossimGpt>       activeGpts;
+   std::vector<double>         heights;
+   active.reserve(count);
+
+   for (ossim_uint32 i = 0; i < count; ++i)
+   {
+      if (rays[i].hasNans())
+      {
+         gpts[i].makeNan();
+      }
+      else
+      {
+         prevPts[i] = rays[i].origin();
+         gpts[i] = ossimGpt(prevPts[i], gpts[i].datum());
+         active.push_back(i);
+      }
+   }
+
+   int iteration_count = 0;
+   while (!active.empty() && (iteration_count < MAX_NUM_ITERATIONS))
+   {
+      const ossim_uint32 ACTIVE = (ossim_uint32)active.size();
+      activeGpts.resize(ACTIVE);
+      heights.resize(ACTIVE);
+      for (ossim_uint32 k = 0; k < ACTIVE; ++k)
+      {
+         activeGpts[k] = gpts[active[k]];
+      }
+      getHeightsAboveEllipsoid(&activeGpts.front(), &heights.front(), ACTIVE);
+
+      ossim_uint32 stillActive = 0;
+      for (ossim_uint32 k = 0; k < ACTIVE; ++k)
+      {
+         const ossim_uint32 i = active[k];
+         const ossimDatum* datum = gpts[i].datum();
+         double h_ellips = ossim::isnan(heights[k]) ? defaultElevValue : heights[k];
+
+         ossimEcefPoint new_intersect_pt;
+         if (!datum->ellipsoid()->nearestIntersection(rays[i], h_ellips, new_intersect_pt))
+         {
+            // Looking over the horizon:
+            hit[i] = 0;
+            gpts[i].makeNan();
+         }
+         else
+         {
+            hit[i] = 1;
+            gpts[i] = ossimGpt(new_intersect_pt, datum);
+            if ((new_intersect_pt - prevPts[i]).magnitude() >= CONVERGENCE_THRESHOLD)
+            {
+               prevPts[i] = new_intersect_pt;
+               active[stillActive++] = i;
+            }
+         }
+      }
+      active.resize(stillActive);
+      ++iteration_count;
+   }
+
+   if (!active.empty() && traceDebug())
+   {
+      ossimNotify(ossimNotifyLevel_WARN)
+         << "WARNING ossimElevSource::intersectRays: Max number of iterations reached solving for "
+         << active.size() << " ground points. Results are probably inaccurate." << std::endl;
+   }
+
+   ossim_uint32 result = 0;
+   for (ossim_uint32 i = 0; i < count; ++i)
+   {
+      if (hit[i])
+         ++result;
+      if (intersected)
+         intersected[i] = (hit[i] != 0);
+   }
+   return result;
+}
+
 double ossimElevSource::getMinHeightAboveMSL() const
 {
    return theMinHeightAboveMSL;
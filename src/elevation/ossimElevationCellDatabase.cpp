@@ -1,4 +1,5 @@
 #include <ossim/elevation/ossimElevationCellDatabase.h>
+#include <algorithm>
 
 RTTI_DEF1(ossimElevationCellDatabase, "ossimElevationCellDatabase", ossimElevationDatabase);
 
@@ -177,6 +178,86 @@ ossimRefPtr<ossimElevCellHandler> ossimElevationCellDatabase::getOrCreateCellHan
 }
 #endif
 
+void ossimElevationCellDatabase::getHeightsAboveMSL(const ossimGpt* gpts,
+                                                    double*         heights,
+                                                    ossim_uint32    count)
+{
+   if ( !isSourceEnabled() )
+   {
+      std::fill(heights, heights + count, ossim::nan());
+      return;
+   }
+
+   // Cells already looked up in this batch:
+   std::vector< ossimRefPtr<ossimElevCellHandler> > handlers;
+
+   ossim_uint32 i = 0;
+   while ( i < count )
+   {
+      ossimRefPtr<ossimElevCellHandler> handler = 0;
+      std::vector< ossimRefPtr<ossimElevCellHandler> >::iterator h = handlers.begin();
+      while ( h != handlers.end() )
+      {
+         if ( (*h)->pointHasCoverage( gpts[i] ) )
+         {
+            handler = (*h).get();
+            break;
+         }
+         ++h;
+      }
+      if ( !handler.valid() )
+      {
+         handler = getOrCreateCellHandler( gpts[i] );
+         if ( !handler.valid() )
+         {
+            heights[i] = ossim::nan();
+            ++i;
+            continue;
+         }
+         handlers.push_back( handler );
+      }
+
+      // Extend the run over the points that follow in the same cell:
+      ossim_uint32 end = i + 1;
+      while ( (end < count) && handler->pointHasCoverage( gpts[end] ) )
+      {
+         ++end;
+      }
+      // Heights are above MSL, getHeightsAboveEllipsoid adds the geoid offsets:
+      handler->getHeightsAboveMSL( gpts + i, heights + i, end - i );
+      i = end;
+   }
+}
+
+void ossimElevationCellDatabase::getHeightsAboveEllipsoid(const ossimGpt* gpts,
+                                                          double*         heights,
+                                                          ossim_uint32    count)
+{
+   getHeightsAboveMSL( gpts, heights, count );
+
+   // One batch geoid lookup for the points that got a height:
+   std::vector<ossim_uint32> found;
+   std::vector<ossimGpt>     foundPts;
+   for ( ossim_uint32 i = 0; i < count; ++i )
+   {
+      if ( !ossim::isnan( heights[i] ) )
+      {
+         found.push_back( i );
+         foundPts.push_back( gpts[i] );
+      }
+   }
+   if ( found.size() )
+   {
+      std::vector<double> offsets( found.size() );
+      getOffsetsFromEllipsoid( &foundPts.front(), &offsets.front(),
+                               (ossim_uint32)found.size() );
+      for ( ossim_uint32 i = 0; i < found.size(); ++i )
+      {
+         heights[ found[i] ] += offsets[i];
+      }
+   }
+}
+
 bool ossimElevationCellDatabase::loadState(const ossimKeywordlist& kwl, const char* prefix)
 {
    ossimString minOpenCells = kwl.find(prefix, "min_open_cells");
@@ -24,6 +24,28 @@ double ossimElevationDatabase::getOffsetFromEllipsoid(const ossimGpt& gpt)
    return result;
 }
 
+void ossimElevationDatabase::getOffsetsFromEllipsoid(const ossimGpt* gpts,
+                                                     double*         offsets,
+                                                     ossim_uint32    count)
+{
+   if(m_geoid.valid())
+   {
+      m_geoid->offsetsFromEllipsoid(gpts, offsets, count);
+   }
+   else
+   {
+      ossimGeoidManager::instance()->offsetsFromEllipsoid(gpts, offsets, count);
+   }
+
+   for(ossim_uint32 i = 0; i < count; ++i)
+   {
+      if(ossim::isnan(offsets[i]))
+      {
+         offsets[i] = 0.0;
+      }
+   }
+}
+
 bool ossimElevationDatabase::loadState(const ossimKeywordlist& kwl, const char* prefix)
 {
    // Connection string:
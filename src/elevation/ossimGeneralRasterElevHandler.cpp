@@ -19,7 +19,8 @@ using namespace std;
 
 ossimGeneralRasterElevHandler::ossimGeneralRasterElevHandler(const ossimFilename& file)
    :ossimElevCellHandler(file.c_str()),
-    m_streamOpen(false)
+    m_streamOpen(false),
+    m_postBuf(0)
 {
    if(!open(file))
    {
@@ -31,12 +32,23 @@ ossimGeneralRasterElevHandler::ossimGeneralRasterElevHandler(const ossimGeneralR
    :ossimElevCellHandler(src),
     theGeneralRasterInfo(src.theGeneralRasterInfo),
     m_streamOpen(false), // ????
-    m_memoryMap(src.m_memoryMap)
+    m_memoryMap(src.m_memoryMap),
+    m_mappedFile(src.m_mappedFile),
+    m_postBuf(0)
 {
+   if(m_mappedFile)
+   {
+      m_postBuf = reinterpret_cast<const char*>(m_mappedFile->getData());
+   }
+   else if(!m_memoryMap.empty())
+   {
+      m_postBuf = &m_memoryMap.front();
+   }
 }
 
 ossimGeneralRasterElevHandler::ossimGeneralRasterElevHandler(const ossimGeneralRasterElevHandler::GeneralRasterInfo& generalRasterInfo)
-   : m_streamOpen(false)
+   : m_streamOpen(false),
+     m_postBuf(0)
 {
 
    close();
@@ -55,7 +67,7 @@ double ossimGeneralRasterElevHandler::getHeightAboveMSL(const ossimGpt& gpt)
 {
    ossim_float64 result = theGeneralRasterInfo.theNullHeightValue;
 
-   if(m_memoryMap.empty())
+   if(!m_postBuf)
    {
       switch(theGeneralRasterInfo.theScalarType)
       {
@@ -206,7 +218,7 @@ double ossimGeneralRasterElevHandler::getPostValue(const ossimIpt& /* gridPt */)
 
 bool ossimGeneralRasterElevHandler::isOpen()const
 {
-   if(!m_memoryMap.empty()) return true;
+   if(m_postBuf) return true;
    std::lock_guard<std::mutex> lock(m_inputStreamMutex);
 
    //---
@@ -224,12 +236,19 @@ bool ossimGeneralRasterElevHandler::open(const ossimFilename& file, bool memoryM
 
    if(memoryMapFlag)
    {
-      if(!m_inputStream.bad())
+      // Shared read only mapping; read the whole cell if it cannot be mapped.
+      m_mappedFile = ossimMemoryMappedFile::open(theGeneralRasterInfo.theFilename);
+      if(m_mappedFile)
+      {
+         m_postBuf = reinterpret_cast<const char*>(m_mappedFile->getData());
+      }
+      else if(!m_inputStream.bad())
       {
          m_memoryMap.resize(theGeneralRasterInfo.theFilename.fileSize());
          if(!m_memoryMap.empty())
          {
            m_inputStream.read((char*)(&m_memoryMap.front()), (streamsize)m_memoryMap.size());
+           m_postBuf = &m_memoryMap.front();
          }
       }
       m_inputStream.close();
@@ -238,7 +257,7 @@ bool ossimGeneralRasterElevHandler::open(const ossimFilename& file, bool memoryM
    // Capture the stream state for non-const is_open on old compiler.
    m_streamOpen = m_inputStream.is_open();
    
-   return m_streamOpen;
+   return ( m_streamOpen || (m_postBuf != 0) );
 }
 
 /**
@@ -248,6 +267,8 @@ void ossimGeneralRasterElevHandler::close()
 {
    m_inputStream.close();
    m_memoryMap.clear();
+   m_mappedFile.reset();
+   m_postBuf = 0;
    m_streamOpen = false;
 }
 
@@ -617,10 +638,10 @@ double ossimGeneralRasterElevHandler::getHeightAboveMSLMemoryTemplate(
    ossim_uint64 offset = y0*bytesPerLine + x0*sizeof(T);
    ossim_uint64 offset2 = offset+bytesPerLine;
    
-   T v00 = *(reinterpret_cast<T*> (&m_memoryMap[offset]));
-   T v01 = *(reinterpret_cast<T*> (&m_memoryMap[offset + sizeof(T)]));
-   T v10 = *(reinterpret_cast<T*> (&m_memoryMap[offset2]));
-   T v11 = *(reinterpret_cast<T*> (&m_memoryMap[offset2 + sizeof(T)]));
+   T v00 = *(reinterpret_cast<const T*> (m_postBuf + offset));
+   T v01 = *(reinterpret_cast<const T*> (m_postBuf + offset + sizeof(T)));
+   T v10 = *(reinterpret_cast<const T*> (m_postBuf + offset2));
+   T v11 = *(reinterpret_cast<const T*> (m_postBuf + offset2 + sizeof(T)));
    if(endian.getSystemEndianType() != info.theByteOrder)
    {
       endian.swap(v00);
@@ -12,12 +12,17 @@
 // $Id$
 
 #include <ossim/elevation/ossimImageElevationDatabase.h>
+#include <ossim/base/ossimDate.h>
+#include <ossim/base/ossimDirectory.h>
 #include <ossim/base/ossimDpt.h>
 #include <ossim/base/ossimKeywordNames.h>
+#include <ossim/base/ossimKeywordlist.h>
+#include <ossim/base/ossimSidecarFile.h>
 #include <ossim/base/ossimString.h>
 #include <ossim/base/ossimTrace.h>
 #include <ossim/elevation/ossimImageElevationHandler.h>
 #include <ossim/util/ossimFileWalker.h>
+#include <algorithm>
 #include <cmath>
 #include <ostream>
 
@@ -30,6 +35,41 @@ static const std::string ELEV_CELL_MAP = "elev_cell_map.kwl";
 
 static ossimTrace traceDebug(ossimString("ossimImageElevationDatabase:debug"));
 
+//---
+// Maps of directories that could not be written, keyed by directory, so a read only tree is
+// walked once per process rather than on every open.
+//---
+static std::map<std::string, ossimKeywordlist> readOnlyMaps;
+static std::mutex readOnlyMapsMutex;
+
+// @return Modification time of file in seconds since the epoch, 0 if not available.
+static ossim_int64 getModTime(const ossimFilename& file)
+{
+   ossimLocalTm modTime;
+   if ( file.getTimes( 0, &modTime, 0 ) )
+   {
+      return (ossim_int64)modTime.getEpoc();
+   }
+   return 0;
+}
+
+// Adds dir and every directory below it with its modification time to dirModTimes.
+static void getDirModTimes(const ossimFilename& dir,
+                           std::map<std::string, ossim_int64>& dirModTimes)
+{
+   dirModTimes[dir.string()] = getModTime( dir );
+
+   ossimDirectory d;
+   ossimFilename sub;
+   if ( d.open( dir ) && d.getFirst( sub, ossimDirectory::OSSIM_DIR_DIRS ) )
+   {
+      do
+      {
+         getDirModTimes( sub, dirModTimes );
+      } while ( d.getNext( sub ) );
+   }
+}
+
 RTTI_DEF1(ossimImageElevationDatabase, "ossimImageElevationDatabase", ossimElevationCellDatabase);
 
 ossimImageElevationDatabase::ossimImageElevationDatabase()
@@ -37,6 +77,12 @@ ossimImageElevationDatabase::ossimImageElevationDatabase()
    ossimElevationCellDatabase(),
    ossimFileProcessorInterface(),
    m_entryMap(),
+   m_entryIndex(),
+   m_unindexedIds(),
+   m_unindexedMutex(),
+   m_knownFiles(),
+   m_dirModTimes(),
+   m_mapDirty(false),
    m_lastMapKey(0),
    m_lastAccessedId(0)
 {
@@ -59,16 +105,19 @@ bool ossimImageElevationDatabase::open(const ossimString& connectionString)
    
    bool result = false;
 
+   // Rectangles queries captured since the last open:
+   if ( m_mapDirty )
+   {
+      saveFileMap();
+   }
+
    close();
 
    if ( connectionString.size() )
    {
       m_connectionString = connectionString.c_str();
 
-      if ( loadMapFromKwl() == false )
-      {
-         loadFileMap();
-      }
+      loadMap();
 
       if ( m_entryMap.size() )
       {
@@ -93,6 +142,12 @@ void ossimImageElevationDatabase::close()
    m_meanSpacing = 0.0;
    m_geoid = 0;
    m_connectionString.clear();
+   m_entryMap.clear();
+   m_entryIndex.clear();
+   m_dirModTimes.clear();
+   std::lock_guard<std::mutex> lock(m_unindexedMutex);
+   m_unindexedIds.clear();
+   m_mapDirty = false;
 }
 
 double ossimImageElevationDatabase::getHeightAboveMSL(const ossimGpt& gpt)
@@ -131,87 +186,134 @@ ossimRefPtr<ossimElevCellHandler> ossimImageElevationDatabase::createCell(
    // Need to disable elevation while loading the DEM image to prevent recursion:
    disableSource();
 
-   std::map<ossim_uint64, ossimImageElevationFileEntry>::iterator i = m_entryMap.begin();
-   while ( i != m_entryMap.end() )
+   // Candidates from the index, in m_entryMap order.
+   std::vector<ossim_uint64> ids;
+   m_entryIndex.findPoint( gpt.lon, gpt.lat, ids );
+   std::sort( ids.begin(), ids.end() );
+
+   for ( std::vector<ossim_uint64>::const_iterator id = ids.begin(); id != ids.end(); ++id )
    {
-      if ( (*i).second.m_loadedFlag == false )
+      std::map<ossim_uint64, ossimImageElevationFileEntry>::iterator i = m_entryMap.find(*id);
+      if ( ( i == m_entryMap.end() ) || (*i).second.m_loadedFlag )
       {
-         // not loaded
-         ossimRefPtr<ossimImageElevationHandler> h = new ossimImageElevationHandler();
+         continue;
+      }
 
-         if ( (*i).second.m_rect.isLonLatNan() )
+      // Check the North up bounding rectangle for intersect.
+      if ( (*i).second.m_rect.pointWithin(gpt) )
+      {
+         ossimRefPtr<ossimImageElevationHandler> h = new ossimImageElevationHandler();
+         if ( h->open( (*i).second.m_file ) )
          {
-            if ( h->open( (*i).second.m_file ) )
+            if ( ossim::isnan(m_meanSpacing) )
             {
-               // First time opened.  Capture the rectangle. for next time.
-               (*i).second.m_rect = h->getBoundingGndRect();
-
-               if ( ossim::isnan(m_meanSpacing) )
-               {
-                  // Save the elev source's post spacing as the database's mean spacing:
-                  m_meanSpacing = h->getMeanSpacingMeters();
-               }
+               // Save the elev source's post spacing as the database's mean spacing:
+               m_meanSpacing = h->getMeanSpacingMeters();
             }
-            else
+
+            //---
+            // Check point coverage again as image may not be geographic and pointHasCoverage
+            // has a check on worldToLocal point.
+            //---
+            if (  h->pointHasCoverage(gpt) )
             {
-               ossimNotify(ossimNotifyLevel_WARN)
-                  << "ossimImageElevationDatabase::createCell WARN:\nCould not open: "
-                  << (*i).second.m_file << "\nRemoving file from map!" << std::endl;
-
-               // Get a copy of the iterator to delet.
-               std::map<ossim_uint64, ossimImageElevationFileEntry>::iterator badIter = i;
-               
-               ++i; // Go to next image.
-
-               // Must put lock around erase.
-               m_cacheMapMutex.lock();
-               m_entryMap.erase(badIter);
-               m_cacheMapMutex.unlock();
-               
-               continue; // Skip the rest of this loop.
+               m_lastAccessedId = (*i).first;
+               (*i).second.m_loadedFlag = true;
+               result = h.get();
+               break;
             }
          }
+      }
+   }
 
-         // Check the North up bounding rectangle for intersect.
-         if ( (*i).second.m_rect.pointWithin(gpt) )
+   if ( !result.valid() )
+   {
+      result = createUnindexedCell(gpt);
+   }
+   
+   enableSource();
+   return result;
+}
+
+ossimRefPtr<ossimElevCellHandler> ossimImageElevationDatabase::createUnindexedCell(
+   const ossimGpt& gpt)
+{
+   ossimRefPtr<ossimElevCellHandler> result = 0;
+
+   std::lock_guard<std::mutex> lock(m_unindexedMutex);
+   bool rectFound = false;
+   std::vector<ossim_uint64>::iterator id = m_unindexedIds.begin();
+   while ( id != m_unindexedIds.end() )
+   {
+      std::map<ossim_uint64, ossimImageElevationFileEntry>::iterator i = m_entryMap.find(*id);
+      if ( i == m_entryMap.end() )
+      {
+         id = m_unindexedIds.erase( id );
+         continue;
+      }
+
+      ossimRefPtr<ossimImageElevationHandler> h = 0;
+      if ( (*i).second.m_rect.isLonLatNan() )
+      {
+         // First time opened.  Capture the rectangle for next time.
+         h = new ossimImageElevationHandler();
+         if ( !h->open( (*i).second.m_file ) )
          {
-            if ( h->isOpen() == false )
-            {
-               h->open( (*i).second.m_file );
-            }
+            ossimNotify(ossimNotifyLevel_WARN)
+               << "ossimImageElevationDatabase::createCell WARN:\nCould not open: "
+               << (*i).second.m_file << "\nSkipping file!" << std::endl;
+            id = m_unindexedIds.erase( id );
+            continue;
+         }
+         (*i).second.m_rect = h->getBoundingGndRect();
+         rectFound = true;
+         if ( ossim::isnan(m_meanSpacing) )
+         {
+            m_meanSpacing = h->getMeanSpacingMeters();
+         }
+      }
 
-            if ( h->isOpen() )
-            {
-               //---
-               // Check point coverage again as image may not be geographic and pointHasCoverage
-               // has a check on worldToLocal point.
-               //---
-               if (  h->pointHasCoverage(gpt) )
-               {
-                  m_lastAccessedId = (*i).first;
-                  (*i).second.m_loadedFlag = true;
-                  result = h.get();
-                  break;
-               }
-               else
-               {
-                  h = 0;
-               }
-            }
+      if ( !result.valid() && !(*i).second.m_loadedFlag && (*i).second.m_rect.pointWithin(gpt) )
+      {
+         if ( !h.valid() )
+         {
+            h = new ossimImageElevationHandler();
+            h->open( (*i).second.m_file );
          }
-         else
+         if ( h->isOpen() && h->pointHasCoverage(gpt) )
          {
-            h = 0;
+            m_lastAccessedId = (*i).first;
+            (*i).second.m_loadedFlag = true;
+            result = h.get();
          }
       }
+      ++id;
+   }
 
-      ++i;
+   if ( rectFound )
+   {
+      // Written on the next open, not from the query threads:
+      m_mapDirty = true;
    }
-   
-   enableSource();
    return result;
 }
 
+bool ossimImageElevationDatabase::unindexedHasCoverage(const ossimGpt& gpt) const
+{
+   std::lock_guard<std::mutex> lock(m_unindexedMutex);
+   for ( std::vector<ossim_uint64>::const_iterator id = m_unindexedIds.begin();
+         id != m_unindexedIds.end(); ++id )
+   {
+      std::map<ossim_uint64, ossimImageElevationFileEntry>::const_iterator i =
+         m_entryMap.find(*id);
+      if ( ( i != m_entryMap.end() ) && (*i).second.m_rect.pointWithin(gpt) )
+      {
+         return true;
+      }
+   }
+   return false;
+}
+
 ossimRefPtr<ossimElevCellHandler> ossimImageElevationDatabase::getOrCreateCellHandler(
    const ossimGpt& gpt)
 {
@@ -308,19 +410,70 @@ bool ossimImageElevationDatabase::pointHasCoverage(const ossimGpt& gpt) const
    // ossimImageGeometry of the image.
    //---
    bool result = false;
-   std::map<ossim_uint64, ossimImageElevationFileEntry>::const_iterator i = m_entryMap.begin();
-   while ( i != m_entryMap.end() )
+   std::vector<ossim_uint64> ids;
+   if ( m_entryIndex.findPoint( gpt.lon, gpt.lat, ids ) )
    {
-      if ( (*i).second.m_rect.pointWithin(gpt) )
+      for ( std::vector<ossim_uint64>::const_iterator id = ids.begin(); id != ids.end(); ++id )
       {
-         result = true;
-         break;
+         std::map<ossim_uint64, ossimImageElevationFileEntry>::const_iterator i =
+            m_entryMap.find(*id);
+         if ( ( i != m_entryMap.end() ) && (*i).second.m_rect.pointWithin(gpt) )
+         {
+            result = true;
+            break;
+         }
       }
-      ++i;
+   }
+   if ( !result )
+   {
+      result = unindexedHasCoverage(gpt);
    }
    return result;
 }
 
+void ossimImageElevationDatabase::getCellsForBounds( const ossim_float64& minLat,
+                                                     const ossim_float64& minLon,
+                                                     const ossim_float64& maxLat,
+                                                     const ossim_float64& maxLon,
+                                                     std::vector<ossimFilename>& cells,
+                                                     ossim_uint32 maxNumberOfCells )
+{
+   ossim_uint32 limitNumberOfCells = maxNumberOfCells>0?maxNumberOfCells:999999999;
+
+   std::vector<ossim_uint64> ids;
+   m_entryIndex.findIntersecting( minLon, minLat, maxLon, maxLat, ids );
+   std::sort( ids.begin(), ids.end() );
+
+   std::vector<ossim_uint64>::const_iterator id = ids.begin();
+   while ( ( id != ids.end() ) && ( cells.size() < limitNumberOfCells ) )
+   {
+      std::map<ossim_uint64, ossimImageElevationFileEntry>::const_iterator i =
+         m_entryMap.find(*id);
+      if ( ( i != m_entryMap.end() ) &&
+           ( std::find( cells.begin(), cells.end(), (*i).second.m_file ) == cells.end() ) )
+      {
+         cells.push_back( (*i).second.m_file );
+      }
+      ++id;
+   }
+
+   // Unindexed entries whose rectangle a query has captured since:
+   const ossimGrect bounds( maxLat, minLon, minLat, maxLon );
+   std::lock_guard<std::mutex> lock(m_unindexedMutex);
+   for ( id = m_unindexedIds.begin();
+         ( id != m_unindexedIds.end() ) && ( cells.size() < limitNumberOfCells ); ++id )
+   {
+      std::map<ossim_uint64, ossimImageElevationFileEntry>::const_iterator i =
+         m_entryMap.find(*id);
+      if ( ( i != m_entryMap.end() ) && !(*i).second.m_rect.isLonLatNan() &&
+           (*i).second.m_rect.intersects( bounds ) &&
+           ( std::find( cells.begin(), cells.end(), (*i).second.m_file ) == cells.end() ) )
+      {
+         cells.push_back( (*i).second.m_file );
+      }
+   }
+}
+
 void ossimImageElevationDatabase::getBoundingRect(ossimGrect& rect) const
 {
    // The bounding rect is the North up rectangle.  So if the underlying image projection is not
@@ -380,10 +533,7 @@ bool ossimImageElevationDatabase::loadState(const ossimKeywordlist& kwl, const c
          result = ossimElevationCellDatabase::loadState(kwl, prefix);
          if ( result )
          {
-            if ( loadMapFromKwl() == false )
-            {
-               loadFileMap();
-            }
+            loadMap();
          }
       }
    }
@@ -410,8 +560,15 @@ void ossimImageElevationDatabase::processFile(const ossimFilename& file)
          << M << " entered...\n" << "file: " << file << "\n";
    }
 
-   // Add the file.
-   m_entryMap.insert( std::make_pair(m_lastMapKey++, ossimImageElevationFileEntry(file)) );
+   // Add the file unless it is already mapped.  The entry opens the file for its rectangle
+   // so the map is written with it:
+   if ( m_knownFiles.find( file.string() ) == m_knownFiles.end() )
+   {
+      // Need to disable elevation while loading the DEM image to prevent recursion:
+      disableSource();
+      m_entryMap.insert( std::make_pair(m_lastMapKey++, ossimImageElevationFileEntry(file)) );
+      enableSource();
+   }
 
    if(traceDebug())
    {
@@ -420,6 +577,21 @@ void ossimImageElevationDatabase::processFile(const ossimFilename& file)
    } 
 }
 
+void ossimImageElevationDatabase::loadMap()
+{
+   if ( loadMapFromKwl() == false )
+   {
+      loadFileMap();
+   }
+   buildIndex();
+
+   if ( m_mapDirty )
+   {
+      saveFileMap();
+      m_mapDirty = false;
+   }
+}
+
 bool ossimImageElevationDatabase::loadMapFromKwl()
 {
 #if TRACE_TIME
@@ -433,36 +605,68 @@ bool ossimImageElevationDatabase::loadMapFromKwl()
       ossimFilename f = m_connectionString;
 
       f = f.dirCat( ossimFilename(ELEV_CELL_MAP ) );
+      ossimKeywordlist kwl;
+      bool loaded = false;
       if ( f.exists() )
       {
-         ossimKeywordlist kwl;
-         if ( kwl.addFile( f ) == true )
+         loaded = kwl.addFile( f );
+      }
+      else
+      {
+         std::lock_guard<std::mutex> lock(readOnlyMapsMutex);
+         std::map<std::string, ossimKeywordlist>::const_iterator m =
+            readOnlyMaps.find( m_connectionString.string() );
+         if ( m != readOnlyMaps.end() )
          {
-            ossimString regExp = "elev_cell[0-9]*\\.file";
-            ossim_uint32 count = kwl.getNumberOfKeysThatMatch( regExp );
-            const ossim_uint32 MAX_LOOKUP = count + 100; // To allow for skipage.
-            ossim_uint32 index = 0;
-            ossim_uint32 found = 0;
-            std::string basePrefix = "elev_cell";
-            std::string dot = ".";
-            std::string prefix;
-            while ( index < MAX_LOOKUP )
+            kwl = (*m).second;
+            loaded = true;
+         }
+      }
+      if ( loaded )
+      {
+         ossimString regExp = "elev_cell[0-9]*\\.file";
+         ossim_uint32 count = kwl.getNumberOfKeysThatMatch( regExp );
+         const ossim_uint32 MAX_LOOKUP = count + 100; // To allow for skipage.
+         ossim_uint32 index = 0;
+         ossim_uint32 found = 0;
+         std::string basePrefix = "elev_cell";
+         std::string dot = ".";
+         std::string prefix;
+         while ( index < MAX_LOOKUP )
+         {
+            prefix = basePrefix + ossimString::toString( index ).string() + dot;
+            ossimImageElevationFileEntry entry;
+            if ( entry.loadState( kwl, prefix ) == true )
+            {
+               // Add the file.
+               m_entryMap.insert( std::make_pair( m_lastMapKey++, entry ) );
+               ++found;
+               if ( found == count ) break;
+            }
+            ++index;
+         }
+
+         if ( m_entryMap.size() == count )
+         {
+            result = true;
+
+            // Maps written by older code have no directory times.  Walked again below.
+            basePrefix = "elev_dir";
+            for ( index = 0; true; ++index )
             {
                prefix = basePrefix + ossimString::toString( index ).string() + dot;
-               ossimImageElevationFileEntry entry;
-               if ( entry.loadState( kwl, prefix ) == true )
+               std::string dir = kwl.findKey( prefix, std::string(ossimKeywordNames::FILE_KW) );
+               if ( dir.empty() )
                {
-                  // Add the file.
-                  m_entryMap.insert( std::make_pair( m_lastMapKey++, entry ) );
-                  ++found;
-                  if ( found == count ) break;
+                  break;
                }
-               ++index;
+               m_dirModTimes[dir] =
+                  ossimString( kwl.findKey( prefix, std::string("mtime") ) ).toInt64();
             }
 
-            if ( m_entryMap.size() == count )
+            if ( refreshFileMap() )
             {
-               result = true;
+               m_mapDirty = true;
             }
          }
       }
@@ -497,47 +701,196 @@ void ossimImageElevationDatabase::loadFileMap()
       
       ossimFilename f = m_connectionString;
 
+      // Taken before the walk so a file added during it changes a time for next time:
+      m_dirModTimes.clear();
+      getDirModTimes( f, m_dirModTimes );
+
       // ossimFileWalker::walk will in turn call back to processFile method for each file it finds.
       fw->walk(f);
 
       // Save the state off for future.
+      m_mapDirty = true;
+      
+      delete fw;
+      fw = 0;
+   }
+
+#if TRACE_TIME
+   sw.stop();
+   ossimNotify(ossimNotifyLevel_NOTICE)
+      << "ossimImageElevationDatabase::loadFileMap() time in seconds: "
+      << std::fixed << std::setprecision(8) << sw.count() << "\n";
+#endif  
+}
+
+bool ossimImageElevationDatabase::refreshFileMap()
+{
+   bool changed = false;
+
+   std::map<ossim_uint64, ossimImageElevationFileEntry>::iterator i = m_entryMap.begin();
+   while ( i != m_entryMap.end() )
+   {
+      ossim_int64 modTime = getModTime( (*i).second.m_file );
+      if ( modTime == 0 )
+      {
+         if ( traceDebug() )
+         {
+            ossimNotify(ossimNotifyLevel_DEBUG)
+               << "ossimImageElevationDatabase::refreshFileMap DEBUG:\nRemoved: "
+               << (*i).second.m_file << "\n";
+         }
+         m_entryMap.erase( i++ );
+         changed = true;
+         continue;
+      }
+
+      if ( (*i).second.m_modTime == 0 )
+      {
+         // Map written before modification times were kept.  Take the rectangle as is.
+         (*i).second.m_modTime = modTime;
+         changed = true;
+      }
+      else if ( (*i).second.m_modTime != modTime )
+      {
+         // File changed. Recapture the rectangle.
+         (*i).second = ossimImageElevationFileEntry( (*i).second.m_file );
+         changed = true;
+      }
+      ++i;
+   }
+
+   //---
+   // Adding or removing a file or directory updates the modification time of the directory
+   // holding it.  If any directory changed walk again, only opening files not already mapped.
+   //---
+   bool walk = m_dirModTimes.empty();
+   for ( std::map<std::string, ossim_int64>::const_iterator d = m_dirModTimes.begin();
+         !walk && ( d != m_dirModTimes.end() ); ++d )
+   {
+      walk = ( getModTime( ossimFilename( (*d).first ) ) != (*d).second );
+   }
+   if ( walk )
+   {
+      ossimFilename dir = m_connectionString;
+
+      // Taken before the walk so a file added during it changes a time for next time:
+      m_dirModTimes.clear();
+      getDirModTimes( dir, m_dirModTimes );
+
+      for ( i = m_entryMap.begin(); i != m_entryMap.end(); ++i )
+      {
+         m_knownFiles.insert( (*i).second.m_file.string() );
+      }
+
+      ossimFileWalker* fw = new ossimFileWalker();
+      fw->initializeDefaultFilterList();
+      fw->setFileProcessor( this );
+      fw->walk( dir );
+      delete fw;
+      fw = 0;
+
+      m_knownFiles.clear();
+
+      // The new directory times are written even if no file was added:
+      changed = true;
+   }
+
+   return changed;
+}
+
+void ossimImageElevationDatabase::saveFileMap() const
+{
+   if ( m_connectionString.size() )
+   {
+      ossimFilename dir = m_connectionString;
+
       ossim_int32 index = 0;
       std::string basePrefix = "elev_cell";
       std::string dot = ".";
-      std::string prefix;
       ossimKeywordlist kwl;
-      const auto& cv = m_entryMap;
-      for (auto&& i : cv)
+      {
+         std::lock_guard<std::mutex> lock(m_unindexedMutex);
+         const auto& cv = m_entryMap;
+         for (auto&& i : cv)
+         {
+            std::string prefix = basePrefix + ossimString::toString(index).string() + dot;
+            i.second.saveState( kwl, prefix );
+            ++index;
+         }
+      }
+
+      index = 0;
+      basePrefix = "elev_dir";
+      for ( std::map<std::string, ossim_int64>::const_iterator d = m_dirModTimes.begin();
+            d != m_dirModTimes.end(); ++d )
       {
          std::string prefix = basePrefix + ossimString::toString(index).string() + dot;
-         i.second.saveState( kwl, prefix );
+         kwl.addPair( prefix, std::string(ossimKeywordNames::FILE_KW), (*d).first );
+         kwl.addPair( prefix, std::string("mtime"), ossimString::toString((*d).second).string() );
          ++index;
       }
-      f = m_connectionString;
-      f = f.dirCat( ossimFilename("elev_cell_map.kwl") );
-      if ( kwl.write( f ) == true )
+
+      if ( !dir.isWriteable() )
+      {
+         // Read only, e.g. a shared DEM tree.  Kept for the next open in this process, which
+         // checks the directory times against it like a map file.
+         if ( traceDebug() )
+         {
+            ossimNotify(ossimNotifyLevel_DEBUG)
+               << "ossimImageElevationDatabase::saveFileMap DEBUG:"
+               << "\nNot writable, map kept in memory: " << dir << "\n";
+         }
+         std::lock_guard<std::mutex> lock(readOnlyMapsMutex);
+         readOnlyMaps[ m_connectionString.string() ] = kwl;
+         return;
+      }
+
+      // Written aside and moved into place so another process opening the database never
+      // reads half a map:
+      ossimFilename f = dir.dirCat( ossimFilename(ELEV_CELL_MAP) );
+      ossimFilename tmp = ossim::getSidecarTempFile( f );
+      bool written = kwl.write( tmp.c_str() );
+      if ( !written )
+      {
+         tmp.remove();
+      }
+      if ( written && ossim::replaceFile( tmp, f ) )
       {
          ossimNotify(ossimNotifyLevel_NOTICE)
-            << "ossimImageElevationDatabase::loadFileMap() NOTICE:"
+            << "ossimImageElevationDatabase::saveFileMap() NOTICE:"
             << "\nWrote file: " << f << "\n";
       }
       else
       {
          ossimNotify(ossimNotifyLevel_WARN)
-            << "ossimImageElevationDatabase::loadFileMap() WARNING:"
+            << "ossimImageElevationDatabase::saveFileMap() WARNING:"
             << "\nCould not open file for write: " << f << std::endl;
       }
-      
-      delete fw;
-      fw = 0;
    }
+}
 
-#if TRACE_TIME
-   sw.stop();
-   ossimNotify(ossimNotifyLevel_NOTICE)
-      << "ossimImageElevationDatabase::loadFileMap() time in seconds: "
-      << std::fixed << std::setprecision(8) << sw.count() << "\n";
-#endif  
+void ossimImageElevationDatabase::buildIndex()
+{
+   m_entryIndex.clear();
+   std::lock_guard<std::mutex> lock(m_unindexedMutex);
+   m_unindexedIds.clear();
+
+   std::map<ossim_uint64, ossimImageElevationFileEntry>::const_iterator i = m_entryMap.begin();
+   while ( i != m_entryMap.end() )
+   {
+      const ossimGrect& rect = (*i).second.m_rect;
+      if ( rect.isLonLatNan() )
+      {
+         m_unindexedIds.push_back( (*i).first );
+      }
+      else
+      {
+         m_entryIndex.add( (*i).first, rect.ul().lon, rect.lr().lat, rect.lr().lon, rect.ul().lat );
+      }
+      ++i;
+   }
+
+   m_entryIndex.build();
 }
 
 // Hidden from use:
@@ -545,6 +898,8 @@ ossimImageElevationDatabase::ossimImageElevationDatabase(const ossimImageElevati
 : ossimElevationCellDatabase(copy)
 {
    m_entryMap = copy.m_entryMap;
+   m_entryIndex = copy.m_entryIndex;
+   m_unindexedIds = copy.m_unindexedIds;
    m_lastMapKey = copy.m_lastMapKey;
    m_lastAccessedId = copy.m_lastAccessedId;
 }
@@ -553,6 +908,7 @@ ossimImageElevationDatabase::ossimImageElevationDatabase(const ossimImageElevati
 ossimImageElevationDatabase::ossimImageElevationFileEntry::ossimImageElevationFileEntry()
    : m_file(),
      m_rect(),
+     m_modTime(0),
      // m_nominalGSD(),
      m_loadedFlag(false)
 {
@@ -565,6 +921,7 @@ ossimImageElevationDatabase::ossimImageElevationFileEntry::ossimImageElevationFi
    const ossimFilename& file)
    : m_file(file),
      m_rect(),
+     m_modTime(getModTime(file)),
      // m_nominalGSD(),
      m_loadedFlag(false)
 {
@@ -582,6 +939,7 @@ ossimImageElevationDatabase::ossimImageElevationFileEntry::ossimImageElevationFi
 (const ossimImageElevationFileEntry& copy_this)
    : m_file(copy_this.m_file),
      m_rect(copy_this.m_rect),
+     m_modTime(copy_this.m_modTime),
      // m_nominalGSD(copy_this.m_nominalGSD),
      m_loadedFlag(copy_this.m_loadedFlag)
 {
@@ -592,6 +950,7 @@ void ossimImageElevationDatabase::ossimImageElevationFileEntry::saveState(
 {
    kwl.addPair( prefix, std::string(ossimKeywordNames::FILE_KW), m_file.string() );
    kwl.addPair( prefix, std::string("grect"), m_rect.toString() );
+   kwl.addPair( prefix, std::string("mtime"), ossimString::toString(m_modTime).string() );
    // kwl.addPair( prefix, std::string("gsd"), m_nominalGSD.toString().string() );
 }
 
@@ -612,6 +971,11 @@ bool ossimImageElevationDatabase::ossimImageElevationFileEntry::loadState(
          if ( m_rect.toRect( value ) )
          {
             result = true;
+
+            // Optional, maps written by older code do not have it.
+            key = "mtime";
+            value = kwl.findKey( prefix, key );
+            m_modTime = value.size() ? ossimString(value).toInt64() : 0;
 #if 0
             key = "gsd";
             value = kwl.findKey( prefix, key );
@@ -39,7 +39,8 @@ ossimSrtmHandler::ossimSrtmHandler()
       m_latSpacing(0.0),
       m_lonSpacing(0.0),
       m_nwCornerPost(),
-      m_swapper(0)
+      m_swapper(0),
+      m_postBuf(0)
 {
 }
 
@@ -56,7 +57,7 @@ ossimSrtmHandler::~ossimSrtmHandler()
 double ossimSrtmHandler::getHeightAboveMSL(const ossimGpt& gpt)
 {
    if(!isOpen()) return ossim::nan();
-   if(!m_memoryMap.empty())
+   if(m_postBuf)
    {
       switch(m_scalarType)
       {
@@ -272,10 +273,10 @@ double ossimSrtmHandler::getHeightAboveMSLMemoryTemplate(T /* dummy */,
    // Grab the four points from the srtm cell needed.
    ossim_uint64 offset = y0 * m_srtmRecordSizeInBytes + x0 * sizeof(T);
    ossim_uint64 offset2 =offset+m_srtmRecordSizeInBytes;
-   T v00 = *(reinterpret_cast<T*> (&m_memoryMap[offset]));
-   T v01 = *(reinterpret_cast<T*> (&m_memoryMap[offset + sizeof(T)]));
-   T v10 = *(reinterpret_cast<T*> (&m_memoryMap[offset2]));
-   T v11 = *(reinterpret_cast<T*> (&m_memoryMap[offset2 + sizeof(T)]));
+   T v00 = *(reinterpret_cast<const T*> (m_postBuf + offset));
+   T v01 = *(reinterpret_cast<const T*> (m_postBuf + offset + sizeof(T)));
+   T v10 = *(reinterpret_cast<const T*> (m_postBuf + offset2));
+   T v11 = *(reinterpret_cast<const T*> (m_postBuf + offset2 + sizeof(T)));
    if (m_swapper)
    {
       m_swapper->swap(v00);
@@ -395,9 +396,19 @@ m_lonSpacing(src.m_lonSpacing),
 m_nwCornerPost(src.m_nwCornerPost),
 m_swapper(src.m_swapper?new ossimEndian:0),
 m_scalarType(src.m_scalarType),
-m_memoryMap(src.m_memoryMap)
+m_memoryMap(src.m_memoryMap),
+m_mappedFile(src.m_mappedFile),
+m_postBuf(0)
 {
-   if(m_memoryMap.empty()&&src.isOpen())
+   if(m_mappedFile)
+   {
+      m_postBuf = reinterpret_cast<const ossim_int8*>(m_mappedFile->getData());
+   }
+   else if(!m_memoryMap.empty())
+   {
+      m_postBuf = &m_memoryMap.front();
+   }
+   else if(src.isOpen())
    {
       m_fileStr.open(src.getFilename().c_str(),
                      std::ios::binary|std::ios::in);
@@ -406,7 +417,7 @@ m_memoryMap(src.m_memoryMap)
 
 bool ossimSrtmHandler::isOpen()const
 {
-   if(!m_memoryMap.empty()) return true;
+   if(m_postBuf) return true;
    
    std::lock_guard<std::mutex> lock(m_fileStrMutex);
    return m_streamOpen;
@@ -431,6 +442,9 @@ bool ossimSrtmHandler::open(const ossimFilename& file, bool memoryMapFlag)
       m_swapper = new ossimEndian();
    }
    m_streamOpen = false;
+   m_memoryMap.clear();
+   m_mappedFile.reset();
+   m_postBuf = 0;
    m_numberOfLines         = m_supportData.getNumberOfLines();
    m_numberOfSamples       = m_supportData.getNumberOfSamples();
    m_srtmRecordSizeInBytes = m_numberOfSamples * ossim::scalarSizeInBytes(m_scalarType);
@@ -459,8 +473,18 @@ bool ossimSrtmHandler::open(const ossimFilename& file, bool memoryMapFlag)
    
    if(memoryMapFlag)
    {
-      m_memoryMap.resize(theFilename.fileSize());
-      m_fileStr.read((char*)&m_memoryMap.front(), (streamsize)m_memoryMap.size());
+      // Shared read only mapping; read the whole cell if it cannot be mapped.
+      m_mappedFile = ossimMemoryMappedFile::open(theFilename);
+      if(m_mappedFile)
+      {
+         m_postBuf = reinterpret_cast<const ossim_int8*>(m_mappedFile->getData());
+      }
+      else
+      {
+         m_memoryMap.resize(theFilename.fileSize());
+         m_fileStr.read((char*)&m_memoryMap.front(), (streamsize)m_memoryMap.size());
+         m_postBuf = &m_memoryMap.front();
+      }
       m_fileStr.close();
    }
    m_streamOpen = true;
@@ -495,5 +519,7 @@ void ossimSrtmHandler::close()
 {
    m_fileStr.close();
    m_memoryMap.clear();
+   m_mappedFile.reset();
+   m_postBuf = 0;
    m_streamOpen = false;
 }
@@ -19,7 +19,7 @@
 #include <ossim/base/ossimTrace.h>
 
 ossimAppFixedTileCache* ossimAppFixedTileCache::theInstance = 0;
-ossimAppFixedTileCache::ossimAppFixedCacheId ossimAppFixedTileCache::theUniqueAppIdCounter = 0;
+std::atomic<ossimAppFixedTileCache::ossimAppFixedCacheId> ossimAppFixedTileCache::theUniqueAppIdCounter(0);
 const ossim_uint32 ossimAppFixedTileCache::DEFAULT_SIZE = 1024*1024*80;
 
 using namespace std;
@@ -27,35 +27,41 @@ using namespace std;
 static const ossimTrace traceDebug("ossimAppFixedTileCache:debug");
 std::ostream& operator <<(std::ostream& out, const ossimAppFixedTileCache& rhs)
 {
-   std::map<ossimAppFixedTileCache::ossimAppFixedCacheId, ossimFixedTileCache*>::const_iterator iter = rhs.theAppCacheMap.begin();
-
-   if(iter == rhs.theAppCacheMap.end())
-   {
-      ossimNotify(ossimNotifyLevel_NOTICE)
-         << "***** APP CACHE EMPTY *****" << endl;
-   }
-   else
+   bool empty = true;
+   for(ossim_uint32 idx = 0; idx < ossimAppFixedTileCache::SHARD_COUNT; ++idx)
    {
-      while(iter != rhs.theAppCacheMap.end())
+      const ossimAppFixedTileCache::CacheShard& shard = rhs.theShards[idx];
+      std::lock_guard<std::mutex> lock(shard.theMutex);
+      ossimAppFixedTileCache::CacheMap::const_iterator iter = shard.theCacheMap.begin();
+      while(iter != shard.theCacheMap.end())
       {
          out << "Cache id = "<< (*iter).first << " size = " << (*iter).second->getCacheSize() << endl;
+         empty = false;
          ++iter;
       }
    }
 
+   if(empty)
+   {
+      ossimNotify(ossimNotifyLevel_NOTICE)
+         << "***** APP CACHE EMPTY *****" << endl;
+   }
+
    return out;
 }
 
 
 ossimAppFixedTileCache::ossimAppFixedTileCache()
+   : theTileSize(64, 64),
+     theMaxCacheSize(0),
+     theMaxGlobalCacheSize(0),
+     theCurrentCacheSize(0)
 {
    if(traceDebug())
    {
       ossimNotify(ossimNotifyLevel_DEBUG) << "ossimAppFixedTileCache::ossimAppFixedTileCache() DEBUG: entered ..." << std::endl;
    }
    theInstance = this;
-   theTileSize = ossimIpt(64, 64);
-   theCurrentCacheSize = 0;
 
    // ossim::defaultTileSize(theTileSize);
    
@@ -120,58 +126,72 @@ ossimAppFixedTileCache *ossimAppFixedTileCache::instance(ossim_uint32  maxSize)
 
 void ossimAppFixedTileCache::setMaxCacheSize(ossim_uint32 cacheSize)
 {
-   std::lock_guard<std::mutex> lock(theMutex);
    theMaxGlobalCacheSize = cacheSize;
    theMaxCacheSize = cacheSize;
    //   theMaxCacheSize      = (ossim_uint32)(theMaxGlobalCacheSize*.2);
+
+   std::vector<ossimRefPtr<ossimFixedTileCache> > caches;
+   getCaches(caches);
+   for(ossim_uint32 idx = 0; idx < caches.size(); ++idx)
+   {
+      caches[idx]->setMaxCacheSize(cacheSize);
+   }
+   if(theCurrentCacheSize.load() > (ossim_int64)cacheSize)
+   {
+      shrinkGlobalCacheSize(theCurrentCacheSize.load() - (ossim_int64)(cacheSize*0.9));
+   }
+}
+
+ossim_uint64 ossimAppFixedTileCache::getCurrentCacheSize() const
+{
+   ossim_int64 size = theCurrentCacheSize.load();
+   return (size > 0) ? (ossim_uint64)size : 0;
 }
 
 void ossimAppFixedTileCache::flush()
 {
-   std::lock_guard<std::mutex> lock(theMutex);
-   std::map<ossimAppFixedCacheId, ossimFixedTileCache*>::iterator currentIter = theAppCacheMap.begin();
-   
-   while(currentIter != theAppCacheMap.end())
+   std::vector<ossimRefPtr<ossimFixedTileCache> > caches;
+   getCaches(caches);
+   for(ossim_uint32 idx = 0; idx < caches.size(); ++idx)
    {
-      (*currentIter).second->flush();
-      ++currentIter;
+      caches[idx]->flush();
    }
-   theCurrentCacheSize = 0;
 }
 
 void ossimAppFixedTileCache::flush(ossimAppFixedCacheId cacheId)
 {
-   std::lock_guard<std::mutex> lock(theMutex);
-   ossimFixedTileCache* cache = getCache(cacheId);
+   ossimRefPtr<ossimFixedTileCache> cache = getCache(cacheId);
+   if(cache.valid())
    {
-      if(cache)
-      {
-         theCurrentCacheSize -= cache->getCacheSize();
-         cache->flush();
-      }
+      cache->flush();
    }
 }
 
 void ossimAppFixedTileCache::deleteCache(ossimAppFixedCacheId cacheId)
 {
-   std::lock_guard<std::mutex> lock(theMutex);
-   ossimRefPtr<ossimFixedTileCache> cache = getCache(cacheId);
+   ossimRefPtr<ossimFixedTileCache> cache = 0;
    {
-      std::map<ossimAppFixedCacheId, ossimFixedTileCache*>::iterator iter = theAppCacheMap.find(cacheId);
-      
-      if(cache.valid())
+      CacheShard& shard = getShard(cacheId);
+      std::lock_guard<std::mutex> lock(shard.theMutex);
+      CacheMap::iterator iter = shard.theCacheMap.find(cacheId);
+      if(iter != shard.theCacheMap.end())
       {
-         theAppCacheMap.erase(iter);
-         theCurrentCacheSize -= cache->getCacheSize();
+         cache = (*iter).second;
+         shard.theCacheMap.erase(iter);
       }
-      cache = 0;
+   }
+
+   // Someone may still hold a reference so take its bytes off the total now:
+   if(cache.valid())
+   {
+      cache->setSizeCounter(0);
+      cache->flush();
    }
 }
 
 ossimAppFixedTileCache::ossimAppFixedCacheId ossimAppFixedTileCache::newTileCache(const ossimIrect& tileBoundaryRect,
                                                                                   const ossimIpt& tileSize)
 {
-   std::lock_guard<std::mutex> lock(theMutex);
    ossimAppFixedCacheId result = -1; 
    ossimFixedTileCache* newCache = new ossimFixedTileCache;
    if(tileSize.x == 0 ||
@@ -185,24 +205,16 @@ ossimAppFixedTileCache::ossimAppFixedCacheId ossimAppFixedTileCache::newTileCach
    {
       newCache->setRect(tileBoundaryRect, tileSize);
    }
-   result = theUniqueAppIdCounter;
-   theAppCacheMap.insert(std::make_pair(result, newCache));
-   ++theUniqueAppIdCounter;
+   result = theUniqueAppIdCounter++;
+   addCache(result, newCache);
    
    return result;
 }
 
 ossimAppFixedTileCache::ossimAppFixedCacheId ossimAppFixedTileCache::newTileCache()
 {
-   std::lock_guard<std::mutex> lock(theMutex);
-   ossimAppFixedCacheId result = -1;
-   ossimFixedTileCache* newCache = new ossimFixedTileCache;
-   
-   {
-      result = theUniqueAppIdCounter;
-      theAppCacheMap.insert(std::make_pair(result, newCache));
-      ++theUniqueAppIdCounter;
-   }
+   ossimAppFixedCacheId result = theUniqueAppIdCounter++;
+   addCache(result, new ossimFixedTileCache);
    
    return result;
    
@@ -211,29 +223,23 @@ ossimAppFixedTileCache::ossimAppFixedCacheId ossimAppFixedTileCache::newTileCach
 void ossimAppFixedTileCache::setRect(ossimAppFixedCacheId cacheId,
                                      const ossimIrect& boundaryTileRect)
 {
-   std::lock_guard<std::mutex> lock(theMutex);
-   ossimFixedTileCache* cache = getCache(cacheId);
-   if(cache)
+   ossimRefPtr<ossimFixedTileCache> cache = getCache(cacheId);
+   if(cache.valid())
    {
-      
-      ossim_uint32 cacheSize = cache->getCacheSize();
       // cache->setRect(boundaryTileRect, theTileSize);
       cache->setRect(boundaryTileRect,
                      cache->getTileSize());      
-      theCurrentCacheSize += (cache->getCacheSize() - cacheSize);
    }
 }
 
 void ossimAppFixedTileCache::setTileSize(ossimAppFixedCacheId cacheId,
                                          const ossimIpt& tileSize)
 {
-   std::lock_guard<std::mutex> lock(theMutex);
-   ossimFixedTileCache* cache = getCache(cacheId);
-   if(cache)
+   ossimRefPtr<ossimFixedTileCache> cache = getCache(cacheId);
+   if(cache.valid())
    {
-      ossim_uint32 cacheSize = cache->getCacheSize();
       cache->setRect(cache->getTileBoundaryRect(), tileSize);
-      theCurrentCacheSize += (cache->getCacheSize() - cacheSize);
+      std::lock_guard<std::mutex> lock(theMutex);
       theTileSize = cache->getTileSize();
    }
 }
@@ -242,10 +248,9 @@ ossimRefPtr<ossimImageData> ossimAppFixedTileCache::getTile(
    ossimAppFixedCacheId cacheId,
    const ossimIpt& origin)
 {
-   std::lock_guard<std::mutex> lock(theMutex);
    ossimRefPtr<ossimImageData> result = 0;
-   ossimFixedTileCache* cache = getCache(cacheId);
-   if(cache)
+   ossimRefPtr<ossimFixedTileCache> cache = getCache(cacheId);
+   if(cache.valid())
    {
       result = cache->getTile(origin);
    }
@@ -259,36 +264,21 @@ ossimRefPtr<ossimImageData> ossimAppFixedTileCache::addTile(
                                                             ossimRefPtr<ossimImageData> data,
                                                             bool duplicateData)
 {
-   std::lock_guard<std::mutex> lock(theMutex);
    ossimRefPtr<ossimImageData> result = 0;
-   ossimFixedTileCache *aCache = this->getCache(cacheId);
-   if(!aCache)
+   ossimRefPtr<ossimFixedTileCache> aCache = this->getCache(cacheId);
+   if(!aCache.valid() || !data.valid())
    {         
       return result;
    }
-   ossim_uint32 dataSize = data->getDataSizeInBytes();
 
-   if( (theCurrentCacheSize+dataSize) > theMaxGlobalCacheSize)
-   {
-      shrinkGlobalCacheSize((ossim_int32)(theMaxGlobalCacheSize*0.1));
-   }
+   // The cache keeps itself under theMaxCacheSize and updates the total:
+   result = aCache->addTile(data, duplicateData);
 
-   ossim_uint32 cacheSize = 0;
+   ossim_int64 maxGlobalCacheSize = theMaxGlobalCacheSize.load();
+   ossim_int64 currentCacheSize   = theCurrentCacheSize.load();
+   if(currentCacheSize > maxGlobalCacheSize)
    {
-      cacheSize = aCache->getCacheSize();
-   }
-   if(cacheSize > theMaxCacheSize)
-   {
-//       shrinkCacheSize(aCache,
-//                       (ossim_int32)(aCache->getCacheSize()*.1));
-      shrinkCacheSize(aCache,
-                      (ossim_int32)(1024*1024));
-   }
-   {
-      cacheSize = aCache->getCacheSize();
-      result    = aCache->addTile(data, duplicateData);
-   
-      theCurrentCacheSize += (aCache->getCacheSize() - cacheSize);
+      shrinkGlobalCacheSize(currentCacheSize - (ossim_int64)(maxGlobalCacheSize*0.9));
    }
    
    return result;
@@ -296,24 +286,30 @@ ossimRefPtr<ossimImageData> ossimAppFixedTileCache::addTile(
 
 void ossimAppFixedTileCache::deleteAll()
 {
-   std::lock_guard<std::mutex> lock(theMutex);
-   theCurrentCacheSize = 0;
-   theAppCacheMap.clear();
+   for(ossim_uint32 idx = 0; idx < SHARD_COUNT; ++idx)
+   {
+      CacheMap caches;
+      {
+         std::lock_guard<std::mutex> lock(theShards[idx].theMutex);
+         caches.swap(theShards[idx].theCacheMap);
+      }
+      for(CacheMap::iterator iter = caches.begin(); iter != caches.end(); ++iter)
+      {
+         (*iter).second->setSizeCounter(0);
+      }
+   }
 }
 
 ossimRefPtr<ossimImageData> ossimAppFixedTileCache::removeTile(
    ossimAppFixedCacheId cacheId,
    const ossimIpt& origin)
 {
-   std::lock_guard<std::mutex> lock(theMutex);
    ossimRefPtr<ossimImageData> result = 0;
    
-   ossimFixedTileCache* cache = getCache(cacheId);
-   if(cache)
+   ossimRefPtr<ossimFixedTileCache> cache = getCache(cacheId);
+   if(cache.valid())
    {
-      ossim_uint32 cacheSize = cache->getCacheSize();
       result = cache->removeTile(origin);
-      theCurrentCacheSize += (cache->getCacheSize() - cacheSize);
    }
 
    return result;
@@ -322,24 +318,22 @@ ossimRefPtr<ossimImageData> ossimAppFixedTileCache::removeTile(
 void ossimAppFixedTileCache::deleteTile(ossimAppFixedCacheId cacheId,
                                         const ossimIpt& origin)
 {
-   std::lock_guard<std::mutex> lock(theMutex);
-   ossimFixedTileCache* cache = getCache(cacheId);
-   if(cache)
+   ossimRefPtr<ossimFixedTileCache> cache = getCache(cacheId);
+   if(cache.valid())
    {
-      ossim_uint32 cacheSize = cache->getCacheSize();
       cache->deleteTile(origin);
-      theCurrentCacheSize += (cache->getCacheSize() - cacheSize);
    }
 }
 
-ossimFixedTileCache* ossimAppFixedTileCache::getCache(
+ossimRefPtr<ossimFixedTileCache> ossimAppFixedTileCache::getCache(
    ossimAppFixedCacheId cacheId)
 {   
-   std::map<ossimAppFixedCacheId, ossimFixedTileCache*>::const_iterator
-      currentIter = theAppCacheMap.find(cacheId);
-   ossimFixedTileCache* result = 0;
+   ossimRefPtr<ossimFixedTileCache> result = 0;
+   CacheShard& shard = getShard(cacheId);
+   std::lock_guard<std::mutex> lock(shard.theMutex);
+   CacheMap::const_iterator currentIter = shard.theCacheMap.find(cacheId);
    
-   if(currentIter != theAppCacheMap.end())
+   if(currentIter != shard.theCacheMap.end())
    {
       result = (*currentIter).second;
    }
@@ -347,30 +341,73 @@ ossimFixedTileCache* ossimAppFixedTileCache::getCache(
    return result;
 }
 
-void ossimAppFixedTileCache::shrinkGlobalCacheSize(ossim_int32 byteCount)
+ossimAppFixedTileCache::CacheShard& ossimAppFixedTileCache::getShard(
+   ossimAppFixedCacheId cacheId)
+{
+   return theShards[((ossim_uint32)cacheId) % SHARD_COUNT];
+}
+
+void ossimAppFixedTileCache::addCache(ossimAppFixedCacheId cacheId,
+                                      ossimFixedTileCache* cache)
+{
+   cache->setMaxCacheSize(theMaxCacheSize.load());
+   cache->setSizeCounter(&theCurrentCacheSize);
+
+   CacheShard& shard = getShard(cacheId);
+   std::lock_guard<std::mutex> lock(shard.theMutex);
+   shard.theCacheMap.insert(std::make_pair(cacheId, ossimRefPtr<ossimFixedTileCache>(cache)));
+}
+
+void ossimAppFixedTileCache::getCaches(
+   std::vector<ossimRefPtr<ossimFixedTileCache> >& caches)
+{
+   caches.clear();
+   for(ossim_uint32 idx = 0; idx < SHARD_COUNT; ++idx)
+   {
+      std::lock_guard<std::mutex> lock(theShards[idx].theMutex);
+      CacheMap::const_iterator iter = theShards[idx].theCacheMap.begin();
+      while(iter != theShards[idx].theCacheMap.end())
+      {
+         caches.push_back((*iter).second);
+         ++iter;
+      }
+   }
+}
+
+void ossimAppFixedTileCache::shrinkGlobalCacheSize(ossim_int64 byteCount)
 {
-   if(static_cast<ossim_uint32>(byteCount) >= theCurrentCacheSize)
+   // One evicting thread is enough, the others carry on:
+   std::unique_lock<std::mutex> shrinkLock(theShrinkMutex, std::try_to_lock);
+   if(!shrinkLock.owns_lock())
    {
-      flush();
+      return;
+   }
+
+   std::vector<ossimRefPtr<ossimFixedTileCache> > caches;
+   getCaches(caches);
+
+   if(byteCount >= theCurrentCacheSize.load())
+   {
+      for(ossim_uint32 idx = 0; idx < caches.size(); ++idx)
+      {
+         caches[idx]->flush();
+      }
    }
    else
    {
-      while(byteCount > 0)
+      // Take the oldest tile of each cache in turn until enough is freed:
+      bool freedSome = true;
+      while( (byteCount > 0) && freedSome )
       {
-         std::map<ossimAppFixedCacheId, ossimFixedTileCache*>::iterator iter = theAppCacheMap.begin();
-         while( (iter != theAppCacheMap.end())&&(byteCount>0))
+         freedSome = false;
+         for(ossim_uint32 idx = 0; (idx < caches.size()) && (byteCount > 0); ++idx)
          {
-            ossimFixedTileCache* cache = getCache((*iter).first);
-            if(cache)
+            ossim_uint32 delta = caches[idx]->evictLruTile();
+            if(delta)
             {
-               ossim_uint32 before = cache->getCacheSize();
-               cache->deleteTile();
-               ossim_uint32 after = cache->getCacheSize();
-               ossim_uint32 delta = (before - after);
                byteCount -= delta;
-               theCurrentCacheSize -= (delta);
+               freedSome = true;
             }
-            ++iter;
          }
       }
    }
@@ -379,11 +416,11 @@ void ossimAppFixedTileCache::shrinkGlobalCacheSize(ossim_int32 byteCount)
 void ossimAppFixedTileCache::shrinkCacheSize(ossimAppFixedCacheId id,
                                              ossim_int32 byteCount)
 {
-   ossimFixedTileCache* cache = getCache(id);
+   ossimRefPtr<ossimFixedTileCache> cache = getCache(id);
 
-   if(cache)
+   if(cache.valid())
    {
-      shrinkCacheSize(cache, byteCount);
+      shrinkCacheSize(cache.get(), byteCount);
    }
 }
 
@@ -401,14 +438,10 @@ void ossimAppFixedTileCache::shrinkCacheSize(ossimFixedTileCache* cache,
       {
          while(byteCount > 0)
          {
-            ossim_uint32 before = cache->getCacheSize();
-            cache->deleteTile();
-            ossim_uint32 after = cache->getCacheSize();
-            ossim_uint32 delta = std::abs((int)(before - after));
+            ossim_uint32 delta = cache->evictLruTile();
             if(delta)
             {
                byteCount -= delta;
-               theCurrentCacheSize -= (delta);
             }
             else
             {
@@ -421,9 +454,8 @@ void ossimAppFixedTileCache::shrinkCacheSize(ossimFixedTileCache* cache,
 
 const ossimIpt& ossimAppFixedTileCache::getTileSize(ossimAppFixedCacheId cacheId)
 {
-   std::lock_guard<std::mutex> lock(theMutex);
-   ossimFixedTileCache* cache = getCache(cacheId);
-   if(cache)
+   ossimRefPtr<ossimFixedTileCache> cache = getCache(cacheId);
+   if(cache.valid())
    {
       return cache->getTileSize();
    }
@@ -26,6 +26,7 @@
 #include <ossim/base/ossimDatum.h>
 #include <ossim/base/ossimNotify.h>
 #include <ossim/support_data/ossimRpfFrame.h>
+#include <ossim/support_data/ossimRpfFrameCache.h>
 #include <ossim/support_data/ossimRpfHeader.h>
 #include <ossim/support_data/ossimRpfToc.h>
 #include <ossim/support_data/ossimRpfTocEntry.h>
@@ -52,8 +53,6 @@ using namespace std;
 
 ossimCibCadrgTileSource::ossimCibCadrgTileSource()
    :ossimImageHandler(),
-    theCompressedBuffer(0),
-    theUncompressedBuffer(0),
     theNumberOfLines(0),
     theNumberOfSamples(0),
     theTile(0),
@@ -61,7 +60,6 @@ ossimCibCadrgTileSource::ossimCibCadrgTileSource()
     theEntryToRender(0),
     theEntryNumberToRender(1),
     theProductType(OSSIM_PRODUCT_TYPE_UNKNOWN),
-    theWorkFrame(0),
     theSkipEmptyCheck(false)
 {
    if (traceDebug())
@@ -73,38 +71,10 @@ ossimCibCadrgTileSource::ossimCibCadrgTileSource()
          << "OSSIM_ID:  " << OSSIM_ID << "\n";
 #endif      
    }
-
-   // Moved memory allocation to happen in first get tile. drb
-   
-   // theWorkFrame = new ossimRpfFrame;
-   
-   // a CADRG and CIBis a 64*64*12 bit buffer and must divide by 8 to
-   // convert to bytes
-   // theCompressedBuffer   = new ossim_uint8[(64*64*12)/8];
-
-   // whether CIB or CADRG we will alocate the buffer
-   // to the larger of the 2 (CADRG is 3 bands)
-   // theUncompressedBuffer = new ossim_uint8[256*256*3];
-                           
 }
 
 ossimCibCadrgTileSource::~ossimCibCadrgTileSource()
 {
-   if(theCompressedBuffer)
-   {
-      delete [] theCompressedBuffer;
-      theCompressedBuffer = 0;
-   }
-   if(theUncompressedBuffer)
-   {
-      delete [] theUncompressedBuffer;
-      theUncompressedBuffer = 0;
-   }
-   if(theWorkFrame)
-   {
-      delete theWorkFrame;
-      theWorkFrame = 0;
-   }
    close();
 }
 
@@ -287,47 +257,38 @@ bool ossimCibCadrgTileSource::getTile(ossimImageData* result,
 
       if (!status) // Did not get an overview tile.
       {
-         if ( !theCompressedBuffer )
-         {
-            // First time through.
-            allocateForProduct(); 
-         }
-
-         if ( theCompressedBuffer )
+         status = true;
+         
+         ossimIrect rect = result->getImageRectangle();
+         
+         ossimIrect imageRect = getImageRectangle();
+         
+         if ( rect.intersects(imageRect) )
          {
-            status = true;
+            //---
+            // Start with a blank tile in case there is not total coverage
+            // for rect.
+            //---
+            result->makeBlank();
             
-            ossimIrect rect = result->getImageRectangle();
-            
-            ossimIrect imageRect = getImageRectangle();
-            
-            if ( rect.intersects(imageRect) )
+            vector<ossimFrameEntryData> frames = getIntersectingEntries(rect);
+            if(frames.size() > 0)
             {
                //---
-               // Start with a blank tile in case there is not total coverage
-               // for rect.
+               // Now lets render each frame.  Note we will have to find
+               // subframes
+               // that intersect the rectangle of interest for each frame.
                //---
-               result->makeBlank();
+               fillTile(rect, frames, result);
                
-               vector<ossimFrameEntryData> frames = getIntersectingEntries(rect);
-               if(frames.size() > 0)
-               {
-                  //---
-                  // Now lets render each frame.  Note we will have to find
-                  // subframes
-                  // that intersect the rectangle of interest for each frame.
-                  //---
-                  fillTile(rect, frames, result);
-                  
-                  // Revalidate tile status.
-                  result->validate();
-               }
-            }
-            else
-            {
-               result->makeBlank();
+               // Revalidate tile status.
+               result->validate();
             }
          }
+         else
+         {
+            result->makeBlank();
+         }
       }
    }
    
@@ -727,312 +688,61 @@ void ossimCibCadrgTileSource::fillTile(
    const vector<ossimFrameEntryData>& framesInvolved,
    ossimImageData* tile)
 {
-   ossim_uint32 idx = 0;
-   for(idx = 0;
-       idx < framesInvolved.size();
-       ++idx)
-   {
+   const ossim_uint32 bands = (theProductType == OSSIM_PRODUCT_TYPE_CIB) ? 1 : 3;
 
-      if(theWorkFrame->parseFile(framesInvolved[idx].theFrameEntry.getFullPath())
-         == ossimErrorCodes::OSSIM_OK)
-      {
-         // we will fill a subtile.  We pass in which frame it is and the position of the frame.
-         // the actual pixel will be 1536*row and 1536 *col.
-         if(theProductType == OSSIM_PRODUCT_TYPE_CIB)
-         {
-            fillSubTileCib(*theWorkFrame,
-                           tileRect,
-                           framesInvolved[idx],
-                           tile);
-         }
-         else
-         {
-            fillSubTileCadrg(*theWorkFrame,
-                             tileRect,
-                             framesInvolved[idx],
-                             tile);
-         }
-      }
-   }
-}
-
-void ossimCibCadrgTileSource::fillSubTileCadrg(
-   const ossimRpfFrame&  aFrame,
-   const ossimIrect& tileRect,
-   const ossimFrameEntryData& frameEntryData,
-   ossimImageData* tile)
-{
-   // first let's grab the absolute position of the frame rectangle in pixel space
-   ossimIrect frameRect(frameEntryData.thePixelCol,
-                        frameEntryData.thePixelRow,
-                        frameEntryData.thePixelCol + CIBCADRG_FRAME_WIDTH  - 1,
-                        frameEntryData.thePixelRow + CIBCADRG_FRAME_HEIGHT - 1);
-
-   
-   // now clip it to the tile
-   ossimIrect clipRect = tileRect.clipToRect(frameRect);
-   
-   const ossimRpfCompressionSection* compressionSection = aFrame.getCompressionSection();
-   
-   if(!compressionSection)
+   // Gather the subframes of each frame that the tile touches.
+   vector<ossimRpfFrameCache::SubFrameRequest> requests;
+   vector<ossimIrect> subRects;
+   for(ossim_uint32 idx = 0; idx < framesInvolved.size(); ++idx)
    {
-      return;
-   }
+      const ossimFrameEntryData& frameEntryData = framesInvolved[idx];
 
-   const vector<ossimRpfColorGrayscaleTable>& colorTable =
-      aFrame.getColorGrayscaleTable();
+      // first let's grab the absolute position of the frame rectangle in pixel space
+      ossimIrect frameRect(frameEntryData.thePixelCol,
+                           frameEntryData.thePixelRow,
+                           frameEntryData.thePixelCol + CIBCADRG_FRAME_WIDTH  - 1,
+                           frameEntryData.thePixelRow + CIBCADRG_FRAME_HEIGHT - 1);
 
-   // ESH 03/2009 -- Partial fix for ticket #646.
-   // Crash fix on reading RPFs: Make sure the colorTable vector 
-   // has entries before trying to make use of them. 
-   int numTables = (int)colorTable.size();
-   if ( numTables <= 0 )
-   {
-      return;
-   }
+      // now clip it to the tile
+      ossimIrect clipRect = tileRect.clipToRect(frameRect);
 
-   ossim_uint8 *tempRows[3];
-   
-   tempRows[0] = theUncompressedBuffer;
-   tempRows[1] = (theUncompressedBuffer + 256*256);
-   tempRows[2] = (tempRows[1] + 256*256);
-   
-   // find the shift to 0,0
-   ossimIpt tempDelta(clipRect.ul().x - frameEntryData.thePixelCol,
-                      clipRect.ul().y - frameEntryData.thePixelRow);
-   
-   
-   // In order to compute the subframe we will need the corner offsets of
-   // the upper left of the frame and the upper left of the clip rect.  The
-   // clip rect should be completely within the frame.  This just translates the value
-   // to make the upper left of the frame be 0,0.
-   //
-   ossimIrect offsetRect(tempDelta.x,
-                         tempDelta.y,
-                         tempDelta.x + clipRect.width()-1,
-                         tempDelta.y + clipRect.height()-1);
-   
-   // each subframe is 64x64.  We will actually use 256x256 since
-   // we will be uncompressing them.  Note CADRG is a 256x256 tile
-   // compressed to 64x64x12 bit data
-   //
-    ossimIrect subFrameRect(offsetRect.ul().x/256,
-                            offsetRect.ul().y/256,
-                            (offsetRect.lr().x)/256,
-                            (offsetRect.lr().y)/256);
-   
-   ossim_uint32 readPtr  = 0;
-
-   ossim_int32 row = 0;
-   ossim_int32 col = 0;
-   ossim_uint32 i = 0;
-   ossim_uint32 j = 0;
-   ossim_int32 upperY = subFrameRect.lr().y;
-   ossim_int32 upperX = subFrameRect.lr().x;
-   ossim_int32 lowerY = subFrameRect.ul().y;
-   ossim_int32 lowerX = subFrameRect.ul().x; 
-   for(row = lowerY; row <= upperY; ++row)
-   {
-      for(col = lowerX; col <= upperX; ++col)
+      //---
+      // Each subframe is 256x256 pixels, compressed to 64x64x12 bit data.
+      // Translate the clip rect so the upper left of the frame is 0,0 and
+      // find the subframes it covers.
+      //---
+      ossimIrect subFrameRect((clipRect.ul().x - frameEntryData.thePixelCol)/256,
+                              (clipRect.ul().y - frameEntryData.thePixelRow)/256,
+                              (clipRect.lr().x - frameEntryData.thePixelCol)/256,
+                              (clipRect.lr().y - frameEntryData.thePixelRow)/256);
+
+      ossimRpfFrameCache::SubFrameRequest request;
+      request.file = frameEntryData.theFrameEntry.getFullPath();
+      for(ossim_int32 row = subFrameRect.ul().y; row <= subFrameRect.lr().y; ++row)
       {
-         readPtr = 0;
-         if(aFrame.fillSubFrameBuffer(theCompressedBuffer, 0, row, col))
-         {
-            for (i = 0; i < 256; i += 4)
-            {
-               for (j = 0; j < 256; j += 8)
-               {
-                  ossim_uint16 firstByte  = theCompressedBuffer[readPtr++] & 0xff;
-                  ossim_uint16 secondByte = theCompressedBuffer[readPtr++] & 0xff;
-                  ossim_uint16 thirdByte  = theCompressedBuffer[readPtr++] & 0xff;
-                  
-                  //because dealing with half-bytes is hard, we
-                  //uncompress two 4x4 tiles at the same time. (a
-                  //4x4 tile compressed is 12 bits )
-                  // this little code was grabbed from openmap software.
-                  
-                  /* Get first 12-bit value as index into VQ table */
-                  // I think we need to swap
-                  ossim_uint16 val1 = (firstByte << 4) | (secondByte >> 4);
-                  
-                  /* Get second 12-bit value as index into VQ table*/
-                  ossim_uint16 val2 = ((secondByte & 0x000F) << 8) | thirdByte;
-                  
-                  for (ossim_uint32 t = 0; t < 4; ++t)
-                  {
-                     for (ossim_uint32 e = 0; e < 4; ++e)
-                     {
-                        ossim_uint16 tableVal1 = compressionSection->getTable()[t].theData[val1*4 + e] & 0xff;
-                        ossim_uint16 tableVal2 = compressionSection->getTable()[t].theData[val2*4 + e] & 0xff;
-
-                        ossim_uint32 pixindex = ((i+t)*256) +
-                                                 (j + e);
-                        const ossim_uint8* color1 = colorTable[0].getStartOfData(tableVal1);
-                        const ossim_uint8* color2 = colorTable[0].getStartOfData(tableVal2);
-                        
-                        
-                        tempRows[0][pixindex] = color1[0];
-                        tempRows[1][pixindex] = color1[1];
-                        tempRows[2][pixindex] = color1[2];
-                        
-                        tempRows[0][pixindex+4] = color2[0];
-                        tempRows[1][pixindex+4] = color2[1];
-                        tempRows[2][pixindex+4] = color2[2];
-                     } //for e
-                  } //for t
-               }  /* for j */
-            } //for i
-         }
-         else
+         for(ossim_int32 col = subFrameRect.ul().x; col <= subFrameRect.lr().x; ++col)
          {
-            memset(theUncompressedBuffer, 0, 256*256*3);
+            request.row = row;
+            request.col = col;
+            requests.push_back(request);
+            subRects.push_back(ossimIrect(frameRect.ul().x + col*256,
+                                          frameRect.ul().y + row*256,
+                                          frameRect.ul().x + col*256 + 255,
+                                          frameRect.ul().y + row*256 + 255));
          }
-         ossim_int32 tempCol = col*256;
-         ossim_int32 tempRow = row*256;
-         ossimIrect subRectToFill(frameRect.ul().x + tempCol,
-                                  frameRect.ul().y + tempRow,
-                                  frameRect.ul().x + tempCol + 255,
-                                  frameRect.ul().y + tempRow + 255);
-         tile->loadTile(theUncompressedBuffer,
-                        subRectToFill,
-                        OSSIM_BSQ);
       }
    }
-}
-
-void ossimCibCadrgTileSource::fillSubTileCib(
-   const ossimRpfFrame&  aFrame,
-   const ossimIrect& tileRect,
-   const ossimFrameEntryData& frameEntryData,
-   ossimImageData* tile)
-{
-   // first let's grab the absolute position of the frame rectangle in pixel
-   // space
-   ossimIrect frameRect(frameEntryData.thePixelCol,
-                        frameEntryData.thePixelRow,
-                        frameEntryData.thePixelCol + CIBCADRG_FRAME_WIDTH  - 1,
-                        frameEntryData.thePixelRow + CIBCADRG_FRAME_HEIGHT - 1);
-
-   
-   // now clip it to the tile
-   ossimIrect clipRect = tileRect.clipToRect(frameRect);
-
-   const ossimRpfCompressionSection* compressionSection = aFrame.getCompressionSection();
-   
-   if(!compressionSection)
-   {
-      return;
-   }
-
-   const vector<ossimRpfColorGrayscaleTable>& colorTable =
-      aFrame.getColorGrayscaleTable();
 
-   // ESH 03/2009 -- Partial fix for ticket #646.
-   // Crash fix on reading RPFs: Make sure the colorTable vector 
-   // has entries before trying to make use of them. 
-   int numTables = (int)colorTable.size();
-   if ( numTables <= 0 )
-   {
-      return;
-   }
+   ossimRpfFrameCache::instance()->getSubFrames(requests, bands);
 
-   // check to see if it does overlap.  If it doesn't then the width and height
-   // will be a single point
+   // Frames that could not be parsed or decoded are left blank.
+   for(ossim_uint32 idx = 0; idx < requests.size(); ++idx)
    {
-      ossim_uint8 *tempRow;
-
-      tempRow = theUncompressedBuffer;
-      
-      // find the shift to 0,0
-      ossimIpt tempDelta(clipRect.ul().x - frameEntryData.thePixelCol,
-                         clipRect.ul().y - frameEntryData.thePixelRow);
-      
-      // In order to compute the subframe we will need the corner offsets of
-      // the upper left of the frame and the upper left of the clip rect.  The
-      // clip rect should be completely within the frame.  This just translates the value
-      // to make the upper left of the frame be 0,0.
-      //
-      ossimIrect offsetRect(tempDelta.x,
-                            tempDelta.y,
-                            tempDelta.x + clipRect.width()-1,
-                            tempDelta.y + clipRect.height()-1);
-
-      // each subframe is 64x64.  We will actually use 256x256 since
-      // we will be uncompressing them.  Note CADRG is a 256x256 tile
-      // compressed to 64x64x12 bit data
-      //
-      ossimIrect subFrameRect(offsetRect.ul().x/256,
-                              offsetRect.ul().y/256,
-                              (offsetRect.lr().x)/256,
-                              (offsetRect.lr().y)/256);
-
-      ossim_int32 row = 0;
-      ossim_int32 col = 0;
-      ossim_uint32 i = 0;
-      ossim_uint32 j = 0;
-      ossim_uint32 readPtr = 0;
-      for(row = subFrameRect.ul().y; row <= subFrameRect.lr().y; ++row)
+      if(requests[idx].data)
       {
-         for(col = subFrameRect.ul().x; col <= subFrameRect.lr().x; ++col)
-         {
-            readPtr = 0;
-            if(aFrame.fillSubFrameBuffer(theCompressedBuffer, 0, row, col))
-            {
-               for (i = 0; i < 256; i += 4)
-               {
-                  for (j = 0; j < 256; j += 8)
-                  {
-                     ossim_uint16 firstByte  = theCompressedBuffer[readPtr++] & 0xff;
-                     ossim_uint16 secondByte = theCompressedBuffer[readPtr++] & 0xff;
-                     ossim_uint16 thirdByte  = theCompressedBuffer[readPtr++] & 0xff;
-                     
-                     //because dealing with half-bytes is hard, we
-                     //uncompress two 4x4 tiles at the same time. (a
-                     //4x4 tile compressed is 12 bits )
-                     // this little code was grabbed from openmap software.
-                     
-                     /* Get first 12-bit value as index into VQ table */
-                     // I think we need to swap
-                     ossim_uint16 val1 = (firstByte << 4) | (secondByte >> 4);
-                     
-                     /* Get second 12-bit value as index into VQ table*/
-                     ossim_uint16 val2 = ((secondByte & 0x000F) << 8) | thirdByte;
-
-                     for (ossim_uint32 t = 0; t < 4; ++t)
-                     {
-                        for (ossim_uint32 e = 0; e < 4; ++e)
-                        {
-                           ossim_uint16 tableVal1 = compressionSection->getTable()[t].theData[val1*4 + e] & 0xff;
-                           ossim_uint16 tableVal2 = compressionSection->getTable()[t].theData[val2*4 + e] & 0xff;
-
-                           ossim_uint32 pixindex = ((i+t)*256) + (j + e);
-                           const ossim_uint8* color1 = colorTable[0].getStartOfData(tableVal1);
-                           const ossim_uint8* color2 = colorTable[0].getStartOfData(tableVal2);
-
-                           
-                           tempRow[pixindex]      = color1[0];
-                           tempRow[pixindex + 4]  = color2[0];
-                        } //for e
-                     } //for t
-                  }  /* for j */
-               } //for i
-            }
-            else
-            {
-               memset(theUncompressedBuffer, 0, 256*256);
-            }
-            ossim_int32 tCol = col*256;
-            ossim_int32 tRow = row*256;
-            ossimIrect subRectToFill(frameRect.ul().x + tCol,
-                                     frameRect.ul().y + tRow,
-                                     frameRect.ul().x + tCol + 255,
-                                     frameRect.ul().y + tRow + 255);
-            tile->loadTile(theUncompressedBuffer,
-                           subRectToFill,
-                           OSSIM_BSQ);
-         }
+         tile->loadTile(&requests[idx].data->front(), subRects[idx], OSSIM_BSQ);
       }
-   }  
+   }
 }
 
 void ossimCibCadrgTileSource::allocateForProduct()
@@ -1042,36 +752,6 @@ void ossimCibCadrgTileSource::allocateForProduct()
       return;
    }
 
-   if ( theWorkFrame )
-   {
-      delete theWorkFrame;
-   }  
-   theWorkFrame = new ossimRpfFrame;
-
-   if(theCompressedBuffer)
-   {
-      delete [] theCompressedBuffer;
-   }
-
-   //---
-   // A CADRG and CIBis a 64*64*12 bit buffer and must divide by 8 to convert
-   // to bytes.
-   //---
-   theCompressedBuffer   = new ossim_uint8[(64*64*12)/8];
-   
-   if(theUncompressedBuffer)
-   {
-      delete [] theUncompressedBuffer;
-   }
-   if(theProductType == OSSIM_PRODUCT_TYPE_CIB)
-   {
-      theUncompressedBuffer = new ossim_uint8[256*256];
-   }
-   else
-   {
-      theUncompressedBuffer = new ossim_uint8[256*256*3];
-   }   
-   
    theTile = ossimImageDataFactory::instance()->create(this, this);
    theTile->initialize();
 }
@@ -0,0 +1,189 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/imaging/ossimDeferredImageHandlerFactory.h>
+#include <ossim/imaging/ossimImageHandlerRegistry.h>
+#include <ossim/base/ossimKeywordNames.h>
+#include <ossim/base/ossimKeywordlist.h>
+
+RTTI_DEF1(ossimDeferredImageHandlerFactory, "ossimDeferredImageHandlerFactory",
+          ossimImageHandlerFactoryBase);
+
+ossimDeferredImageHandlerFactory::ossimDeferredImageHandlerFactory(
+   std::shared_ptr<ossimDeferredPlugin> plugin)
+   :
+   ossimImageHandlerFactoryBase(),
+   m_plugin(plugin),
+   m_services(plugin->getEntry().imageHandlers),
+   m_registrations(),
+   m_previousCapture(0)
+{
+   m_plugin->addListener( this );
+}
+
+const ossimDeferredImageHandlerFactory::RegistrationList&
+ossimDeferredImageHandlerFactory::load(const ossimString& reason)const
+{
+   m_plugin->load( reason );
+   return m_registrations;
+}
+
+void ossimDeferredImageHandlerFactory::beginLoad()
+{
+   m_previousCapture = ossimImageHandlerRegistry::instance()->setCaptureList( &m_registrations );
+}
+
+void ossimDeferredImageHandlerFactory::endLoad()
+{
+   ossimImageHandlerRegistry::instance()->setCaptureList( m_previousCapture );
+   m_previousCapture = 0;
+}
+
+ossimImageHandler* ossimDeferredImageHandlerFactory::open(const ossimFilename& fileName,
+                                                          bool openOverview)const
+{
+   ossimImageHandler* result = 0;
+   const RegistrationList& factories = load( fileName );
+   for ( std::size_t i = 0; ( i < factories.size() ) && !result; ++i )
+   {
+      result = factories[i].factory->open( fileName, openOverview );
+   }
+   return result;
+}
+
+ossimImageHandler* ossimDeferredImageHandlerFactory::open(const ossimKeywordlist& kwl,
+                                                          const char* prefix)const
+{
+   ossimImageHandler* result = 0;
+   if ( m_services.mayCreate( kwl, prefix ) )
+   {
+      const RegistrationList& factories = load( kwl.find( prefix, ossimKeywordNames::TYPE_KW ) );
+      for ( std::size_t i = 0; ( i < factories.size() ) && !result; ++i )
+      {
+         result = factories[i].factory->open( kwl, prefix );
+      }
+   }
+   return result;
+}
+
+ossimRefPtr<ossimImageHandler> ossimDeferredImageHandlerFactory::open(
+   std::shared_ptr<ossim::istream>& str, const std::string& connectionString,
+   bool openOverview)const
+{
+   ossimRefPtr<ossimImageHandler> result = 0;
+   const RegistrationList& factories = load( connectionString );
+   for ( std::size_t i = 0; ( i < factories.size() ) && !result.valid(); ++i )
+   {
+      result = factories[i].factory->open( str, connectionString, openOverview );
+   }
+   return result;
+}
+
+ossimRefPtr<ossimImageHandler> ossimDeferredImageHandlerFactory::open(
+   std::shared_ptr<ossim::ImageHandlerState> state)const
+{
+   ossimRefPtr<ossimImageHandler> result = 0;
+   if ( state && m_services.hasType( state->getImageHandlerType() ) )
+   {
+      const RegistrationList& factories = load( state->getImageHandlerType() );
+      for ( std::size_t i = 0; ( i < factories.size() ) && !result.valid(); ++i )
+      {
+         result = factories[i].factory->open( state );
+      }
+   }
+   return result;
+}
+
+ossimRefPtr<ossimImageHandler> ossimDeferredImageHandlerFactory::openOverview(
+   const ossimFilename& file)const
+{
+   ossimRefPtr<ossimImageHandler> result = 0;
+   const RegistrationList& factories = load( file );
+   for ( std::size_t i = 0; ( i < factories.size() ) && !result.valid(); ++i )
+   {
+      result = factories[i].factory->openOverview( file );
+   }
+   return result;
+}
+
+ossimRefPtr<ossimImageHandler> ossimDeferredImageHandlerFactory::openOverview(
+   std::shared_ptr<ossim::istream>& str, const ossimString& connectionString)const
+{
+   ossimRefPtr<ossimImageHandler> result = 0;
+   const RegistrationList& factories = load( connectionString );
+   for ( std::size_t i = 0; ( i < factories.size() ) && !result.valid(); ++i )
+   {
+      result = factories[i].factory->openOverview( str, connectionString );
+   }
+   return result;
+}
+
+void ossimDeferredImageHandlerFactory::getImageHandlersBySuffix(ImageHandlerList& result,
+                                                                const ossimString& ext)const
+{
+   if ( m_services.hasExtension( ext ) )
+   {
+      const RegistrationList& factories = load( ossimString("extension ") + ext );
+      for ( std::size_t i = 0; i < factories.size(); ++i )
+      {
+         factories[i].factory->getImageHandlersBySuffix( result, ext );
+      }
+   }
+}
+
+void ossimDeferredImageHandlerFactory::getImageHandlersByMimeType(
+   ImageHandlerList& result, const ossimString& mimeType)const
+{
+   const RegistrationList& factories = load( mimeType );
+   for ( std::size_t i = 0; i < factories.size(); ++i )
+   {
+      factories[i].factory->getImageHandlersByMimeType( result, mimeType );
+   }
+}
+
+void ossimDeferredImageHandlerFactory::getSupportedExtensions(UniqueStringList& extensionList)const
+{
+   for ( std::size_t i = 0; i < m_services.extensions.size(); ++i )
+   {
+      extensionList.push_back( m_services.extensions[i] );
+   }
+}
+
+ossimObject* ossimDeferredImageHandlerFactory::createObject(const ossimString& typeName)const
+{
+   ossimObject* result = 0;
+   if ( m_services.hasType( typeName ) )
+   {
+      const RegistrationList& factories = load( typeName );
+      for ( std::size_t i = 0; ( i < factories.size() ) && !result; ++i )
+      {
+         result = factories[i].factory->createObject( typeName );
+      }
+   }
+   return result;
+}
+
+ossimObject* ossimDeferredImageHandlerFactory::createObject(const ossimKeywordlist& kwl,
+                                                            const char* prefix)const
+{
+   ossimObject* result = 0;
+   if ( m_services.mayCreate( kwl, prefix ) )
+   {
+      const RegistrationList& factories = load( kwl.find( prefix, ossimKeywordNames::TYPE_KW ) );
+      for ( std::size_t i = 0; ( i < factories.size() ) && !result; ++i )
+      {
+         result = factories[i].factory->createObject( kwl, prefix );
+      }
+   }
+   return result;
+}
+
+void ossimDeferredImageHandlerFactory::getTypeNameList(std::vector<ossimString>& typeList)const
+{
+   typeList.insert( typeList.end(), m_services.types.begin(), m_services.types.end() );
+}
@@ -0,0 +1,151 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/imaging/ossimDeferredImageWriterFactory.h>
+#include <ossim/imaging/ossimImageWriterFactoryRegistry.h>
+#include <ossim/imaging/ossimImageFileWriter.h>
+#include <ossim/base/ossimKeywordNames.h>
+#include <ossim/base/ossimKeywordlist.h>
+
+RTTI_DEF1(ossimDeferredImageWriterFactory, "ossimDeferredImageWriterFactory",
+          ossimImageWriterFactoryBase);
+
+ossimDeferredImageWriterFactory::ossimDeferredImageWriterFactory(
+   std::shared_ptr<ossimDeferredPlugin> plugin)
+   :
+   ossimImageWriterFactoryBase(),
+   m_plugin(plugin),
+   m_services(plugin->getEntry().imageWriters),
+   m_registrations(),
+   m_previousCapture(0)
+{
+   m_plugin->addListener( this );
+}
+
+const ossimDeferredImageWriterFactory::RegistrationList&
+ossimDeferredImageWriterFactory::load(const ossimString& reason)const
+{
+   m_plugin->load( reason );
+   return m_registrations;
+}
+
+bool ossimDeferredImageWriterFactory::mayCreate(const ossimString& typeName)const
+{
+   return m_services.hasType( typeName ) || typeName.contains( "/" );
+}
+
+void ossimDeferredImageWriterFactory::beginLoad()
+{
+   m_previousCapture =
+      ossimImageWriterFactoryRegistry::instance()->setCaptureList( &m_registrations );
+}
+
+void ossimDeferredImageWriterFactory::endLoad()
+{
+   ossimImageWriterFactoryRegistry::instance()->setCaptureList( m_previousCapture );
+   m_previousCapture = 0;
+}
+
+ossimImageFileWriter* ossimDeferredImageWriterFactory::createWriter(const ossimKeywordlist& kwl,
+                                                                    const char *prefix)const
+{
+   ossimImageFileWriter* result = 0;
+   if ( m_services.mayCreate( kwl, prefix ) )
+   {
+      const RegistrationList& factories = load( kwl.find( prefix, ossimKeywordNames::TYPE_KW ) );
+      for ( std::size_t i = 0; ( i < factories.size() ) && !result; ++i )
+      {
+         result = factories[i].factory->createWriter( kwl, prefix );
+      }
+   }
+   return result;
+}
+
+ossimImageFileWriter* ossimDeferredImageWriterFactory::createWriter(
+   const ossimString& typeName)const
+{
+   ossimImageFileWriter* result = 0;
+   if ( mayCreate( typeName ) )
+   {
+      const RegistrationList& factories = load( typeName );
+      for ( std::size_t i = 0; ( i < factories.size() ) && !result; ++i )
+      {
+         result = factories[i].factory->createWriter( typeName );
+      }
+   }
+   return result;
+}
+
+void ossimDeferredImageWriterFactory::getExtensions(std::vector<ossimString>& result)const
+{
+   result.insert( result.end(), m_services.extensions.begin(), m_services.extensions.end() );
+}
+
+void ossimDeferredImageWriterFactory::getImageTypeList(
+   std::vector<ossimString>& imageTypeList)const
+{
+   imageTypeList.insert( imageTypeList.end(),
+                         m_services.imageTypes.begin(), m_services.imageTypes.end() );
+}
+
+void ossimDeferredImageWriterFactory::getImageFileWritersBySuffix(ImageFileWriterList& result,
+                                                                  const ossimString& ext)const
+{
+   if ( m_services.hasExtension( ext ) )
+   {
+      const RegistrationList& factories = load( ossimString("extension ") + ext );
+      for ( std::size_t i = 0; i < factories.size(); ++i )
+      {
+         factories[i].factory->getImageFileWritersBySuffix( result, ext );
+      }
+   }
+}
+
+void ossimDeferredImageWriterFactory::getImageFileWritersByMimeType(
+   ImageFileWriterList& result, const ossimString& mimeType)const
+{
+   const RegistrationList& factories = load( mimeType );
+   for ( std::size_t i = 0; i < factories.size(); ++i )
+   {
+      factories[i].factory->getImageFileWritersByMimeType( result, mimeType );
+   }
+}
+
+ossimObject* ossimDeferredImageWriterFactory::createObject(const ossimString& typeName)const
+{
+   ossimObject* result = 0;
+   if ( mayCreate( typeName ) )
+   {
+      const RegistrationList& factories = load( typeName );
+      for ( std::size_t i = 0; ( i < factories.size() ) && !result; ++i )
+      {
+         result = factories[i].factory->createObject( typeName );
+      }
+   }
+   return result;
+}
+
+ossimObject* ossimDeferredImageWriterFactory::createObject(const ossimKeywordlist& kwl,
+                                                           const char* prefix)const
+{
+   ossimObject* result = 0;
+   if ( m_services.mayCreate( kwl, prefix ) )
+   {
+      const RegistrationList& factories = load( kwl.find( prefix, ossimKeywordNames::TYPE_KW ) );
+      for ( std::size_t i = 0; ( i < factories.size() ) && !result; ++i )
+      {
+         result = factories[i].factory->createObject( kwl, prefix );
+      }
+   }
+   return result;
+}
+
+void ossimDeferredImageWriterFactory::getTypeNameList(std::vector<ossimString>& typeList)const
+{
+   typeList.insert( typeList.end(), m_services.types.begin(), m_services.types.end() );
+}
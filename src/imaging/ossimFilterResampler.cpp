@@ -23,8 +23,242 @@
 #include <ossim/base/ossimDrect.h>
 #include <ossim/imaging/ossimFilterTable.h>
 
+#if defined(__x86_64__) || defined(_M_X64)
+#  define OSSIM_FILTER_RESAMPLER_X86 1
+#  include <immintrin.h>
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#    define OSSIM_TARGET_AVX2
+#  else
+#    define OSSIM_TARGET_AVX2 __attribute__((target("avx2")))
+#  endif
+#endif
+#include <cstring>
+
 using namespace std;
 
+//---
+// Kernel accumulators for the interior fast path of resampleBilinearTile.
+//
+// Each sums one band of one output pixel: "rows" rows of "stride" input taps
+// starting at src, weighted by the padded float filter table.  Taps equal to
+// the null value are left out of both the pixel and the density sums, the
+// same as the scalar path.  Callers guarantee that the whole padded kernel
+// lies inside the input tile so no per tap bounds checks are needed.
+//
+// Taps of a single output pixel go in the vector lanes.  Neighboring output
+// pixels map to arbitrary input positions so spreading them across lanes
+// would need gathers.
+//---
+namespace
+{
+#ifdef OSSIM_FILTER_RESAMPLER_X86
+
+   inline __m128i load4Sse2(const ossim_uint8* src)
+   {
+      ossim_int32 bytes;
+      std::memcpy(&bytes, src, sizeof(bytes));
+      __m128i zero = _mm_setzero_si128();
+      return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero), zero);
+   }
+
+   inline __m128i load4Sse2(const ossim_uint16* src)
+   {
+      return _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src)),
+                                _mm_setzero_si128());
+   }
+
+   inline float horizontalSum(__m128 v)
+   {
+      __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+      __m128 sums = _mm_add_ps(v, shuf);
+      shuf = _mm_movehl_ps(shuf, sums);
+      return _mm_cvtss_f32(_mm_add_ss(sums, shuf));
+   }
+
+   /** SSE2, always present on x86_64.  Four taps per step. */
+   template <class T>
+   void accumulateSse2(const T* src, ossim_uint32 inWidth,
+                       const float* weights, ossim_uint32 stride,
+                       ossim_uint32 rows, float nullPix,
+                       float& pixel, float& density)
+   {
+      const __m128 vnull = _mm_set1_ps(nullPix);
+      __m128 pix = _mm_setzero_ps();
+      __m128 den = _mm_setzero_ps();
+      for(ossim_uint32 iy = 0; iy < rows; ++iy)
+      {
+         for(ossim_uint32 ix = 0; ix < stride; ix += 4)
+         {
+            __m128 value = _mm_cvtepi32_ps(load4Sse2(src + ix));
+            __m128 w = _mm_and_ps(_mm_loadu_ps(weights + ix), _mm_cmpneq_ps(value, vnull));
+            pix = _mm_add_ps(pix, _mm_mul_ps(value, w));
+            den = _mm_add_ps(den, w);
+         }
+         src += inWidth;
+         weights += stride;
+      }
+      pixel = horizontalSum(pix);
+      density = horizontalSum(den);
+   }
+
+   OSSIM_TARGET_AVX2 inline __m256i load8Avx2(const ossim_uint8* src)
+   {
+      return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src)));
+   }
+
+   OSSIM_TARGET_AVX2 inline __m256i load8Avx2(const ossim_uint16* src)
+   {
+      return _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+   }
+
+   /** Two rows of four taps. */
+   OSSIM_TARGET_AVX2 inline __m256i load4x2Avx2(const ossim_uint8* src0, const ossim_uint8* src1)
+   {
+      ossim_int32 bytes0, bytes1;
+      std::memcpy(&bytes0, src0, sizeof(bytes0));
+      std::memcpy(&bytes1, src1, sizeof(bytes1));
+      return _mm256_cvtepu8_epi32(_mm_unpacklo_epi32(_mm_cvtsi32_si128(bytes0),
+                                                     _mm_cvtsi32_si128(bytes1)));
+   }
+
+   OSSIM_TARGET_AVX2 inline __m256i load4x2Avx2(const ossim_uint16* src0, const ossim_uint16* src1)
+   {
+      return _mm256_cvtepu16_epi32(
+         _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src0)),
+                            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src1))));
+   }
+
+   OSSIM_TARGET_AVX2 inline float horizontalSumAvx2(__m256 v)
+   {
+      __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+      __m128 shuf = _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(2, 3, 0, 1));
+      sum = _mm_add_ps(sum, shuf);
+      shuf = _mm_movehl_ps(shuf, sum);
+      return _mm_cvtss_f32(_mm_add_ss(sum, shuf));
+   }
+
+   /**
+    * AVX2.  Eight taps per step; a stride of four (bilinear, cubic) takes two
+    * rows per step.  Kernel heights are always even.
+    */
+   template <class T>
+   OSSIM_TARGET_AVX2 void accumulateAvx2(const T* src, ossim_uint32 inWidth,
+                                         const float* weights, ossim_uint32 stride,
+                                         ossim_uint32 rows, float nullPix,
+                                         float& pixel, float& density)
+   {
+      const __m256 vnull = _mm256_set1_ps(nullPix);
+      __m256 pix = _mm256_setzero_ps();
+      __m256 den = _mm256_setzero_ps();
+      if(stride == 4)
+      {
+         for(ossim_uint32 iy = 0; iy < rows; iy += 2)
+         {
+            __m256 value = _mm256_cvtepi32_ps(load4x2Avx2(src, src + inWidth));
+            __m256 w = _mm256_and_ps(_mm256_loadu_ps(weights),
+                                     _mm256_cmp_ps(value, vnull, _CMP_NEQ_UQ));
+            pix = _mm256_add_ps(pix, _mm256_mul_ps(value, w));
+            den = _mm256_add_ps(den, w);
+            src += 2*inWidth;
+            weights += 8;
+         }
+      }
+      else
+      {
+         for(ossim_uint32 iy = 0; iy < rows; ++iy)
+         {
+            ossim_uint32 ix = 0;
+            for(; ix + 8 <= stride; ix += 8)
+            {
+               __m256 value = _mm256_cvtepi32_ps(load8Avx2(src + ix));
+               __m256 w = _mm256_and_ps(_mm256_loadu_ps(weights + ix),
+                                        _mm256_cmp_ps(value, vnull, _CMP_NEQ_UQ));
+               pix = _mm256_add_ps(pix, _mm256_mul_ps(value, w));
+               den = _mm256_add_ps(den, w);
+            }
+            if(ix < stride)
+            {
+               // Four left over; zero extended into the upper lanes.
+               __m256 value = _mm256_cvtepi32_ps(
+                  _mm256_castsi128_si256(load4Sse2(src + ix)));
+               __m256 w = _mm256_and_ps(
+                  _mm256_castps128_ps256(_mm_loadu_ps(weights + ix)),
+                  _mm256_cmp_ps(value, vnull, _CMP_NEQ_UQ));
+               w = _mm256_insertf128_ps(w, _mm_setzero_ps(), 1);
+               pix = _mm256_add_ps(pix, _mm256_mul_ps(value, w));
+               den = _mm256_add_ps(den, w);
+            }
+            src += inWidth;
+            weights += stride;
+         }
+      }
+      pixel = horizontalSumAvx2(pix);
+      density = horizontalSumAvx2(den);
+   }
+
+   bool cpuHasAvx2()
+   {
+#if defined(_MSC_VER)
+      int info[4];
+      __cpuid(info, 0);
+      if(info[0] < 7)
+      {
+         return false;
+      }
+      __cpuid(info, 1);
+      const bool osxsave = (info[2] & (1 << 27)) != 0;
+      __cpuidex(info, 7, 0);
+      const bool avx2 = (info[1] & (1 << 5)) != 0;
+      return osxsave && avx2 && ((_xgetbv(0) & 6) == 6);
+#else
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2") != 0;
+#endif
+   }
+
+#endif /* End of "#ifdef OSSIM_FILTER_RESAMPLER_X86" */
+
+   template <class T> struct AccumulatorFunction
+   {
+      typedef void (*Type)(const T*, ossim_uint32, const float*, ossim_uint32,
+                           ossim_uint32, float, float&, float&);
+   };
+
+   /** Accumulator for a SIMD level. */
+   template <class T> struct SimdAccumulator
+   {
+      typedef typename AccumulatorFunction<T>::Type Function;
+      static Function get(ossimFilterResampler::SimdLevel level)
+      {
+#ifdef OSSIM_FILTER_RESAMPLER_X86
+         if(level == ossimFilterResampler::SIMD_AVX2)
+         {
+            return &accumulateAvx2<T>;
+         }
+         if(level == ossimFilterResampler::SIMD_SSE2)
+         {
+            return &accumulateSse2<T>;
+         }
+#endif
+         return 0;
+      }
+   };
+
+   /**
+    * get() returns 0 for scalar types without a fast path, or for SIMD_NONE,
+    * in which case resampleBilinearTile does everything the old way.
+    */
+   template <class T> struct FastAccumulator
+   {
+      typedef typename AccumulatorFunction<T>::Type Function;
+      static Function get(ossimFilterResampler::SimdLevel) { return 0; }
+   };
+
+   template <> struct FastAccumulator<ossim_uint8> : public SimdAccumulator<ossim_uint8> {};
+   template <> struct FastAccumulator<ossim_uint16> : public SimdAccumulator<ossim_uint16> {};
+}
+
 ossimFilterResampler::ossimFilterResampler()
    :theMinifyFilter(new ossimNearestNeighborFilter()),
     theMagnifyFilter(new ossimNearestNeighborFilter()),
@@ -32,7 +266,8 @@ ossimFilterResampler::ossimFilterResampler()
     theMagnifyFilterType(ossimFilterResampler_NEAREST_NEIGHBOR),
     theScaleFactor(1.0, 1.0),
     theInverseScaleFactor(1.0, 1.0),
-    theBlurFactor(1.0)
+    theBlurFactor(1.0),
+    theSimdLevel(getMaxSimdLevel())
 {
    setScaleFactor(ossimDpt(1.0, 1.0));
    loadState(ossimPreferences::instance()->preferencesKWL(),"resampler.");
@@ -345,6 +580,7 @@ template <class T> void ossimFilterResampler::resampleBilinearTile(
 
    // INPUT INFORMATION
    ossim_uint32       inWidth      = input->getWidth();
+   ossim_uint32       inHeight     = input->getHeight();
    ossim_uint32       inBandSize   = input->getSizePerBand();  // fix for out-of-bounds check OLK 06/2005
    ossim_uint32       BANDS        = input->getNumberOfBands();
    ossimIrect         inputRect    = input->getImageRectangle();
@@ -384,6 +620,12 @@ template <class T> void ossimFilterResampler::resampleBilinearTile(
    double xkernel_half_width   = theFilterTable.getXSupport();
    double ykernel_half_height  = theFilterTable.getYSupport();
 
+   // Vectorized kernel for pixels whose padded kernel is fully inside the input.
+   typename FastAccumulator<T>::Function fastAccumulator = FastAccumulator<T>::get(theSimdLevel);
+   ossim_int32 fastMaxStartX =
+      (ossim_int32)inWidth - (ossim_int32)theFilterTable.getFloatRowStride();
+   ossim_int32 fastMaxStartY = (ossim_int32)inHeight - (ossim_int32)ykernel_height;
+
    double initialx  = inputUl.x-inputRect.ul().x;
    double initialy  = inputUl.y-inputRect.ul().y;
    double terminalx = inputUr.x-inputRect.ul().x;
@@ -472,6 +714,31 @@ template <class T> void ossimFilterResampler::resampleBilinearTile(
                   resultBuf[band][resultX] = static_cast<T>(NULL_PIX[band]);
                }
             }
+            else if ( fastAccumulator &&
+                      (startx >= 0) && (startx <= fastMaxStartX) &&
+                      (starty >= 0) && (starty <= fastMaxStartY) )
+            {
+               const float* weights = theFilterTable.getClosestFloatWeights(pointx,pointy);
+               const ossim_uint32 stride = theFilterTable.getFloatRowStride();
+               for (band = 0; band < BANDS; ++band)
+               {
+                  float pixel;
+                  float density;
+                  fastAccumulator(inputBuf[band] + sourceIndex, inWidth, weights, stride,
+                                  ykernel_height, static_cast<float>(NULL_PIX[band]),
+                                  pixel, density);
+                  if(density<=FLT_EPSILON)
+                  {
+                     tmpFlt64 = NULL_PIX[band];
+                  }
+                  else
+                  {
+                     tmpFlt64 = pixel/density;
+                  }
+                  tmpFlt64 = (tmpFlt64>=MIN_PIX[band]?(tmpFlt64<MAX_PIX[band]?tmpFlt64:MAX_PIX[band]):MIN_PIX[band]); 
+                  resultBuf[band][resultX] = static_cast<T>(tmpFlt64);
+               }
+            }
             else
             {  
                kernel = theFilterTable.getClosestWeights(pointx,pointy);
@@ -878,6 +1145,26 @@ void ossimFilterResampler::setBlurFactor(ossim_float64 blur)
    theBlurFactor = blur;
 }
 
+void ossimFilterResampler::setSimdLevel(SimdLevel level)
+{
+   theSimdLevel = (level < getMaxSimdLevel()) ? level : getMaxSimdLevel();
+}
+
+ossimFilterResampler::SimdLevel ossimFilterResampler::getSimdLevel()const
+{
+   return theSimdLevel;
+}
+
+ossimFilterResampler::SimdLevel ossimFilterResampler::getMaxSimdLevel()
+{
+#ifdef OSSIM_FILTER_RESAMPLER_X86
+   static const SimdLevel maxLevel = cpuHasAvx2() ? SIMD_AVX2 : SIMD_SSE2;
+   return maxLevel;
+#else
+   return SIMD_NONE;
+#endif
+}
+
 bool ossimFilterResampler::saveState(ossimKeywordlist& kwl,
                                      const char* prefix)const
 {
@@ -930,6 +1217,12 @@ bool ossimFilterResampler::loadState(const ossimKeywordlist& kwl,
       setMagnifyFilterType(lookup);
    }
 
+   lookup = kwl.find(prefix, "simd_enabled");
+   if (lookup)
+   {
+      setSimdLevel(ossimString(lookup).toBool() ? getMaxSimdLevel() : SIMD_NONE);
+   }
+
    if(fabs(theScaleFactor.x) <= FLT_EPSILON)
    {
       theScaleFactor.x = 1.0;
@@ -14,6 +14,8 @@
 
 ossimFilterTable::ossimFilterTable()
    :theWeights(0),
+    theFloatWeights(0),
+    theFloatRowStride(0),
     theWidth(0),
     theHeight(0),
     theWidthHeight(0),
@@ -31,6 +33,11 @@ ossimFilterTable::~ossimFilterTable()
       delete [] theWeights;
       theWeights = 0;
    }
+   if(theFloatWeights)
+   {
+      delete [] theFloatWeights;
+      theFloatWeights = 0;
+   }
 }
 
 void ossimFilterTable::buildTable(ossim_uint32  filterSteps,
@@ -65,6 +72,7 @@ void ossimFilterTable::buildTable(ossim_uint32  filterSteps,
    theWidth  = (2*theXSupport);
    theHeight = (2*theYSupport);
    theWidthHeight = theWidth*theHeight;
+   theFloatRowStride = (theWidth + 3) & ~3;
    
    allocateWeights();
    left   = -(xsupport-1);
@@ -104,6 +112,28 @@ void ossimFilterTable::buildTable(ossim_uint32  filterSteps,
           }
         }
      }
+
+   // Float copy, each row padded with zero weights.
+   if(theFloatWeights)
+   {
+      const double* src = theWeights;
+      float* dst = theFloatWeights;
+      ossim_uint32 rows = theHeight*theFilterSteps*theFilterSteps;
+      for(ossim_uint32 row = 0; row < rows; ++row)
+      {
+         ossim_uint32 col = 0;
+         for(; col < theWidth; ++col)
+         {
+            dst[col] = static_cast<float>(src[col]);
+         }
+         for(; col < theFloatRowStride; ++col)
+         {
+            dst[col] = 0.0f;
+         }
+         src += theWidth;
+         dst += theFloatRowStride;
+      }
+   }
 }
 
 ossim_uint32 ossimFilterTable::getWidthByHeight()const
@@ -131,6 +161,11 @@ ossim_uint32 ossimFilterTable::getHeight()const
    return theHeight;
 }
 
+ossim_uint32 ossimFilterTable::getFloatRowStride()const
+{
+   return theFloatRowStride;
+}
+
 void ossimFilterTable::allocateWeights()
 {
    if(theWeights)
@@ -138,11 +173,18 @@ void ossimFilterTable::allocateWeights()
       delete [] theWeights;
       theWeights = 0;
    }
+   if(theFloatWeights)
+   {
+      delete [] theFloatWeights;
+      theFloatWeights = 0;
+   }
 
    ossim_uint32 size = (theWidthHeight*(theFilterSteps*theFilterSteps));
 
    if(size)
    {
       theWeights = new double[size];
+      theFloatWeights =
+         new float[theFloatRowStride*theHeight*(theFilterSteps*theFilterSteps)];
    }
 }
\ No newline at end of file
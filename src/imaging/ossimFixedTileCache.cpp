@@ -9,7 +9,6 @@
 //***********************************
 // $Id: ossimFixedTileCache.cpp 16276 2010-01-06 01:54:47Z gpotts $
 #include <ossim/imaging/ossimFixedTileCache.h>
-#include <algorithm>
 
 using namespace std;
 
@@ -22,8 +21,10 @@ ossimFixedTileCache::ossimFixedTileCache()
      theCacheSize(0),
      theMaxCacheSize(0),
      theTileMap(),
-     theLruQueue(),
-     theUseLruFlag(true)
+     theLruHead(0),
+     theLruTail(0),
+     theUseLruFlag(true),
+     theSizeCounter(0)
 {
    ossim::defaultTileSize(theTileSize);
 
@@ -44,52 +45,46 @@ ossimFixedTileCache::~ossimFixedTileCache()
 
 void ossimFixedTileCache::setRect(const ossimIrect& rect)
 {
-   {
-      std::lock_guard<std::mutex> lock(theMutex);
-      ossim::defaultTileSize(theTileSize);
-      theTileBoundaryRect      = rect;
-      theTileBoundaryRect.stretchToTileBoundary(theTileSize);
-      theBoundaryWidthHeight.x = theTileBoundaryRect.width();
-      theBoundaryWidthHeight.y = theTileBoundaryRect.height();
-      theTilesHorizontal       = theBoundaryWidthHeight.x/theTileSize.x;
-      theTilesVertical         = theBoundaryWidthHeight.y/theTileSize.y;
-   }
-   flush();
+   std::lock_guard<std::mutex> lock(theMutex);
+   ossim::defaultTileSize(theTileSize);
+   theTileBoundaryRect      = rect;
+   theTileBoundaryRect.stretchToTileBoundary(theTileSize);
+   theBoundaryWidthHeight.x = theTileBoundaryRect.width();
+   theBoundaryWidthHeight.y = theTileBoundaryRect.height();
+   theTilesHorizontal       = theBoundaryWidthHeight.x/theTileSize.x;
+   theTilesVertical         = theBoundaryWidthHeight.y/theTileSize.y;
+   flushNoLock();
 }
 
 void ossimFixedTileCache::setRect(const ossimIrect& rect,
                                   const ossimIpt& tileSize)
 {
-   {
-      std::lock_guard<std::mutex> lock(theMutex);
-      theTileBoundaryRect      = rect;
-      theTileSize              = tileSize;
-      theTileBoundaryRect.stretchToTileBoundary(theTileSize);
-      theBoundaryWidthHeight.x = theTileBoundaryRect.width();
-      theBoundaryWidthHeight.y = theTileBoundaryRect.height();
-      theTilesHorizontal       = theBoundaryWidthHeight.x/theTileSize.x;
-      theTilesVertical         = theBoundaryWidthHeight.y/theTileSize.y;
-   }
-   flush();
+   std::lock_guard<std::mutex> lock(theMutex);
+   theTileBoundaryRect      = rect;
+   theTileSize              = tileSize;
+   theTileBoundaryRect.stretchToTileBoundary(theTileSize);
+   theBoundaryWidthHeight.x = theTileBoundaryRect.width();
+   theBoundaryWidthHeight.y = theTileBoundaryRect.height();
+   theTilesHorizontal       = theBoundaryWidthHeight.x/theTileSize.x;
+   theTilesVertical         = theBoundaryWidthHeight.y/theTileSize.y;
+   flushNoLock();
 }
 
 
 void ossimFixedTileCache::keepTilesWithinRect(const ossimIrect& rect)
 {
    std::lock_guard<std::mutex> lock(theMutex);
-   std::map<ossim_int32, ossimFixedTileCacheInfo>::iterator tileIter = theTileMap.begin();
+   TileMap::iterator tileIter = theTileMap.begin();
 
    while(tileIter != theTileMap.end())
    {
-      ossimIrect tileRect = (*tileIter).second.theTile->getImageRectangle();
-      if(!tileRect.intersects(rect))
+      TileMap::iterator currentIter = tileIter;
+      ++tileIter;
+      if(!currentIter->second.theTile.valid() ||
+         !currentIter->second.theTile->getImageRectangle().intersects(rect))
       {
-         eraseFromLru(computeId((*tileIter).second.theTile->getOrigin()));
-         theCacheSize -= (*tileIter).second.theTile->getDataSizeInBytes();
-         (*tileIter).second.theTile = NULL;
-         theTileMap.erase(tileIter);
+         eraseTileNoLock(currentIter);
       }
-      ++tileIter;
    }
 }
 
@@ -113,10 +108,7 @@ ossimRefPtr<ossimImageData> ossimFixedTileCache::addTile(ossimRefPtr<ossimImageD
       return result;
    }
    
-   std::map<ossim_int32, ossimFixedTileCacheInfo>::iterator tileIter =
-      theTileMap.find(id);
-
-   if(tileIter==theTileMap.end())
+   if(theTileMap.find(id) == theTileMap.end())
    {
       if(duplicateData)
       {
@@ -127,12 +119,22 @@ ossimRefPtr<ossimImageData> ossimFixedTileCache::addTile(ossimRefPtr<ossimImageD
          result = imageData;
       }
       ossimFixedTileCacheInfo cacheInfo(result, id);
-       
-      theCacheSize += imageData->getDataSizeInBytes();
-      theTileMap.insert(make_pair(id, cacheInfo));
+
+      // Make room first so the new tile is not the one evicted:
+      if(theMaxCacheSize && theUseLruFlag)
+      {
+         while( ((ossim_uint64)theCacheSize.load() + cacheInfo.theSizeInBytes >
+                 theMaxCacheSize) && evictLruTileNoLock() )
+         {
+         }
+      }
+
+      ossimFixedTileCacheInfo* info =
+         &(theTileMap.insert(make_pair(id, cacheInfo)).first->second);
+      adjustCacheSize(info->theSizeInBytes);
       if(theUseLruFlag)
       {
-         theLruQueue.push_back(id);
+         pushLru(info);
       }
    }
    
@@ -144,12 +146,15 @@ ossimRefPtr<ossimImageData> ossimFixedTileCache::getTile(ossim_int32 id)
    std::lock_guard<std::mutex> lock(theMutex);
    ossimRefPtr<ossimImageData> result = NULL;
 
-   std::map<ossim_int32, ossimFixedTileCacheInfo>::iterator tileIter =
-      theTileMap.find(id);
+   TileMap::iterator tileIter = theTileMap.find(id);
    if(tileIter!=theTileMap.end())
    {
       result = (*tileIter).second.theTile;
-      adjustLru(id);
+      if(theUseLruFlag)
+      {
+         unlinkLru(&tileIter->second);
+         pushLru(&tileIter->second);
+      }
    }
 
    return result;
@@ -161,12 +166,12 @@ ossimIpt ossimFixedTileCache::getTileOrigin(ossim_int32 tileId)
    ossimIpt result;
    result.makeNan();
 
-   if(tileId < 0)
+   if((tileId < 0) || !theTilesHorizontal)
    {
       return result;
    }
    ossim_int32 ty = (tileId/theTilesHorizontal);
-   ossim_int32 tx = (tileId%theTilesVertical);
+   ossim_int32 tx = (tileId%theTilesHorizontal);
    
    ossimIpt ul = theTileBoundaryRect.ul();
    
@@ -197,18 +202,12 @@ ossim_int32 ossimFixedTileCache::computeId(const ossimIpt& tileOrigin)const
 
 void ossimFixedTileCache::deleteTile(ossim_int32 tileId)
 {
-   std::map<ossim_int32, ossimFixedTileCacheInfo>::iterator tileIter =
-      theTileMap.find(tileId);
+   std::lock_guard<std::mutex> lock(theMutex);
+   TileMap::iterator tileIter = theTileMap.find(tileId);
 
    if(tileIter != theTileMap.end())
    {
-      if((*tileIter).second.theTile.valid())
-      {
-         theCacheSize -= (*tileIter).second.theTile->getDataSizeInBytes();
-         (*tileIter).second.theTile = NULL;
-      }
-      theTileMap.erase(tileIter);
-      eraseFromLru(tileId);
+      eraseTileNoLock(tileIter);
    }
 }
 
@@ -217,18 +216,11 @@ ossimRefPtr<ossimImageData> ossimFixedTileCache::removeTile(ossim_int32 tileId)
    std::lock_guard<std::mutex> lock(theMutex);
    ossimRefPtr<ossimImageData> result = NULL;
    
-   std::map<ossim_int32, ossimFixedTileCacheInfo>::iterator tileIter =
-      theTileMap.find(tileId);
+   TileMap::iterator tileIter = theTileMap.find(tileId);
 
    if(tileIter != theTileMap.end())
    {
-      theCacheSize -= (*tileIter).second.theTile->getDataSizeInBytes();
-      if((*tileIter).second.theTile.valid())
-      {
-         result =  (*tileIter).second.theTile;
-      }
-      theTileMap.erase(tileIter);
-      eraseFromLru(tileId);
+      result = eraseTileNoLock(tileIter);
    }
    
    return result;
@@ -237,59 +229,159 @@ ossimRefPtr<ossimImageData> ossimFixedTileCache::removeTile(ossim_int32 tileId)
 void ossimFixedTileCache::flush()
 {
    std::lock_guard<std::mutex> lock(theMutex);
-   std::map<ossim_int32, ossimFixedTileCacheInfo>::iterator tileIter =
-      theTileMap.begin();
+   flushNoLock();
+}
 
-   while(tileIter != theTileMap.end())
+void ossimFixedTileCache::deleteTile()
+{
+   evictLruTile();
+}
+
+ossimRefPtr<ossimImageData> ossimFixedTileCache::removeTile()
+{
+   std::lock_guard<std::mutex> lock(theMutex);
+   ossimRefPtr<ossimImageData> result = NULL;
+   if(theUseLruFlag && theLruHead)
    {
-      if( (*tileIter).second.theTile.valid())
-      {
-         (*tileIter).second.theTile = 0;
-      }
-      ++tileIter;
+      result = eraseTileNoLock(theTileMap.find(theLruHead->theTileId));
    }
-   theLruQueue.clear();
-   theTileMap.clear();
-   theCacheSize = 0;
+
+   return result;
 }
 
-void ossimFixedTileCache::deleteTile()
+void ossimFixedTileCache::setUseLruFlag(bool flag)
 {
    std::lock_guard<std::mutex> lock(theMutex);
-   if(theUseLruFlag)
+   if(flag == theUseLruFlag)
    {
-      if(theLruQueue.begin() != theLruQueue.end())
+      return;
+   }
+   theUseLruFlag = flag;
+
+   // Entries come and go from the list with the flag so rebuild or drop it:
+   theLruHead = 0;
+   theLruTail = 0;
+   for(TileMap::iterator tileIter = theTileMap.begin(); tileIter != theTileMap.end(); ++tileIter)
+   {
+      tileIter->second.theLruPrev = 0;
+      tileIter->second.theLruNext = 0;
+      if(theUseLruFlag)
       {
-         deleteTile(*(theLruQueue.begin()));
+         pushLru(&tileIter->second);
       }
    }
 }
 
-ossimRefPtr<ossimImageData> ossimFixedTileCache::removeTile()
+ossim_uint32 ossimFixedTileCache::getNumberOfTiles()const
 {
    std::lock_guard<std::mutex> lock(theMutex);
-   if(theUseLruFlag)
+   return (ossim_uint32)theTileMap.size();
+}
+
+void ossimFixedTileCache::setSizeCounter(std::atomic<ossim_int64>* counter)
+{
+   std::lock_guard<std::mutex> lock(theMutex);
+   ossim_int64 size = theCacheSize.load();
+   if(theSizeCounter)
    {
-      if(theLruQueue.begin() != theLruQueue.end())
-      {
-         return removeTile(*(theLruQueue.begin()));
-      }
+      *theSizeCounter -= size;
+   }
+   theSizeCounter = counter;
+   if(theSizeCounter)
+   {
+      *theSizeCounter += size;
+   }
+}
+
+ossim_uint32 ossimFixedTileCache::evictLruTile()
+{
+   std::lock_guard<std::mutex> lock(theMutex);
+   return evictLruTileNoLock();
+}
+
+ossim_uint32 ossimFixedTileCache::evictLruTileNoLock()
+{
+   ossim_uint32 result = 0;
+   if(theUseLruFlag && theLruHead)
+   {
+      result = theLruHead->theSizeInBytes;
+      eraseTileNoLock(theTileMap.find(theLruHead->theTileId));
+   }
+   return result;
+}
+
+ossimRefPtr<ossimImageData> ossimFixedTileCache::eraseTileNoLock(TileMap::iterator tileIter)
+{
+   ossimRefPtr<ossimImageData> result = tileIter->second.theTile;
+   unlinkLru(&tileIter->second);
+   adjustCacheSize(-(ossim_int64)tileIter->second.theSizeInBytes);
+   theTileMap.erase(tileIter);
+   return result;
+}
+
+void ossimFixedTileCache::flushNoLock()
+{
+   adjustCacheSize(-(ossim_int64)theCacheSize.load());
+   theTileMap.clear();
+   theLruHead = 0;
+   theLruTail = 0;
+}
+
+void ossimFixedTileCache::adjustCacheSize(ossim_int64 delta)
+{
+   theCacheSize += (ossim_uint32)delta;
+   if(theSizeCounter)
+   {
+      *theSizeCounter += delta;
+   }
+}
+
+void ossimFixedTileCache::pushLru(ossimFixedTileCacheInfo* info)
+{
+   info->theLruPrev = theLruTail;
+   info->theLruNext = 0;
+   if(theLruTail)
+   {
+      theLruTail->theLruNext = info;
    }
+   else
+   {
+      theLruHead = info;
+   }
+   theLruTail = info;
+}
 
-   return NULL;
+void ossimFixedTileCache::unlinkLru(ossimFixedTileCacheInfo* info)
+{
+   if(info->theLruPrev)
+   {
+      info->theLruPrev->theLruNext = info->theLruNext;
+   }
+   else if(theLruHead == info)
+   {
+      theLruHead = info->theLruNext;
+   }
+   if(info->theLruNext)
+   {
+      info->theLruNext->theLruPrev = info->theLruPrev;
+   }
+   else if(theLruTail == info)
+   {
+      theLruTail = info->theLruPrev;
+   }
+   info->theLruPrev = 0;
+   info->theLruNext = 0;
 }
 
 void ossimFixedTileCache::adjustLru(ossim_int32 id)
 {
    if(theUseLruFlag)
    {
-      std::list<ossim_int32>::iterator iter = std::find(theLruQueue.begin(), theLruQueue.end(), id);
-      
-      if(iter != theLruQueue.end())
+      TileMap::iterator tileIter = theTileMap.find(id);
+      if(tileIter != theTileMap.end())
       {
-         ossim_int32 value = *iter;
-         theLruQueue.erase(iter);
-         theLruQueue.push_back(value);
+         unlinkLru(&tileIter->second);
+         pushLru(&tileIter->second);
       }
    }
 }
@@ -298,12 +390,10 @@ void ossimFixedTileCache::eraseFromLru(ossim_int32 id)
 {
    if(theUseLruFlag)
    {
-      
-      std::list<ossim_int32>::iterator iter = std::find(theLruQueue.begin(), theLruQueue.end(), id);
-      
-      if(iter != theLruQueue.end())
+      TileMap::iterator tileIter = theTileMap.find(id);
+      if(tileIter != theTileMap.end())
       {
-         theLruQueue.erase(iter);
+         unlinkLru(&tileIter->second);
       }
    }
 }
@@ -22,6 +22,7 @@
 #include <ossim/base/ossimScalarTypeLut.h>
 //#include <ossim/base/ossimSource.h>
 #include <ossim/base/ossimString.h>
+#include <ossim/base/ossimTileBufferPool.h>
 #include <ossim/imaging/ossimImageData.h>
 #include <algorithm>
 #include <cstring>
@@ -1686,6 +1687,14 @@ template <class T> void ossimImageData::makeBlank(T /* dummyTemplate */ )
 
 void ossimImageData::initialize()
 {
+   // Recycle a buffer if ours is too small. Contents are stale but are blanked below.
+   const ossim_uint64 size = getDataSizeInBytes();
+   if ( (m_dataBuffer.capacity() < size) &&
+        ossimTileBufferPool::instance()->acquire(m_dataBuffer, size) )
+   {
+      setDataObjectStatus(OSSIM_STATUS_UNKNOWN);
+   }
+
    // let the base class allocate a buffer
    ossimRectilinearDataObject::initialize();
 
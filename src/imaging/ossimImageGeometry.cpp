@@ -16,17 +16,98 @@
 #include <ossim/base/ossimGrect.h>
 #include <ossim/base/ossimKeywordNames.h>
 #include <ossim/base/ossim2dTo2dTransformRegistry.h>
+#include <ossim/base/ossimEnvironmentUtility.h>
+#include <ossim/base/ossimPreferences.h>
+#include <ossim/base/ossimTrace.h>
 #include <ossim/elevation/ossimElevManager.h>
 #include <ossim/projection/ossimProjection.h>
 #include <ossim/projection/ossimEquDistCylProjection.h>
 #include <ossim/projection/ossimProjectionFactoryRegistry.h>
 #include <ossim/imaging/ossimImageHandlerRegistry.h>
+#include <algorithm>
 #include <cmath>
+#include <list>
+#include <memory>
+#include <mutex>
 
 using namespace std;
 
 RTTI_DEF1(ossimImageGeometry, "ossimImageGeometry", ossimObject);
 
+static ossimTrace traceDebug("ossimImageGeometry:debug");
+
+//**************************************************************************************************
+// Fast geometry mode support. Grids are shared by every geometry with the same projection state
+// through a small most recently used list, since chains clone their geometries freely.
+//**************************************************************************************************
+static const ossim_uint32 FAST_GRID_CACHE_SIZE       = 8;
+static const double       FAST_GRID_MARGIN           = 0.05; // Of the longer image side.
+static const double       FAST_GRID_MIN_HEIGHT       = -500.0;
+static const double       FAST_GRID_MAX_HEIGHT       = 9000.0;
+static const double       FAST_GRID_HEIGHT_STEP      = 500.0;
+static const double       FAST_GRID_CONVERGENCE      = 0.001; // meters, as ossimElevSource
+static const int          FAST_GRID_MAX_ITERATIONS   = 50;
+
+//! A grid of the list, read or built once by the first geometry that needs it. Its mutex holds
+//! back the other geometries with the same key meanwhile, but no others.
+struct FastGridEntry
+{
+   FastGridEntry() : done(false), grid(0) {}
+   std::mutex                       mutex;
+   bool                             done;
+   ossimRefPtr<ossimProjectionGrid> grid;
+};
+
+typedef std::list< std::pair< std::string, std::shared_ptr<FastGridEntry> > > FastGridList;
+
+//! Guards the list only, never held while a grid is read or built.
+static std::mutex& fastGridMutex()
+{
+   static std::mutex m;
+   return m;
+}
+
+static FastGridList& fastGridCache()
+{
+   static FastGridList cache;
+   return cache;
+}
+
+static double fastGridPreference(const char* key, double defaultValue)
+{
+   const char* lookup = ossimPreferences::instance()->findPreference(key);
+   return lookup ? ossimString(lookup).toDouble() : defaultValue;
+}
+
+static bool fastModePreference(double& maxError)
+{
+   maxError = fastGridPreference("geometry.fast_mode.max_error", 0.1);
+   const char* lookup = ossimPreferences::instance()->findPreference("geometry.fast_mode");
+   return lookup && ossimString(lookup).toBool();
+}
+
+//! Intersects the line of sight of full image point ipt with the DEM through the grid the same
+//! way ossimElevSource::intersectRay walks the ray. Returns FALSE if the grid does not cover a
+//! step or there is no elevation, for the caller to use the projection instead.
+static bool fastGridLineSampleToWorld(const ossimProjectionGrid* grid,
+                                      const ossimDpt& ipt,
+                                      ossimGpt& gpt)
+{
+   double hgt = 0.0;
+   for (int i = 0; i < FAST_GRID_MAX_ITERATIONS; ++i)
+   {
+      if (!grid->lineSampleHeightToWorld(ipt, hgt, gpt))
+         return false;
+      double next = ossimElevManager::instance()->getHeightAboveEllipsoid(gpt);
+      if (ossim::isnan(next))
+         return false;
+      if (std::fabs(next - hgt) < FAST_GRID_CONVERGENCE)
+         return grid->lineSampleHeightToWorld(ipt, next, gpt);
+      hgt = next;
+   }
+   return false;
+}
+
 //**************************************************************************************************
 // Default constructor defaults to unity transform with no projection  
 //**************************************************************************************************
@@ -36,9 +117,14 @@ m_transform (0),
 m_projection(0),
 m_decimationFactors(0),
 m_imageSize(),
-m_targetRrds(0)
+m_targetRrds(0),
+m_fastMode(false),
+m_fastModeMaxError(0.1),
+m_fastGrid(0),
+m_fastGridChecked(false)
 {
    m_imageSize.makeNan();
+   m_fastMode = fastModePreference(m_fastModeMaxError);
 }
 
 //**************************************************************************************************
@@ -55,8 +141,14 @@ m_transform(copy_this.m_transform.valid()?(ossim2dTo2dTransform*)copy_this.m_tra
 m_projection(copy_this.m_projection.valid()?(ossimProjection*)copy_this.m_projection->dup():(ossimProjection*)0),
 m_decimationFactors(copy_this.m_decimationFactors),
 m_imageSize(copy_this.m_imageSize),
-m_targetRrds(copy_this.m_targetRrds)
+m_targetRrds(copy_this.m_targetRrds),
+m_fastMode(copy_this.m_fastMode),
+m_fastModeMaxError(copy_this.m_fastModeMaxError),
+m_fastGrid(0),
+m_fastGridChecked(false),
+m_fastGridMutex()
 {
+   copyFastGrid(copy_this);
 }
 
 //**************************************************************************************************
@@ -70,9 +162,14 @@ m_transform(transform),
 m_projection(proj),
 m_decimationFactors(0),
 m_imageSize(),
-m_targetRrds(0)   
+m_targetRrds(0),
+m_fastMode(false),
+m_fastModeMaxError(0.1),
+m_fastGrid(0),
+m_fastGridChecked(false)
 {
    m_imageSize.makeNan();
+   m_fastMode = fastModePreference(m_fastModeMaxError);
 }
 
 //**************************************************************************************************
@@ -191,7 +288,9 @@ bool ossimImageGeometry::localToWorld(const ossimDpt& local_pt, ossimGpt& world_
    rnToFull(local_pt, m_targetRrds, full_image_pt);
 
    // Perform projection to world coordinates:
-   m_projection->lineSampleToWorld(full_image_pt, world_pt);
+   const ossimProjectionGrid* grid = getFastGrid();
+   if (!grid || !fastGridLineSampleToWorld(grid, full_image_pt, world_pt))
+      m_projection->lineSampleToWorld(full_image_pt, world_pt);
 
 
     // Put longitude between -180 and +180 and latitude between -90 and +90 if not so. 
@@ -233,7 +332,9 @@ bool ossimImageGeometry::localToWorld(const ossimDpt& local_pt,
    rnToFull(local_pt, m_targetRrds, full_image_pt);
 
    // Perform projection to world coordinates:
-   m_projection->lineSampleHeightToWorld(full_image_pt, h_ellipsoid, world_pt);
+   const ossimProjectionGrid* grid = getFastGrid();
+   if (!grid || !grid->lineSampleHeightToWorld(full_image_pt, h_ellipsoid, world_pt))
+      m_projection->lineSampleHeightToWorld(full_image_pt, h_ellipsoid, world_pt);
 
    // Put longitude between -180 and +180 and latitude between -90 and +90 if not so. 
    world_pt.wrap();
@@ -279,7 +380,9 @@ bool ossimImageGeometry::worldToLocal(const ossimGpt& world_pt, ossimDpt& local_
          }     
 
          // Perform projection from world coordinates to full-image space:
-         m_projection->worldToLineSample(copyPt, full_image_pt);
+         const ossimProjectionGrid* grid = getFastGrid();
+         if (!grid || !grid->worldToLineSample(copyPt, full_image_pt))
+            m_projection->worldToLineSample(copyPt, full_image_pt);
       }
       else
       {
@@ -300,6 +403,96 @@ bool ossimImageGeometry::worldToLocal(const ossimGpt& world_pt, ossimDpt& local_
    
 } // End: ossimImageGeometry::worldToLocal(const ossimGpt&, ossimDpt&)
 
+//**************************************************************************************************
+// Batch versions. Points go through in chunks so the scratch space can live on the stack.
+//**************************************************************************************************
+static const ossim_uint32 BATCH_CHUNK_SIZE = 64;
+
+bool ossimImageGeometry::localToWorld(const ossimDpt* local_pts,
+                                      ossimGpt* world_pts,
+                                      ossim_uint32 count) const
+{
+   if (!m_projection.valid())
+   {
+      for (ossim_uint32 i = 0; i < count; ++i)
+         world_pts[i].makeNan();
+      return false;
+   }
+
+   const ossimProjectionGrid* grid = getFastGrid();
+   ossimDpt full_image_pts[BATCH_CHUNK_SIZE];
+   for (ossim_uint32 start = 0; start < count; start += BATCH_CHUNK_SIZE)
+   {
+      ossim_uint32 n = std::min(count - start, BATCH_CHUNK_SIZE);
+      for (ossim_uint32 i = 0; i < n; ++i)
+         rnToFull(local_pts[start + i], m_targetRrds, full_image_pts[i]);
+
+      if (grid)
+      {
+         for (ossim_uint32 i = 0; i < n; ++i)
+         {
+            if (!fastGridLineSampleToWorld(grid, full_image_pts[i], world_pts[start + i]))
+               m_projection->lineSampleToWorld(full_image_pts[i], world_pts[start + i]);
+         }
+      }
+      else
+      {
+         m_projection->lineSampleToWorld(full_image_pts, world_pts + start, n);
+      }
+   }
+   return true;
+}
+
+bool ossimImageGeometry::worldToLocal(const ossimGpt* world_pts,
+                                      ossimDpt* local_pts,
+                                      ossim_uint32 count) const
+{
+   if (!m_projection.valid())
+   {
+      for (ossim_uint32 i = 0; i < count; ++i)
+         local_pts[i].makeNan();
+      return false;
+   }
+
+   const bool affectedByElevation = isAffectedByElevation();
+   const ossimProjectionGrid* grid = affectedByElevation ? getFastGrid() : 0;
+   ossimGpt copy_pts[BATCH_CHUNK_SIZE];
+   ossimDpt full_image_pts[BATCH_CHUNK_SIZE];
+   for (ossim_uint32 start = 0; start < count; start += BATCH_CHUNK_SIZE)
+   {
+      ossim_uint32 n = std::min(count - start, BATCH_CHUNK_SIZE);
+      const ossimGpt* gpts = world_pts + start;
+      if (affectedByElevation)
+      {
+         // Same as the single point version: fill in missing heights from the DEM.
+         for (ossim_uint32 i = 0; i < n; ++i)
+         {
+            copy_pts[i] = gpts[i];
+            if (copy_pts[i].isHgtNan())
+               copy_pts[i].hgt = ossimElevManager::instance()->getHeightAboveEllipsoid(copy_pts[i]);
+         }
+         gpts = copy_pts;
+      }
+
+      if (grid)
+      {
+         for (ossim_uint32 i = 0; i < n; ++i)
+         {
+            if (!grid->worldToLineSample(gpts[i], full_image_pts[i]))
+               m_projection->worldToLineSample(gpts[i], full_image_pts[i]);
+         }
+      }
+      else
+      {
+         m_projection->worldToLineSample(gpts, full_image_pts, n);
+      }
+
+      for (ossim_uint32 i = 0; i < n; ++i)
+         fullToRn(full_image_pts[i], m_targetRrds, local_pts[start + i]);
+   }
+   return true;
+}
+
 bool ossimImageGeometry::worldToLocal(const ossimGrect& world_rect, ossimDrect& local_rect) const
 {
    ossimDpt dp1, dp2, dp3, dp4;
@@ -326,6 +519,137 @@ void ossimImageGeometry::setTransform(ossim2dTo2dTransform* transform)
 void ossimImageGeometry::setProjection(ossimProjection* projection) 
 { 
    m_projection = projection; 
+   resetFastGrid();
+}
+
+//**************************************************************************************************
+//! Turns fast geometry mode on or off. The grid is looked up again on next use.
+//**************************************************************************************************
+void ossimImageGeometry::setFastMode(bool flag, double maxError)
+{
+   m_fastMode = flag;
+   m_fastModeMaxError = maxError;
+   resetFastGrid();
+}
+
+//**************************************************************************************************
+//! Finds the fast mode grid in the memory cache, then the disk cache, else builds it.
+//**************************************************************************************************
+const ossimProjectionGrid* ossimImageGeometry::getFastGrid() const
+{
+   if (!m_fastMode)
+      return 0;
+   if (m_fastGridChecked.load(std::memory_order_acquire))
+      return m_fastGrid.get();
+
+   std::lock_guard<std::mutex> lock(m_fastGridMutex);
+   if (m_fastGridChecked.load(std::memory_order_acquire))
+      return m_fastGrid.get();
+
+   ossimRefPtr<ossimProjectionGrid> grid = 0;
+   if (m_projection.valid() && m_projection->isAffectedByElevation() && !m_imageSize.hasNans())
+   {
+      // Cover a margin around the image for resampling kernels and edge tiles:
+      const double margin = FAST_GRID_MARGIN * std::max(m_imageSize.x, m_imageSize.y);
+      const ossimDrect rect(-margin, -margin, m_imageSize.x - 1 + margin,
+                            m_imageSize.y - 1 + margin);
+      const double minHgt = fastGridPreference("geometry.fast_mode.min_height",
+                                               FAST_GRID_MIN_HEIGHT);
+      const double maxHgt = fastGridPreference("geometry.fast_mode.max_height",
+                                               FAST_GRID_MAX_HEIGHT);
+      const double hgtStep = fastGridPreference("geometry.fast_mode.height_step",
+                                                FAST_GRID_HEIGHT_STEP);
+
+      // Key on everything the grid depends on:
+      ossimKeywordlist kwl;
+      m_projection->saveState(kwl, "projection.");
+      kwl.add("fast_grid.image_rect", rect.toString().c_str());
+      kwl.add("fast_grid.heights", (ossimString::toString(minHgt) + " " +
+                                    ossimString::toString(maxHgt) + " " +
+                                    ossimString::toString(hgtStep)).c_str());
+      kwl.add("fast_grid.max_error", m_fastModeMaxError);
+      const std::string key = kwl.toString().string();
+
+      std::shared_ptr<FastGridEntry> entry;
+      {
+         std::lock_guard<std::mutex> listLock(fastGridMutex());
+         FastGridList& cache = fastGridCache();
+         FastGridList::iterator pos = cache.begin();
+         while ((pos != cache.end()) && (pos->first != key))
+            ++pos;
+
+         if (pos != cache.end())
+         {
+            cache.splice(cache.begin(), cache, pos);
+         }
+         else
+         {
+            cache.push_front(std::make_pair(key, std::make_shared<FastGridEntry>()));
+            if (cache.size() > FAST_GRID_CACHE_SIZE)
+               cache.pop_back();
+         }
+         entry = cache.front().second;
+      }
+
+      std::lock_guard<std::mutex> entryLock(entry->mutex);
+      if (!entry->done)
+      {
+         ossimFilename dir = ossimPreferences::instance()->
+            findPreference("geometry.fast_mode.cache_dir");
+         if (dir.empty())
+            dir = ossimEnvironmentUtility::instance()->getUserOssimSupportDir().
+               dirCat("geometry_cache");
+         const ossimFilename file =
+            dir.dirCat(ossimProjectionGrid::hashKey(key) + ".grid");
+
+         grid = new ossimProjectionGrid;
+         if (grid->read(file, key))
+         {
+            if (traceDebug())
+               ossimNotify(ossimNotifyLevel_DEBUG) << "ossimImageGeometry::getFastGrid: read "
+                                                   << file << "\n";
+         }
+         else if (grid->build(m_projection.get(), rect, minHgt, maxHgt, hgtStep,
+                              m_fastModeMaxError))
+         {
+            if (traceDebug())
+               ossimNotify(ossimNotifyLevel_DEBUG)
+                  << "ossimImageGeometry::getFastGrid: built " << grid->getCols() << "x"
+                  << grid->getRows() << " nodes, error " << grid->getMaxError() << "\n";
+            if ((dir.exists() || dir.createDirectory()) && !grid->write(file, key))
+               ossimNotify(ossimNotifyLevel_WARN)
+                  << "ossimImageGeometry::getFastGrid: could not write " << file << "\n";
+         }
+         else
+         {
+            // Remember the failure too so clones do not try again:
+            if (traceDebug())
+               ossimNotify(ossimNotifyLevel_DEBUG) << "ossimImageGeometry::getFastGrid: "
+                  << "projection not approximated within " << m_fastModeMaxError << " pixels\n";
+            grid = 0;
+         }
+
+         entry->grid = grid;
+         entry->done = true;
+      }
+      grid = entry->grid;
+   }
+
+   m_fastGrid = grid;
+   m_fastGridChecked.store(true, std::memory_order_release);
+   return m_fastGrid.get();
+}
+
+//**************************************************************************************************
+//! Takes the fast mode grid of other if it has looked it up, else leaves it to getFastGrid().
+//**************************************************************************************************
+void ossimImageGeometry::copyFastGrid(const ossimImageGeometry& other)
+{
+   if (other.m_fastGridChecked.load(std::memory_order_acquire))
+   {
+      m_fastGrid = other.m_fastGrid;
+      m_fastGridChecked.store(true, std::memory_order_release);
+   }
 }
 
 //**************************************************************************************************
@@ -549,6 +873,8 @@ void ossimImageGeometry::decimationFactors(
 bool ossimImageGeometry::loadState(const ossimKeywordlist& kwl,
                                    const char* prefix)
 {
+   resetFastGrid();
+
    const char* lookup = kwl.find(prefix, ossimKeywordNames::TYPE_KW);
    if (lookup)
    {
@@ -706,6 +1032,10 @@ const ossimImageGeometry& ossimImageGeometry::operator=(const ossimImageGeometry
       m_imageSize         = copy_this.m_imageSize;
       m_decimationFactors = copy_this.m_decimationFactors;
       m_targetRrds        = copy_this.m_targetRrds;
+      m_fastMode          = copy_this.m_fastMode;
+      m_fastModeMaxError  = copy_this.m_fastModeMaxError;
+      resetFastGrid();
+      copyFastGrid(copy_this);
    }
    return *this;
 }
@@ -1885,6 +1885,56 @@ void ossimImageHandler::setStartingResLevel(ossim_uint32 level)
    theStartingResLevel = level;
 }
 
+bool ossimImageHandler::supportsConcurrentReads() const
+{
+   return false;
+}
+
+ossimRefPtr<ossimImageHandler> ossimImageHandler::createConcurrentReader() const
+{
+   return ossimRefPtr<ossimImageHandler>();
+}
+
+bool ossimImageHandler::initConcurrentReader(ossimImageHandler* reader) const
+{
+   if ( !reader )
+   {
+      return false;
+   }
+
+   reader->theImageFile              = theImageFile;
+   reader->theOverviewFile           = theOverviewFile;
+   reader->theSupplementaryDirectory = theSupplementaryDirectory;
+   reader->theValidImageVertices     = theValidImageVertices;
+   reader->theMetaData               = theMetaData;
+   reader->theGeometry               = theGeometry;
+   reader->theLut                    = theLut;
+   reader->theDecimationFactors      = theDecimationFactors;
+   reader->theImageID                = theImageID;
+   reader->theStartingResLevel       = theStartingResLevel;
+   reader->theOpenOverviewFlag       = false; // Overview reader is set below, never reopened.
+   reader->thePixelType              = thePixelType;
+   reader->m_state                   = m_state;
+   reader->setEnableFlag(isSourceEnabled());
+
+   if ( theOverview.valid() )
+   {
+      ossimRefPtr<ossimImageHandler> overviewReader;
+      if ( theOverview->supportsConcurrentReads() )
+      {
+         overviewReader = theOverview->createConcurrentReader();
+      }
+      if ( !overviewReader.valid() )
+      {
+         return false;
+      }
+      overviewReader->changeOwner(reader);
+      reader->theOverview = overviewReader;
+   }
+
+   return true;
+}
+
 bool ossimImageHandler::getOpenOverviewFlag() const
 {
    return theOpenOverviewFlag;
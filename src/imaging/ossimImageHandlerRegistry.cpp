@@ -22,6 +22,7 @@
 #include <ossim/imaging/ossimImageHandler.h>
 #include <ossim/imaging/ossimImageHandlerFactory.h>
 #include <ossim/imaging/ossimImageHandlerFactoryBase.h>
+#include <ossim/support_data/ImageHandlerStateStore.h>
 #include <algorithm>
 
 using namespace std;
@@ -67,19 +68,24 @@ ossimObject* ossimImageHandlerRegistry::createObject(const ossimKeywordlist& kwl
 ossimRefPtr<ossimImageHandler> ossimImageHandlerRegistry::openBySuffix(const ossimFilename& file,
                                                                        bool openOverview)const
 {
+   // Try the handlers one factory at a time, in factory order, so that factories after the one
+   // that opens the file are never asked.  A deferred plugin factory loads its plugin when asked.
+   const ossimString ext = file.ext();
    std::vector<ossimRefPtr<ossimImageHandler> > handlers;
-   
-   getImageHandlersBySuffix(handlers, file.ext());
-   ossim_uint32 idx = 0;
-   ossim_uint32 size = (ossim_uint32) handlers.size();
-   
-   for(idx = 0; idx < size; ++idx)
+   vector<ossimImageHandlerFactoryBase*>::const_iterator iter = m_factoryList.begin();
+   while(iter != m_factoryList.end())
    {
-      handlers[idx]->setOpenOverviewFlag(openOverview);
-      if(handlers[idx]->open(file))
+      handlers.clear();
+      (*iter)->getImageHandlersBySuffix(handlers, ext);
+      for(ossim_uint32 idx = 0; idx < (ossim_uint32)handlers.size(); ++idx)
       {
-         return handlers[idx];
+         handlers[idx]->setOpenOverviewFlag(openOverview);
+         if(handlers[idx]->open(file))
+         {
+            return handlers[idx];
+         }
       }
+      ++iter;
    }
    
    return ossimRefPtr<ossimImageHandler>(0);
@@ -163,6 +169,19 @@ std::shared_ptr<ossim::ImageHandlerState> ossimImageHandlerRegistry::getState(co
    if(m_stateCache)
    {
       result = m_stateCache->getItem(id);
+      if(!result&&m_stateStore)
+      {
+         // Saved by an earlier process:
+         result = m_stateStore->load(id);
+         if(result)
+         {
+            if(traceDebug())
+            {
+               ossimNotify(ossimNotifyLevel_DEBUG)<< "ossimImageHandlerRegistry::getState: loaded " << id << " from " << m_stateStore->getFile(id) << std::endl;
+            }
+            m_stateCache->addItem(id, result);
+         }
+      }
    }
 
    return result;
@@ -194,11 +213,15 @@ ossimRefPtr<ossimImageHandler> ossimImageHandlerRegistry::openConnection(
    std::shared_ptr<ossim::ImageHandlerState> state = getState(myConnectionString, 0);
    if(state)
    {
-      if(traceDebug())
+      result = open(state);
+      if(result)
       {
-         ossimNotify(ossimNotifyLevel_DEBUG)<< "ossimImageHandlerRegistry::openConnection: leaving with open(state).........." << std::endl;;
+         if(traceDebug())
+         {
+            ossimNotify(ossimNotifyLevel_DEBUG)<< "ossimImageHandlerRegistry::openConnection: leaving with open(state).........." << std::endl;;
+         }
+         return result;
       }
-      return open(state);
    }  
 
    std::shared_ptr<ossim::istream> str = ossim::StreamFactoryRegistry::instance()->
@@ -548,9 +571,11 @@ ossimImageHandlerRegistry::ossimImageHandlerRegistry(const ossimImageHandlerRegi
 void ossimImageHandlerRegistry::initializeStateCache()const
 {
    m_stateCache = 0;
+   m_stateStore = 0;
    ossimString enabledString = ossimPreferences::instance()->findPreference("ossim.imaging.handler.registry.state_cache.enabled");
    ossimString minSizeString = ossimPreferences::instance()->findPreference("ossim.imaging.handler.registry.state_cache.min_size");
    ossimString maxSizeString = ossimPreferences::instance()->findPreference("ossim.imaging.handler.registry.state_cache.max_size");
+   ossimFilename directory = ossimPreferences::instance()->findPreference("ossim.imaging.handler.registry.state_cache.directory");
 
    ossim_uint32 maxSize = 0;
    ossim_uint32 minSize = 0;
@@ -577,6 +602,10 @@ void ossimImageHandlerRegistry::initializeStateCache()const
          {
             m_stateCache->setMinAndMaxItemsToCache(minSize, maxSize);
          }
+         if(!directory.empty())
+         {
+            m_stateStore = std::make_shared<ossim::ImageHandlerStateStore>(directory);
+         }
       }
 
    }
@@ -595,6 +624,10 @@ void ossimImageHandlerRegistry::addToStateCache(ossimImageHandler* handler)const
             ossimNotify(ossimNotifyLevel_DEBUG)<< "ossimImageHandlerRegistry::addToStateCache: " << id << std::endl;
          }
          m_stateCache->addItem(id, state);
+         if(m_stateStore&&!m_stateStore->save(id, *state)&&traceDebug())
+         {
+            ossimNotify(ossimNotifyLevel_DEBUG)<< "ossimImageHandlerRegistry::addToStateCache: could not save " << id << " to " << m_stateStore->getDirectory() << std::endl;
+         }
       }
    }
 }
@@ -35,9 +35,12 @@
 #include <ossim/projection/ossimMapProjection.h>
 #include <ossim/projection/ossimBilinearMapProjection.h>
 #include <ossim/projection/ossimEquDistCylProjection.h>
+#include <functional>
 #include <iostream>
 #include <stack>
+#include <string>
 #include <ossim/base/ossimPreferences.h>
+#include <ossim/elevation/ossimElevManager.h>
 
 // using namespace std;
 
@@ -574,10 +577,13 @@ void ossimImageRenderer::ossimRendererSubRectInfo::transformViewToImage()
    ossim_float64 h = vrect.height();
 #endif
 
-   m_transform->viewToImage(m_Vul, m_Iul);
-   m_transform->viewToImage(m_Vur, m_Iur);
-   m_transform->viewToImage(m_Vlr, m_Ilr);
-   m_transform->viewToImage(m_Vll, m_Ill);
+   const ossimDpt viewCorners[4] = { m_Vul, m_Vur, m_Vlr, m_Vll };
+   ossimDpt imageCorners[4];
+   m_transform->viewToImage(viewCorners, imageCorners, 4);
+   m_Iul = imageCorners[0];
+   m_Iur = imageCorners[1];
+   m_Ilr = imageCorners[2];
+   m_Ill = imageCorners[3];
 
 //  m_ulRoundTripError = m_transform->getRoundTripErrorView(m_Vul);
 //  m_urRoundTripError = m_transform->getRoundTripErrorView(m_Vur);
@@ -857,33 +863,21 @@ bool ossimImageRenderer::ossimRendererSubRectInfo::canBilinearInterpolate() cons
     getImageMids(iUpper, iRight, iBottom, iLeft, iCenter);
 
     // get the model centers for the mid upper left right bottom
-    m_transform->viewToImage(vCenter, testCenter);
-
-    if (testCenter.hasNans())
-    {
-      return false;
-    }
-
-    m_transform->viewToImage(vUpper, testUpper);
-    if (testUpper.hasNans())
-    {
-      return false;
-    }
-    m_transform->viewToImage(vRight, testRight);
-    if (testRight.hasNans())
+    const ossimDpt viewMids[5] = { vCenter, vUpper, vRight, vBottom, vLeft };
+    ossimDpt testMids[5];
+    m_transform->viewToImage(viewMids, testMids, 5);
+    for (ossim_uint32 i = 0; i < 5; ++i)
     {
-      return false;
-    }
-    m_transform->viewToImage(vBottom, testBottom);
-    if (testBottom.hasNans())
-    {
-      return false;
-    }
-    m_transform->viewToImage(vLeft, testLeft);
-    if (testLeft.hasNans())
-    {
-      return false;
+      if (testMids[i].hasNans())
+      {
+        return false;
+      }
     }
+    testCenter = testMids[0];
+    testUpper  = testMids[1];
+    testRight  = testMids[2];
+    testBottom = testMids[3];
+    testLeft   = testMids[4];
 
     // now get the model error to bilinear estimate of those points
     double errorCheck1 = (testCenter - iCenter).length();
@@ -1094,7 +1088,12 @@ ossimImageRenderer::ossimImageRenderer()
       m_AutoUpdateInputTransform(true),
       m_MaxLevelsToCompute(999999), // something large so it will always compute
       m_averageViewToImageScale(1.0),
-      m_averageViewToImageRLevelScale(0.0)
+      m_averageViewToImageRLevelScale(0.0),
+      m_transformCacheSize(0),
+      m_transformCacheBytes(0),
+      m_transformStateHash(0),
+      m_transformGridList(),
+      m_transformGridMap()
 {
   ossimViewInterface::theObject = this;
   m_Resampler = new ossimFilterResampler();
@@ -1119,8 +1118,12 @@ ossimImageRenderer::ossimImageRenderer(ossimImageSource *inputSource,
       m_AutoUpdateInputTransform(true),
       m_MaxLevelsToCompute(999999),  // something large so it will always compute
       m_averageViewToImageScale(1.0),
-      m_averageViewToImageRLevelScale(0.0)
-
+      m_averageViewToImageRLevelScale(0.0),
+      m_transformCacheSize(0),
+      m_transformCacheBytes(0),
+      m_transformStateHash(0),
+      m_transformGridList(),
+      m_transformGridMap()
 {
    ossimViewInterface::theObject = this;
    m_Resampler = new ossimFilterResampler();
@@ -1231,6 +1234,18 @@ ossimRefPtr<ossimImageData> ossimImageRenderer::getTile(
    
    m_Tile->setImageRectangle(tileRect);
    m_Tile->makeBlank();
+
+   // Same tile under the same transform state, reuse the last split:
+   if ( m_transformCacheSize )
+   {
+      const SubRectList* cachedSubRects = findTransformGrid(tileRect, resLevel);
+      if ( cachedSubRects )
+      {
+         fillTile(m_Tile, *cachedSubRects);
+         m_Tile->validate();
+         return m_Tile;
+      }
+   }
  
 
   //if(!(m_viewArea.intersects(ossimPolyArea2d(tileRect))))
@@ -1320,7 +1335,13 @@ ossimRefPtr<ossimImageData> ossimImageRenderer::getTile(
 //   {
 //      return m_Tile;
 //   }
-   recursiveResample(m_Tile, subRectInfo, 1);
+   SubRectList subRects;
+   computeSubRects(subRectInfo, subRects);
+   if ( m_transformCacheSize )
+   {
+      addTransformGrid(tileRect, resLevel, subRects);
+   }
+   fillTile(m_Tile, subRects);
   
    if(m_Tile.valid())
    {
@@ -1337,6 +1358,53 @@ ossimRefPtr<ossimImageData> ossimImageRenderer::getTile(
 void ossimImageRenderer::recursiveResample(ossimRefPtr<ossimImageData> outputData,
                                            const ossimRendererSubRectInfo& rectInfo,
                                            ossim_uint32 /* level */)
+{
+  SubRectList subRects;
+  computeSubRects(rectInfo, subRects);
+  fillTile(outputData, subRects);
+  #if 0
+   ossimIrect tempViewRect = rectInfo.getViewRect();
+   if(rectInfo.imageIsNan())
+   {
+      return;
+   } 
+
+  if(tempViewRect.width() <2 ||
+      tempViewRect.height() <2)
+  {
+      if(!rectInfo.imageHasNans())
+      {
+         fillTile(outputData,
+                  rectInfo);
+      }
+      return;
+  }
+  //
+  std::vector<ossimRendererSubRectInfo> splitRects;
+  rectInfo.splitView(splitRects);
+
+//std::cout << "SHOULD BE SPLITTING: " << splitRects.size() <<"\n";
+  ossim_uint32 idx = 0;
+  if(!splitRects.empty())
+  {
+   // std::cout << "SPLITTING " << level << ", " << tempViewRect << "\n";
+    for(idx = 0; idx < splitRects.size();++idx)
+    {
+      recursiveResample(outputData,
+                        splitRects[idx],
+                        level + 1);
+    }
+  }
+  else if(!rectInfo.imageHasNans())
+  {
+    fillTile(outputData,
+            rectInfo);
+  }
+  #endif
+}
+
+void ossimImageRenderer::computeSubRects(const ossimRendererSubRectInfo& rectInfo,
+                                         SubRectList& subRects)
 {
   // Removed recursion and just use the std::stack.
   //
@@ -1355,8 +1423,7 @@ void ossimImageRenderer::recursiveResample(ossimRefPtr<ossimImageData> outputDat
       {
           if(!currentRectInfo.imageHasNans())
           {
-             fillTile(outputData,
-                      currentRectInfo);
+             subRects.push_back(currentRectInfo);
           }
       }
       else
@@ -1381,53 +1448,22 @@ void ossimImageRenderer::recursiveResample(ossimRefPtr<ossimImageData> outputDat
         {
           if(!currentRectInfo.imageHasNans())
           {
-            fillTile(outputData,
-                    currentRectInfo);
+            subRects.push_back(currentRectInfo);
           }
         }
       }
 
     }
   }
-  #if 0
-   ossimIrect tempViewRect = rectInfo.getViewRect();
-   if(rectInfo.imageIsNan())
-   {
-      return;
-   } 
-
-  if(tempViewRect.width() <2 ||
-      tempViewRect.height() <2)
-  {
-      if(!rectInfo.imageHasNans())
-      {
-         fillTile(outputData,
-                  rectInfo);
-      }
-      return;
-  }
-  //
-  std::vector<ossimRendererSubRectInfo> splitRects;
-  rectInfo.splitView(splitRects);
+}
 
-//std::cout << "SHOULD BE SPLITTING: " << splitRects.size() <<"\n";
-  ossim_uint32 idx = 0;
-  if(!splitRects.empty())
-  {
-   // std::cout << "SPLITTING " << level << ", " << tempViewRect << "\n";
-    for(idx = 0; idx < splitRects.size();++idx)
-    {
-      recursiveResample(outputData,
-                        splitRects[idx],
-                        level + 1);
-    }
-  }
-  else if(!rectInfo.imageHasNans())
-  {
-    fillTile(outputData,
-            rectInfo);
-  }
-  #endif
+void ossimImageRenderer::fillTile(ossimRefPtr<ossimImageData> outputData,
+                                  const SubRectList& subRects)
+{
+   for(SubRectList::const_iterator iter = subRects.begin(); iter != subRects.end(); ++iter)
+   {
+      fillTile(outputData, *iter);
+   }
 }
 
 #define RSET_SEARCH_THRESHHOLD 0.1
@@ -1823,6 +1859,10 @@ void ossimImageRenderer::initializeBoundingRects()
    {
       m_viewRect.makeNan();
    }
+   else
+   {
+      updateTransformStateHash();
+   }
    
 #if 0 /* Please leave for debug. */
    ossimNotify(ossimNotifyLevel_DEBUG)
@@ -1932,6 +1972,15 @@ bool ossimImageRenderer::loadState(const ossimKeywordlist& kwl, const char* pref
       m_interpErrorThreshold = threshold.toDouble();
    }
 
+   // Cached grids belong to the transform just replaced.
+   clearTransformCache();
+   const char* transformCacheSize = kwl.find(prefix, "transform_cache_size");
+   if(transformCacheSize)
+   {
+      // Megabytes.
+      setTransformCacheSize(ossimString(transformCacheSize).toUInt64()*1024*1024);
+   }
+
    return result;
 }
 
@@ -2646,6 +2695,9 @@ ossimString ossimImageRenderer::getShortName() const
 
 void ossimImageRenderer::refreshEvent(ossimRefreshEvent& event)
 {
+   // Input pixels or geometry may have changed underneath the cached grids.
+   clearTransformCache();
+   
    ossimImageSourceFilter::refreshEvent(event);
    ossimImageSourceFilter::initialize(); // init connections
    if((event.getObject()!=this)&&
@@ -2691,3 +2743,165 @@ void ossimImageRenderer::setEnableFlag(bool flag)
       initialize();
    }
 }
+
+void ossimImageRenderer::setTransformCacheSize(ossim_uint64 bytes)
+{
+   m_transformCacheSize = bytes;
+   if ( m_transformCacheSize == 0 )
+   {
+      clearTransformCache();
+   }
+   else
+   {
+      trimTransformCache(m_transformCacheSize);
+      if ( !m_rectsDirty )
+      {
+         updateTransformStateHash();
+      }
+   }
+}
+
+ossim_uint64 ossimImageRenderer::getTransformCacheSize() const
+{
+   return m_transformCacheSize;
+}
+
+ossim_uint64 ossimImageRenderer::getTransformCacheBytes() const
+{
+   return m_transformCacheBytes;
+}
+
+void ossimImageRenderer::clearTransformCache()
+{
+   m_transformGridMap.clear();
+   m_transformGridList.clear();
+   m_transformCacheBytes = 0;
+}
+
+bool ossimImageRenderer::prefetchElevation(const ossimIrect& viewRect) const
+{
+   bool result = false;
+   const ossimImageViewProjectionTransform* ivpt =
+      dynamic_cast<const ossimImageViewProjectionTransform*>(m_ImageViewTransform.get());
+   if ( isSourceEnabled() && ivpt && ivpt->getImageGeometry() && ivpt->getViewGeometry() &&
+        ivpt->getImageGeometry()->isAffectedByElevation() && !viewRect.hasNans() )
+   {
+      // Corners and edge midpoints, for views that are not north up.  Projecting at the
+      // ellipsoid keeps the view projection from looking up elevation itself.
+      const ossimImageGeometry* view = ivpt->getViewGeometry();
+      const ossimDpt ul = viewRect.ul();
+      const ossimDpt lr = viewRect.lr();
+      const ossimDpt mid = viewRect.midPoint();
+      const ossimDpt pts[8] = { ul, ossimDpt(mid.x, ul.y), ossimDpt(lr.x, ul.y),
+                                ossimDpt(lr.x, mid.y), lr, ossimDpt(mid.x, lr.y),
+                                ossimDpt(ul.x, lr.y), ossimDpt(ul.x, mid.y) };
+      ossimGrect footprint;
+      footprint.makeNan();
+      for ( ossim_uint32 i = 0; i < 8; ++i )
+      {
+         ossimGpt gpt;
+         if ( view->localToWorld( pts[i], 0.0, gpt ) && !gpt.isLatLonNan() )
+         {
+            footprint.expandToInclude( gpt );
+         }
+      }
+      result = ossimElevManager::instance()->prefetch( footprint );
+   }
+   return result;
+}
+
+bool ossimImageRenderer::TransformGridKey::operator<(const TransformGridKey& rhs) const
+{
+   if ( m_stateHash != rhs.m_stateHash ) return m_stateHash < rhs.m_stateHash;
+   if ( m_resLevel  != rhs.m_resLevel )  return m_resLevel  < rhs.m_resLevel;
+   if ( m_ul.y != rhs.m_ul.y ) return m_ul.y < rhs.m_ul.y;
+   if ( m_ul.x != rhs.m_ul.x ) return m_ul.x < rhs.m_ul.x;
+   if ( m_lr.y != rhs.m_lr.y ) return m_lr.y < rhs.m_lr.y;
+   return m_lr.x < rhs.m_lr.x;
+}
+
+const ossimImageRenderer::SubRectList* ossimImageRenderer::findTransformGrid(
+   const ossimIrect& tileRect, ossim_uint32 resLevel)
+{
+   const SubRectList* result = 0;
+   TransformGridKey key;
+   key.m_stateHash = m_transformStateHash;
+   key.m_ul        = tileRect.ul();
+   key.m_lr        = tileRect.lr();
+   key.m_resLevel  = resLevel;
+
+   TransformGridMap::iterator iter = m_transformGridMap.find(key);
+   if ( iter != m_transformGridMap.end() )
+   {
+      // Move to the front of the LRU list.
+      m_transformGridList.splice(m_transformGridList.begin(), m_transformGridList, iter->second);
+      result = &(iter->second->second);
+   }
+   return result;
+}
+
+void ossimImageRenderer::addTransformGrid(const ossimIrect& tileRect,
+                                          ossim_uint32 resLevel,
+                                          const SubRectList& subRects)
+{
+   const ossim_uint64 bytes = sizeof(TransformGridKey) +
+      subRects.size()*sizeof(ossimRendererSubRectInfo);
+   if ( bytes > m_transformCacheSize )
+   {
+      return;
+   }
+
+   TransformGridKey key;
+   key.m_stateHash = m_transformStateHash;
+   key.m_ul        = tileRect.ul();
+   key.m_lr        = tileRect.lr();
+   key.m_resLevel  = resLevel;
+   if ( m_transformGridMap.find(key) != m_transformGridMap.end() )
+   {
+      return;
+   }
+
+   trimTransformCache(m_transformCacheSize - bytes);
+
+   m_transformGridList.push_front(std::make_pair(key, subRects));
+
+   // fillTile only needs the corners and scales; don't keep the transform alive.
+   SubRectList& cached = m_transformGridList.front().second;
+   for(SubRectList::iterator iter = cached.begin(); iter != cached.end(); ++iter)
+   {
+      iter->m_transform  = 0;
+      iter->m_viewBounds = 0;
+   }
+   m_transformGridMap[key] = m_transformGridList.begin();
+   m_transformCacheBytes += bytes;
+}
+
+void ossimImageRenderer::trimTransformCache(ossim_uint64 maxBytes)
+{
+   while ( !m_transformGridList.empty() && (m_transformCacheBytes > maxBytes) )
+   {
+      TransformGridList::iterator last = --m_transformGridList.end();
+      m_transformCacheBytes -= sizeof(TransformGridKey) +
+         last->second.size()*sizeof(ossimRendererSubRectInfo);
+      m_transformGridMap.erase(last->first);
+      m_transformGridList.erase(last);
+   }
+}
+
+void ossimImageRenderer::updateTransformStateHash()
+{
+   m_transformStateHash = 0;
+   if ( m_transformCacheSize && m_ImageViewTransform.valid() )
+   {
+      //---
+      // The transform state saves both the image and view geometries for a
+      // projection IVT.  The input rect and threshold go in as well since the
+      // splits depend on m_viewArea and the interpolation error.
+      //---
+      ossimKeywordlist kwl;
+      m_ImageViewTransform->saveState(kwl, "ivt.");
+      kwl.add("input_rect", m_inputR0Rect.toString().c_str());
+      kwl.add("interpolation_error_threshold", m_interpErrorThreshold);
+      m_transformStateHash = std::hash<std::string>()(kwl.toString().string());
+   }
+}
@@ -17,8 +17,10 @@
 #include <ossim/base/ossimDrect.h>
 #include <ossim/base/ossimIrect.h>
 #include <ossim/base/ossimTrace.h>
+#include <ossim/base/ossimVisitor.h>
 #include <ossim/imaging/ossimImageData.h>
 #include <ossim/imaging/ossimImageDataFactory.h>
+#include <ossim/imaging/ossimImageRenderer.h>
 #include <ossim/imaging/ossimImageWriter.h>
 #include <ossim/base/ossimMultiResLevelHistogram.h>
 
@@ -42,7 +44,8 @@ ossimImageSourceSequencer::ossimImageSourceSequencer(ossimImageSource* inputSour
     theNumberOfTilesHorizontal(0),
     theNumberOfTilesVertical(0),
     theCurrentTileNumber(0),
-    theCreateHistogram(false)
+    theCreateHistogram(false),
+    thePrefetchRenderer(0)
 {
    ossim::defaultTileSize(theTileSize);
    theAreaOfInterest.makeNan();
@@ -134,9 +137,17 @@ void ossimImageSourceSequencer::updateTileDimensions()
 void ossimImageSourceSequencer::initialize()
 {
    theInputConnection = PTR_CAST(ossimImageSource, getInput(0));
+   thePrefetchRenderer = 0;
 
    if(theInputConnection)
    {
+      ossimTypeNameVisitor visitor( ossimString("ossimImageRenderer"),
+                                    true, // firstofTypeFlag
+                                    (ossimVisitor::VISIT_INPUTS|
+                                     ossimVisitor::VISIT_CHILDREN) );
+      theInputConnection->accept( visitor );
+      thePrefetchRenderer = visitor.getObjectAs<ossimImageRenderer>(0);
+
       if(theTileSize.hasNans())
       {
          theTileSize.x = theInputConnection->getTileWidth();
@@ -333,6 +344,10 @@ ossimRefPtr<ossimImageData> ossimImageSourceSequencer::getNextTile( ossim_uint32
       if ( getTileRect( theCurrentTileNumber, tileRect ) )
       {
          ++theCurrentTileNumber;
+
+         // Load the elevation for the next tile while this one is resampled.
+         prefetchElevation( theCurrentTileNumber );
+
          result = theInputConnection->getTile(tileRect, resLevel);
          if( !result.valid() || !result->getBuf() )
          {	 
@@ -450,6 +465,15 @@ bool ossimImageSourceSequencer::getTileRect(ossim_int64 tile_id, ossimIrect& til
    return result;
 }
 
+void ossimImageSourceSequencer::prefetchElevation(ossim_int64 tileId) const
+{
+   ossimIrect tileRect;
+   if ( thePrefetchRenderer.valid() && getTileRect( tileId, tileRect ) )
+   {
+      thePrefetchRenderer->prefetchElevation( tileRect );
+   }
+}
+
 double ossimImageSourceSequencer::getNullPixelValue(ossim_uint32 band)const
 {
    if (theInputConnection)
@@ -81,9 +81,16 @@ void ossimImageWriterFactoryRegistry::getTypeNameList(std::vector<ossimString>&
 
 ossimImageFileWriter *ossimImageWriterFactoryRegistry::createWriterFromExtension(const ossimString& fileExtension)const
 {
+   // Stop at the first factory with a writer for the extension so later factories, including
+   // deferred plugin factories, are not asked.
    ossimImageFileWriter *writer = NULL;
    ossimImageWriterFactoryBase::ImageFileWriterList result;
-   getImageFileWritersBySuffix(result, fileExtension);
+   vector<ossimImageWriterFactoryBase*>::const_iterator factories = m_factoryList.begin();
+   while((factories != m_factoryList.end()) && result.empty())
+   {
+      (*factories)->getImageFileWritersBySuffix(result, fileExtension);
+      ++factories;
+   }
    if(!result.empty())
    {
       writer = result[0].release();
@@ -15,11 +15,14 @@
 
 #include <ossim/imaging/ossimLasReader.h>
 #include <ossim/base/ossimBooleanProperty.h>
+#include <ossim/base/ossimByteStreamBuffer.h>
 #include <ossim/base/ossimCommon.h>
+#include <ossim/base/ossimDate.h>
 #include <ossim/base/ossimIpt.h>
 #include <ossim/base/ossimGpt.h>
 #include <ossim/base/ossimEndian.h>
 #include <ossim/base/ossimKeywordlist.h>
+#include <ossim/base/ossimPreferences.h>
 #include <ossim/base/ossimProperty.h>
 #include <ossim/base/ossimString.h>
 #include <ossim/base/ossimStringProperty.h>
@@ -40,6 +43,7 @@
 
 #include <ossim/support_data/ossimTiffInfo.h>
 
+#include <algorithm>
 #include <fstream>
 #include <limits>
 #include <sstream>
@@ -53,6 +57,13 @@ static ossimTrace traceDebug("ossimLasReader:debug");
 static const char GSD_KW[]  = "gsd";
 static const char SCAN_KW[] = "scan"; // boolean
 
+// Point records are read in blocks of at most this many.
+static const ossim_uint64 RECORDS_PER_READ = 65536;
+
+// Zeroed bytes after the last record read, for point record types whose readStream reads
+// more than the header record length.
+static const ossim_uint64 RECORD_PAD = 64;
+
 ossimLasReader::ossimLasReader()
    : ossimImageHandler(),
      m_str(),
@@ -68,7 +79,10 @@ ossimLasReader::ossimLasReader()
      m_mutex(),
      m_scan(false), // ???
      m_units(OSSIM_METERS),
-     m_unitConverter(0)   
+     m_unitConverter(0),
+     m_index(),
+     m_indexInitialized(false),
+     m_recordBuf()
 {
    //---
    // Nan out as can be set in several places, i.e. setProperty,
@@ -150,6 +164,10 @@ bool ossimLasReader::open()
 
 void ossimLasReader::completeOpen()
 {
+   if ( theOpenOverviewFlag )
+   {
+      openOverview();
+   }
    establishDecimationFactors();
 }
 
@@ -163,6 +181,9 @@ void ossimLasReader::close()
       m_entry = 0;
       m_tile  = 0;
       m_proj  = 0;
+      m_index.clear();
+      m_indexInitialized = false;
+      std::vector<char>().swap( m_recordBuf );
       ossimImageHandler::close();
    }
 }
@@ -198,8 +219,13 @@ bool ossimLasReader::getTile(ossimImageData* result, ossim_uint32 resLevel)
 
    bool status = false;
 
+   // Reduced resolution levels come from the overview if there is one.
+   if ( resLevel && getOverviewTile( resLevel, result ) )
+   {
+      return true;
+   }
 
-   if ( m_hdr && result && (result->getScalarType() == OSSIM_FLOAT32||result->getScalarType() == OSSIM_UINT16) &&
+   if ( m_hdr && m_hdr->getPointDataRecordLength() && result && (result->getScalarType() == OSSIM_FLOAT32||result->getScalarType() == OSSIM_UINT16) &&
         (result->getDataObjectStatus() != OSSIM_NULL) &&
         !m_ul.hasNans() && !m_gsd.hasNans() )
    {
@@ -248,52 +274,82 @@ bool ossimLasReader::getTile(ossimImageData* result, ossim_uint32 resLevel)
       const ossim_float64 OFFSET_Y = m_hdr->getOffsetY();
       const ossim_float64 OFFSET_Z = m_hdr->getOffsetZ();
 
+      const ossim_uint64 REC_LEN = m_hdr->getPointDataRecordLength();
+
       // Create array of buckets.
       std::vector<ossimLasReader::Bucket> bucket( TILE_SIZE );
 
+      std::lock_guard<std::mutex> lock( m_mutex );
+
+      // Get the runs of records that can fall in the tile, or all of them without an index.
+      if ( !m_indexInitialized )
+      {
+         initIndex();
+      }
+      std::vector<ossimLasPointIndex::Range> ranges;
+      if ( m_index.valid() )
+      {
+         m_index.getRanges( UL_PROG_PT.x, LR_PROG_PT.y, LR_PROG_PT.x, UL_PROG_PT.y, ranges );
+      }
+      else
+      {
+         ossimLasPointIndex::Range all;
+         all.first = 0;
+         all.count = getNumberOfRecords();
+         ranges.push_back( all );
+      }
+
       // Loop through the point data.
       ossimLasPointRecordInterface* lasPtRec = getNewPointRecord();
       ossimDpt lasPt;
 
-      m_str.clear();
-      m_str.seekg(m_hdr->getOffsetToPointData());
-
-      while ( m_str.good() )
+      for ( std::size_t r = 0; r < ranges.size(); ++r )
       {
-         // m_str.read((char*)lasPtRec, 28);
-         lasPtRec->readStream( m_str );
-
-         //if ( lasPtRec->getReturnNumber() == ENTRY )
-         //{
-         lasPt.x = lasPtRec->getX() * SCALE_X + OFFSET_X;
-         lasPt.y = lasPtRec->getY() * SCALE_Y + OFFSET_Y;
-         if ( m_unitConverter )
+         const ossim_uint64 END = ranges[r].first + ranges[r].count;
+         for ( ossim_uint64 first = ranges[r].first; first < END; first += RECORDS_PER_READ )
          {
-            convertToMeters(lasPt.x);
-            convertToMeters(lasPt.y);
-         }
-         if ( PROJ_RECT.pointWithin( lasPt ) )
-         {
-            // Compute the bucket index:
-            ossim_int32 line = static_cast<ossim_int32>((UL_PROG_PT.y - lasPt.y) / scale.y);
-            ossim_int32 samp = static_cast<ossim_int32>((lasPt.x - UL_PROG_PT.x) / scale.x );
-            ossim_int32 bucketIndex = line * TILE_WIDTH + samp;
-               
-            // Range check and add if in there.
-            if ( ( bucketIndex >= 0 ) && ( bucketIndex < TILE_SIZE ) )
+            const ossim_uint64 COUNT = readRecords( first, std::min(RECORDS_PER_READ, END - first) );
+            if ( !COUNT )
+            {
+               break;
+            }
+            ossimByteStreamBuffer buf( &m_recordBuf.front(), (ossim_int64)m_recordBuf.size(), true );
+            std::istream is( &buf );
+
+            for ( ossim_uint64 i = 0; i < COUNT; ++i )
             {
-               ossim_float64 z = lasPtRec->getZ() * SCALE_Z + OFFSET_Z;
-               if (  m_unitConverter ) convertToMeters(z);
-               bucket[bucketIndex].add( z ); 
-               bucket[bucketIndex].setRed(lasPtRec->getRed());
-               bucket[bucketIndex].setGreen(lasPtRec->getGreen());
-               bucket[bucketIndex].setBlue(lasPtRec->getBlue());
-               bucket[bucketIndex].setIntensity(lasPtRec->getIntensity());
+               is.clear();
+               is.seekg( (std::streamoff)(i * REC_LEN) );
+               lasPtRec->readStream( is );
 
+               lasPt.x = lasPtRec->getX() * SCALE_X + OFFSET_X;
+               lasPt.y = lasPtRec->getY() * SCALE_Y + OFFSET_Y;
+               if ( m_unitConverter )
+               {
+                  convertToMeters(lasPt.x);
+                  convertToMeters(lasPt.y);
+               }
+               if ( PROJ_RECT.pointWithin( lasPt ) )
+               {
+                  // Compute the bucket index:
+                  ossim_int32 line = static_cast<ossim_int32>((UL_PROG_PT.y - lasPt.y) / scale.y);
+                  ossim_int32 samp = static_cast<ossim_int32>((lasPt.x - UL_PROG_PT.x) / scale.x );
+                  ossim_int32 bucketIndex = line * TILE_WIDTH + samp;
+               
+                  // Range check and add if in there.
+                  if ( ( bucketIndex >= 0 ) && ( bucketIndex < TILE_SIZE ) )
+                  {
+                     ossim_float64 z = lasPtRec->getZ() * SCALE_Z + OFFSET_Z;
+                     if (  m_unitConverter ) convertToMeters(z);
+                     bucket[bucketIndex].add( z ); 
+                     bucket[bucketIndex].setRed(lasPtRec->getRed());
+                     bucket[bucketIndex].setGreen(lasPtRec->getGreen());
+                     bucket[bucketIndex].setBlue(lasPtRec->getBlue());
+                     bucket[bucketIndex].setIntensity(lasPtRec->getIntensity());
+                  }
+               }
             }
          }
-         //}
-         if ( m_str.eof() ) break;
       }
       delete lasPtRec;
       lasPtRec = 0;
@@ -439,6 +495,7 @@ ossim_uint32 ossimLasReader::getCurrentEntry() const
 bool ossimLasReader::setCurrentEntry(ossim_uint32 entryIdx)
 {
    bool result = false;
+   const bool CHANGED = ( entryIdx != m_entry );
    if ( isOpen() )
    {
       std::vector<ossim_uint32> entryList;
@@ -454,7 +511,16 @@ bool ossimLasReader::setCurrentEntry(ossim_uint32 entryIdx)
          ++i;
       }
    }
-   if(result) initTile();
+   if(result)
+   {
+      initTile();
+      if ( CHANGED )
+      {
+         // Each entry has its own overview.
+         theOverviewFile.clear();
+         completeOpen();
+      }
+   }
    return result;
 }
 
@@ -1263,6 +1329,140 @@ ossimLasPointRecordInterface* ossimLasReader::getNewPointRecord() const
    return result;
 }
 
+void ossimLasReader::initIndex()
+{
+   static const char M[] = "ossimLasReader::initIndex";
+
+   m_indexInitialized = true;
+   m_index.clear();
+
+   const ossim_uint64 NUM_RECORDS = getNumberOfRecords();
+   if ( !NUM_RECORDS || m_ul.hasNans() || m_lr.hasNans() )
+   {
+      return;
+   }
+
+   // The sidecar is only good for this version of the file and these bounds.
+   ossimFilename indexFile;
+   getFilenameWithThisExt( ossimString(".lpi"), indexFile );
+   const ossim_uint64 FILE_SIZE = theImageFile.fileSize();
+   ossim_int64 modTime = 0;
+   ossimLocalTm tm;
+   if ( theImageFile.getTimes( 0, &tm, 0 ) )
+   {
+      modTime = (ossim_int64)tm.getEpoc();
+   }
+
+   if ( m_index.read( indexFile, FILE_SIZE, modTime, NUM_RECORDS ) )
+   {
+      ossim_float64 minX, minY, maxX, maxY;
+      m_index.getBounds( minX, minY, maxX, maxY );
+      if ( (minX == m_ul.x) && (maxY == m_ul.y) && (maxX == m_lr.x) && (minY == m_lr.y) )
+      {
+         if ( traceDebug() )
+         {
+            ossimNotify(ossimNotifyLevel_DEBUG) << M << " read " << indexFile << "\n";
+         }
+         return;
+      }
+      m_index.clear();
+   }
+
+   const ossim_float64 SCALE_X  = m_hdr->getScaleFactorX();
+   const ossim_float64 SCALE_Y  = m_hdr->getScaleFactorY();
+   const ossim_float64 OFFSET_X = m_hdr->getOffsetX();
+   const ossim_float64 OFFSET_Y = m_hdr->getOffsetY();
+   const ossim_uint64  REC_LEN  = m_hdr->getPointDataRecordLength();
+
+   m_index.initialize( m_ul.x, m_lr.y, m_lr.x, m_ul.y, NUM_RECORDS );
+
+   ossimLasPointRecordInterface* lasPtRec = getNewPointRecord();
+   ossimDpt lasPt;
+   ossim_uint64 record = 0;
+   while ( record < NUM_RECORDS )
+   {
+      const ossim_uint64 COUNT =
+         readRecords( record, std::min(RECORDS_PER_READ, NUM_RECORDS - record) );
+      if ( !COUNT )
+      {
+         break;
+      }
+      ossimByteStreamBuffer buf( &m_recordBuf.front(), (ossim_int64)m_recordBuf.size(), true );
+      std::istream is( &buf );
+
+      for ( ossim_uint64 i = 0; i < COUNT; ++i, ++record )
+      {
+         is.clear();
+         is.seekg( (std::streamoff)(i * REC_LEN) );
+         lasPtRec->readStream( is );
+
+         lasPt.x = lasPtRec->getX() * SCALE_X + OFFSET_X;
+         lasPt.y = lasPtRec->getY() * SCALE_Y + OFFSET_Y;
+         if ( m_unitConverter )
+         {
+            convertToMeters(lasPt.x);
+            convertToMeters(lasPt.y);
+         }
+         m_index.add( record, lasPt.x, lasPt.y );
+      }
+   }
+   delete lasPtRec;
+   lasPtRec = 0;
+
+   m_index.finalize();
+
+   //---
+   // A sidecar found is always used, one is written only with the las_reader.point_index
+   // preference on since data directories may be read only or shared.  Not being able to
+   // write it only costs the next open.
+   //---
+   bool written =
+      ossimString( ossimPreferences::instance()->
+                   findPreference( "las_reader.point_index" ) ).toBool() &&
+      m_index.write( indexFile, FILE_SIZE, modTime );
+   if ( traceDebug() )
+   {
+      ossimNotify(ossimNotifyLevel_DEBUG)
+         << M << " indexed " << record << " points, "
+         << (written ? "wrote " : "could not write ") << indexFile << "\n";
+   }
+}
+
+ossim_uint64 ossimLasReader::readRecords(ossim_uint64 first, ossim_uint64 count)
+{
+   const ossim_uint64 REC_LEN = m_hdr->getPointDataRecordLength();
+   const ossim_uint64 BYTES   = count * REC_LEN;
+   m_recordBuf.resize( (std::size_t)(BYTES + RECORD_PAD) );
+
+   m_str.clear();
+   m_str.seekg( (std::streamoff)(m_hdr->getOffsetToPointData() + first * REC_LEN),
+                std::ios_base::beg );
+   m_str.read( &m_recordBuf.front(), (std::streamsize)BYTES );
+
+   const ossim_uint64 BYTES_READ = (ossim_uint64)m_str.gcount();
+   std::fill( m_recordBuf.begin() + (std::size_t)BYTES_READ, m_recordBuf.end(), 0 );
+
+   return BYTES_READ / REC_LEN;
+}
+
+ossim_uint64 ossimLasReader::getNumberOfRecords() const
+{
+   ossim_uint64 result = 0;
+   const ossim_uint64 REC_LEN = m_hdr ? m_hdr->getPointDataRecordLength() : 0;
+   if ( REC_LEN )
+   {
+      // Trust the file size over the header count.
+      const ossim_uint64 FILE_SIZE = theImageFile.fileSize();
+      const ossim_uint64 OFFSET    = m_hdr->getOffsetToPointData();
+      result = ( FILE_SIZE > OFFSET ) ? (FILE_SIZE - OFFSET) / REC_LEN : 0;
+      if ( m_hdr->getNumberOfPoints() )
+      {
+         result = std::min( result, m_hdr->getNumberOfPoints() );
+      }
+   }
+   return result;
+}
+
 void ossimLasReader::getScale(ossimDpt& scale, ossim_uint32 resLevel) const
 {
    // std::pow(2.0, 0) returns 1.
@@ -14,6 +14,7 @@
 #include <ossim/imaging/ossimNitfTileSource.h>
 #include <ossim/base/ossimConstants.h>
 #include <ossim/base/ossimCommon.h>
+#include <ossim/base/ossimDate.h>
 #include <ossim/base/ossimTrace.h>
 #include <ossim/base/ossimNotifyContext.h>
 #include <ossim/base/ossimIpt.h>
@@ -23,6 +24,7 @@
 #include <ossim/base/ossimKeywordlist.h>
 #include <ossim/base/ossimInterleaveTypeLut.h>
 #include <ossim/base/ossimPackedBits.h>
+#include <ossim/base/ossimPreferences.h>
 #include <ossim/base/ossimScalarTypeLut.h>
 #include <ossim/base/ossimEndian.h>
 #include <ossim/base/ossimBooleanProperty.h>
@@ -36,6 +38,7 @@
 #include <ossim/base/ossimContainerProperty.h>
 #include <ossim/projection/ossimProjectionFactoryRegistry.h>
 #include <ossim/support_data/ossimNitfIchipbTag.h>
+#include <ossim/support_data/ossimNitfJpegBlockIndex.h>
 #include <ossim/support_data/ossimNitfImageHeaderV2_0.h>
 #include <ossim/support_data/ossimNitfImageHeaderV2_1.h>
 #include <ossim/support_data/ossimNitfStdidcTag.h>
@@ -166,6 +169,92 @@ bool ossimNitfTileSource::isOpen()const
    return (theNitfImageHeader.size() > 0);
 }
 
+bool ossimNitfTileSource::supportsConcurrentReads() const
+{
+   //---
+   // Derived readers(e.g. ossimQuickbirdNitfTileSource) carry extra state
+   // this class does not know how to copy.
+   //
+   // The block buffers are allocated on the first getTile, so check that
+   // allocate() set up the entry rather than theCacheTile; the reader
+   // allocates its own buffers.
+   //---
+   bool result = isOpen() && theFileStr &&
+      ( theCacheTileInterLeaveType != OSSIM_INTERLEAVE_UNKNOWN ) &&
+      ( getClassName() == STATIC_TYPE_NAME(ossimNitfTileSource) );
+   if ( result && theOverview.valid() )
+   {
+      result = theOverview->supportsConcurrentReads();
+   }
+   return result;
+}
+
+ossimRefPtr<ossimImageHandler> ossimNitfTileSource::createConcurrentReader() const
+{
+   static const char MODULE[] = "ossimNitfTileSource::createConcurrentReader";
+
+   ossimRefPtr<ossimImageHandler> result = 0;
+   if ( !supportsConcurrentReads() )
+   {
+      return result;
+   }
+
+   ossimRefPtr<ossimNitfTileSource> reader = new ossimNitfTileSource();
+   if ( !initConcurrentReader( reader.get() ) )
+   {
+      return result;
+   }
+
+   // Headers are shared, they are not modified after parseFile().
+   reader->theNitfFile                = theNitfFile;
+   reader->theNitfImageHeader         = theNitfImageHeader;
+   reader->theReadMode                = theReadMode;
+   reader->theScalarType              = theScalarType;
+   reader->theSwapBytesFlag           = theSwapBytesFlag;
+   reader->theNumberOfInputBands      = theNumberOfInputBands;
+   reader->theNumberOfOutputBands     = theNumberOfOutputBands;
+   reader->theBlockSizeInBytes        = theBlockSizeInBytes;
+   reader->theReadBlockSizeInBytes    = theReadBlockSizeInBytes;
+   reader->theNumberOfImages          = theNumberOfImages;
+   reader->theCurrentEntry            = theCurrentEntry;
+   reader->theImageRect               = theImageRect;
+   reader->theSelectorBandList        = theSelectorBandList;
+   reader->theOutputBandList          = theOutputBandList;
+   reader->theCacheSize               = theCacheSize;
+   reader->theCacheTileInterLeaveType = theCacheTileInterLeaveType;
+   reader->theEntryList               = theEntryList;
+   reader->thePackedBitsFlag          = thePackedBitsFlag;
+   reader->theBlockImageRect          = theBlockImageRect;
+   reader->theNitfBlockOffset         = theNitfBlockOffset;
+   reader->theNitfBlockSize           = theNitfBlockSize;
+   reader->m_jpegOffsetsDirty         = m_jpegOffsetsDirty;
+
+   //---
+   // The application cache id belongs to this source; deleteCache on close
+   // of one reader would pull it out from under the others.
+   //---
+   reader->theCacheEnabledFlag        = false;
+
+   reader->theFileStr = ossim::StreamFactoryRegistry::instance()->createIstream(
+      theImageFile, ios::in | ios::binary);
+   if ( !reader->theFileStr )
+   {
+      if (traceDebug())
+      {
+         ossimNotify(ossimNotifyLevel_DEBUG)
+            << MODULE << " ERROR:"
+            << "\nCannot open:  " << theImageFile.c_str() << endl;
+      }
+      return result;
+   }
+
+   if ( reader->allocateBuffers() )
+   {
+      result = reader.get();
+   }
+   return result;
+}
+
 bool ossimNitfTileSource::open()
 {
    bool result = false;
@@ -3238,138 +3327,54 @@ bool ossimNitfTileSource::scanForJpegBlockOffsets()
    ossim_uint32 total_blocks = hdr->getNumberOfBlocksPerRow()*hdr->getNumberOfBlocksPerCol();
    
    //---
-   // NOTE:
-   // SOI = 0xffd8 Start of image
-   // EOI = 0xffd9 End of image
-   // DHT = 0xffc4 Define Huffman Table(s)
-   // DQT = 0xffdb Define Quantization Table(s)
+   // The scan reads the whole segment, so its result can be kept in a sidecar file stamped
+   // with the size and modification time of the nitf and read back on later opens.  A sidecar
+   // found is always used, one is written only with the nitf_reader.jpeg_block_index
+   // preference on since data directories may be read only or shared.
    //---
-
-   // Seek to the first block.
-   theFileStr->seekg(hdr->getDataLocation(), ios::beg);
-
-   if ( theFileStr->good() )
+   const std::streamoff startOfData = hdr->getDataLocation();
+   const ossimFilename indexFile = getFilenameWithThisExtension(ossimString(".jbi"));
+   const ossim_uint64 fileSize = theImageFile.fileSize();
+   ossim_int64 modTime = 0;
+   ossimLocalTm tm;
+   if ( theImageFile.getTimes( 0, &tm, 0 ) )
    {
-      const ossim_uint8 AP6 = 0xe6;
-      const ossim_uint8 AP7 = 0xe7;
-      const ossim_uint8 DHT = 0xc4;
-      const ossim_uint8 DQT = 0xdb;
-      const ossim_uint8 EOI = 0xd9;
-      const ossim_uint8 FF  = 0xff;
-      const ossim_uint8 SOI = 0xd8;
-      const ossim_uint8 SOS = 0xda;
-
-      union
-      {
-         char c;
-         ossim_uint8 uc;
-      } ct;
+      modTime = (ossim_int64)tm.getEpoc();
+   }
 
-      std::streamoff soiOffset = 0;
-      std::streamoff eoiOffset = 0;
-      ossim_uint16   length    = 0;
+   // Streams that are not local files, e.g. urls, get scanned every time.
+   const bool useSidecar = theImageFile.exists();
 
-      ossimEndian* swapper = 0;
-      if ( ossim::byteOrder() == OSSIM_LITTLE_ENDIAN )
+   ossimNitfJpegBlockIndex index;
+   if ( useSidecar && index.read( indexFile, fileSize, modTime, startOfData, total_blocks ) )
+   {
+      if ( traceDebug() )
       {
-         swapper = new ossimEndian();
+         ossimNotify(ossimNotifyLevel_DEBUG)
+            << "ossimNitfTileSource::scanForJpegBlockOffsets read " << indexFile << "\n";
       }
-      
-      // Find all the SOI markers.
-      while ( theFileStr->get( ct.c ) && !allBlocksFound ) 
-      {
-         if ( ct.uc == FF ) // Found FF byte.
-         {
-            // Loop to skip multiple 0xff's in cases like FF FF D8
-            while ( theFileStr->get( ct.c ) )
-            {
-               if ( ct.uc != FF)
-               {
-                  break;
-               }
-            }
-         
-            if ( ct.uc == SOI ) 
-            {
-               // At SOI 0xFFD8 marker... SOI marker offset is two bytes back.
-               soiOffset = ((std::streamoff)theFileStr->tellg()) - 2;
-
-               // Now look for matching EOI.
-               while ( theFileStr->get( ct.c ) )
-               {
-                  if ( ct.uc == FF ) // Found FF byte.
-                  {
-                     // Loop to skip multiple 0xff's in cases like FF FF D8
-                     while ( theFileStr->get( ct.c ) )
-                     {
-                        if ( ct.uc != FF )
-                        {
-                           break;
-                        }
-                     }
-
-                     if ( ct.uc == EOI )
-                     {
-                        // At EOI 0xD9marker...
-                        eoiOffset = theFileStr->tellg();
-
-                        // Capture offset:
-                        theNitfBlockOffset.push_back( soiOffset );
-
-                        // Capture block size:
-                        theNitfBlockSize.push_back( eoiOffset - soiOffset );
-
-                        //---
-                        // Since there can be more than one jpeg entry in a file, breeak out of
-                        // loop when we hit block size.
-                        //---
-                        if ( theNitfBlockOffset.size() == total_blocks )
-                        {
-                           allBlocksFound = true;
-                        }
-
-                        break; // From "find EOI" while loop.
-                     }
-                     //---
-                     // These are things to skip to avoid hitting random sequence of FFD9
-                     // and picking up a false EOI.
-                     // Not a complete set of markers but all test data works.
-                     // drb - 14 May 2013.
-                     //---
-                     else if ( ( ct.uc == AP6 ) || ( ct.uc == AP7 ) || ( ct.uc == DHT ) ||
-                               ( ct.uc == DQT ) || ( ct.uc == SOS ) ||
-                               ( ( ct.uc >= 0xc0 ) && ( ct.uc <= 0xcF ) )
-                               )
-                     {
-                        // Length two byte big endian.
-                        theFileStr->read( (char*)&length, 2 );
-                        if ( swapper )
-                        {
-                           swapper->swap( length );
-                        }
-                        // Length includes two length bytes.
-
-                        // Seek to the end of the record.
-                        theFileStr->seekg( length - 2, std::ios_base::cur );
-                     }
-
-                  } //  Matches: if ( ct.uc == FF )
-                  
-               } // Matches: while ( theFileStr->get( ut.c ) ) "find EOI loop" 
-               
-            } // Matches: if ( ut.uc == SOI ) "SOI marker found"
-
-         } // Matches: if ( ut.uc == FF )
-
-      } // Matches: while ( theFileStr->get( ut.c ) && !allBlocksFound )
+   }
+   else
+   {
+      index.scan( *theFileStr, startOfData, total_blocks );
 
-      if ( swapper )
+      // Not being able to write the sidecar, e.g. a read only directory, only costs the next open.
+      bool written = useSidecar &&
+         ossimString( ossimPreferences::instance()->
+                      findPreference( "nitf_reader.jpeg_block_index" ) ).toBool() &&
+         index.write( indexFile, fileSize, modTime, startOfData, total_blocks );
+      if ( traceDebug() )
       {
-         delete swapper;
-         swapper = 0;
+         ossimNotify(ossimNotifyLevel_DEBUG)
+            << "ossimNitfTileSource::scanForJpegBlockOffsets found "
+            << index.getNumberOfBlocks() << " of " << total_blocks << " blocks, "
+            << (written ? "wrote " : "could not write ") << indexFile << "\n";
       }
+   }
 
-   } // Matches: if ( theFileStr->good() )
+   theNitfBlockOffset = index.getOffsets();
+   theNitfBlockSize   = index.getSizes();
+   allBlocksFound     = ( index.getNumberOfBlocks() == total_blocks );
 
    theFileStr->seekg(0, ios::beg);
    theFileStr->clear();
@@ -3399,7 +3404,6 @@ bool ossimNitfTileSource::scanForJpegBlockOffsets()
    }
 
 #if 0 /* Please leave for debug. (drb) */
-   std::streamoff startOfData = hdr->getDataLocation();
    ossimNotify(ossimNotifyLevel_WARN) << "current entry: " << theCurrentEntry << "\n";
    for (ossim_uint32 i = 0; i < total_blocks; ++i)
    {
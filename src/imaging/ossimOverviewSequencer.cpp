@@ -10,6 +10,7 @@
 // $Id: ossimOverviewSequencer.cpp 23377 2015-06-17 18:03:05Z okramer $
 
 #include <ossim/imaging/ossimOverviewSequencer.h>
+#include <ossim/base/ossimCommon.h>
 #include <ossim/base/ossimIpt.h>
 #include <ossim/base/ossimIrect.h>
 #include <ossim/base/ossimMultiResLevelHistogram.h>
@@ -19,8 +20,15 @@
 #include <ossim/imaging/ossimImageDataFactory.h>
 #include <ossim/imaging/ossimImageHandler.h>
 #include <ossim/support_data/ossimImageMetaData.h>
+#include <ossim/parallel/ossimJob.h>
+#include <ossim/parallel/ossimJobWorkStealingQueue.h>
 #include <ossim/parallel/ossimMpi.h>
 
+#if defined(__x86_64__) || defined(_M_X64)
+#  define OSSIM_OVERVIEW_SEQUENCER_X86 1
+#  include <emmintrin.h>
+#endif
+
 using namespace std;
 
 
@@ -30,6 +38,181 @@ static const char OSSIM_ID[] = "$Id: ossimOverviewSequencer.cpp 23377 2015-06-17
 
 static ossimTrace traceDebug("ossimOverviewSequencer:debug");
 
+namespace
+{
+   // Tiles each thread decimates per batch.
+   const ossim_uint32 TILES_PER_THREAD = 4;
+
+   // Accumulator for 2x2 box sums.  Integer types sum exactly, which
+   // truncates the same as the double math used for the other types.
+   template <class T> struct BoxAccumulator       { typedef ossim_float64 Type; };
+   template <> struct BoxAccumulator<ossim_uint8>  { typedef ossim_int32 Type; };
+   template <> struct BoxAccumulator<ossim_uint16> { typedef ossim_int32 Type; };
+   template <> struct BoxAccumulator<ossim_sint16> { typedef ossim_int32 Type; };
+   template <> struct BoxAccumulator<ossim_uint32> { typedef ossim_int64 Type; };
+   template <> struct BoxAccumulator<ossim_sint32> { typedef ossim_int64 Type; };
+
+   //---
+   // 2x2 box reduction of one output line from input lines s1 and s2.  Null
+   // inputs are left out of the average, and an output with no valid input
+   // is null.
+   //---
+   template <class T>
+   void boxLineScalar(const T* s1, const T* s2, T* d, ossim_uint32 samps, T nullPix)
+   {
+      typedef typename BoxAccumulator<T>::Type A;
+      for (ossim_uint32 j = 0; j < samps; ++j)
+      {
+         const T* p1 = s1 + 2*j;
+         const T* p2 = s2 + 2*j;
+         A value = 0;
+         ossim_int32 weight = 0;
+         if (p1[0] != nullPix) { value += p1[0]; ++weight; }
+         if (p1[1] != nullPix) { value += p1[1]; ++weight; }
+         if (p2[0] != nullPix) { value += p2[0]; ++weight; }
+         if (p2[1] != nullPix) { value += p2[1]; ++weight; }
+         d[j] = weight ? static_cast<T>( value/static_cast<A>(weight) ) : nullPix;
+      }
+   }
+
+   template <class T>
+   void boxLine(const T* s1, const T* s2, T* d, ossim_uint32 samps, T nullPix)
+   {
+      boxLineScalar(s1, s2, d, samps, nullPix);
+   }
+
+#ifdef OSSIM_OVERVIEW_SEQUENCER_X86
+   //---
+   // SSE2 versions.  Runs of input free of nulls are summed 16 (8 bit) or 8
+   // (16 bit) outputs at a time; a run containing a null goes to the scalar
+   // code.  Sums of four are exact so the results match the scalar code.
+   //---
+   void boxLine(const ossim_uint8* s1, const ossim_uint8* s2, ossim_uint8* d,
+                ossim_uint32 samps, ossim_uint8 nullPix)
+   {
+      const __m128i NULLS    = _mm_set1_epi8(static_cast<char>(nullPix));
+      const __m128i LOW_BYTE = _mm_set1_epi16(0x00ff);
+      ossim_uint32 j = 0;
+      for (; j + 16 <= samps; j += 16)
+      {
+         const __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s1 + 2*j));
+         const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s1 + 2*j + 16));
+         const __m128i a2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s2 + 2*j));
+         const __m128i b2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s2 + 2*j + 16));
+         const __m128i nulls =
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(a1, NULLS), _mm_cmpeq_epi8(b1, NULLS)),
+                         _mm_or_si128(_mm_cmpeq_epi8(a2, NULLS), _mm_cmpeq_epi8(b2, NULLS)));
+         if (_mm_movemask_epi8(nulls))
+         {
+            boxLineScalar(s1 + 2*j, s2 + 2*j, d + j, 16, nullPix);
+            continue;
+         }
+
+         // Each 16 bit lane holds a horizontal pair; add the pair and the pair below.
+         __m128i sumA = _mm_add_epi16(
+            _mm_add_epi16(_mm_and_si128(a1, LOW_BYTE), _mm_srli_epi16(a1, 8)),
+            _mm_add_epi16(_mm_and_si128(a2, LOW_BYTE), _mm_srli_epi16(a2, 8)));
+         __m128i sumB = _mm_add_epi16(
+            _mm_add_epi16(_mm_and_si128(b1, LOW_BYTE), _mm_srli_epi16(b1, 8)),
+            _mm_add_epi16(_mm_and_si128(b2, LOW_BYTE), _mm_srli_epi16(b2, 8)));
+         _mm_storeu_si128(reinterpret_cast<__m128i*>(d + j),
+                          _mm_packus_epi16(_mm_srli_epi16(sumA, 2), _mm_srli_epi16(sumB, 2)));
+      }
+      if (j < samps)
+      {
+         boxLineScalar(s1 + 2*j, s2 + 2*j, d + j, samps - j, nullPix);
+      }
+   }
+
+   void boxLine(const ossim_uint16* s1, const ossim_uint16* s2, ossim_uint16* d,
+                ossim_uint32 samps, ossim_uint16 nullPix)
+   {
+      const __m128i NULLS    = _mm_set1_epi16(static_cast<short>(nullPix));
+      const __m128i LOW_WORD = _mm_set1_epi32(0xffff);
+
+      // SSE2 has no unsigned 32 to 16 bit pack; bias into signed range and back.
+      const __m128i BIAS32   = _mm_set1_epi32(0x8000);
+      const __m128i BIAS16   = _mm_set1_epi16(static_cast<short>(0x8000));
+      ossim_uint32 j = 0;
+      for (; j + 8 <= samps; j += 8)
+      {
+         const __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s1 + 2*j));
+         const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s1 + 2*j + 8));
+         const __m128i a2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s2 + 2*j));
+         const __m128i b2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s2 + 2*j + 8));
+         const __m128i nulls =
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi16(a1, NULLS), _mm_cmpeq_epi16(b1, NULLS)),
+                         _mm_or_si128(_mm_cmpeq_epi16(a2, NULLS), _mm_cmpeq_epi16(b2, NULLS)));
+         if (_mm_movemask_epi8(nulls))
+         {
+            boxLineScalar(s1 + 2*j, s2 + 2*j, d + j, 8, nullPix);
+            continue;
+         }
+
+         __m128i sumA = _mm_add_epi32(
+            _mm_add_epi32(_mm_and_si128(a1, LOW_WORD), _mm_srli_epi32(a1, 16)),
+            _mm_add_epi32(_mm_and_si128(a2, LOW_WORD), _mm_srli_epi32(a2, 16)));
+         __m128i sumB = _mm_add_epi32(
+            _mm_add_epi32(_mm_and_si128(b1, LOW_WORD), _mm_srli_epi32(b1, 16)),
+            _mm_add_epi32(_mm_and_si128(b2, LOW_WORD), _mm_srli_epi32(b2, 16)));
+         sumA = _mm_sub_epi32(_mm_srli_epi32(sumA, 2), BIAS32);
+         sumB = _mm_sub_epi32(_mm_srli_epi32(sumB, 2), BIAS32);
+         _mm_storeu_si128(reinterpret_cast<__m128i*>(d + j),
+                          _mm_xor_si128(_mm_packs_epi32(sumA, sumB), BIAS16));
+      }
+      if (j < samps)
+      {
+         boxLineScalar(s1 + 2*j, s2 + 2*j, d + j, samps - j, nullPix);
+      }
+   }
+#endif /* #ifdef OSSIM_OVERVIEW_SEQUENCER_X86 */
+}
+
+//---
+// Decimates every thread count'th tile of the current batch starting at its
+// thread index, so each thread keeps one reader and scratch tile.
+//---
+class ossimOverviewSequencer::ResampleJob : public ossimJob
+{
+public:
+   ResampleJob(ossimOverviewSequencer* sequencer, ossim_uint32 thread)
+      : ossimJob(),
+        m_sequencer(sequencer),
+        m_thread(thread)
+   {
+   }
+
+protected:
+   virtual void run()
+   {
+      ossimOverviewSequencer* seq = m_sequencer;
+      const ossim_uint32 THREADS = static_cast<ossim_uint32>(seq->m_readers.size());
+
+      // No reader of our own means sharing the image handler.
+      ossimImageSource* source = seq->m_readers[m_thread].get();
+      std::mutex* readMutex = 0;
+      if ( !source )
+      {
+         source = seq->m_imageHandler.get();
+         readMutex = &seq->m_readMutex;
+      }
+
+      ossimRefPtr<ossimImageData> inputTile;
+      for (ossim_uint32 idx = m_thread; idx < seq->m_batchSize; idx += THREADS)
+      {
+         bool readError = false;
+         bool resampled = seq->makeTile(seq->m_batchStart + idx, source, readMutex,
+                                        inputTile, seq->m_batchTiles[idx].get(), readError);
+         seq->m_batchStatus[idx] = static_cast<ossim_uint8>(
+            readError ? TILE_READ_ERROR : (resampled ? TILE_RESAMPLED : TILE_BLANK) );
+      }
+   }
+
+private:
+   ossimOverviewSequencer* m_sequencer;
+   ossim_uint32            m_thread;
+};
+
 ossimOverviewSequencer::ossimOverviewSequencer()
    :
    ossimReferenced(),
@@ -54,7 +237,19 @@ ossimOverviewSequencer::ossimOverviewSequencer()
    m_scanForMinMaxNull(false),
    m_minValues(0),
    m_maxValues(0),
-   m_nulValues(0)
+   m_nulValues(0),
+   m_numberOfThreads(1),
+   m_jobQueue(),
+   m_readers(),
+   m_readMutex(),
+   m_batchTiles(),
+   m_batchStatus(),
+   m_batchStart(0),
+   m_batchSize(0),
+   m_inputLevel(0),
+   m_inputTile(0),
+   m_outputLevel(0),
+   m_retainOutputLevel(false)
 {
    m_areaOfInterest.makeNan();
 
@@ -73,6 +268,8 @@ ossimOverviewSequencer::ossimOverviewSequencer()
 
 ossimOverviewSequencer::~ossimOverviewSequencer()
 {
+   m_jobQueue.reset();
+   m_readers.clear();
    m_imageHandler = 0;
    m_maskFilter   = 0;
    m_maskWriter   = 0;
@@ -200,7 +397,14 @@ void ossimOverviewSequencer::initialize()
    // Check the area of interest and set from image if needed.
    if ( m_areaOfInterest.hasNans() )
    {
-      m_areaOfInterest = m_imageHandler->getImageRectangle(m_sourceResLevel);
+      if ( m_inputLevel.valid() )
+      {
+         m_areaOfInterest = m_inputLevel->getImageRectangle();
+      }
+      else
+      {
+         m_areaOfInterest = m_imageHandler->getImageRectangle(m_sourceResLevel);
+      }
    }
 
    // Check the tile size and set from image if needed.
@@ -229,6 +433,47 @@ void ossimOverviewSequencer::initialize()
       m_tile->initialize();
    }
 
+   m_inputTile = 0;
+   m_outputLevel = 0;
+   if ( m_retainOutputLevel && m_tile.valid() )
+   {
+      ossimIrect rect;
+      getOutputImageRectangle(rect);
+      m_outputLevel = static_cast<ossimImageData*>( m_tile->dup() );
+      m_outputLevel->setImageRectangle(rect);
+      m_outputLevel->makeBlank();
+   }
+
+   //---
+   // Threads.  The mask filter and writer aren't safe to share so masking
+   // stays on the calling thread.
+   //---
+   m_jobQueue.reset();
+   m_readers.clear();
+   m_batchTiles.clear();
+   m_batchStatus.clear();
+   m_batchStart = 0;
+   m_batchSize  = 0;
+   ossim_uint32 threads = m_numberOfThreads ? m_numberOfThreads : ossim::getNumberOfThreads();
+   if ( (threads > 1) && m_tile.valid() && !m_maskFilter.valid() )
+   {
+      m_jobQueue = std::make_shared<ossimJobWorkStealingQueue>(threads);
+      m_readers.resize(threads);
+      if ( !m_inputLevel.valid() && m_imageHandler->supportsConcurrentReads() )
+      {
+         for (ossim_uint32 i = 0; i < threads; ++i)
+         {
+            m_readers[i] = m_imageHandler->createConcurrentReader();
+         }
+      }
+      m_batchTiles.resize(threads*TILES_PER_THREAD);
+      for (ossim_uint32 i = 0; i < m_batchTiles.size(); ++i)
+      {
+         m_batchTiles[i] = static_cast<ossimImageData*>( m_tile->dup() );
+      }
+      m_batchStatus.resize(m_batchTiles.size(), TILE_BLANK);
+   }
+
    if (m_histoMode != OSSIM_HISTO_MODE_UNKNOWN)
    {
       m_histogram = new ossimMultiBandHistogram;
@@ -291,7 +536,10 @@ void ossimOverviewSequencer::initialize()
          << "\nresamp type:            " << m_resampleType
          << "\nscan for min max:       " << (m_scanForMinMax?"true\n":"false\n")
          << "\nscan for min, max null: " << (m_scanForMinMaxNull?"true\n":"false\n")
-         << "\nhisto mode:             " << m_histoMode << "\n";
+         << "\nhisto mode:             " << m_histoMode
+         << "\nthreads:                " << (m_jobQueue ? m_readers.size() : 1)
+         << "\ninput level in memory:  " << (m_inputLevel.valid()?"true":"false")
+         << "\nretain output level:    " << (m_retainOutputLevel?"true":"false") << "\n";
       if (m_histoMode != OSSIM_HISTO_MODE_UNKNOWN)
       {
          ossimNotify(ossimNotifyLevel_DEBUG)
@@ -312,66 +560,135 @@ ossimRefPtr<ossimImageData> ossimOverviewSequencer::getNextTile()
       return ossimRefPtr<ossimImageData>();
    }
 
+   ossimRefPtr<ossimImageData> tile;
+   bool resampled = false;
+   bool readError = false;
+
+   if ( m_jobQueue && (m_currentTileNumber < getNumberOfTiles()) )
+   {
+      if ( (m_currentTileNumber < m_batchStart) ||
+           (m_currentTileNumber >= m_batchStart + m_batchSize) )
+      {
+         makeTileBatch(m_currentTileNumber);
+      }
+      const ossim_uint32 IDX = m_currentTileNumber - m_batchStart;
+      tile      = m_batchTiles[IDX];
+      resampled = (m_batchStatus[IDX] == TILE_RESAMPLED);
+      readError = (m_batchStatus[IDX] == TILE_READ_ERROR);
+   }
+   else
+   {
+      ossimImageSource* source = m_imageHandler.get();
+      if (m_maskFilter.valid())
+      {
+         source = m_maskFilter.get();
+      }
+      resampled = makeTile(m_currentTileNumber, source, 0, m_inputTile, m_tile.get(), readError);
+      tile = m_tile;
+   }
+
+   if ( readError )
+   {
+      // Set our error status for callers.
+      setErrorStatus();
+      
+      ossimNotify(ossimNotifyLevel_WARN)
+         << "ossimOverviewSequencer::getNextTile  ERROR:"
+         << "\nError set reading tile:  " << m_currentTileNumber << std::endl;
+   }
+   else if ( resampled )
+   {
+      finishTile(tile);
+   }
+
+   // Increment the tile index.
+   ++m_currentTileNumber;
+
+   return tile;
+}
+
+bool ossimOverviewSequencer::makeTile(ossim_uint32 tileNumber,
+                                      ossimImageSource* source,
+                                      std::mutex* readMutex,
+                                      ossimRefPtr<ossimImageData>& inputTile,
+                                      ossimImageData* outputTile,
+                                      bool& readError) const
+{
    // Get the rectangle to grab from the image.
    ossimIrect inputRect;
-   getInputTileRectangle(inputRect);
+   getInputTileRectangle(inputRect, tileNumber);
 
    // Get the output rectangle.
    ossimIrect outputRect;
-   getOutputTileRectangle(outputRect);
+   getOutputTileRectangle(outputRect, tileNumber);
 
    // Capture the output rectangle.
-   m_tile->setImageRectangle(outputRect);
+   outputTile->setImageRectangle(outputRect);
 
    // Start with a blank tile.
-   m_tile->makeBlank();
+   outputTile->makeBlank();
 
    // Grab the input tile.
-   ossimRefPtr<ossimImageData> inputTile;
-   if (m_maskFilter.valid())
+   ossimRefPtr<ossimImageData> data;
+   readError = false;
+   if ( m_inputLevel.valid() )
    {
-      inputTile = m_maskFilter->getTile(inputRect, m_sourceResLevel);
-
-      // Check for errors reading tile and set our error status for callers.
-      if ( m_maskFilter->hasError() )
+      if ( !inputTile.valid() )
       {
-         setErrorStatus();
+         inputTile = static_cast<ossimImageData*>( m_tile->dup() );
       }
+      inputTile->setImageRectangle(inputRect);
+      inputTile->makeBlank();
+      inputTile->loadTile(m_inputLevel.get());
+      inputTile->validate();
+      data = inputTile;
    }
-   else
+   else if ( source )
    {
-      inputTile = m_imageHandler->getTile(inputRect, m_sourceResLevel);
-
-      // Check for errors reading tile and set our error status for callers.
-      if ( m_imageHandler->hasError() )
+      if ( readMutex )
       {
-         setErrorStatus();
+         //---
+         // Shared source; its tile is only good until the next read so copy
+         // it out under the lock.
+         //---
+         std::lock_guard<std::mutex> lock(*readMutex);
+         ossimRefPtr<ossimImageData> t = source->getTile(inputRect, m_sourceResLevel);
+         readError = source->hasError();
+         if ( t.valid() && !readError )
+         {
+            if ( !inputTile.valid() )
+            {
+               inputTile = static_cast<ossimImageData*>( m_tile->dup() );
+            }
+            inputTile->setImageRectangle(inputRect);
+            inputTile->makeBlank();
+            inputTile->loadTile(t.get());
+            data = inputTile;
+         }
+      }
+      else
+      {
+         data = source->getTile(inputRect, m_sourceResLevel);
+
+         // Check for errors reading tile.
+         readError = source->hasError();
       }
    }
 
-   if ( hasError() )
+   bool result = false;
+   if ( readError )
    {
-      ossimNotify(ossimNotifyLevel_WARN)
-         << "ossimOverviewSequencer::getNextTile  ERROR:"
-         << "\nError set reading tile:  " << m_currentTileNumber << std::endl;
-      if ( inputTile.valid() )
-      {
-         inputTile->makeBlank();
-      }
+      // Caller reports.
    }
-   else if ( inputTile.valid() )
+   else if ( data.valid() )
    {
-      if ( (inputTile->getDataObjectStatus() == OSSIM_PARTIAL) ||
-           (inputTile->getDataObjectStatus() == OSSIM_FULL ) )
+      if ( (data->getDataObjectStatus() == OSSIM_PARTIAL) ||
+           (data->getDataObjectStatus() == OSSIM_FULL ) )
       {
          // Resample the tile.
-         resampleTile(inputTile.get());
-         m_tile->validate();
-         
-         // Scan the resampled pixels for bogus values to be masked out (if masking enabled)
-         if (m_maskWriter.valid())
-            m_maskWriter->generateMask(m_tile, m_sourceResLevel+1);
-         populateStats(m_tile);
+         resampleTile(data.get(), outputTile);
+         outputTile->validate();
+         result = true;
       }
    }
    else
@@ -382,10 +699,35 @@ ossimRefPtr<ossimImageData> ossimOverviewSequencer::getNextTile()
          << "\nRes level:  " << m_sourceResLevel << std::endl;
    }
 
-   // Increment the tile index.
-   ++m_currentTileNumber;
+   return result;
+}
+
+void ossimOverviewSequencer::makeTileBatch(ossim_uint32 tileNumber)
+{
+   m_batchStart = tileNumber;
+   m_batchSize  = ossim::min<ossim_uint32>( static_cast<ossim_uint32>(m_batchTiles.size()),
+                                            getNumberOfTiles() - tileNumber );
 
-   return m_tile;
+   const ossim_uint32 JOBS = ossim::min<ossim_uint32>(
+      static_cast<ossim_uint32>(m_readers.size()), m_batchSize );
+   for (ossim_uint32 i = 0; i < JOBS; ++i)
+   {
+      m_jobQueue->add( std::make_shared<ResampleJob>(this, i) );
+   }
+   m_jobQueue->waitForJobsToFinish();
+}
+
+void ossimOverviewSequencer::finishTile(ossimRefPtr<ossimImageData> tile)
+{
+   // Scan the resampled pixels for bogus values to be masked out (if masking enabled)
+   if (m_maskWriter.valid())
+      m_maskWriter->generateMask(tile, m_sourceResLevel+1);
+   populateStats(tile);
+
+   if (m_outputLevel.valid())
+   {
+      m_outputLevel->loadTile(tile.get());
+   }
 }
 
 void ossimOverviewSequencer::slaveProcessTiles()
@@ -415,6 +757,35 @@ void ossimOverviewSequencer::setResampleType(
    m_resampleType = resampleType;
 }
 
+void ossimOverviewSequencer::setNumberOfThreads(ossim_uint32 threads)
+{
+   m_numberOfThreads = threads;
+   m_dirtyFlag = true;
+}
+
+ossim_uint32 ossimOverviewSequencer::getNumberOfThreads() const
+{
+   return m_numberOfThreads;
+}
+
+void ossimOverviewSequencer::setInputLevel(ossimImageData* level)
+{
+   m_inputLevel = level;
+   m_areaOfInterest.makeNan();
+   m_dirtyFlag = true;
+}
+
+void ossimOverviewSequencer::setRetainOutputLevel(bool flag)
+{
+   m_retainOutputLevel = flag;
+   m_dirtyFlag = true;
+}
+
+ossimRefPtr<ossimImageData> ossimOverviewSequencer::getOutputLevel() const
+{
+   return m_outputLevel;
+}
+
 void ossimOverviewSequencer::setScanForMinMax(bool flag)
 {
    m_scanForMinMax  = flag;
@@ -780,10 +1151,16 @@ bool ossimOverviewSequencer::writeOmdFile(const std::string& file)
 }
 
 void ossimOverviewSequencer::getInputTileRectangle(ossimIrect& inputRect) const
+{
+   getInputTileRectangle(inputRect, m_currentTileNumber);
+}
+
+void ossimOverviewSequencer::getInputTileRectangle(ossimIrect& inputRect,
+                                                   ossim_uint32 tileNumber) const
 {
    if (!m_imageHandler) return;
    
-   getOutputTileRectangle(inputRect);
+   getOutputTileRectangle(inputRect, tileNumber);
    inputRect = inputRect * m_decimationFactor;
 
 #if 0
@@ -798,10 +1175,16 @@ void ossimOverviewSequencer::getInputTileRectangle(ossimIrect& inputRect) const
 
 void ossimOverviewSequencer::getOutputTileRectangle(
    ossimIrect& outputRect) const
+{
+   getOutputTileRectangle(outputRect, m_currentTileNumber);
+}
+
+void ossimOverviewSequencer::getOutputTileRectangle(
+   ossimIrect& outputRect, ossim_uint32 tileNumber) const
 {
    // Get the row and column.
-   ossim_int32 row = m_currentTileNumber / m_numberOfTilesHorizontal;
-   ossim_int32 col = m_currentTileNumber % m_numberOfTilesHorizontal;
+   ossim_int32 row = tileNumber / m_numberOfTilesHorizontal;
+   ossim_int32 col = tileNumber % m_numberOfTilesHorizontal;
 
    ossimIpt pt;
 
@@ -857,11 +1240,17 @@ void ossimOverviewSequencer::updateTileDimensions()
 
 void ossimOverviewSequencer::resampleTile(const ossimImageData* inputTile)
 {
-   switch(m_imageHandler->getOutputScalarType())
+   resampleTile(inputTile, m_tile.get());
+}
+
+void ossimOverviewSequencer::resampleTile(const ossimImageData* inputTile,
+                                          ossimImageData* outputTile) const
+{
+   switch(outputTile->getScalarType())
    {
       case OSSIM_UINT8:
       {
-         resampleTile(inputTile, ossim_uint8(0));
+         resampleTile(inputTile, outputTile, ossim_uint8(0));
          break;
       }
 
@@ -872,37 +1261,37 @@ void ossimOverviewSequencer::resampleTile(const ossimImageData* inputTile)
       case OSSIM_USHORT15:
       case OSSIM_UINT16:
       {
-         resampleTile(inputTile, ossim_uint16(0));
+         resampleTile(inputTile, outputTile, ossim_uint16(0));
          break;
       }
       case OSSIM_SINT16:
       {
-         resampleTile(inputTile, ossim_sint16(0));
+         resampleTile(inputTile, outputTile, ossim_sint16(0));
          break;
       }
 
       case OSSIM_UINT32:
       {
-         resampleTile(inputTile, ossim_uint32(0));
+         resampleTile(inputTile, outputTile, ossim_uint32(0));
          break;
       }
          
       case OSSIM_SINT32:
       {
-         resampleTile(inputTile, ossim_sint32(0));
+         resampleTile(inputTile, outputTile, ossim_sint32(0));
          break;
       }
          
       case OSSIM_FLOAT32:
       {
-         resampleTile(inputTile, ossim_float32(0.0));
+         resampleTile(inputTile, outputTile, ossim_float32(0.0));
          break;
       }
          
       case OSSIM_NORMALIZED_DOUBLE:
       case OSSIM_FLOAT64:
       {
-         resampleTile(inputTile, ossim_float64(0.0));
+         resampleTile(inputTile, outputTile, ossim_float64(0.0));
          break;
       }
       default:
@@ -911,62 +1300,34 @@ void ossimOverviewSequencer::resampleTile(const ossimImageData* inputTile)
             << std::endl;
          return;
          
-   } // End of "switch(m_imageHandler->getOutputScalarType())"
+   } // End of "switch(outputTile->getScalarType())"
 }
 
 template <class T>
-void  ossimOverviewSequencer::resampleTile(const ossimImageData* inputTile, T  /* dummy */ )
+void  ossimOverviewSequencer::resampleTile(const ossimImageData* inputTile,
+                                           ossimImageData* outputTile,
+                                           T  /* dummy */ ) const
 {
-#if 0
-   if (traceDebug())
-   {
-      ossimNotify(ossimNotifyLevel_DEBUG)
-         << "ossimOverviewSequencer::resampleTile DEBUG: "
-         << "\ncurrent tile: " << m_currentTileNumber
-         << "\ninput tile:\n" << *inputTile
-         << "output tile:\n" << *(m_tile.get())
-         << endl;
-   }
-#endif
-   
-   const ossim_uint32 BANDS = m_tile->getNumberOfBands();
-   const ossim_uint32 LINES = m_tile->getHeight();
-   const ossim_uint32 SAMPS = m_tile->getWidth();
+   const ossim_uint32 BANDS = outputTile->getNumberOfBands();
+   const ossim_uint32 LINES = outputTile->getHeight();
+   const ossim_uint32 SAMPS = outputTile->getWidth();
    const ossim_uint32 INPUT_WIDTH = m_decimationFactor*m_tileSize.x;
    
    T nullPixel              = 0;
-   ossim_float64 weight     = 0.0;
-   ossim_float64 value      = 0.0;
-   ossim_uint32 sampOffset  = 0;
    
    if (m_resampleType == ossimFilterResampler::ossimFilterResampler_NEAREST_NEIGHBOR)
    {
       for (ossim_uint32 band=0; band<BANDS; ++band)
       {
          const T* s = static_cast<const T*>(inputTile->getBuf(band)); // source
-         T*       d = static_cast<T*>(m_tile->getBuf(band)); // destination
-         
-         nullPixel = static_cast<T>(inputTile->getNullPix(band));
-         weight = 0.0;
-         value  = 0.0;
+         T*       d = static_cast<T*>(outputTile->getBuf(band)); // destination
          
          for (ossim_uint32 i=0; i<LINES; ++i)
          {
+            const T* sl = s + i*m_decimationFactor*INPUT_WIDTH;
             for (ossim_uint32 j=0; j<SAMPS; ++j)
             {
-               sampOffset = j*m_decimationFactor;
-               
-               weight = 1.0;
-               value  = *(s + i*m_decimationFactor*INPUT_WIDTH + sampOffset);
-               
-               if(weight)
-               {
-                  d[j] = static_cast<T>( value/weight );
-               }
-               else
-               {
-                  d[j] = nullPixel;
-               }
+               d[j] = sl[j*m_decimationFactor];
                
             } // End of sample loop.
             
@@ -979,74 +1340,34 @@ void  ossimOverviewSequencer::resampleTile(const ossimImageData* inputTile, T  /
    }
    else // ossimFilterResampler::ossimFilterResampler_BOX
    {
-      ossim_uint32 lineOffset1 = 0;
-      ossim_uint32 lineOffset2 = 0;
-      ossim_float64 ul = 0.0;
-      ossim_float64 ur = 0.0;
-      ossim_float64 ll = 0.0;
-      ossim_float64 lr = 0.0;
-
       for (ossim_uint32 band=0; band<BANDS; ++band)
       {
          const T* s = static_cast<const T*>(inputTile->getBuf(band)); // source
-         T*       d = static_cast<T*>(m_tile->getBuf(band)); // destination
+         T*       d = static_cast<T*>(outputTile->getBuf(band)); // destination
 
          nullPixel = static_cast<T>(inputTile->getNullPix(band));
-         weight = 0.0;
-         value  = 0.0;
          
          for (ossim_uint32 i=0; i<LINES; ++i)
          {
-            lineOffset1 = i*m_decimationFactor*INPUT_WIDTH;
-            lineOffset2 = (i*m_decimationFactor+1)*INPUT_WIDTH;
-            
-            for (ossim_uint32 j=0; j<SAMPS; ++j)
+            //---
+            // Average the upper left 2x2 of each decimation cell.  The
+            // common factor of two has contiguous pairs and goes through the
+            // vectorized line kernels.
+            //---
+            const T* s1 = s + i*m_decimationFactor*INPUT_WIDTH;
+            const T* s2 = s + (i*m_decimationFactor+1)*INPUT_WIDTH;
+            if (m_decimationFactor == 2)
             {
-               sampOffset = j*m_decimationFactor;
-               
-               weight = 0.0;
-               value  = 0.0;
-               
-               //---
-               // Grab four pixels from the source, average, and assign
-               // to output.
-               //---
-               ul = *(s + lineOffset1 + sampOffset);
-               ur = *(s + lineOffset1 + sampOffset + 1);
-               ll = *(s + lineOffset2 + sampOffset);
-               lr = *(s + lineOffset2 + sampOffset + 1);
-               
-               if(ul != nullPixel)
-               {
-                  ++weight;
-                  value += ul;
-               }
-               if(ur != nullPixel)
-               {
-                  ++weight;
-                  value += ur;
-               }
-               if(ll != nullPixel)
-               {
-                  ++weight;
-                  value += ll;
-               }
-               if(lr != nullPixel)
-               {
-                  ++weight;
-                  value += lr;
-               }
-
-               if(weight)
-               {
-                  d[j] = static_cast<T>( value/weight );
-               }
-               else
+               boxLine(s1, s2, d, SAMPS, nullPixel);
+            }
+            else
+            {
+               for (ossim_uint32 j=0; j<SAMPS; ++j)
                {
-                  d[j] = nullPixel;
+                  boxLineScalar(s1 + j*m_decimationFactor, s2 + j*m_decimationFactor,
+                                d + j, 1, nullPixel);
                }
-            
-            } // End of sample loop.
+            }
             
             d += m_tileSize.x;
             
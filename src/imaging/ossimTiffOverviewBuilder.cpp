@@ -19,17 +19,20 @@
 #include <ossim/base/ossimErrorCodes.h>
 #include <ossim/base/ossimErrorContext.h>
 #include <ossim/base/ossimNotify.h>
+#include <ossim/base/ossimPreferences.h>
 #include <ossim/base/ossimStdOutProgress.h>
 #include <ossim/base/ossimIpt.h>
 #include <ossim/base/ossimIrect.h>
 #include <ossim/base/ossimFilename.h>
 #include <ossim/base/ossimScalarTypeLut.h>
+#include <ossim/base/ossimString.h>
 #include <ossim/base/ossimTrace.h>
 #include <ossim/imaging/ossimBitMaskTileSource.h>
 #include <ossim/imaging/ossimImageData.h>
 #include <ossim/imaging/ossimImageDataFactory.h>
 #include <ossim/imaging/ossimImageGeometry.h>
 #include <ossim/imaging/ossimImageHandler.h>
+#include <ossim/imaging/ossimTiffTileEncoder.h>
 #include <ossim/imaging/ossimTiffTileSource.h>
 #include <ossim/projection/ossimMapProjection.h>
 #include <ossim/projection/ossimMapProjectionInfo.h>
@@ -38,6 +41,7 @@
 
 #include <xtiffio.h>
 #include <algorithm> /* for std::fill */
+#include <memory>
 #include <sstream>
 using namespace std;
 
@@ -52,6 +56,9 @@ static const char COPY_ALL_KW[]           = "copy_all_flag";
 static const char TEMP_EXTENSION[] = "temp_extension";
 static const char INTERNAL_OVERVIEWS_KW[] = "internal_overviews_flag";
 
+// Default in memory level budget in megabytes.
+static const ossim_uint64 DEFAULT_PIPELINE_MEMORY_SIZE = 512;
+
 #ifdef OSSIM_ID_ENABLED
 static const char OSSIM_ID[] = "$Id: ossimTiffOverviewBuilder.cpp 22362 2013-08-07 20:23:22Z dburken $";
 #endif
@@ -77,8 +84,24 @@ ossimTiffOverviewBuilder::ossimTiffOverviewBuilder()
       m_nullPixelValues(),
       m_copyAllFlag(false),
       m_outputTileSizeSetFlag(false),
-      m_internalOverviewsFlag(false)
+      m_internalOverviewsFlag(false),
+      m_numberOfThreads(0),
+      m_compressionThreads(ossimTiffTileEncoder::getDefaultNumberOfThreads()),
+      m_pipelineMemorySize(DEFAULT_PIPELINE_MEMORY_SIZE*1024*1024),
+      m_previousLevel(0)
 {
+   const char* lookup =
+      ossimPreferences::instance()->findPreference("overview_builder.threads");
+   if (lookup)
+   {
+      m_numberOfThreads = ossimString(lookup).toUInt32();
+   }
+   lookup = ossimPreferences::instance()->findPreference("overview_builder.pipeline_memory_size");
+   if (lookup)
+   {
+      m_pipelineMemorySize = ossimString(lookup).toUInt64()*1024*1024;
+   }
+
    if (traceDebug())
    {
       ossimNotify(ossimNotifyLevel_DEBUG)
@@ -320,8 +343,12 @@ bool ossimTiffOverviewBuilder::execute()
       //---
       // If we copied r0 to the overview file use it instead of the
       // original image handler as it is probably faster.
+      //
+      // If the previous level is still in memory it is the source and the
+      // image handler only supplies pixel type, bands and nulls.
       //---
-      if ( !copyR0() && (i <= m_imageHandler->getNumberOfDecimationLevels()) ) 
+      if ( m_previousLevel.valid() ||
+           ( !copyR0() && (i <= m_imageHandler->getNumberOfDecimationLevels()) ) )
       {
          ih = m_imageHandler;
       }
@@ -361,8 +388,11 @@ bool ossimTiffOverviewBuilder::execute()
          m_maskWriter->connectMyInputTo(ih.get());
       }
 
-      if ( !writeRn( ih.get(), tif, i, (i==startingResLevel) && !copyR0() ) )
+      if ( !writeRn( ih.get(), tif, i, (i==startingResLevel) && !copyR0(),
+                     (i+1) == requiedResLevels ) )
       {
+         m_previousLevel = 0;
+
          // Set the error...
          setErrorStatus();
          ossimNotify(ossimNotifyLevel_WARN)
@@ -394,6 +424,7 @@ bool ossimTiffOverviewBuilder::execute()
       
       if (needsAborting())
       {
+         m_previousLevel = 0;
          ih->disconnect();
          ih = 0;
          if (tif)
@@ -509,6 +540,13 @@ bool ossimTiffOverviewBuilder::writeR0(TIFF* tif)
    }
 
    setCurrentMessage(ossimString("Copying r0..."));
+
+   // Compress on a thread pool if there's anything to compress.
+   std::unique_ptr<ossimTiffTileEncoder> encoder;
+   if ( (m_compressionThreads != 1) && ossimTiffTileEncoder::isParallelizable(tif) )
+   {
+      encoder.reset( new ossimTiffTileEncoder(tif, m_compressionThreads) );
+   }
    
    //***
    // Tile loop in the line direction.
@@ -564,12 +602,22 @@ bool ossimTiffOverviewBuilder::writeR0(TIFF* tif)
 
             // Write the tile.
             int bytesWritten = 0;
-            bytesWritten = TIFFWriteTile(tif,
-                                         data,
-                                         origin.x,
-                                         origin.y,
-                                         0,        // z
-                                         band);    // sample
+            if ( encoder )
+            {
+               if ( encoder->writeTile(data, origin.x, origin.y, band) )
+               {
+                  bytesWritten = m_tileSizeInBytes;
+               }
+            }
+            else
+            {
+               bytesWritten = TIFFWriteTile(tif,
+                                            data,
+                                            origin.x,
+                                            origin.y,
+                                            0,        // z
+                                            band);    // sample
+            }
 
             if (bytesWritten != m_tileSizeInBytes)
             {
@@ -603,6 +651,14 @@ bool ossimTiffOverviewBuilder::writeR0(TIFF* tif)
 
    } // End of tile loop in the line (height) direction.
 
+   if ( encoder && !encoder->finish() )
+   {
+      ossimNotify(ossimNotifyLevel_WARN)
+         << MODULE << " ERROR: compressing tiff tiles!" << std::endl;
+      theErrorStatus = ossimErrorCodes::OSSIM_ERROR;
+      return false;
+   }
+
    //***
    // Write the current dirctory.
    //***
@@ -621,7 +677,8 @@ bool ossimTiffOverviewBuilder::writeR0(TIFF* tif)
 bool ossimTiffOverviewBuilder::writeRn( ossimImageHandler* imageHandler,
                                         TIFF* tif,
                                         ossim_uint32 resLevel,
-                                        bool firstResLevel )
+                                        bool firstResLevel,
+                                        bool lastResLevel )
 {
    if ( ossimMpi::instance()->getRank() == 0 )
    {
@@ -671,6 +728,38 @@ bool ossimTiffOverviewBuilder::writeRn( ossimImageHandler* imageHandler,
    sequencer->setSourceLevel(sourceResLevel);
    sequencer->setResampleType(m_resampleType);
    sequencer->setTileSize( ossimIpt(m_tileWidth, m_tileHeight) );
+
+   //---
+   // Threads and keeping levels in memory are for single process builds.
+   // Masking reads through the mask filter so it always goes to the file.
+   //---
+   ossimRefPtr<ossimImageData> inputLevel = m_previousLevel;
+   m_previousLevel = 0;
+   if ( (ossimMpi::instance()->getNumberOfProcessors() == 1) && !m_maskFilter.valid() )
+   {
+      sequencer->setNumberOfThreads(m_numberOfThreads);
+
+      ossimIrect inputRect;
+      if ( inputLevel.valid() )
+      {
+         sequencer->setInputLevel( inputLevel.get() );
+         sequencer->setSourceLevel( resLevel - 1 );
+         inputRect = inputLevel->getImageRectangle();
+      }
+      else
+      {
+         inputRect = imageHandler->getImageRectangle(sourceResLevel);
+      }
+
+      if ( !lastResLevel && m_pipelineMemorySize )
+      {
+         ossim_uint64 bytes = static_cast<ossim_uint64>( (inputRect.width()+1)/2 ) *
+            static_cast<ossim_uint64>( (inputRect.height()+1)/2 ) *
+            imageHandler->getNumberOfOutputBands() *
+            ossim::scalarSizeInBytes( imageHandler->getOutputScalarType() );
+         sequencer->setRetainOutputLevel( bytes <= m_pipelineMemorySize );
+      }
+   }
    
    if ( firstResLevel )
    {
@@ -749,6 +838,13 @@ bool ossimTiffOverviewBuilder::writeRn( ossimImageHandler* imageHandler,
       }
    }
 
+   // Compress on a thread pool if there's anything to compress.
+   std::unique_ptr<ossimTiffTileEncoder> encoder;
+   if ( (m_compressionThreads != 1) && ossimTiffTileEncoder::isParallelizable(tif) )
+   {
+      encoder.reset( new ossimTiffTileEncoder(tif, m_compressionThreads) );
+   }
+
    ossim_uint32 outputTilesWide = sequencer->getNumberOfTilesHorizontal();
    ossim_uint32 outputTilesHigh = sequencer->getNumberOfTilesVertical();
    ossim_uint32 numberOfTiles   = sequencer->getNumberOfTiles();
@@ -792,12 +888,22 @@ bool ossimTiffOverviewBuilder::writeRn( ossimImageHandler* imageHandler,
             {
                // Write the tile.
                int bytesWritten = 0;
-               bytesWritten = TIFFWriteTile(tif,
-                                            t->getBuf(band),
-                                            x,
-                                            y,
-                                            0,        // z
-                                            band);    // sample
+               if ( encoder )
+               {
+                  if ( encoder->writeTile(t->getBuf(band), x, y, band) )
+                  {
+                     bytesWritten = m_tileSizeInBytes;
+                  }
+               }
+               else
+               {
+                  bytesWritten = TIFFWriteTile(tif,
+                                               t->getBuf(band),
+                                               x,
+                                               y,
+                                               0,        // z
+                                               band);    // sample
+               }
                
                if (bytesWritten != m_tileSizeInBytes)
                {
@@ -834,6 +940,14 @@ bool ossimTiffOverviewBuilder::writeRn( ossimImageHandler* imageHandler,
 
    } // End of tile loop in the line (height) direction.
 
+   if ( encoder && !encoder->finish() )
+   {
+      setErrorStatus();
+      ossimNotify(ossimNotifyLevel_WARN)
+         << MODULE << " ERROR: compressing tiff tiles!" << std::endl;
+      return false;
+   }
+
    //---
    // Write the current dirctory.
    //---
@@ -864,6 +978,9 @@ bool ossimTiffOverviewBuilder::writeRn( ossimImageHandler* imageHandler,
       }
    }
 
+   // Hand the level to the next pass if the sequencer kept it.
+   m_previousLevel = sequencer->getOutputLevel();
+
    ++m_currentTiffDir;
 
    return true;
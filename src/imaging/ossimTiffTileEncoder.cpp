@@ -0,0 +1,354 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/imaging/ossimTiffTileEncoder.h>
+#include <ossim/base/ossimCommon.h>
+#include <ossim/base/ossimNotify.h>
+#include <ossim/base/ossimPreferences.h>
+#include <ossim/base/ossimString.h>
+#include <ossim/parallel/ossimJob.h>
+#include <ossim/parallel/ossimJobWorkStealingQueue.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+   // Tiles per thread allowed between being queued and written.
+   const ossim_uint32 TILES_IN_FLIGHT = 4;
+
+   // Growable in memory file behind a scratch TIFF.
+   struct MemoryFile
+   {
+      MemoryFile() : m_data(), m_pos(0) {}
+
+      std::vector<ossim_uint8> m_data;
+      toff_t                   m_pos;
+   };
+
+   tmsize_t memoryRead(thandle_t handle, void* buf, tmsize_t size)
+   {
+      MemoryFile* file = static_cast<MemoryFile*>(handle);
+      if (file->m_pos >= file->m_data.size())
+         return 0;
+      tmsize_t count = std::min<tmsize_t>(size, (tmsize_t)(file->m_data.size() - file->m_pos));
+      memcpy(buf, &file->m_data[file->m_pos], count);
+      file->m_pos += count;
+      return count;
+   }
+
+   tmsize_t memoryWrite(thandle_t handle, void* buf, tmsize_t size)
+   {
+      MemoryFile* file = static_cast<MemoryFile*>(handle);
+      if (file->m_pos + size > file->m_data.size())
+         file->m_data.resize(file->m_pos + size);
+      memcpy(&file->m_data[file->m_pos], buf, size);
+      file->m_pos += size;
+      return size;
+   }
+
+   toff_t memorySeek(thandle_t handle, toff_t offset, int whence)
+   {
+      MemoryFile* file = static_cast<MemoryFile*>(handle);
+      if (whence == SEEK_CUR)
+         file->m_pos += offset;
+      else if (whence == SEEK_END)
+         file->m_pos = file->m_data.size() + offset;
+      else
+         file->m_pos = offset;
+      return file->m_pos;
+   }
+
+   int memoryClose(thandle_t /* handle */)
+   {
+      return 0;
+   }
+
+   toff_t memorySize(thandle_t handle)
+   {
+      return static_cast<MemoryFile*>(handle)->m_data.size();
+   }
+
+   int memoryMap(thandle_t /* handle */, void** /* base */, toff_t* /* size */)
+   {
+      return 0;
+   }
+
+   void memoryUnmap(thandle_t /* handle */, void* /* base */, toff_t /* size */)
+   {
+   }
+}
+
+class ossimTiffTileEncoder::EncodeJob : public ossimJob
+{
+public:
+   EncodeJob(ossimTiffTileEncoder* encoder, std::shared_ptr<Tile> tile)
+      : ossimJob(), m_encoder(encoder), m_tile(tile)
+   {
+   }
+
+protected:
+   virtual void run()
+   {
+      m_encoder->encode(*m_tile);
+   }
+
+private:
+   ossimTiffTileEncoder* m_encoder;
+   std::shared_ptr<Tile> m_tile;
+};
+
+ossimTiffTileEncoder::ossimTiffTileEncoder(TIFF* tif, ossim_uint32 threads)
+:  m_tif(tif),
+   m_threads(threads ? threads : ossim::getNumberOfThreads()),
+   m_tileSize(TIFFTileSize(tif)),
+   m_compression(COMPRESSION_NONE),
+   m_bitsPerSample(8),
+   m_samplesPerPixel(1),
+   m_sampleFormat(SAMPLEFORMAT_UINT),
+   m_planarConfig(PLANARCONFIG_CONTIG),
+   m_photometric(PHOTOMETRIC_MINISBLACK),
+   m_predictor(PREDICTOR_NONE),
+   m_tileWidth(0),
+   m_tileLength(0),
+   m_jpegQuality(-1),
+   m_jpegColorMode(-1),
+   m_zipQuality(-1),
+   m_queue(),
+   m_pending(),
+   m_mutex(),
+   m_condition(),
+   m_jpegTables(),
+   m_jpegTablesWritten(false),
+   m_ok(true)
+{
+   TIFFGetFieldDefaulted(tif, TIFFTAG_COMPRESSION,     &m_compression);
+   TIFFGetFieldDefaulted(tif, TIFFTAG_BITSPERSAMPLE,   &m_bitsPerSample);
+   TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLESPERPIXEL, &m_samplesPerPixel);
+   TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLEFORMAT,    &m_sampleFormat);
+   TIFFGetFieldDefaulted(tif, TIFFTAG_PLANARCONFIG,    &m_planarConfig);
+   TIFFGetField(tif, TIFFTAG_PHOTOMETRIC, &m_photometric);
+   TIFFGetField(tif, TIFFTAG_TILEWIDTH,   &m_tileWidth);
+   TIFFGetField(tif, TIFFTAG_TILELENGTH,  &m_tileLength);
+
+   if ( (m_compression == COMPRESSION_LZW) || (m_compression == COMPRESSION_DEFLATE) ||
+        (m_compression == COMPRESSION_ADOBE_DEFLATE) )
+   {
+      TIFFGetField(tif, TIFFTAG_PREDICTOR, &m_predictor);
+   }
+   if ( (m_compression == COMPRESSION_DEFLATE) || (m_compression == COMPRESSION_ADOBE_DEFLATE) )
+   {
+      TIFFGetField(tif, TIFFTAG_ZIPQUALITY, &m_zipQuality);
+   }
+   else if (m_compression == COMPRESSION_JPEG)
+   {
+      TIFFGetField(tif, TIFFTAG_JPEGQUALITY,   &m_jpegQuality);
+      TIFFGetField(tif, TIFFTAG_JPEGCOLORMODE, &m_jpegColorMode);
+   }
+
+   m_queue = std::make_shared<ossimJobWorkStealingQueue>(m_threads);
+}
+
+ossimTiffTileEncoder::~ossimTiffTileEncoder()
+{
+   finish();
+   m_queue.reset();
+}
+
+bool ossimTiffTileEncoder::writeTile(const void* buf,
+                                     ossim_uint32 x,
+                                     ossim_uint32 y,
+                                     ossim_uint16 sample)
+{
+   if (!m_ok || !buf)
+   {
+      m_ok = false;
+      return false;
+   }
+
+   std::shared_ptr<Tile> tile = std::make_shared<Tile>();
+   tile->m_index = TIFFComputeTile(m_tif, x, y, 0, sample);
+   const ossim_uint8* p = static_cast<const ossim_uint8*>(buf);
+   tile->m_raw.assign(p, p + m_tileSize);
+
+   m_pending.push_back(tile);
+   m_queue->add( std::make_shared<EncodeJob>(this, tile) );
+
+   while ( m_ok && (m_pending.size() > m_threads*TILES_IN_FLIGHT) )
+   {
+      writeFront();
+   }
+   return m_ok;
+}
+
+bool ossimTiffTileEncoder::finish()
+{
+   while ( !m_pending.empty() )
+   {
+      writeFront();
+   }
+   m_queue->waitForJobsToFinish();
+   return m_ok;
+}
+
+ossim_uint32 ossimTiffTileEncoder::getNumberOfThreads() const
+{
+   return m_threads;
+}
+
+bool ossimTiffTileEncoder::isParallelizable(TIFF* tif)
+{
+   ossim_uint16 compression = COMPRESSION_NONE;
+   ossim_uint16 photometric = PHOTOMETRIC_MINISBLACK;
+   TIFFGetFieldDefaulted(tif, TIFFTAG_COMPRESSION, &compression);
+   TIFFGetField(tif, TIFFTAG_PHOTOMETRIC, &photometric);
+
+   //---
+   // YCbCr JPEG has libtiff rewrite tags on the output as it sets up its encoder, which
+   // doesn't happen for raw writes.
+   //---
+   return ( TIFFIsTiled(tif) && (compression != COMPRESSION_NONE) &&
+            (photometric != PHOTOMETRIC_YCBCR) );
+}
+
+ossim_uint32 ossimTiffTileEncoder::getDefaultNumberOfThreads()
+{
+   ossim_uint32 result = 0;
+   const char* lookup = ossimPreferences::instance()->findPreference("tiff_writer.compression_threads");
+   if (lookup)
+   {
+      result = ossimString(lookup).toUInt32();
+   }
+   return result;
+}
+
+void ossimTiffTileEncoder::encode(Tile& tile)
+{
+   MemoryFile file;
+   std::vector<ossim_uint8> tables;
+   bool ok = false;
+
+   //---
+   // Encoding byte swaps 16 bit and wider samples for a file of the other byte order, so the
+   // scratch must have the output's or the raw tiles would be written in the wrong one.
+   //---
+   TIFF* scratch = TIFFClientOpen("ossimTiffTileEncoder",
+                                  TIFFIsBigEndian(m_tif) ? "wmb" : "wml", (thandle_t)&file,
+                                  memoryRead, memoryWrite, memorySeek, memoryClose,
+                                  memorySize, memoryMap, memoryUnmap);
+   if ( scratch && (TIFFIsByteSwapped(scratch) != TIFFIsByteSwapped(m_tif)) )
+   {
+      TIFFCleanup(scratch);
+      scratch = 0;
+   }
+   if (scratch)
+   {
+      // One tile image with the output's codec setup.  Palettes only matter to readers.
+      TIFFSetField(scratch, TIFFTAG_IMAGEWIDTH,      m_tileWidth);
+      TIFFSetField(scratch, TIFFTAG_IMAGELENGTH,     m_tileLength);
+      TIFFSetField(scratch, TIFFTAG_TILEWIDTH,       m_tileWidth);
+      TIFFSetField(scratch, TIFFTAG_TILELENGTH,      m_tileLength);
+      TIFFSetField(scratch, TIFFTAG_BITSPERSAMPLE,   m_bitsPerSample);
+      TIFFSetField(scratch, TIFFTAG_SAMPLESPERPIXEL, m_samplesPerPixel);
+      TIFFSetField(scratch, TIFFTAG_SAMPLEFORMAT,    m_sampleFormat);
+      TIFFSetField(scratch, TIFFTAG_PLANARCONFIG,    m_planarConfig);
+      TIFFSetField(scratch, TIFFTAG_PHOTOMETRIC,
+                   (m_photometric == PHOTOMETRIC_PALETTE) ? PHOTOMETRIC_MINISBLACK : m_photometric);
+      //---
+      // Same codec and bytes under the id libtiff doesn't warn about each time the scratch
+      // directory is flushed.
+      //---
+      TIFFSetField(scratch, TIFFTAG_COMPRESSION,
+                   (m_compression == COMPRESSION_DEFLATE) ? COMPRESSION_ADOBE_DEFLATE : m_compression);
+      if (m_predictor != PREDICTOR_NONE)
+         TIFFSetField(scratch, TIFFTAG_PREDICTOR, m_predictor);
+      if (m_zipQuality != -1)
+         TIFFSetField(scratch, TIFFTAG_ZIPQUALITY, m_zipQuality);
+      if (m_jpegQuality != -1)
+         TIFFSetField(scratch, TIFFTAG_JPEGQUALITY, m_jpegQuality);
+      if (m_jpegColorMode != -1)
+         TIFFSetField(scratch, TIFFTAG_JPEGCOLORMODE, m_jpegColorMode);
+
+      // Encoding may modify the buffer (predictors, byte swapping); it is ours to modify.
+      if ( TIFFWriteEncodedTile(scratch, 0, &tile.m_raw.front(), m_tileSize) == m_tileSize )
+      {
+         uint64* offsets = 0;
+         uint64* counts  = 0;
+         if ( TIFFGetField(scratch, TIFFTAG_TILEOFFSETS, &offsets) &&
+              TIFFGetField(scratch, TIFFTAG_TILEBYTECOUNTS, &counts) &&
+              offsets && counts && (offsets[0] + counts[0] <= file.m_data.size()) )
+         {
+            tile.m_encoded.assign(file.m_data.begin() + offsets[0],
+                                  file.m_data.begin() + offsets[0] + counts[0]);
+            ok = true;
+         }
+
+         if (m_compression == COMPRESSION_JPEG)
+         {
+            uint32 count = 0;
+            void* data = 0;
+            if ( TIFFGetField(scratch, TIFFTAG_JPEGTABLES, &count, &data) && data )
+            {
+               const ossim_uint8* p = static_cast<const ossim_uint8*>(data);
+               tables.assign(p, p + count);
+            }
+         }
+      }
+
+      TIFFCleanup(scratch);
+   }
+
+   tile.m_raw.clear();
+
+   std::lock_guard<std::mutex> lock(m_mutex);
+   if ( m_jpegTables.empty() && !tables.empty() )
+   {
+      m_jpegTables.swap(tables);
+   }
+   tile.m_ok = ok;
+   tile.m_done = true;
+   m_condition.notify_all();
+}
+
+bool ossimTiffTileEncoder::writeFront()
+{
+   std::shared_ptr<Tile> tile = m_pending.front();
+   m_pending.pop_front();
+   {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_condition.wait(lock, [&tile]{ return tile->m_done; });
+
+      //---
+      // Every worker builds the same tables from the same quality; the output needs them
+      // before its first abbreviated tile can be decoded.
+      //---
+      if ( tile->m_ok && !m_jpegTablesWritten && !m_jpegTables.empty() )
+      {
+         TIFFSetField(m_tif, TIFFTAG_JPEGTABLES, (uint32)m_jpegTables.size(),
+                      &m_jpegTables.front());
+         m_jpegTablesWritten = true;
+      }
+   }
+
+   if ( m_ok && tile->m_ok && !tile->m_encoded.empty() )
+   {
+      tmsize_t size = (tmsize_t)tile->m_encoded.size();
+      if ( TIFFWriteRawTile(m_tif, tile->m_index, &tile->m_encoded.front(), size) != size )
+      {
+         m_ok = false;
+      }
+   }
+   else if ( m_ok )
+   {
+      ossimNotify(ossimNotifyLevel_WARN)
+         << "ossimTiffTileEncoder::writeFront ERROR: compressing tile " << tile->m_index
+         << std::endl;
+      m_ok = false;
+   }
+   return m_ok;
+}
@@ -2218,6 +2218,99 @@ bool ossimTiffTileSource::isOpen() const
    return (theTiffPtr != NULL);
 }
 
+bool ossimTiffTileSource::supportsConcurrentReads() const
+{
+   //---
+   // Derived readers(e.g. ossimTerraSarTiffReader) carry extra state this
+   // class does not know how to copy.
+   //---
+   bool result = isOpen() &&
+      ( getClassName() == STATIC_TYPE_NAME(ossimTiffTileSource) );
+   if ( result && theOverview.valid() )
+   {
+      result = theOverview->supportsConcurrentReads();
+   }
+   return result;
+}
+
+ossimRefPtr<ossimImageHandler> ossimTiffTileSource::createConcurrentReader() const
+{
+   static const char MODULE[] = "ossimTiffTileSource::createConcurrentReader";
+
+   ossimRefPtr<ossimImageHandler> result = 0;
+   if ( !supportsConcurrentReads() )
+   {
+      return result;
+   }
+
+   ossimRefPtr<ossimTiffTileSource> reader = new ossimTiffTileSource();
+   if ( !initConcurrentReader( reader.get() ) )
+   {
+      return result;
+   }
+
+   std::shared_ptr<ossim::istream> str =
+      ossim::StreamFactoryRegistry::instance()->createIstream(theImageFile);
+   if ( !str )
+   {
+      return result;
+   }
+
+   // Same client open as open(str, connectionString), minus the directory scan:
+   reader->m_streamAdaptor = std::make_shared<ossim::TiffIStreamAdaptor>(str,
+                                                                         theImageFile);
+   reader->theTiffPtr = XTIFFClientOpen(theImageFile.c_str(), "rm",
+                                        (thandle_t)reader->m_streamAdaptor.get(),
+                                        ossim::TiffIStreamAdaptor::tiffRead,
+                                        ossim::TiffIStreamAdaptor::tiffWrite,
+                                        ossim::TiffIStreamAdaptor::tiffSeek,
+                                        ossim::TiffIStreamAdaptor::tiffClose,
+                                        ossim::TiffIStreamAdaptor::tiffSize,
+                                        ossim::TiffIStreamAdaptor::tiffMap,
+                                        ossim::TiffIStreamAdaptor::tiffUnmap);
+   if ( !reader->theTiffPtr )
+   {
+      if (traceDebug())
+      {
+         ossimNotify(ossimNotifyLevel_WARN)
+            << MODULE << " ERROR:\n"
+            << "libtiff could not open..." << std::endl;
+      }
+      return result;
+   }
+
+   reader->theSamplesPerPixel       = theSamplesPerPixel;
+   reader->theBitsPerSample         = theBitsPerSample;
+   reader->theSampleFormatUnit      = theSampleFormatUnit;
+   reader->theMaxSampleValue        = theMaxSampleValue;
+   reader->theMinSampleValue        = theMinSampleValue;
+   reader->theNullSampleValue       = theNullSampleValue;
+   reader->theNumberOfDirectories   = theNumberOfDirectories;
+   reader->theCurrentDirectory      = TIFFCurrentDirectory(reader->theTiffPtr);
+   reader->theR0isFullRes           = theR0isFullRes;
+   reader->theBytesPerPixel         = theBytesPerPixel;
+   reader->theScalarType            = theScalarType;
+   reader->theApplyColorPaletteFlag = theApplyColorPaletteFlag;
+   reader->theImageWidth            = theImageWidth;
+   reader->theImageLength           = theImageLength;
+   reader->theReadMethod            = theReadMethod;
+   reader->thePlanarConfig          = thePlanarConfig;
+   reader->thePhotometric           = thePhotometric;
+   reader->theRowsPerStrip          = theRowsPerStrip;
+   reader->theImageDirectoryList    = theImageDirectoryList;
+   reader->theMaskDirectoryList     = theMaskDirectoryList;
+   reader->theInputTileSize         = theInputTileSize;
+   reader->theOutputTileSize        = theOutputTileSize;
+   reader->theCompressionType       = theCompressionType;
+   reader->theOutputBandList        = theOutputBandList;
+
+   // Tile and buffer are per reader. The buffer is allocated on first read.
+   reader->allocateTile();
+
+   result = reader.get();
+   return result;
+}
+
 bool ossimTiffTileSource::hasR0() const
 {
    return theR0isFullRes;
@@ -33,6 +33,7 @@
 #include <ossim/support_data/ossimGeoTiff.h>
 #include <ossim/imaging/ossimMemoryImageSource.h>
 #include <ossim/imaging/ossimScalarRemapper.h>
+#include <ossim/imaging/ossimTiffTileEncoder.h>
 
 #include <tiffio.h>
 #ifdef OSSIM_HAS_GEOTIFF
@@ -45,6 +46,7 @@
 #endif
 
 #include <algorithm>
+#include <memory>
 #include <sstream>
 
 using namespace std;
@@ -52,6 +54,7 @@ using namespace std;
 static ossimTrace traceDebug("ossimTiffWriter:debug");
 static const char* TIFF_WRITER_OUTPUT_TILE_SIZE_X_KW = "output_tile_size_x";
 static const char* TIFF_WRITER_OUTPUT_TILE_SIZE_Y_KW = "output_tile_size_y";
+static const char* TIFF_WRITER_COMPRESSION_THREADS_KW = "compression_threads";
 static const long  DEFAULT_JPEG_QUALITY = 75;
 
 RTTI_DEF1(ossimTiffWriter, "ossimTiffWriter", ossimImageFileWriter);
@@ -71,7 +74,8 @@ ossimTiffWriter::ossimTiffWriter()
             theProjectionInfo(NULL),
             theOutputTileSize(OSSIM_DEFAULT_TILE_WIDTH, OSSIM_DEFAULT_TILE_HEIGHT),
             theForceBigTiffFlag(false),
-            theBigTiffFlag(false)
+            theBigTiffFlag(false),
+            theCompressionThreads(ossimTiffTileEncoder::getDefaultNumberOfThreads())
 {
    theColorLut = new ossimNBandLutDataObject();
    ossim::defaultTileSize(theOutputTileSize);
@@ -712,6 +716,11 @@ bool ossimTiffWriter::saveState(ossimKeywordlist& kwl,
            theCompressionType,
            true);
 
+   kwl.add(prefix,
+           TIFF_WRITER_COMPRESSION_THREADS_KW,
+           theCompressionThreads,
+           true);
+
    kwl.add(prefix,
            "color_lut_flag",
            (ossim_uint32)theColorLutFlag,
@@ -785,6 +794,12 @@ bool ossimTiffWriter::loadState(const ossimKeywordlist& kwl,
       setJpegQuality(ossimString(value).toLong());
    }
 
+   value = kwl.find(prefix, TIFF_WRITER_COMPRESSION_THREADS_KW);
+   if(value)
+   {
+      theCompressionThreads = ossimString(value).toUInt32();
+   }
+
    value = kwl.find(prefix, ossimKeywordNames::PHOTOMETRIC_KW);
    if(value)
    {
@@ -890,6 +905,13 @@ bool ossimTiffWriter::writeToTiles()
    ossim_uint32 tileHeight      = theInputConnection->getTileHeight();
    ossim_uint32 numberOfTiles   = theInputConnection->getNumberOfTiles();
 
+   // Compress on a thread pool if there's anything to compress.
+   std::unique_ptr<ossimTiffTileEncoder> encoder;
+   if ( (theCompressionThreads != 1) && ossimTiffTileEncoder::isParallelizable(tiffPtr) )
+   {
+      encoder.reset( new ossimTiffTileEncoder(tiffPtr, theCompressionThreads) );
+   }
+
    // Tile loop in the height direction.
    ossim_uint32 tileNumber = 0;
    vector<ossim_float64> minBands;
@@ -942,12 +964,22 @@ bool ossimTiffWriter::writeToTiles()
          // Write the tile to disk.
          //---
          ossim_uint32 bytesWritten = 0;
-         bytesWritten = TIFFWriteTile(tiffPtr,
-                                      tempTile->getBuf(),
-                                      origin.x,
-                                      origin.y,
-                                      0,            // z
-                                      0);           // s
+         if ( encoder )
+         {
+            if ( encoder->writeTile(tempTile->getBuf(), origin.x, origin.y, 0) )
+            {
+               bytesWritten = tileSizeInBytes;
+            }
+         }
+         else
+         {
+            bytesWritten = TIFFWriteTile(tiffPtr,
+                                         tempTile->getBuf(),
+                                         origin.x,
+                                         origin.y,
+                                         0,            // z
+                                         0);           // s
+         }
 
          if (bytesWritten != tileSizeInBytes)
          {
@@ -974,6 +1006,14 @@ bool ossimTiffWriter::writeToTiles()
 
    } // End of tile loop in the line (height) direction.
 
+   if ( encoder && !encoder->finish() )
+   {
+      ossimNotify(ossimNotifyLevel_WARN)
+               << MODULE << " ERROR: Error returned compressing tiff tiles." << std::endl;
+      setErrorStatus();
+      return false;
+   }
+
    if(!theColorLutFlag&&!needsAborting())
    {
       writeMinMaxTags(minBands, maxBands);
@@ -1000,6 +1040,13 @@ bool ossimTiffWriter::writeToTilesBandSep()
    ossim_uint32 tileHeight    = theInputConnection->getTileHeight();
    ossim_uint32 numberOfTiles = theInputConnection->getNumberOfTiles();
 
+   // Compress on a thread pool if there's anything to compress.
+   std::unique_ptr<ossimTiffTileEncoder> encoder;
+   if ( (theCompressionThreads != 1) && ossimTiffTileEncoder::isParallelizable(tiffPtr) )
+   {
+      encoder.reset( new ossimTiffTileEncoder(tiffPtr, theCompressionThreads) );
+   }
+
 #if 0
    if(traceDebug())
    {
@@ -1055,7 +1102,15 @@ bool ossimTiffWriter::writeToTilesBandSep()
             tdata_t* data = (tdata_t*)id->getBuf(band);
             // Write the tile.
             tsize_t bytesWritten = 0;
-            if(data)
+            if(data && encoder)
+            {
+               if ( encoder->writeTile(data, (ossim_uint32)origin.x, (ossim_uint32)origin.y,
+                                       (ossim_uint16)band) )
+               {
+                  bytesWritten = tileSizeInBytes;
+               }
+            }
+            else if(data)
             {
                bytesWritten = TIFFWriteTile(tiffPtr,
                                             data,
@@ -1095,6 +1150,14 @@ bool ossimTiffWriter::writeToTilesBandSep()
 
    } // End of tile loop in the line (height) direction.
 
+   if ( encoder && !encoder->finish() )
+   {
+      ossimNotify(ossimNotifyLevel_WARN)
+               << MODULE << " ERROR: Error returned compressing tiff tiles." << std::endl;
+      setErrorStatus();
+      return false;
+   }
+
    if(!theColorLutFlag&&!needsAborting())
    {
       writeMinMaxTags(minBands, maxBands);
@@ -1435,6 +1498,10 @@ void ossimTiffWriter::setProperty(ossimRefPtr<ossimProperty> property)
          setCompressionType(s);
       } 
    }
+   else if(property->getName() == TIFF_WRITER_COMPRESSION_THREADS_KW)
+   {
+      theCompressionThreads = property->valueToString().toUInt32();
+   }
    else if(property->getName() == "lut_file")
    {
       theLutFilename = ossimFilename(property->valueToString());
@@ -1501,6 +1568,16 @@ ossimRefPtr<ossimProperty> ossimTiffWriter::getProperty(const ossimString& name)
       stringProp->addConstraint(ossimString("zip"));      
       prop = stringProp.get();
    }
+   else if (name == TIFF_WRITER_COMPRESSION_THREADS_KW)
+   {
+      ossimRefPtr<ossimNumericProperty> numericProp =
+            new ossimNumericProperty(name,
+                                     ossimString::toString(theCompressionThreads),
+                                     0.0,
+                                     1024.0);
+      numericProp->setNumericType(ossimNumericProperty::ossimNumericPropertyType_UINT);
+      prop = numericProp.get();
+   }
    else if (name == "lut_file")
    {
       ossimRefPtr<ossimFilenameProperty> property =
@@ -1546,6 +1623,7 @@ void ossimTiffWriter::getPropertyNames(std::vector<ossimString>& propertyNames)c
          ossimKeywordNames::COMPRESSION_QUALITY_KW));
    propertyNames.push_back(ossimString(
          ossimKeywordNames::COMPRESSION_TYPE_KW));
+   propertyNames.push_back(ossimString(TIFF_WRITER_COMPRESSION_THREADS_KW));
    propertyNames.push_back(ossimString("lut_file"));
    propertyNames.push_back(ossimString("color_lut_flag"));
    propertyNames.push_back(ossimString("big_tiff_flag"));
@@ -1613,6 +1691,16 @@ ossimString ossimTiffWriter::getCompressionType()const
    return theCompressionType;
 }
 
+void ossimTiffWriter::setCompressionThreads(ossim_uint32 threads)
+{
+   theCompressionThreads = threads;
+}
+
+ossim_uint32 ossimTiffWriter::getCompressionThreads()const
+{
+   return theCompressionThreads;
+}
+
 bool ossimTiffWriter::getGeotiffFlag()const
 {
    return theOutputGeotiffTagsFlag;
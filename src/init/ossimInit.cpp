@@ -35,6 +35,8 @@
 #include <ossim/base/ossimObjectFactoryRegistry.h>
 #include <ossim/base/ossimPreferences.h>
 #include <ossim/base/ossimStreamFactoryRegistry.h>
+#include <ossim/base/ossimTileBufferPool.h>
+#include <ossim/base/ossimTimer.h>
 #include <ossim/base/ossimTrace.h>
 #include <ossim/base/ossimTraceManager.h>
 #include <ossim/base/ossimGeoidEgm96.h>
@@ -49,6 +51,8 @@
 #include <ossim/support_data/ImageHandlerStateFactory.h>
 
 #include <ossim/imaging/ossimCodecFactoryRegistry.h>
+#include <ossim/imaging/ossimDeferredImageHandlerFactory.h>
+#include <ossim/imaging/ossimDeferredImageWriterFactory.h>
 #include <ossim/imaging/ossimImageSourceFactoryRegistry.h>
 #include <ossim/imaging/ossimImageGeometryRegistry.h>
 #include <ossim/imaging/ossimImageHandlerRegistry.h>
@@ -59,7 +63,10 @@
 
 #include <ossim/plugin/ossimSharedPluginRegistry.h>
 #include <ossim/plugin/ossimDynamicLibrary.h>
+#include <ossim/plugin/ossimDeferredPlugin.h>
+#include <ossim/plugin/ossimPluginManifest.h>
 
+#include <ossim/projection/ossimDeferredProjectionFactory.h>
 #include <ossim/projection/ossimProjectionFactoryRegistry.h>
 #include <ossim/projection/ossimProjectionViewControllerFactory.h>
 
@@ -73,6 +80,7 @@ using namespace std;
 
 static ossimTrace traceExec = ossimTrace("ossimInit:exec");
 static ossimTrace traceDebug = ossimTrace("ossimInit:debug");
+static ossimTrace traceStartup = ossimTrace("ossimInit:startup");
 
 extern "C"
 {
@@ -206,6 +214,10 @@ void ossimInit::initialize(ossimArgumentParser& parser)
    //Parse the command line:
 
    theInstance->parseOptions(parser);
+
+   // Tiles made before the preferences were loaded left the pool with its defaults:
+   ossimTileBufferPool::instance()->readPreferences();
+
    // we will also support defining a trace pattern from an Environment
    // variable.  This will make JNI code easier to enable tracing
    //
@@ -216,19 +228,50 @@ void ossimInit::initialize(ossimArgumentParser& parser)
       ossimTraceManager::instance()->setTracePattern(traceVariable);
    }
 
+   ossimTimer::Timer_t t0 = ossimTimer::instance()->tick();
+
    theInstance->initializeDefaultFactories();
 
     theInstance->initializeLogFile();
+
+   ossimTimer::Timer_t t1 = ossimTimer::instance()->tick();
    
    if(thePluginLoaderEnabledFlag)
    {
       theInstance->initializePlugins();
    }
+
+   ossimTimer::Timer_t t2 = ossimTimer::instance()->tick();
+
    if (theElevEnabledFlag)
    {
       theInstance->initializeElevation();
    }
 
+   if (traceStartup())
+   {
+      ossimTimer::Timer_t t3 = ossimTimer::instance()->tick();
+      ossimSharedPluginRegistry* plugins = ossimSharedPluginRegistry::instance();
+      double pluginSeconds = 0.0;
+      for (ossim_uint32 idx = 0; idx < plugins->getNumberOfPlugins(); ++idx)
+      {
+         const ossimPluginLibrary* lib = plugins->getPlugin(idx);
+         if (lib)
+         {
+            pluginSeconds += lib->getLoadSeconds();
+         }
+      }
+      ossimNotify(ossimNotifyLevel_DEBUG)
+         << "ossimInit::initialize startup:"
+         << "\ndefault factories: " << ossimTimer::instance()->delta_s(t0, t1) << " s"
+         << "\nplugins:           " << ossimTimer::instance()->delta_s(t1, t2) << " s"
+         << "\nelevation:         " << ossimTimer::instance()->delta_s(t2, t3) << " s"
+         << "\nplugins loaded:    " << plugins->getNumberOfPlugins()
+         << " (" << pluginSeconds << " s in libraries)"
+         << "\nplugins deferred:  " << plugins->getNumberOfDeferredPlugins()
+         << std::endl;
+   }
+
    if (traceDebug())
    {
       ossimNotify(ossimNotifyLevel_DEBUG)
@@ -727,6 +770,27 @@ void ossimInit::initializePlugins()
       }
    }
    #endif   
+   //---
+   // With lazy loading on, plugins found in the manifest are registered by stand in factories
+   // and loaded on first use.  Others are loaded now and recorded in it for the next run.
+   //---
+   bool lazyLoad = false;
+   ossimString lazyLoadPref = ossimPreferences::instance()->findPreference("ossim.plugins.lazy_load");
+   if(lazyLoadPref.size())
+   {
+      lazyLoad = lazyLoadPref.toBool();
+   }
+   ossimFilename manifestFile = ossimPreferences::instance()->findPreference("ossim.plugins.manifest");
+   if(manifestFile.empty())
+   {
+      manifestFile = ossimEnvironmentUtility::instance()->getUserOssimSupportDir().dirCat("plugin_manifest.kwl");
+   }
+   ossimPluginManifest manifest;
+   if(lazyLoad)
+   {
+      manifest.read(manifestFile);
+   }
+
    // now check new plugin loading that supports passing options to the plugins
    // 
    const ossimKeywordlist& kwl = thePreferences->preferencesKWL();
@@ -758,7 +822,9 @@ void ossimInit::initializePlugins()
          options    = kwl.find((newPrefix+"options").c_str());
          if(pluginFile.exists())
          {
-            ossimSharedPluginRegistry::instance()->registerPlugin(pluginFile, options);
+            // plugin<N>.lazy: false forces a load at startup.
+            ossimString lazy = kwl.find((newPrefix+"lazy").c_str());
+            registerPlugin(manifest, pluginFile, options, lazyLoad && (lazy.empty() || lazy.toBool()));
          }
       }
    }
@@ -790,7 +856,7 @@ void ossimInit::initializePlugins()
          pluginFile = kwl.find(newPrefix.c_str());
          if(pluginFile.exists())
          {
-            ossimSharedPluginRegistry::instance()->registerPlugin(pluginFile, options);
+            registerPlugin(manifest, pluginFile, options, lazyLoad);
          }
       }
    }
@@ -821,13 +887,185 @@ void ossimInit::initializePlugins()
          ossim_uint32 idx = 0;
          for(idx = 0; idx < result.size(); ++idx)
          {
-            ossimSharedPluginRegistry::instance()->registerPlugin(result[idx]);
+            registerPlugin(manifest, result[idx], ossimString(), lazyLoad);
          }
       }
    }
+
+   if(lazyLoad && manifest.isModified())
+   {
+      if(!manifest.write(manifestFile) && traceDebug())
+      {
+         ossimNotify(ossimNotifyLevel_DEBUG)
+            << "DEBUG ossimInit::initializePlugins: Could not write plugin manifest "
+            << manifestFile << std::endl;
+      }
+   }
 #endif
 }
 
+//---
+// Sets services.front from the registrations a plugin made to one registry.
+// @return false if one stand in factory can not take their place: mixed or relative
+// positions, or more than one factory pushed to the front, which ends up in reverse order.
+//---
+template <class RegistrationList>
+static bool getPosition(const RegistrationList& registrations,
+                        ossimPluginManifest::Services& services)
+{
+   bool result = true;
+   if(registrations.size())
+   {
+      services.front = registrations[0].pushToFrontFlag;
+      if(services.front && (registrations.size() > 1))
+      {
+         result = false;
+      }
+      for(std::size_t idx = 0; idx < registrations.size(); ++idx)
+      {
+         if(registrations[idx].beforeThisFactory ||
+            (registrations[idx].pushToFrontFlag != services.front))
+         {
+            result = false;
+         }
+      }
+      if(services.empty())
+      {
+         // Nothing to route requests to the stand in by.
+         result = false;
+      }
+   }
+   return result;
+}
+
+void ossimInit::registerPlugin(ossimPluginManifest& manifest,
+                               const ossimFilename& file,
+                               const ossimString& options,
+                               bool deferAllowed)
+{
+   ossimSharedPluginRegistry* plugins = ossimSharedPluginRegistry::instance();
+   if(plugins->getPlugin(file))
+   {
+      return;
+   }
+   for(ossim_uint32 idx = 0; idx < plugins->getNumberOfDeferredPlugins(); ++idx)
+   {
+      if(plugins->getDeferredPlugin(idx)->getFilename() == file)
+      {
+         return;
+      }
+   }
+
+   ossimImageHandlerRegistry*       handlerRegistry    = ossimImageHandlerRegistry::instance();
+   ossimImageWriterFactoryRegistry* writerRegistry     = ossimImageWriterFactoryRegistry::instance();
+   ossimProjectionFactoryRegistry*  projectionRegistry = ossimProjectionFactoryRegistry::instance();
+
+   const ossimPluginManifest::Entry* entry = deferAllowed ? manifest.find(file, options) : 0;
+   if(entry && entry->deferrable)
+   {
+      std::shared_ptr<ossimDeferredPlugin> plugin =
+         std::make_shared<ossimDeferredPlugin>(file, options, *entry);
+      plugins->registerDeferredPlugin(plugin);
+
+      // Stand in factories live as long as the registries, like the plugin factories.
+      const ossimPluginManifest::Entry& e = plugin->getEntry();
+      if(!e.imageHandlers.empty())
+      {
+         handlerRegistry->registerFactory(new ossimDeferredImageHandlerFactory(plugin),
+                                          e.imageHandlers.front);
+      }
+      if(!e.imageWriters.empty())
+      {
+         writerRegistry->registerFactory(new ossimDeferredImageWriterFactory(plugin),
+                                         e.imageWriters.front);
+      }
+      if(!e.projections.empty())
+      {
+         projectionRegistry->registerFactory(new ossimDeferredProjectionFactory(plugin),
+                                             e.projections.front);
+      }
+      if(traceStartup())
+      {
+         ossimNotify(ossimNotifyLevel_DEBUG)
+            << "ossimInit::registerPlugin: deferred " << file << std::endl;
+      }
+      return;
+   }
+
+   if(!deferAllowed)
+   {
+      plugins->registerPlugin(file, options);
+      return;
+   }
+
+   // Load now, capturing what the plugin registers to record it in the manifest.
+   ossimImageHandlerRegistry::RegistrationList       handlers;
+   ossimImageWriterFactoryRegistry::RegistrationList writers;
+   ossimProjectionFactoryRegistry::RegistrationList  projections;
+   ossimImageHandlerRegistry::RegistrationList* previousHandlers =
+      handlerRegistry->setCaptureList(&handlers);
+   ossimImageWriterFactoryRegistry::RegistrationList* previousWriters =
+      writerRegistry->setCaptureList(&writers);
+   ossimProjectionFactoryRegistry::RegistrationList* previousProjections =
+      projectionRegistry->setCaptureList(&projections);
+
+   bool loaded = plugins->registerPlugin(file, options);
+
+   handlerRegistry->setCaptureList(previousHandlers);
+   writerRegistry->setCaptureList(previousWriters);
+   projectionRegistry->setCaptureList(previousProjections);
+   handlerRegistry->registerFactories(handlers);
+   writerRegistry->registerFactories(writers);
+   projectionRegistry->registerFactories(projections);
+
+   if(loaded)
+   {
+      ossimPluginManifest::Entry newEntry;
+      for(std::size_t idx = 0; idx < handlers.size(); ++idx)
+      {
+         ossimImageHandlerFactoryBase::UniqueStringList extensions;
+         handlers[idx].factory->getSupportedExtensions(extensions);
+         for(ossim_uint32 i = 0; i < extensions.size(); ++i)
+         {
+            newEntry.imageHandlers.extensions.push_back(extensions[i].downcase());
+         }
+         handlers[idx].factory->getTypeNameList(newEntry.imageHandlers.types);
+      }
+      for(std::size_t idx = 0; idx < writers.size(); ++idx)
+      {
+         std::vector<ossimString> extensions;
+         writers[idx].factory->getExtensions(extensions);
+         for(std::size_t i = 0; i < extensions.size(); ++i)
+         {
+            newEntry.imageWriters.extensions.push_back(extensions[i].downcase());
+         }
+         writers[idx].factory->getTypeNameList(newEntry.imageWriters.types);
+         writers[idx].factory->getImageTypeList(newEntry.imageWriters.imageTypes);
+      }
+      for(std::size_t idx = 0; idx < projections.size(); ++idx)
+      {
+         projections[idx].factory->getTypeNameList(newEntry.projections.types);
+      }
+      if(projections.size())
+      {
+         // Files and image handlers reach the projection stand in only for the plugin's own:
+         newEntry.projections.extensions   = newEntry.imageHandlers.extensions;
+         newEntry.projections.handlerTypes = newEntry.imageHandlers.types;
+      }
+
+      //---
+      // A plugin making projections for images it does not open itself, e.g. sensor models
+      // for core TIFFs, must be loaded: nothing would route those images to its stand in.
+      //---
+      newEntry.deferrable = (handlers.size() || writers.size() || projections.size()) &&
+         (projections.empty() || handlers.size()) &&
+         getPosition(handlers, newEntry.imageHandlers) &&
+         getPosition(writers, newEntry.imageWriters) &&
+         getPosition(projections, newEntry.projections);
+      manifest.set(file, options, newEntry);
+   }
+}
+
 void ossimInit::initializeElevation()
 {
    if (traceDebug()) ossimNotify(ossimNotifyLevel_DEBUG)
@@ -35,6 +35,10 @@ ossimImageHandlerMtAdaptor::ossimImageHandlerMtAdaptor(ossimImageHandler* adapte
       d_cacheTileSize(1024),
       m_adaptedHandler (0),
       m_cache (0),
+      m_idleReaders (),
+      m_readerMutex (),
+      m_useConcurrentReads (true),
+      m_concurrentReadsFailed (false),
       d_useCache (false),
       d_useFauxTile (false)
 {
@@ -54,6 +58,7 @@ ossimImageHandlerMtAdaptor::ossimImageHandlerMtAdaptor(ossimImageHandler* adapte
 //**************************************************************************************************
 ossimImageHandlerMtAdaptor::~ossimImageHandlerMtAdaptor()
 {
+   clearReaders();
    m_adaptedHandler = 0;
    m_cache = 0;
    d_fauxTile = 0;
@@ -64,6 +69,7 @@ ossimImageHandlerMtAdaptor::~ossimImageHandlerMtAdaptor()
 //**************************************************************************************************
 void ossimImageHandlerMtAdaptor::setAdaptee(ossimImageHandler* handler)
 {
+   clearReaders();
    m_adaptedHandler = handler;
    if (handler == NULL)
       return;
@@ -159,10 +165,25 @@ ossimRefPtr<ossimImageData>
    if (!m_adaptedHandler.valid())
       return NULL;
 
+   ossimRefPtr<ossimImageData> tile = new ossimImageData();
+
+   // With a private reader there is nothing to lock. The reader's tile is still copied since it
+   // is reused by whichever thread checks the reader out next:
+   ossimRefPtr<ossimImageHandler> reader = checkOutReader();
+   if (reader.valid())
+   {
+      ossimRefPtr<ossimImageData> temp_tile = reader->getTile(tile_rect, rLevel);
+      if (temp_tile.valid())
+         *tile = *(temp_tile.get());
+      else
+         tile = NULL;
+      checkInReader(reader);
+      return tile;
+   }
+
    // The sole purpose of the adapter is this mutex lock around the actual handler getTile:
    //std::lock_guard<std::mutex> lock(m_mutex);
 
-   ossimRefPtr<ossimImageData> tile = new ossimImageData();
    ossimRefPtr<ossimImageData> temp_tile = 0;
    double dt = ossimTimer::instance()->time_s();
 
@@ -215,12 +236,21 @@ bool ossimImageHandlerMtAdaptor::getTile(ossimImageData* tile, ossim_uint32 rLev
    if ((!m_adaptedHandler.valid()) || (tile == NULL))
       return false;
 
+   // The caller owns the tile so a private reader can fill it directly:
+   ossimRefPtr<ossimImageHandler> reader = checkOutReader();
+   if (reader.valid())
+   {
+      bool status = reader->getTile(tile, rLevel);
+      checkInReader(reader);
+      return status;
+   }
+
    // The sole purpose of the adapter is this mutex lock around the actual handler getTile:
    std::lock_guard<std::mutex> lock(m_mutex);
 
    // This is effectively a copy of ossimImageSource::getTile(ossimImageData*). It is reimplemented 
-   // here to save two additional function calls:
-   tile->ref();
+   // here to save two additional function calls. The tile is not ref'd here: a caller holding it
+   // by raw pointer at count 0 would have it deleted by the unref.
    bool status = true;
    ossimIrect tile_rect = tile->getImageRectangle();
 
@@ -234,7 +264,6 @@ bool ossimImageHandlerMtAdaptor::getTile(ossimImageData* tile, ossim_uint32 rLev
       *tile = *(temp_tile.get());
    else
       status = false;
-   tile->unref();
    
    return status;
 }
@@ -346,6 +375,7 @@ void ossimImageHandlerMtAdaptor::close()
 {
    removeListener((ossimConnectableObjectListener*)this);
    this->disconnectAllOutputs();
+   clearReaders();
    m_cache = 0;
    if (m_adaptedHandler.valid())
    {
@@ -367,6 +397,92 @@ void ossimImageHandlerMtAdaptor::setUseCache(bool use_cache)
    d_useCache = use_cache;
 }
 
+void ossimImageHandlerMtAdaptor::setUseConcurrentReads(bool flag)
+{
+   m_useConcurrentReads = flag;
+   if (!flag)
+      clearReaders();
+}
+
+bool ossimImageHandlerMtAdaptor::getUseConcurrentReads() const
+{
+   return m_useConcurrentReads;
+}
+
+//**************************************************************************************************
+//! Takes an idle reader from the pool or creates one. Returns null if the adaptee can't
+//! be read concurrently.
+//**************************************************************************************************
+ossimRefPtr<ossimImageHandler> ossimImageHandlerMtAdaptor::checkOutReader()
+{
+   ossimRefPtr<ossimImageHandler> reader = 0;
+   if (!m_useConcurrentReads || !m_adaptedHandler.valid())
+      return reader;
+
+   {
+      std::lock_guard<std::mutex> lock(m_readerMutex);
+      if (m_concurrentReadsFailed)
+         return reader;
+      if (!m_idleReaders.empty())
+      {
+         reader = m_idleReaders.back();
+         m_idleReaders.pop_back();
+         return reader;
+      }
+   }
+
+   // Pool is dry. Creating a reader reads the adaptee's state so it is done under the adaptee
+   // lock, but this only happens until there is one reader per concurrent caller:
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (m_adaptedHandler->supportsConcurrentReads())
+         reader = m_adaptedHandler->createConcurrentReader();
+   }
+
+   if (!reader.valid())
+   {
+      // Don't keep trying on every tile:
+      std::lock_guard<std::mutex> lock(m_readerMutex);
+      m_concurrentReadsFailed = true;
+      if (traceDebug())
+      {
+         ossimNotify(ossimNotifyLevel_DEBUG)
+            << "ossimImageHandlerMtAdaptor::checkOutReader: "
+            << m_adaptedHandler->getClassName() << " does not support concurrent reads."
+            << " Using locked reads." << std::endl;
+      }
+   }
+   return reader;
+}
+
+//**************************************************************************************************
+//! Returns a reader obtained from checkOutReader() to the pool.
+//**************************************************************************************************
+void ossimImageHandlerMtAdaptor::checkInReader(ossimRefPtr<ossimImageHandler>& reader)
+{
+   if (reader.valid())
+   {
+      std::lock_guard<std::mutex> lock(m_readerMutex);
+      m_idleReaders.push_back(reader);
+   }
+   reader = 0;
+}
+
+//**************************************************************************************************
+//! Drops all pooled readers.
+//**************************************************************************************************
+void ossimImageHandlerMtAdaptor::clearReaders()
+{
+   std::vector<ossimRefPtr<ossimImageHandler> > readers;
+   {
+      std::lock_guard<std::mutex> lock(m_readerMutex);
+      readers.swap(m_idleReaders);
+      m_concurrentReadsFailed = false;
+   }
+   for (auto& reader : readers)
+      reader->close();
+}
+
 void ossimImageHandlerMtAdaptor::setCacheTileSize(ossim_uint32 cache_tile_size)
 {
    d_cacheTileSize = cache_tile_size;
@@ -0,0 +1,437 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/parallel/ossimJobWorkStealingQueue.h>
+#include <ossim/base/ossimCommon.h>
+#include <algorithm>
+#include <ostream>
+
+namespace
+{
+   // Identifies the pool and deque owned by the calling thread so that jobs queued from inside
+   // a running job land on the local deque.
+   struct WorkerContext
+   {
+      const ossimJobWorkStealingQueue* pool;
+      ossim_int32 index;
+   };
+   thread_local WorkerContext t_workerContext = { 0, -1 };
+
+   // Calls of one parallelFor.  Held by its jobs, which may run after it returned.
+   struct ParallelForState
+   {
+      ParallelForState(ossim_uint32 count, const std::function<void(ossim_uint32)>& work)
+         : m_count(count), m_work(work), m_next(0), m_done(0), m_mutex(), m_condition()
+      {
+      }
+
+      /** Makes calls until none are left. */
+      void run()
+      {
+         ossim_uint32 calls = 0;
+         for (ossim_uint32 i = m_next++; i < m_count; i = m_next++)
+         {
+            m_work(i);
+            ++calls;
+         }
+         if (calls)
+         {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_done += calls;
+            if (m_done == m_count)
+               m_condition.notify_all();
+         }
+      }
+
+      const ossim_uint32                        m_count;
+      const std::function<void(ossim_uint32)>& m_work; // Only used while calls are left.
+      std::atomic<ossim_uint32>                 m_next;
+      ossim_uint32                              m_done;
+      std::mutex                                m_mutex;
+      std::condition_variable                   m_condition;
+   };
+
+   class ParallelForJob : public ossimJob
+   {
+   public:
+      ParallelForJob(std::shared_ptr<ParallelForState> state) : ossimJob(), m_state(state) {}
+   protected:
+      virtual void run() { m_state->run(); }
+   private:
+      std::shared_ptr<ParallelForState> m_state;
+   };
+}
+
+ossimJobWorkStealingQueue::Statistics::Statistics()
+:  jobsAdded(0),
+   jobsExecuted(0),
+   jobsStolen(0),
+   stealAttempts(0),
+   queueDepth(0),
+   maxQueueDepth(0),
+   busyThreads(0),
+   threadQueueDepth(),
+   threadJobsExecuted()
+{
+}
+
+std::ostream& ossimJobWorkStealingQueue::Statistics::print(std::ostream& out) const
+{
+   out << "jobs_added:       " << jobsAdded
+       << "\njobs_executed:    " << jobsExecuted
+       << "\njobs_stolen:      " << jobsStolen
+       << "\nsteal_attempts:   " << stealAttempts
+       << "\nqueue_depth:      " << queueDepth
+       << "\nmax_queue_depth:  " << maxQueueDepth
+       << "\nbusy_threads:     " << busyThreads
+       << "\n";
+   for (ossim_uint32 idx = 0; idx < threadJobsExecuted.size(); ++idx)
+   {
+      out << "thread" << idx << ".executed: " << threadJobsExecuted[idx]
+          << "  thread" << idx << ".queue_depth: " << threadQueueDepth[idx] << "\n";
+   }
+   return out;
+}
+
+ossimJobWorkStealingQueue::WorkerDeque::WorkerDeque()
+:  m_mutex(),
+   m_jobs(),
+   m_executed(0),
+   m_currentJob()
+{
+}
+
+ossimJobWorkStealingQueue::Worker::Worker(ossimJobWorkStealingQueue* pool, ossim_uint32 index)
+:  ossim::Thread(),
+   m_pool(pool),
+   m_index(index)
+{
+}
+
+ossimJobWorkStealingQueue::Worker::~Worker()
+{
+   waitForCompletion();
+}
+
+void ossimJobWorkStealingQueue::Worker::run()
+{
+   m_pool->workerLoop(m_index);
+}
+
+ossimJobWorkStealingQueue::ossimJobWorkStealingQueue(ossim_uint32 nThreads)
+:  m_deques(),
+   m_workers(),
+   m_doneFlag(false),
+   m_nextDeque(0),
+   m_pendingJobs(0),
+   m_outstandingJobs(0),
+   m_busyThreads(0),
+   m_sleepingThreads(0),
+   m_idleMutex(),
+   m_idleCondition(),
+   m_finishedMutex(),
+   m_finishedCondition(),
+   m_jobsAdded(0),
+   m_jobsStolen(0),
+   m_stealAttempts(0),
+   m_maxQueueDepth(0)
+{
+   if (nThreads == 0)
+      nThreads = ossim::getNumberOfThreads();
+   if (nThreads == 0)
+      nThreads = 1;
+
+   // All deques must exist before the first worker starts looking for something to steal:
+   for (ossim_uint32 idx = 0; idx < nThreads; ++idx)
+      m_deques.push_back(std::unique_ptr<WorkerDeque>(new WorkerDeque()));
+
+   for (ossim_uint32 idx = 0; idx < nThreads; ++idx)
+   {
+      std::shared_ptr<Worker> worker = std::make_shared<Worker>(this, idx);
+      m_workers.push_back(worker);
+      worker->start();
+   }
+}
+
+ossimJobWorkStealingQueue::~ossimJobWorkStealingQueue()
+{
+   cancel();
+   waitForCompletion();
+   m_workers.clear();
+}
+
+ossimJobWorkStealingQueue* ossimJobWorkStealingQueue::instance()
+{
+   static ossimJobWorkStealingQueue pool;
+   return &pool;
+}
+
+void ossimJobWorkStealingQueue::add(std::shared_ptr<ossimJob> job)
+{
+   if (!job || m_doneFlag)
+      return;
+
+   job->ready();
+   ++m_jobsAdded;
+   ++m_outstandingJobs;
+
+   // Keep locally generated work on the producing worker's deque, spread external work:
+   ossim_int32 idx = currentWorkerIndex();
+   if (idx < 0)
+      idx = (ossim_int32)(m_nextDeque.fetch_add(1) % m_deques.size());
+
+   WorkerDeque& deque = *m_deques[idx];
+   {
+      std::lock_guard<std::mutex> lock(deque.m_mutex);
+      deque.m_jobs.push_back(job);
+   }
+
+   ossim_int64 depth = ++m_pendingJobs;
+   ossim_uint32 maxDepth = m_maxQueueDepth.load();
+   while ((depth > (ossim_int64)maxDepth) &&
+          !m_maxQueueDepth.compare_exchange_weak(maxDepth, (ossim_uint32)depth))
+   {
+   }
+
+   // Only pay for the idle lock when somebody is actually asleep:
+   if (m_sleepingThreads.load() > 0)
+   {
+      std::lock_guard<std::mutex> lock(m_idleMutex);
+      m_idleCondition.notify_one();
+   }
+}
+
+ossim_uint32 ossimJobWorkStealingQueue::getNumberOfThreads() const
+{
+   return (ossim_uint32)m_workers.size();
+}
+
+ossim_uint32 ossimJobWorkStealingQueue::size() const
+{
+   ossim_int64 pending = m_pendingJobs.load();
+   return (pending > 0) ? (ossim_uint32)pending : 0;
+}
+
+bool ossimJobWorkStealingQueue::isEmpty() const
+{
+   return (m_pendingJobs.load() <= 0);
+}
+
+ossim_uint32 ossimJobWorkStealingQueue::numberOfBusyThreads() const
+{
+   return m_busyThreads.load();
+}
+
+bool ossimJobWorkStealingQueue::hasJobsToProcess() const
+{
+   return (m_outstandingJobs.load() > 0);
+}
+
+void ossimJobWorkStealingQueue::waitForJobsToFinish()
+{
+   std::unique_lock<std::mutex> lock(m_finishedMutex);
+   m_finishedCondition.wait(lock, [this]{ return m_outstandingJobs.load() <= 0; });
+}
+
+void ossimJobWorkStealingQueue::parallelFor(ossim_uint32 count,
+                                            ossim_uint32 shares,
+                                            const std::function<void(ossim_uint32)>& work)
+{
+   if (count == 0)
+      return;
+
+   //---
+   // The caller makes calls too, so it finishes the work even if every worker is busy, e.g.
+   // when called from jobs on this pool.  Jobs that only start after that find nothing left.
+   //---
+   std::shared_ptr<ParallelForState> state = std::make_shared<ParallelForState>(count, work);
+   shares = std::min(std::min(shares, getNumberOfThreads()), count - 1);
+   for (ossim_uint32 idx = 0; idx < shares; ++idx)
+      add(std::make_shared<ParallelForJob>(state));
+   state->run();
+
+   std::unique_lock<std::mutex> lock(state->m_mutex);
+   state->m_condition.wait(lock, [&state]{ return state->m_done == state->m_count; });
+}
+
+void ossimJobWorkStealingQueue::clear()
+{
+   ossimJob::List removedJobs;
+   for (ossim_uint32 idx = 0; idx < m_deques.size(); ++idx)
+   {
+      WorkerDeque& deque = *m_deques[idx];
+      std::lock_guard<std::mutex> lock(deque.m_mutex);
+      m_pendingJobs -= (ossim_int64)deque.m_jobs.size();
+      removedJobs.insert(removedJobs.end(), deque.m_jobs.begin(), deque.m_jobs.end());
+      deque.m_jobs.clear();
+   }
+
+   for (ossimJob::List::iterator iter = removedJobs.begin(); iter != removedJobs.end(); ++iter)
+   {
+      (*iter)->cancel();
+      (*iter)->finished();
+      jobDone();
+   }
+}
+
+void ossimJobWorkStealingQueue::cancel()
+{
+   m_doneFlag = true;
+   clear();
+
+   for (ossim_uint32 idx = 0; idx < m_deques.size(); ++idx)
+   {
+      WorkerDeque& deque = *m_deques[idx];
+      std::lock_guard<std::mutex> lock(deque.m_mutex);
+      if (deque.m_currentJob)
+         deque.m_currentJob->cancel();
+   }
+
+   std::lock_guard<std::mutex> lock(m_idleMutex);
+   m_idleCondition.notify_all();
+}
+
+void ossimJobWorkStealingQueue::waitForCompletion()
+{
+   for (auto worker : m_workers)
+      worker->waitForCompletion();
+}
+
+ossimJobWorkStealingQueue::Statistics ossimJobWorkStealingQueue::getStatistics() const
+{
+   Statistics stats;
+   stats.jobsAdded     = m_jobsAdded.load();
+   stats.jobsStolen    = m_jobsStolen.load();
+   stats.stealAttempts = m_stealAttempts.load();
+   stats.queueDepth    = size();
+   stats.maxQueueDepth = m_maxQueueDepth.load();
+   stats.busyThreads   = m_busyThreads.load();
+   for (ossim_uint32 idx = 0; idx < m_deques.size(); ++idx)
+   {
+      const WorkerDeque& deque = *m_deques[idx];
+      ossim_uint64 executed = deque.m_executed.load();
+      stats.jobsExecuted += executed;
+      stats.threadJobsExecuted.push_back(executed);
+
+      std::lock_guard<std::mutex> lock(deque.m_mutex);
+      stats.threadQueueDepth.push_back((ossim_uint32)deque.m_jobs.size());
+   }
+   return stats;
+}
+
+void ossimJobWorkStealingQueue::resetStatistics()
+{
+   m_jobsAdded = 0;
+   m_jobsStolen = 0;
+   m_stealAttempts = 0;
+   m_maxQueueDepth = size();
+   for (ossim_uint32 idx = 0; idx < m_deques.size(); ++idx)
+      m_deques[idx]->m_executed = 0;
+}
+
+void ossimJobWorkStealingQueue::workerLoop(ossim_uint32 index)
+{
+   t_workerContext.pool = this;
+   t_workerContext.index = (ossim_int32)index;
+
+   while (!m_doneFlag)
+   {
+      std::shared_ptr<ossimJob> job = popLocal(index);
+      if (!job)
+         job = steal(index);
+      if (job)
+      {
+         execute(index, job);
+         continue;
+      }
+
+      // Nothing anywhere. The sleeping count is raised before the pending count is re-checked
+      // so that a concurrent add() either sees us asleep or we see its job.
+      std::unique_lock<std::mutex> lock(m_idleMutex);
+      ++m_sleepingThreads;
+      m_idleCondition.wait(lock, [this]{ return m_doneFlag.load() || (m_pendingJobs.load() > 0); });
+      --m_sleepingThreads;
+   }
+
+   t_workerContext.pool = 0;
+   t_workerContext.index = -1;
+}
+
+std::shared_ptr<ossimJob> ossimJobWorkStealingQueue::popLocal(ossim_uint32 index)
+{
+   std::shared_ptr<ossimJob> job;
+   WorkerDeque& deque = *m_deques[index];
+   std::lock_guard<std::mutex> lock(deque.m_mutex);
+   if (!deque.m_jobs.empty())
+   {
+      job = deque.m_jobs.front();
+      deque.m_jobs.pop_front();
+      --m_pendingJobs;
+   }
+   return job;
+}
+
+std::shared_ptr<ossimJob> ossimJobWorkStealingQueue::steal(ossim_uint32 index)
+{
+   std::shared_ptr<ossimJob> job;
+   if (m_pendingJobs.load() <= 0)
+      return job;
+
+   ++m_stealAttempts;
+   ossim_uint32 nDeques = (ossim_uint32)m_deques.size();
+   for (ossim_uint32 offset = 1; (offset < nDeques) && !job; ++offset)
+   {
+      WorkerDeque& victim = *m_deques[(index + offset) % nDeques];
+      std::lock_guard<std::mutex> lock(victim.m_mutex);
+      if (!victim.m_jobs.empty())
+      {
+         job = victim.m_jobs.front();
+         victim.m_jobs.pop_front();
+         --m_pendingJobs;
+         ++m_jobsStolen;
+      }
+   }
+   return job;
+}
+
+void ossimJobWorkStealingQueue::execute(ossim_uint32 index, std::shared_ptr<ossimJob> job)
+{
+   WorkerDeque& deque = *m_deques[index];
+   ++m_busyThreads;
+   {
+      std::lock_guard<std::mutex> lock(deque.m_mutex);
+      deque.m_currentJob = job;
+   }
+
+   if (job->isCanceled())
+      job->finished();
+   else if (job->isReady())
+      job->start();
+
+   {
+      std::lock_guard<std::mutex> lock(deque.m_mutex);
+      deque.m_currentJob.reset();
+   }
+   ++deque.m_executed;
+   --m_busyThreads;
+   jobDone();
+}
+
+void ossimJobWorkStealingQueue::jobDone()
+{
+   if (--m_outstandingJobs <= 0)
+   {
+      std::lock_guard<std::mutex> lock(m_finishedMutex);
+      m_finishedCondition.notify_all();
+   }
+}
+
+ossim_int32 ossimJobWorkStealingQueue::currentWorkerIndex() const
+{
+   return (t_workerContext.pool == this) ? t_workerContext.index : -1;
+}
@@ -54,14 +54,11 @@ void ossimMultiThreadSequencer::ossimGetTileJob::run()
       }
       dt = ossimTimer::instance()->time_s() - dt; //###
 
-      // Give the sequencer the tile. Execution may pause here while waiting for space to free up
-      // if the cache is full.
+      // Give the sequencer the tile. Space for it in the reorder buffer was guaranteed when the
+      // job was queued.
       m_sequencer.setTileInCache(m_tileID, (ossimImageData*)tile->dup(), m_chainID, dt);
    }
 
-   // Unblock the main thread which might be blocked waiting for jobs to finish:
-   m_sequencer.m_getTileBlock.release();
-
    // Queue the next job using this job's freed-up image chain:
    if (t_launchNewJob)
       m_sequencer.nextJob(m_chainID);
@@ -98,13 +95,18 @@ ossimMultiThreadSequencer::ossimMultiThreadSequencer(ossimImageSource* input,
    m_callback(std::make_shared<ossimGetTileCallback>()),
    m_nextTileID (0),
    m_tileCache(),                       
+   m_tileCacheSize(0),
+   m_consumedTiles(0),
    m_maxCacheSize (DEFAULT_MAX_TILE_CACHE_FACTOR * num_threads),
    m_maxTileCacheFactor (DEFAULT_MAX_TILE_CACHE_FACTOR),
-   m_cacheMutex(),
-   m_jobMutex(),
    m_totalNumberOfTiles(0),
-   m_getTileBlock(),
-   m_nextJobBlock(),
+   m_stopJobs(false),
+   m_writerWaiting(false),
+   m_workersWaiting(0),
+   m_getTileMutex(),
+   m_getTileCondition(),
+   m_nextJobMutex(),
+   m_nextJobCondition(),
    d_printMutex(),
    d_timerMutex(),                                 
    d_debugEnabled(false),
@@ -126,8 +128,6 @@ ossimMultiThreadSequencer::ossimMultiThreadSequencer(ossimImageSource* input,
 
    // The base-class' initialize() method should have been called by the base class constructor
    // unless somebody moved it!
-   m_nextJobBlock.release();
-   m_getTileBlock.release();
    ossimTimer::instance()->setStartTick();
 }
 
@@ -136,19 +136,42 @@ ossimMultiThreadSequencer::ossimMultiThreadSequencer(ossimImageSource* input,
 //*************************************************************************************************
 ossimMultiThreadSequencer::~ossimMultiThreadSequencer()
 {
+   stopJobs();
    m_inputChain = 0; //!< Same as base class' theInputConnection
-   m_jobMtQueue = 0;
    m_callback.reset();
 }
 
+//*************************************************************************************************
+//! Stops and discards the current job pool, releasing any workers waiting for buffer space.
+//*************************************************************************************************
+void ossimMultiThreadSequencer::stopJobs()
+{
+   if (!m_jobMtQueue)
+      return;
+
+   m_stopJobs = true;
+   {
+      std::lock_guard<std::mutex> lock(m_nextJobMutex);
+      m_nextJobCondition.notify_all();
+   }
+   m_jobMtQueue->cancel();
+   m_jobMtQueue->waitForCompletion();
+   m_jobMtQueue = 0;
+   m_stopJobs = false;
+}
+
 //*************************************************************************************************
 //! Overrides base class in order to implement multi-threaded tile requests. 
 //*************************************************************************************************
 void ossimMultiThreadSequencer::setToStartOfSequence()
 {
+   // Any jobs left over from a previous sequence would deposit into the new buffer:
+   stopJobs();
+
    // Reset important indices:
    theCurrentTileNumber = 0;
    m_nextTileID = 0;
+   m_consumedTiles = 0;
    m_totalNumberOfTiles = theNumberOfTilesHorizontal * theNumberOfTilesVertical;
 
    //! The base class should have successfully assigned its input:
@@ -193,6 +216,11 @@ void ossimMultiThreadSequencer::setToStartOfSequence()
    //connectMyInputTo(m_inputChain.get());
    //setAreaOfInterest(m_inputChain->getBoundingRect());
 
+   // Size the reorder buffer. It must hold at least the tiles fetched below plus one in flight
+   // per thread:
+   m_tileCacheSize = max<ossim_uint32>(m_maxCacheSize, 2 * m_numThreads);
+   m_tileCache.reset(new TileSlot[m_tileCacheSize]);
+
    //// EXPERIMENTAL -- Fetch the first N tiles sequentially:
    for (ossim_uint32 i=0; i<m_numThreads; ++i)
    {
@@ -202,9 +230,10 @@ void ossimMultiThreadSequencer::setToStartOfSequence()
       job->start();
    }
 
-   // Set up the job queue and fill it with first N jobs:
+   // Set up the job pool and fill it with first N jobs. Subsequent jobs are queued by the workers
+   // themselves (see nextJob()) and so land on the worker's own deque:
    ossim_uint32 num_jobs_to_launch =  min<ossim_uint32>(m_numThreads, m_totalNumberOfTiles);
-   std::shared_ptr<ossimJobQueue> jobQueue = std::make_shared<ossimJobQueue>();
+   m_jobMtQueue = std::make_shared<ossimJobWorkStealingQueue>(num_jobs_to_launch);
    for (ossim_uint32 chain_id=0; chain_id<num_jobs_to_launch; ++chain_id)
    {
       if (d_debugEnabled)
@@ -216,13 +245,13 @@ void ossimMultiThreadSequencer::setToStartOfSequence()
 
       std::shared_ptr<ossimGetTileJob> job = std::make_shared<ossimGetTileJob>(m_nextTileID++, chain_id, *this);
       job->setCallback(m_callback);
-      jobQueue->add(job, false);
+      m_jobMtQueue->add(job);
    }
 
-   // Initialize the multi-thread queue. Note the setJobQueue is done after construction as it was 
-   // crashing do to jobs being launched during init:
-   m_jobMtQueue = std::make_shared<ossimJobMultiThreadQueue>(nullptr, num_jobs_to_launch);
-   m_jobMtQueue->setJobQueue(jobQueue);
+   // Load the elevation for the round of tiles after these. Each later job does the same for the
+   // tile its chain will get next (see nextJob()).
+   for (ossim_uint32 i=0; i<m_numThreads; ++i)
+      prefetchElevation(m_nextTileID + i);
 }
 
 
@@ -246,83 +275,65 @@ ossimRefPtr<ossimImageData> ossimMultiThreadSequencer::getNextTile(ossim_uint32
       return tile;
    }
 
-   // May need to wait until the corresponding job is finished if the tile is not in the cache:
-   TileCache::iterator tile_iter = m_tileCache.begin();
-   while (!tile.valid()) 
+   // Wait until the job for the current tile has deposited it. Tiles are handed out in sequence;
+   // later tiles keep arriving in their own slots while we wait.
+   TileSlot& slot = m_tileCache[theCurrentTileNumber % m_tileCacheSize];
+   const ossim_int64 tile_id = theCurrentTileNumber;
+   if (slot.m_tileID.load(std::memory_order_acquire) != tile_id)
    {
-      // If the tile is not yet copied into the cache, it means the job is still running. Let's 
-      // block this thread and let the getTile jobs unlock as they finish. We'll exit this loop
-      // when the job of interest finishes.
+      if (d_debugEnabled)
+      {
+         ostringstream s1;
+         s1<<"getNextTile() -- Waiting on tile #"<<theCurrentTileNumber
+           <<"\n   tiles queued ahead = "<<(m_nextTileID - m_consumedTiles);
+         print(s1);
+      }
+
       if (d_timeMetricsEnabled)
          d_t1 = ossimTimer::instance()->time_s(); 
-      m_cacheMutex.lock();
-      if (d_timeMetricsEnabled)
-         d_idleTime1 += ossimTimer::instance()->time_s() - d_t1; 
 
-      // RP - Just grab the first tile for better performance, because order does not matter, we need
-      // to process them all
-      tile_iter = m_tileCache.begin(); //.find(theCurrentTileNumber);
-      m_cacheMutex.unlock();
-
-      if (tile_iter == m_tileCache.end())
+      // The waiting flag is raised before the slot is re-checked so that a depositing worker
+      // either sees the flag or we see its tile:
+      std::unique_lock<std::mutex> lock(m_getTileMutex);
+      m_writerWaiting = true;
+      while (slot.m_tileID.load() != tile_id)
       {
-         if (d_debugEnabled)
-         {
-            ostringstream s1;
-            s1<<"getNextTile() -- Waiting on tile #"<<theCurrentTileNumber;
-            m_cacheMutex.lock();
-            s1<<"\n   cache size = "<<m_tileCache.size();
-            TileCache::iterator iter = m_tileCache.begin();
-            while(iter != m_tileCache.end())
-            {
-               s1<<"\n   cache.tile_id = "<<iter->first;
-               iter++;
-            }
-            m_cacheMutex.unlock();
-            print(s1);
-         }
-
          if (d_timedBlocksDt > 0)
-            m_getTileBlock.block(d_timedBlocksDt); 
+            m_getTileCondition.wait_for(lock, std::chrono::milliseconds(d_timedBlocksDt));
          else
-         {
-            m_getTileBlock.reset();
-            if (d_timeMetricsEnabled)
-               d_t1 = ossimTimer::instance()->time_s(); 
-            m_getTileBlock.block();
-            if (d_timeMetricsEnabled)
-               d_idleTime2 += ossimTimer::instance()->time_s() - d_t1; 
-         }
-      }
-      else
-      {
-         // A valid tile was found. Need to assign the output tile and free up the reference in the
-         // cache:
-         if (d_debugEnabled)
-         {
-            ostringstream s2;
-            s2<<"getNextTile() -- Copying tile #"<<theCurrentTileNumber<<".  Cache size: "<<m_tileCache.size();
-            print(s2);
-         }
-         tile = tile_iter->second;
-         
-         if (d_timeMetricsEnabled)
-            d_t1 = ossimTimer::instance()->time_s(); 
-         m_cacheMutex.lock();
-         m_tileCache.erase(tile_iter);
-         m_cacheMutex.unlock();
-         if (d_timeMetricsEnabled)
-            d_idleTime3 += ossimTimer::instance()->time_s() - d_t1; 
-
-         if (m_tileCache.empty()) 
-            ++d_cacheEmptyCount; 
-         m_nextJobBlock.release(); // nextJob() may be blocked until cache space is freed
+            m_getTileCondition.wait(lock);
       }
+      m_writerWaiting = false;
+
+      if (d_timeMetricsEnabled)
+         d_idleTime2 += ossimTimer::instance()->time_s() - d_t1; 
+   }
+
+   if (d_debugEnabled)
+   {
+      ostringstream s2;
+      s2<<"getNextTile() -- Copying tile #"<<theCurrentTileNumber;
+      print(s2);
    }
 
+   // Take the tile and free the slot before advertising the space to the workers:
+   tile = slot.m_tile;
+   slot.m_tile = 0;
+   slot.m_tileID.store(-1, std::memory_order_release);
+
    // Advance the caller-requested tile ID. This is different from the last threaded getTile()'s
-   // tile index maintained in m_nextTileID and advanced in initNextJob():
+   // tile index maintained in m_nextTileID and advanced in nextJob():
    ++theCurrentTileNumber;
+   m_consumedTiles = theCurrentTileNumber;
+   if (m_tileCache[theCurrentTileNumber % m_tileCacheSize].m_tileID != (ossim_int64) theCurrentTileNumber)
+      ++d_cacheEmptyCount; 
+
+   // Workers may be blocked in nextJob() until buffer space is freed:
+   if (m_workersWaiting > 0)
+   {
+      std::lock_guard<std::mutex> lock(m_nextJobMutex);
+      m_nextJobCondition.notify_all();
+   }
    return tile;
 }
 
@@ -338,8 +349,7 @@ void ossimMultiThreadSequencer::setNumberOfThreads(ossim_uint32 num_threads)
    if (m_inputChain.valid())
       m_inputChain->setNumberOfThreads(num_threads);
 
-   if (m_jobMtQueue && m_jobMtQueue->hasJobsToProcess())
-      m_jobMtQueue->getJobQueue()->clear();
+   stopJobs();
 
    m_nextTileID = 0; // effectively resets this sequencer
 }
@@ -369,8 +379,8 @@ void ossimMultiThreadSequencer::setUseCache(bool use_cache)
 }
 
 //*************************************************************************************************
-//! Access method to tile cache with scope lock to avoid multiple threads writing to
-//! the cache simultaneously.
+//! Deposits a finished tile in its reorder buffer slot. No lock is taken; the writer thread is
+//! only signaled if it is waiting.
 //*************************************************************************************************
 void ossimMultiThreadSequencer::setTileInCache(ossim_uint32 tile_id, 
                                                ossimImageData* tile, 
@@ -378,82 +388,101 @@ void ossimMultiThreadSequencer::setTileInCache(ossim_uint32 tile_id,
                                                double dt)
 {
    if (d_timeMetricsEnabled)
-      d_t1 = ossimTimer::instance()->time_s(); 
-   std::lock_guard<std::mutex> lock(m_cacheMutex);
-   if (d_timeMetricsEnabled)
-      d_idleTime4 += ossimTimer::instance()->time_s() - d_t1; 
+   {
+      std::lock_guard<std::mutex> lock(d_timerMutex);
+      d_jobGetTileT += dt;
+   }
 
-   d_jobGetTileT += dt;
+   // nextJob() only queues a tile once its slot has been vacated by the writer:
+   TileSlot& slot = m_tileCache[tile_id % m_tileCacheSize];
+   slot.m_tile = tile;
+   slot.m_tileID.store(tile_id);
 
-   m_tileCache[tile_id] = tile;
    if (d_debugEnabled)
    {
       ostringstream s2;
       s2<<"THREAD #"<<chain_id<<" -- setTileInCache() Wrote tile #"<<tile_id;
       print(s2);
    }
-   if (d_maxCacheUsed < m_tileCache.size())
-      d_maxCacheUsed = (ossim_uint32) m_tileCache.size();
+
+   ossim_uint32 used = tile_id + 1 - m_consumedTiles;
+   if (d_maxCacheUsed < used)
+      d_maxCacheUsed = used;
+
+   if (m_writerWaiting)
+   {
+      std::lock_guard<std::mutex> lock(m_getTileMutex);
+      m_getTileCondition.notify_one();
+   }
 }
 
 //*************************************************************************************************
-// Queues up the next getTile job if cache is not full. This is called as soon as the job
-// handling the corresponding chain ID is finished.
+// Queues up the next getTile job once there is room for its tile in the reorder buffer. This is
+// called as soon as the job handling the corresponding chain ID is finished.
 //*************************************************************************************************
 void ossimMultiThreadSequencer::nextJob(ossim_uint32 chain_id)
 {
-   // Check for end of sequence:
-   if (m_nextTileID >= m_totalNumberOfTiles)
+   if (m_stopJobs)
+      return;
+
+   // Claim the next tile and check for end of sequence:
+   ossim_uint32 tile_id = m_nextTileID++;
+   if (tile_id >= m_totalNumberOfTiles)
       return;
 
-   while (((ossim_uint32) m_tileCache.size()) >= m_maxCacheSize)
+   // Backpressure: the tile's slot is free only after the writer has consumed the tile that
+   // previously occupied it.
+   if (tile_id >= m_consumedTiles + m_tileCacheSize)
    {
       if (d_debugEnabled)
       {
-         m_cacheMutex.lock();
-         TileCache::const_iterator iter = m_tileCache.begin();
          ostringstream s1;
          s1<<"THREAD #"<<chain_id<<" -- nextJob() Waiting on cache before queuing tile/job #"
-            <<m_nextTileID<<"using chain #"<<chain_id<<". Cache size: "<<m_tileCache.size();
-         while(iter != m_tileCache.end())
-         {
-            s1<<"\n   cache.tile_id = "<<iter->first;
-            iter++;
-         }
-         m_cacheMutex.unlock();
+            <<tile_id<<" using chain #"<<chain_id<<". Writer is at tile #"<<m_consumedTiles;
          print(s1);
       }
 
-      if (d_timedBlocksDt > 0)
-         m_nextJobBlock.block(d_timedBlocksDt);
-      else
+      if (d_timeMetricsEnabled)
+         d_t1 = ossimTimer::instance()->time_s(); 
+
+      std::unique_lock<std::mutex> lock(m_nextJobMutex);
+      ++m_workersWaiting;
+      while ((tile_id >= m_consumedTiles + m_tileCacheSize) && !m_stopJobs)
       {
-         m_nextJobBlock.reset();
-         if (d_timeMetricsEnabled)
-            d_t1 = ossimTimer::instance()->time_s(); 
-         m_nextJobBlock.block();
-         if (d_timeMetricsEnabled)
-         d_idleTime5 += ossimTimer::instance()->time_s() - d_t1; 
+         if (d_timedBlocksDt > 0)
+            m_nextJobCondition.wait_for(lock, std::chrono::milliseconds(d_timedBlocksDt));
+         else
+            m_nextJobCondition.wait(lock);
       }
+      --m_workersWaiting;
+
+      if (d_timeMetricsEnabled)
+         d_idleTime5 += ossimTimer::instance()->time_s() - d_t1; 
+
+      if (m_stopJobs)
+         return;
    }
 
    if (d_debugEnabled)
    {
       ostringstream s2;
-      s2<<"THREAD #"<<chain_id<<" -- nextJob() Queuing tile/job #"<<m_nextTileID;
+      s2<<"THREAD #"<<chain_id<<" -- nextJob() Queuing tile/job #"<<tile_id;
       print(s2);
    }
 
-   // Job queue will receive pointer into ossimRefPtr so no leak here:
-   if (d_timeMetricsEnabled)
-      d_t1 = ossimTimer::instance()->time_s(); 
-   std::lock_guard<std::mutex> lock(m_jobMutex);
-   if (d_timeMetricsEnabled)
-      d_idleTime6 += ossimTimer::instance()->time_s() - d_t1; 
-
-   std::shared_ptr<ossimGetTileJob> job = std::make_shared<ossimGetTileJob>(m_nextTileID++, chain_id, *this);
+   std::shared_ptr<ossimGetTileJob> job = std::make_shared<ossimGetTileJob>(tile_id, chain_id, *this);
    job->setCallback(m_callback);
-   m_jobMtQueue->getJobQueue()->add(job);
+   m_jobMtQueue->add(job);
+
+   // Load the elevation for the tile this chain will get after this one while it is resampled:
+   prefetchElevation(tile_id + m_numThreads);
+}
+
+ossimJobWorkStealingQueue::Statistics ossimMultiThreadSequencer::getJobStatistics() const
+{
+   if (m_jobMtQueue)
+      return m_jobMtQueue->getStatistics();
+   return ossimJobWorkStealingQueue::Statistics();
 }
 
 //*************************************************************************************************
@@ -0,0 +1,79 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/plugin/ossimDeferredPlugin.h>
+#include <ossim/plugin/ossimSharedPluginRegistry.h>
+#include <ossim/base/ossimNotify.h>
+#include <ossim/base/ossimTrace.h>
+#include <mutex>
+
+static ossimTrace traceStartup("ossimInit:startup");
+
+namespace
+{
+   /** Recursive as a plugin may ask for something a deferred plugin serves while loading. */
+   std::recursive_mutex& loadMutex()
+   {
+      static std::recursive_mutex m;
+      return m;
+   }
+}
+
+ossimDeferredPlugin::ossimDeferredPlugin(const ossimFilename& file, const ossimString& options,
+                                         const ossimPluginManifest::Entry& entry)
+   :
+   m_file(file),
+   m_options(options),
+   m_entry(entry),
+   m_listeners(),
+   m_state(PENDING)
+{
+}
+
+void ossimDeferredPlugin::addListener(Listener* listener)
+{
+   std::lock_guard<std::recursive_mutex> lock( loadMutex() );
+   if ( listener )
+   {
+      m_listeners.push_back( listener );
+   }
+}
+
+bool ossimDeferredPlugin::load(const ossimString& reason)
+{
+   std::lock_guard<std::recursive_mutex> lock( loadMutex() );
+   if ( m_state == PENDING )
+   {
+      for ( std::size_t i = 0; i < m_listeners.size(); ++i )
+      {
+         m_listeners[i]->beginLoad();
+      }
+      const bool status = ossimSharedPluginRegistry::instance()->registerPlugin( m_file, m_options );
+      for ( std::size_t i = m_listeners.size(); i > 0; --i )
+      {
+         m_listeners[i-1]->endLoad();
+      }
+      m_state = status ? LOADED : FAILED;
+
+      if ( traceStartup() )
+      {
+         const ossimPluginLibrary* lib = ossimSharedPluginRegistry::instance()->getPlugin( m_file );
+         ossimNotify(ossimNotifyLevel_DEBUG)
+            << "ossimDeferredPlugin::load: " << m_file << " for " << reason << ": "
+            << ( status ? "loaded in " : "failed after " )
+            << ( lib ? lib->getLoadSeconds() : 0.0 ) << " s" << std::endl;
+      }
+   }
+   return m_state == LOADED;
+}
+
+bool ossimDeferredPlugin::isLoaded()const
+{
+   std::lock_guard<std::recursive_mutex> lock( loadMutex() );
+   return m_state == LOADED;
+}
@@ -13,14 +13,16 @@
 
 ossimPluginLibrary::ossimPluginLibrary()
    :ossimDynamicLibrary(),
-    m_info(0)
+    m_info(0),
+    m_loadSeconds(0.0)
 {
 }
 
 ossimPluginLibrary::ossimPluginLibrary(const ossimString& name, const ossimString& options)
    :ossimDynamicLibrary(name),
     m_options(options),
-    m_info(0)
+    m_info(0),
+    m_loadSeconds(0.0)
 {
    initialize();
 }
@@ -87,3 +89,13 @@ void ossimPluginLibrary::setOptions(const ossimString& options)
    m_options = options;
    
 }
+
+double ossimPluginLibrary::getLoadSeconds()const
+{
+   return m_loadSeconds;
+}
+
+void ossimPluginLibrary::setLoadSeconds(double seconds)
+{
+   m_loadSeconds = seconds;
+}
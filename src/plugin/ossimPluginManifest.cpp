@@ -0,0 +1,211 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/plugin/ossimPluginManifest.h>
+#include <ossim/base/ossimDate.h>
+#include <ossim/base/ossimKeywordlist.h>
+#include <ossim/base/ossimKeywordNames.h>
+#include <algorithm>
+
+namespace
+{
+   void saveList(ossimKeywordlist& kwl, const std::string& prefix, const char* key,
+                 const std::vector<ossimString>& list)
+   {
+      ossimString value;
+      for ( std::size_t i = 0; i < list.size(); ++i )
+      {
+         if ( i )
+         {
+            value += " ";
+         }
+         value += list[i];
+      }
+      kwl.add( prefix.c_str(), key, value.c_str() );
+   }
+
+   void loadList(const ossimKeywordlist& kwl, const std::string& prefix, const char* key,
+                 std::vector<ossimString>& list)
+   {
+      list.clear();
+      ossimString( kwl.findKey( prefix, std::string(key) ) ).split( list, " ", true );
+   }
+
+   void saveServices(ossimKeywordlist& kwl, const std::string& prefix,
+                     const ossimPluginManifest::Services& services)
+   {
+      kwl.add( prefix.c_str(), "front", ossimString::toString( services.front ).c_str() );
+      saveList( kwl, prefix, "extensions", services.extensions );
+      saveList( kwl, prefix, "types", services.types );
+      saveList( kwl, prefix, "image_types", services.imageTypes );
+      saveList( kwl, prefix, "handler_types", services.handlerTypes );
+   }
+
+   void loadServices(const ossimKeywordlist& kwl, const std::string& prefix,
+                     ossimPluginManifest::Services& services)
+   {
+      services.front = ossimString( kwl.findKey( prefix, std::string("front") ) ).toBool();
+      loadList( kwl, prefix, "extensions", services.extensions );
+      loadList( kwl, prefix, "types", services.types );
+      loadList( kwl, prefix, "image_types", services.imageTypes );
+      loadList( kwl, prefix, "handler_types", services.handlerTypes );
+   }
+}
+
+bool ossimPluginManifest::Services::hasExtension(const ossimString& ext)const
+{
+   return std::find( extensions.begin(), extensions.end(), ext.downcase() ) != extensions.end();
+}
+
+bool ossimPluginManifest::Services::hasType(const ossimString& type)const
+{
+   // Case blind, as writers are created by image types in any case.
+   const ossimString t = type.downcase();
+   for ( std::size_t i = 0; i < types.size(); ++i )
+   {
+      if ( types[i].downcase() == t )
+      {
+         return true;
+      }
+   }
+   for ( std::size_t i = 0; i < imageTypes.size(); ++i )
+   {
+      if ( imageTypes[i].downcase() == t )
+      {
+         return true;
+      }
+   }
+   return false;
+}
+
+bool ossimPluginManifest::Services::hasHandlerType(const ossimString& className)const
+{
+   return std::find( handlerTypes.begin(), handlerTypes.end(), className ) != handlerTypes.end();
+}
+
+bool ossimPluginManifest::Services::mayCreate(const ossimKeywordlist& kwl,
+                                              const char* prefix)const
+{
+   const char* type = kwl.find( prefix, ossimKeywordNames::TYPE_KW );
+   return !type || hasType( ossimString( type ) );
+}
+
+ossimPluginManifest::ossimPluginManifest()
+   :
+   m_entries(),
+   m_modified(false)
+{
+}
+
+bool ossimPluginManifest::read(const ossimFilename& file)
+{
+   m_entries.clear();
+   m_modified = false;
+
+   ossimKeywordlist kwl;
+   if ( !file.exists() || !kwl.addFile( file ) )
+   {
+      return false;
+   }
+
+   const ossim_uint32 count =
+      ossimString( kwl.findKey( std::string("number_of_plugins") ) ).toUInt32();
+   for ( ossim_uint32 i = 0; i < count; ++i )
+   {
+      const std::string prefix = "plugin" + ossimString::toString( i ).string() + ".";
+      const std::string plugin = kwl.findKey( prefix, std::string("file") );
+      if ( plugin.empty() )
+      {
+         continue;
+      }
+      Entry& entry = m_entries[plugin];
+      entry.size       = ossimString( kwl.findKey( prefix, std::string("size") ) ).toInt64();
+      entry.modTime    =
+         ossimString( kwl.findKey( prefix, std::string("modification_time") ) ).toInt64();
+      entry.options    = kwl.findKey( prefix, std::string("options") );
+      entry.deferrable = ossimString( kwl.findKey( prefix, std::string("deferrable") ) ).toBool();
+      loadServices( kwl, prefix + "image_handler.", entry.imageHandlers );
+      loadServices( kwl, prefix + "image_writer.", entry.imageWriters );
+      loadServices( kwl, prefix + "projection.", entry.projections );
+   }
+   return true;
+}
+
+bool ossimPluginManifest::write(const ossimFilename& file)const
+{
+   ossimKeywordlist kwl;
+   ossim_uint32 i = 0;
+   for ( std::map<std::string, Entry>::const_iterator e = m_entries.begin();
+         e != m_entries.end(); ++e, ++i )
+   {
+      const std::string prefix = "plugin" + ossimString::toString( i ).string() + ".";
+      const Entry& entry = e->second;
+      kwl.add( prefix.c_str(), "file", e->first.c_str() );
+      kwl.add( prefix.c_str(), "size", entry.size );
+      kwl.add( prefix.c_str(), "modification_time", entry.modTime );
+      kwl.add( prefix.c_str(), "options", entry.options.c_str() );
+      kwl.add( prefix.c_str(), "deferrable",
+               ossimString::toString( entry.deferrable ).c_str() );
+      saveServices( kwl, prefix + "image_handler.", entry.imageHandlers );
+      saveServices( kwl, prefix + "image_writer.", entry.imageWriters );
+      saveServices( kwl, prefix + "projection.", entry.projections );
+   }
+   kwl.add( "number_of_plugins", i );
+
+   const ossimFilename dir = file.path();
+   if ( dir.size() && !dir.exists() && !dir.createDirectory() )
+   {
+      return false;
+   }
+   bool result = kwl.write( file.c_str() );
+   if ( result )
+   {
+      m_modified = false;
+   }
+   return result;
+}
+
+const ossimPluginManifest::Entry* ossimPluginManifest::find(const ossimFilename& plugin,
+                                                            const ossimString& options)const
+{
+   const Entry* result = 0;
+   std::map<std::string, Entry>::const_iterator e = m_entries.find( plugin.string() );
+   ossim_int64 size;
+   ossim_int64 modTime;
+   if ( ( e != m_entries.end() ) && getStamp( plugin, size, modTime ) &&
+        ( e->second.size == size ) && ( e->second.modTime == modTime ) &&
+        ( e->second.options == options.trim() ) )
+   {
+      result = &e->second;
+   }
+   return result;
+}
+
+void ossimPluginManifest::set(const ossimFilename& plugin, const ossimString& options,
+                              Entry entry)
+{
+   if ( getStamp( plugin, entry.size, entry.modTime ) )
+   {
+      entry.options = options.trim();
+      m_entries[plugin.string()] = entry;
+      m_modified = true;
+   }
+}
+
+bool ossimPluginManifest::getStamp(const ossimFilename& plugin, ossim_int64& size,
+                                   ossim_int64& modTime)
+{
+   ossimLocalTm tm;
+   bool result = plugin.isFile() && plugin.getTimes( 0, &tm, 0 );
+   if ( result )
+   {
+      size    = plugin.fileSize();
+      modTime = (ossim_int64)tm.getEpoc();
+   }
+   return result;
+}
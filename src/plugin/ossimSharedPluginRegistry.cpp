@@ -14,6 +14,8 @@
 #include <ossim/base/ossimTrace.h>
 #include <ossim/base/ossimKeywordNames.h>
 #include <ossim/base/ossimKeywordlist.h>
+#include <ossim/base/ossimTimer.h>
+#include <ossim/plugin/ossimDeferredPlugin.h>
 #include <ossim/plugin/ossimSharedObjectBridge.h>
 
 //ossimSharedPluginRegistry* ossimSharedPluginRegistry::theInstance = NULL;
@@ -42,6 +44,7 @@ bool ossimSharedPluginRegistry::registerPlugin(const ossimFilename& filename, co
    bool result = false;
    if(!getPlugin(filename))
    {
+      ossimTimer::Timer_t start = ossimTimer::instance()->tick();
       ossimPluginLibrary *lib =new ossimPluginLibrary;
       if(lib->load(filename))
       {
@@ -49,6 +52,7 @@ bool ossimSharedPluginRegistry::registerPlugin(const ossimFilename& filename, co
          if(lib->getSymbol("ossimSharedLibraryInitialize"))
          {
             lib->initialize();
+            lib->setLoadSeconds(ossimTimer::instance()->delta_s(start, ossimTimer::instance()->tick()));
 //            if(!insertFrontFlag)
 //            {
             theLibraryList.push_back(lib);
@@ -204,6 +208,46 @@ bool ossimSharedPluginRegistry::isLoaded(const ossimFilename& filename) const
    return result;
 }
 
+void ossimSharedPluginRegistry::registerDeferredPlugin(std::shared_ptr<ossimDeferredPlugin> plugin)
+{
+   if(plugin)
+   {
+      theDeferredList.push_back(plugin);
+   }
+}
+
+ossim_uint32 ossimSharedPluginRegistry::getNumberOfDeferredPlugins()const
+{
+   ossim_uint32 result = 0;
+   for(ossim_uint32 idx = 0; idx < theDeferredList.size(); ++idx)
+   {
+      if(!theDeferredList[idx]->isLoaded())
+      {
+         ++result;
+      }
+   }
+   return result;
+}
+
+std::shared_ptr<const ossimDeferredPlugin> ossimSharedPluginRegistry::getDeferredPlugin(
+   ossim_uint32 idx)const
+{
+   std::shared_ptr<const ossimDeferredPlugin> result;
+   for(ossim_uint32 i = 0; i < theDeferredList.size(); ++i)
+   {
+      if(!theDeferredList[i]->isLoaded())
+      {
+         if(idx == 0)
+         {
+            result = theDeferredList[i];
+            break;
+         }
+         --idx;
+      }
+   }
+   return result;
+}
+
 void ossimSharedPluginRegistry::printAllPluginInformation(std::ostream& out)
 {
    ossim_uint32 count = getNumberOfPlugins();
@@ -219,6 +263,7 @@ void ossimSharedPluginRegistry::printAllPluginInformation(std::ostream& out)
          out << "Plugin: " << pi->getName() << std::endl;
          out << "DESCRIPTION: \n";
          out << pi->getDescription() << "\n";
+         out << "LOAD TIME: " << pi->getLoadSeconds() << " s\n";
          out << "CLASSES SUPPORTED\n     ";
          std::copy(classNames.begin(),
                    classNames.end(),
@@ -226,4 +271,15 @@ void ossimSharedPluginRegistry::printAllPluginInformation(std::ostream& out)
          out << "\n";
       }
    }
+
+   count = getNumberOfDeferredPlugins();
+   for(idx = 0; idx < count; ++idx)
+   {
+      std::shared_ptr<const ossimDeferredPlugin> pi = getDeferredPlugin(idx);
+      if(pi)
+      {
+         out << "Plugin: " << pi->getFilename() << std::endl;
+         out << "DEFERRED: loaded when something it serves is asked for\n\n";
+      }
+   }
 }
@@ -6,11 +6,9 @@ ossimGenericPointCloudHandler::ossimGenericPointCloudHandler(vector<ossimEcefPoi
 {
    // Fill the point storage in any order.
    // Loop to add your points (assume your points are passed in a vector ecef_points[])
+   m_pointBlock.reserve((ossim_uint32)ecef_points.size());
    for (ossim_uint32 i=0; i<ecef_points.size(); ++i)
-   {
-      ossimPointRecord* point = new ossimPointRecord(ossimGpt(ecef_points[i]));
-      m_pointBlock.addPoint(point);
-   }
+      m_pointBlock.addPoint(ossimGpt(ecef_points[i]));
    ossimGrect bounds;
    m_pointBlock.getBounds(bounds);
    m_minRecord = new ossimPointRecord(bounds.ll());
@@ -21,11 +19,9 @@ ossimGenericPointCloudHandler::ossimGenericPointCloudHandler(vector<ossimGpt>& g
 {
    // Fill the point storage in any order.
    // Loop to add your points (assume your points are passed in a vector ecef_points[])
+   m_pointBlock.reserve((ossim_uint32)ground_points.size());
    for (ossim_uint32 i=0; i<ground_points.size(); ++i)
-   {
-      ossimPointRecord* point = new ossimPointRecord(ground_points[i]);
-      m_pointBlock.addPoint(point);
-   }
+      m_pointBlock.addPoint(ground_points[i]);
    ossimGrect bounds;
    m_pointBlock.getBounds(bounds);
    m_minRecord = new ossimPointRecord(bounds.ll());
@@ -50,8 +46,9 @@ void ossimGenericPointCloudHandler::getFileBlock(ossim_uint32 offset,
    if (offset >= m_pointBlock.size())
       return;
 
+   block.reserve(m_pointBlock.size() - offset);
    for (ossim_uint32 i=offset; i<m_pointBlock.size(); ++i)
-      block.addPoint(new ossimPointRecord(*(m_pointBlock[i])));
+      block.addPoint(m_pointBlock, i);
 
    m_currentPID = block.size();
 }
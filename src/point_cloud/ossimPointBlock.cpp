@@ -6,18 +6,36 @@
 //
 //**************************************************************************************************
 #include <ossim/point_cloud/ossimPointBlock.h>
+#include <algorithm>
 
 using namespace std;
 
 RTTI_DEF1(ossimPointBlock, "ossimPointBlock", ossimDataObject)
 
+// Field code of each column, in column order.
+static const ossimPointRecord::FIELD_CODES FIELD_CODE_LIST[ossimPointBlock::NUM_FIELDS] =
+{
+   ossimPointRecord::Intensity,
+   ossimPointRecord::ReturnNumber,
+   ossimPointRecord::NumberOfReturns,
+   ossimPointRecord::Red,
+   ossimPointRecord::Green,
+   ossimPointRecord::Blue,
+   ossimPointRecord::GpsTime,
+   ossimPointRecord::Infrared
+};
+
 ossimPointBlock::ossimPointBlock(ossimSource* owner, ossim_uint32 fields)
 :  ossimDataObject(owner),
    m_nullPCR(fields),
    m_minMaxValid(false),
-   m_fieldCode(0),
-   m_isNormalized(false)
+   m_fieldCode(fields),
+   m_isNormalized(false),
+   m_datum(0),
+   m_pointListValid(false),
+   m_pointsEditable(false)
 {
+   allocateFields();
 }
 
 ossimPointBlock::~ossimPointBlock()
@@ -25,57 +43,284 @@ ossimPointBlock::~ossimPointBlock()
 
 }
 
+ossim_uint32 ossimPointBlock::fieldIndex(ossimPointRecord::FIELD_CODES fc)
+{
+   for (ossim_uint32 k=0; k<NUM_FIELDS; ++k)
+   {
+      if (FIELD_CODE_LIST[k] == fc)
+         return k;
+   }
+   return NUM_FIELDS;
+}
+
+void ossimPointBlock::allocateFields()
+{
+   for (ossim_uint32 k=0; k<NUM_FIELDS; ++k)
+   {
+      if (m_fieldCode & FIELD_CODE_LIST[k])
+         m_fields[k].resize(m_lat.size(), ossim::nan());
+      else
+         vector<ossim_float32>().swap(m_fields[k]);
+   }
+}
+
+ossim_uint32 ossimPointBlock::size() const
+{
+   // Records handed out stand for the block until copied back, and may have been added to:
+   if (m_pointsEditable.load())
+   {
+      std::lock_guard<std::mutex> lock(m_lazyMutex);
+      if (m_pointsEditable.load())
+         return (ossim_uint32)m_pointList.size();
+   }
+   return (ossim_uint32)m_lat.size();
+}
+
+void ossimPointBlock::reserve(ossim_uint32 numPoints)
+{
+   m_lat.reserve(numPoints);
+   m_lon.reserve(numPoints);
+   m_hgt.reserve(numPoints);
+   m_pointId.reserve(numPoints);
+   for (ossim_uint32 k=0; k<NUM_FIELDS; ++k)
+   {
+      if (m_fieldCode & FIELD_CODE_LIST[k])
+         m_fields[k].reserve(numPoints);
+   }
+}
+
+void ossimPointBlock::clear()
+{
+   m_pointsEditable = false;
+   m_lat.clear();
+   m_lon.clear();
+   m_hgt.clear();
+   m_pointId.clear();
+   for (ossim_uint32 k=0; k<NUM_FIELDS; ++k)
+      m_fields[k].clear();
+   m_isNormalized = false;
+   invalidate();
+}
+
+ossimGpt ossimPointBlock::getPosition(ossim_uint32 i) const
+{
+   sync();
+   ossimGpt pos (m_lat[i], m_lon[i], m_hgt[i]);
+   pos.datum(m_datum);
+   return pos;
+}
+
+void ossimPointBlock::setPosition(ossim_uint32 i, const ossimGpt& pos)
+{
+   sync();
+   m_lat[i] = pos.lat;
+   m_lon[i] = pos.lon;
+   m_hgt[i] = pos.hgt;
+   invalidate();
+}
+
+ossim_float32 ossimPointBlock::getField(ossim_uint32 i, ossimPointRecord::FIELD_CODES fc) const
+{
+   const ossim_float32* column = getFieldColumn(fc);
+   if (column)
+      return column[i];
+   return ossim::nan();
+}
+
+void ossimPointBlock::setField(ossim_uint32 i, ossimPointRecord::FIELD_CODES fc, ossim_float32 value)
+{
+   ossim_float32* column = getFieldColumn(fc);
+   if (column)
+   {
+      column[i] = value;
+      invalidate();
+   }
+}
+
+const ossim_float32* ossimPointBlock::getFieldColumn(ossimPointRecord::FIELD_CODES fc) const
+{
+   sync();
+   ossim_uint32 k = fieldIndex(fc);
+   if ((k < NUM_FIELDS) && !m_fields[k].empty())
+      return &m_fields[k].front();
+   return 0;
+}
+
+ossim_float32* ossimPointBlock::getFieldColumn(ossimPointRecord::FIELD_CODES fc)
+{
+   sync();
+   ossim_uint32 k = fieldIndex(fc);
+   if ((k < NUM_FIELDS) && !m_fields[k].empty())
+   {
+      // Caller may write through the column.
+      invalidate();
+      return &m_fields[k].front();
+   }
+   return 0;
+}
+
 void ossimPointBlock::getFieldMin(ossimPointRecord::FIELD_CODES field, ossim_float32& value) const
 {
    if (empty())
+   {
       value = ossim::nan();
-   else if (!m_minMaxValid)
-      scanForMinMax();
-
+      return;
+   }
+   updateMinMax();
    value = m_minRecord.getField(field);
 }
 
 void ossimPointBlock::getFieldMax(ossimPointRecord::FIELD_CODES field, ossim_float32& value) const
 {
    if (empty())
+   {
       value = ossim::nan();
-   else if (!m_minMaxValid)
-      scanForMinMax();
-
+      return;
+   }
+   updateMinMax();
    value = m_maxRecord.getField(field);
 }
 
 
 void ossimPointBlock::getBounds(ossimGrect& block_bounds) const
 {
-   if (!m_minMaxValid)
-      scanForMinMax();
-
+   if (empty())
+   {
+      block_bounds.makeNan();
+      return;
+   }
+   updateMinMax();
    block_bounds = ossimGrect(m_minRecord.getPosition(), m_maxRecord.getPosition());
 }
 
+void ossimPointBlock::makePointList() const
+{
+   const ossim_uint32 numPoints = (ossim_uint32)m_lat.size();
+   if (m_pointListValid && (m_pointList.size() == numPoints))
+      return;
+
+   // Refresh the records callers may still hold rather than replacing them:
+   m_pointList.resize(numPoints);
+   for (ossim_uint32 i=0; i<numPoints; ++i)
+   {
+      ossimGpt pos (m_lat[i], m_lon[i], m_hgt[i]);
+      pos.datum(m_datum);
+      ossimPointRecord record (pos);
+      record.setPointId(m_pointId[i]);
+      for (ossim_uint32 k=0; k<NUM_FIELDS; ++k)
+      {
+         if (!m_fields[k].empty())
+            record.setField(FIELD_CODE_LIST[k], m_fields[k][i]);
+      }
+      if (m_pointList[i].valid())
+         *m_pointList[i] = record;
+      else
+         m_pointList[i] = new ossimPointRecord(record);
+   }
+   m_pointListValid = true;
+}
+
+const ossimPointBlock::PointList& ossimPointBlock::getPoints() const
+{
+   // Records already handed out for editing are returned as they are:
+   std::lock_guard<std::mutex> lock(m_lazyMutex);
+   if (!m_pointsEditable.load())
+      makePointList();
+   return m_pointList;
+}
+
+ossimPointBlock::PointList& ossimPointBlock::getPoints()
+{
+   std::lock_guard<std::mutex> lock(m_lazyMutex);
+   if (!m_pointsEditable.load())
+   {
+      makePointList();
+
+      // The caller may edit the records or the list until the next sync():
+      m_minMaxValid = false;
+      m_pointsEditable = true;
+   }
+   return m_pointList;
+}
+
 const ossimPointRecord* ossimPointBlock::getPoint(ossim_uint32 point_offset) const
 {
-   if (point_offset < m_pointList.size())
-      return m_pointList[point_offset].get();
+   const PointList& points = getPoints();
+   if (point_offset < points.size())
+      return points[point_offset].get();
    return 0;
 }
 
 ossimPointRecord* ossimPointBlock::getPoint(ossim_uint32 point_offset)
 {
-   if (point_offset < m_pointList.size())
-      return m_pointList[point_offset].get();
+   PointList& points = getPoints();
+   if (point_offset < points.size())
+      return points[point_offset].get();
    return 0;
 }
 
+void ossimPointBlock::syncColumns() const
+{
+   std::lock_guard<std::mutex> lock(m_lazyMutex);
+   if (!m_pointsEditable.load())
+      return; // Another thread got here first.
+
+   // Columns are the block's state whatever the constness of the caller; the records only
+   // stand in for them while handed out.
+   ossimPointBlock* self = const_cast<ossimPointBlock*>(this);
+   const ossim_uint32 numPoints = (ossim_uint32)m_pointList.size();
+   if (m_lat.empty() && numPoints && m_pointList[0].valid())
+      self->m_datum = m_pointList[0]->getPosition().datum();
+
+   self->m_lat.resize(numPoints);
+   self->m_lon.resize(numPoints);
+   self->m_hgt.resize(numPoints);
+   self->m_pointId.resize(numPoints);
+   for (ossim_uint32 k=0; k<NUM_FIELDS; ++k)
+   {
+      if (m_fieldCode & FIELD_CODE_LIST[k])
+         self->m_fields[k].resize(numPoints, ossim::nan());
+   }
+
+   for (ossim_uint32 i=0; i<numPoints; ++i)
+   {
+      const ossimPointRecord* opr = m_pointList[i].get();
+      if (!opr)
+         continue;
+      const ossimGpt& pos = opr->getPosition();
+      self->m_lat[i] = pos.lat;
+      self->m_lon[i] = pos.lon;
+      self->m_hgt[i] = pos.hgt;
+      self->m_pointId[i] = opr->getPointId();
+      for (ossim_uint32 k=0; k<NUM_FIELDS; ++k)
+      {
+         if (!m_fields[k].empty())
+            self->m_fields[k][i] = opr->getField(FIELD_CODE_LIST[k]);
+      }
+   }
+
+   // Records edited after this are not copied back, so have the next handout refresh them:
+   m_minMaxValid = false;
+   m_pointListValid = false;
+   m_pointsEditable = false;
+}
+
 const ossimPointBlock& ossimPointBlock::operator=(const ossimPointBlock& block )
 {
-   ossim_uint32 numPoints = block.size();
-   if (numPoints == 0)
+   if (this == &block)
       return *this;
 
-   for (ossim_uint32 i=0; i<numPoints; ++i)
-      m_pointList.push_back(new ossimPointRecord(*(block[i])));
+   block.sync();
+   m_pointsEditable = false;
+   m_lat = block.m_lat;
+   m_lon = block.m_lon;
+   m_hgt = block.m_hgt;
+   m_pointId = block.m_pointId;
+   for (ossim_uint32 k=0; k<NUM_FIELDS; ++k)
+      m_fields[k] = block.m_fields[k];
+   m_datum = block.m_datum;
+   m_pointList.clear();
+   m_pointListValid = false;
 
    m_nullPCR = block.m_nullPCR;
    m_minRecord = block.m_minRecord;
@@ -94,147 +339,181 @@ ossimObject* ossimPointBlock::dup() const
    return copy;
 }
 
-ossim_uint32 ossimPointBlock::getFieldCode() const
+ossim_uint64 ossimPointBlock::getDataSizeInBytes() const
 {
-   if (!m_pointList.empty())
-      m_fieldCode = m_pointList[0]->getFieldCode();
+   sync();
+   ossim_uint64 bytes = size() * (3*sizeof(ossim_float64) + sizeof(ossim_uint32));
+   for (ossim_uint32 k=0; k<NUM_FIELDS; ++k)
+      bytes += m_fields[k].size() * sizeof(ossim_float32);
+   return bytes;
+}
 
+ossim_uint32 ossimPointBlock::getFieldCode() const
+{
    return m_fieldCode;
 }
 
 vector<ossimPointRecord::FIELD_CODES> ossimPointBlock::getFieldCodesAsList() const
 {
    vector<ossimPointRecord::FIELD_CODES> code_list;
-   if (m_fieldCode & ossimPointRecord::Intensity)
-      code_list.push_back(ossimPointRecord::Intensity);
-   if (m_fieldCode & ossimPointRecord::ReturnNumber)
-      code_list.push_back(ossimPointRecord::ReturnNumber);
-   if (m_fieldCode & ossimPointRecord::NumberOfReturns)
-      code_list.push_back(ossimPointRecord::NumberOfReturns);
-   if (m_fieldCode & ossimPointRecord::Red)
-      code_list.push_back(ossimPointRecord::Red);
-   if (m_fieldCode & ossimPointRecord::Green)
-      code_list.push_back(ossimPointRecord::Green);
-   if (m_fieldCode & ossimPointRecord::Blue)
-      code_list.push_back(ossimPointRecord::Blue);
-   if (m_fieldCode & ossimPointRecord::GpsTime)
-      code_list.push_back(ossimPointRecord::GpsTime);
-   if (m_fieldCode & ossimPointRecord::Infrared)
-      code_list.push_back(ossimPointRecord::Infrared);
-  return code_list;
+   for (ossim_uint32 k=0; k<NUM_FIELDS; ++k)
+   {
+      if (m_fieldCode & FIELD_CODE_LIST[k])
+         code_list.push_back(FIELD_CODE_LIST[k]);
+   }
+   return code_list;
 }
 
 void ossimPointBlock::setFieldCode(ossim_uint32 code)
 {
+   sync();
    if (getFieldCode() != code)
       clear();
 
    m_fieldCode = code;
+   allocateFields();
 }
 
 void ossimPointBlock::addPoint(ossimPointRecord* opr)
 {
-   // First check that the fields match the expected. If not, sync up to this point:
-   if ((opr->getFieldCode() & m_fieldCode) != m_fieldCode)
+   // Takes a reference so a new'ed record no one else holds is freed on return:
+   ossimRefPtr<ossimPointRecord> record (opr);
+   if (!opr)
+      return;
+
+   // The first point sets the fields stored:
+   sync();
+   if (m_lat.empty() && (opr->getFieldCode() != m_fieldCode))
+   {
       m_fieldCode = opr->getFieldCode();
+      allocateFields();
+   }
 
-   m_pointList.push_back(ossimRefPtr<ossimPointRecord>(opr));
-   m_minMaxValid = false;
+   ossim_uint32 i = addPoint(opr->getPosition(), opr->getPointId());
+   for (ossim_uint32 k=0; k<NUM_FIELDS; ++k)
+   {
+      if (!m_fields[k].empty())
+         m_fields[k][i] = opr->getField(FIELD_CODE_LIST[k]);
+   }
+}
+
+ossim_uint32 ossimPointBlock::addPoint(const ossimGpt& pos, ossim_uint32 pointId)
+{
+   sync();
+   if (m_lat.empty())
+      m_datum = pos.datum();
+
+   m_lat.push_back(pos.lat);
+   m_lon.push_back(pos.lon);
+   m_hgt.push_back(pos.hgt);
+   m_pointId.push_back(pointId);
+   for (ossim_uint32 k=0; k<NUM_FIELDS; ++k)
+   {
+      if (m_fieldCode & FIELD_CODE_LIST[k])
+         m_fields[k].push_back(ossim::nan());
+   }
+   invalidate();
+
+   return (ossim_uint32)m_lat.size() - 1;
+}
+
+ossim_uint32 ossimPointBlock::addPoint(const ossimPointBlock& block, ossim_uint32 i)
+{
+   sync();
+   block.sync();
+   if (m_lat.empty() && (block.m_fieldCode != m_fieldCode))
+   {
+      m_fieldCode = block.m_fieldCode;
+      allocateFields();
+   }
+
+   ossim_uint32 index = addPoint(block.getPosition(i), block.m_pointId[i]);
+   for (ossim_uint32 k=0; k<NUM_FIELDS; ++k)
+   {
+      if (!m_fields[k].empty())
+         m_fields[k][index] = block.m_fields[k].empty() ? ossim::nan() : block.m_fields[k][i];
+   }
+   return index;
+}
+
+void ossimPointBlock::updateMinMax() const
+{
+   sync();
+   std::lock_guard<std::mutex> lock(m_lazyMutex);
+   if (!m_minMaxValid)
+      scanForMinMax();
 }
 
 void ossimPointBlock::scanForMinMax() const
 {
-   ossim_uint32 numPoints = size();
+   ossim_uint32 numPoints = (ossim_uint32)m_lat.size();
    if (numPoints == 0)
       return;
 
-   // Latch first point:
-   m_minRecord = *(m_pointList[0].get());
-   m_maxRecord = m_minRecord;
-   ossimGpt minPos (m_minRecord.getPosition());
+   m_minRecord = ossimPointRecord(m_fieldCode);
+   m_maxRecord = ossimPointRecord(m_fieldCode);
+
+   // Positions, a column at a time:
+   ossimGpt minPos (m_lat[0], m_lon[0], m_hgt[0]);
+   minPos.datum(m_datum);
    ossimGpt maxPos (minPos);
+   for (ossim_uint32 i=1; i<numPoints; ++i)
+   {
+      minPos.lat = std::min(minPos.lat, m_lat[i]);
+      minPos.lon = std::min(minPos.lon, m_lon[i]);
+      minPos.hgt = std::min(minPos.hgt, m_hgt[i]);
+      maxPos.lat = std::max(maxPos.lat, m_lat[i]);
+      maxPos.lon = std::max(maxPos.lon, m_lon[i]);
+      maxPos.hgt = std::max(maxPos.hgt, m_hgt[i]);
+   }
+   m_minRecord.setPosition(minPos);
+   m_maxRecord.setPosition(maxPos);
 
    // For shorthand later:
-   const ossimPointRecord::FIELD_CODES I = ossimPointRecord::Intensity;
    const ossimPointRecord::FIELD_CODES R = ossimPointRecord::Red;
    const ossimPointRecord::FIELD_CODES G = ossimPointRecord::Green;
    const ossimPointRecord::FIELD_CODES B = ossimPointRecord::Blue;
-   const ossimPointRecord::FIELD_CODES S = ossimPointRecord::ReturnNumber;
-   const ossimPointRecord::FIELD_CODES N = ossimPointRecord::NumberOfReturns;
 
    // If color available, latch the min for all bands as one to minimize color distortion:
-   bool hasRGB = false;
-   if (m_minRecord.hasFields(R|G|B))
-   {
-      hasRGB = true;
-      ossim_float32 r = m_pointList[0]->getField(R);
-      ossim_float32 g = m_pointList[0]->getField(G);
-      ossim_float32 b = m_pointList[0]->getField(B);
-      float minC = std::min(r, std::min(g, b));
-      float maxC = std::max(r, std::max(g, b));
-      m_minRecord.setField(R,   minC);
+   const bool hasRGB = ((m_fieldCode & (R|G|B)) == (ossim_uint32)(R|G|B));
+   if (hasRGB)
+   {
+      const ossim_float32* r = &m_fields[fieldIndex(R)].front();
+      const ossim_float32* g = &m_fields[fieldIndex(G)].front();
+      const ossim_float32* b = &m_fields[fieldIndex(B)].front();
+      ossim_float32 minC = std::min(r[0], std::min(g[0], b[0]));
+      ossim_float32 maxC = std::max(r[0], std::max(g[0], b[0]));
+      for (ossim_uint32 i=1; i<numPoints; ++i)
+      {
+         minC = std::min(minC, std::min(r[i], std::min(g[i], b[i])));
+         maxC = std::max(maxC, std::max(r[i], std::max(g[i], b[i])));
+      }
+      m_minRecord.setField(R, minC);
       m_minRecord.setField(G, minC);
-      m_minRecord.setField(B,  minC);
-      m_maxRecord.setField(R,   maxC);
+      m_minRecord.setField(B, minC);
+      m_maxRecord.setField(R, maxC);
       m_maxRecord.setField(G, maxC);
-      m_maxRecord.setField(B,  maxC);
+      m_maxRecord.setField(B, maxC);
    }
 
-   // Now loop over all points in file to latch min/max:
-   for (ossim_uint32 i=0; i<numPoints; ++i)
+   // Remaining fields one column at a time:
+   for (ossim_uint32 k=0; k<NUM_FIELDS; ++k)
    {
-      if (m_pointList[i]->getPosition().lat < minPos.lat)
-         minPos.lat = m_pointList[i]->getPosition().lat;
-      if (m_pointList[i]->getPosition().lon < minPos.lon)
-         minPos.lon = m_pointList[i]->getPosition().lon;
-      if (m_pointList[i]->getPosition().hgt < minPos.hgt)
-         minPos.hgt = m_pointList[i]->getPosition().hgt;
-
-      if (m_pointList[i]->getPosition().lat > maxPos.lat)
-         maxPos.lat = m_pointList[i]->getPosition().lat;
-      if (m_pointList[i]->getPosition().lon > maxPos.lon)
-         maxPos.lon = m_pointList[i]->getPosition().lon;
-      if (m_pointList[i]->getPosition().hgt > maxPos.hgt)
-         maxPos.hgt = m_pointList[i]->getPosition().hgt;
-
-      if (m_minRecord.hasFields(I) &&  (m_minRecord.getField(I) > m_pointList[i]->getField(I)))
-         m_minRecord.setField(I, m_pointList[i]->getField(I));
-
-      if (m_minRecord.hasFields(S) &&  (m_minRecord.getField(S) > m_pointList[i]->getField(S)))
-         m_minRecord.setField(S, m_pointList[i]->getField(S));
-
-      if (m_minRecord.hasFields(N) &&  (m_minRecord.getField(N) > m_pointList[i]->getField(N)))
-         m_minRecord.setField(N, m_pointList[i]->getField(N));
-
-      if (hasRGB)
+      const ossimPointRecord::FIELD_CODES fc = FIELD_CODE_LIST[k];
+      if (m_fields[k].empty() || (hasRGB && ((fc == R) || (fc == G) || (fc == B))))
+         continue;
+
+      const ossim_float32* column = &m_fields[k].front();
+      ossim_float32 minV = column[0];
+      ossim_float32 maxV = column[0];
+      for (ossim_uint32 i=1; i<numPoints; ++i)
       {
-         ossim_float32 r = m_pointList[i]->getField(R);
-         ossim_float32 g = m_pointList[i]->getField(G);
-         ossim_float32 b = m_pointList[i]->getField(B);
-
-         float minC = std::min(r, std::min(g, b));
-         if (m_minRecord.getField(R) > minC)
-         {
-            m_minRecord.setField(R, minC);
-            m_minRecord.setField(G, minC);
-            m_minRecord.setField(B, minC);
-         }
-
-         float maxC = std::max(r, std::max(g, b));
-         if (m_maxRecord.getField(R) < maxC)
-         {
-            m_maxRecord.setField(R, maxC);
-            m_maxRecord.setField(G, maxC);
-            m_maxRecord.setField(B, maxC);
-         }
+         minV = std::min(minV, column[i]);
+         maxV = std::max(maxV, column[i]);
       }
-   } // end loop over all points
+      m_minRecord.setField(fc, minV);
+      m_maxRecord.setField(fc, maxV);
+   }
 
-   m_minRecord.setPosition(minPos);
-   m_maxRecord.setPosition(maxPos);
    m_minMaxValid = true;
 }
-
-
-
-
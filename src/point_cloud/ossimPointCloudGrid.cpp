@@ -0,0 +1,149 @@
+//**************************************************************************************************
+//
+// OSSIM (http://trac.osgeo.org/ossim/)
+//
+// License:  LGPL -- See LICENSE.txt file in the top level directory for more details.
+//
+//**************************************************************************************************
+// $Id$
+
+#include <ossim/point_cloud/ossimPointCloudGrid.h>
+#include <algorithm>
+
+ossimPointCloudGrid::ossimPointCloudGrid()
+:  m_width(0),
+   m_height(0),
+   m_numBands(0),
+   m_reducer(MEAN)
+{
+}
+
+ossimPointCloudGrid::ossimPointCloudGrid(ossim_uint32 width, ossim_uint32 height,
+                                         ossim_uint32 numBands, Reducer reducer)
+:  m_width(0),
+   m_height(0),
+   m_numBands(0),
+   m_reducer(MEAN)
+{
+   initialize(width, height, numBands, reducer);
+}
+
+void ossimPointCloudGrid::initialize(ossim_uint32 width, ossim_uint32 height,
+                                     ossim_uint32 numBands, Reducer reducer)
+{
+   m_width = width;
+   m_height = height;
+   m_numBands = numBands;
+   m_reducer = reducer;
+
+   const std::size_t cells = (std::size_t) width * height;
+   m_count.assign(cells, 0);
+   m_value.assign(cells * numBands, 0.0);
+}
+
+void ossimPointCloudGrid::clear()
+{
+   std::fill(m_count.begin(), m_count.end(), 0);
+   std::fill(m_value.begin(), m_value.end(), 0.0);
+}
+
+void ossimPointCloudGrid::add(ossim_uint32 cell, const ossim_float32* values)
+{
+   const bool first = (m_count[cell] == 0);
+   ++m_count[cell];
+
+   ossim_float64* v = &m_value[(std::size_t) cell * m_numBands];
+   switch (m_reducer)
+   {
+   case MEAN:
+   case SUM:
+      for (ossim_uint32 b=0; b<m_numBands; ++b)
+         v[b] += values[b];
+      break;
+   case MIN:
+      for (ossim_uint32 b=0; b<m_numBands; ++b)
+      {
+         if (first || (values[b] < v[b]))
+            v[b] = values[b];
+      }
+      break;
+   case MAX:
+      for (ossim_uint32 b=0; b<m_numBands; ++b)
+      {
+         if (first || (values[b] > v[b]))
+            v[b] = values[b];
+      }
+      break;
+   default: // COUNT
+      break;
+   }
+}
+
+void ossimPointCloudGrid::merge(const ossimPointCloudGrid& grid)
+{
+   if ((grid.m_width != m_width) || (grid.m_height != m_height) ||
+       (grid.m_numBands != m_numBands) || (grid.m_reducer != m_reducer))
+   {
+      return;
+   }
+
+   const ossim_uint32 cells = getNumberOfCells();
+   for (ossim_uint32 cell=0; cell<cells; ++cell)
+   {
+      if (grid.m_count[cell] == 0)
+         continue;
+
+      const bool first = (m_count[cell] == 0);
+      m_count[cell] += grid.m_count[cell];
+
+      const std::size_t offset = (std::size_t) cell * m_numBands;
+      for (ossim_uint32 b=0; b<m_numBands; ++b)
+      {
+         const ossim_float64 value = grid.m_value[offset + b];
+         switch (m_reducer)
+         {
+         case MEAN:
+         case SUM:
+            m_value[offset + b] += value;
+            break;
+         case MIN:
+            if (first || (value < m_value[offset + b]))
+               m_value[offset + b] = value;
+            break;
+         case MAX:
+            if (first || (value > m_value[offset + b]))
+               m_value[offset + b] = value;
+            break;
+         default: // COUNT
+            break;
+         }
+      }
+   }
+}
+
+ossim_float32 ossimPointCloudGrid::getValue(ossim_uint32 cell, ossim_uint32 band,
+                                            ossim_float32 nullValue) const
+{
+   const ossim_uint32 count = m_count[cell];
+   if (count == 0)
+      return nullValue;
+
+   const std::size_t offset = (std::size_t) cell * m_numBands + band;
+   switch (m_reducer)
+   {
+   case MEAN:
+      return (ossim_float32) (m_value[offset] / count);
+   case COUNT:
+      return (ossim_float32) count;
+   default: // SUM, MIN, MAX
+      return (ossim_float32) m_value[offset];
+   }
+}
+
+void ossimPointCloudGrid::getBand(ossim_uint32 band, ossim_float32* buf,
+                                  ossim_float32 nullValue) const
+{
+   const ossim_uint32 cells = getNumberOfCells();
+   for (ossim_uint32 cell=0; cell<cells; ++cell)
+      buf[cell] = getValue(cell, band, nullValue);
+}
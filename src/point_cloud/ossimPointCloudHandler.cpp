@@ -43,7 +43,7 @@ void ossimPointCloudHandler::getBlock(const ossimGrect& bounds, ossimPointBlock&
 
    // This default implementation simply reads the whole datafile in file-blocks, retaining
    // only those points inside the bounds:
-   ossimPointBlock file_block;
+   ossimPointBlock file_block (0, block.getFieldCode());
    rewind();
    ossimGpt gpt;
 
@@ -51,14 +51,13 @@ void ossimPointCloudHandler::getBlock(const ossimGrect& bounds, ossimPointBlock&
    {
       file_block.clear();
       getNextFileBlock(file_block, DEFAULT_BLOCK_SIZE);
-      ossimPointBlock::PointList& pointList = file_block.getPoints();
-      ossimPointBlock::PointList::iterator iter = pointList.begin();
-      while (iter != pointList.end())
+      ossimPointBlock::const_iterator iter = file_block.begin();
+      while (iter != file_block.end())
       {
-         gpt = (*iter)->getPosition();
+         gpt = iter.getPosition();
          if (bounds.pointWithin(gpt))
          {
-            block.addPoint(iter->get());
+            block.addPoint(file_block, iter.getIndex());
          }
          ++iter;
       }
@@ -79,23 +78,19 @@ void ossimPointCloudHandler::normalizeBlock(ossimPointBlock& block)
       return;
 
    ossim_uint32 numPoints = block.size();
-   float val, norm, min, max;
+   float min, max;
    vector<ossimPointRecord::FIELD_CODES> field_codes = block.getFieldCodesAsList();
-   vector<ossimPointRecord::FIELD_CODES>::const_iterator iter;
+   vector<ossimPointRecord::FIELD_CODES>::const_iterator iter = field_codes.begin();
    ossimPointRecord::FIELD_CODES field_code;
-   for (ossim_uint32 i=0; i<numPoints; ++i)
+   while (iter != field_codes.end())
    {
-      ossimPointRecord* opr = block[i];
-      iter = field_codes.begin();
-      while (iter != field_codes.end())
-      {
-         field_code = *iter;
-         min = m_minRecord->getField(field_code);
-         max = m_maxRecord->getField(field_code);
-         val = opr->getField(field_code);
-         norm = (val - min) / (max - min);
-         opr->setField(field_code, norm);
-         ++iter;
-      }
+      // A column at a time:
+      field_code = *iter;
+      min = m_minRecord->getField(field_code);
+      max = m_maxRecord->getField(field_code);
+      ossim_float32* column = block.getFieldColumn(field_code);
+      for (ossim_uint32 i=0; column && (i<numPoints); ++i)
+         column[i] = (column[i] - min) / (max - min);
+      ++iter;
    }
 }
@@ -25,13 +25,22 @@
 #include <ossim/base/ossimNumericProperty.h>
 #include <ossim/base/ossimStringProperty.h>
 #include <ossim/imaging/ossimImageDataFactory.h>
+#include <ossim/parallel/ossimJobWorkStealingQueue.h>
 #include <ossim/projection/ossimEpsgProjectionFactory.h>
+#include <algorithm>
 
 using namespace std;
 
 static ossimTrace traceDebug("ossimPointCloudImageHandler:debug");
 static const char* GSD_FACTOR_KW = "gsd_factor";
 static const char* COMPONENT_KW = "component";
+static const char* THREADS_KW = "threads";
+
+// Tiles with fewer points than this per thread are not worth splitting further:
+static const ossim_uint32 MIN_POINTS_PER_THREAD = 8192;
+
+// Points go through the geometry in chunks of this many:
+static const ossim_uint32 POINT_CHUNK_SIZE = 64;
 
 // The member m_activeComponent should be one of the following strings. This is set either in a
 // state KWL or by a call to setProperty(<"active_component", <string> >)
@@ -41,43 +50,6 @@ static const char* LOWEST_KW = "LOWEST";
 static const char* RETURNS_KW = "RETURNS";
 static const char* RGB_KW = "RGB";
 
-ossimPointCloudImageHandler::PcrBucket::PcrBucket(const ossim_float32* init_value,
-                                                  ossim_uint32 numBands)
-:  m_numSamples (1)
-{
-   m_bucket = new ossim_float32[numBands];
-   for (ossim_uint32 i=0; i<numBands; i++)
-      m_bucket[i] = init_value[i];
-}
-
-
-ossimPointCloudImageHandler::PcrBucket::PcrBucket(const ossim_float32& R,
-      const ossim_float32& G,
-      const ossim_float32& B)
-:  m_numSamples (1)
-{
-   m_bucket = new ossim_float32[3];
-   m_bucket[0] = R;
-   m_bucket[1] = G;
-   m_bucket[2] = B;
-
-}
-
-
-ossimPointCloudImageHandler::PcrBucket::PcrBucket(const ossim_float32& init_value)
-:  m_numSamples (1)
-{
-   m_bucket = new ossim_float32[1];
-   m_bucket[0] = init_value;
-}
-
-
-ossimPointCloudImageHandler::PcrBucket::~PcrBucket()
-{
-   delete [] m_bucket;
-}
-
-
 ossimPointCloudImageHandler::ossimPointCloudImageHandler()
       : ossimImageHandler(),
         m_maxPixel(1.0),
@@ -86,7 +58,8 @@ ossimPointCloudImageHandler::ossimPointCloudImageHandler()
         m_gsdFactor (1.0),
         m_tile(0),
         m_mutex(),
-        m_activeComponent(INTENSITY)
+        m_activeComponent(INTENSITY),
+        m_numThreads(0)
 {
    //---
    // Nan out as can be set in several places, i.e. setProperty,
@@ -236,7 +209,6 @@ bool ossimPointCloudImageHandler::getTile(ossimImageData* result, ossim_uint32 r
    const ossimIpt tile_offset (img_tile_rect.ul());
    const ossim_uint32 tile_width = img_tile_rect.width();
    const ossim_uint32 tile_height = img_tile_rect.height();
-   const ossim_uint32 tile_size = img_tile_rect.area();
 
    ossimGpt gnd_ul, gnd_lr;
    ossimDpt dpt_ul (img_tile_rect.ul().x - 0.5, img_tile_rect.ul().y - 0.5);
@@ -245,7 +217,6 @@ bool ossimPointCloudImageHandler::getTile(ossimImageData* result, ossim_uint32 r
    theGeometry->rnToWorld(dpt_lr, resLevel, gnd_lr);
    const ossimGrect gnd_rect (gnd_ul, gnd_lr);
 
-   // Create array of buckets to store accumulated point data.
    ossim_uint32 numBands = result->getNumberOfBands();
    if (numBands > getNumberOfInputBands())
    {
@@ -257,180 +228,136 @@ bool ossimPointCloudImageHandler::getTile(ossimImageData* result, ossim_uint32 r
       result->makeBlank();
       return false;
    }
-   std::map<ossim_int32, PcrBucket*> accumulator;
 
-   // initialize a point block with desired fields as requested in the reader properties
+   // Read the points under the tile. The point cloud handler is shared by all tile requests, so
+   // only the read is serialized; the rasterizing below runs outside the lock.
+   const Components component = m_activeComponent;
    ossimPointBlock pointBlock (this);
-   pointBlock.setFieldCode(componentToFieldCode());
-   m_pch->rewind();
-
-   ossimDpt ipt;
-   ossimGpt pos;
-
-#define USE_GETBLOCK
-#ifdef USE_GETBLOCK
-   m_pch->getBlock(gnd_rect, pointBlock);
-   for (ossim_uint32 id=0; id<pointBlock.size(); ++id)
    {
-      pos = pointBlock[id]->getPosition();
-      theGeometry->worldToRn(pos, resLevel, ipt);
-      ipt.x = ossim::round<double,double>(ipt.x) - tile_offset.x;
-      ipt.y = ossim::round<double,double>(ipt.y) - tile_offset.y;
-
-      ossim_int32 bucketIndex = ipt.y*tile_width + ipt.x;
-      if ((bucketIndex >= 0) && (bucketIndex < (ossim_int32)tile_size))
-         addSample(accumulator, bucketIndex, pointBlock[id]);
+      std::lock_guard<std::mutex> lock (m_mutex);
+      pointBlock.setFieldCode(componentToFieldCode());
+      m_pch->rewind();
+      m_pch->getBlock(gnd_rect, pointBlock);
    }
 
-#else // using getFileBlock
-   ossim_uint32 numPoints = m_pch->getNumPoints();
-   if (numPoints > ossimPointCloudHandler::DEFAULT_BLOCK_SIZE)
-      numPoints = ossimPointCloudHandler::DEFAULT_BLOCK_SIZE;
+   // Split the points into shares run on the shared job pool and this thread, each filling its
+   // own grid, then fold the grids together:
+   const ossim_uint32 numPoints = pointBlock.size();
+   const ossim_uint32 gridBands = (component == RGB) ? 3 : 1;
+   const ossimPointCloudGrid::Reducer reducer = componentToReducer(component);
+   const ossim_uint32 numThreads =
+         std::max<ossim_uint32>(1, std::min(getNumberOfThreads(), numPoints / MIN_POINTS_PER_THREAD));
+   const ossim_uint32 pointsPerThread = (numPoints + numThreads - 1) / numThreads;
 
-   // Loop to read all point blocks:
-   do
-   {
-      pointBlock.clear();
-      m_pch->getNextFileBlock(pointBlock, numPoints);
-      //m_pch->normalizeBlock(pointBlock);
-
-      for (ossim_uint32 id=0; id<pointBlock.size(); ++id)
+   std::vector<ossimPointCloudGrid> grids (numThreads);
+   ossimJobWorkStealingQueue::instance()->parallelFor(numThreads, numThreads - 1,
+      [&](ossim_uint32 t)
       {
-         // Check that each point in read block is inside the ROI before accumulating it:
-         pos = pointBlock[id]->getPosition();
-         if (gnd_rect.pointWithin(pos))
-         {
-            theGeometry->worldToRn(pos, resLevel, ipt);
-            ipt.x = ossim::round<double,double>(ipt.x) - tile_offset.x;
-            ipt.y = ossim::round<double,double>(ipt.y) - tile_offset.y;
+         grids[t].initialize(tile_width, tile_height, gridBands, reducer);
+         const ossim_uint32 first = std::min(numPoints, t*pointsPerThread);
+         const ossim_uint32 last = std::min(numPoints, first + pointsPerThread);
+         accumulate(pointBlock, first, last, tile_offset, resLevel, component, grids[t]);
+      });
+   for (ossim_uint32 t=1; t<numThreads; ++t)
+      grids[0].merge(grids[t]);
 
-            ossim_int32 bucketIndex = ipt.y*tile_width + ipt.x;
-            if ((bucketIndex >= 0) && (bucketIndex < (ossim_int32)tile_size))
-               addSample(accumulator, bucketIndex, pointBlock[id]);
-         }
-      }
-   } while (pointBlock.size() == numPoints);
-#endif
-
-   // Finished accumulating, need to normalize and fill the tile.
    // We must always blank out the tile as we may not have a point for every pixel.
-   normalize(accumulator);
-   auto buf = new ossim_float32*[numBands];
-   std::map<ossim_int32, PcrBucket*>::iterator accum_iter;
    ossim_float32 null_pixel = OSSIM_DEFAULT_NULL_PIX_FLOAT;
    result->setNullPix(null_pixel);
    for (ossim_uint32 band = 0; band < numBands; band++)
+      grids[0].getBand(band, result->getFloatBuf(band), null_pixel);
+
+   result->validate();
+   return true;
+}
+
+void ossimPointCloudImageHandler::accumulate(const ossimPointBlock& block,
+                                             ossim_uint32 first,
+                                             ossim_uint32 last,
+                                             const ossimIpt& tile_offset,
+                                             ossim_uint32 resLevel,
+                                             Components component,
+                                             ossimPointCloudGrid& grid) const
+{
+   // Columns feeding the grid bands. Elevation components take the heights.
+   const ossim_float64* hgts = block.getHgts();
+   const ossim_float32* columns[3] = { 0, 0, 0 };
+   if (component == INTENSITY)
+      columns[0] = block.getFieldColumn(ossimPointRecord::Intensity);
+   else if (component == RETURNS)
+      columns[0] = block.getFieldColumn(ossimPointRecord::NumberOfReturns);
+   else if (component == RGB)
+   {
+      columns[0] = block.getFieldColumn(ossimPointRecord::Red);
+      columns[1] = block.getFieldColumn(ossimPointRecord::Green);
+      columns[2] = block.getFieldColumn(ossimPointRecord::Blue);
+   }
+   const bool useHeights = (component == HIGHEST) || (component == LOWEST);
+   const ossim_uint32 numBands = grid.getNumberOfBands();
+   const ossim_int32 width = (ossim_int32) grid.getWidth();
+   const ossim_int32 height = (ossim_int32) grid.getHeight();
+   const ossim_uint32 targetRrds = theGeometry->getTargetRrds();
+
+   ossimGpt gpts[POINT_CHUNK_SIZE];
+   ossimDpt local_pts[POINT_CHUNK_SIZE];
+   ossimDpt ipt;
+   ossim_float32 values[3];
+   for (ossim_uint32 start=first; start<last; start+=POINT_CHUNK_SIZE)
    {
-      ossim_uint32 index = 0;
-      buf[band] = result->getFloatBuf(band);
-      for (ossim_uint32 y = 0; y < tile_height; y++)
+      const ossim_uint32 n = std::min(last - start, POINT_CHUNK_SIZE);
+      for (ossim_uint32 i=0; i<n; ++i)
+         gpts[i] = block.getPosition(start + i);
+      theGeometry->worldToLocal(gpts, local_pts, n);
+
+      for (ossim_uint32 i=0; i<n; ++i)
       {
-         for (ossim_uint32 x = 0; x < tile_width; x++)
+         theGeometry->rnToRn(local_pts[i], targetRrds, resLevel, ipt);
+         if (ipt.hasNans())
+            continue;
+
+         const ossim_int32 x = ossim::round<ossim_int32,double>(ipt.x) - tile_offset.x;
+         const ossim_int32 y = ossim::round<ossim_int32,double>(ipt.y) - tile_offset.y;
+         if ((x < 0) || (y < 0) || (x >= width) || (y >= height))
+            continue;
+
+         const ossim_uint32 id = start + i;
+         for (ossim_uint32 b=0; b<numBands; ++b)
          {
-            accum_iter = accumulator.find(index);
-            if (accum_iter != accumulator.end())
-               buf[band][index] = accum_iter->second->m_bucket[band];
+            if (useHeights)
+               values[b] = (ossim_float32) hgts[id];
             else
-               buf[band][index] = null_pixel;
-            ++index;
+               values[b] = columns[b] ? columns[b][id] : ossim::nan();
          }
+         grid.add((ossim_uint32) (y*width + x), values);
       }
    }
-
-   delete [] buf;
-   buf = 0;
-
-   auto pcr_iter = accumulator.begin();
-   while (pcr_iter != accumulator.end())
-   {
-      delete pcr_iter->second;
-      pcr_iter++;
-   }
-
-   result->validate();
-   return true;
 }
 
-void ossimPointCloudImageHandler::addSample(std::map<ossim_int32, PcrBucket*>& accumulator,
-                                            ossim_int32 index,
-                                            const ossimPointRecord* sample)
+ossimPointCloudGrid::Reducer
+ossimPointCloudImageHandler::componentToReducer(Components component)
 {
-   if (sample == 0)
-      return;
-
-   //cout << "sample: "<<*sample<<endl;//TODO: REMOVE DEBUG
-
-   // Search map for exisiting point in that location:
-   auto iter = accumulator.find(index);
-   if (iter == accumulator.end())
-   {
-      // First hit. Initialize location with current sample:
-      if (m_activeComponent == INTENSITY)
-      {
-         accumulator[index] = new PcrBucket(sample->getField(ossimPointRecord::Intensity));
-      }
-      else if (m_activeComponent == RGB)
-      {
-         ossim_float32 color[3];
-         color[0] = sample->getField(ossimPointRecord::Red);
-         color[1] = sample->getField(ossimPointRecord::Green);
-         color[2] = sample->getField(ossimPointRecord::Blue);
-         accumulator[index] = new PcrBucket(color, 3);
-      }
-      else if ((m_activeComponent == LOWEST) || (m_activeComponent == HIGHEST))
-         accumulator[index] = new PcrBucket(sample->getPosition().hgt);
-      else if (m_activeComponent == RETURNS)
-         accumulator[index] = new PcrBucket(sample->getField(ossimPointRecord::NumberOfReturns));
-   }
-   else
+   // Highest and lowest elevations latch extremes and returns are summed; the rest are averaged:
+   switch (component)
    {
-      // Not the first hit at this location, accumulate:
-      // First hit. Initialize location with current sample:
-      if (m_activeComponent == INTENSITY)
-      {
-         iter->second->m_bucket[0] += sample->getField(ossimPointRecord::Intensity);
-      }
-      else if (m_activeComponent == RGB)
-      {
-         iter->second->m_bucket[0] += sample->getField(ossimPointRecord::Red);
-         iter->second->m_bucket[1] += sample->getField(ossimPointRecord::Green);
-         iter->second->m_bucket[2] += sample->getField(ossimPointRecord::Blue);
-      }
-      else if ((m_activeComponent == HIGHEST) &&
-            (sample->getPosition().hgt > iter->second->m_bucket[0]))
-         iter->second->m_bucket[0] = sample->getPosition().hgt;
-      else if ((m_activeComponent == LOWEST) &&
-            (sample->getPosition().hgt < iter->second->m_bucket[0]))
-         iter->second->m_bucket[0] = sample->getPosition().hgt;
-      else if (m_activeComponent == RETURNS)
-         iter->second->m_bucket[0] += sample->getField(ossimPointRecord::NumberOfReturns);
-
-      iter->second->m_numSamples++;
+   case HIGHEST:
+      return ossimPointCloudGrid::MAX;
+   case LOWEST:
+      return ossimPointCloudGrid::MIN;
+   case RETURNS:
+      return ossimPointCloudGrid::SUM;
+   default:
+      return ossimPointCloudGrid::MEAN;
    }
 }
 
-void ossimPointCloudImageHandler::normalize(std::map<ossim_int32, PcrBucket*>& accumulator)
+void ossimPointCloudImageHandler::setNumberOfThreads(ossim_uint32 numThreads)
 {
-   // highest and lowest elevations latch extremes, no mean is computed but needs to be normalized
-   if ((m_activeComponent == LOWEST) || (m_activeComponent == HIGHEST) ||
-         (m_activeComponent == RETURNS))
-      return;
-
-   int numBands = 1;
-   if (m_activeComponent == RGB)
-      numBands = 3;
+   m_numThreads = numThreads;
+}
 
-   auto iter = accumulator.begin();
-   ossim_float32 avg;
-   while (iter != accumulator.end())
-   {
-      for (int i=0; i<numBands; i++)
-      {
-         avg = iter->second->m_bucket[i] / iter->second->m_numSamples;
-         iter->second->m_bucket[i] = avg;
-      }
-      iter++;
-   }
+ossim_uint32 ossimPointCloudImageHandler::getNumberOfThreads() const
+{
+   return m_numThreads ? m_numThreads : ossim::getNumberOfThreads();
 }
 
 ossim_uint32 ossimPointCloudImageHandler::getNumberOfInputBands() const
@@ -764,6 +691,10 @@ void ossimPointCloudImageHandler::setProperty(ossimRefPtr<ossimProperty> propert
    {
       m_activeComponent = (Components) s.toUInt32();
    }
+   else if ( property->getName() == THREADS_KW )
+   {
+      setNumberOfThreads(s.toUInt32());
+   }
    else if ( property->getName() == COMPONENT_KW )
    {
       for (int i=0; i<NUM_COMPONENTS; i++)
@@ -801,6 +732,10 @@ ossimRefPtr<ossimProperty> ossimPointCloudImageHandler::getProperty(const ossimS
    {
       prop = new ossimStringProperty(name, m_componentNames[m_activeComponent]);
    }
+   else if ( name == THREADS_KW )
+   {
+      prop = new ossimNumericProperty(name, ossimString::toString(m_numThreads));
+   }
    else
    {
       prop = ossimImageHandler::getProperty(name);
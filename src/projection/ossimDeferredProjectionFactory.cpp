@@ -0,0 +1,145 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/projection/ossimDeferredProjectionFactory.h>
+#include <ossim/projection/ossimProjectionFactoryRegistry.h>
+#include <ossim/projection/ossimProjection.h>
+#include <ossim/imaging/ossimImageHandler.h>
+#include <ossim/base/ossimKeywordNames.h>
+#include <ossim/base/ossimKeywordlist.h>
+
+RTTI_DEF1(ossimDeferredProjectionFactory, "ossimDeferredProjectionFactory",
+          ossimProjectionFactoryBase);
+
+ossimDeferredProjectionFactory::ossimDeferredProjectionFactory(
+   std::shared_ptr<ossimDeferredPlugin> plugin)
+   :
+   ossimProjectionFactoryBase(),
+   m_plugin(plugin),
+   m_services(plugin->getEntry().projections),
+   m_registrations(),
+   m_previousCapture(0)
+{
+   m_plugin->addListener( this );
+}
+
+const ossimDeferredProjectionFactory::RegistrationList&
+ossimDeferredProjectionFactory::load(const ossimString& reason)const
+{
+   m_plugin->load( reason );
+   return m_registrations;
+}
+
+bool ossimDeferredProjectionFactory::mayCreate(const ossimString& name)const
+{
+   return m_services.hasType( name ) || name.contains( ":" );
+}
+
+void ossimDeferredProjectionFactory::beginLoad()
+{
+   m_previousCapture =
+      ossimProjectionFactoryRegistry::instance()->setCaptureList( &m_registrations );
+}
+
+void ossimDeferredProjectionFactory::endLoad()
+{
+   ossimProjectionFactoryRegistry::instance()->setCaptureList( m_previousCapture );
+   m_previousCapture = 0;
+}
+
+ossimProjection* ossimDeferredProjectionFactory::createProjection(const ossimFilename& filename,
+                                                                  ossim_uint32 entryIdx)const
+{
+   ossimProjection* result = 0;
+   if ( m_services.hasExtension( filename.ext() ) )
+   {
+      const RegistrationList& factories = load( filename );
+      for ( std::size_t i = 0; ( i < factories.size() ) && !result; ++i )
+      {
+         result = factories[i].factory->createProjection( filename, entryIdx );
+      }
+   }
+   return result;
+}
+
+ossimProjection* ossimDeferredProjectionFactory::createProjection(const ossimString& name)const
+{
+   ossimProjection* result = 0;
+   if ( mayCreate( name ) )
+   {
+      const RegistrationList& factories = load( name );
+      for ( std::size_t i = 0; ( i < factories.size() ) && !result; ++i )
+      {
+         result = factories[i].factory->createProjection( name );
+      }
+   }
+   return result;
+}
+
+ossimProjection* ossimDeferredProjectionFactory::createProjection(const ossimKeywordlist& kwl,
+                                                                  const char* prefix)const
+{
+   ossimProjection* result = 0;
+   if ( m_services.mayCreate( kwl, prefix ) )
+   {
+      const RegistrationList& factories = load( kwl.find( prefix, ossimKeywordNames::TYPE_KW ) );
+      for ( std::size_t i = 0; ( i < factories.size() ) && !result; ++i )
+      {
+         result = factories[i].factory->createProjection( kwl, prefix );
+      }
+   }
+   return result;
+}
+
+ossimProjection* ossimDeferredProjectionFactory::createProjection(ossimImageHandler* handler)const
+{
+   ossimProjection* result = 0;
+   if ( handler && m_services.hasHandlerType( handler->getClassName() ) )
+   {
+      const RegistrationList& factories = load( handler->getFilename() );
+      for ( std::size_t i = 0; ( i < factories.size() ) && !result; ++i )
+      {
+         result = factories[i].factory->createProjection( handler );
+      }
+   }
+   return result;
+}
+
+ossimObject* ossimDeferredProjectionFactory::createObject(const ossimString& typeName)const
+{
+   ossimObject* result = 0;
+   if ( mayCreate( typeName ) )
+   {
+      const RegistrationList& factories = load( typeName );
+      for ( std::size_t i = 0; ( i < factories.size() ) && !result; ++i )
+      {
+         result = factories[i].factory->createObject( typeName );
+      }
+   }
+   return result;
+}
+
+ossimObject* ossimDeferredProjectionFactory::createObject(const ossimKeywordlist& kwl,
+                                                          const char* prefix)const
+{
+   ossimObject* result = 0;
+   if ( m_services.mayCreate( kwl, prefix ) )
+   {
+      const RegistrationList& factories = load( kwl.find( prefix, ossimKeywordNames::TYPE_KW ) );
+      for ( std::size_t i = 0; ( i < factories.size() ) && !result; ++i )
+      {
+         result = factories[i].factory->createObject( kwl, prefix );
+      }
+   }
+   return result;
+}
+
+void ossimDeferredProjectionFactory::getTypeNameList(std::vector<ossimString>& typeList)const
+{
+   typeList.insert( typeList.end(), m_services.types.begin(), m_services.types.end() );
+}
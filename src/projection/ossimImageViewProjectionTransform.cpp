@@ -25,6 +25,7 @@
 #include <ossim/base/ossimKeywordlist.h>
 #include <ossim/base/ossimPolyArea2d.h>
 #include <ossim/projection/ossimEquDistCylProjection.h>
+#include <algorithm>
 #include <cmath>
 
 RTTI_DEF1(ossimImageViewProjectionTransform,
@@ -95,11 +96,15 @@ void ossimImageViewProjectionTransform::imageToView(const ossimDpt& ip, ossimDpt
    }
    
    // Check for same projection on input and output sides to save projection to ground:
-   if (m_imageGeometry->getProjection() == m_viewGeometry->getProjection())
+   const ossimProjection* iproj = m_imageGeometry->getProjection();
+   const ossimProjection* vproj = m_viewGeometry->getProjection();
+   if ((iproj && vproj && iproj->isEqualTo(*vproj)) || (iproj == vproj))
    {
       // Check for possible same 2D transforms as well:
-      if ( (m_imageGeometry->getTransform() == m_viewGeometry->getTransform()) &&
-           (m_imageGeometry->decimationFactor(0) == m_viewGeometry->decimationFactor(0)) )
+      const ossim2dTo2dTransform* ixform = m_imageGeometry->getTransform();
+      const ossim2dTo2dTransform* vxform = m_viewGeometry->getTransform();
+      if (((ixform && vxform && ixform->isEqualTo(*vxform)) || (ixform == vxform)) &&
+          (m_imageGeometry->decimationFactor(0) == m_viewGeometry->decimationFactor(0)))
       {
          vp = ip;
          return;
@@ -186,6 +191,70 @@ void ossimImageViewProjectionTransform::viewToImage(const ossimDpt& vp, ossimDpt
 #endif
 }
 
+//*****************************************************************************
+//  Batch version of imageToView.
+//*****************************************************************************
+void ossimImageViewProjectionTransform::imageToView(const ossimDpt* ips,
+                                                    ossimDpt* vps,
+                                                    ossim_uint32 count) const
+{
+   bool trivial = ((m_imageGeometry == m_viewGeometry) || !m_imageGeometry || !m_viewGeometry);
+   if (!trivial)
+   {
+      const ossimProjection* iproj = m_imageGeometry->getProjection();
+      const ossimProjection* vproj = m_viewGeometry->getProjection();
+      trivial = ((iproj && vproj && iproj->isEqualTo(*vproj)) || (iproj == vproj));
+   }
+   if (trivial)
+   {
+      // Trivial cases, no trip to ground:
+      for (ossim_uint32 i = 0; i < count; ++i)
+         imageToView(ips[i], vps[i]);
+      return;
+   }
+
+   // Project to ground and back a chunk at a time:
+   const ossim_uint32 CHUNK_SIZE = 64;
+   ossimGpt gps[CHUNK_SIZE];
+   for (ossim_uint32 start = 0; start < count; start += CHUNK_SIZE)
+   {
+      ossim_uint32 n = std::min(count - start, CHUNK_SIZE);
+      m_imageGeometry->localToWorld(ips + start, gps, n);
+      m_viewGeometry->worldToLocal(gps, vps + start, n);
+   }
+}
+
+//*****************************************************************************
+//  Batch version of viewToImage.
+//*****************************************************************************
+void ossimImageViewProjectionTransform::viewToImage(const ossimDpt* vps,
+                                                    ossimDpt* ips,
+                                                    ossim_uint32 count) const
+{
+   bool trivial = ((m_imageGeometry == m_viewGeometry) || !m_imageGeometry || !m_viewGeometry);
+   if (!trivial)
+   {
+      const ossimProjection* iproj = m_imageGeometry->getProjection();
+      const ossimProjection* vproj = m_viewGeometry->getProjection();
+      trivial = ((iproj && vproj && iproj->isEqualTo(*vproj)) || (iproj == vproj));
+   }
+   if (trivial)
+   {
+      for (ossim_uint32 i = 0; i < count; ++i)
+         viewToImage(vps[i], ips[i]);
+      return;
+   }
+
+   const ossim_uint32 CHUNK_SIZE = 64;
+   ossimGpt gps[CHUNK_SIZE];
+   for (ossim_uint32 start = 0; start < count; start += CHUNK_SIZE)
+   {
+      ossim_uint32 n = std::min(count - start, CHUNK_SIZE);
+      m_viewGeometry->localToWorld(vps + start, gps, n);
+      m_imageGeometry->worldToLocal(gps, ips + start, n);
+   }
+}
+
 void ossimImageViewProjectionTransform::getViewSegments(std::vector<ossimDrect>& viewBounds, 
                                                       ossimPolyArea2d& polyArea,
                                                       ossim_uint32 numberOfEdgePoints)const
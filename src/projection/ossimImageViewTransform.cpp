@@ -38,6 +38,26 @@ void ossimImageViewTransform::viewToImage(const ossimDpt& viewPoint,
    ossim2dTo2dTransform::inverse(viewPoint, imagePoint);
 }
 
+void ossimImageViewTransform::imageToView(const ossimDpt* imagePoints,
+                                          ossimDpt*       viewPoints,
+                                          ossim_uint32    count)const
+{
+   for(ossim_uint32 i = 0; i < count; ++i)
+   {
+      imageToView(imagePoints[i], viewPoints[i]);
+   }
+}
+
+void ossimImageViewTransform::viewToImage(const ossimDpt* viewPoints,
+                                          ossimDpt*       imagePoints,
+                                          ossim_uint32    count)const
+{
+   for(ossim_uint32 i = 0; i < count; ++i)
+   {
+      viewToImage(viewPoints[i], imagePoints[i]);
+   }
+}
+
 ossimDpt ossimImageViewTransform::imageToView(const ossimDpt& imagePoint)const
 {
    ossimDpt tempPt;
@@ -294,16 +314,13 @@ void ossimImageViewTransform::getViewToImageScale(ossimDpt &result,
   ossimDpt iptdx2 = iptdx1 + ossimDpt(dxdy.x, 0.0);
   ossimDpt iptdy1 = viewSeedPoint - ossimDpt(dxdyHalf.y, 0.0);
   ossimDpt iptdy2 = iptdx1 + ossimDpt(0.0, dxdy.y);
-  ossimDpt dx1;
-  ossimDpt dx2;
-  ossimDpt dy1;
-  ossimDpt dy2;
-
-  viewToImage(iptdx1, dx1);
-  viewToImage(iptdx2, dx2);
-
-  viewToImage(iptdy1, dy1);
-  viewToImage(iptdy2, dy2);
+  const ossimDpt viewPts[4] = { iptdx1, iptdx2, iptdy1, iptdy2 };
+  ossimDpt imagePts[4];
+  viewToImage(viewPts, imagePts, 4);
+  const ossimDpt& dx1 = imagePts[0];
+  const ossimDpt& dx2 = imagePts[1];
+  const ossimDpt& dy1 = imagePts[2];
+  const ossimDpt& dy2 = imagePts[3];
 
   if (!(dx1.hasNans() || dx2.hasNans()))
   {
@@ -399,16 +416,13 @@ void ossimImageViewTransform::getImageToViewScale(ossimDpt &result,
   ossimDpt iptdx2 = iptdx1 + ossimDpt(dxdy.x,0.0);
   ossimDpt iptdy1 = imageSeedPoint - ossimDpt(dxdyHalf.y, 0.0);
   ossimDpt iptdy2 = iptdx1 + ossimDpt(0.0,dxdy.y);
-  ossimDpt dx1;
-  ossimDpt dx2;
-  ossimDpt dy1;
-  ossimDpt dy2;
-
-  imageToView(iptdx1, dx1);
-  imageToView(iptdx2, dx2);
-
-  imageToView(iptdy1, dy1);
-  imageToView(iptdy2, dy2);
+  const ossimDpt imagePts[4] = { iptdx1, iptdx2, iptdy1, iptdy2 };
+  ossimDpt viewPts[4];
+  imageToView(imagePts, viewPts, 4);
+  const ossimDpt& dx1 = viewPts[0];
+  const ossimDpt& dx2 = viewPts[1];
+  const ossimDpt& dy1 = viewPts[2];
+  const ossimDpt& dy2 = viewPts[3];
 
   if (!(dx1.hasNans() || dx2.hasNans()))
   {
@@ -454,6 +454,100 @@ void ossimMapProjection::lineSampleToWorld (const ossimDpt& lineSampPt,
       worldPt.hgt = ossimElevManager::instance()->getHeightAboveEllipsoid(worldPt);
 }
 
+void ossimMapProjection::worldToLineSample(const ossimGpt* worldPts,
+                                           ossimDpt*       lineSampPts,
+                                           ossim_uint32    count) const
+{
+   if ( !hasBatchFastPath() )
+   {
+      ossimProjection::worldToLineSample(worldPts, lineSampPts, count);
+      return;
+   }
+
+#ifdef USE_MODEL_TRANSFORM
+   const NEWMAT::Matrix& m = theInverseModelTransform.getData();
+   const double m00 = m[0][0];
+   const double m01 = m[0][1];
+   const double m03 = m[0][3];
+   const double m10 = m[1][0];
+   const double m11 = m[1][1];
+   const double m13 = m[1][3];
+#endif
+
+   for (ossim_uint32 i = 0; i < count; ++i)
+   {
+      ossimDpt& lineSample = lineSampPts[i];
+      if ( worldPts[i].isLatLonNan() )
+      {
+         lineSample.makeNan();
+         continue;
+      }
+
+      ossimGpt gpt = worldPts[i];
+      if ( theDatum )
+         gpt.changeDatum(theDatum);
+
+      ossimDpt modelPoint = forward(gpt);
+
+#ifdef USE_MODEL_TRANSFORM
+      lineSample.x = m00*modelPoint.x + m01*modelPoint.y + m03;
+      lineSample.y = m10*modelPoint.x + m11*modelPoint.y + m13;
+#else
+      eastingNorthingToLineSample(modelPoint, lineSample);
+#endif
+   }
+}
+
+void ossimMapProjection::lineSampleToWorld(const ossimDpt* lineSampPts,
+                                           ossimGpt*       worldPts,
+                                           ossim_uint32    count) const
+{
+   if ( !hasBatchFastPath() )
+   {
+      ossimProjection::lineSampleToWorld(lineSampPts, worldPts, count);
+      return;
+   }
+
+#ifdef USE_MODEL_TRANSFORM
+   const NEWMAT::Matrix& m = theModelTransform.getData();
+   const double m00 = m[0][0];
+   const double m01 = m[0][1];
+   const double m03 = m[0][3];
+   const double m10 = m[1][0];
+   const double m11 = m[1][1];
+   const double m13 = m[1][3];
+#endif
+
+   for (ossim_uint32 i = 0; i < count; ++i)
+   {
+      const ossimDpt& lineSample = lineSampPts[i];
+      ossimGpt& gpt = worldPts[i];
+      if ( lineSample.hasNans() )
+      {
+         gpt.makeNan();
+         continue;
+      }
+
+      ossimDpt modelPoint;
+#ifdef USE_MODEL_TRANSFORM
+      modelPoint.x = m00*lineSample.x + m01*lineSample.y + m03;
+      modelPoint.y = m10*lineSample.x + m11*lineSample.y + m13;
+#else
+      lineSampleToEastingNorthing(lineSample, modelPoint);
+#endif
+
+      gpt = inverse(modelPoint);
+      gpt.hgt = ossim::nan();
+      if ( theElevationLookupFlag )
+         gpt.hgt = ossimElevManager::instance()->getHeightAboveEllipsoid(gpt);
+   }
+}
+
+bool ossimMapProjection::hasBatchFastPath() const
+{
+   return false;
+}
+
 void ossimMapProjection::lineSampleToEastingNorthing(const ossimDpt& lineSample,
                                                      ossimDpt&       eastingNorthing)const
 {
@@ -272,6 +272,35 @@ void ossimNitfRpcModel::worldToLineSample(const ossimGpt& world_point,
    image_point.y = image_point.y * theDecimation;
 }
 
+void ossimNitfRpcModel::worldToLineSample(const ossimGpt* world_points,
+                                          ossimDpt*       image_points,
+                                          ossim_uint32    count) const
+{
+   ossimRpcModel::worldToLineSample(world_points, image_points, count);
+
+   for (ossim_uint32 i = 0; i < count; ++i)
+   {
+      image_points[i].x = image_points[i].x * theDecimation;
+      image_points[i].y = image_points[i].y * theDecimation;
+   }
+}
+
+void ossimNitfRpcModel::worldToLineSample(const double* lat,
+                                          const double* lon,
+                                          const double* hgt,
+                                          double*       line,
+                                          double*       samp,
+                                          ossim_uint32  count) const
+{
+   ossimRpcModel::worldToLineSample(lat, lon, hgt, line, samp, count);
+
+   for (ossim_uint32 i = 0; i < count; ++i)
+   {
+      line[i] = line[i] * theDecimation;
+      samp[i] = samp[i] * theDecimation;
+   }
+}
+
 void ossimNitfRpcModel::lineSampleHeightToWorld(
    const ossimDpt& image_point,
    const double&   heightEllipsoid,
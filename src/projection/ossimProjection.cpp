@@ -168,6 +168,26 @@ void ossimProjection::worldToLineSample(const ossimGpt& worldPoint,
    
 }
 
+void ossimProjection::worldToLineSample(const ossimGpt* worldPts,
+                                        ossimDpt*       lineSampPts,
+                                        ossim_uint32    count) const
+{
+   for (ossim_uint32 i = 0; i < count; ++i)
+   {
+      worldToLineSample(worldPts[i], lineSampPts[i]);
+   }
+}
+
+void ossimProjection::lineSampleToWorld(const ossimDpt* lineSampPts,
+                                        ossimGpt*       worldPts,
+                                        ossim_uint32    count) const
+{
+   for (ossim_uint32 i = 0; i < count; ++i)
+   {
+      lineSampleToWorld(lineSampPts[i], worldPts[i]);
+   }
+}
+
 void ossimProjection::getRoundTripError(const ossimDpt& imagePoint,
                                         ossimDpt& errorResult)const
 {
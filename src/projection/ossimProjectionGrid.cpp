@@ -0,0 +1,541 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/projection/ossimProjectionGrid.h>
+#include <ossim/base/ossimCommon.h>
+#include <ossim/base/ossimDatum.h>
+#include <ossim/base/ossimDatumFactoryRegistry.h>
+#include <ossim/base/ossimGpt.h>
+#include <ossim/base/ossimRefPtr.h>
+#include <ossim/base/ossimSidecarFile.h>
+#include <ossim/projection/ossimProjection.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+namespace
+{
+   using ossim::readValue;
+   using ossim::writeValue;
+   using ossim::readArray;
+   using ossim::writeArray;
+
+   const char         MAGIC[8]        = { 'O', 'S', 'S', 'I', 'M', 'P', 'G', 'R' };
+   const ossim_uint32 VERSION         = 1;
+   const ossim_uint32 START_CELLS     = 8;   // Cells along the longer image side, first pass.
+   const ossim_uint32 MAX_CELLS       = 128; // Finest grid tried before giving up.
+   const ossim_uint32 MAX_LAYERS      = 1024;
+   const ossim_uint32 CHECKS_PER_CELL = 2;   // Check points per cell side, from its edge on.
+
+   void writeString(std::ostream& out, const std::string& s)
+   {
+      writeValue( out, (ossim_uint64)s.size() );
+      out.write( s.data(), s.size() );
+   }
+
+   bool readString(std::istream& in, std::string& s, ossim_uint64 maxSize)
+   {
+      ossim_uint64 size = 0;
+      if ( !readValue( in, size ) || ( size > maxSize ) )
+      {
+         return false;
+      }
+      s.resize( (std::size_t)size );
+      if ( size )
+      {
+         in.read( &s[0], size );
+      }
+      return !in.fail();
+   }
+
+   /**
+    * Locates u, v (in node units) in a cols x rows grid.  Rejects points outside and NaNs.
+    * @param i Index of the upper left node of the cell.
+    */
+   bool locate(double u, double v, ossim_uint32 cols, ossim_uint32 rows,
+               std::size_t& i, double& fu, double& fv)
+   {
+      if ( !( u >= 0.0 ) || !( v >= 0.0 ) || ( u > cols - 1 ) || ( v > rows - 1 ) )
+      {
+         return false;
+      }
+      const ossim_uint32 c = std::min( (ossim_uint32)u, cols - 2 );
+      const ossim_uint32 r = std::min( (ossim_uint32)v, rows - 2 );
+      fu = u - c;
+      fv = v - r;
+      i  = (std::size_t)r * cols + c;
+      return true;
+   }
+
+   double bilinear(const std::vector<ossim_float64>& nodes, std::size_t i, ossim_uint32 cols,
+                   double fu, double fv)
+   {
+      const ossim_float64* p = &nodes[i];
+      const double top    = p[0]    + fu * ( p[1]        - p[0] );
+      const double bottom = p[cols] + fu * ( p[cols + 1] - p[cols] );
+      return top + fv * ( bottom - top );
+   }
+
+   /**
+    * Calls work(proj, k) for k in [0, count) from ossim::getNumberOfThreads() threads, each with
+    * its own copy of the projection since models may keep scratch state.
+    */
+   template <class Work> void forEach(const ossimProjection* proj, ossim_uint32 count, Work work)
+   {
+      const ossim_uint32 threads = std::min( ossim::getNumberOfThreads(), count );
+      std::vector< ossimRefPtr<ossimProjection> > copies;
+      for ( ossim_uint32 t = 0; ( threads > 1 ) && ( t < threads ); ++t )
+      {
+         ossimRefPtr<ossimProjection> copy = dynamic_cast<ossimProjection*>( proj->dup() );
+         if ( !copy.valid() )
+         {
+            copies.clear();
+            break;
+         }
+         copies.push_back( copy );
+      }
+
+      if ( copies.empty() )
+      {
+         for ( ossim_uint32 k = 0; k < count; ++k )
+         {
+            work( proj, k );
+         }
+         return;
+      }
+
+      std::atomic<ossim_uint32> next( 0 );
+      std::vector<std::thread> pool;
+      for ( ossim_uint32 t = 0; t < copies.size(); ++t )
+      {
+         const ossimProjection* copy = copies[t].get();
+         pool.push_back( std::thread( [&next, count, copy, &work]()
+         {
+            for ( ossim_uint32 k = next++; k < count; k = next++ )
+            {
+               work( copy, k );
+            }
+         } ) );
+      }
+      for ( ossim_uint32 t = 0; t < pool.size(); ++t )
+      {
+         pool[t].join();
+      }
+   }
+}
+
+ossimProjectionGrid::ossimProjectionGrid()
+   :
+   m_imageRect(),
+   m_spacing(),
+   m_cols(0),
+   m_rows(0),
+   m_minHgt(0.0),
+   m_hgtStep(0.0),
+   m_maxError(0.0),
+   m_datum(0),
+   m_layers()
+{
+}
+
+void ossimProjectionGrid::clear()
+{
+   m_cols     = 0;
+   m_rows     = 0;
+   m_maxError = 0.0;
+   m_datum    = 0;
+   m_layers.clear();
+}
+
+bool ossimProjectionGrid::build(const ossimProjection* proj, const ossimDrect& imageRect,
+                                double minHgt, double maxHgt, double hgtStep, double maxError)
+{
+   clear();
+
+   const double width  = imageRect.lr().x - imageRect.ul().x;
+   const double height = imageRect.lr().y - imageRect.ul().y;
+   if ( !proj || imageRect.hasNans() || !( width > 0.0 ) || !( height > 0.0 ) ||
+        !( hgtStep > 0.0 ) || !( maxHgt > minHgt ) || !( maxError > 0.0 ) )
+   {
+      return false;
+   }
+
+   // A projection that resolves the center pixel:
+   const ossimDpt center = imageRect.midPoint();
+   ossimGpt g0, gx, gy;
+   proj->lineSampleHeightToWorld( center, 0.0, g0 );
+   proj->lineSampleHeightToWorld( center + ossimDpt( 1.0, 0.0 ), 0.0, gx );
+   proj->lineSampleHeightToWorld( center + ossimDpt( 0.0, 1.0 ), 0.0, gy );
+   const double gsd = std::min( g0.distanceTo( gx ), g0.distanceTo( gy ) );
+   if ( g0.hasNans() || !( gsd > 0.0 ) )
+   {
+      return false;
+   }
+
+   const ossim_uint32 layers = (ossim_uint32)std::ceil( ( maxHgt - minHgt ) / hgtStep ) + 1;
+   if ( layers > MAX_LAYERS )
+   {
+      return false;
+   }
+
+   m_imageRect = imageRect;
+   m_minHgt    = minHgt;
+   m_hgtStep   = hgtStep;
+   m_datum     = g0.datum();
+
+   const double longSide = std::max( width, height );
+   for ( ossim_uint32 cells = START_CELLS; cells <= MAX_CELLS; cells *= 2 )
+   {
+      m_cols = (ossim_uint32)std::ceil( cells * width  / longSide ) + 1;
+      m_rows = (ossim_uint32)std::ceil( cells * height / longSide ) + 1;
+      m_spacing.x = width  / ( m_cols - 1 );
+      m_spacing.y = height / ( m_rows - 1 );
+      m_layers.assign( layers, Layer() );
+
+      forEach( proj, layers,
+               [this](const ossimProjection* p, ossim_uint32 k) { sampleLayer( p, k ); } );
+
+      bool sampled = true;
+      for ( ossim_uint32 k = 0; k < layers; ++k )
+      {
+         sampled = sampled && m_layers[k].x.size();
+      }
+      if ( !sampled )
+      {
+         break; // Nothing projected, or the footprint crosses the date line.
+      }
+
+      // Check at every layer and halfway between:
+      std::vector<double> errors( 2 * layers - 1, 0.0 );
+      forEach( proj, (ossim_uint32)errors.size(),
+               [this, &errors, maxError](const ossimProjection* p, ossim_uint32 j)
+      {
+         const ossim_uint32 k = std::min( j / 2, (ossim_uint32)m_layers.size() - 2 );
+         errors[j] = checkHeight( p, m_minHgt + 0.5 * j * m_hgtStep, k, maxError );
+      } );
+
+      m_maxError = *std::max_element( errors.begin(), errors.end() );
+      if ( m_maxError <= maxError )
+      {
+         return true;
+      }
+   }
+
+   clear();
+   return false;
+}
+
+void ossimProjectionGrid::sampleLayer(const ossimProjection* proj, ossim_uint32 k)
+{
+   Layer& layer = m_layers[k];
+   const double hgt = m_minHgt + k * m_hgtStep;
+   const std::size_t nodes = (std::size_t)m_cols * m_rows;
+
+   // Forward nodes, and the ground rectangle they span:
+   layer.lat.resize( nodes );
+   layer.lon.resize( nodes );
+   double minLat = 90.0, maxLat = -90.0, minLon = 180.0, maxLon = -180.0;
+   ossimGpt gpt;
+   for ( ossim_uint32 r = 0; r < m_rows; ++r )
+   {
+      for ( ossim_uint32 c = 0; c < m_cols; ++c )
+      {
+         const ossimDpt ipt( m_imageRect.ul().x + c * m_spacing.x,
+                             m_imageRect.ul().y + r * m_spacing.y );
+         proj->lineSampleHeightToWorld( ipt, hgt, gpt );
+         if ( m_datum && gpt.datum() && ( gpt.datum() != m_datum ) )
+         {
+            gpt.changeDatum( m_datum );
+         }
+
+         const std::size_t i = (std::size_t)r * m_cols + c;
+         layer.lat[i] = gpt.lat;
+         layer.lon[i] = gpt.lon;
+         if ( !gpt.isLatNan() && !gpt.isLonNan() )
+         {
+            minLat = std::min( minLat, gpt.lat );
+            maxLat = std::max( maxLat, gpt.lat );
+            minLon = std::min( minLon, gpt.lon );
+            maxLon = std::max( maxLon, gpt.lon );
+         }
+      }
+   }
+
+   // Leave the inverse grid empty to fail the build if there is no footprint or it wraps:
+   if ( !( maxLat > minLat ) || !( maxLon > minLon ) || ( maxLon - minLon > 180.0 ) )
+   {
+      return;
+   }
+
+   layer.groundOrigin  = ossimDpt( minLon, minLat );
+   layer.groundSpacing = ossimDpt( ( maxLon - minLon ) / ( m_cols - 1 ),
+                                   ( maxLat - minLat ) / ( m_rows - 1 ) );
+   std::vector<ossim_float64> x( nodes );
+   std::vector<ossim_float64> y( nodes );
+   ossimDpt ipt;
+   for ( ossim_uint32 r = 0; r < m_rows; ++r )
+   {
+      for ( ossim_uint32 c = 0; c < m_cols; ++c )
+      {
+         gpt = ossimGpt( minLat + r * layer.groundSpacing.y, minLon + c * layer.groundSpacing.x,
+                         hgt, m_datum );
+         proj->worldToLineSample( gpt, ipt );
+         const std::size_t i = (std::size_t)r * m_cols + c;
+         x[i] = ipt.x;
+         y[i] = ipt.y;
+      }
+   }
+   layer.x.swap( x );
+   layer.y.swap( y );
+}
+
+double ossimProjectionGrid::checkHeight(const ossimProjection* proj, double hgt, ossim_uint32 k,
+                                        double maxError) const
+{
+   double worst = 0.0;
+   const ossim_uint32 cols = ( m_cols - 1 ) * CHECKS_PER_CELL + 1;
+   const ossim_uint32 rows = ( m_rows - 1 ) * CHECKS_PER_CELL + 1;
+
+   // Forward, on the edges and inside of each image cell.  The grid's answer is taken back to
+   // the image by the projection to measure the error in pixels:
+   ossimGpt approx;
+   ossimDpt back;
+   for ( ossim_uint32 r = 0; ( r < rows ) && ( worst <= maxError ); ++r )
+   {
+      for ( ossim_uint32 c = 0; ( c < cols ) && ( worst <= maxError ); ++c )
+      {
+         const ossimDpt ipt( m_imageRect.ul().x + c * m_spacing.x / CHECKS_PER_CELL,
+                             m_imageRect.ul().y + r * m_spacing.y / CHECKS_PER_CELL );
+         if ( lineSampleHeightToWorld( ipt, hgt, approx ) )
+         {
+            proj->worldToLineSample( approx, back );
+            if ( !back.hasNans() )
+            {
+               worst = std::max( worst, ( back - ipt ).length() );
+            }
+         }
+      }
+   }
+
+   // Inverse, the same way over the ground cells of the lower layer.  Points the projection
+   // puts outside the image never get an answer from the grid, so are not checked.
+   const Layer& layer = m_layers[k];
+   ossimDpt ipt, approxIpt;
+   for ( ossim_uint32 r = 0; ( r < rows ) && ( worst <= maxError ); ++r )
+   {
+      for ( ossim_uint32 c = 0; ( c < cols ) && ( worst <= maxError ); ++c )
+      {
+         const ossimGpt gpt( layer.groundOrigin.y + r * layer.groundSpacing.y / CHECKS_PER_CELL,
+                             layer.groundOrigin.x + c * layer.groundSpacing.x / CHECKS_PER_CELL,
+                             hgt, m_datum );
+         proj->worldToLineSample( gpt, ipt );
+         if ( !ipt.hasNans() && m_imageRect.pointWithin( ipt ) &&
+              worldToLineSample( gpt, approxIpt ) )
+         {
+            worst = std::max( worst, ( ipt - approxIpt ).length() );
+         }
+      }
+   }
+
+   return worst;
+}
+
+bool ossimProjectionGrid::findLayer(double hgt, ossim_uint32& k, double& t) const
+{
+   const double f = ( hgt - m_minHgt ) / m_hgtStep;
+   if ( ( m_layers.size() < 2 ) || !( f >= 0.0 ) || ( f > m_layers.size() - 1 ) )
+   {
+      return false;
+   }
+   k = std::min( (ossim_uint32)f, (ossim_uint32)m_layers.size() - 2 );
+   t = f - k;
+   return true;
+}
+
+bool ossimProjectionGrid::lineSampleHeightToWorld(const ossimDpt& ipt, double hgt,
+                                                  ossimGpt& gpt) const
+{
+   ossim_uint32 k;
+   std::size_t i;
+   double t, fu, fv;
+   if ( !findLayer( hgt, k, t ) ||
+        !locate( ( ipt.x - m_imageRect.ul().x ) / m_spacing.x,
+                 ( ipt.y - m_imageRect.ul().y ) / m_spacing.y, m_cols, m_rows, i, fu, fv ) )
+   {
+      return false;
+   }
+
+   const Layer& a = m_layers[k];
+   const Layer& b = m_layers[k + 1];
+   const double latA = bilinear( a.lat, i, m_cols, fu, fv );
+   const double lonA = bilinear( a.lon, i, m_cols, fu, fv );
+   const double latB = bilinear( b.lat, i, m_cols, fu, fv );
+   const double lonB = bilinear( b.lon, i, m_cols, fu, fv );
+   gpt = ossimGpt( latA + t * ( latB - latA ), lonA + t * ( lonB - lonA ), hgt, m_datum );
+
+   return !gpt.hasNans();
+}
+
+bool ossimProjectionGrid::worldToLineSample(const ossimGpt& world, ossimDpt& ipt) const
+{
+   ossimGpt gpt( world );
+   if ( m_datum && gpt.datum() && ( gpt.datum() != m_datum ) )
+   {
+      gpt.changeDatum( m_datum );
+   }
+
+   ossim_uint32 k;
+   double t;
+   if ( !findLayer( gpt.hgt, k, t ) )
+   {
+      return false;
+   }
+
+   double x[2], y[2];
+   for ( ossim_uint32 j = 0; j < 2; ++j )
+   {
+      const Layer& layer = m_layers[k + j];
+      std::size_t i;
+      double fu, fv;
+      if ( !locate( ( gpt.lon - layer.groundOrigin.x ) / layer.groundSpacing.x,
+                    ( gpt.lat - layer.groundOrigin.y ) / layer.groundSpacing.y,
+                    m_cols, m_rows, i, fu, fv ) )
+      {
+         return false;
+      }
+      x[j] = bilinear( layer.x, i, m_cols, fu, fv );
+      y[j] = bilinear( layer.y, i, m_cols, fu, fv );
+   }
+   ipt.x = x[0] + t * ( x[1] - x[0] );
+   ipt.y = y[0] + t * ( y[1] - y[0] );
+
+   return !ipt.hasNans() && m_imageRect.pointWithin( ipt );
+}
+
+bool ossimProjectionGrid::read(const ossimFilename& file, const std::string& key)
+{
+   clear();
+
+   std::ifstream in( file.c_str(), std::ios_base::in | std::ios_base::binary );
+   if ( !in.good() )
+   {
+      return false;
+   }
+
+   std::string fileKey;
+   if ( !ossim::readSidecarHeader( in, MAGIC, VERSION ) ||
+        !readString( in, fileKey, key.size() ) || ( fileKey != key ) )
+   {
+      return false;
+   }
+
+   std::string datumCode;
+   ossimDpt ul, lr;
+   ossim_uint32 layers = 0;
+   bool status = readValue( in, ul.x ) && readValue( in, ul.y ) &&
+                 readValue( in, lr.x ) && readValue( in, lr.y ) &&
+                 readValue( in, m_cols ) && readValue( in, m_rows ) &&
+                 readValue( in, m_minHgt ) && readValue( in, m_hgtStep ) &&
+                 readValue( in, m_maxError ) && readValue( in, layers ) &&
+                 readString( in, datumCode, 64 ) &&
+                 ( m_cols >= 2 ) && ( m_cols <= MAX_CELLS + 1 ) &&
+                 ( m_rows >= 2 ) && ( m_rows <= MAX_CELLS + 1 ) &&
+                 ( layers >= 2 ) && ( layers <= MAX_LAYERS ) && ( m_hgtStep > 0.0 ) &&
+                 ( lr.x > ul.x ) && ( lr.y > ul.y );
+
+   const std::size_t nodes = (std::size_t)m_cols * m_rows;
+   if ( status )
+   {
+      m_imageRect = ossimDrect( ul, lr );
+      m_spacing   = ossimDpt( ( lr.x - ul.x ) / ( m_cols - 1 ), ( lr.y - ul.y ) / ( m_rows - 1 ) );
+      m_datum     = datumCode.size() ?
+         ossimDatumFactoryRegistry::instance()->create( ossimString( datumCode ) ) : 0;
+      m_layers.resize( layers );
+   }
+   for ( ossim_uint32 k = 0; status && ( k < layers ); ++k )
+   {
+      Layer& layer = m_layers[k];
+      status = readValue( in, layer.groundOrigin.x ) && readValue( in, layer.groundOrigin.y ) &&
+               readValue( in, layer.groundSpacing.x ) && readValue( in, layer.groundSpacing.y ) &&
+               readArray( in, layer.lat, nodes ) && readArray( in, layer.lon, nodes ) &&
+               readArray( in, layer.x, nodes ) && readArray( in, layer.y, nodes );
+   }
+
+   if ( !status )
+   {
+      clear();
+   }
+   return status;
+}
+
+bool ossimProjectionGrid::write(const ossimFilename& file, const std::string& key) const
+{
+   if ( !valid() )
+   {
+      return false;
+   }
+
+   // Of two processes writing the same grid the last one wins whole:
+   const ossimFilename tmp = ossim::getSidecarTempFile( file );
+   std::ofstream out( tmp.c_str(), std::ios_base::out | std::ios_base::binary );
+   if ( !out.good() )
+   {
+      return false;
+   }
+
+   ossim::writeSidecarHeader( out, MAGIC, VERSION );
+   writeString( out, key );
+   writeValue( out, m_imageRect.ul().x );
+   writeValue( out, m_imageRect.ul().y );
+   writeValue( out, m_imageRect.lr().x );
+   writeValue( out, m_imageRect.lr().y );
+   writeValue( out, m_cols );
+   writeValue( out, m_rows );
+   writeValue( out, m_minHgt );
+   writeValue( out, m_hgtStep );
+   writeValue( out, m_maxError );
+   writeValue( out, (ossim_uint32)m_layers.size() );
+   writeString( out, m_datum ? std::string( m_datum->code().c_str() ) : std::string() );
+   for ( ossim_uint32 k = 0; k < m_layers.size(); ++k )
+   {
+      const Layer& layer = m_layers[k];
+      writeValue( out, layer.groundOrigin.x );
+      writeValue( out, layer.groundOrigin.y );
+      writeValue( out, layer.groundSpacing.x );
+      writeValue( out, layer.groundSpacing.y );
+      writeArray( out, layer.lat );
+      writeArray( out, layer.lon );
+      writeArray( out, layer.x );
+      writeArray( out, layer.y );
+   }
+   out.close();
+
+   if ( out.fail() )
+   {
+      tmp.remove();
+      return false;
+   }
+   return ossim::replaceFile( tmp, file );
+}
+
+std::string ossimProjectionGrid::hashKey(const std::string& key)
+{
+   ossim_uint64 hash = 14695981039346656037ULL;
+   for ( std::size_t i = 0; i < key.size(); ++i )
+   {
+      hash ^= (unsigned char)key[i];
+      hash *= 1099511628211ULL;
+   }
+
+   char buf[17];
+   snprintf( buf, sizeof(buf), "%016llx", (unsigned long long)hash );
+   return std::string( buf );
+}
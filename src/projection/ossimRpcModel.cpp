@@ -25,6 +25,7 @@ RTTI_DEF1(ossimRpcModel, "ossimRpcModel", ossimSensorModel);
 #include <ossim/base/ossimDpt.h>
 #include <ossim/base/ossimDatum.h>
 #include <ossim/base/ossimEllipsoid.h>
+#include <ossim/base/ossimEcefRay.h>
 #include <ossim/base/ossimException.h>
 #include <ossim/base/ossimKeywordlist.h>
 #include <ossim/base/ossimKeywordNames.h>
@@ -33,9 +34,15 @@ RTTI_DEF1(ossimRpcModel, "ossimRpcModel", ossimSensorModel);
 #include <algorithm>
 #include <iomanip>
 #include <sstream>
+#include <vector>
 #include <ossim/projection/ossimProjectionFactoryRegistry.h>
 #include <json/json.h>
 
+#if defined(__x86_64__) || defined(_M_X64)
+#  define OSSIM_RPC_MODEL_X86 1
+#  include <emmintrin.h>
+#endif
+
 //***
 // Define Trace flags for use within this file:
 //***
@@ -80,7 +87,59 @@ static const ossimString PARAM_UNITS[] ={"pixel",
                                         "scale",
                                         "degrees",
                                         "degrees"};
-      
+
+//---
+// Monomials are computed in RPC00A order. Entry i of B_TERMS is the RPC00A
+// index of RPC00B term i.
+//---
+static const int B_TERMS[NUM_COEFFS] =
+   { 0, 1, 2, 3, 4, 5, 6, 8, 9, 10, 7, 11, 14, 17, 12, 15, 18, 13, 16, 19 };
+
+// Points normalized per pass of the batch evaluators:
+static const ossim_uint32 BATCH_CHUNK_SIZE = 64;
+
+//---
+// The twenty monomials of normalized lat P, lon L and height H, and their
+// partials, in RPC00A order.
+//---
+static inline void monomials(double P, double L, double H, double* t)
+{
+   const double LL = L*L;
+   const double PP = P*P;
+   const double HH = H*H;
+   t[ 0] = 1.0;    t[ 1] = L;      t[ 2] = P;      t[ 3] = H;
+   t[ 4] = L*P;    t[ 5] = L*H;    t[ 6] = P*H;    t[ 7] = L*P*H;
+   t[ 8] = LL;     t[ 9] = PP;     t[10] = HH;     t[11] = LL*L;
+   t[12] = LL*P;   t[13] = LL*H;   t[14] = L*PP;   t[15] = PP*P;
+   t[16] = PP*H;   t[17] = L*HH;   t[18] = P*HH;   t[19] = HH*H;
+}
+
+static inline void monomialPartials(double P, double L, double H,
+                                    double* dP, double* dL, double* dH)
+{
+   for (int i = 0; i < NUM_COEFFS; ++i)
+   {
+      dP[i] = 0.0;
+      dL[i] = 0.0;
+   }
+   dP[ 2] = 1.0;      dP[ 4] = L;        dP[ 6] = H;        dP[ 7] = L*H;
+   dP[ 9] = 2.0*P;    dP[12] = L*L;      dP[14] = 2.0*L*P;  dP[15] = 3.0*P*P;
+   dP[16] = 2.0*P*H;  dP[18] = H*H;
+
+   dL[ 1] = 1.0;      dL[ 4] = P;        dL[ 5] = H;        dL[ 7] = P*H;
+   dL[ 8] = 2.0*L;    dL[11] = 3.0*L*L;  dL[12] = 2.0*L*P;  dL[13] = 2.0*L*H;
+   dL[14] = P*P;      dL[17] = H*H;
+
+   if (dH)
+   {
+      for (int i = 0; i < NUM_COEFFS; ++i)
+         dH[i] = 0.0;
+      dH[ 3] = 1.0;      dH[ 5] = L;        dH[ 6] = P;        dH[ 7] = L*P;
+      dH[10] = 2.0*H;    dH[13] = L*L;      dH[16] = P*P;      dH[17] = 2.0*L*H;
+      dH[18] = 2.0*P*H;  dH[19] = 3.0*H*H;
+   }
+}
+
 //*****************************************************************************
 //  DEFAULT CONSTRUCTOR: ossimRpcModel()
 //  
@@ -312,10 +371,12 @@ void ossimRpcModel::worldToLineSample(const ossimGpt& ground_point,
    //***
    // Compute the adjusted, normalized line (U) and sample (V):
    //***
-   double Pu = polynomial(nlat, nlon, nhgt, theLineNumCoef);
-   double Qu = polynomial(nlat, nlon, nhgt, theLineDenCoef);
-   double Pv = polynomial(nlat, nlon, nhgt, theSampNumCoef);
-   double Qv = polynomial(nlat, nlon, nhgt, theSampDenCoef);
+   double m[NUM_COEFFS];
+   basis(nlat, nlon, nhgt, m);
+   double Pu = dot(theLineNumCoef, m);
+   double Qu = dot(theLineDenCoef, m);
+   double Pv = dot(theSampNumCoef, m);
+   double Qv = dot(theSampDenCoef, m);
    double U_rot  = Pu / Qu;
    double V_rot  = Pv / Qv;
 
@@ -337,6 +398,97 @@ void ossimRpcModel::worldToLineSample(const ossimGpt& ground_point,
    return;
 }
 
+void ossimRpcModel::worldToLineSample(const ossimGpt* ground_points,
+                                      ossimDpt*       img_pts,
+                                      ossim_uint32    count) const
+{
+   // Split the points into coordinate arrays a chunk at a time:
+   double lat[BATCH_CHUNK_SIZE];
+   double lon[BATCH_CHUNK_SIZE];
+   double hgt[BATCH_CHUNK_SIZE];
+   double line[BATCH_CHUNK_SIZE];
+   double samp[BATCH_CHUNK_SIZE];
+   for ( ossim_uint32 start = 0; start < count; start += BATCH_CHUNK_SIZE )
+   {
+      const ossim_uint32 n = std::min( count - start, BATCH_CHUNK_SIZE );
+      for ( ossim_uint32 i = 0; i < n; ++i )
+      {
+         lat[i] = ground_points[start + i].lat;
+         lon[i] = ground_points[start + i].lon;
+         hgt[i] = ground_points[start + i].hgt;
+      }
+
+      // Qualified so a derived model adjusts the points only once:
+      ossimRpcModel::worldToLineSample( lat, lon, hgt, line, samp, n );
+
+      for ( ossim_uint32 i = 0; i < n; ++i )
+      {
+         img_pts[start + i].line = line[i];
+         img_pts[start + i].samp = samp[i];
+      }
+   }
+}
+
+void ossimRpcModel::worldToLineSample(const double* lat,
+                                      const double* lon,
+                                      const double* hgt,
+                                      double*       line,
+                                      double*       samp,
+                                      ossim_uint32  count) const
+{
+   const double nullHgt      = ( - theHgtOffset) / theHgtScale;
+   const double lineScale    = theLineScale + theIntrackScale;
+   const double sampScale    = theSampScale + theCrtrackScale;
+   const bool   wrapWest     = ( theLonOffset < -160.0 );
+   const bool   wrapEast     = ( theLonOffset > 160.0 );
+
+   double nlat[BATCH_CHUNK_SIZE];
+   double nlon[BATCH_CHUNK_SIZE];
+   double nhgt[BATCH_CHUNK_SIZE];
+   double U_rot[BATCH_CHUNK_SIZE];
+   double V_rot[BATCH_CHUNK_SIZE];
+   for ( ossim_uint32 start = 0; start < count; start += BATCH_CHUNK_SIZE )
+   {
+      const ossim_uint32 n = std::min( count - start, BATCH_CHUNK_SIZE );
+
+      // Normalize, with the same dateline test as the single point method:
+      for ( ossim_uint32 i = 0; i < n; ++i )
+      {
+         double lonPt = lon[start + i];
+         if ( wrapWest && ( lonPt > 160.0 ) )
+         {
+            lonPt -= 360.0;
+         }
+         else if ( wrapEast && ( lonPt < -160.0 ) )
+         {
+            lonPt += 360.0;
+         }
+         nlat[i] = (lat[start + i] - theLatOffset) / theLatScale;
+         nlon[i] = (lonPt - theLonOffset) / theLonScale;
+         nhgt[i] = ( !hgt || ossim::isnan(hgt[start + i]) ) ? nullHgt :
+            (hgt[start + i] - theHgtOffset) / theHgtScale;
+      }
+
+      evaluate( nlat, nlon, nhgt, U_rot, V_rot, n );
+
+      for ( ossim_uint32 i = 0; i < n; ++i )
+      {
+         if ( ossim::isnan(lat[start + i]) || ossim::isnan(lon[start + i]) )
+         {
+            line[start + i] = ossim::nan();
+            samp[start + i] = ossim::nan();
+            continue;
+         }
+
+         double U = U_rot[i]*theCosMapRot + V_rot[i]*theSinMapRot;
+         double V = V_rot[i]*theCosMapRot - U_rot[i]*theSinMapRot;
+
+         line[start + i] = U*lineScale + theLineOffset + theIntrackOffset;
+         samp[start + i] = V*sampScale + theSampOffset + theCrtrackOffset;
+      }
+   }
+}
+
 //*****************************************************************************
 //  METHOD: ossimRpcModel::lineSampleToWorld()
 //  
@@ -375,6 +527,29 @@ void  ossimRpcModel::lineSampleToWorld(const ossimDpt& imagePoint,
 #endif
 }
 
+void ossimRpcModel::lineSampleToWorld(const ossimDpt* imagePoints,
+                                     ossimGpt*       worldPoints,
+                                     ossim_uint32    count) const
+{
+   std::vector<ossimEcefRay> rays(count);
+   for (ossim_uint32 i = 0; i < count; ++i)
+   {
+      // A ray of nans comes back from intersectRays as a nan point.
+      if (!imagePoints[i].hasNans())
+      {
+         imagingRay(imagePoints[i], rays[i]);
+      }
+      else
+      {
+         rays[i].makeNan();
+      }
+   }
+   if (count)
+   {
+      ossimElevManager::instance()->intersectRays(&rays.front(), worldPoints, count);
+   }
+}
+
 //*****************************************************************************
 //  METHOD: ossimRpcModel::imagingRay()
 //  
@@ -539,6 +714,7 @@ void ossimRpcModel::lineSampleHeightToWorld(const ossimDpt& image_point,
    // * residuals of normalized image point: deltaU, deltaV,
    // * partial derivatives of Uc and Vc wrt X, Y,
    // * corrections to normalized lat, lon: deltaLat, deltaLon.
+   double m[NUM_COEFFS], mLat[NUM_COEFFS], mLon[NUM_COEFFS];
    double Pu, Qu, Pv, Qv;
    double dPu_dLat, dQu_dLat, dPv_dLat, dQv_dLat;
    double dPu_dLon, dQu_dLon, dPv_dLon, dQv_dLon;
@@ -552,11 +728,12 @@ void ossimRpcModel::lineSampleHeightToWorld(const ossimDpt& image_point,
    do
    {
       // Calculate the normalized line and sample Uc, Vc as ratio of
-      // polynomials Pu, Qu and Pv, Qv:
-      Pu = polynomial(nlat, nlon, nhgt, theLineNumCoef);
-      Qu = polynomial(nlat, nlon, nhgt, theLineDenCoef);
-      Pv = polynomial(nlat, nlon, nhgt, theSampNumCoef);
-      Qv = polynomial(nlat, nlon, nhgt, theSampDenCoef);
+      // polynomials Pu, Qu and Pv, Qv, all from one basis:
+      basis(nlat, nlon, nhgt, m);
+      Pu = dot(theLineNumCoef, m);
+      Qu = dot(theLineDenCoef, m);
+      Pv = dot(theSampNumCoef, m);
+      Qv = dot(theSampDenCoef, m);
       if (ossim::isnan(Pu) || ossim::isnan(Pv) || (Qu == 0.0) || (Qv == 0.0))
       {
          gpt.makeNan();
@@ -573,14 +750,15 @@ void ossimRpcModel::lineSampleHeightToWorld(const ossimDpt& image_point,
       if ((fabs(deltaU) > epsilonU) || (fabs(deltaV) > epsilonV))
       {
          // Analytically compute the partials of each polynomial wrt lat, lon:
-         dPu_dLat = dPoly_dLat(nlat, nlon, nhgt, theLineNumCoef);
-         dQu_dLat = dPoly_dLat(nlat, nlon, nhgt, theLineDenCoef);
-         dPv_dLat = dPoly_dLat(nlat, nlon, nhgt, theSampNumCoef);
-         dQv_dLat = dPoly_dLat(nlat, nlon, nhgt, theSampDenCoef);
-         dPu_dLon = dPoly_dLon(nlat, nlon, nhgt, theLineNumCoef);
-         dQu_dLon = dPoly_dLon(nlat, nlon, nhgt, theLineDenCoef);
-         dPv_dLon = dPoly_dLon(nlat, nlon, nhgt, theSampNumCoef);
-         dQv_dLon = dPoly_dLon(nlat, nlon, nhgt, theSampDenCoef);
+         basisPartials(nlat, nlon, nhgt, mLat, mLon, 0);
+         dPu_dLat = dot(theLineNumCoef, mLat);
+         dQu_dLat = dot(theLineDenCoef, mLat);
+         dPv_dLat = dot(theSampNumCoef, mLat);
+         dQv_dLat = dot(theSampDenCoef, mLat);
+         dPu_dLon = dot(theLineNumCoef, mLon);
+         dQu_dLon = dot(theLineDenCoef, mLon);
+         dPv_dLon = dot(theSampNumCoef, mLon);
+         dQv_dLon = dot(theSampDenCoef, mLon);
          
          // Analytically compute partials of quotients U and V wrt lat, lon:
          dU_dLat = (Qu*dPu_dLat - Pu*dQu_dLat)/(Qu*Qu);
@@ -640,26 +818,9 @@ void ossimRpcModel::lineSampleHeightToWorld(const ossimDpt& image_point,
 double ossimRpcModel::polynomial(const double& P, const double& L,
                                  const double& H, const double* c) const
 {
-   double r;
-
-   if (thePolyType == A)
-   {
-      r = c[ 0]       + c[ 1]*L     + c[ 2]*P     + c[ 3]*H     +
-          c[ 4]*L*P   + c[ 5]*L*H   + c[ 6]*P*H   + c[ 7]*L*P*H +
-          c[ 8]*L*L   + c[ 9]*P*P   + c[10]*H*H   + c[11]*L*L*L +
-          c[12]*L*L*P + c[13]*L*L*H + c[14]*L*P*P + c[15]*P*P*P +
-          c[16]*P*P*H + c[17]*L*H*H + c[18]*P*H*H + c[19]*H*H*H;
-   }
-   else
-   {
-      r = c[ 0]       + c[ 1]*L     + c[ 2]*P     + c[ 3]*H     +
-          c[ 4]*L*P   + c[ 5]*L*H   + c[ 6]*P*H   + c[ 7]*L*L   +
-          c[ 8]*P*P   + c[ 9]*H*H   + c[10]*L*P*H + c[11]*L*L*L +
-          c[12]*L*P*P + c[13]*L*H*H + c[14]*L*L*P + c[15]*P*P*P +
-          c[16]*P*H*H + c[17]*L*L*H + c[18]*P*P*H + c[19]*H*H*H;
-   }
-   
-   return r;
+   double m[NUM_COEFFS];
+   basis(P, L, H, m);
+   return dot(c, m);
 }
 
 //*****************************************************************************
@@ -671,68 +832,178 @@ double ossimRpcModel::polynomial(const double& P, const double& L,
 double ossimRpcModel::dPoly_dLat(const double& P, const double& L,
                                  const double& H, const double* c) const
 {
-   double dr;
+   double dLat[NUM_COEFFS], dLon[NUM_COEFFS];
+   basisPartials(P, L, H, dLat, dLon, 0);
+   return dot(c, dLat);
+}
+
+//*****************************************************************************
+// PRIVATE METHOD: ossimRpcModel::dPoly_dLon
+//  
+//  Computes derivative of polynomial wrt normalized Longitude L.
+//  
+//*****************************************************************************
+double ossimRpcModel::dPoly_dLon(const double& P, const double& L,
+                                 const double& H, const double* c) const
+{
+   double dLat[NUM_COEFFS], dLon[NUM_COEFFS];
+   basisPartials(P, L, H, dLat, dLon, 0);
+   return dot(c, dLon);
+}
+
+//*****************************************************************************
+// PRIVATE METHOD: ossimRpcModel::dPoly_dHgt
+//  
+//  Computes derivative of polynomial wrt normalized Height H.
+//  
+//*****************************************************************************
+double ossimRpcModel::dPoly_dHgt(const double& P, const double& L,
+                                 const double& H, const double* c) const
+{
+   double dLat[NUM_COEFFS], dLon[NUM_COEFFS], dHgt[NUM_COEFFS];
+   basisPartials(P, L, H, dLat, dLon, dHgt);
+   return dot(c, dHgt);
+}
 
+//*****************************************************************************
+// PRIVATE METHOD: ossimRpcModel::basis
+//  
+//  Computes the monomials of (P, L, H) in the coefficient order of
+//  thePolyType.
+//  
+//*****************************************************************************
+void ossimRpcModel::basis(const double& P, const double& L,
+                          const double& H, double* m) const
+{
    if (thePolyType == A)
    {
-      dr = c[2] + c[4]*L + c[6]*H + c[7]*L*H + 2*c[9]*P + c[12]*L*L +
-           2*c[14]*L*P + 3*c[15]*P*P +2*c[16]*P*H + c[18]*H*H;
+      monomials(P, L, H, m);
    }
    else
    {
-      dr = c[2] + c[4]*L + c[6]*H + 2*c[8]*P + c[10]*L*H + 2*c[12]*L*P +
-           c[14]*L*L + 3*c[15]*P*P + c[16]*H*H + 2*c[18]*P*H;
+      double t[NUM_COEFFS];
+      monomials(P, L, H, t);
+      for (int i = 0; i < NUM_COEFFS; ++i)
+         m[i] = t[B_TERMS[i]];
    }
-   
-   return dr;
 }
 
 //*****************************************************************************
-// PRIVATE METHOD: ossimRpcModel::dPoly_dLon
+// PRIVATE METHOD: ossimRpcModel::basisPartials
 //  
-//  Computes derivative of polynomial wrt normalized Longitude L.
+//  Computes the partials of the monomials wrt P, L and H in the coefficient
+//  order of thePolyType.
 //  
 //*****************************************************************************
-double ossimRpcModel::dPoly_dLon(const double& P, const double& L,
-                                 const double& H, const double* c) const
+void ossimRpcModel::basisPartials(const double& P, const double& L,
+                                  const double& H, double* dLat,
+                                  double* dLon, double* dHgt) const
 {
-   double dr;
-
    if (thePolyType == A)
    {
-      dr = c[1] + c[4]*P + c[5]*H + c[7]*P*H + 2*c[8]*L + 3*c[11]*L*L +
-           2*c[12]*L*P + 2*c[13]*L*H + c[14]*P*P + c[17]*H*H;
+      monomialPartials(P, L, H, dLat, dLon, dHgt);
    }
    else
    {
-      dr = c[1] + c[4]*P + c[5]*H + 2*c[7]*L + c[10]*P*H + 3*c[11]*L*L +
-           c[12]*P*P + c[13]*H*H + 2*c[14]*P*L + 2*c[17]*L*H;
+      double tLat[NUM_COEFFS], tLon[NUM_COEFFS], tHgt[NUM_COEFFS];
+      monomialPartials(P, L, H, tLat, tLon, dHgt ? tHgt : 0);
+      for (int i = 0; i < NUM_COEFFS; ++i)
+      {
+         dLat[i] = tLat[B_TERMS[i]];
+         dLon[i] = tLon[B_TERMS[i]];
+         if (dHgt)
+            dHgt[i] = tHgt[B_TERMS[i]];
+      }
    }
-   return dr;
+}
+
+double ossimRpcModel::dot(const double* c, const double* m)
+{
+   double r = c[0]*m[0];
+   for (int i = 1; i < NUM_COEFFS; ++i)
+      r += c[i]*m[i];
+   return r;
 }
 
 //*****************************************************************************
-// PRIVATE METHOD: ossimRpcModel::dPoly_dHgt
+// PRIVATE METHOD: ossimRpcModel::evaluate
 //  
-//  Computes derivative of polynomial wrt normalized Height H.
+//  Computes the four polynomials for arrays of normalized ground points. On
+//  x86-64 two points go through at a time with SSE2. The terms are summed in
+//  coefficient order, as dot() does, so every path gives the same result.
 //  
 //*****************************************************************************
-double ossimRpcModel::dPoly_dHgt(const double& P, const double& L,
-                                 const double& H, const double* c) const
+void ossimRpcModel::evaluate(const double* nlat, const double* nlon,
+                             const double* nhgt, double* U, double* V,
+                             ossim_uint32 count) const
 {
-   double dr;
+   ossim_uint32 i = 0;
 
-   if (thePolyType == A)
+#if defined(OSSIM_RPC_MODEL_X86)
+   static const int A_TERMS[NUM_COEFFS] =
+      { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19 };
+   const int* order = (thePolyType == A) ? A_TERMS : B_TERMS;
+
+   const double* coeffs[4] =
+      { theLineNumCoef, theLineDenCoef, theSampNumCoef, theSampDenCoef };
+   __m128d c[4][NUM_COEFFS];
+   for (int p = 0; p < 4; ++p)
    {
-      dr = c[3] + c[5]*L + c[6]*P + c[7]*L*P + 2*c[10]*H + c[13]*L*L +
-           c[16]*P*P + 2*c[17]*L*H + 2*c[18]*P*H + 3*c[19]*H*H;
+      for (int k = 0; k < NUM_COEFFS; ++k)
+         c[p][k] = _mm_set1_pd(coeffs[p][k]);
    }
-   else
+
+   for ( ; i + 2 <= count; i += 2)
+   {
+      const __m128d P  = _mm_loadu_pd(nlat + i);
+      const __m128d L  = _mm_loadu_pd(nlon + i);
+      const __m128d H  = _mm_loadu_pd(nhgt + i);
+      const __m128d LL = _mm_mul_pd(L, L);
+      const __m128d PP = _mm_mul_pd(P, P);
+      const __m128d HH = _mm_mul_pd(H, H);
+
+      // Same terms, computed the same way, as monomials():
+      __m128d t[NUM_COEFFS];
+      t[ 0] = _mm_set1_pd(1.0);
+      t[ 1] = L;
+      t[ 2] = P;
+      t[ 3] = H;
+      t[ 4] = _mm_mul_pd(L, P);
+      t[ 5] = _mm_mul_pd(L, H);
+      t[ 6] = _mm_mul_pd(P, H);
+      t[ 7] = _mm_mul_pd(t[4], H);
+      t[ 8] = LL;
+      t[ 9] = PP;
+      t[10] = HH;
+      t[11] = _mm_mul_pd(LL, L);
+      t[12] = _mm_mul_pd(LL, P);
+      t[13] = _mm_mul_pd(LL, H);
+      t[14] = _mm_mul_pd(L, PP);
+      t[15] = _mm_mul_pd(PP, P);
+      t[16] = _mm_mul_pd(PP, H);
+      t[17] = _mm_mul_pd(L, HH);
+      t[18] = _mm_mul_pd(P, HH);
+      t[19] = _mm_mul_pd(HH, H);
+
+      __m128d r[4];
+      for (int p = 0; p < 4; ++p)
+      {
+         r[p] = _mm_mul_pd(c[p][0], t[order[0]]);
+         for (int k = 1; k < NUM_COEFFS; ++k)
+            r[p] = _mm_add_pd(r[p], _mm_mul_pd(c[p][k], t[order[k]]));
+      }
+      _mm_storeu_pd(U + i, _mm_div_pd(r[0], r[1]));
+      _mm_storeu_pd(V + i, _mm_div_pd(r[2], r[3]));
+   }
+#endif
+
+   double m[NUM_COEFFS];
+   for ( ; i < count; ++i)
    {
-      dr = c[3] + c[5]*L + c[6]*P + 2*c[9]*H + c[10]*L*P + 2*c[13]*L*H +
-           2*c[16]*P*H + c[17]*L*L + c[18]*P*P + 3*c[19]*H*H;
+      basis(nlat[i], nlon[i], nhgt[i], m);
+      U[i] = dot(theLineNumCoef, m) / dot(theLineDenCoef, m);
+      V[i] = dot(theSampNumCoef, m) / dot(theSampDenCoef, m);
    }
-   return dr;
 }
 
 void ossimRpcModel::updateModel()
@@ -1320,10 +1591,12 @@ ossimDpt ossimRpcModel::getForwardDeriv(int derivMode,
          //***
          // Compute the normalized line (Un) and sample (Vn):
          //***
-         double Pu = polynomial(nlat, nlon, nhgt, theLineNumCoef);
-         double Qu = polynomial(nlat, nlon, nhgt, theLineDenCoef);
-         double Pv = polynomial(nlat, nlon, nhgt, theSampNumCoef);
-         double Qv = polynomial(nlat, nlon, nhgt, theSampDenCoef);
+         double m[NUM_COEFFS];
+         basis(nlat, nlon, nhgt, m);
+         double Pu = dot(theLineNumCoef, m);
+         double Qu = dot(theLineDenCoef, m);
+         double Pv = dot(theSampNumCoef, m);
+         double Qv = dot(theSampDenCoef, m);
          double Un  = Pu / Qu;
          double Vn  = Pv / Qv;
          
@@ -1339,18 +1612,20 @@ ossimDpt ossimRpcModel::getForwardDeriv(int derivMode,
          double dPu_dLat, dQu_dLat, dPv_dLat, dQv_dLat;
          double dPu_dLon, dQu_dLon, dPv_dLon, dQv_dLon;
          double dPu_dHgt, dQu_dHgt, dPv_dHgt, dQv_dHgt;
-         dPu_dLat = dPoly_dLat(nlat, nlon, nhgt, theLineNumCoef);
-         dQu_dLat = dPoly_dLat(nlat, nlon, nhgt, theLineDenCoef);
-         dPv_dLat = dPoly_dLat(nlat, nlon, nhgt, theSampNumCoef);
-         dQv_dLat = dPoly_dLat(nlat, nlon, nhgt, theSampDenCoef);
-         dPu_dLon = dPoly_dLon(nlat, nlon, nhgt, theLineNumCoef);
-         dQu_dLon = dPoly_dLon(nlat, nlon, nhgt, theLineDenCoef);
-         dPv_dLon = dPoly_dLon(nlat, nlon, nhgt, theSampNumCoef);
-         dQv_dLon = dPoly_dLon(nlat, nlon, nhgt, theSampDenCoef);
-         dPu_dHgt = dPoly_dHgt(nlat, nlon, nhgt, theLineNumCoef);
-         dQu_dHgt = dPoly_dHgt(nlat, nlon, nhgt, theLineDenCoef);
-         dPv_dHgt = dPoly_dHgt(nlat, nlon, nhgt, theSampNumCoef);
-         dQv_dHgt = dPoly_dHgt(nlat, nlon, nhgt, theSampDenCoef);
+         double mLat[NUM_COEFFS], mLon[NUM_COEFFS], mHgt[NUM_COEFFS];
+         basisPartials(nlat, nlon, nhgt, mLat, mLon, mHgt);
+         dPu_dLat = dot(theLineNumCoef, mLat);
+         dQu_dLat = dot(theLineDenCoef, mLat);
+         dPv_dLat = dot(theSampNumCoef, mLat);
+         dQv_dLat = dot(theSampDenCoef, mLat);
+         dPu_dLon = dot(theLineNumCoef, mLon);
+         dQu_dLon = dot(theLineDenCoef, mLon);
+         dPv_dLon = dot(theSampNumCoef, mLon);
+         dQv_dLon = dot(theSampDenCoef, mLon);
+         dPu_dHgt = dot(theLineNumCoef, mHgt);
+         dQu_dHgt = dot(theLineDenCoef, mHgt);
+         dPv_dHgt = dot(theSampNumCoef, mHgt);
+         dQv_dHgt = dot(theSampDenCoef, mHgt);
          
          //***
          // Compute partials of quotients U and V wrt lat, lon, hgt 
@@ -273,11 +273,15 @@ void ossimRpcSolver::solveCoefficients(const std::vector<ossimDpt>& imagePoints,
    ossim_uint32 idx = 0;
 
    theMaxResidual = 0;
+   std::vector<ossimDpt> evalPts (imagePoints.size());
+   if (imagePoints.size())
+   {
+      theRpcModel->worldToLineSample(&groundControlPoints.front(), &evalPts.front(),
+                                     (ossim_uint32) imagePoints.size());
+   }
    for (idx = 0; idx<imagePoints.size(); idx++)
    {
-      ossimDpt evalPt;
-      evalPoint(groundControlPoints[idx], evalPt);
-      ossim_float64 len = (evalPt - imagePoints[idx]).length();
+      ossim_float64 len = (evalPts[idx] - imagePoints[idx]).length();
       if (len > theMaxResidual)
          theMaxResidual = len;
       sumSquareError += (len*len);
@@ -300,8 +304,10 @@ bool ossimRpcSolver::solve(const ossimDrect& imageBounds,
    ossimDpt ul = imageBounds.ul();
    ossim_float64 w = imageBounds.width();
    ossim_float64 h = imageBounds.height();
-   ossimDpt ipt, irpc;
+   ossimDpt ipt;
    ossimGpt gpt;
+   std::vector<ossimDpt> ipts, irpcs;
+   std::vector<ossimGpt> gpts;
 
    // Start at the minimum grid size:
    ossim_uint32 xSamples = STARTING_GRID_SIZE;
@@ -324,6 +330,8 @@ bool ossimRpcSolver::solve(const ossimDrect& imageBounds,
       double deltaY = h/(ySamples-1);
 
       // Sample the midpoints between image grid used to compute RPC:
+      ipts.clear();
+      gpts.clear();
       for (ossim_uint32 y=0; y<ySamples-1; ++y)
       {
          ipt.y = deltaY*((double)y + 0.5) + ul.y;
@@ -341,17 +349,24 @@ bool ossimRpcSolver::solve(const ossimDrect& imageBounds,
                if(ossim::isnan(h) == false)
                   gpt.height(h);
             }
+            ipts.push_back(ipt);
+            gpts.push_back(gpt);
+         }
+      }
 
-            // Reverse projection using RPC:
-            evalPoint(gpt, irpc);
+      // Reverse projection of all samples using RPC:
+      irpcs.resize(gpts.size());
+      if (gpts.size())
+         theRpcModel->worldToLineSample(&gpts.front(), &irpcs.front(), (ossim_uint32) gpts.size());
 
-            // Compute residual and accumulate:
-            residual = (ipt-irpc).length();
-            if (residual > theMaxResidual)
-               theMaxResidual = residual;
-            sumResiduals += residual;
-            ++numResiduals;
-         }
+      // Compute residuals and accumulate:
+      for (ossim_uint32 i=0; i<ipts.size(); ++i)
+      {
+         residual = (ipts[i]-irpcs[i]).length();
+         if (residual > theMaxResidual)
+            theMaxResidual = residual;
+         sumResiduals += residual;
+         ++numResiduals;
       }
 
       theMeanResidual = sumResiduals/numResiduals;
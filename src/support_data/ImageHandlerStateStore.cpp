@@ -0,0 +1,156 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/support_data/ImageHandlerStateStore.h>
+#include <ossim/support_data/ImageHandlerStateRegistry.h>
+#include <ossim/base/ossimDate.h>
+#include <ossim/base/ossimKeywordlist.h>
+#include <ossim/base/ossimSidecarFile.h>
+#include <cstdio>
+
+namespace
+{
+   const std::string ID_KW       = "state_store.id";
+   const std::string IMAGE_KW    = "state_store.image.";
+   const std::string OVERVIEW_KW = "state_store.overview.";
+   const std::string STATE_KW    = "state.";
+
+   /** @return 64 bit FNV-1a hash of s as 16 hex digits. */
+   std::string hashId(const std::string& s)
+   {
+      ossim_uint64 h = 14695981039346656037ULL;
+      for ( std::string::size_type i = 0; i < s.size(); ++i )
+      {
+         h ^= (ossim_uint8)s[i];
+         h *= 1099511628211ULL;
+      }
+      char buf[17];
+      std::snprintf( buf, sizeof(buf), "%016llx", (unsigned long long)h );
+      return std::string( buf );
+   }
+
+   /** Gets size and modification time of file.  @return false if it is not a local file. */
+   bool getStamp(const ossimFilename& file, ossim_int64& size, ossim_int64& modTime)
+   {
+      bool result = false;
+      if ( file.isFile() )
+      {
+         ossimLocalTm tm;
+         if ( file.getTimes( 0, &tm, 0 ) )
+         {
+            size    = file.fileSize();
+            modTime = (ossim_int64)tm.getEpoc();
+            result  = true;
+         }
+      }
+      return result;
+   }
+
+   bool addStamp(ossimKeywordlist& kwl, const std::string& prefix, const ossimFilename& file)
+   {
+      ossim_int64 size;
+      ossim_int64 modTime;
+      bool result = getStamp( file, size, modTime );
+      if ( result )
+      {
+         kwl.add( prefix.c_str(), "file", file.c_str() );
+         kwl.add( prefix.c_str(), "size", size );
+         kwl.add( prefix.c_str(), "modification_time", modTime );
+      }
+      return result;
+   }
+
+   /** @return true if the file stamped under prefix is unchanged. */
+   bool checkStamp(const ossimKeywordlist& kwl, const std::string& prefix)
+   {
+      ossim_int64 size;
+      ossim_int64 modTime;
+      const ossimFilename file = kwl.findKey( prefix, std::string("file") );
+      return getStamp( file, size, modTime ) &&
+         ( ossimString( kwl.findKey( prefix, std::string("size") ) ).toInt64() == size ) &&
+         ( ossimString( kwl.findKey( prefix, std::string("modification_time") ) ).toInt64() ==
+           modTime );
+   }
+}
+
+ossim::ImageHandlerStateStore::ImageHandlerStateStore(const ossimFilename& directory)
+   :
+   m_directory(directory)
+{
+}
+
+ossimFilename ossim::ImageHandlerStateStore::getFile(const ossimString& id)const
+{
+   return m_directory.dirCat( hashId( id.string() ) + ".state" );
+}
+
+std::shared_ptr<ossim::ImageHandlerState> ossim::ImageHandlerStateStore::load(
+   const ossimString& id)const
+{
+   std::shared_ptr<ossim::ImageHandlerState> result;
+   const ossimFilename file = getFile( id );
+   ossimKeywordlist kwl;
+   if ( file.exists() && kwl.addFile( file ) && ( kwl.findKey( ID_KW ) == id.string() ) )
+   {
+      if ( checkStamp( kwl, IMAGE_KW ) &&
+           ( kwl.findKey( OVERVIEW_KW, std::string("file") ).empty() ||
+             checkStamp( kwl, OVERVIEW_KW ) ) )
+      {
+         result = ossim::ImageHandlerStateRegistry::instance()->createState( kwl, STATE_KW );
+      }
+      else
+      {
+         // Image or overview changed since; the state gets saved again once reopened.
+         file.remove();
+      }
+   }
+   return result;
+}
+
+bool ossim::ImageHandlerStateStore::save(const ossimString& id,
+                                         const ossim::ImageHandlerState& state)const
+{
+   ossimKeywordlist kwl;
+   kwl.add( ID_KW.c_str(), id.c_str() );
+   if ( !addStamp( kwl, IMAGE_KW, state.getConnectionString() ) )
+   {
+      return false;
+   }
+   std::shared_ptr<const ossim::ImageHandlerState> overview = state.getOverviewState();
+   if ( overview && !addStamp( kwl, OVERVIEW_KW, overview->getConnectionString() ) )
+   {
+      return false;
+   }
+   if ( !state.save( kwl, STATE_KW ) )
+   {
+      return false;
+   }
+
+   if ( !m_directory.exists() && !m_directory.createDirectory() )
+   {
+      return false;
+   }
+
+   const ossimFilename file = getFile( id );
+   const ossimFilename tmp  = ossim::getSidecarTempFile( file );
+   if ( !kwl.write( tmp.c_str() ) )
+   {
+      tmp.remove();
+      return false;
+   }
+   return ossim::replaceFile( tmp, file );
+}
+
+void ossim::ImageHandlerStateStore::remove(const ossimString& id)const
+{
+   const ossimFilename file = getFile( id );
+   if ( file.exists() )
+   {
+      file.remove();
+   }
+}
@@ -0,0 +1,297 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/support_data/ossimLasPointIndex.h>
+#include <ossim/base/ossimCommon.h>
+#include <ossim/base/ossimSidecarFile.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+
+namespace
+{
+   using ossim::readValue;
+   using ossim::writeValue;
+   using ossim::readArray;
+   using ossim::writeArray;
+
+   const char         MAGIC[8]           = { 'O', 'S', 'S', 'I', 'M', 'L', 'P', 'I' };
+   const ossim_uint32 VERSION            = 1;
+   const ossim_uint32 MAX_CELLS_PER_SIDE = 1024;
+
+   /** @return true if cellStart starts at 0, never goes down and ends at runs. */
+   bool validCellStarts(const std::vector<ossim_uint64>& cellStart, ossim_uint64 runs)
+   {
+      if ( cellStart.empty() || cellStart.front() || ( cellStart.back() != runs ) )
+      {
+         return false;
+      }
+      for ( std::size_t i = 1; i < cellStart.size(); ++i )
+      {
+         if ( cellStart[i] < cellStart[i - 1] )
+         {
+            return false;
+         }
+      }
+      return true;
+   }
+
+   bool lessFirst(const ossimLasPointIndex::Range& a, const ossimLasPointIndex::Range& b)
+   {
+      return a.first < b.first;
+   }
+}
+
+ossimLasPointIndex::ossimLasPointIndex()
+   :
+   m_minX(0.0),
+   m_minY(0.0),
+   m_maxX(0.0),
+   m_maxY(0.0),
+   m_cols(0),
+   m_rows(0),
+   m_cellStart(),
+   m_first(),
+   m_count(),
+   m_building()
+{
+}
+
+void ossimLasPointIndex::clear()
+{
+   m_cols = 0;
+   m_rows = 0;
+   m_cellStart.clear();
+   m_first.clear();
+   m_count.clear();
+   m_building.clear();
+}
+
+void ossimLasPointIndex::initialize(double minX, double minY, double maxX, double maxY,
+                                    ossim_uint64 numberOfPoints)
+{
+   clear();
+
+   m_minX = std::min(minX, maxX);
+   m_minY = std::min(minY, maxY);
+   m_maxX = std::max(minX, maxX);
+   m_maxY = std::max(minY, maxY);
+
+   // Split the cells between the axes by the aspect of the bounds.
+   const double cells  = std::max<double>( 1.0, (double)(numberOfPoints / POINTS_PER_CELL) );
+   const double width  = m_maxX - m_minX;
+   const double height = m_maxY - m_minY;
+   double cols = 1.0;
+   if ( (width > 0.0) && (height > 0.0) )
+   {
+      cols = std::floor( std::sqrt( cells * width / height ) + 0.5 );
+   }
+   else if ( width > 0.0 )
+   {
+      cols = cells;
+   }
+   cols = ossim::clamp<double>( cols, 1.0, MAX_CELLS_PER_SIDE );
+   const double rows = ossim::clamp<double>( std::ceil( cells / cols ), 1.0, MAX_CELLS_PER_SIDE );
+
+   m_cols = (ossim_uint32)cols;
+   m_rows = (ossim_uint32)rows;
+   m_building.resize( (std::size_t)m_cols * m_rows );
+}
+
+void ossimLasPointIndex::getCell(double x, double y, ossim_int64& col, ossim_int64& row) const
+{
+   const double width  = m_maxX - m_minX;
+   const double height = m_maxY - m_minY;
+   col = ( width  > 0.0 ) ? (ossim_int64)std::floor( (x - m_minX) / width  * m_cols ) : 0;
+   row = ( height > 0.0 ) ? (ossim_int64)std::floor( (y - m_minY) / height * m_rows ) : 0;
+   col = std::max<ossim_int64>( 0, std::min<ossim_int64>( col, (ossim_int64)m_cols - 1 ) );
+   row = std::max<ossim_int64>( 0, std::min<ossim_int64>( row, (ossim_int64)m_rows - 1 ) );
+}
+
+void ossimLasPointIndex::add(ossim_uint64 record, double x, double y)
+{
+   if ( m_building.empty() || ossim::isnan(x) || ossim::isnan(y) )
+   {
+      return;
+   }
+
+   ossim_int64 col;
+   ossim_int64 row;
+   getCell(x, y, col, row);
+
+   std::vector<Range>& runs = m_building[ (std::size_t)(row * m_cols + col) ];
+   if ( runs.size() && ( runs.back().first + runs.back().count == record ) &&
+        ( runs.back().count < std::numeric_limits<ossim_uint32>::max() ) )
+   {
+      ++runs.back().count;
+   }
+   else
+   {
+      Range run;
+      run.first = record;
+      run.count = 1;
+      runs.push_back(run);
+   }
+}
+
+void ossimLasPointIndex::finalize()
+{
+   if ( m_building.empty() )
+   {
+      return;
+   }
+
+   m_cellStart.resize( m_building.size() + 1 );
+   m_first.clear();
+   m_count.clear();
+   for ( std::size_t i = 0; i < m_building.size(); ++i )
+   {
+      m_cellStart[i] = m_first.size();
+      for ( std::size_t j = 0; j < m_building[i].size(); ++j )
+      {
+         m_first.push_back( m_building[i][j].first );
+         m_count.push_back( (ossim_uint32)m_building[i][j].count );
+      }
+   }
+   m_cellStart.back() = m_first.size();
+
+   std::vector< std::vector<Range> >().swap( m_building );
+}
+
+void ossimLasPointIndex::getRanges(double minX, double minY, double maxX, double maxY,
+                                   std::vector<Range>& ranges, ossim_uint64 maxGap) const
+{
+   ranges.clear();
+   if ( !valid() || (std::max(minX, maxX) < m_minX) || (std::min(minX, maxX) > m_maxX) ||
+        (std::max(minY, maxY) < m_minY) || (std::min(minY, maxY) > m_maxY) )
+   {
+      return;
+   }
+
+   ossim_int64 col0, row0, col1, row1;
+   getCell( std::min(minX, maxX), std::min(minY, maxY), col0, row0 );
+   getCell( std::max(minX, maxX), std::max(minY, maxY), col1, row1 );
+
+   std::vector<Range> runs;
+   for ( ossim_int64 row = row0; row <= row1; ++row )
+   {
+      for ( ossim_int64 col = col0; col <= col1; ++col )
+      {
+         const std::size_t cell = (std::size_t)(row * m_cols + col);
+         for ( ossim_uint64 i = m_cellStart[cell]; i < m_cellStart[cell + 1]; ++i )
+         {
+            Range run;
+            run.first = m_first[ (std::size_t)i ];
+            run.count = m_count[ (std::size_t)i ];
+            runs.push_back(run);
+         }
+      }
+   }
+
+   std::sort( runs.begin(), runs.end(), lessFirst );
+   for ( std::size_t i = 0; i < runs.size(); ++i )
+   {
+      if ( ranges.size() && ( runs[i].first <= ranges.back().first + ranges.back().count + maxGap ) )
+      {
+         ranges.back().count = std::max( ranges.back().count,
+                                         runs[i].first + runs[i].count - ranges.back().first );
+      }
+      else
+      {
+         ranges.push_back( runs[i] );
+      }
+   }
+}
+
+bool ossimLasPointIndex::getBounds(double& minX, double& minY, double& maxX, double& maxY) const
+{
+   minX = m_minX;
+   minY = m_minY;
+   maxX = m_maxX;
+   maxY = m_maxY;
+   return valid();
+}
+
+bool ossimLasPointIndex::read(const ossimFilename& file, ossim_uint64 fileSize, ossim_int64 modTime,
+                              ossim_uint64 numberOfPoints)
+{
+   clear();
+
+   std::ifstream in( file.c_str(), std::ios_base::in | std::ios_base::binary );
+   if ( !in.good() )
+   {
+      return false;
+   }
+
+   ossim_uint64 size      = 0;
+   ossim_int64  time      = 0;
+   if ( !ossim::readSidecarHeader( in, MAGIC, VERSION ) ||
+        !readValue( in, size ) || ( size != fileSize ) ||
+        !readValue( in, time ) || ( time != modTime ) )
+   {
+      return false;
+   }
+
+   // Every run holds a point, so more runs than points means a corrupt file, not a big one.
+   ossim_uint64 runs = 0;
+   bool status = readValue( in, m_minX ) && readValue( in, m_minY ) &&
+                 readValue( in, m_maxX ) && readValue( in, m_maxY ) &&
+                 readValue( in, m_cols ) && readValue( in, m_rows ) && readValue( in, runs ) &&
+                 ( runs <= numberOfPoints ) &&
+                 m_cols && m_rows && ( m_cols <= MAX_CELLS_PER_SIDE ) &&
+                 ( m_rows <= MAX_CELLS_PER_SIDE ) &&
+                 readArray( in, m_cellStart, (ossim_uint64)m_cols * m_rows + 1 ) &&
+                 readArray( in, m_first, runs ) &&
+                 readArray( in, m_count, runs ) &&
+                 validCellStarts( m_cellStart, runs ); // Stale or corrupt, caller rebuilds.
+   if ( !status )
+   {
+      clear();
+   }
+   return status;
+}
+
+bool ossimLasPointIndex::write(const ossimFilename& file, ossim_uint64 fileSize,
+                               ossim_int64 modTime) const
+{
+   if ( !valid() )
+   {
+      return false;
+   }
+
+   // Written aside and moved into place so a concurrent reader never sees part of a file.
+   const ossimFilename tmp = ossim::getSidecarTempFile( file );
+   std::ofstream out( tmp.c_str(), std::ios_base::out | std::ios_base::binary );
+   if ( !out.good() )
+   {
+      return false;
+   }
+
+   ossim::writeSidecarHeader( out, MAGIC, VERSION );
+   writeValue( out, fileSize );
+   writeValue( out, modTime );
+   writeValue( out, m_minX );
+   writeValue( out, m_minY );
+   writeValue( out, m_maxX );
+   writeValue( out, m_maxY );
+   writeValue( out, m_cols );
+   writeValue( out, m_rows );
+   writeValue( out, (ossim_uint64)m_first.size() );
+   writeArray( out, m_cellStart );
+   writeArray( out, m_first );
+   writeArray( out, m_count );
+   out.close();
+
+   if ( out.fail() )
+   {
+      tmp.remove();
+      return false;
+   }
+   return ossim::replaceFile( tmp, file );
+}
@@ -0,0 +1,286 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/support_data/ossimNitfJpegBlockIndex.h>
+#include <ossim/base/ossimSidecarFile.h>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+   using ossim::readValue;
+   using ossim::writeValue;
+
+   const char         MAGIC[8]        = { 'O', 'S', 'S', 'I', 'M', 'J', 'B', 'I' };
+   const ossim_uint32 VERSION         = 1;
+
+   /**
+    * Chunked reader over the stream.  get() leaves its argument alone at the end of the stream,
+    * like std::istream::get(char&).
+    */
+   class ScanBuffer
+   {
+   public:
+      ScanBuffer(std::istream& str, std::streamoff start)
+         :
+         m_str(str),
+         m_buf(ossimNitfJpegBlockIndex::SCAN_BUFFER_SIZE),
+         m_bufStart(start),
+         m_pos(0),
+         m_end(0)
+      {
+      }
+
+      /** @return File offset of the next byte. */
+      std::streamoff tell() const
+      {
+         return m_bufStart + (std::streamoff)m_pos;
+      }
+
+      bool get(ossim_uint8& c)
+      {
+         if ( (m_pos == m_end) && !fill() )
+         {
+            return false;
+         }
+         c = m_buf[m_pos++];
+         return true;
+      }
+
+      /** Moves past the next 0xFF byte.  @return false at the end of the stream. */
+      bool skipPastFF()
+      {
+         while ( true )
+         {
+            if ( m_pos < m_end )
+            {
+               const ossim_uint8* p = (const ossim_uint8*)
+                  memchr( &m_buf[m_pos], 0xff, m_end - m_pos );
+               if ( p )
+               {
+                  m_pos = (std::size_t)(p - &m_buf.front()) + 1;
+                  return true;
+               }
+               m_pos = m_end;
+            }
+            if ( !fill() )
+            {
+               return false;
+            }
+         }
+      }
+
+      void seek(std::streamoff offset)
+      {
+         if ( (offset >= m_bufStart) && (offset <= m_bufStart + (std::streamoff)m_end) )
+         {
+            m_pos = (std::size_t)(offset - m_bufStart);
+         }
+         else
+         {
+            m_bufStart = offset;
+            m_pos = 0;
+            m_end = 0;
+         }
+      }
+
+   private:
+      /** Reads the chunk following the current one. */
+      bool fill()
+      {
+         m_bufStart += (std::streamoff)m_end;
+         m_pos = 0;
+         m_end = 0;
+         m_str.clear();
+         m_str.seekg( m_bufStart, std::ios_base::beg );
+         m_str.read( (char*)&m_buf.front(), (std::streamsize)m_buf.size() );
+         m_end = (std::size_t)m_str.gcount();
+         return m_end > 0;
+      }
+
+      std::istream&            m_str;
+      std::vector<ossim_uint8> m_buf;
+      std::streamoff           m_bufStart; // File offset of m_buf[0].
+      std::size_t              m_pos;
+      std::size_t              m_end;
+   };
+}
+
+ossimNitfJpegBlockIndex::ossimNitfJpegBlockIndex()
+   :
+   m_offsets(),
+   m_sizes()
+{
+}
+
+void ossimNitfJpegBlockIndex::clear()
+{
+   m_offsets.clear();
+   m_sizes.clear();
+}
+
+bool ossimNitfJpegBlockIndex::scan(std::istream& str, std::streamoff start,
+                                   ossim_uint32 totalBlocks)
+{
+   clear();
+
+   //---
+   // NOTE:
+   // SOI = 0xffd8 Start of image
+   // EOI = 0xffd9 End of image
+   // DHT = 0xffc4 Define Huffman Table(s)
+   // DQT = 0xffdb Define Quantization Table(s)
+   //---
+   const ossim_uint8 AP6 = 0xe6;
+   const ossim_uint8 AP7 = 0xe7;
+   const ossim_uint8 DHT = 0xc4;
+   const ossim_uint8 DQT = 0xdb;
+   const ossim_uint8 EOI = 0xd9;
+   const ossim_uint8 FF  = 0xff;
+   const ossim_uint8 SOI = 0xd8;
+   const ossim_uint8 SOS = 0xda;
+
+   ScanBuffer buf( str, start );
+   ossim_uint8 c;
+
+   // Find all the SOI markers.  There can be more than one jpeg entry in a file, so stop at
+   // totalBlocks.
+   while ( ( m_offsets.size() < totalBlocks ) && buf.skipPastFF() )
+   {
+      // Skip multiple 0xff's in cases like FF FF D8
+      c = FF;
+      while ( buf.get( c ) && ( c == FF ) ) {}
+
+      if ( c != SOI )
+      {
+         continue;
+      }
+
+      // At SOI 0xFFD8 marker... SOI marker offset is two bytes back.
+      const std::streamoff soiOffset = buf.tell() - 2;
+
+      // Now look for matching EOI.
+      while ( buf.skipPastFF() )
+      {
+         c = FF;
+         while ( buf.get( c ) && ( c == FF ) ) {}
+
+         if ( c == EOI )
+         {
+            m_offsets.push_back( soiOffset );
+            m_sizes.push_back( (ossim_uint32)( buf.tell() - soiOffset ) );
+            break;
+         }
+
+         //---
+         // These are things to skip to avoid hitting random sequence of FFD9
+         // and picking up a false EOI.
+         // Not a complete set of markers but all test data works.
+         // drb - 14 May 2013.
+         //---
+         if ( ( c == AP6 ) || ( c == AP7 ) || ( c == DHT ) || ( c == DQT ) || ( c == SOS ) ||
+              ( ( c >= 0xc0 ) && ( c <= 0xcf ) ) )
+         {
+            // Length two byte big endian, includes the two length bytes.
+            ossim_uint8 hi;
+            ossim_uint8 lo;
+            if ( !buf.get( hi ) || !buf.get( lo ) )
+            {
+               break;
+            }
+            const ossim_uint32 length = ( (ossim_uint32)hi << 8 ) | lo;
+            if ( length > 2 )
+            {
+               buf.seek( buf.tell() + (std::streamoff)( length - 2 ) );
+            }
+         }
+      }
+   }
+
+   str.clear();
+
+   return m_offsets.size() == totalBlocks;
+}
+
+bool ossimNitfJpegBlockIndex::read(const ossimFilename& file, ossim_uint64 fileSize,
+                                   ossim_int64 modTime, std::streamoff start,
+                                   ossim_uint32 totalBlocks)
+{
+   clear();
+
+   std::ifstream in( file.c_str(), std::ios_base::in | std::ios_base::binary );
+   if ( !in.good() )
+   {
+      return false;
+   }
+
+   ossim_uint64 size      = 0;
+   ossim_int64  time      = 0;
+   ossim_int64  location  = 0;
+   ossim_uint32 total     = 0;
+   ossim_uint32 count     = 0;
+   if ( !ossim::readSidecarHeader( in, MAGIC, VERSION ) ||
+        !readValue( in, size ) || ( size != fileSize ) ||
+        !readValue( in, time ) || ( time != modTime ) ||
+        !readValue( in, location ) || ( location != (ossim_int64)start ) ||
+        !readValue( in, total ) || ( total != totalBlocks ) ||
+        !readValue( in, count ) || ( count > totalBlocks ) )
+   {
+      return false;
+   }
+
+   m_offsets.resize( count );
+   m_sizes.resize( count );
+   bool status = true;
+   for ( ossim_uint32 i = 0; status && ( i < count ); ++i )
+   {
+      ossim_int64 offset;
+      status = readValue( in, offset ) && readValue( in, m_sizes[i] ) &&
+               ( offset >= (ossim_int64)start ) &&
+               ( (ossim_uint64)offset + m_sizes[i] <= fileSize );
+      m_offsets[i] = (std::streamoff)offset;
+   }
+   if ( !status )
+   {
+      clear();
+   }
+   return status;
+}
+
+bool ossimNitfJpegBlockIndex::write(const ossimFilename& file, ossim_uint64 fileSize,
+                                    ossim_int64 modTime, std::streamoff start,
+                                    ossim_uint32 totalBlocks) const
+{
+   // Written aside and moved into place so a concurrent reader never sees part of a file.
+   const ossimFilename tmp = ossim::getSidecarTempFile( file );
+   std::ofstream out( tmp.c_str(), std::ios_base::out | std::ios_base::binary );
+   if ( !out.good() )
+   {
+      return false;
+   }
+
+   ossim::writeSidecarHeader( out, MAGIC, VERSION );
+   writeValue( out, fileSize );
+   writeValue( out, modTime );
+   writeValue( out, (ossim_int64)start );
+   writeValue( out, totalBlocks );
+   writeValue( out, (ossim_uint32)m_offsets.size() );
+   for ( std::size_t i = 0; i < m_offsets.size(); ++i )
+   {
+      writeValue( out, (ossim_int64)m_offsets[i] );
+      writeValue( out, m_sizes[i] );
+   }
+   out.close();
+
+   if ( out.fail() )
+   {
+      tmp.remove();
+      return false;
+   }
+   return ossim::replaceFile( tmp, file );
+}
@@ -38,6 +38,7 @@
 #include <ossim/base/ossimEndian.h>
 #include <ossim/base/ossimErrorCodes.h>
 #include <ossim/base/ossimTrace.h>
+#include <cstring>
 #include <istream>
 #include <ostream>
 
@@ -418,6 +419,77 @@ bool ossimRpfFrame::fillSubFrameBuffer(ossim_uint8* buffer,
    return true;
 }
 
+bool ossimRpfFrame::decodeSubFrame(ossim_uint8* buffer,
+                                   ossim_uint32 bands,
+                                   ossim_uint32 row,
+                                   ossim_uint32 col)const
+{
+   // ESH 03/2009 -- Partial fix for ticket #646.
+   // Crash fix on reading RPFs: Make sure the colorTable vector 
+   // has entries before trying to make use of them. 
+   if( !theCompressionSection || theColorGrayscaleTable.empty() )
+   {
+      return false;
+   }
+
+   //---
+   // A CADRG and CIB subframe is a 64*64*12 bit buffer and must divide by 8
+   // to convert to bytes.
+   //---
+   ossim_uint8 compressed[(64*64*12)/8];
+   if( !fillSubFrameBuffer(compressed, 0, row, col) )
+   {
+      memset(buffer, 0, 256*256*bands);
+      return true;
+   }
+
+   const ossimRpfColorGrayscaleTable& colorTable = theColorGrayscaleTable[0];
+   const std::vector<ossimRpfCompressionOffsetTableData>& table =
+      theCompressionSection->getTable();
+   ossim_uint32 readPtr = 0;
+   for (ossim_uint32 i = 0; i < 256; i += 4)
+   {
+      for (ossim_uint32 j = 0; j < 256; j += 8)
+      {
+         ossim_uint16 firstByte  = compressed[readPtr++] & 0xff;
+         ossim_uint16 secondByte = compressed[readPtr++] & 0xff;
+         ossim_uint16 thirdByte  = compressed[readPtr++] & 0xff;
+
+         //because dealing with half-bytes is hard, we
+         //uncompress two 4x4 tiles at the same time. (a
+         //4x4 tile compressed is 12 bits )
+         // this little code was grabbed from openmap software.
+
+         /* Get first 12-bit value as index into VQ table */
+         ossim_uint16 val1 = (firstByte << 4) | (secondByte >> 4);
+
+         /* Get second 12-bit value as index into VQ table*/
+         ossim_uint16 val2 = ((secondByte & 0x000F) << 8) | thirdByte;
+
+         for (ossim_uint32 t = 0; t < 4; ++t)
+         {
+            for (ossim_uint32 e = 0; e < 4; ++e)
+            {
+               ossim_uint16 tableVal1 = table[t].theData[val1*4 + e] & 0xff;
+               ossim_uint16 tableVal2 = table[t].theData[val2*4 + e] & 0xff;
+
+               ossim_uint32 pixindex = ((i+t)*256) + (j + e);
+               const ossim_uint8* color1 = colorTable.getStartOfData(tableVal1);
+               const ossim_uint8* color2 = colorTable.getStartOfData(tableVal2);
+
+               for (ossim_uint32 b = 0; b < bands; ++b)
+               {
+                  buffer[b*256*256 + pixindex]     = color1[b];
+                  buffer[b*256*256 + pixindex + 4] = color2[b];
+               }
+            } //for e
+         } //for t
+      } /* for j */
+   } //for i
+
+   return true;
+}
+
 void ossimRpfFrame::clearFields()
 {   
    theFilename = "";
@@ -0,0 +1,159 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/support_data/ossimRpfFrameCache.h>
+#include <ossim/support_data/ossimRpfFrame.h>
+#include <ossim/base/ossimCommon.h>
+#include <ossim/base/ossimErrorCodes.h>
+#include <ossim/base/ossimPreferences.h>
+#include <ossim/parallel/ossimJobWorkStealingQueue.h>
+#include <map>
+
+namespace
+{
+   const ossim_uint32 DEFAULT_MAX_FRAMES    = 32;
+   const ossim_uint32 DEFAULT_MAX_SUBFRAMES = 512;
+}
+
+ossimRpfFrameCache* ossimRpfFrameCache::instance()
+{
+   static ossimRpfFrameCache cache;
+   return &cache;
+}
+
+ossimRpfFrameCache::ossimRpfFrameCache()
+   :
+   m_frames(),
+   m_subFrames()
+{
+   ossim_uint32 maxFrames    = DEFAULT_MAX_FRAMES;
+   ossim_uint32 maxSubFrames = DEFAULT_MAX_SUBFRAMES;
+
+   ossimString value = ossimPreferences::instance()->findPreference("rpf.frame_cache.max_frames");
+   if ( value.size() )
+   {
+      maxFrames = value.toUInt32();
+   }
+   value = ossimPreferences::instance()->findPreference("rpf.frame_cache.max_subframes");
+   if ( value.size() )
+   {
+      maxSubFrames = value.toUInt32();
+   }
+   setLimits( maxFrames, maxSubFrames );
+}
+
+void ossimRpfFrameCache::setLimits(ossim_uint32 maxFrames, ossim_uint32 maxSubFrames)
+{
+   // Shrink back to 80% when full, like the image handler state cache.
+   m_frames.setMinAndMaxItemsToCache(
+      ossim::round<ossim_uint32, ossim_float32>( maxFrames * 0.8f ), maxFrames );
+   m_subFrames.setMinAndMaxItemsToCache(
+      ossim::round<ossim_uint32, ossim_float32>( maxSubFrames * 0.8f ), maxSubFrames );
+}
+
+void ossimRpfFrameCache::clear()
+{
+   m_frames.reset();
+   m_subFrames.reset();
+}
+
+ossimString ossimRpfFrameCache::subFrameKey(const ossimFilename& file, ossim_uint32 row,
+                                            ossim_uint32 col, ossim_uint32 bands)
+{
+   ossimString key = file;
+   key += "|";
+   key += ossimString::toString( row );
+   key += ",";
+   key += ossimString::toString( col );
+   key += ",";
+   key += ossimString::toString( bands );
+   return key;
+}
+
+std::shared_ptr<const ossimRpfFrame> ossimRpfFrameCache::getFrame(const ossimFilename& file)
+{
+   std::shared_ptr<const ossimRpfFrame> result = m_frames.getItem( file );
+   if ( !result )
+   {
+      // Parsed outside any lock.  Two threads may parse the same frame; the last one wins.
+      std::shared_ptr<ossimRpfFrame> frame = std::make_shared<ossimRpfFrame>();
+      if ( frame->parseFile( file ) == ossimErrorCodes::OSSIM_OK )
+      {
+         result = frame;
+         m_frames.addItem( file, result );
+      }
+   }
+   return result;
+}
+
+ossimRpfFrameCache::SubFrame ossimRpfFrameCache::getSubFrame(const ossimFilename& file,
+                                                             ossim_uint32 row,
+                                                             ossim_uint32 col,
+                                                             ossim_uint32 bands)
+{
+   const ossimString key = subFrameKey( file, row, col, bands );
+   SubFrame result = m_subFrames.getItem( key );
+   if ( !result )
+   {
+      std::shared_ptr<const ossimRpfFrame> frame = getFrame( file );
+      if ( frame )
+      {
+         std::shared_ptr<SubFrameData> data = std::make_shared<SubFrameData>( 256*256*bands );
+         if ( frame->decodeSubFrame( &data->front(), bands, row, col ) )
+         {
+            result = data;
+            m_subFrames.addItem( key, result );
+         }
+      }
+   }
+   return result;
+}
+
+void ossimRpfFrameCache::getSubFrames(std::vector<SubFrameRequest>& requests, ossim_uint32 bands)
+{
+   // Cache hits first, on this thread:
+   std::vector<ossim_uint32> misses;
+   for ( ossim_uint32 i = 0; i < requests.size(); ++i )
+   {
+      SubFrameRequest& request = requests[i];
+      request.data = m_subFrames.getItem(
+         subFrameKey( request.file, request.row, request.col, bands ) );
+      if ( !request.data )
+      {
+         misses.push_back( i );
+      }
+   }
+   if ( misses.empty() )
+   {
+      return;
+   }
+
+   // Parse each frame once, then decode the subframes:
+   std::map<ossimString, ossim_uint32> fileIndex;
+   std::vector<ossimFilename> files;
+   for ( ossim_uint32 i = 0; i < misses.size(); ++i )
+   {
+      const ossimFilename& file = requests[ misses[i] ].file;
+      if ( fileIndex.insert( std::make_pair( file, (ossim_uint32)files.size() ) ).second )
+      {
+         files.push_back( file );
+      }
+   }
+   ossimJobWorkStealingQueue* pool = ossimJobWorkStealingQueue::instance();
+   pool->parallelFor( (ossim_uint32)files.size(), pool->getNumberOfThreads(),
+                      [this, &files](ossim_uint32 i)
+   {
+      getFrame( files[i] );
+   } );
+   pool->parallelFor( (ossim_uint32)misses.size(), pool->getNumberOfThreads(),
+                      [this, &requests, &misses, bands](ossim_uint32 i)
+   {
+      SubFrameRequest& request = requests[ misses[i] ];
+      request.data = getSubFrame( request.file, request.row, request.col, bands );
+   } );
+}
@@ -487,9 +487,8 @@ bool ossimHlzTool::computeHLZ()
          m_numThreads = ossim::getNumberOfThreads();
 
       // Loop over input DEM, creating a thread job for each filter window:
-      std::shared_ptr<ossimJobMultiThreadQueue> jobMtQueue =
-            std::make_shared<ossimJobMultiThreadQueue>(nullptr, m_numThreads);
-      std::shared_ptr<ossimJobQueue> jobQueue = jobMtQueue->getJobQueue();
+      std::shared_ptr<ossimJobWorkStealingQueue> jobMtQueue =
+            std::make_shared<ossimJobWorkStealingQueue>(m_numThreads);
 
       ossimNotify(ossimNotifyLevel_INFO) << "\nPreparing " << numPatches << " jobs..." << endl; // TODO: DEBUG
       setPercentComplete(0);
@@ -506,17 +505,17 @@ bool ossimHlzTool::computeHLZ()
                job = std::make_shared<ossimHlzTool::LsFitPatchProcessorJob>(this, chip_origin, chipId++);
             else
                job = std::make_shared<ossimHlzTool::NormPatchProcessorJob>(this, chip_origin, chipId++);
-            jobQueue->add(job, false);
+            jobMtQueue->add(job);
          }
-         qsize = jobQueue->size();
+         qsize = jobMtQueue->size();
          setPercentComplete(100*(chipId-qsize)/numPatches);
       }
 
       // Wait until all chips have been processed before proceeding:
       ossimNotify(ossimNotifyLevel_INFO) << "All jobs queued. Waiting for job threads to finish..." << endl;
-      while (jobMtQueue->hasJobsToProcess() || jobMtQueue->numberOfBusyThreads())
+      while (jobMtQueue->hasJobsToProcess())
       {
-         qsize = jobMtQueue->getJobQueue()->size();
+         qsize = jobMtQueue->size();
          setPercentComplete(100*(numPatches-qsize)/numPatches);
          ossim::Thread::sleepInMicroSeconds(10000);
       }
@@ -687,7 +686,7 @@ bool ossimHlzTool::PatchProcessorJob::level2Test()
    for (ossim_uint32 i=0; (i<numPoints) && !found_obstruction; ++i)
    {
       //If this is not the only return, implies clutter along the ray:
-      int num_returns = (int) pc_block[i]->getField(ossimPointRecord::NumberOfReturns);
+      int num_returns = (int) pc_block.getField(i, ossimPointRecord::NumberOfReturns);
       if (num_returns > 1)
       {
          found_obstruction = true;
@@ -29,7 +29,8 @@ const char* ossimPointCloudTool::DESCRIPTION =
 
 ossimPointCloudTool::ossimPointCloudTool()
 :  m_operation (LOWEST_DEM),
-   m_gsd (0)
+   m_gsd (0),
+   m_numThreads (0)
 {
 }
 
@@ -126,6 +127,9 @@ bool ossimPointCloudTool::initialize(ossimArgumentParser& ap)
    if ( ap.read("--pc", sp1) )
       m_demFile = ts1;
 
+   if ( ap.read("--threads", sp1) )
+      m_numThreads = ts1.toUInt32();
+
 /*
    if ( ap.read("--request-api", sp1))
    {
@@ -161,7 +165,7 @@ void ossimPointCloudTool::loadJSON(const Json::Value &json_request)
 
 bool ossimPointCloudTool::initialize()
 {
-   if (loadPC())
+   if (!loadPC())
    {
       ossimNotify(ossimNotifyLevel_WARN)
               << "ossimPointCloudTool::initialize ERR: Cannot open PC file at <"<<m_pcFile
@@ -191,6 +195,7 @@ bool ossimPointCloudTool::loadPC()
    // Use "rasterized" PC to establish best output image geometry:
    m_pciHandler = new ossimPointCloudImageHandler;
    m_pciHandler->setPointCloudHandler(m_pcHandler.get());
+   m_pciHandler->setNumberOfThreads(m_numThreads);
    m_prodGeom = m_pciHandler->getImageGeometry();
    if (!m_prodGeom.valid() || !m_prodGeom->getAsMapProjection())
       return false;
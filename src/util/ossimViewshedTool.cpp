@@ -517,7 +517,8 @@ bool ossimViewshedTool::computeViewshed()
 
    if (m_numThreads > 1)
    {
-      std::shared_ptr<ossimJobQueue> jobQueue = std::make_shared<ossimJobQueue>();
+      // Jobs are picked up by the pool's workers as soon as they are added:
+      m_jobMtQueue = std::make_shared<ossimJobWorkStealingQueue>(m_numThreads);
       for (int sector=0; sector<8; ++sector)
       {
          if (m_radials[sector] == 0)
@@ -526,27 +527,28 @@ bool ossimViewshedTool::computeViewshed()
          if (m_threadBySector)
          {
             std::shared_ptr<SectorProcessorJob> job = std::make_shared<SectorProcessorJob>(this, sector, m_halfWindow);
-            jobQueue->add(job, false);
+            m_jobMtQueue->add(job);
          }
          else
          {
             for (ossim_uint32 r=0; r<=m_halfWindow; ++r)
             {
                std::shared_ptr<RadialProcessorJob> job = std::make_shared<RadialProcessorJob>(this, sector, r, m_halfWindow);
-               jobQueue->add(job, false);
+               m_jobMtQueue->add(job);
             }
          }
          if (needsAborting())
+         {
+            m_jobMtQueue->cancel();
             return 0;
+         }
       }
 
-      ossimNotify(ossimNotifyLevel_INFO) << "\nSubmitting "<<jobQueue->size()<<" jobs..."<<endl;
-      m_jobMtQueue = std::make_shared<ossimJobMultiThreadQueue>(jobQueue, m_numThreads);
+      ossimNotify(ossimNotifyLevel_INFO) << "\nSubmitted "<<m_jobMtQueue->getStatistics().jobsAdded<<" jobs..."<<endl;
 
       // Wait until all radials have been processed before proceeding:
       ossimNotify(ossimNotifyLevel_INFO) << "Waiting for job threads to finish..."<<endl;
-      while (m_jobMtQueue->hasJobsToProcess() || m_jobMtQueue->numberOfBusyThreads())
-         ossim::Thread::sleepInMicroSeconds(250);
+      m_jobMtQueue->waitForJobsToFinish();
    }
    else
    {
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <ossim/init/ossimInit.h>
 #include <ossim/base/ossimKeywordlist.h>
 #include <ossim/base/ossimTempFilename.h>
@@ -295,6 +296,66 @@ bool runIncludeTest()
    return test_failed;
 }
 
+bool runLargeListTest()
+{
+   cout << "----------- Testing list larger than the parse block, prefix queries ------------ \n";
+
+   // Enough keys to span several read blocks, with a multi line value in each object.
+   const ossim_uint32 OBJECTS = 1000;
+   ostringstream os;
+   for (ossim_uint32 i = 0; i < OBJECTS; ++i)
+   {
+      os << "object" << i << ".type: ossimRectangleCutFilter\n"
+         << "object" << i << ".description: \"\"\"line one\nline two\"\"\"\n"
+         << "object" << i << ".input_connection1: " << i + 1 << "\n";
+   }
+   os << "name: list\n";
+
+   ossimKeywordlist kwl;
+   bool test_failed = false;
+   cout << "Parsed? ";
+   if (kwl.parseString(os.str()) && (kwl.getSize() == OBJECTS * 3 + 1))
+   {
+      cout << "PASSED" << endl;
+   }
+   else
+   {
+      cout << "FAILED" << endl;
+      test_failed = true;
+   }
+
+   cout << "Multi line values? ";
+   if ((ossimString(kwl.find("object0.description")) == "line one\nline two") &&
+       (ossimString(kwl.find("object999.description")) == "line one\nline two"))
+   {
+      cout << "PASSED" << endl;
+   }
+   else
+   {
+      cout << "FAILED" << endl;
+      test_failed = true;
+   }
+
+   cout << "Prefix queries? ";
+   vector<ossimString> prefixes;
+   kwl.getSubstringKeyList(prefixes, "^(object1[0-9]*\\.)");
+   if ((kwl.getNumberOfSubstringKeys("^(object[0-9]+.)") == OBJECTS) &&
+       (prefixes.size() == 111) &&
+       (kwl.getNumberOfKeysThatMatch("^object99[0-9]\\.type") == 10) &&
+       (kwl.getNumberOfKeysThatMatch("^(object)?name") == 1) &&
+       (kwl.getNumberOfKeysThatMatch("type$") == OBJECTS))
+   {
+      cout << "PASSED" << endl;
+   }
+   else
+   {
+      cout << "FAILED" << endl;
+      test_failed = true;
+   }
+
+   return test_failed;
+}
+
 int main(int argc, char* argv[])
 {
    ossimInit::instance()->initialize(argc, argv);
@@ -389,6 +450,7 @@ int main(int argc, char* argv[])
    cout << "complicatedHtmlEmbed preserved? " << ((ossimString(kwl2.find("complicatedHtmlEmbed.value"))==complicatedHtmlEmbed)?"PASSED":"FAILED") << endl;
    bool test_failed = runTestForFileVariations();
    test_failed |= runIncludeTest();
+   test_failed |= runLargeListTest();
 
    if (!test_failed)
       cout<<"\nAll tests PASSED.\n"<<endl;
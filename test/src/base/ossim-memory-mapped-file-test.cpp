@@ -0,0 +1,104 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Description: Test app for ossimMemoryMappedFile.  Opens a file from several threads, checks
+// they share one mapping holding the file contents, and that missing and empty files are
+// refused.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/base/ossimArgumentParser.h>
+#include <ossim/base/ossimFilename.h>
+#include <ossim/base/ossimMemoryMappedFile.h>
+#include <ossim/init/ossimInit.h>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+   ossimArgumentParser ap(&argc, argv);
+   ossimInit::instance()->addOptions(ap);
+   ossimInit::instance()->initialize(ap);
+
+   const ossim_uint32 SIZE = 100000;
+   ossimFilename file = "ossim-memory-mapped-file-test.bin";
+   ossimFilename emptyFile = "ossim-memory-mapped-file-test-empty.bin";
+   {
+      ofstream os(file.c_str(), ios::binary);
+      for (ossim_uint32 i = 0; i < SIZE; ++i)
+         os.put((char)(i*7 + i/251));
+      ofstream empty(emptyFile.c_str(), ios::binary);
+   }
+
+   int errors = 0;
+
+   // Opens from several threads must all get the one mapping.
+   vector< std::shared_ptr<ossimMemoryMappedFile> > maps(8);
+   vector<std::thread> threads;
+   for (ossim_uint32 i = 0; i < maps.size(); ++i)
+      threads.push_back(std::thread([&maps, &file, i]() { maps[i] = ossimMemoryMappedFile::open(file); }));
+   for (ossim_uint32 i = 0; i < threads.size(); ++i)
+      threads[i].join();
+
+   for (ossim_uint32 i = 0; i < maps.size(); ++i)
+   {
+      if (!maps[i] || (maps[i].get() != maps[0].get()))
+      {
+         cout << "open " << i << " did not return the shared mapping" << endl;
+         ++errors;
+      }
+   }
+
+   if (maps[0])
+   {
+      if (maps[0]->getSize() != SIZE)
+      {
+         cout << "size is " << maps[0]->getSize() << " expected " << SIZE << endl;
+         ++errors;
+      }
+      const ossim_uint8* data = maps[0]->getData();
+      for (ossim_uint32 i = 0; (i < SIZE) && data; ++i)
+      {
+         if (data[i] != (ossim_uint8)(i*7 + i/251))
+         {
+            cout << "byte " << i << " differs" << endl;
+            ++errors;
+            break;
+         }
+      }
+   }
+
+   // Released and mapped again.
+   maps.clear();
+   std::shared_ptr<ossimMemoryMappedFile> again = ossimMemoryMappedFile::open(file);
+   if (!again || (again->getSize() != SIZE))
+   {
+      cout << "could not map again after release" << endl;
+      ++errors;
+   }
+   again.reset();
+
+   if (ossimMemoryMappedFile::open(emptyFile))
+   {
+      cout << "empty file mapped" << endl;
+      ++errors;
+   }
+   if (ossimMemoryMappedFile::open(ossimFilename("ossim-memory-mapped-file-test-missing.bin")))
+   {
+      cout << "missing file mapped" << endl;
+      ++errors;
+   }
+
+   file.remove();
+   emptyFile.remove();
+
+   cout << "ossim-memory-mapped-file-test: " << (errors ? "FAILED" : "PASSED") << endl;
+   return errors ? 1 : 0;
+}
@@ -0,0 +1,127 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Description: Test app for ossimRtree.  Indexes a mesh of tiles like a DEM directory plus some
+// random rectangles and checks point and rectangle searches against a brute force scan.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/base/ossimArgumentParser.h>
+#include <ossim/base/ossimRtree.h>
+#include <ossim/init/ossimInit.h>
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+struct TestRect
+{
+   double minX, minY, maxX, maxY;
+};
+
+static ossim_uint32 seed = 4321;
+static double nextRandom()
+{
+   seed = seed*1103515245 + 12345;
+   return (seed >> 8) / 16777216.0;
+}
+
+static bool sameIds(vector<ossim_uint64> a, vector<ossim_uint64> b)
+{
+   sort(a.begin(), a.end());
+   sort(b.begin(), b.end());
+   return a == b;
+}
+
+int main(int argc, char *argv[])
+{
+   ossimArgumentParser ap(&argc, argv);
+   ossimInit::instance()->addOptions(ap);
+   ossimInit::instance()->initialize(ap);
+
+   // One degree tiles sharing edges, then some overlapping random rectangles.
+   vector<TestRect> rects;
+   for (int lat = -20; lat < 20; ++lat)
+   {
+      for (int lon = -60; lon < 60; ++lon)
+      {
+         TestRect r = { (double)lon, (double)lat, lon + 1.0, lat + 1.0 };
+         rects.push_back(r);
+      }
+   }
+   for (ossim_uint32 i = 0; i < 500; ++i)
+   {
+      double x = -70.0 + 140.0*nextRandom();
+      double y = -30.0 + 60.0*nextRandom();
+      TestRect r = { x, y, x + 5.0*nextRandom(), y + 5.0*nextRandom() };
+      rects.push_back(r);
+   }
+
+   ossimRtree tree;
+   for (ossim_uint32 i = 0; i < rects.size(); ++i)
+      tree.add(i*3 + 1, rects[i].minX, rects[i].minY, rects[i].maxX, rects[i].maxY);
+
+   int errors = 0;
+   for (ossim_uint32 pass = 0; pass < 2; ++pass)
+   {
+      // Searches before build() scan, after build() use the tree.
+      if (pass == 1)
+         tree.build();
+
+      for (ossim_uint32 i = 0; (i < 2000) && (errors < 10); ++i)
+      {
+         // Every 4th point on a tile corner.
+         double x = (i % 4) ? -75.0 + 150.0*nextRandom() : (double)((int)(i % 100) - 50);
+         double y = (i % 4) ? -35.0 + 70.0*nextRandom() : (double)((int)(i % 30) - 15);
+
+         vector<ossim_uint64> expected;
+         for (ossim_uint32 r = 0; r < rects.size(); ++r)
+         {
+            if ((x >= rects[r].minX) && (x <= rects[r].maxX) &&
+                (y >= rects[r].minY) && (y <= rects[r].maxY))
+               expected.push_back(r*3 + 1);
+         }
+         vector<ossim_uint64> found;
+         if ((tree.findPoint(x, y, found) != !expected.empty()) || !sameIds(found, expected))
+         {
+            cout << "pass " << pass << " point " << x << "," << y << " found " << found.size()
+                 << " expected " << expected.size() << endl;
+            ++errors;
+         }
+
+         double w = 3.0*nextRandom();
+         double h = 3.0*nextRandom();
+         expected.clear();
+         for (ossim_uint32 r = 0; r < rects.size(); ++r)
+         {
+            if ((x <= rects[r].maxX) && (rects[r].minX <= x + w) &&
+                (y <= rects[r].maxY) && (rects[r].minY <= y + h))
+               expected.push_back(r*3 + 1);
+         }
+         found.clear();
+         tree.findIntersecting(x + w, y + h, x, y, found);
+         if (!sameIds(found, expected))
+         {
+            cout << "pass " << pass << " rect at " << x << "," << y << " found " << found.size()
+                 << " expected " << expected.size() << endl;
+            ++errors;
+         }
+      }
+   }
+
+   tree.clear();
+   tree.build();
+   vector<ossim_uint64> found;
+   if (!tree.empty() || tree.findPoint(0.0, 0.0, found))
+   {
+      cout << "cleared tree not empty" << endl;
+      ++errors;
+   }
+
+   cout << "ossim-rtree-test: " << (errors ? "FAILED" : "PASSED") << endl;
+   return errors ? 1 : 0;
+}
@@ -0,0 +1,229 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Description: Test app for the ossimElevManager batch height queries.  Writes two adjacent DEM
+// images, loads them as an image elevation database and checks the batch, grid and batch ray
+// intersection results are the same as the single point calls.  Also checks the batch geoid
+// offsets against the single point ones.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/base/ossimArgumentParser.h>
+#include <ossim/base/ossimEcefPoint.h>
+#include <ossim/base/ossimEcefRay.h>
+#include <ossim/base/ossimDatumFactory.h>
+#include <ossim/base/ossimFilename.h>
+#include <ossim/base/ossimGeoidManager.h>
+#include <ossim/base/ossimGpt.h>
+#include <ossim/elevation/ossimElevManager.h>
+#include <ossim/elevation/ossimImageElevationDatabase.h>
+#include <ossim/imaging/ossimImageData.h>
+#include <ossim/imaging/ossimImageGeometry.h>
+#include <ossim/imaging/ossimMemoryImageSource.h>
+#include <ossim/imaging/ossimTiffWriter.h>
+#include <ossim/init/ossimInit.h>
+#include <ossim/projection/ossimEquDistCylProjection.h>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+static const ossim_uint32 DEM_SIZE = 101;
+static const double       DEM_SPAN = 0.1; // degrees
+static const double       ORIGIN_LAT = 38.0;
+static const double       ORIGIN_LON = -77.0;
+
+static bool writeDem(const ossimFilename& file, double ulLat, double ulLon)
+{
+   ossimRefPtr<ossimImageData> dem =
+      new ossimImageData(0, OSSIM_FLOAT32, 1, DEM_SIZE, DEM_SIZE);
+   dem->initialize();
+   ossim_float32* buf = static_cast<ossim_float32*>(dem->getBuf(0));
+   for (ossim_uint32 y = 0; y < DEM_SIZE; ++y)
+   {
+      for (ossim_uint32 x = 0; x < DEM_SIZE; ++x)
+      {
+         double lat = ulLat - y*DEM_SPAN/(DEM_SIZE - 1);
+         buf[y*DEM_SIZE + x] = (ossim_float32)(100.0 + 2000.0*(lat - ORIGIN_LAT) +
+                                               50.0*((x*7 + y*3) % 11));
+      }
+   }
+   dem->validate();
+
+   ossimRefPtr<ossimEquDistCylProjection> proj = new ossimEquDistCylProjection();
+   proj->setUlTiePoints(ossimGpt(ulLat, ulLon));
+   proj->setDecimalDegreesPerPixel(ossimDpt(DEM_SPAN/(DEM_SIZE - 1), DEM_SPAN/(DEM_SIZE - 1)));
+   proj->setElevationLookupFlag(false);
+   ossimRefPtr<ossimImageGeometry> geom = new ossimImageGeometry(0, proj.get());
+   geom->setImageSize(ossimIpt(DEM_SIZE, DEM_SIZE));
+
+   ossimRefPtr<ossimMemoryImageSource> source = new ossimMemoryImageSource();
+   source->setImage(dem);
+   source->setImageGeometry(geom.get());
+   ossimRefPtr<ossimTiffWriter> writer = new ossimTiffWriter();
+   writer->connectMyInputTo(0, source.get());
+   writer->setFilename(file);
+   writer->setWriteOverviewFlag(false);
+   bool result = writer->execute();
+   writer->disconnect();
+   return result;
+}
+
+static bool same(double a, double b)
+{
+   return (ossim::isnan(a) && ossim::isnan(b)) || (a == b);
+}
+
+int main(int argc, char *argv[])
+{
+   ossimArgumentParser ap(&argc, argv);
+   ossimInit::instance()->addOptions(ap);
+   ossimInit::instance()->initialize(ap);
+
+   // Two cells side by side.
+   ossimFilename dir = "ossim-batch-elevation-test-dem";
+   dir.createDirectory();
+   if ( !writeDem(dir.dirCat("west.tif"), ORIGIN_LAT + DEM_SPAN, ORIGIN_LON) ||
+        !writeDem(dir.dirCat("east.tif"), ORIGIN_LAT + DEM_SPAN, ORIGIN_LON + DEM_SPAN) )
+   {
+      cout << "could not write dem" << endl;
+      return 1;
+   }
+
+   ossimRefPtr<ossimImageElevationDatabase> db = new ossimImageElevationDatabase();
+   if ( !db->open(dir) )
+   {
+      cout << "could not open " << dir << endl;
+      return 1;
+   }
+   ossimElevManager* mgr = ossimElevManager::instance();
+   mgr->addDatabase(db.get(), true);
+
+   int errors = 0;
+
+   // Scattered points over both cells and off their edges.
+   const ossim_uint32 COUNT = 2000;
+   vector<ossimGpt> pts(COUNT);
+   ossim_uint32 seed = 12345;
+   for (ossim_uint32 i = 0; i < COUNT; ++i)
+   {
+      seed = seed*1103515245 + 12345;
+      double u = (seed >> 8) / 16777216.0;
+      seed = seed*1103515245 + 12345;
+      double v = (seed >> 8) / 16777216.0;
+      pts[i] = ossimGpt(ORIGIN_LAT - 0.01 + v*(DEM_SPAN + 0.02),
+                        ORIGIN_LON - 0.01 + u*(2*DEM_SPAN + 0.02));
+   }
+
+   vector<double> heights(COUNT);
+   mgr->getHeightsAboveEllipsoid(&pts.front(), &heights.front(), COUNT);
+   for (ossim_uint32 i = 0; (i < COUNT) && (errors < 10); ++i)
+   {
+      double h = mgr->getHeightAboveEllipsoid(pts[i]);
+      if (!same(h, heights[i]))
+      {
+         cout << "ellipsoid height " << i << " is " << heights[i] << " expected " << h << endl;
+         ++errors;
+      }
+   }
+   mgr->getHeightsAboveMSL(&pts.front(), &heights.front(), COUNT);
+   for (ossim_uint32 i = 0; (i < COUNT) && (errors < 10); ++i)
+   {
+      double h = mgr->getHeightAboveMSL(pts[i]);
+      if (!same(h, heights[i]))
+      {
+         cout << "msl height " << i << " is " << heights[i] << " expected " << h << endl;
+         ++errors;
+      }
+   }
+
+   // The dem itself must have been used.
+   double center = mgr->getHeightAboveMSL(ossimGpt(ORIGIN_LAT + 0.05, ORIGIN_LON + 0.05));
+   if (ossim::isnan(center) || (center < 100.0) || (center > 800.0))
+   {
+      cout << "dem not used, center height " << center << endl;
+      ++errors;
+   }
+
+   // North up grid from the upper left crossing both cells.
+   const ossim_uint32 LINES = 37;
+   const ossim_uint32 SAMPLES = 73;
+   const double SPACING = 0.0029;
+   ossimGpt origin(ORIGIN_LAT + DEM_SPAN, ORIGIN_LON);
+   vector<double> grid(LINES*SAMPLES);
+   mgr->getHeightsAboveEllipsoid(origin, -SPACING, SPACING, LINES, SAMPLES, &grid.front());
+   for (ossim_uint32 line = 0; (line < LINES) && (errors < 10); ++line)
+   {
+      for (ossim_uint32 samp = 0; samp < SAMPLES; ++samp)
+      {
+         ossimGpt gpt(origin.lat - line*SPACING, origin.lon + samp*SPACING);
+         double h = mgr->getHeightAboveEllipsoid(gpt);
+         if (!same(h, grid[line*SAMPLES + samp]))
+         {
+            cout << "grid post " << line << "," << samp << " is " << grid[line*SAMPLES + samp]
+                 << " expected " << h << endl;
+            ++errors;
+            break;
+         }
+      }
+   }
+
+   // Oblique rays from 5 km up.
+   const ossim_uint32 RAYS = 200;
+   vector<ossimEcefRay> rays(RAYS);
+   for (ossim_uint32 i = 0; i < RAYS; ++i)
+   {
+      ossimEcefPoint from(ossimGpt(pts[i].lat, pts[i].lon, 5000.0));
+      ossimEcefPoint to(ossimGpt(pts[i].lat + 0.003, pts[i].lon + 0.002, 0.0));
+      rays[i] = ossimEcefRay(from, to);
+   }
+   rays[7].makeNan();
+   vector<ossimGpt> batchGpts(RAYS);
+   mgr->intersectRays(&rays.front(), &batchGpts.front(), RAYS);
+   for (ossim_uint32 i = 0; (i < RAYS) && (errors < 10); ++i)
+   {
+      ossimGpt gpt;
+      mgr->intersectRay(rays[i], gpt);
+      if ( !same(gpt.lat, batchGpts[i].lat) || !same(gpt.lon, batchGpts[i].lon) ||
+           !same(gpt.hgt, batchGpts[i].hgt) )
+      {
+         cout << "ray " << i << " hit " << batchGpts[i] << " expected " << gpt << endl;
+         ++errors;
+      }
+   }
+
+   // Batch geoid offsets world wide, with a few non WGS84 and NaN points.
+   const ossim_uint32 GEOID_COUNT = 1001;
+   vector<ossimGpt> geoidPts(GEOID_COUNT);
+   const ossimDatum* nar = ossimDatumFactory::instance()->create(ossimString("NAR-C"));
+   for (ossim_uint32 i = 0; i < GEOID_COUNT; ++i)
+   {
+      geoidPts[i] = ossimGpt(-89.9 + 179.8*i/GEOID_COUNT, -180.0 + 360.0*((i*37) % 1000)/1000.0);
+      if (nar && (i % 10 == 3))
+         geoidPts[i].changeDatum(nar);
+   }
+   geoidPts[5].makeNan();
+   vector<double> offsets(GEOID_COUNT);
+   ossimGeoidManager::instance()->offsetsFromEllipsoid(&geoidPts.front(), &offsets.front(),
+                                                       GEOID_COUNT);
+   for (ossim_uint32 i = 0; (i < GEOID_COUNT) && (errors < 10); ++i)
+   {
+      double offset = ossimGeoidManager::instance()->offsetFromEllipsoid(geoidPts[i]);
+      if ( !same(offset, offsets[i]) && !(fabs(offset - offsets[i]) < 1.0e-9) )
+      {
+         cout << "geoid offset " << i << " is " << offsets[i] << " expected " << offset << endl;
+         ++errors;
+      }
+   }
+
+   db = 0;
+   dir.dirCat(".*").wildcardRemove();
+   dir.remove();
+
+   cout << "ossim-batch-elevation-test: " << (errors ? "FAILED" : "PASSED") << endl;
+   return errors ? 1 : 0;
+}
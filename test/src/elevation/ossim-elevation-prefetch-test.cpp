@@ -0,0 +1,266 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Description: Test app for ossimElevManager::prefetch.  Writes two adjacent DEM images, loads
+// them as an image elevation database and checks prefetching a footprint opens just the cells
+// under it, without any height query from the caller.  Then renders an RPC image over both
+// cells and checks ossimImageRenderer::prefetchElevation and the sequencer's look ahead open the
+// cell under the next tile, and only when prefetching is enabled.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/base/ossimArgumentParser.h>
+#include <ossim/base/ossimFilename.h>
+#include <ossim/base/ossimGpt.h>
+#include <ossim/base/ossimGrect.h>
+#include <ossim/elevation/ossimElevManager.h>
+#include <ossim/elevation/ossimImageElevationDatabase.h>
+#include <ossim/imaging/ossimImageData.h>
+#include <ossim/imaging/ossimImageGeometry.h>
+#include <ossim/imaging/ossimImageRenderer.h>
+#include <ossim/imaging/ossimImageSourceSequencer.h>
+#include <ossim/imaging/ossimMemoryImageSource.h>
+#include <ossim/imaging/ossimTiffWriter.h>
+#include <ossim/init/ossimInit.h>
+#include <ossim/projection/ossimEquDistCylProjection.h>
+#include <ossim/projection/ossimRpcModel.h>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+static const ossim_uint32 DEM_SIZE = 51;
+static const double       DEM_SPAN = 0.1; // degrees
+static const double       ORIGIN_LAT = 38.0;
+static const double       ORIGIN_LON = -77.0;
+
+static bool writeDem(const ossimFilename& file, double ulLat, double ulLon)
+{
+   ossimRefPtr<ossimImageData> dem =
+      new ossimImageData(0, OSSIM_FLOAT32, 1, DEM_SIZE, DEM_SIZE);
+   dem->initialize();
+   ossim_float32* buf = static_cast<ossim_float32*>(dem->getBuf(0));
+   for (ossim_uint32 i = 0; i < DEM_SIZE*DEM_SIZE; ++i)
+      buf[i] = (ossim_float32)(100.0 + i % 37);
+   dem->validate();
+
+   ossimRefPtr<ossimEquDistCylProjection> proj = new ossimEquDistCylProjection();
+   proj->setUlTiePoints(ossimGpt(ulLat, ulLon));
+   proj->setDecimalDegreesPerPixel(ossimDpt(DEM_SPAN/(DEM_SIZE - 1), DEM_SPAN/(DEM_SIZE - 1)));
+   proj->setElevationLookupFlag(false);
+   ossimRefPtr<ossimImageGeometry> geom = new ossimImageGeometry(0, proj.get());
+   geom->setImageSize(ossimIpt(DEM_SIZE, DEM_SIZE));
+
+   ossimRefPtr<ossimMemoryImageSource> source = new ossimMemoryImageSource();
+   source->setImage(dem);
+   source->setImageGeometry(geom.get());
+   ossimRefPtr<ossimTiffWriter> writer = new ossimTiffWriter();
+   writer->connectMyInputTo(0, source.get());
+   writer->setFilename(file);
+   writer->setWriteOverviewFlag(false);
+   bool result = writer->execute();
+   writer->disconnect();
+   return result;
+}
+
+/** Replaces the manager's databases with one freshly opened on dir, so no cell is open. */
+static ossimRefPtr<ossimImageElevationDatabase> openDatabase(const ossimFilename& dir)
+{
+   ossimElevManager* mgr = ossimElevManager::instance();
+   mgr->clear();
+   ossimRefPtr<ossimImageElevationDatabase> db = new ossimImageElevationDatabase();
+   if ( db->open(dir) )
+   {
+      mgr->addDatabase(db.get(), true);
+   }
+   else
+   {
+      db = 0;
+   }
+   return db;
+}
+
+/** @return true if file is one of the cells open in db. */
+static bool isOpen(ossimImageElevationDatabase* db, const ossimString& file)
+{
+   vector<ossimFilename> open;
+   db->getOpenCellList(open);
+   for (ossim_uint32 i = 0; i < open.size(); ++i)
+   {
+      if ( open[i].file() == file )
+         return true;
+   }
+   return false;
+}
+
+/**
+ * Image over both DEM cells with a simple RPC model, which is affected by elevation, rendered
+ * to a geographic view of two 50 pixel tiles: tile 0 over the west cell, tile 1 over the east.
+ */
+static ossimRefPtr<ossimImageRenderer> createRenderer()
+{
+   ossimRefPtr<ossimImageData> image = new ossimImageData(0, OSSIM_UINT8, 1, 200, 100);
+   image->initialize();
+   image->fill(1.0);
+
+   vector<double> lineNum(20, 0.0), lineDen(20, 0.0), sampNum(20, 0.0), sampDen(20, 0.0);
+   lineNum[2] = -1.0;
+   sampNum[1] = 1.0;
+   lineDen[0] = 1.0;
+   sampDen[0] = 1.0;
+   ossimRefPtr<ossimRpcModel> rpc = new ossimRpcModel();
+   rpc->setAttributes(100.0, 50.0, 100.0, 50.0,
+                      ORIGIN_LAT + DEM_SPAN/2, ORIGIN_LON + DEM_SPAN, 100.0,
+                      DEM_SPAN/2, DEM_SPAN, 500.0,
+                      sampNum, sampDen, lineNum, lineDen, ossimRpcModel::B, false);
+   ossimRefPtr<ossimImageGeometry> geom = new ossimImageGeometry(0, rpc.get());
+   geom->setImageSize(ossimIpt(200, 100));
+
+   ossimRefPtr<ossimMemoryImageSource> source = new ossimMemoryImageSource();
+   source->setImage(image);
+   source->setImageGeometry(geom.get());
+
+   ossimRefPtr<ossimEquDistCylProjection> viewProj = new ossimEquDistCylProjection();
+   viewProj->setUlTiePoints(ossimGpt(ORIGIN_LAT + 0.07, ORIGIN_LON + 0.001));
+   viewProj->setDecimalDegreesPerPixel(ossimDpt(0.002, 0.002));
+   viewProj->setElevationLookupFlag(false);
+   ossimRefPtr<ossimImageGeometry> view = new ossimImageGeometry(0, viewProj.get());
+   view->setImageSize(ossimIpt(100, 50));
+
+   ossimRefPtr<ossimImageRenderer> renderer = new ossimImageRenderer();
+   renderer->connectMyInputTo(source.get());
+   renderer->setView(view.get());
+   return renderer;
+}
+
+int main(int argc, char *argv[])
+{
+   ossimArgumentParser ap(&argc, argv);
+   ossimInit::instance()->addOptions(ap);
+   ossimInit::instance()->initialize(ap);
+
+   ossimFilename dir = "ossim-elevation-prefetch-test-dem";
+   dir.createDirectory();
+   if ( !writeDem(dir.dirCat("west.tif"), ORIGIN_LAT + DEM_SPAN, ORIGIN_LON) ||
+        !writeDem(dir.dirCat("east.tif"), ORIGIN_LAT + DEM_SPAN, ORIGIN_LON + DEM_SPAN) )
+   {
+      cout << "could not write dem" << endl;
+      return 1;
+   }
+
+   ossimRefPtr<ossimImageElevationDatabase> db = new ossimImageElevationDatabase();
+   if ( !db->open(dir) )
+   {
+      cout << "could not open " << dir << endl;
+      return 1;
+   }
+   ossimElevManager* mgr = ossimElevManager::instance();
+   mgr->addDatabase(db.get(), true);
+
+   int errors = 0;
+   vector<ossimFilename> open;
+
+   // Disabled, nothing is queued.
+   mgr->setPrefetchFlag(false);
+   ossimGrect west(ORIGIN_LAT + 0.07, ORIGIN_LON + 0.02, ORIGIN_LAT + 0.03, ORIGIN_LON + 0.06);
+   if ( mgr->prefetch(west) )
+   {
+      cout << "prefetch queued while disabled" << endl;
+      ++errors;
+   }
+   mgr->setPrefetchFlag(true);
+
+   // Footprint inside the west cell.
+   if ( !mgr->prefetch(west) )
+   {
+      cout << "prefetch not queued" << endl;
+      ++errors;
+   }
+   mgr->waitForPrefetch();
+   db->getOpenCellList(open);
+   if ( (open.size() != 1) || (open[0].file() != "west.tif") )
+   {
+      cout << "west prefetch opened " << open.size() << " cells" << endl;
+      ++errors;
+   }
+
+   // Footprint across both.
+   ossimGrect both(ORIGIN_LAT + 0.07, ORIGIN_LON + 0.05, ORIGIN_LAT + 0.03, ORIGIN_LON + 0.15);
+   mgr->prefetch(both);
+   mgr->waitForPrefetch();
+   open.clear();
+   db->getOpenCellList(open);
+   if ( open.size() != 2 )
+   {
+      cout << "prefetch across both cells opened " << open.size() << " cells" << endl;
+      ++errors;
+   }
+
+   // Renderer, straight and through the sequencer:
+   ossimRefPtr<ossimImageRenderer> renderer = createRenderer();
+   const ossimIrect eastTile(50, 0, 99, 49);
+   db = openDatabase(dir);
+   mgr->setPrefetchFlag(false);
+   if ( renderer->prefetchElevation(eastTile) )
+   {
+      cout << "renderer prefetch queued while disabled" << endl;
+      ++errors;
+   }
+   mgr->setPrefetchFlag(true);
+   if ( !renderer->prefetchElevation(eastTile) )
+   {
+      cout << "renderer prefetch not queued" << endl;
+      ++errors;
+   }
+   mgr->waitForPrefetch();
+   if ( !isOpen(db.get(), "east.tif") || isOpen(db.get(), "west.tif") )
+   {
+      cout << "renderer prefetch did not open just the east cell" << endl;
+      ++errors;
+   }
+
+   ossimRefPtr<ossimImageSourceSequencer> sequencer = new ossimImageSourceSequencer();
+   sequencer->connectMyInputTo(renderer.get());
+   sequencer->initialize();
+   sequencer->setTileSize(ossimIpt(50, 50));
+   sequencer->setAreaOfInterest(ossimIrect(0, 0, 99, 49));
+
+   // Disabled, getting tile 0 leaves the east cell closed:
+   db = openDatabase(dir);
+   mgr->setPrefetchFlag(false);
+   sequencer->setToStartOfSequence();
+   sequencer->getNextTile();
+   mgr->waitForPrefetch();
+   if ( isOpen(db.get(), "east.tif") )
+   {
+      cout << "sequencer opened the east cell while disabled" << endl;
+      ++errors;
+   }
+
+   // Enabled, getting tile 0 loads the cell under tile 1:
+   db = openDatabase(dir);
+   mgr->setPrefetchFlag(true);
+   sequencer->setToStartOfSequence();
+   sequencer->getNextTile();
+   mgr->waitForPrefetch();
+   if ( !isOpen(db.get(), "east.tif") )
+   {
+      cout << "sequencer did not prefetch the east cell" << endl;
+      ++errors;
+   }
+
+   sequencer->disconnect();
+   sequencer = 0;
+   renderer = 0;
+   mgr->setPrefetchFlag(false);
+   mgr->clear();
+   db = 0;
+   dir.dirCat(".*").wildcardRemove();
+   dir.remove();
+
+   cout << "ossim-elevation-prefetch-test: " << (errors ? "FAILED" : "PASSED") << endl;
+   return errors ? 1 : 0;
+}
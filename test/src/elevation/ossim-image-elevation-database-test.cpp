@@ -0,0 +1,161 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Description: Test app for the ossimImageElevationDatabase cell map.  Writes DEM images in a
+// directory tree and checks that the elev_cell_map.kwl written on open is read back without
+// being rewritten, that a DEM added to a nested directory or removed is picked up on the next
+// open, and that no temporary map file is left behind.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/base/ossimArgumentParser.h>
+#include <ossim/base/ossimDate.h>
+#include <ossim/base/ossimDirectory.h>
+#include <ossim/base/ossimFilename.h>
+#include <ossim/base/ossimGpt.h>
+#include <ossim/base/ossimKeywordlist.h>
+#include <ossim/elevation/ossimImageElevationDatabase.h>
+#include <ossim/imaging/ossimImageData.h>
+#include <ossim/imaging/ossimImageGeometry.h>
+#include <ossim/imaging/ossimMemoryImageSource.h>
+#include <ossim/imaging/ossimTiffWriter.h>
+#include <ossim/init/ossimInit.h>
+#include <ossim/projection/ossimEquDistCylProjection.h>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+static const ossim_uint32 DEM_SIZE   = 21;
+static const double       DEM_SPAN   = 0.1; // degrees
+static const double       ORIGIN_LAT = 38.0;
+static const double       ORIGIN_LON = -77.0;
+
+static int errors = 0;
+
+static void check(bool passed, const char* what)
+{
+   if ( !passed )
+   {
+      cout << "FAILED: " << what << endl;
+      ++errors;
+   }
+}
+
+/** Writes a DEM whose upper left corner is col DEM spans east of the origin. */
+static bool writeDem(const ossimFilename& file, int col)
+{
+   ossimRefPtr<ossimImageData> dem = new ossimImageData(0, OSSIM_FLOAT32, 1, DEM_SIZE, DEM_SIZE);
+   dem->initialize();
+   dem->fill( 100.0 + col );
+
+   ossimRefPtr<ossimEquDistCylProjection> proj = new ossimEquDistCylProjection();
+   proj->setUlTiePoints(ossimGpt(ORIGIN_LAT + DEM_SPAN, ORIGIN_LON + col*DEM_SPAN));
+   proj->setDecimalDegreesPerPixel(ossimDpt(DEM_SPAN/(DEM_SIZE - 1), DEM_SPAN/(DEM_SIZE - 1)));
+   proj->setElevationLookupFlag(false);
+   ossimRefPtr<ossimImageGeometry> geom = new ossimImageGeometry(0, proj.get());
+   geom->setImageSize(ossimIpt(DEM_SIZE, DEM_SIZE));
+
+   ossimRefPtr<ossimMemoryImageSource> source = new ossimMemoryImageSource();
+   source->setImage(dem);
+   source->setImageGeometry(geom.get());
+   ossimRefPtr<ossimTiffWriter> writer = new ossimTiffWriter();
+   writer->connectMyInputTo(0, source.get());
+   writer->setFilename(file);
+   writer->setWriteOverviewFlag(false);
+   bool result = writer->execute();
+   writer->disconnect();
+   return result;
+}
+
+/** @return true if a freshly opened database on dir covers the center of DEM col. */
+static bool covers(const ossimFilename& dir, int col)
+{
+   ossimRefPtr<ossimImageElevationDatabase> db = new ossimImageElevationDatabase();
+   return db->open(dir) &&
+      db->pointHasCoverage(ossimGpt(ORIGIN_LAT + DEM_SPAN/2, ORIGIN_LON + (col + 0.5)*DEM_SPAN));
+}
+
+static ossim_int64 modTime(const ossimFilename& file)
+{
+   ossimLocalTm t;
+   return file.getTimes(0, &t, 0) ? (ossim_int64)t.getEpoc() : 0;
+}
+
+/** Modification times are kept in seconds. */
+static void nextSecond()
+{
+   std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+}
+
+int main(int argc, char *argv[])
+{
+   ossimArgumentParser ap(&argc, argv);
+   ossimInit::instance()->addOptions(ap);
+   ossimInit::instance()->initialize(ap);
+
+   ossimFilename dir    = "ossim-image-elevation-database-test-dem";
+   ossimFilename nested = dir.dirCat("nested");
+   ossimFilename map    = dir.dirCat("elev_cell_map.kwl");
+   nested.createDirectory(true);
+   if ( !writeDem(dir.dirCat("dem0.tif"), 0) )
+   {
+      cout << "could not write dem" << endl;
+      return 1;
+   }
+
+   // First open walks the tree and writes the map with the directory times:
+   check(covers(dir, 0), "first open covers dem0");
+   check(map.exists(), "map written on open");
+   ossimKeywordlist kwl(map);
+   check(kwl.getNumberOfKeysThatMatch("elev_cell[0-9]*\\.file") == 1, "map holds one cell");
+   check(kwl.getNumberOfKeysThatMatch("elev_dir[0-9]*\\.file") == 2,
+         "map holds the directory and the nested one");
+
+   // Nothing changed, read back without writing again:
+   ossim_int64 mapTime = modTime(map);
+   nextSecond();
+   check(covers(dir, 0), "reopen covers dem0");
+   check(modTime(map) == mapTime, "unchanged map not rewritten");
+
+   // A DEM added to the nested directory changes only its time:
+   if ( !writeDem(nested.dirCat("dem1.tif"), 1) )
+   {
+      cout << "could not write dem" << endl;
+      return 1;
+   }
+   check(covers(dir, 1), "nested dem1 picked up");
+   check(covers(dir, 0), "dem0 kept");
+   kwl.clear();
+   kwl.addFile(map);
+   check(kwl.getNumberOfKeysThatMatch("elev_cell[0-9]*\\.file") == 2, "map holds both cells");
+
+   // Removed DEMs drop out:
+   nextSecond();
+   ossimFilename(nested.dirCat("dem1.tif")).remove();
+   check(!covers(dir, 1), "removed dem1 dropped");
+   check(covers(dir, 0), "dem0 still kept");
+
+   // No temporary map file left:
+   std::vector<ossimFilename> files;
+   ossimDirectory d;
+   if ( d.open(dir) )
+   {
+      d.findAllFilesThatMatch(files, "elev_cell_map\\.kwl\\..*",
+                              ossimDirectory::OSSIM_DIR_FILES);
+   }
+   check(files.empty(), "no temporary map file left");
+
+   nested.dirCat(".*").wildcardRemove();
+   nested.remove();
+   dir.dirCat(".*").wildcardRemove();
+   dir.remove();
+
+   cout << "ossim-image-elevation-database-test: " << (errors ? "FAILED" : "PASSED") << endl;
+   return errors ? 1 : 0;
+}
@@ -0,0 +1,205 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Description: Test app for ossimFixedTileCache and ossimAppFixedTileCache.  Checks the least
+// recently used eviction order, that the maximum size bounds the total across caches in all
+// shards, and adds and gets tiles from several threads at once.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/base/ossimArgumentParser.h>
+#include <ossim/base/ossimIrect.h>
+#include <ossim/imaging/ossimAppFixedTileCache.h>
+#include <ossim/imaging/ossimFixedTileCache.h>
+#include <ossim/imaging/ossimImageData.h>
+#include <ossim/init/ossimInit.h>
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+static const ossim_int32 TILE_SIZE   = 64;
+static const ossim_int32 NUM_TILES_X = 16;
+static const ossim_uint32 TILE_BYTES = TILE_SIZE * TILE_SIZE;
+static const ossimIrect REGION(0, 0, TILE_SIZE * NUM_TILES_X - 1, TILE_SIZE * NUM_TILES_X - 1);
+
+static std::atomic<int> g_failures(0);
+
+static void check(bool passed, const char* what)
+{
+   if (!passed)
+   {
+      std::cout << "FAILED: " << what << std::endl;
+      ++g_failures;
+   }
+}
+
+static ossimIpt tileOrigin(ossim_int32 tileIdx)
+{
+   return ossimIpt((tileIdx % NUM_TILES_X) * TILE_SIZE, (tileIdx / NUM_TILES_X) * TILE_SIZE);
+}
+
+static ossimRefPtr<ossimImageData> makeTile(ossim_int32 tileIdx)
+{
+   ossimIpt origin = tileOrigin(tileIdx);
+   ossimRefPtr<ossimImageData> tile = new ossimImageData(0, OSSIM_UINT8, 1, TILE_SIZE, TILE_SIZE);
+   tile->setImageRectangle(ossimIrect(origin.x, origin.y,
+                                      origin.x + TILE_SIZE - 1, origin.y + TILE_SIZE - 1));
+   tile->initialize();
+   tile->fill((double)(tileIdx % 250 + 1));
+   return tile;
+}
+
+static bool isTile(const ossimRefPtr<ossimImageData>& tile, ossim_int32 tileIdx)
+{
+   return tile.valid() && (tile->getOrigin() == tileOrigin(tileIdx)) &&
+      (tile->getPix(0) == (double)(tileIdx % 250 + 1));
+}
+
+/** A full cache drops the tile that was used last longest ago. */
+static void testLruOrder()
+{
+   ossimRefPtr<ossimFixedTileCache> cache = new ossimFixedTileCache;
+   cache->setRect(REGION, ossimIpt(TILE_SIZE, TILE_SIZE));
+   cache->setMaxCacheSize(4 * TILE_BYTES);
+
+   for (ossim_int32 idx = 0; idx < 4; ++idx)
+      cache->addTile(makeTile(idx));
+
+   // Touch 0 and 2 so that 1 then 3 are the oldest:
+   check(isTile(cache->getTile(tileOrigin(0)), 0), "lru get 0");
+   check(isTile(cache->getTile(tileOrigin(2)), 2), "lru get 2");
+
+   cache->addTile(makeTile(4));
+   check(!cache->getTile(tileOrigin(1)).valid(), "lru evicts 1 first");
+   check(cache->getTile(tileOrigin(3)).valid(), "lru keeps 3");
+
+   cache->addTile(makeTile(5));
+   check(!cache->getTile(tileOrigin(0)).valid(), "lru evicts 0 second");
+   check(isTile(cache->getTile(tileOrigin(2)), 2), "lru keeps 2");
+   check(isTile(cache->getTile(tileOrigin(4)), 4), "lru keeps 4");
+   check(isTile(cache->getTile(tileOrigin(5)), 5), "lru keeps 5");
+   check(cache->getCacheSize() <= 4 * TILE_BYTES, "lru cache size");
+}
+
+/** The maximum bounds the total of the caches in every shard. */
+static void testSizeBound()
+{
+   const ossim_uint32 NUM_CACHES = 32;
+   const ossim_uint32 MAX_SIZE   = 64 * TILE_BYTES;
+
+   ossimAppFixedTileCache* appCache = ossimAppFixedTileCache::instance();
+   appCache->setMaxCacheSize(MAX_SIZE);
+   const ossim_uint64 startSize = appCache->getCurrentCacheSize();
+
+   std::vector<ossimAppFixedTileCache::ossimAppFixedCacheId> ids;
+   for (ossim_uint32 idx = 0; idx < NUM_CACHES; ++idx)
+      ids.push_back(appCache->newTileCache(REGION, ossimIpt(TILE_SIZE, TILE_SIZE)));
+
+   // Filling one cache stops at the maximum:
+   for (ossim_int32 idx = 0; idx < NUM_TILES_X * NUM_TILES_X; ++idx)
+      appCache->addTile(ids[0], makeTile(idx));
+   check(appCache->getCurrentCacheSize() - startSize <= MAX_SIZE,
+         "one cache holds no more than the maximum");
+
+   // Filling all of them stops at the maximum:
+   for (ossim_int32 idx = 0; idx < NUM_TILES_X * NUM_TILES_X; ++idx)
+   {
+      for (ossim_uint32 cacheIdx = 0; cacheIdx < NUM_CACHES; ++cacheIdx)
+      {
+         appCache->addTile(ids[cacheIdx], makeTile(idx));
+         if (appCache->getCurrentCacheSize() > MAX_SIZE)
+         {
+            check(false, "total over the maximum");
+            idx = NUM_TILES_X * NUM_TILES_X;
+            break;
+         }
+      }
+   }
+
+   for (ossim_uint32 idx = 0; idx < NUM_CACHES; ++idx)
+      appCache->deleteCache(ids[idx]);
+   check(appCache->getCurrentCacheSize() == startSize, "deleted caches leave the total");
+}
+
+static void getAndAddTiles(ossimAppFixedTileCache::ossimAppFixedCacheId ownId,
+                           ossimAppFixedTileCache::ossimAppFixedCacheId sharedId,
+                           ossim_uint32 seed)
+{
+   ossimAppFixedTileCache* appCache = ossimAppFixedTileCache::instance();
+   for (ossim_uint32 i = 0; i < 20000; ++i)
+   {
+      seed = seed * 1103515245 + 12345;
+      ossim_int32 tileIdx = (seed >> 16) % (NUM_TILES_X * NUM_TILES_X);
+      ossimAppFixedTileCache::ossimAppFixedCacheId id = (i % 2) ? ownId : sharedId;
+
+      // addTile returns nothing when another thread added the tile first:
+      ossimRefPtr<ossimImageData> tile = appCache->getTile(id, tileOrigin(tileIdx));
+      if (!tile.valid())
+      {
+         tile = appCache->addTile(id, makeTile(tileIdx));
+      }
+      if (tile.valid() && !isTile(tile, tileIdx))
+      {
+         ++g_failures;
+      }
+   }
+}
+
+/** Gets and adds from several threads into their own caches and one they share. */
+static void testConcurrentAccess()
+{
+   const ossim_uint32 NUM_THREADS = 8;
+   const ossim_uint32 MAX_SIZE    = 96 * TILE_BYTES;
+
+   ossimAppFixedTileCache* appCache = ossimAppFixedTileCache::instance();
+   appCache->setMaxCacheSize(MAX_SIZE);
+   const ossim_uint64 startSize = appCache->getCurrentCacheSize();
+
+   ossimAppFixedTileCache::ossimAppFixedCacheId sharedId =
+      appCache->newTileCache(REGION, ossimIpt(TILE_SIZE, TILE_SIZE));
+   std::vector<ossimAppFixedTileCache::ossimAppFixedCacheId> ids;
+   std::vector<std::thread> threads;
+   for (ossim_uint32 idx = 0; idx < NUM_THREADS; ++idx)
+      ids.push_back(appCache->newTileCache(REGION, ossimIpt(TILE_SIZE, TILE_SIZE)));
+   for (ossim_uint32 idx = 0; idx < NUM_THREADS; ++idx)
+      threads.push_back(std::thread(getAndAddTiles, ids[idx], sharedId, idx + 1));
+   for (ossim_uint32 idx = 0; idx < NUM_THREADS; ++idx)
+      threads[idx].join();
+
+   // Only one thread evicts at a time and the others carry on, so racing adds can push the
+   // total past the maximum by no more than a tile per cache:
+   check(appCache->getCurrentCacheSize() - startSize <= MAX_SIZE + (NUM_THREADS + 1) * TILE_BYTES,
+         "concurrent total over the maximum");
+
+   for (ossim_uint32 idx = 0; idx < NUM_THREADS; ++idx)
+      appCache->deleteCache(ids[idx]);
+   appCache->deleteCache(sharedId);
+   check(appCache->getCurrentCacheSize() == startSize, "concurrent deleted caches leave the total");
+}
+
+int main(int argc, char *argv[])
+{
+   ossimArgumentParser ap(&argc, argv);
+   ossimInit::instance()->addOptions(ap);
+   ossimInit::instance()->initialize(ap);
+
+   testLruOrder();
+   testSizeBound();
+   testConcurrentAccess();
+
+   int status = 0;
+   if (g_failures.load())
+   {
+      std::cout << "FAILED: " << g_failures.load() << " checks" << std::endl;
+      status = 1;
+   }
+   else
+   {
+      std::cout << "PASSED" << std::endl;
+   }
+   return status;
+}
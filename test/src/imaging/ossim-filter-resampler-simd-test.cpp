@@ -0,0 +1,245 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Description: Test app for the ossimFilterResampler SSE2/AVX2 kernels.  Resamples random tiles
+// with nulls at every SIMD level the CPU has, for each scalar type and kernel width, through
+// a rotated mapping that runs off the input tile so edge pixels take the scalar path.  Checks
+// each result is within 5e-5 relative of a double precision reference, and that types without
+// vectorized kernels are unchanged.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/base/ossimArgumentParser.h>
+#include <ossim/base/ossimDpt.h>
+#include <ossim/base/ossimIpt.h>
+#include <ossim/base/ossimScalarTypeLut.h>
+#include <ossim/base/ossimString.h>
+#include <ossim/imaging/ossimFilterResampler.h>
+#include <ossim/imaging/ossimImageData.h>
+#include <ossim/init/ossimInit.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+
+using namespace std;
+
+// Odd input sizes so vectors run partly off the right edge.
+static const ossim_uint32 IN_WIDTH   = 67;
+static const ossim_uint32 IN_HEIGHT  = 53;
+static const ossim_uint32 OUT_SIZE   = 64;
+static const ossim_uint32 BANDS      = 3;
+static const ossimIpt     IN_ORIGIN(1000, 2000);
+static const double       MAX_ERROR  = 5e-5;
+static const double       NULL_RATIO = 0.1;
+
+// Kernel widths 2, 4, 4, 6 and 8 taps, rows padded to 4, 4, 4, 8 and 8:
+static const char* FILTERS[] = { "bilinear", "cubic", "gaussian", "lanczos", "sinc" };
+static const ossim_uint32 NUM_FILTERS = 5;
+
+// Input pixels per output pixel, and rotation:
+static const double STEPS[]  = { 1.23, 0.71 };
+static const double ANGLES[] = { 0.0, 0.13 };
+
+static int errors = 0;
+
+static const char* levelName(ossimFilterResampler::SimdLevel level)
+{
+   return (level == ossimFilterResampler::SIMD_AVX2) ? "avx2" :
+      (level == ossimFilterResampler::SIMD_SSE2) ? "sse2" : "none";
+}
+
+template <class T>
+static ossimRefPtr<ossimImageData> makeInput(ossimScalarType scalarType, std::mt19937& rng)
+{
+   ossimRefPtr<ossimImageData> tile =
+      new ossimImageData(0, scalarType, BANDS, IN_WIDTH, IN_HEIGHT);
+   tile->setOrigin(IN_ORIGIN);
+   tile->initialize();
+   std::uniform_real_distribution<double> unit(0.0, 1.0);
+   for (ossim_uint32 band = 0; band < BANDS; ++band)
+   {
+      // Float types default to their full range:
+      const double minPix = std::max(tile->getMinPix(band), -30000.0);
+      const double maxPix = std::min(tile->getMaxPix(band), 60000.0);
+      T* buf = static_cast<T*>(tile->getBuf(band));
+      for (ossim_uint32 i = 0; i < IN_WIDTH * IN_HEIGHT; ++i)
+      {
+         buf[i] = (unit(rng) < NULL_RATIO) ? static_cast<T>(tile->getNullPix(band)) :
+            static_cast<T>(minPix + unit(rng) * (maxPix - minPix));
+      }
+   }
+   tile->validate();
+   return tile;
+}
+
+/** Output tile with the null, min and max of like. */
+static ossimRefPtr<ossimImageData> makeOutput(ossimScalarType scalarType,
+                                              const ossimImageData* like)
+{
+   ossimRefPtr<ossimImageData> tile =
+      new ossimImageData(0, scalarType, BANDS, OUT_SIZE, OUT_SIZE);
+   tile->initialize();
+   for (ossim_uint32 band = 0; band < BANDS; ++band)
+   {
+      tile->setNullPix(like->getNullPix(band), band);
+      tile->setMinPix(like->getMinPix(band), band);
+      tile->setMaxPix(like->getMaxPix(band), band);
+   }
+   return tile;
+}
+
+static void resample(ossimFilterResampler& resampler, const ossimRefPtr<ossimImageData>& input,
+                     ossimRefPtr<ossimImageData>& output, double step, double angle)
+{
+   // Starts above and left of the input and runs off its right and bottom edges:
+   const ossimDpt ul(IN_ORIGIN.x - 2.6, IN_ORIGIN.y - 3.1);
+   const ossimDpt dx(step * cos(angle), step * sin(angle));
+   const ossimDpt dy(-step * sin(angle), step * cos(angle));
+   const ossimDpt ur = ul + dx * (OUT_SIZE - 1.0);
+   output->makeBlank();
+   resampler.resample(input, output, ul, ur, dy, dy, ossimDpt(OUT_SIZE, OUT_SIZE));
+}
+
+/** Compares each level against a double precision run, or with SIMD_NONE if exact. */
+template <class T>
+static void testType(ossimScalarType scalarType, bool exact, std::mt19937& rng)
+{
+   const ossimString typeName = ossimScalarTypeLut::instance()->getEntryString(scalarType);
+   ossimRefPtr<ossimImageData> input = makeInput<T>(scalarType, rng);
+
+   // Same pixels in double:
+   ossimRefPtr<ossimImageData> input64 =
+      new ossimImageData(0, OSSIM_FLOAT64, BANDS, IN_WIDTH, IN_HEIGHT);
+   input64->setOrigin(IN_ORIGIN);
+   input64->initialize();
+   for (ossim_uint32 band = 0; band < BANDS; ++band)
+   {
+      const T* src = static_cast<const T*>(input->getBuf(band));
+      ossim_float64* dst = input64->getDoubleBuf(band);
+      for (ossim_uint32 i = 0; i < IN_WIDTH * IN_HEIGHT; ++i)
+         dst[i] = src[i];
+   }
+   input64->validate();
+
+   ossimRefPtr<ossimImageData> reference = makeOutput(OSSIM_FLOAT64, input.get());
+   ossimRefPtr<ossimImageData> scalar = makeOutput(scalarType, input.get());
+   ossimRefPtr<ossimImageData> output = makeOutput(scalarType, input.get());
+   const ossim_uint32 COUNT = OUT_SIZE * OUT_SIZE;
+
+   for (ossim_uint32 f = 0; f < NUM_FILTERS; ++f)
+   {
+      for (ossim_uint32 s = 0; s < 2; ++s)
+      {
+         const double step  = STEPS[s];
+         const double angle = ANGLES[s];
+         ossimFilterResampler resampler;
+         resampler.setFilterType(FILTERS[f]);
+
+         resampler.setSimdLevel(ossimFilterResampler::SIMD_NONE);
+         resample(resampler, input64, reference, step, angle);
+         resample(resampler, input, scalar, step, angle);
+
+         // The scalar path truncates the double result:
+         for (ossim_uint32 band = 0; band < BANDS; ++band)
+         {
+            const ossim_float64* ref = reference->getDoubleBuf(band);
+            const T* buf = static_cast<const T*>(scalar->getBuf(band));
+            ossim_uint32 bad = 0;
+            for (ossim_uint32 i = 0; i < COUNT; ++i)
+            {
+               if (buf[i] != static_cast<T>(ref[i]))
+                  ++bad;
+            }
+            if (bad)
+            {
+               cout << "FAILED: " << typeName << " " << FILTERS[f] << " step " << step
+                    << ": " << bad << " scalar pixels differ from the double reference" << endl;
+               ++errors;
+            }
+         }
+
+         for (ossim_uint32 level = ossimFilterResampler::SIMD_SSE2;
+              level <= (ossim_uint32)ossimFilterResampler::getMaxSimdLevel(); ++level)
+         {
+            resampler.setSimdLevel((ossimFilterResampler::SimdLevel)level);
+            resample(resampler, input, output, step, angle);
+
+            for (ossim_uint32 band = 0; band < BANDS; ++band)
+            {
+               const ossim_float64* ref = reference->getDoubleBuf(band);
+               const T* expected = static_cast<const T*>(scalar->getBuf(band));
+               const T* buf = static_cast<const T*>(output->getBuf(band));
+               const double nullPix = output->getNullPix(band);
+               const double minPix  = output->getMinPix(band);
+               const double maxPix  = output->getMaxPix(band);
+               ossim_uint32 bad = 0;
+               for (ossim_uint32 i = 0; i < COUNT; ++i)
+               {
+                  if (exact || (ref[i] == nullPix))
+                  {
+                     if (buf[i] != expected[i])
+                        ++bad;
+                  }
+                  else
+                  {
+                     // Any value within the bound, clamped and truncated as the output is:
+                     const double e  = MAX_ERROR * fabs(ref[i]);
+                     const double lo = std::max(minPix, std::min(maxPix, ref[i] - e));
+                     const double hi = std::max(minPix, std::min(maxPix, ref[i] + e));
+                     if ((buf[i] < static_cast<T>(lo)) || (buf[i] > static_cast<T>(hi)))
+                        ++bad;
+                  }
+               }
+               if (bad)
+               {
+                  cout << "FAILED: " << typeName << " " << FILTERS[f] << " step " << step
+                       << " " << levelName((ossimFilterResampler::SimdLevel)level) << ": " << bad
+                       << " pixels outside " << MAX_ERROR << " of the scalar path" << endl;
+                  ++errors;
+               }
+            }
+         }
+      }
+   }
+}
+
+int main(int argc, char *argv[])
+{
+   ossimArgumentParser ap(&argc, argv);
+   ossimInit::instance()->addOptions(ap);
+   ossimInit::instance()->initialize(ap);
+
+   cout << "SIMD level: " << levelName(ossimFilterResampler::getMaxSimdLevel()) << endl;
+
+   {
+      // Levels are capped at what the CPU has:
+      ossimFilterResampler resampler;
+      resampler.setSimdLevel(ossimFilterResampler::SIMD_AVX2);
+      if (resampler.getSimdLevel() != ossimFilterResampler::getMaxSimdLevel())
+      {
+         cout << "FAILED: SIMD level not capped" << endl;
+         ++errors;
+      }
+   }
+
+   std::mt19937 rng(20261017);
+   for (ossim_uint32 pass = 0; pass < 4; ++pass)
+   {
+      // Vectorized:
+      testType<ossim_uint8>(OSSIM_UINT8, false, rng);
+      testType<ossim_uint16>(OSSIM_UINT16, false, rng);
+      testType<ossim_uint16>(OSSIM_USHORT11, false, rng);
+
+      // Scalar only, so every level is the same:
+      testType<ossim_sint16>(OSSIM_SINT16, true, rng);
+      testType<ossim_float32>(OSSIM_FLOAT32, true, rng);
+   }
+
+   cout << "ossim-filter-resampler-simd-test: " << (errors ? "FAILED" : "PASSED") << endl;
+   return errors ? 1 : 0;
+}
@@ -29,6 +29,7 @@
 #include <ossim/imaging/ossimImageHandlerRegistry.h>
 #include <ossim/init/ossimInit.h>
 #include <ossim/support_data/ImageHandlerStateRegistry.h>
+#include <ossim/support_data/ImageHandlerStateStore.h>
 // Put your includes here:
 
 // System includes:
@@ -48,6 +49,7 @@ int main(int argc, char *argv[])
    ap.getApplicationUsage()->addCommandLineOption("--max-time-to-open-state","specify the time in seconds.  Example: 1.234");
    ap.getApplicationUsage()->addCommandLineOption("--min-speedup","specify the minumum speedup for state open versus normal open.  For min-speedup = 2.5 means that we must be at least 2.5 times faster with the state");
    ap.getApplicationUsage()->addCommandLineOption("--geom-test","Will enable geometry tests.  Will load the file the with and without the state and make sure the geometry remains the same");
+   ap.getApplicationUsage()->addCommandLineOption("--store-test","<directory> Will save the state to a state store in directory, load it back and open the image from it");
    std::string ts1;
    ossimArgumentParser::ossimParameter sp1(ts1);
 
@@ -56,6 +58,7 @@ int main(int argc, char *argv[])
       ossim_float64 maxTimeForStateOpen = -1;
       ossim_float64 minSpeedup = 0.0;
       bool geomTestFlag = false;
+      ossimFilename storeDir;
    //   argumentParser.getApplicationUsage()->addCommandLineOption("--random-seed", "value to use as the seed for the random elevation post generator");
       if (ap.argc() == 1 || ap.read("-h") ||
           ap.read("--help"))
@@ -75,6 +78,10 @@ int main(int argc, char *argv[])
       {
          geomTestFlag = true;
       }
+      if(ap.read("--store-test", sp1))
+      {
+         storeDir = ts1;
+      }
       if(ap.argc() == 2)
       {
 
@@ -122,6 +129,32 @@ int main(int argc, char *argv[])
                   }
                }
 
+               if(!storeDir.empty())
+               {
+                  ossim::ImageHandlerStateStore store(storeDir);
+                  ossimString id = ossimString(ap[1]) + "_e0";
+                  if(!store.save(id, *state))
+                  {
+                     throw ossimException(ossimString("Unable to save state to ") + storeDir);
+                  }
+                  std::shared_ptr<ossim::ImageHandlerState> storedState = store.load(id);
+                  store.remove(id);
+                  if(!storedState)
+                  {
+                     throw ossimException(ossimString("Unable to load state from ") + storeDir);
+                  }
+                  if(store.load(id + "_missing"))
+                  {
+                     throw ossimException("Loaded a state that was never saved");
+                  }
+                  ossimRefPtr<ossimImageHandler> hStored = ossimImageHandlerRegistry::instance()->open(storedState);
+                  if(!hStored)
+                  {
+                     throw ossimException(ossimString("Unable to open image from stored state")+ ap[1]);
+                  }
+                  std::cout << "store-test: passed\n";
+               }
+
                if(geomTestFlag)
                {
                   t1 = ossimTimer::instance()->tick();
@@ -0,0 +1,195 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Description: Test app for ossimOverviewSequencer.  Decimates 8 and 16 bit images containing
+// nulls single threaded, multithreaded and from an in memory level, and checks every output pixel
+// against a straight 2x2 box average.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/base/ossimArgumentParser.h>
+#include <ossim/base/ossimFilename.h>
+#include <ossim/base/ossimString.h>
+#include <ossim/imaging/ossimImageData.h>
+#include <ossim/imaging/ossimImageHandler.h>
+#include <ossim/imaging/ossimImageHandlerRegistry.h>
+#include <ossim/imaging/ossimMemoryImageSource.h>
+#include <ossim/imaging/ossimOverviewSequencer.h>
+#include <ossim/imaging/ossimTiffWriter.h>
+#include <ossim/init/ossimInit.h>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+
+// Odd sizes so the last row and column of tiles hang off the image.
+static const ossim_int32 WIDTH  = 701;
+static const ossim_int32 HEIGHT = 459;
+static const ossim_int32 TILE_SIZE = 64;
+
+template <class T>
+static T inputPixel(const ossimImageData* image, ossim_int32 x, ossim_int32 y)
+{
+   if ( (x >= WIDTH) || (y >= HEIGHT) )
+      return 0;
+   return static_cast<const T*>(image->getBuf(0))[y*WIDTH + x];
+}
+
+template <class T>
+static T expectedPixel(const ossimImageData* image, ossim_int32 x, ossim_int32 y)
+{
+   ossim_int64 sum = 0;
+   ossim_int64 count = 0;
+   for (ossim_int32 dy = 0; dy < 2; ++dy)
+   {
+      for (ossim_int32 dx = 0; dx < 2; ++dx)
+      {
+         T p = inputPixel<T>(image, 2*x + dx, 2*y + dy);
+         if (p != 0)
+         {
+            sum += p;
+            ++count;
+         }
+      }
+   }
+   return count ? static_cast<T>(sum/count) : 0;
+}
+
+template <class T>
+static int check(const char* name, const ossimImageData* image, ossimOverviewSequencer* seq)
+{
+   int errors = 0;
+   ossimIrect outputRect;
+   seq->getOutputImageRectangle(outputRect);
+   const ossim_uint32 TILES = seq->getNumberOfTiles();
+   for (ossim_uint32 i = 0; (i < TILES) && (errors < 10); ++i)
+   {
+      ossimRefPtr<ossimImageData> tile = seq->getNextTile();
+      if ( !tile.valid() || seq->hasError() )
+      {
+         cout << name << ": no tile " << i << endl;
+         ++errors;
+         continue;
+      }
+      ossimIrect rect = tile->getImageRectangle();
+      const T* buf = static_cast<const T*>(tile->getBuf(0));
+      for (ossim_int32 y = rect.ul().y; y <= rect.lr().y; ++y)
+      {
+         for (ossim_int32 x = rect.ul().x; x <= rect.lr().x; ++x)
+         {
+            if ( (x > outputRect.lr().x) || (y > outputRect.lr().y) )
+               continue;
+            T got = buf[(y - rect.ul().y)*rect.width() + (x - rect.ul().x)];
+            T expected = expectedPixel<T>(image, x, y);
+            if (got != expected)
+            {
+               cout << name << ": pixel " << x << "," << y << " is " << (ossim_int64)got
+                    << " expected " << (ossim_int64)expected << endl;
+               ++errors;
+               break;
+            }
+         }
+      }
+   }
+
+   // The retained level must match the tiles.
+   ossimRefPtr<ossimImageData> level = seq->getOutputLevel();
+   if (level.valid())
+   {
+      const T* buf = static_cast<const T*>(level->getBuf(0));
+      for (ossim_int32 y = 0; (y < (ossim_int32)level->getHeight()) && !errors; ++y)
+      {
+         for (ossim_int32 x = 0; x < (ossim_int32)level->getWidth(); ++x)
+         {
+            if (buf[y*level->getWidth() + x] != expectedPixel<T>(image, x, y))
+            {
+               cout << name << ": retained level differs at " << x << "," << y << endl;
+               ++errors;
+               break;
+            }
+         }
+      }
+   }
+   return errors;
+}
+
+template <class T>
+static int runTest(ossimScalarType scalar, T maxValue, const char* name)
+{
+   // Pseudo random pixels with about one in ten null.
+   ossimRefPtr<ossimImageData> image = new ossimImageData(0, scalar, 1, WIDTH, HEIGHT);
+   image->initialize();
+   image->setNullPix(0.0, 0);
+   image->setMinPix(1.0, 0);
+   image->setMaxPix(static_cast<double>(maxValue), 0);
+   T* buf = static_cast<T*>(image->getBuf(0));
+   ossim_uint32 seed = 12345;
+   for (ossim_int32 i = 0; i < WIDTH*HEIGHT; ++i)
+   {
+      seed = seed*1103515245 + 12345;
+      ossim_uint32 r = seed >> 8;
+      buf[i] = (r % 10 == 0) ? 0 : static_cast<T>(1 + (r % maxValue));
+   }
+   image->validate();
+
+   ossimFilename file = ossimString("ossim-overview-sequencer-test-") + name + ".tif";
+   ossimRefPtr<ossimMemoryImageSource> source = new ossimMemoryImageSource();
+   source->setImage(image);
+   ossimRefPtr<ossimTiffWriter> writer = new ossimTiffWriter();
+   writer->connectMyInputTo(0, source.get());
+   writer->setFilename(file);
+   writer->setWriteOverviewFlag(false);
+   writer->execute();
+   writer->disconnect();
+
+   ossimRefPtr<ossimImageHandler> ih = ossimImageHandlerRegistry::instance()->open(file);
+   if (!ih.valid())
+   {
+      cout << name << ": could not open " << file << endl;
+      return 1;
+   }
+
+   int errors = 0;
+   const ossim_uint32 THREADS[] = { 1, 4 };
+   for (ossim_uint32 t = 0; t < 2; ++t)
+   {
+      for (ossim_uint32 inMemory = 0; inMemory < 2; ++inMemory)
+      {
+         ossimRefPtr<ossimOverviewSequencer> seq = new ossimOverviewSequencer();
+         seq->setImageHandler(ih.get());
+         seq->setSourceLevel(0);
+         seq->setTileSize(ossimIpt(TILE_SIZE, TILE_SIZE));
+         seq->setNumberOfThreads(THREADS[t]);
+         if (inMemory)
+            seq->setInputLevel(image.get());
+         seq->setRetainOutputLevel(true);
+         seq->initialize();
+
+         ostringstream os;
+         os << name << " threads " << THREADS[t] << (inMemory ? " in memory" : " from file");
+         errors += check<T>(os.str().c_str(), image.get(), seq.get());
+      }
+   }
+
+   ih = 0;
+   file.remove();
+   return errors;
+}
+
+int main(int argc, char *argv[])
+{
+   ossimArgumentParser ap(&argc, argv);
+   ossimInit::instance()->addOptions(ap);
+   ossimInit::instance()->initialize(ap);
+
+   int errors = 0;
+   errors += runTest<ossim_uint8>(OSSIM_UINT8, ossim_uint8(255), "uint8");
+   errors += runTest<ossim_uint16>(OSSIM_UINT16, ossim_uint16(65535), "uint16");
+
+   cout << "ossim-overview-sequencer-test: " << (errors ? "FAILED" : "PASSED") << endl;
+   return errors ? 1 : 0;
+}
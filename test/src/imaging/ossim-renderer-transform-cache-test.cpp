@@ -0,0 +1,166 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Description: Test app for the ossimImageRenderer transform grid cache.  Renders the same view
+// tiles with the cache off and on, for two views, and checks the pixels are identical.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/base/ossimArgumentParser.h>
+#include <ossim/base/ossimRefreshEvent.h>
+#include <ossim/imaging/ossimImageData.h>
+#include <ossim/imaging/ossimImageGeometry.h>
+#include <ossim/imaging/ossimImageRenderer.h>
+#include <ossim/imaging/ossimMemoryImageSource.h>
+#include <ossim/init/ossimInit.h>
+#include <ossim/projection/ossimEquDistCylProjection.h>
+#include <ossim/projection/ossimUtmProjection.h>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+static const ossim_uint32 IMAGE_SIZE = 512;
+static const ossim_uint32 TILE_SIZE  = 64;
+
+static ossimRefPtr<ossimImageGeometry> createView(double metersPerPixel)
+{
+   ossimRefPtr<ossimUtmProjection> proj = new ossimUtmProjection(18);
+   proj->setHemisphere('N');
+   proj->setUlTiePoints(ossimGpt(38.0, -77.0));
+   proj->setMetersPerPixel(ossimDpt(metersPerPixel, metersPerPixel));
+   proj->setElevationLookupFlag(false);
+   return new ossimImageGeometry(0, proj.get());
+}
+
+static void render(ossimImageRenderer* renderer, vector< ossimRefPtr<ossimImageData> >& tiles)
+{
+   tiles.clear();
+   ossimIrect bounds = renderer->getBoundingRect();
+   for (ossim_int32 y = bounds.ul().y; y < bounds.ul().y + 4*(ossim_int32)TILE_SIZE; y += TILE_SIZE)
+   {
+      for (ossim_int32 x = bounds.ul().x; x < bounds.ul().x + 4*(ossim_int32)TILE_SIZE;
+           x += TILE_SIZE)
+      {
+         ossimIrect rect(x, y, x + TILE_SIZE - 1, y + TILE_SIZE - 1);
+         ossimRefPtr<ossimImageData> tile = renderer->getTile(rect);
+         tiles.push_back(tile.valid() ? (ossimImageData*)tile->dup() : 0);
+      }
+   }
+}
+
+static int compare(const char* name, const vector< ossimRefPtr<ossimImageData> >& a,
+                   const vector< ossimRefPtr<ossimImageData> >& b)
+{
+   int errors = 0;
+   for (ossim_uint32 i = 0; i < a.size(); ++i)
+   {
+      bool same = (a[i].valid() == b[i].valid());
+      if (same && a[i].valid())
+      {
+         same = (a[i]->getDataObjectStatus() == b[i]->getDataObjectStatus()) &&
+                (a[i]->getSizeInBytes() == b[i]->getSizeInBytes());
+         if (same && a[i]->getBuf() && b[i]->getBuf())
+            same = (memcmp(a[i]->getBuf(), b[i]->getBuf(), a[i]->getSizeInBytes()) == 0);
+      }
+      if (!same)
+      {
+         cout << name << ": tile " << i << " differs" << endl;
+         ++errors;
+      }
+   }
+   return errors;
+}
+
+int main(int argc, char *argv[])
+{
+   ossimArgumentParser ap(&argc, argv);
+   ossimInit::instance()->addOptions(ap);
+   ossimInit::instance()->initialize(ap);
+
+   // Gradient image on a geographic projection.
+   ossimRefPtr<ossimImageData> image =
+      new ossimImageData(0, OSSIM_UINT8, 1, IMAGE_SIZE, IMAGE_SIZE);
+   image->initialize();
+   ossim_uint8* buf = image->getUcharBuf();
+   for (ossim_uint32 y = 0; y < IMAGE_SIZE; ++y)
+      for (ossim_uint32 x = 0; x < IMAGE_SIZE; ++x)
+         buf[y*IMAGE_SIZE + x] = (ossim_uint8)(1 + ((x*3 + y*5) % 254));
+   image->validate();
+
+   ossimRefPtr<ossimEquDistCylProjection> inputProj = new ossimEquDistCylProjection();
+   inputProj->setUlTiePoints(ossimGpt(38.0, -77.0));
+   inputProj->setDecimalDegreesPerPixel(ossimDpt(0.00001, 0.00001));
+   inputProj->setElevationLookupFlag(false);
+   ossimRefPtr<ossimImageGeometry> inputGeom = new ossimImageGeometry(0, inputProj.get());
+   inputGeom->setImageSize(ossimIpt(IMAGE_SIZE, IMAGE_SIZE));
+
+   ossimRefPtr<ossimMemoryImageSource> source = new ossimMemoryImageSource();
+   source->setImage(image);
+   source->setImageGeometry(inputGeom.get());
+
+   ossimRefPtr<ossimImageRenderer> renderer = new ossimImageRenderer();
+   renderer->connectMyInputTo(source.get());
+
+   ossimRefPtr<ossimImageGeometry> view1 = createView(0.7);
+   ossimRefPtr<ossimImageGeometry> view2 = createView(1.3);
+
+   // Reference renders without the cache.
+   vector< ossimRefPtr<ossimImageData> > ref1, ref2, tiles;
+   renderer->setTransformCacheSize(0);
+   renderer->setView(view1.get());
+   render(renderer.get(), ref1);
+   renderer->setView(view2.get());
+   render(renderer.get(), ref2);
+
+   int errors = 0;
+   renderer->setTransformCacheSize(1024*1024);
+
+   // First pass fills the cache, later passes hit it, including after switching views.
+   renderer->setView(view1.get());
+   render(renderer.get(), tiles);
+   errors += compare("view 1 miss", ref1, tiles);
+   if (renderer->getTransformCacheBytes() == 0)
+   {
+      cout << "cache is empty after render" << endl;
+      ++errors;
+   }
+   render(renderer.get(), tiles);
+   errors += compare("view 1 hit", ref1, tiles);
+
+   renderer->setView(view2.get());
+   render(renderer.get(), tiles);
+   errors += compare("view 2 miss", ref2, tiles);
+   renderer->setView(view1.get());
+   render(renderer.get(), tiles);
+   errors += compare("view 1 hit after view 2", ref1, tiles);
+
+   // Refresh invalidates.
+   ossimRefreshEvent refresh(ossimRefreshEvent::REFRESH_GEOMETRY);
+   renderer->refreshEvent(refresh);
+   if (renderer->getTransformCacheBytes() != 0)
+   {
+      cout << "cache not cleared by refreshEvent" << endl;
+      ++errors;
+   }
+   render(renderer.get(), tiles);
+   errors += compare("view 1 after refresh", ref1, tiles);
+
+   // A tiny cache must stay within its limit.
+   renderer->setTransformCacheSize(2048);
+   render(renderer.get(), tiles);
+   errors += compare("view 1 small cache", ref1, tiles);
+   if (renderer->getTransformCacheBytes() > 2048)
+   {
+      cout << "cache over its limit: " << renderer->getTransformCacheBytes() << endl;
+      ++errors;
+   }
+
+   renderer->disconnect();
+   cout << "ossim-renderer-transform-cache-test: " << (errors ? "FAILED" : "PASSED") << endl;
+   return errors ? 1 : 0;
+}
@@ -0,0 +1,189 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Description: Test app for ossimTiffTileEncoder.  Writes the same image with ossimTiffWriter
+// compressing on the writing thread and on a thread pool, for each compression type and tile
+// layout, and checks both files read back the same.  Then encodes 16 bit tiles with a predictor
+// into a big endian file and checks they read back as written.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/base/ossimArgumentParser.h>
+#include <ossim/base/ossimFilename.h>
+#include <ossim/base/ossimString.h>
+#include <ossim/imaging/ossimImageData.h>
+#include <ossim/imaging/ossimImageHandler.h>
+#include <ossim/imaging/ossimImageHandlerRegistry.h>
+#include <ossim/imaging/ossimMemoryImageSource.h>
+#include <ossim/imaging/ossimTiffTileEncoder.h>
+#include <ossim/imaging/ossimTiffWriter.h>
+#include <ossim/init/ossimInit.h>
+#include <tiffio.h>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+// Odd sizes so the last row and column of tiles are partial.
+static const ossim_uint32 WIDTH  = 517;
+static const ossim_uint32 HEIGHT = 389;
+static const ossim_uint32 BANDS  = 3;
+
+static bool writeImage(ossimImageData* image, const ossimFilename& file,
+                       const char* compression, const char* imageType, ossim_uint32 threads)
+{
+   ossimRefPtr<ossimMemoryImageSource> source = new ossimMemoryImageSource();
+   source->setImage(image);
+   ossimRefPtr<ossimTiffWriter> writer = new ossimTiffWriter();
+   writer->connectMyInputTo(0, source.get());
+   writer->setFilename(file);
+   writer->setOutputImageType(imageType);
+   writer->setCompressionType(compression);
+   writer->setCompressionThreads(threads);
+   writer->setTileSize(ossimIpt(128, 128));
+   writer->setWriteOverviewFlag(false);
+   bool result = writer->execute();
+   writer->disconnect();
+   return result;
+}
+
+static ossimRefPtr<ossimImageData> readImage(const ossimFilename& file)
+{
+   ossimRefPtr<ossimImageData> result;
+   ossimRefPtr<ossimImageHandler> ih = ossimImageHandlerRegistry::instance()->open(file);
+   if (ih.valid())
+   {
+      ossimRefPtr<ossimImageData> tile = ih->getTile(ih->getImageRectangle());
+      if (tile.valid())
+         result = (ossimImageData*)tile->dup();
+   }
+   return result;
+}
+
+/**
+ * Writes 16 bit deflate tiles with a horizontal predictor through the encoder into a file of
+ * the given byte order ("b" or "l") and reads them back with libtiff.
+ * @return true if they read back as written.
+ */
+static bool checkByteOrder(const ossimFilename& file, const char* byteOrder)
+{
+   const ossim_uint32 TILE  = 64;
+   const ossim_uint32 SIZE  = 2*TILE;
+   std::vector<ossim_uint16> tiles(4*TILE*TILE);
+   for (ossim_uint32 i = 0; i < tiles.size(); ++i)
+      tiles[i] = (ossim_uint16)(i*257 + (i % 13)*4099);
+
+   std::string mode = std::string("w") + byteOrder;
+   TIFF* tif = TIFFOpen(file.c_str(), mode.c_str());
+   if (!tif)
+      return false;
+   TIFFSetField(tif, TIFFTAG_IMAGEWIDTH,      SIZE);
+   TIFFSetField(tif, TIFFTAG_IMAGELENGTH,     SIZE);
+   TIFFSetField(tif, TIFFTAG_TILEWIDTH,       TILE);
+   TIFFSetField(tif, TIFFTAG_TILELENGTH,      TILE);
+   TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE,   16);
+   TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, 1);
+   TIFFSetField(tif, TIFFTAG_SAMPLEFORMAT,    SAMPLEFORMAT_UINT);
+   TIFFSetField(tif, TIFFTAG_PLANARCONFIG,    PLANARCONFIG_CONTIG);
+   TIFFSetField(tif, TIFFTAG_PHOTOMETRIC,     PHOTOMETRIC_MINISBLACK);
+   TIFFSetField(tif, TIFFTAG_COMPRESSION,     COMPRESSION_ADOBE_DEFLATE);
+   TIFFSetField(tif, TIFFTAG_PREDICTOR,       PREDICTOR_HORIZONTAL);
+   bool result = true;
+   {
+      ossimTiffTileEncoder encoder(tif, 4);
+      for (ossim_uint32 t = 0; t < 4; ++t)
+         result = encoder.writeTile(&tiles[t*TILE*TILE], (t % 2)*TILE, (t / 2)*TILE, 0) && result;
+      result = encoder.finish() && result;
+   }
+   TIFFClose(tif);
+
+   tif = result ? TIFFOpen(file.c_str(), "r") : 0;
+   if (tif)
+   {
+      std::vector<ossim_uint16> tile(TILE*TILE);
+      for (ossim_uint32 t = 0; result && (t < 4); ++t)
+      {
+         result = ( TIFFReadTile(tif, &tile.front(), (t % 2)*TILE, (t / 2)*TILE, 0, 0) > 0 ) &&
+            !memcmp(&tile.front(), &tiles[t*TILE*TILE], TILE*TILE*sizeof(ossim_uint16));
+      }
+      TIFFClose(tif);
+   }
+   else
+   {
+      result = false;
+   }
+   file.remove();
+   return result;
+}
+
+int main(int argc, char *argv[])
+{
+   ossimArgumentParser ap(&argc, argv);
+   ossimInit::instance()->addOptions(ap);
+   ossimInit::instance()->initialize(ap);
+
+   ossimRefPtr<ossimImageData> image = new ossimImageData(0, OSSIM_UINT8, BANDS, WIDTH, HEIGHT);
+   image->initialize();
+   for (ossim_uint32 band = 0; band < BANDS; ++band)
+   {
+      ossim_uint8* buf = image->getUcharBuf(band);
+      for (ossim_uint32 y = 0; y < HEIGHT; ++y)
+         for (ossim_uint32 x = 0; x < WIDTH; ++x)
+            buf[y*WIDTH + x] = (ossim_uint8)(1 + ((x*(band + 3) + y*5 + (x*y) % 7) % 254));
+   }
+   image->validate();
+
+   const char* COMPRESSIONS[] = { "deflate", "lzw", "packbits", "jpeg" };
+   const char* IMAGE_TYPES[]  = { "tiff_tiled", "tiff_tiled_band_separate" };
+
+   ossimFilename serialFile   = "ossim-tiff-tile-encoder-test-1.tif";
+   ossimFilename parallelFile = "ossim-tiff-tile-encoder-test-4.tif";
+
+   int errors = 0;
+   for (ossim_uint32 c = 0; c < 4; ++c)
+   {
+      for (ossim_uint32 t = 0; t < 2; ++t)
+      {
+         ossimString name = ossimString(COMPRESSIONS[c]) + " " + IMAGE_TYPES[t];
+         if ( !writeImage(image.get(), serialFile, COMPRESSIONS[c], IMAGE_TYPES[t], 1) ||
+              !writeImage(image.get(), parallelFile, COMPRESSIONS[c], IMAGE_TYPES[t], 4) )
+         {
+            cout << name << ": write failed" << endl;
+            ++errors;
+            continue;
+         }
+
+         ossimRefPtr<ossimImageData> serial   = readImage(serialFile);
+         ossimRefPtr<ossimImageData> parallel = readImage(parallelFile);
+         if ( !serial.valid() || !parallel.valid() ||
+              (serial->getSizeInBytes() != parallel->getSizeInBytes()) ||
+              memcmp(serial->getBuf(), parallel->getBuf(), serial->getSizeInBytes()) )
+         {
+            cout << name << ": parallel compressed file differs" << endl;
+            ++errors;
+         }
+         else if ( (c != 3) &&
+                   memcmp(image->getBuf(), parallel->getBuf(), image->getSizeInBytes()) )
+         {
+            // Lossless must also match the source.
+            cout << name << ": file differs from source" << endl;
+            ++errors;
+         }
+      }
+   }
+   serialFile.remove();
+   parallelFile.remove();
+
+   if ( !checkByteOrder(parallelFile, "b") || !checkByteOrder(parallelFile, "l") )
+   {
+      cout << "16 bit tiles did not read back from a big or little endian file" << endl;
+      ++errors;
+   }
+
+   cout << "ossim-tiff-tile-encoder-test: " << (errors ? "FAILED" : "PASSED") << endl;
+   return errors ? 1 : 0;
+}
@@ -0,0 +1,106 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Description: Test app for ossimTileBufferPool.  Creates, fills and drops tiles from several
+// threads, checks that every recycled tile comes back blank, that the pool stays within its
+// limit and that flush empties it, and prints the pool statistics.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/base/ossimArgumentParser.h>
+#include <ossim/base/ossimPreferences.h>
+#include <ossim/base/ossimTileBufferPool.h>
+#include <ossim/imaging/ossimImageData.h>
+#include <ossim/imaging/ossimImageDataFactory.h>
+#include <ossim/init/ossimInit.h>
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+static const int NUM_THREADS = 4;
+static const int NUM_TILES   = 500;
+
+static std::atomic<int> g_failures(0);
+
+static void makeTiles()
+{
+   for (int i = 0; i < NUM_TILES; ++i)
+   {
+      ossimRefPtr<ossimImageData> tile =
+         ossimImageDataFactory::instance()->create(0, OSSIM_UINT16, 3, 256, 256);
+      tile->initialize();
+
+      // A recycled buffer must not leak the previous tile's pixels:
+      const ossim_uint16* buf = (const ossim_uint16*)tile->getBuf();
+      const ossim_uint32 size = tile->getSize();
+      for (ossim_uint32 idx = 0; idx < size; ++idx)
+      {
+         if (buf[idx] != (ossim_uint16)tile->getNullPix(0))
+         {
+            ++g_failures;
+            break;
+         }
+      }
+
+      tile->fill(1234.0);
+      ossimRefPtr<ossimImageData> copy = (ossimImageData*)tile->dup();
+      if (copy->getDataObjectStatus() != OSSIM_FULL)
+         ++g_failures;
+   }
+}
+
+int main(int argc, char *argv[])
+{
+   ossimArgumentParser ap(&argc, argv);
+   ossimInit::instance()->addOptions(ap);
+   ossimInit::instance()->initialize(ap);
+
+   ossimTileBufferPool* pool = ossimTileBufferPool::instance();
+   // Off by default:
+   if (pool->getEnabled() && !ossimPreferences::instance()->findPreference("tile_buffer_pool_size"))
+   {
+      std::cout << "FAILED: pool on by default" << std::endl;
+      ++g_failures;
+   }
+   pool->setMaxPoolSize(16*1024*1024);
+   pool->setEnabled(true);
+   pool->resetStatistics();
+
+   std::vector<std::thread> threads;
+   for (int i = 0; i < NUM_THREADS; ++i)
+      threads.push_back(std::thread(makeTiles));
+   for (int i = 0; i < NUM_THREADS; ++i)
+      threads[i].join();
+
+   ossimTileBufferPool::Statistics stats = pool->getStatistics();
+   stats.print(std::cout);
+   if (stats.pooledBytes > pool->getMaxPoolSize())
+   {
+      std::cout << "FAILED: pool over its limit" << std::endl;
+      ++g_failures;
+   }
+
+   // Buffers released by the threads above are all held by the pool, so flush frees them:
+   pool->flush();
+   if (pool->getStatistics().pooledBytes != 0)
+   {
+      std::cout << "FAILED: flush left pooled bytes" << std::endl;
+      ++g_failures;
+   }
+
+   int status = 0;
+   if (g_failures.load() || (stats.hits == 0))
+   {
+      std::cout << "FAILED: " << g_failures.load() << " bad tiles" << std::endl;
+      status = 1;
+   }
+   else
+   {
+      std::cout << "PASSED" << std::endl;
+   }
+   return status;
+}
@@ -0,0 +1,222 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Description: Test app for the ossimImageHandlerMtAdaptor reader pool.  Writes a TIFF and a
+// NITF, reads each from several threads at once through one adaptor, and checks every tile
+// matches a single threaded read of the same file.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/base/ossimArgumentParser.h>
+#include <ossim/base/ossimFilename.h>
+#include <ossim/base/ossimIrect.h>
+#include <ossim/base/ossimString.h>
+#include <ossim/imaging/ossimImageData.h>
+#include <ossim/imaging/ossimImageFileWriter.h>
+#include <ossim/imaging/ossimImageHandler.h>
+#include <ossim/imaging/ossimImageHandlerRegistry.h>
+#include <ossim/imaging/ossimMemoryImageSource.h>
+#include <ossim/imaging/ossimNitfWriter.h>
+#include <ossim/imaging/ossimTiffWriter.h>
+#include <ossim/init/ossimInit.h>
+#include <ossim/parallel/ossimImageHandlerMtAdaptor.h>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Odd sizes so the last row and column of blocks are partial.
+static const ossim_uint32 WIDTH       = 517;
+static const ossim_uint32 HEIGHT      = 389;
+static const ossim_uint32 BANDS       = 3;
+static const ossim_int32  RECT_SIZE   = 100;
+static const ossim_int32  RECT_STEP   = 77;
+static const ossim_uint32 NUM_THREADS = 8;
+static const ossim_uint32 NUM_PASSES  = 3;
+
+static std::atomic<int> g_failures(0);
+
+static void check(bool passed, const ossimString& what)
+{
+   if (!passed)
+   {
+      cout << "FAILED: " << what << endl;
+      ++g_failures;
+   }
+}
+
+/** Adaptor with its idle reader count visible. */
+class TestAdaptor : public ossimImageHandlerMtAdaptor
+{
+public:
+   TestAdaptor(ossimImageHandler* adaptee) : ossimImageHandlerMtAdaptor(adaptee) {}
+   ossim_uint32 getIdleReaderCount()
+   {
+      std::lock_guard<std::mutex> lock(m_readerMutex);
+      return (ossim_uint32)m_idleReaders.size();
+   }
+};
+
+static bool writeImage(ossimImageData* image, ossimImageFileWriter* writer,
+                       const ossimFilename& file, const char* imageType)
+{
+   ossimRefPtr<ossimMemoryImageSource> source = new ossimMemoryImageSource();
+   source->setImage(image);
+   writer->connectMyInputTo(0, source.get());
+   writer->setFilename(file);
+   writer->setOutputImageType(imageType);
+   writer->setTileSize(ossimIpt(64, 64));
+   writer->setWriteOverviewFlag(false);
+   bool result = writer->execute();
+   writer->disconnect();
+   return result;
+}
+
+/** Rectangles that straddle the block edges and run off the image. */
+static vector<ossimIrect> makeRects()
+{
+   vector<ossimIrect> rects;
+   for (ossim_int32 y = -RECT_STEP/2; y < (ossim_int32)HEIGHT; y += RECT_STEP)
+      for (ossim_int32 x = -RECT_STEP/2; x < (ossim_int32)WIDTH; x += RECT_STEP)
+         rects.push_back(ossimIrect(x, y, x + RECT_SIZE - 1, y + RECT_SIZE - 1));
+   return rects;
+}
+
+static bool sameTile(const ossimImageData* a, const ossimImageData* b)
+{
+   if (!a || !b)
+      return a == b;
+   return (a->getImageRectangle() == b->getImageRectangle()) &&
+      (a->getDataObjectStatus() == b->getDataObjectStatus()) &&
+      (a->getSizeInBytes() == b->getSizeInBytes()) &&
+      !memcmp(a->getBuf(), b->getBuf(), a->getSizeInBytes());
+}
+
+/** Reads all rects, each thread starting at a different one, half through each getTile. */
+static void readTiles(ossimImageHandlerMtAdaptor* adaptor, const vector<ossimIrect>* rects,
+                      const vector<ossimRefPtr<ossimImageData> >* expected, ossim_uint32 start)
+{
+   const size_t count = rects->size();
+   for (ossim_uint32 pass = 0; pass < NUM_PASSES; ++pass)
+   {
+      for (size_t i = 0; i < count; ++i)
+      {
+         const size_t idx = (start * 7 + i) % count;
+         const ossimIrect& rect = (*rects)[idx];
+         ossimRefPtr<ossimImageData> tile;
+         if ((idx + pass) % 2)
+         {
+            tile = adaptor->getTile(rect, 0);
+         }
+         else
+         {
+            tile = (ossimImageData*)(*expected)[idx]->dup();
+            tile->makeBlank();
+            if (!adaptor->getTile(tile.get(), 0))
+               tile = 0;
+         }
+         if (!sameTile(tile.get(), (*expected)[idx].get()))
+            ++g_failures;
+      }
+   }
+}
+
+static void testFile(const ossimFilename& file, const ossimString& name)
+{
+   ossimRefPtr<ossimImageHandler> single = ossimImageHandlerRegistry::instance()->open(file);
+   ossimRefPtr<ossimImageHandler> shared = ossimImageHandlerRegistry::instance()->open(file);
+   check(single.valid() && shared.valid(), name + " open");
+   if (!single.valid() || !shared.valid())
+      return;
+   check(shared->supportsConcurrentReads(), name + " supports concurrent reads");
+
+   // Single threaded reads straight from the handler:
+   const vector<ossimIrect> rects = makeRects();
+   vector<ossimRefPtr<ossimImageData> > expected;
+   for (size_t i = 0; i < rects.size(); ++i)
+   {
+      ossimRefPtr<ossimImageData> tile = single->getTile(rects[i], 0);
+      check(tile.valid(), name + " single threaded read");
+      if (!tile.valid())
+         return;
+      expected.push_back((ossimImageData*)tile->dup());
+   }
+
+   ossimRefPtr<TestAdaptor> adaptor = new TestAdaptor(shared.get());
+   const int failures = g_failures.load();
+   vector<std::thread> threads;
+   for (ossim_uint32 idx = 0; idx < NUM_THREADS; ++idx)
+      threads.push_back(std::thread(readTiles, adaptor.get(), &rects, &expected, idx));
+   for (ossim_uint32 idx = 0; idx < NUM_THREADS; ++idx)
+      threads[idx].join();
+   if (g_failures.load() != failures)
+      cout << "FAILED: " << name << " " << (g_failures.load() - failures)
+           << " tiles differ from the single threaded read" << endl;
+
+   // Readers came back to the pool, at most one per thread:
+   const ossim_uint32 idle = adaptor->getIdleReaderCount();
+   check((idle > 0) && (idle <= NUM_THREADS), name + " reader pool size");
+
+   // Same through the locked path:
+   adaptor->setUseConcurrentReads(false);
+   check(adaptor->getIdleReaderCount() == 0, name + " pool dropped");
+   readTiles(adaptor.get(), &rects, &expected, 0);
+}
+
+int main(int argc, char *argv[])
+{
+   ossimArgumentParser ap(&argc, argv);
+   ossimInit::instance()->addOptions(ap);
+   ossimInit::instance()->initialize(ap);
+
+   ossimRefPtr<ossimImageData> image = new ossimImageData(0, OSSIM_UINT16, BANDS, WIDTH, HEIGHT);
+   image->initialize();
+   for (ossim_uint32 band = 0; band < BANDS; ++band)
+   {
+      ossim_uint16* buf = image->getUshortBuf(band);
+      for (ossim_uint32 y = 0; y < HEIGHT; ++y)
+         for (ossim_uint32 x = 0; x < WIDTH; ++x)
+            buf[y*WIDTH + x] = (ossim_uint16)(1 + ((x*(band + 3) + y*517 + (x*y) % 7) % 4000));
+   }
+   image->validate();
+
+   ossimFilename tiffFile  = "ossim-image-handler-mt-adaptor-test.tif";
+   ossimFilename stripFile = "ossim-image-handler-mt-adaptor-test-strip.tif";
+   ossimFilename nitfFile  = "ossim-image-handler-mt-adaptor-test.ntf";
+
+   ossimRefPtr<ossimImageFileWriter> writer = new ossimTiffWriter();
+   check(writeImage(image.get(), writer.get(), tiffFile, "tiff_tiled_band_separate"),
+         "tiff write");
+   writer = new ossimTiffWriter();
+   check(writeImage(image.get(), writer.get(), stripFile, "tiff_strip"), "tiff strip write");
+   writer = new ossimNitfWriter();
+   check(writeImage(image.get(), writer.get(), nitfFile, "nitf_block_band_separate"),
+         "nitf write");
+   writer = 0;
+
+   testFile(tiffFile, "tiff tiled");
+   testFile(stripFile, "tiff strip");
+   testFile(nitfFile, "nitf");
+
+   tiffFile.remove();
+   stripFile.remove();
+   nitfFile.remove();
+
+   int status = 0;
+   if (g_failures.load())
+   {
+      cout << "ossim-image-handler-mt-adaptor-test: FAILED" << endl;
+      status = 1;
+   }
+   else
+   {
+      cout << "ossim-image-handler-mt-adaptor-test: PASSED" << endl;
+   }
+   return status;
+}
@@ -0,0 +1,139 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Description: Test app for ossimJobWorkStealingQueue.  Queues a batch of jobs from the main
+// thread, each of which spawns child jobs from inside the pool, then checks that every job ran
+// exactly once and prints the pool statistics.  Then checks parallelFor makes every call once,
+// from the main thread and from jobs keeping every worker of the pool busy.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/parallel/ossimJob.h>
+#include <ossim/parallel/ossimJobWorkStealingQueue.h>
+#include <ossim/base/ossimArgumentParser.h>
+#include <ossim/base/ossimApplicationUsage.h>
+#include <ossim/init/ossimInit.h>
+#include <ossim/base/Thread.h>
+#include <atomic>
+#include <iostream>
+#include <vector>
+
+static const int NUM_THREADS    = 8;
+static const int NUM_JOBS       = 2000;
+static const int CHILDREN_PER_JOB = 4;
+
+static const ossim_uint32 NUM_CALLS = 1000;
+
+static std::atomic<int> g_executed(0);
+
+/** @return true if parallelFor on pool called each index once. */
+static bool checkParallelFor(ossimJobWorkStealingQueue* pool)
+{
+   std::vector<int> calls(NUM_CALLS, 0);
+   pool->parallelFor(NUM_CALLS, NUM_THREADS, [&calls](ossim_uint32 i) { ++calls[i]; });
+   for (ossim_uint32 i = 0; i < NUM_CALLS; ++i)
+   {
+      if (calls[i] != 1)
+         return false;
+   }
+   return true;
+}
+
+class ossimTestParallelForJob : public ossimJob
+{
+public:
+   ossimTestParallelForJob(ossimJobWorkStealingQueue* pool, std::atomic<int>* failures)
+      : m_pool(pool), m_failures(failures) {}
+protected:
+   virtual void run()
+   {
+      if (!checkParallelFor(m_pool))
+         ++(*m_failures);
+   }
+private:
+   ossimJobWorkStealingQueue* m_pool;
+   std::atomic<int>*          m_failures;
+};
+
+class ossimTestChildJob : public ossimJob
+{
+protected:
+   virtual void run()
+   {
+      ++g_executed;
+   }
+};
+
+class ossimTestParentJob : public ossimJob
+{
+public:
+   ossimTestParentJob(ossimJobWorkStealingQueue* pool) : m_pool(pool) {}
+protected:
+   virtual void run()
+   {
+      ++g_executed;
+
+      // Uneven work so that stealing actually happens:
+      if ((g_executed.load() % 7) == 0)
+         ossim::Thread::sleepInMicroSeconds(200);
+
+      for (int i = 0; i < CHILDREN_PER_JOB; ++i)
+         m_pool->add(std::make_shared<ossimTestChildJob>());
+   }
+private:
+   ossimJobWorkStealingQueue* m_pool;
+};
+
+int main(int argc, char *argv[])
+{
+   ossimArgumentParser ap(&argc, argv);
+   ossimInit::instance()->addOptions(ap);
+   ossimInit::instance()->initialize(ap);
+
+   std::shared_ptr<ossimJobWorkStealingQueue> pool =
+      std::make_shared<ossimJobWorkStealingQueue>(NUM_THREADS);
+
+   for (int i = 0; i < NUM_JOBS; ++i)
+      pool->add(std::make_shared<ossimTestParentJob>(pool.get()));
+
+   pool->waitForJobsToFinish();
+
+   ossimJobWorkStealingQueue::Statistics stats = pool->getStatistics();
+   stats.print(std::cout);
+
+   const int expected = NUM_JOBS * (1 + CHILDREN_PER_JOB);
+   int status = 0;
+   if ((g_executed.load() != expected) || (stats.jobsExecuted != (ossim_uint64)expected) ||
+       pool->hasJobsToProcess())
+   {
+      std::cout << "FAILED: expected " << expected << " jobs, executed " << g_executed.load()
+                << std::endl;
+      status = 1;
+   }
+
+   std::atomic<int> failures(0);
+   if (!checkParallelFor(pool.get()))
+      ++failures;
+   for (int i = 0; i < 2*NUM_THREADS; ++i)
+      pool->add(std::make_shared<ossimTestParallelForJob>(pool.get(), &failures));
+   pool->waitForJobsToFinish();
+   if (failures.load())
+   {
+      std::cout << "FAILED: parallelFor missed or repeated calls " << failures.load()
+                << " times" << std::endl;
+      status = 1;
+   }
+
+   if (status == 0)
+   {
+      std::cout << "PASSED" << std::endl;
+   }
+
+   pool->cancel();
+   pool->waitForCompletion();
+
+   return status;
+}
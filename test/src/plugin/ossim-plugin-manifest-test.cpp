@@ -0,0 +1,274 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Description: Test app for ossimPluginManifest and the deferred plugin stand in factories.
+// Round trips a manifest entry through a file, checks a changed library size or modification
+// time invalidates it, checks the stand ins only load a plugin for what it lists and then once,
+// and that captured registrations keep their front/back order.
+//
+// The "plugin" is a file that is not a library, so its load fails, and a listener stands in for
+// its ossimSharedLibraryInitialize by registering a factory while the load is captured.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/base/ossimArgumentParser.h>
+#include <ossim/base/ossimDate.h>
+#include <ossim/base/ossimFactoryListInterface.h>
+#include <ossim/base/ossimKeywordlist.h>
+#include <ossim/base/ossimKeywordNames.h>
+#include <ossim/imaging/ossimDeferredImageHandlerFactory.h>
+#include <ossim/imaging/ossimGeneralRasterTileSource.h>
+#include <ossim/imaging/ossimImageHandlerFactoryBase.h>
+#include <ossim/imaging/ossimImageHandlerRegistry.h>
+#include <ossim/init/ossimInit.h>
+#include <ossim/plugin/ossimDeferredPlugin.h>
+#include <ossim/plugin/ossimPluginManifest.h>
+#include <ossim/projection/ossimDeferredProjectionFactory.h>
+#include <ossim/projection/ossimProjectionFactoryRegistry.h>
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+using namespace std;
+
+static int errors = 0;
+
+static void check(bool passed, const char* what)
+{
+   if (!passed)
+   {
+      cout << "FAILED: " << what << endl;
+      ++errors;
+   }
+}
+
+/** Image handler factory the fake plugin registers.  Counts the requests passed on to it. */
+class TestHandlerFactory : public ossimImageHandlerFactoryBase
+{
+public:
+   TestHandlerFactory() : suffixRequests(0) {}
+   virtual ossimImageHandler* open(const ossimFilename&, bool) const { return 0; }
+   virtual ossimImageHandler* open(const ossimKeywordlist&, const char*) const { return 0; }
+   virtual void getImageHandlersBySuffix(ImageHandlerList&, const ossimString&) const
+   {
+      ++suffixRequests;
+   }
+   virtual void getSupportedExtensions(UniqueStringList& list) const { list.push_back("foo"); }
+   virtual ossimObject* createObject(const ossimString&) const { return 0; }
+   virtual ossimObject* createObject(const ossimKeywordlist&, const char*) const { return 0; }
+   virtual void getTypeNameList(std::vector<ossimString>& list) const
+   {
+      list.push_back("ossimFooTileSource");
+   }
+   mutable int suffixRequests;
+};
+
+/** Projection factory the fake plugin registers.  Counts the file requests passed on to it. */
+class TestProjectionFactory : public ossimProjectionFactoryBase
+{
+public:
+   TestProjectionFactory() : fileRequests(0) {}
+   virtual ossimProjection* createProjection(const ossimFilename&, ossim_uint32) const
+   {
+      ++fileRequests;
+      return 0;
+   }
+   virtual ossimProjection* createProjection(const ossimString&) const { return 0; }
+   virtual ossimProjection* createProjection(const ossimKeywordlist&, const char*) const
+   {
+      return 0;
+   }
+   virtual ossimObject* createObject(const ossimString&) const { return 0; }
+   virtual ossimObject* createObject(const ossimKeywordlist&, const char*) const { return 0; }
+   virtual void getTypeNameList(std::vector<ossimString>&) const {}
+   mutable int fileRequests;
+};
+
+/** Counts load attempts and registers the fake plugin's factories as its init would. */
+class TestListener : public ossimDeferredPlugin::Listener
+{
+public:
+   TestListener() : loads(0) {}
+   virtual void beginLoad()
+   {
+      ++loads;
+      ossimImageHandlerRegistry::instance()->registerFactory(&handlerFactory);
+      ossimProjectionFactoryRegistry::instance()->registerFactory(&projectionFactory);
+   }
+   virtual void endLoad() {}
+   int loads;
+   TestHandlerFactory    handlerFactory;
+   TestProjectionFactory projectionFactory;
+};
+
+/** Factory list with its order visible. */
+class TestList : public ossimFactoryListInterface<ossimImageHandlerFactoryBase, ossimImageHandler>
+{
+public:
+   const FactoryListType& getList() const { return m_factoryList; }
+};
+
+static ossimFilename makeLibrary(const ossimFilename& file, const char* contents)
+{
+   std::ofstream out(file.c_str(), std::ios_base::out | std::ios_base::binary);
+   out << contents;
+   return file;
+}
+
+static ossimPluginManifest::Entry makeEntry()
+{
+   ossimPluginManifest::Entry entry;
+   entry.deferrable = true;
+   entry.imageHandlers.extensions.push_back("foo");
+   entry.imageHandlers.types.push_back("ossimFooTileSource");
+   entry.imageWriters.front = true;
+   entry.imageWriters.extensions.push_back("foo");
+   entry.imageWriters.types.push_back("ossimFooWriter");
+   entry.imageWriters.imageTypes.push_back("foo_rgb");
+   entry.projections.types.push_back("ossimFooProjection");
+   entry.projections.extensions.push_back("foo");
+   entry.projections.handlerTypes.push_back("ossimFooTileSource");
+   return entry;
+}
+
+static void testRoundTrip()
+{
+   const ossimFilename library = makeLibrary("ossim-plugin-manifest-test.so", "not a library");
+   const ossimFilename file = "ossim-plugin-manifest-test.kwl";
+
+   ossimPluginManifest manifest;
+   manifest.set(library, " opt1 ", makeEntry());
+   check(manifest.isModified() && manifest.write(file) && !manifest.isModified(), "write");
+
+   ossimPluginManifest copy;
+   check(copy.read(file), "read");
+   const ossimPluginManifest::Entry* entry = copy.find(library, "opt1");
+   check(entry != 0, "entry found after round trip");
+   if (entry)
+   {
+      const ossimPluginManifest::Entry expected = makeEntry();
+      check(entry->deferrable, "deferrable");
+      check(entry->imageHandlers.extensions == expected.imageHandlers.extensions &&
+            entry->imageHandlers.types == expected.imageHandlers.types &&
+            !entry->imageHandlers.front, "image handlers");
+      check(entry->imageWriters.front &&
+            entry->imageWriters.imageTypes == expected.imageWriters.imageTypes &&
+            entry->imageWriters.hasType("FOO_RGB"), "image writers");
+      check(entry->projections.types == expected.projections.types &&
+            entry->projections.hasExtension("FOO") &&
+            entry->projections.hasHandlerType("ossimFooTileSource"), "projections");
+   }
+   check(copy.find(library, "opt2") == 0, "other options ignored");
+
+   // A rebuilt library of another size:
+   makeLibrary(library, "not a library either");
+   check(copy.find(library, "opt1") == 0, "size change invalidates");
+
+   // Same size, new modification time:
+   makeLibrary(library, "not a library");
+   copy.set(library, "opt1", makeEntry());
+   check(copy.find(library, "opt1") != 0, "set restamps");
+   ossimLocalTm modTime;
+   library.getTimes(0, &modTime, 0);
+   modTime.addSeconds(-3600.0);
+   library.setTimes(0, &modTime, 0);
+   check(copy.find(library, "opt1") == 0, "modification time change invalidates");
+
+   library.remove();
+   file.remove();
+}
+
+static void testStandIns()
+{
+   const ossimFilename library = makeLibrary("ossim-plugin-manifest-test.so", "not a library");
+   std::shared_ptr<ossimDeferredPlugin> plugin =
+      std::make_shared<ossimDeferredPlugin>(library, ossimString(), makeEntry());
+
+   // Stand ins first, so they capture what the listener registers:
+   ossimRefPtr<ossimDeferredImageHandlerFactory> handlers =
+      new ossimDeferredImageHandlerFactory(plugin);
+   ossimRefPtr<ossimDeferredProjectionFactory> projections =
+      new ossimDeferredProjectionFactory(plugin);
+   TestListener listener;
+   plugin->addListener(&listener);
+
+   // Requests for what the plugin does not list:
+   ossimImageHandlerFactoryBase::ImageHandlerList list;
+   handlers->getImageHandlersBySuffix(list, "tif");
+   check(handlers->createObject(ossimString("ossimTiffTileSource")) == 0, "unlisted type");
+   ossimKeywordlist kwl;
+   kwl.add(ossimKeywordNames::TYPE_KW, "ossimTiffTileSource");
+   check(handlers->open(kwl, 0) == 0, "unlisted keyword list type");
+   check(projections->createProjection(ossimFilename("image.tif"), 0) == 0, "unlisted suffix");
+   ossimRefPtr<ossimImageHandler> coreHandler = new ossimGeneralRasterTileSource;
+   check(projections->createProjection(coreHandler.get()) == 0, "unlisted handler type");
+   check(projections->createProjection(ossimString("ossimUtmProjection")) == 0,
+         "unlisted projection");
+   check(listener.loads == 0, "plugin loaded for something it does not list");
+
+   // The first listed one loads it and is passed on to its factories:
+   handlers->getImageHandlersBySuffix(list, "FOO");
+   check(listener.loads == 1, "plugin not loaded for a listed extension");
+   check(listener.handlerFactory.suffixRequests == 1, "request not passed to plugin factory");
+   check(!ossimImageHandlerRegistry::instance()->
+         isFactoryRegistered(&listener.handlerFactory), "captured factory reached the registry");
+
+   // Later ones do not load it again:
+   handlers->getImageHandlersBySuffix(list, "foo");
+   projections->createProjection(ossimFilename("image.foo"), 0);
+   check(listener.loads == 1, "plugin loaded more than once");
+   check(listener.handlerFactory.suffixRequests == 2, "second request not passed on");
+   check(listener.projectionFactory.fileRequests == 1, "projection request not passed on");
+
+   library.remove();
+}
+
+static void testCaptureOrder()
+{
+   TestHandlerFactory a, b, c, d, x, y;
+
+   // Registered directly:
+   TestList direct;
+   direct.registerFactory(&x);
+   direct.registerFactory(&y);
+   direct.registerFactory(&a);
+   direct.registerFactory(&b, true);
+   direct.registerFactory(&c);
+   direct.registerFactoryBefore(&d, &y);
+
+   // Captured, then made:
+   TestList captured;
+   captured.registerFactory(&x);
+   captured.registerFactory(&y);
+   TestList::RegistrationList registrations;
+   check(captured.setCaptureList(&registrations) == 0, "no previous capture");
+   captured.registerFactory(&a);
+   captured.registerFactory(&b, true);
+   captured.registerFactory(&c);
+   captured.registerFactoryBefore(&d, &y);
+   captured.setCaptureList(0);
+   check((captured.getList().size() == 2) && (registrations.size() == 4),
+         "registrations not held back");
+   captured.registerFactories(registrations);
+
+   check(captured.getList() == direct.getList(), "captured order differs");
+   check((direct.getList().size() == 6) && (direct.getList()[0] == &b) &&
+         (direct.getList()[2] == &d) && (direct.getList()[5] == &c), "direct order");
+}
+
+int main(int argc, char *argv[])
+{
+   ossimArgumentParser ap(&argc, argv);
+   ossimInit::instance()->addOptions(ap);
+   ossimInit::instance()->initialize(ap);
+
+   testRoundTrip();
+   testStandIns();
+   testCaptureOrder();
+
+   cout << "ossim-plugin-manifest-test: " << (errors ? "FAILED" : "PASSED") << endl;
+   return errors ? 1 : 0;
+}
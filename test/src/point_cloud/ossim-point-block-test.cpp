@@ -0,0 +1,236 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Description: Test app for the columnar ossimPointBlock.  Fills blocks from records and from
+// positions, and checks the columns, the record adapter, edits through the records, min/max,
+// copies, concurrent reads and the bounded getBlock() of ossimGenericPointCloudHandler agree.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/base/ossimArgumentParser.h>
+#include <ossim/init/ossimInit.h>
+#include <ossim/point_cloud/ossimGenericPointCloudHandler.h>
+#include <ossim/point_cloud/ossimPointBlock.h>
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+   ossimArgumentParser ap(&argc, argv);
+   ossimInit::instance()->addOptions(ap);
+   ossimInit::instance()->initialize(ap);
+
+   int errors = 0;
+   const ossim_uint32 N = 1000;
+   const ossim_uint32 FIELDS = ossimPointRecord::Intensity | ossimPointRecord::NumberOfReturns;
+
+   // Records through the compatibility addPoint():
+   ossimPointBlock block;
+   for (ossim_uint32 i = 0; i < N; ++i)
+   {
+      ossimPointRecord* pr = new ossimPointRecord(FIELDS);
+      pr->setPointId(i + 1);
+      pr->setPosition(ossimGpt(30.0 + i * 0.001, -100.0 - i * 0.001, i * 0.5));
+      pr->setField(ossimPointRecord::Intensity, (ossim_float32)(i % 256));
+      pr->setField(ossimPointRecord::NumberOfReturns, (ossim_float32)(1 + i % 3));
+      block.addPoint(pr);
+   }
+
+   if ((block.size() != N) || (block.getFieldCode() != FIELDS))
+   {
+      cout << "size " << block.size() << " field code " << block.getFieldCode() << endl;
+      ++errors;
+   }
+   if (block.getFieldColumn(ossimPointRecord::Red) ||
+       !block.getFieldColumn(ossimPointRecord::Intensity))
+   {
+      cout << "wrong columns allocated" << endl;
+      ++errors;
+   }
+
+   // Columns, iterator and record adapter must agree:
+   const ossimPointBlock& constBlock = block;
+   ossim_uint32 count = 0;
+   for (ossimPointBlock::const_iterator p = block.begin(); p != block.end(); ++p, ++count)
+   {
+      const ossim_uint32 i = p.getIndex();
+      const ossimPointRecord* pr = constBlock[i];
+      if ((p.getField(ossimPointRecord::Intensity) != (ossim_float32)(i % 256)) ||
+          (block.getFieldColumn(ossimPointRecord::NumberOfReturns)[i] != 1 + i % 3) ||
+          (p.getPointId() != i + 1) || (block.getHgts()[i] != i * 0.5) || !pr ||
+          (pr->getPointId() != i + 1) || (pr->getPosition() != p.getPosition()) ||
+          (pr->getField(ossimPointRecord::Intensity) != (ossim_float32)(i % 256)))
+      {
+         cout << "point " << i << " differs" << endl;
+         ++errors;
+         break;
+      }
+   }
+   if (count != N)
+   {
+      cout << "iterated " << count << " points" << endl;
+      ++errors;
+   }
+
+   // Min/max and bounds:
+   ossim_float32 minI, maxI;
+   block.getFieldMin(ossimPointRecord::Intensity, minI);
+   block.getFieldMax(ossimPointRecord::Intensity, maxI);
+   ossimGrect bounds;
+   block.getBounds(bounds);
+   if ((minI != 0.0f) || (maxI != 255.0f) || !bounds.pointWithin(block.getPosition(0)) ||
+       !bounds.pointWithin(block.getPosition(N - 1)))
+   {
+      cout << "min/max " << minI << " " << maxI << " bounds " << bounds << endl;
+      ++errors;
+   }
+
+   // Writes through setField() reach the adapter:
+   block.setField(5, ossimPointRecord::Intensity, 1000.0f);
+   if (block[5]->getField(ossimPointRecord::Intensity) != 1000.0f)
+   {
+      cout << "record adapter not refreshed after setField" << endl;
+      ++errors;
+   }
+
+   // Copy:
+   ossimRefPtr<ossimPointBlock> copy = (ossimPointBlock*)block.dup();
+   if ((copy->size() != N) || (copy->getField(5, ossimPointRecord::Intensity) != 1000.0f))
+   {
+      cout << "copy differs" << endl;
+      ++errors;
+   }
+
+   // Edits through the non-const records reach the columns:
+   ossimPointRecord* edited = block[7];
+   edited->setField(ossimPointRecord::Intensity, 2000.0f);
+   edited->setPosition(ossimGpt(31.0, -101.0, -5.0));
+   block.getFieldMax(ossimPointRecord::Intensity, maxI);
+   if ((block.getField(7, ossimPointRecord::Intensity) != 2000.0f) ||
+       (block.getPosition(7).hgt != -5.0) || (maxI != 2000.0f))
+   {
+      cout << "edit through record not copied to the columns" << endl;
+      ++errors;
+   }
+   ossimRefPtr<ossimPointRecord> appended = new ossimPointRecord(FIELDS);
+   appended->setPointId(N + 1);
+   appended->setPosition(ossimGpt(32.0, -102.0, 1.0));
+   block.getPoints().push_back(appended);
+   if ((block.size() != N + 1) || (block.getPointId(N) != N + 1))
+   {
+      cout << "record appended to getPoints() not copied to the columns" << endl;
+      ++errors;
+   }
+   block.getPoints().pop_back();
+   block.setField(7, ossimPointRecord::Intensity, 7.0f);
+   block.setPosition(7, ossimGpt(30.007, -100.007, 3.5));
+
+   // Edits through a held list survive calls that do not read the columns:
+   {
+      ossimPointBlock::PointList& held = block.getPoints();
+      if ((block.size() != N) || !block[9] || (constBlock.getPoint(9) != held[9].get()))
+      {
+         cout << "record accessors do not return the held records" << endl;
+         ++errors;
+      }
+      held[9]->setField(ossimPointRecord::Intensity, 9.5f);
+      if (block.getField(9, ossimPointRecord::Intensity) != 9.5f)
+      {
+         cout << "edit through a held list lost" << endl;
+         ++errors;
+      }
+
+      // Once copied back, the next handout refreshes the records from the columns:
+      held[9]->setField(ossimPointRecord::Intensity, 99.0f);
+      if ((block.getField(9, ossimPointRecord::Intensity) != 9.5f) ||
+          (block[9]->getField(ossimPointRecord::Intensity) != 9.5f))
+      {
+         cout << "records differ from the columns after a sync" << endl;
+         ++errors;
+      }
+      block.setField(9, ossimPointRecord::Intensity, (ossim_float32)9);
+   }
+
+   // The record loop of existing code copies back once, so runs in linear time on a big block:
+   {
+      const ossim_uint32 BIG = 500000;
+      ossimPointBlock big(0, FIELDS);
+      big.reserve(BIG);
+      for (ossim_uint32 i = 0; i < BIG; ++i)
+         big.setField(big.addPoint(ossimGpt(30.0, -100.0, 0.0), i), ossimPointRecord::Intensity,
+                      (ossim_float32)(i % 100));
+      const ossim_uint32 numPoints = big.size();
+      for (ossim_uint32 i = 0; i < numPoints; ++i)
+      {
+         ossimPointRecord* pr = big[i];
+         pr->setField(ossimPointRecord::Intensity, pr->getField(ossimPointRecord::Intensity) / 100.0f);
+      }
+      ossim_float32 bigMax;
+      big.getFieldMax(ossimPointRecord::Intensity, bigMax);
+      if ((big.size() != BIG) || (bigMax != 0.99f) ||
+          (big.getField(BIG - 1, ossimPointRecord::Intensity) != (ossim_float32)((BIG - 1) % 100) / 100.0f))
+      {
+         cout << "record loop over a big block differs" << endl;
+         ++errors;
+      }
+   }
+
+   // Record copies and min/max made from several threads at once:
+   {
+      const ossimPointBlock& shared = block;
+      ossimRefPtr<ossimPointBlock> fresh = (ossimPointBlock*)block.dup();
+      const ossimPointBlock& sharedFresh = *fresh;
+      std::atomic<int> mismatches(0);
+      vector<std::thread> readers;
+      for (ossim_uint32 t = 0; t < 8; ++t)
+      {
+         readers.push_back(std::thread([&, t]() {
+            for (ossim_uint32 i = t; i < N; i += 8)
+            {
+               const ossimPointRecord* pr = sharedFresh.getPoint(i);
+               ossim_float32 maxV;
+               sharedFresh.getFieldMax(ossimPointRecord::Intensity, maxV);
+               if (!pr || (pr->getPosition() != shared.getPosition(i)) || (maxV != 1000.0f))
+                  ++mismatches;
+            }
+         }));
+      }
+      for (ossim_uint32 t = 0; t < readers.size(); ++t)
+         readers[t].join();
+      if (mismatches.load())
+      {
+         cout << mismatches.load() << " concurrent record reads differ" << endl;
+         ++errors;
+      }
+   }
+
+   // Bounded fetch from the generic handler built from positions:
+   vector<ossimGpt> gpts;
+   for (ossim_uint32 i = 0; i < N; ++i)
+      gpts.push_back(block.getPosition(i));
+   ossimRefPtr<ossimGenericPointCloudHandler> handler = new ossimGenericPointCloudHandler(gpts);
+   ossimGrect roi(ossimGpt(30.2505, -100.6005, 0.0), ossimGpt(30.0995, -100.0995, 1000.0));
+   ossimPointBlock found;
+   handler->getBlock(roi, found);
+   ossim_uint32 expected = 0;
+   for (ossim_uint32 i = 0; i < N; ++i)
+   {
+      if (roi.pointWithin(gpts[i]))
+         ++expected;
+   }
+   if ((found.size() != expected) || (expected == 0))
+   {
+      cout << "getBlock found " << found.size() << " expected " << expected << endl;
+      ++errors;
+   }
+
+   cout << "ossim-point-block-test: " << (errors ? "FAILED" : "PASSED") << endl;
+   return errors ? 1 : 0;
+}
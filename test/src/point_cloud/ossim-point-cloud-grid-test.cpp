@@ -0,0 +1,180 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Description: Test app for ossimPointCloudGrid.  Checks each reducer against a brute force pass
+// over the samples, that grids filled from parts of the samples merge to the same result, and
+// that ossimPointCloudImageHandler rasterizes the same tile with one thread or several.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/base/ossimArgumentParser.h>
+#include <ossim/imaging/ossimImageData.h>
+#include <ossim/init/ossimInit.h>
+#include <ossim/point_cloud/ossimGenericPointCloudHandler.h>
+#include <ossim/point_cloud/ossimPointCloudGrid.h>
+#include <ossim/point_cloud/ossimPointCloudImageHandler.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+static const ossim_uint32 WIDTH   = 16;
+static const ossim_uint32 HEIGHT  = 8;
+static const ossim_uint32 SAMPLES = 20000;
+static const ossim_float32 NULL_VALUE = -99999.0f;
+
+static ossim_float32 expected(ossimPointCloudGrid::Reducer reducer, vector<ossim_float32> v)
+{
+   if (v.empty())
+      return NULL_VALUE;
+
+   sort(v.begin(), v.end());
+   double sum = 0.0;
+   for (ossim_uint32 i = 0; i < v.size(); ++i)
+      sum += v[i];
+
+   switch (reducer)
+   {
+   case ossimPointCloudGrid::MEAN:
+      return (ossim_float32)(sum / v.size());
+   case ossimPointCloudGrid::MIN:
+      return v.front();
+   case ossimPointCloudGrid::MAX:
+      return v.back();
+   case ossimPointCloudGrid::SUM:
+      return (ossim_float32)sum;
+   default: // COUNT
+      return (ossim_float32)v.size();
+   }
+}
+
+static int checkReducer(ossimPointCloudGrid::Reducer reducer, const vector<ossim_uint32>& cells,
+                        const vector<ossim_float32>& values)
+{
+   int errors = 0;
+
+   // One grid fed everything, and three grids fed a third each then merged:
+   ossimPointCloudGrid whole(WIDTH, HEIGHT, 1, reducer);
+   ossimPointCloudGrid parts[3];
+   for (ossim_uint32 p = 0; p < 3; ++p)
+      parts[p].initialize(WIDTH, HEIGHT, 1, reducer);
+   vector< vector<ossim_float32> > bins(WIDTH * HEIGHT);
+   for (ossim_uint32 i = 0; i < cells.size(); ++i)
+   {
+      whole.add(cells[i], values[i]);
+      parts[i % 3].add(cells[i], values[i]);
+      bins[cells[i]].push_back(values[i]);
+   }
+   parts[0].merge(parts[1]);
+   parts[0].merge(parts[2]);
+
+   vector<ossim_float32> band(WIDTH * HEIGHT);
+   whole.getBand(0, &band.front(), NULL_VALUE);
+   for (ossim_uint32 cell = 0; cell < WIDTH * HEIGHT; ++cell)
+   {
+      ossim_float32 e = expected(reducer, bins[cell]);
+      ossim_float32 tolerance = 1.0e-3f * max(1.0f, fabs(e));
+      if ((fabs(band[cell] - e) > tolerance) ||
+          (fabs(parts[0].getValue(cell, 0, NULL_VALUE) - e) > tolerance) ||
+          (whole.getCount(cell) != bins[cell].size()) ||
+          (parts[0].getCount(cell) != bins[cell].size()))
+      {
+         cout << "reducer " << reducer << " cell " << cell << ": got " << band[cell]
+              << " merged " << parts[0].getValue(cell, 0, NULL_VALUE) << " expected " << e << endl;
+         ++errors;
+         break;
+      }
+   }
+   return errors;
+}
+
+static int checkThreads()
+{
+   // Random points over a small area with heights to rasterize as highest and lowest:
+   vector<ossimGpt> gpts;
+   srand(11);
+   for (ossim_uint32 i = 0; i < 100000; ++i)
+   {
+      gpts.push_back(ossimGpt(30.0 + 0.01 * rand() / RAND_MAX,
+                              -100.0 + 0.01 * rand() / RAND_MAX,
+                              100.0 * rand() / RAND_MAX));
+   }
+
+   int errors = 0;
+   ossimRefPtr<ossimImageData> tiles[2];
+   const ossim_uint32 threads[2] = { 1, 4 };
+   for (ossim_uint32 component = ossimPointCloudImageHandler::HIGHEST;
+        component <= ossimPointCloudImageHandler::LOWEST; ++component)
+   {
+      for (ossim_uint32 t = 0; t < 2; ++t)
+      {
+         ossimRefPtr<ossimPointCloudImageHandler> handler = new ossimPointCloudImageHandler;
+         handler->setPointCloudHandler(new ossimGenericPointCloudHandler(gpts));
+         handler->setCurrentEntry(component);
+         handler->setNumberOfThreads(threads[t]);
+         tiles[t] = (ossimImageData*)handler->getTile(ossimIrect(0, 0, 255, 255))->dup();
+      }
+
+      const ossim_float32* a = tiles[0]->getFloatBuf(0);
+      const ossim_float32* b = tiles[1]->getFloatBuf(0);
+      for (ossim_uint32 i = 0; i < tiles[0]->getSizePerBand(); ++i)
+      {
+         if (a[i] != b[i])
+         {
+            cout << "component " << component << " pixel " << i << ": " << a[i]
+                 << " with one thread, " << b[i] << " with four" << endl;
+            ++errors;
+            break;
+         }
+      }
+   }
+   return errors;
+}
+
+int main(int argc, char *argv[])
+{
+   ossimArgumentParser ap(&argc, argv);
+   ossimInit::instance()->addOptions(ap);
+   ossimInit::instance()->initialize(ap);
+
+   // Samples land in all but the last cell, so empty cells are covered too.
+   vector<ossim_uint32> cells;
+   vector<ossim_float32> values;
+   srand(5);
+   for (ossim_uint32 i = 0; i < SAMPLES; ++i)
+   {
+      cells.push_back(rand() % (WIDTH * HEIGHT - 1));
+      values.push_back(1000.0f * rand() / RAND_MAX - 500.0f);
+   }
+
+   int errors = 0;
+   errors += checkReducer(ossimPointCloudGrid::MEAN, cells, values);
+   errors += checkReducer(ossimPointCloudGrid::MIN, cells, values);
+   errors += checkReducer(ossimPointCloudGrid::MAX, cells, values);
+   errors += checkReducer(ossimPointCloudGrid::SUM, cells, values);
+   errors += checkReducer(ossimPointCloudGrid::COUNT, cells, values);
+
+   // Three band samples reduce each band on its own:
+   ossimPointCloudGrid rgb(2, 1, 3, ossimPointCloudGrid::MEAN);
+   const ossim_float32 c1[3] = { 10.0f, 20.0f, 30.0f };
+   const ossim_float32 c2[3] = { 30.0f, 40.0f, 50.0f };
+   rgb.add(1, c1);
+   rgb.add(1, c2);
+   if ((rgb.getValue(1, 0, NULL_VALUE) != 20.0f) || (rgb.getValue(1, 2, NULL_VALUE) != 40.0f) ||
+       (rgb.getValue(0, 1, NULL_VALUE) != NULL_VALUE))
+   {
+      cout << "three band mean differs" << endl;
+      ++errors;
+   }
+
+   errors += checkThreads();
+
+   cout << "ossim-point-cloud-grid-test: " << (errors ? "FAILED" : "PASSED") << endl;
+   return errors ? 1 : 0;
+}
@@ -0,0 +1,175 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Description: Test app for the batch worldToLineSample/lineSampleToWorld methods.  Checks that
+// the batch results of a few projections, and of the RPC coordinate array form, match the single
+// point results exactly, including for a map projection that overrides a single point method.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/base/ossimArgumentParser.h>
+#include <ossim/init/ossimInit.h>
+#include <ossim/projection/ossimEquDistCylProjection.h>
+#include <ossim/projection/ossimRpcModel.h>
+#include <ossim/projection/ossimSinusoidalProjection.h>
+#include <ossim/projection/ossimUtmProjection.h>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+static const ossim_uint32 NUM_POINTS = 1000;
+
+static bool same(const ossimDpt& a, const ossimDpt& b)
+{
+   return (a.hasNans() && b.hasNans()) || (a == b);
+}
+
+static bool same(const ossimGpt& a, const ossimGpt& b)
+{
+   return (a.isLatLonNan() && b.isLatLonNan()) || ((a.lat == b.lat) && (a.lon == b.lon));
+}
+
+// Overrides a single point method but not the batch forms, which must still use it.
+class ShiftedSinusoidal : public ossimSinusoidalProjection
+{
+public:
+   using ossimSinusoidalProjection::worldToLineSample;
+   virtual void worldToLineSample(const ossimGpt& worldPoint, ossimDpt& lineSample) const
+   {
+      ossimSinusoidalProjection::worldToLineSample(worldPoint, lineSample);
+      lineSample.x += 0.5;
+   }
+};
+
+static int checkProjection(const char* name, const ossimProjection& proj,
+                           const ossimGpt& origin, double extent)
+{
+   vector<ossimGpt> gpts(NUM_POINTS);
+   for (ossim_uint32 i = 0; i < NUM_POINTS; ++i)
+   {
+      gpts[i] = ossimGpt(origin.lat - extent*(i%37)/37.0, origin.lon + extent*(i%41)/41.0,
+                         (i%3) ? 100.0 : ossim::nan());
+   }
+   gpts[7].makeNan();
+
+   vector<ossimDpt> batchIpts(NUM_POINTS);
+   proj.worldToLineSample(&gpts.front(), &batchIpts.front(), NUM_POINTS);
+
+   vector<ossimGpt> batchGpts(NUM_POINTS);
+   proj.lineSampleToWorld(&batchIpts.front(), &batchGpts.front(), NUM_POINTS);
+
+   int errors = 0;
+   for (ossim_uint32 i = 0; i < NUM_POINTS; ++i)
+   {
+      ossimDpt ipt;
+      proj.worldToLineSample(gpts[i], ipt);
+      if (!same(ipt, batchIpts[i]))
+      {
+         cout << name << " worldToLineSample mismatch at " << i << ": " << ipt << " != "
+              << batchIpts[i] << endl;
+         ++errors;
+      }
+
+      ossimGpt gpt;
+      proj.lineSampleToWorld(batchIpts[i], gpt);
+      if (!same(gpt, batchGpts[i]))
+      {
+         cout << name << " lineSampleToWorld mismatch at " << i << ": " << gpt << " != "
+              << batchGpts[i] << endl;
+         ++errors;
+      }
+   }
+   cout << name << ": " << (errors ? "FAILED" : "PASSED") << endl;
+   return errors;
+}
+
+static int checkRpcArrays(const char* name, const ossimRpcModel& rpc, const ossimGpt& origin,
+                          double extent)
+{
+   vector<double> lat(NUM_POINTS), lon(NUM_POINTS), hgt(NUM_POINTS);
+   for (ossim_uint32 i = 0; i < NUM_POINTS; ++i)
+   {
+      lat[i] = origin.lat - extent*(i%37)/37.0;
+      lon[i] = origin.lon + extent*(i%41)/41.0;
+      hgt[i] = (i%3) ? 100.0 : ossim::nan();
+   }
+   lat[7] = ossim::nan();
+
+   vector<double> line(NUM_POINTS), samp(NUM_POINTS);
+   rpc.worldToLineSample(&lat.front(), &lon.front(), &hgt.front(), &line.front(), &samp.front(),
+                         NUM_POINTS);
+
+   int errors = 0;
+   for (ossim_uint32 i = 0; i < NUM_POINTS; ++i)
+   {
+      ossimDpt ipt;
+      rpc.worldToLineSample(ossimGpt(lat[i], lon[i], hgt[i]), ipt);
+      if (!same(ipt, ossimDpt(samp[i], line[i])))
+      {
+         cout << name << " array worldToLineSample mismatch at " << i << ": " << ipt << " != ("
+              << samp[i] << ", " << line[i] << ")" << endl;
+         ++errors;
+         break;
+      }
+   }
+   cout << name << " arrays: " << (errors ? "FAILED" : "PASSED") << endl;
+   return errors;
+}
+
+int main(int argc, char *argv[])
+{
+   ossimArgumentParser ap(&argc, argv);
+   ossimInit::instance()->addOptions(ap);
+   ossimInit::instance()->initialize(ap);
+
+   ossimGpt origin(38.0, -77.0);
+   int errors = 0;
+
+   ossimRefPtr<ossimEquDistCylProjection> eqProj = new ossimEquDistCylProjection();
+   eqProj->setUlTiePoints(origin);
+   eqProj->setDecimalDegreesPerPixel(ossimDpt(0.0000090, 0.0000090));
+   eqProj->setElevationLookupFlag(false);
+   errors += checkProjection("ossimEquDistCylProjection", *eqProj, origin, 0.01);
+
+   ossimRefPtr<ossimUtmProjection> utmProj = new ossimUtmProjection(18);
+   utmProj->setHemisphere('N');
+   utmProj->setUlTiePoints(origin);
+   utmProj->setMetersPerPixel(ossimDpt(1.0, 1.0));
+   utmProj->setElevationLookupFlag(false);
+   errors += checkProjection("ossimUtmProjection", *utmProj, origin, 0.01);
+
+   ossimRefPtr<ShiftedSinusoidal> sinProj = new ShiftedSinusoidal();
+   sinProj->setUlTiePoints(origin);
+   sinProj->setMetersPerPixel(ossimDpt(1.0, 1.0));
+   sinProj->setElevationLookupFlag(false);
+   errors += checkProjection("ShiftedSinusoidal", *sinProj, origin, 0.01);
+
+   // Simple synthetic RPC. Only worldToLineSample has a batch override; lineSampleToWorld
+   // intersects the DEM through the base class loop.
+   vector<double> lineNum(20, 0.0), lineDen(20, 0.0), sampNum(20, 0.0), sampDen(20, 0.0);
+   lineNum[2] = -1.0;  lineNum[4] = 0.01; lineNum[3] = 0.001;
+   sampNum[1] = 1.0;   sampNum[6] = 0.01;
+   lineDen[0] = 1.0;   lineDen[1] = 0.001;
+   sampDen[0] = 1.0;   sampDen[2] = 0.001;
+   ossimRefPtr<ossimRpcModel> rpc = new ossimRpcModel();
+   rpc->setAttributes(5000.0, 5000.0, 5000.0, 5000.0,
+                      origin.lat - 0.05, origin.lon + 0.05, 100.0,
+                      0.05, 0.05, 500.0,
+                      sampNum, sampDen, lineNum, lineDen);
+   errors += checkProjection("ossimRpcModel", *rpc, origin, 0.1);
+   errors += checkRpcArrays("ossimRpcModel", *rpc, origin, 0.1);
+
+   // Same coefficients in RPC00A term order:
+   rpc->setAttributes(5000.0, 5000.0, 5000.0, 5000.0,
+                      origin.lat - 0.05, origin.lon + 0.05, 100.0,
+                      0.05, 0.05, 500.0,
+                      sampNum, sampDen, lineNum, lineDen, ossimRpcModel::A);
+   errors += checkProjection("ossimRpcModel A", *rpc, origin, 0.1);
+   errors += checkRpcArrays("ossimRpcModel A", *rpc, origin, 0.1);
+
+   return errors ? 1 : 0;
+}
@@ -0,0 +1,185 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Description: Test app for ossimProjectionGrid and the fast geometry mode of ossimImageGeometry.
+// Builds a grid over a synthetic RPC model, checks random points against the model, reads the
+// grid back from disk, checks a fast mode geometry against a plain one, and looks a grid up from
+// several threads at once.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/base/ossimArgumentParser.h>
+#include <ossim/base/ossimPreferences.h>
+#include <ossim/imaging/ossimImageGeometry.h>
+#include <ossim/init/ossimInit.h>
+#include <ossim/projection/ossimProjectionGrid.h>
+#include <ossim/projection/ossimRpcModel.h>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+static const ossim_uint32 NUM_POINTS = 2000;
+static const double       MAX_ERROR  = 0.1;
+static const double       MIN_HGT    = -500.0;
+static const double       MAX_HGT    = 1500.0;
+
+
+static ossimRefPtr<ossimRpcModel> makeRpc()
+{
+   vector<double> lineNum(20, 0.0), lineDen(20, 0.0), sampNum(20, 0.0), sampDen(20, 0.0);
+   lineNum[2] = -1.0;  lineNum[4] = 0.01;  lineNum[3] = 0.001;  lineNum[7] = 0.002;
+   sampNum[1] = 1.0;   sampNum[6] = 0.01;  sampNum[3] = 0.002;  sampNum[8] = 0.003;
+   lineDen[0] = 1.0;   lineDen[1] = 0.001;
+   sampDen[0] = 1.0;   sampDen[2] = 0.001;
+   ossimRefPtr<ossimRpcModel> rpc = new ossimRpcModel();
+   rpc->setAttributes(5000.0, 5000.0, 5000.0, 5000.0, 37.95, -76.95, 100.0, 0.05, 0.05, 500.0,
+                      sampNum, sampDen, lineNum, lineDen);
+   return rpc;
+}
+
+static int checkGrid(const char* name, const ossimProjectionGrid& grid,
+                     const ossimProjection& proj)
+{
+   double worstForward = 0.0;
+   double worstInverse = 0.0;
+   ossim_uint32 answered = 0;
+   srand(7);
+   for (ossim_uint32 i = 0; i < NUM_POINTS; ++i)
+   {
+      const ossimDpt ipt(9999.0 * rand() / RAND_MAX, 9999.0 * rand() / RAND_MAX);
+      const double hgt = MIN_HGT + (MAX_HGT - MIN_HGT) * rand() / RAND_MAX;
+
+      ossimGpt approx;
+      ossimDpt back;
+      if (grid.lineSampleHeightToWorld(ipt, hgt, approx))
+      {
+         // Forward error measured in pixels by projecting the grid's answer back:
+         proj.worldToLineSample(approx, back);
+         worstForward = max(worstForward, (back - ipt).length());
+         ++answered;
+      }
+
+      // Inverse error against the projection's own inverse, since its iterative forward
+      // projection does not come back to ipt exactly:
+      ossimGpt exact;
+      ossimDpt expected;
+      proj.lineSampleHeightToWorld(ipt, hgt, exact);
+      proj.worldToLineSample(exact, expected);
+      if (grid.worldToLineSample(exact, back))
+         worstInverse = max(worstInverse, (back - expected).length());
+   }
+
+   int errors = 0;
+   if ((worstForward > MAX_ERROR) || (worstInverse > MAX_ERROR) || (answered < NUM_POINTS / 2))
+   {
+      cout << name << ": forward error " << worstForward << " inverse error " << worstInverse
+           << " pixels, " << answered << " of " << NUM_POINTS << " answered" << endl;
+      ++errors;
+   }
+   return errors;
+}
+
+int main(int argc, char *argv[])
+{
+   ossimArgumentParser ap(&argc, argv);
+   ossimInit::instance()->addOptions(ap);
+   ossimInit::instance()->initialize(ap);
+
+   int errors = 0;
+   ossimRefPtr<ossimRpcModel> rpc = makeRpc();
+   const ossimDrect rect(0.0, 0.0, 9999.0, 9999.0);
+
+   ossimProjectionGrid grid;
+   if (!grid.build(rpc.get(), rect, MIN_HGT, MAX_HGT, 250.0, MAX_ERROR) ||
+       (grid.getMaxError() > MAX_ERROR) || (grid.getNumberOfLayers() != 9))
+   {
+      cout << "build failed, error " << grid.getMaxError() << endl;
+      ++errors;
+   }
+   errors += checkGrid("built", grid, *rpc);
+
+   // Round trip through a file, which must refuse another key:
+   const ossimFilename file = "ossim-projection-grid-test.grid";
+   ossimProjectionGrid copy;
+   if (!grid.write(file, "key") || copy.read(file, "other key") || !copy.read(file, "key") ||
+       (copy.getCols() != grid.getCols()) || (copy.getRows() != grid.getRows()))
+   {
+      cout << "file round trip failed" << endl;
+      ++errors;
+   }
+   errors += checkGrid("read", copy, *rpc);
+   file.remove();
+
+   // Fast mode geometry against the plain one at known heights:
+   const ossimFilename cacheDir = "ossim-projection-grid-test-cache";
+   ossimPreferences::instance()->addPreference("geometry.fast_mode.cache_dir", cacheDir.c_str());
+   ossimPreferences::instance()->addPreference("geometry.fast_mode.max_height", "1500");
+   ossimRefPtr<ossimImageGeometry> plain = new ossimImageGeometry(0, makeRpc().get());
+   plain->setImageSize(ossimIpt(10000, 10000));
+   plain->setFastMode(false);
+   ossimRefPtr<ossimImageGeometry> fast = new ossimImageGeometry(*plain);
+   fast->setFastMode(true, MAX_ERROR);
+   if (!fast->getFastGrid())
+   {
+      cout << "fast mode grid not made" << endl;
+      ++errors;
+   }
+
+   // Clones looking up a grid not made yet from several threads at once share one:
+   vector< ossimRefPtr<ossimImageGeometry> > clones;
+   for (ossim_uint32 t = 0; t < 8; ++t)
+   {
+      clones.push_back(new ossimImageGeometry(*plain));
+      clones[t]->setImageSize(ossimIpt(9000, 9000));
+      clones[t]->setFastMode(true, MAX_ERROR);
+   }
+   vector<const ossimProjectionGrid*> grids(clones.size(), 0);
+   vector<std::thread> threads;
+   for (ossim_uint32 t = 0; t < clones.size(); ++t)
+      threads.push_back(std::thread([&clones, &grids, t]() { grids[t] = clones[t]->getFastGrid(); }));
+   for (ossim_uint32 t = 0; t < threads.size(); ++t)
+      threads[t].join();
+   for (ossim_uint32 t = 0; t < grids.size(); ++t)
+   {
+      if (!grids[t] || (grids[t] != grids[0]) || (grids[t] == fast->getFastGrid()))
+      {
+         cout << "concurrent fast mode grid lookups differ" << endl;
+         ++errors;
+         break;
+      }
+   }
+
+   double worst = 0.0;
+   srand(9);
+   for (ossim_uint32 i = 0; i < NUM_POINTS; ++i)
+   {
+      const ossimDpt ipt(9999.0 * rand() / RAND_MAX, 9999.0 * rand() / RAND_MAX);
+      const double hgt = MIN_HGT + (MAX_HGT - MIN_HGT) * rand() / RAND_MAX;
+      ossimGpt gpt;
+      ossimDpt a, b;
+      plain->localToWorld(ipt, hgt, gpt);
+      plain->worldToLocal(gpt, a);
+      fast->worldToLocal(gpt, b);
+      worst = max(worst, (a - b).length());
+
+      fast->localToWorld(ipt, hgt, gpt);
+      plain->worldToLocal(gpt, a);
+      worst = max(worst, (a - ipt).length());
+   }
+   if (worst > MAX_ERROR)
+   {
+      cout << "fast mode geometry differs by " << worst << " pixels" << endl;
+      ++errors;
+   }
+   cacheDir.dirCat(".*[.]grid").wildcardRemove();
+   cacheDir.remove();
+
+   cout << "ossim-projection-grid-test: " << (errors ? "FAILED" : "PASSED") << endl;
+   return errors ? 1 : 0;
+}
@@ -0,0 +1,164 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Description: Test app for ossimLasPointIndex.  Indexes points laid out in flight line order,
+// checks the ranges for random rectangles hold every point a brute force search finds, and
+// that the sidecar file reads back only for the file size and time it was stamped with and only
+// when its cell starts are sound.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/base/ossimArgumentParser.h>
+#include <ossim/base/ossimFilename.h>
+#include <ossim/init/ossimInit.h>
+#include <ossim/support_data/ossimLasPointIndex.h>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+static bool inRanges(ossim_uint64 record, const vector<ossimLasPointIndex::Range>& ranges)
+{
+   for (ossim_uint32 i = 0; i < ranges.size(); ++i)
+   {
+      if ((record >= ranges[i].first) && (record < ranges[i].first + ranges[i].count))
+         return true;
+   }
+   return false;
+}
+
+static int check(const ossimLasPointIndex& index, const vector<double>& x, const vector<double>& y,
+                 const char* name)
+{
+   int errors = 0;
+   srand(7);
+   vector<ossimLasPointIndex::Range> ranges;
+   for (ossim_uint32 q = 0; (q < 200) && !errors; ++q)
+   {
+      const double minX = 1000.0 * rand() / RAND_MAX;
+      const double minY = 500.0 * rand() / RAND_MAX;
+      const double maxX = minX + 50.0 * rand() / RAND_MAX;
+      const double maxY = minY + 50.0 * rand() / RAND_MAX;
+      index.getRanges(minX, minY, maxX, maxY, ranges);
+
+      for (ossim_uint32 i = 1; i < ranges.size(); ++i)
+      {
+         if (ranges[i].first <= ranges[i - 1].first + ranges[i - 1].count)
+         {
+            cout << name << ": ranges not sorted and merged" << endl;
+            ++errors;
+            break;
+         }
+      }
+      for (ossim_uint64 r = 0; r < x.size(); ++r)
+      {
+         if ((x[r] >= minX) && (x[r] <= maxX) && (y[r] >= minY) && (y[r] <= maxY) &&
+             !inRanges(r, ranges))
+         {
+            cout << name << ": record " << r << " missing from query " << q << endl;
+            ++errors;
+            break;
+         }
+      }
+   }
+   return errors;
+}
+
+int main(int argc, char *argv[])
+{
+   ossimArgumentParser ap(&argc, argv);
+   ossimInit::instance()->addOptions(ap);
+   ossimInit::instance()->initialize(ap);
+
+   // Flight lines back and forth across a 1000 x 500 area.
+   vector<double> x;
+   vector<double> y;
+   srand(3);
+   for (ossim_uint32 line = 0; line < 50; ++line)
+   {
+      for (ossim_uint32 i = 0; i < 2000; ++i)
+      {
+         double along = i * 0.5;
+         x.push_back((line % 2) ? 1000.0 - along : along);
+         y.push_back(line * 10.0 + 10.0 * rand() / RAND_MAX);
+      }
+   }
+
+   int errors = 0;
+
+   ossimLasPointIndex index;
+   index.initialize(0.0, 0.0, 1000.0, 500.0, x.size());
+   for (ossim_uint64 r = 0; r < x.size(); ++r)
+      index.add(r, x[r], y[r]);
+   index.finalize();
+   if (!index.valid())
+   {
+      cout << "index not valid after finalize" << endl;
+      ++errors;
+   }
+   errors += check(index, x, y, "built");
+
+   // A rectangle off the bounds has nothing.
+   vector<ossimLasPointIndex::Range> ranges;
+   index.getRanges(2000.0, 2000.0, 2100.0, 2100.0, ranges);
+   if (ranges.size())
+   {
+      cout << "ranges found outside the bounds" << endl;
+      ++errors;
+   }
+
+   // Sidecar round trip.
+   ossimFilename file = "ossim-las-point-index-test.lpi";
+   if (!index.write(file, 12345, 678))
+   {
+      cout << "could not write " << file << endl;
+      ++errors;
+   }
+   ossimLasPointIndex copy;
+   if (!copy.read(file, 12345, 678, x.size()))
+   {
+      cout << "could not read " << file << endl;
+      ++errors;
+   }
+   errors += check(copy, x, y, "read");
+   if (copy.read(file, 12345, 679, x.size()) || copy.valid())
+   {
+      cout << "read an index stamped with another time" << endl;
+      ++errors;
+   }
+   if (copy.read(file, 12346, 678, x.size()))
+   {
+      cout << "read an index stamped with another size" << endl;
+      ++errors;
+   }
+   if (copy.read(file, 12345, 678, 1) || copy.valid())
+   {
+      cout << "read an index with more runs than points" << endl;
+      ++errors;
+   }
+
+   // Cell starts running past the runs, e.g. a sidecar overwritten in part, are rejected.
+   {
+      // Header: magic, version, byte order, size, time, bounds, cols, rows, run count.
+      const std::streamoff CELL_START_OFFSET = 8 + 4 + 4 + 8 + 8 + 4 * 8 + 4 + 4 + 8;
+      const ossim_uint64 bad = 0xffffffffffffULL;
+      fstream io(file.c_str(), ios_base::in | ios_base::out | ios_base::binary);
+      io.seekp(CELL_START_OFFSET + sizeof(ossim_uint64));
+      io.write((const char*)&bad, sizeof(bad));
+      io.close();
+   }
+   if (copy.read(file, 12345, 678, x.size()) || copy.valid())
+   {
+      cout << "read an index with corrupt cell starts" << endl;
+      ++errors;
+   }
+   file.remove();
+
+   cout << "ossim-las-point-index-test: " << (errors ? "FAILED" : "PASSED") << endl;
+   return errors ? 1 : 0;
+}
@@ -0,0 +1,152 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Description: Test app for ossimNitfJpegBlockIndex.  Scans a synthetic segment of JPEG streams
+// larger than the scan buffer, with false EOI markers hidden in marker segments, and checks the
+// sidecar file reads back only for the file and segment it was stamped with.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/base/ossimArgumentParser.h>
+#include <ossim/base/ossimFilename.h>
+#include <ossim/init/ossimInit.h>
+#include <ossim/support_data/ossimNitfJpegBlockIndex.h>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static const ossim_uint32   BLOCKS = 40;
+static const std::streamoff START  = 1000;
+
+static void addSegment(string& s, ossim_uint8 marker, ossim_uint32 payload)
+{
+   s += (char)0xff;
+   s += (char)marker;
+   s += (char)((payload + 2) >> 8);
+   s += (char)((payload + 2) & 0xff);
+   for (ossim_uint32 i = 0; i < payload; ++i)
+      s += (char)((i % 5 == 0) ? 0xff : ((i % 5 == 1) ? 0xd9 : rand() % 256));
+}
+
+/** Segment of BLOCKS streams after START bytes of header holding 0xFF bytes. */
+static string makeSegment(vector<std::streamoff>& offsets, vector<ossim_uint32>& sizes)
+{
+   string s;
+   for (std::streamoff i = 0; i < START; ++i)
+      s += (char)((i % 7) ? 0xff : 0x20);
+
+   srand(3);
+   for (ossim_uint32 b = 0; b < BLOCKS; ++b)
+   {
+      const std::streamoff soi = (std::streamoff)s.size();
+      s += (char)0xff;
+      s += (char)0xff; // Fill byte before the marker.
+      s += (char)0xd8;
+      addSegment(s, 0xdb, 130);  // DQT
+      addSegment(s, 0xc4, 400);  // DHT
+      addSegment(s, 0xc0, 15);   // SOF0
+      addSegment(s, 0xda, 10);   // SOS
+
+      // Entropy coded data with stuffed 0xFF's and restart markers.
+      const ossim_uint32 bytes = 40000 + rand() % 60000;
+      for (ossim_uint32 i = 0; i < bytes; ++i)
+      {
+         const int r = rand() % 64;
+         if (r == 0)
+         {
+            s += (char)0xff;
+            s += (char)0x00;
+         }
+         else if (r == 1)
+         {
+            s += (char)0xff;
+            s += (char)(0xd0 + rand() % 8);
+         }
+         else
+         {
+            s += (char)(rand() % 255);
+         }
+      }
+      s += (char)0xff;
+      s += (char)0xd9;
+
+      offsets.push_back(soi + 1); // The SOI marker starts at the last 0xFF.
+      sizes.push_back((ossim_uint32)((std::streamoff)s.size() - soi - 1));
+   }
+   return s;
+}
+
+static int check(const ossimNitfJpegBlockIndex& index, const vector<std::streamoff>& offsets,
+                 const vector<ossim_uint32>& sizes, const char* name)
+{
+   if ((index.getOffsets() != offsets) || (index.getSizes() != sizes))
+   {
+      cout << name << ": " << index.getNumberOfBlocks() << " blocks, expected " << offsets.size()
+           << endl;
+      return 1;
+   }
+   return 0;
+}
+
+int main(int argc, char *argv[])
+{
+   ossimArgumentParser ap(&argc, argv);
+   ossimInit::instance()->addOptions(ap);
+   ossimInit::instance()->initialize(ap);
+
+   vector<std::streamoff> offsets;
+   vector<ossim_uint32> sizes;
+   const string segment = makeSegment(offsets, sizes);
+   int errors = 0;
+   if (segment.size() < 2 * ossimNitfJpegBlockIndex::SCAN_BUFFER_SIZE)
+   {
+      cout << "segment too small to cross the scan buffer" << endl;
+      ++errors;
+   }
+
+   // All blocks, and a scan that stops early:
+   istringstream str(segment);
+   ossimNitfJpegBlockIndex index;
+   if (!index.scan(str, START, BLOCKS))
+      ++errors;
+   errors += check(index, offsets, sizes, "scan");
+
+   ossimNitfJpegBlockIndex partial;
+   if (!partial.scan(str, START, 10))
+      ++errors;
+   errors += check(partial, vector<std::streamoff>(offsets.begin(), offsets.begin() + 10),
+                   vector<ossim_uint32>(sizes.begin(), sizes.begin() + 10), "partial scan");
+
+   // More blocks than the segment holds finds them all and reports failure:
+   ossimNitfJpegBlockIndex missing;
+   if (missing.scan(str, START, BLOCKS + 1))
+      ++errors;
+   errors += check(missing, offsets, sizes, "missing scan");
+
+   // Sidecar only reads back with the same stamp:
+   const ossimFilename file = "ossim-nitf-jpeg-block-index-test.jbi";
+   const ossim_uint64 fileSize = segment.size();
+   ossimNitfJpegBlockIndex copy;
+   if (!index.write(file, fileSize, 1234, START, BLOCKS) ||
+       copy.read(file, fileSize + 1, 1234, START, BLOCKS) ||
+       copy.read(file, fileSize, 1235, START, BLOCKS) ||
+       copy.read(file, fileSize, 1234, START + 1, BLOCKS) ||
+       copy.read(file, fileSize, 1234, START, BLOCKS + 1) ||
+       !copy.read(file, fileSize, 1234, START, BLOCKS))
+   {
+      cout << "sidecar stamp not checked" << endl;
+      ++errors;
+   }
+   errors += check(copy, offsets, sizes, "read");
+   file.remove();
+
+   cout << "ossim-nitf-jpeg-block-index-test: " << (errors ? "FAILED" : "PASSED") << endl;
+   return errors ? 1 : 0;
+}
@@ -0,0 +1,481 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Description: Test app for ossimRpfFrame::decodeSubFrame and ossimRpfFrameCache.  Writes a few
+// CADRG frames of random VQ codes, tables and colors, with one subframe masked out, and checks:
+// - decodeSubFrame matches the per tile decode the CIB/CADRG tile source used before it,
+// - rpf.frame_cache.max_frames and max_subframes, then setLimits, bound what the cache holds,
+// - getSubFrames called from several threads at once hands back the same subframes.
+//
+//**************************************************************************************************
+//  $Id$
+
+#include <ossim/base/ossimArgumentParser.h>
+#include <ossim/base/ossimErrorCodes.h>
+#include <ossim/base/ossimFilename.h>
+#include <ossim/base/ossimPreferences.h>
+#include <ossim/base/ossimString.h>
+#include <ossim/init/ossimInit.h>
+#include <ossim/support_data/ossimNitfFileHeaderV2_0.h>
+#include <ossim/support_data/ossimNitfTagInformation.h>
+#include <ossim/support_data/ossimRpfColorGrayscaleTable.h>
+#include <ossim/support_data/ossimRpfCompressionSection.h>
+#include <ossim/support_data/ossimRpfConstants.h>
+#include <ossim/support_data/ossimRpfFrame.h>
+#include <ossim/support_data/ossimRpfFrameCache.h>
+#include <ossim/support_data/ossimRpfHeader.h>
+#include <ossim/support_data/ossimRpfLocationSection.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+static const ossim_uint32 NUM_FRAMES    = 3;
+static const ossim_uint32 SUBFRAMES     = 6;    // Per side, as in CADRG.
+static const ossim_uint32 MISSING_ROW   = 2;    // Masked out subframe.
+static const ossim_uint32 MISSING_COL   = 3;
+static const ossim_uint32 SUBFRAME_SIZE = 256*256;
+static const ossim_uint32 CODE_BYTES    = (64*64*12)/8;
+static const ossim_uint32 MAX_FRAMES    = 2;
+static const ossim_uint32 MAX_SUBFRAMES = 10;
+static const ossim_uint32 NUM_THREADS   = 8;
+static const ossim_uint32 NUM_PASSES    = 4;
+
+static std::atomic<int> g_failures(0);
+
+static void check(bool passed, const ossimString& what)
+{
+   if (!passed)
+   {
+      cout << "FAILED: " << what << endl;
+      ++g_failures;
+   }
+}
+
+/** Appends the low bytes of value, big endian as RPF is written. */
+static void put(std::string& s, ossim_uint32 value, ossim_uint32 bytes)
+{
+   for (ossim_uint32 i = bytes; i > 0; --i)
+      s.push_back((char)((value >> (8*(i - 1))) & 0xff));
+}
+
+static void putRandom(std::string& s, ossim_uint32 bytes, std::mt19937& rng)
+{
+   for (ossim_uint32 i = 0; i < bytes; ++i)
+      s.push_back((char)(rng() & 0xff));
+}
+
+static void addComponent(ossimRpfLocationSection* locSec, ossimRpfComponentId id,
+                         ossim_uint32 location, ossim_uint32 length)
+{
+   ossimRpfComponentLocationRecord record;
+   record.m_componentId       = id;
+   record.m_componentLength   = length;
+   record.m_componentLocation = location;
+   locSec->addComponentRecord(record);
+}
+
+/**
+ * Writes a frame of 6x6 subframes of 12 bit VQ codes, with four 4096 entry lookup tables into a
+ * 256 entry RGB color table.  Subframe MISSING_ROW, MISSING_COL is null in the mask table and
+ * the others are stored last to first so their offsets come from the mask.
+ */
+static bool writeFrame(const ossimFilename& file, ossim_uint32 seed)
+{
+   std::mt19937 rng(seed);
+
+   ossimRefPtr<ossimNitfFileHeaderV2_0> fileHdr = new ossimNitfFileHeaderV2_0();
+   fileHdr->setComplexityLevel("01");
+   fileHdr->setDate();
+   fileHdr->setTitle(file.file());
+   ossimRpfHeader* rpfHdr = new ossimRpfHeader();
+   ossimRefPtr<ossimNitfRegisteredTag> rpfHdrRp = rpfHdr;
+   fileHdr->addTag(ossimNitfTagInformation(rpfHdrRp));
+
+   std::ofstream out(file.c_str(), std::ios_base::out | std::ios_base::binary);
+   if (!out)
+      return false;
+
+   // The location section follows the file header:
+   fileHdr->writeStream(out);
+   const ossim_uint32 locationPos = (ossim_uint32)out.tellp();
+   fileHdr->setHeaderLength(locationPos);
+   rpfHdr->setLocationSectionPos(locationPos);
+   rpfHdr->setFilename(file.file());
+
+   const ossim_uint16 NUM_COMPONENTS = 7;
+   const ossim_uint32 LOCATION_SIZE = 14 + 10*NUM_COMPONENTS;
+   const ossim_uint32 start = locationPos + LOCATION_SIZE;
+   ossimRpfLocationSection* locSec = rpfHdr->getLocationSection();
+   locSec->clearFields();
+   locSec->setLocationSectionLength(LOCATION_SIZE);
+   locSec->setLocationTableOffset(14);
+   locSec->setNumberOfComponentLocationRecords(NUM_COMPONENTS);
+   locSec->setLocationRecordLength(10);
+
+   std::string body;
+
+   // Compression section, the lookup tables are offset from the end of its subheader:
+   ossim_uint32 pos = (ossim_uint32)body.size();
+   put(body, 1, 2);   // VQ
+   put(body, 4, 2);   // Lookup offset records
+   put(body, 0, 2);   // Parameter offset records
+   put(body, 6, 4);
+   put(body, 14, 2);
+   for (ossim_uint32 t = 0; t < 4; ++t)
+   {
+      put(body, t + 1, 2);
+      put(body, 4096, 4);
+      put(body, 4, 2);
+      put(body, 8, 2);
+      put(body, 6 + 4*14 + t*4096*4, 4);
+   }
+   putRandom(body, 4*4096*4, rng);
+   addComponent(locSec, OSSIM_RPF_COMPRESSION_SECTION_SUBHEADER, start + pos,
+                (ossim_uint32)body.size() - pos);
+
+   // Color/grayscale section subheader and the one RGB color table:
+   pos = (ossim_uint32)body.size();
+   put(body, 1, 1);
+   put(body, 0, 1);
+   body += "            ";
+   addComponent(locSec, OSSIM_RPF_COLOR_GRAYSCALE_SECTION_SUBHEADER, start + pos, 14);
+   pos = (ossim_uint32)body.size();
+   put(body, 6, 4);
+   put(body, 17, 2);
+   put(body, 1, 2);   // RGB
+   put(body, 256, 4);
+   put(body, 3, 1);
+   put(body, 0, 2);
+   put(body, 6 + 17, 4);
+   put(body, OSSIM_RPF_ULONG_NULL, 4);
+   putRandom(body, 256*3, rng);
+   addComponent(locSec, OSSIM_RPF_COLORMAP_SUBSECTION, start + pos,
+                (ossim_uint32)body.size() - pos);
+
+   // Image description subheader, then the mask subsection:
+   pos = (ossim_uint32)body.size();
+   put(body, 1, 2);
+   put(body, SUBFRAMES*SUBFRAMES, 2);
+   put(body, 1, 2);
+   put(body, 1, 2);
+   put(body, SUBFRAMES, 2);
+   put(body, SUBFRAMES, 2);
+   put(body, 256, 4);
+   put(body, 256, 4);
+   put(body, 6, 4);
+   put(body, OSSIM_RPF_ULONG_NULL, 4);
+   addComponent(locSec, OSSIM_RPF_IMAGE_DESCRIPTION_SUBHEADER, start + pos, 28);
+   pos = (ossim_uint32)body.size();
+   put(body, 4, 2);
+   put(body, 0, 2);
+   put(body, 0, 2);
+   ossim_uint32 stored = SUBFRAMES*SUBFRAMES - 1;
+   for (ossim_uint32 row = 0; row < SUBFRAMES; ++row)
+   {
+      for (ossim_uint32 col = 0; col < SUBFRAMES; ++col)
+      {
+         if ((row == MISSING_ROW) && (col == MISSING_COL))
+         {
+            put(body, OSSIM_RPF_ULONG_NULL, 4);
+         }
+         else
+         {
+            --stored;
+            put(body, stored*CODE_BYTES, 4);
+         }
+      }
+   }
+   addComponent(locSec, OSSIM_RPF_MASK_SUBSECTION, start + pos, (ossim_uint32)body.size() - pos);
+
+   // Image display parameters, 64 rows of 64 12 bit codes:
+   pos = (ossim_uint32)body.size();
+   put(body, 64, 4);
+   put(body, 64, 4);
+   put(body, 12, 1);
+   addComponent(locSec, OSSIM_RPF_IMAGE_DISPLAY_PARAMETERS_SUBHEADER, start + pos, 9);
+
+   pos = (ossim_uint32)body.size();
+   putRandom(body, (SUBFRAMES*SUBFRAMES - 1)*CODE_BYTES, rng);
+   addComponent(locSec, OSSIM_RPF_SPATIAL_DATA_SUBSECTION, start + pos,
+                (ossim_uint32)body.size() - pos);
+   locSec->setComponentAggregateLength(LOCATION_SIZE + (ossim_uint32)body.size());
+
+   out.seekp(start, std::ios_base::beg);
+   out.write(body.data(), body.size());
+   fileHdr->setFileLength(start + body.size());
+
+   // Again with the lengths, the RPF header writes the location section:
+   out.seekp(0, std::ios_base::beg);
+   fileHdr->writeStream(out);
+   return out.good();
+}
+
+/**
+ * The 3 band decode fillSubTileCadrg did per tile before decodeSubFrame, into band sequential
+ * buffer.  fillSubTileCib kept the first band.
+ */
+static void decodeOld(const ossimRpfFrame& aFrame, ossim_uint32 row, ossim_uint32 col,
+                      ossim_uint8* buffer)
+{
+   const ossimRpfCompressionSection* compressionSection = aFrame.getCompressionSection();
+   const vector<ossimRpfColorGrayscaleTable>& colorTable = aFrame.getColorGrayscaleTable();
+   ossim_uint8 compressed[CODE_BYTES];
+   ossim_uint8* tempRows[3] = { buffer, buffer + SUBFRAME_SIZE, buffer + 2*SUBFRAME_SIZE };
+   ossim_uint32 readPtr = 0;
+   if (aFrame.fillSubFrameBuffer(compressed, 0, row, col))
+   {
+      for (ossim_uint32 i = 0; i < 256; i += 4)
+      {
+         for (ossim_uint32 j = 0; j < 256; j += 8)
+         {
+            ossim_uint16 firstByte  = compressed[readPtr++] & 0xff;
+            ossim_uint16 secondByte = compressed[readPtr++] & 0xff;
+            ossim_uint16 thirdByte  = compressed[readPtr++] & 0xff;
+            ossim_uint16 val1 = (firstByte << 4) | (secondByte >> 4);
+            ossim_uint16 val2 = ((secondByte & 0x000F) << 8) | thirdByte;
+            for (ossim_uint32 t = 0; t < 4; ++t)
+            {
+               for (ossim_uint32 e = 0; e < 4; ++e)
+               {
+                  ossim_uint16 tableVal1 = compressionSection->getTable()[t].theData[val1*4 + e] & 0xff;
+                  ossim_uint16 tableVal2 = compressionSection->getTable()[t].theData[val2*4 + e] & 0xff;
+                  ossim_uint32 pixindex = ((i+t)*256) + (j + e);
+                  const ossim_uint8* color1 = colorTable[0].getStartOfData(tableVal1);
+                  const ossim_uint8* color2 = colorTable[0].getStartOfData(tableVal2);
+                  tempRows[0][pixindex] = color1[0];
+                  tempRows[1][pixindex] = color1[1];
+                  tempRows[2][pixindex] = color1[2];
+                  tempRows[0][pixindex+4] = color2[0];
+                  tempRows[1][pixindex+4] = color2[1];
+                  tempRows[2][pixindex+4] = color2[2];
+               }
+            }
+         }
+      }
+   }
+   else
+   {
+      memset(buffer, 0, SUBFRAME_SIZE*3);
+   }
+}
+
+typedef vector< vector<ossim_uint8> > Expected; // 3 band subframes by frame, row, col.
+
+static ossim_uint32 subFrameIndex(ossim_uint32 frame, ossim_uint32 row, ossim_uint32 col)
+{
+   return (frame*SUBFRAMES + row)*SUBFRAMES + col;
+}
+
+static bool sameSubFrame(const ossimRpfFrameCache::SubFrame& data,
+                         const vector<ossim_uint8>& expected, ossim_uint32 bands)
+{
+   return data && (data->size() == SUBFRAME_SIZE*bands) &&
+      !memcmp(&data->front(), &expected.front(), SUBFRAME_SIZE*bands);
+}
+
+static void testDecode(const vector<ossimFilename>& files, Expected& expected)
+{
+   expected.resize(files.size()*SUBFRAMES*SUBFRAMES);
+   vector<ossim_uint8> buffer(SUBFRAME_SIZE*3);
+   for (ossim_uint32 f = 0; f < files.size(); ++f)
+   {
+      ossimRpfFrame frame;
+      check(frame.parseFile(files[f]) == ossimErrorCodes::OSSIM_OK, files[f] + " parse");
+      check(frame.getCompressionSection() && (frame.getColorGrayscaleTable().size() == 1) &&
+            frame.hasSubframeMaskTable(), files[f] + " sections");
+      if (!frame.getCompressionSection() || frame.getColorGrayscaleTable().empty())
+         return;
+
+      ossim_uint32 bad = 0;
+      for (ossim_uint32 row = 0; row < SUBFRAMES; ++row)
+      {
+         for (ossim_uint32 col = 0; col < SUBFRAMES; ++col)
+         {
+            vector<ossim_uint8>& old = expected[subFrameIndex(f, row, col)];
+            old.resize(SUBFRAME_SIZE*3);
+            decodeOld(frame, row, col, &old.front());
+
+            for (ossim_uint32 bands = 1; bands <= 3; bands += 2)
+            {
+               memset(&buffer.front(), 0xff, buffer.size());
+               if (!frame.decodeSubFrame(&buffer.front(), bands, row, col) ||
+                   memcmp(&buffer.front(), &old.front(), SUBFRAME_SIZE*bands))
+                  ++bad;
+            }
+         }
+      }
+      check(bad == 0, files[f] + " " + ossimString::toString(bad) +
+            " subframes decode differently");
+
+      // The masked out one is black, the rest are not:
+      const vector<ossim_uint8>& missing = expected[subFrameIndex(f, MISSING_ROW, MISSING_COL)];
+      const vector<ossim_uint8>& present = expected[subFrameIndex(f, 0, 0)];
+      check(std::count(missing.begin(), missing.end(), 0) == (long)missing.size(),
+            "masked subframe not blank");
+      check(std::count(present.begin(), present.end(), 0) < (long)present.size() / 2,
+            "subframe blank");
+   }
+}
+
+/** @return How many of items are still alive, i.e. held by the cache. */
+template <class T> static ossim_uint32 countAlive(const vector< std::weak_ptr<T> >& items)
+{
+   ossim_uint32 result = 0;
+   for (ossim_uint32 i = 0; i < items.size(); ++i)
+      if (!items[i].expired())
+         ++result;
+   return result;
+}
+
+static void testLimits(const vector<ossimFilename>& files, const Expected& expected,
+                       ossim_uint32 maxFrames, ossim_uint32 maxSubFrames, const ossimString& name)
+{
+   ossimRpfFrameCache* cache = ossimRpfFrameCache::instance();
+   cache->clear();
+
+   vector< std::weak_ptr<const ossimRpfFrame> > frames;
+   vector< std::weak_ptr<const ossimRpfFrameCache::SubFrameData> > subFrames;
+   ossim_uint32 maxAliveFrames = 0;
+   ossim_uint32 maxAliveSubFrames = 0;
+   ossim_uint32 bad = 0;
+   for (ossim_uint32 f = 0; f < files.size(); ++f)
+   {
+      frames.push_back(cache->getFrame(files[f]));
+      maxAliveFrames = std::max(maxAliveFrames, countAlive(frames));
+      for (ossim_uint32 row = 0; row < SUBFRAMES; ++row)
+      {
+         for (ossim_uint32 col = 0; col < SUBFRAMES; ++col)
+         {
+            ossimRpfFrameCache::SubFrame data = cache->getSubFrame(files[f], row, col, 3);
+            if (!sameSubFrame(data, expected[subFrameIndex(f, row, col)], 3))
+               ++bad;
+            subFrames.push_back(data);
+            data.reset();
+            maxAliveSubFrames = std::max(maxAliveSubFrames, countAlive(subFrames));
+         }
+      }
+   }
+   check(bad == 0, name + " cached subframes differ");
+   check((maxAliveFrames > 0) && (maxAliveFrames <= maxFrames),
+         name + " " + ossimString::toString(maxAliveFrames) + " frames cached");
+   check((maxAliveSubFrames > 0) && (maxAliveSubFrames <= maxSubFrames),
+         name + " " + ossimString::toString(maxAliveSubFrames) + " subframes cached");
+
+   // The most recent subframe is a hit, the first was dropped:
+   const ossim_uint32 last = (ossim_uint32)files.size() - 1;
+   check(cache->getSubFrame(files[last], SUBFRAMES - 1, SUBFRAMES - 1, 3) ==
+         subFrames.back().lock(), name + " last subframe not cached");
+   check(subFrames.front().expired(), name + " first subframe still cached");
+
+   cache->clear();
+   check((countAlive(frames) == 0) && (countAlive(subFrames) == 0), name + " clear");
+}
+
+/** Asks for every subframe of every frame, each thread in its own order. */
+static void readSubFrames(const vector<ossimFilename>* files, const Expected* expected,
+                          ossim_uint32 start)
+{
+   const ossim_uint32 count = (ossim_uint32)expected->size();
+   for (ossim_uint32 pass = 0; pass < NUM_PASSES; ++pass)
+   {
+      // A handful at a time, like the subframes under a tile:
+      for (ossim_uint32 first = 0; first < count; first += 4)
+      {
+         vector<ossimRpfFrameCache::SubFrameRequest> requests;
+         vector<ossim_uint32> indexes;
+         for (ossim_uint32 i = first; (i < first + 4) && (i < count); ++i)
+         {
+            const ossim_uint32 idx = (start*11 + pass*5 + i*7) % count;
+            ossimRpfFrameCache::SubFrameRequest request;
+            request.file = (*files)[idx / (SUBFRAMES*SUBFRAMES)];
+            request.row  = (idx / SUBFRAMES) % SUBFRAMES;
+            request.col  = idx % SUBFRAMES;
+            requests.push_back(request);
+            indexes.push_back(idx);
+         }
+         const ossim_uint32 bands = ((start + pass) % 2) ? 3 : 1;
+         ossimRpfFrameCache::instance()->getSubFrames(requests, bands);
+         for (ossim_uint32 i = 0; i < requests.size(); ++i)
+         {
+            if (!sameSubFrame(requests[i].data, (*expected)[indexes[i]], bands))
+               ++g_failures;
+         }
+      }
+   }
+}
+
+static void testThreads(const vector<ossimFilename>& files, const Expected& expected)
+{
+   // Small enough that threads evict each other's subframes:
+   ossimRpfFrameCache::instance()->clear();
+   ossimRpfFrameCache::instance()->setLimits(MAX_FRAMES, MAX_SUBFRAMES);
+
+   const int failures = g_failures.load();
+   vector<std::thread> threads;
+   for (ossim_uint32 idx = 0; idx < NUM_THREADS; ++idx)
+      threads.push_back(std::thread(readSubFrames, &files, &expected, idx));
+   for (ossim_uint32 idx = 0; idx < NUM_THREADS; ++idx)
+      threads[idx].join();
+   if (g_failures.load() != failures)
+      cout << "FAILED: " << (g_failures.load() - failures)
+           << " subframes from getSubFrames differ from the single decode" << endl;
+
+   ossimRpfFrameCache::instance()->clear();
+}
+
+int main(int argc, char *argv[])
+{
+   ossimArgumentParser ap(&argc, argv);
+   ossimInit::instance()->addOptions(ap);
+   ossimInit::instance()->initialize(ap);
+
+   // Read by the cache on first use:
+   ossimPreferences::instance()->addPreference("rpf.frame_cache.max_frames",
+                                               ossimString::toString(MAX_FRAMES).c_str());
+   ossimPreferences::instance()->addPreference("rpf.frame_cache.max_subframes",
+                                               ossimString::toString(MAX_SUBFRAMES).c_str());
+
+   vector<ossimFilename> files;
+   for (ossim_uint32 f = 0; f < NUM_FRAMES; ++f)
+   {
+      files.push_back(ossimFilename("ossim-rpf-frame-cache-test-") +
+                      ossimString::toString(f) + ".ntf");
+      check(writeFrame(files.back(), 20261017 + f), files.back() + " write");
+   }
+
+   Expected expected;
+   testDecode(files, expected);
+   if (g_failures.load() == 0)
+   {
+      testLimits(files, expected, MAX_FRAMES, MAX_SUBFRAMES, "preferences");
+      ossimRpfFrameCache::instance()->setLimits(1, 25);
+      testLimits(files, expected, 1, 25, "setLimits");
+      testThreads(files, expected);
+   }
+
+   for (ossim_uint32 f = 0; f < files.size(); ++f)
+      files[f].remove();
+
+   int status = 0;
+   if (g_failures.load())
+   {
+      cout << "ossim-rpf-frame-cache-test: FAILED" << endl;
+      status = 1;
+   }
+   else
+   {
+      cout << "ossim-rpf-frame-cache-test: PASSED" << endl;
+   }
+   return status;
+}